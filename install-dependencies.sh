@@ -1,5 +1,5 @@
 #!/bin/bash
-sudo yum install lzo snappy-devel libaio-devel openssl-devel mysql-devel numactl-devel
+sudo yum install lzo snappy-devel lz4-devel libzstd-devel libaio-devel openssl-devel mysql-devel numactl-devel
 sudo yum install -b test t-csrd-tbnet-devel t_libeasy-devel
 # install gtest
 GTEST_SRC='http://googletest.googlecode.com/files/gtest-1.6.0.zip'
@@ -25,8 +25,8 @@ Vendor: TaoBao
 Prefix:%{_prefix}
 Source:%{NAME}-%{VERSION}.tar.gz
 BuildRoot: %(pwd)/%{name}-root
-BuildRequires: t-csrd-tbnet-devel >= 1.0.8 lzo >= 2.06 snappy >= 1.0.2 libaio-devel >= 0.3 t_libeasy-devel >= 1.0.16-198 openssl-devel >= 0.9.8 mysql-devel >= 5.0.77
-Requires: lzo >= 2.06 snappy >= 1.0.2 libaio >= 0.3 openssl >= 0.9.8
+BuildRequires: t-csrd-tbnet-devel >= 1.0.8 lzo >= 2.06 snappy >= 1.0.2 lz4 >= 1.7.3 libzstd >= 1.3.1 libaio-devel >= 0.3 t_libeasy-devel >= 1.0.16-198 openssl-devel >= 0.9.8 mysql-devel >= 5.0.77
+Requires: lzo >= 2.06 snappy >= 1.0.2 lz4 >= 1.7.3 libzstd >= 1.3.1 libaio >= 0.3 openssl >= 0.9.8
 
 %package -n oceanbase-utils
 summary: OceanBase utility programs
@@ -111,6 +111,16 @@ rm -rf $RPM_BUILD_ROOT
 %{_prefix}/lib/libsnappy_1.0.so
 %{_prefix}/lib/libsnappy_1.0.so.0
 %{_prefix}/lib/libsnappy_1.0.so.0.0.0
+%{_prefix}/lib/liblz4_1.0.a
+%{_prefix}/lib/liblz4_1.0.la
+%{_prefix}/lib/liblz4_1.0.so
+%{_prefix}/lib/liblz4_1.0.so.0
+%{_prefix}/lib/liblz4_1.0.so.0.0.0
+%{_prefix}/lib/libzstd_1.0.a
+%{_prefix}/lib/libzstd_1.0.la
+%{_prefix}/lib/libzstd_1.0.so
+%{_prefix}/lib/libzstd_1.0.so.0
+%{_prefix}/lib/libzstd_1.0.so.0.0.0
 %{_prefix}/bin/oceanbase.pl
 %config %{_prefix}/etc/oceanbase.conf.template
 %{_prefix}/tests/
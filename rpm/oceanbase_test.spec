@@ -25,7 +25,7 @@ Vendor: TaoBao
 Prefix:%{_prefix}
 Source:%{NAME}-%{VERSION}.tar.gz
 BuildRoot: %(pwd)/%{name}-root
-Requires: lzo >= 2.06 snappy >= 1.0.2 libaio >= 0.3 openssl >= 0.9.8 perl-DBI
+Requires: lzo >= 2.06 snappy >= 1.0.2 lz4 >= 1.7.3 libzstd >= 1.3.1 libaio >= 0.3 openssl >= 0.9.8 perl-DBI
 
 %package -n oceanbase-utils
 summary: OceanBase utility programs
@@ -109,6 +109,16 @@ rm -rf $RPM_BUILD_ROOT
 %{_prefix}/lib/libsnappy_1.0.so
 %{_prefix}/lib/libsnappy_1.0.so.0
 %{_prefix}/lib/libsnappy_1.0.so.0.0.0
+%{_prefix}/lib/liblz4_1.0.a
+%{_prefix}/lib/liblz4_1.0.la
+%{_prefix}/lib/liblz4_1.0.so
+%{_prefix}/lib/liblz4_1.0.so.0
+%{_prefix}/lib/liblz4_1.0.so.0.0.0
+%{_prefix}/lib/libzstd_1.0.a
+%{_prefix}/lib/libzstd_1.0.la
+%{_prefix}/lib/libzstd_1.0.so
+%{_prefix}/lib/libzstd_1.0.so.0
+%{_prefix}/lib/libzstd_1.0.so.0.0.0
 %{_prefix}/bin/oceanbase.pl
 %config %{_prefix}/etc/oceanbase.conf.template
 %{_prefix}/tests/
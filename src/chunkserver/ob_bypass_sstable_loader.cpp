@@ -12,6 +12,7 @@
  *
  */
 #include "common/file_directory_utils.h"
+#include "common/ob_io_scheduler.h"
 #include "ob_chunk_server_main.h"
 #include "ob_tablet_manager.h"
 #include "ob_bypass_sstable_loader.h"
@@ -558,6 +559,8 @@ namespace oceanbase
        */
       if (is_continue_load_&& need_import(file_name))
       {
+        // bypass loading has the lowest io priority on the disk
+        ObIOClassGuard io_guard(IO_CLASS_LOAD, disk_no);
         ret = load_one_bypass_sstable(disk_no, file_name);
         if (OB_SUCCESS != ret)
         {
@@ -23,6 +23,7 @@
 #include "common/ob_trace_log.h"
 #include "ob_tablet_manager.h"
 #include "common/ob_atomic.h"
+#include "common/ob_io_scheduler.h"
 #include "common/file_directory_utils.h"
 #include "ob_tablet_merger_v1.h"
 #include "ob_tablet_merger_v2.h"
@@ -451,6 +452,9 @@ namespace oceanbase
             {
               atomic_inc(ref);
               TBSYS_LOG(DEBUG,"get a tablet, start merge");
+              // the merge io is throttled on the disk of the tablet, the merger
+              // switches to the disk of the new sstable when it creates one
+              ObIOClassGuard io_guard(IO_CLASS_MERGE, tablet->get_disk_no());
               if ((err = merger->merge(tablet,tablet->get_data_version() + 1)) != OB_SUCCESS
                   && OB_CS_TABLE_HAS_DELETED != err)
               {
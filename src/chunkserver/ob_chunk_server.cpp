@@ -20,6 +20,8 @@
 #include "ob_chunk_callback.h"
 #include "common/ob_config_manager.h"
 #include "common/ob_profile_log.h"
+#include "common/ob_aio_backend.h"
+#include "common/ob_io_scheduler.h"
 
 using namespace oceanbase::common;
 
@@ -101,6 +103,18 @@ namespace oceanbase
       return tablet_manager_;
     }
 
+    void ObChunkServer::set_io_scheduler_config(const ObChunkServerConfig& config)
+    {
+      int64_t band_limit[IO_CLASS_NUM];
+      band_limit[IO_CLASS_FOREGROUND] = 0;
+      band_limit[IO_CLASS_MERGE] = config.merge_io_band_limit;
+      band_limit[IO_CLASS_MIGRATE] = config.migrate_io_band_limit;
+      band_limit[IO_CLASS_LOAD] = config.load_io_band_limit;
+      ObIOScheduler::get_instance().set_config(config.io_scheduler_enable,
+          config.io_foreground_latency_target, band_limit,
+          config.io_background_min_band_limit);
+    }
+
     int ObChunkServer::reload_config()
     {
       int ret = OB_SUCCESS;
@@ -108,6 +122,9 @@ namespace oceanbase
       const ObChunkServerConfig& config = get_config();
 
       tablet_manager.get_chunk_merge().set_config_param();
+      ObAIOBackend::set_config(config.aio_use_io_uring ? AIO_BACKEND_IO_URING : AIO_BACKEND_LIBAIO,
+                               config.aio_queue_depth);
+      set_io_scheduler_config(config);
       set_default_queue_size((int)config.task_queue_size);
       set_min_left_time(config.task_left_time);
       tablet_manager.get_serving_block_cache().enlarg_cache_size(config.block_cache_size);
@@ -393,6 +410,14 @@ namespace oceanbase
         ret = tablet_manager_.init(&config_);
       }
 
+      // aio backend of sstable scan, must be set before any scan thread starts
+      if (OB_SUCCESS == ret)
+      {
+        ObAIOBackend::set_config(config_.aio_use_io_uring ? AIO_BACKEND_IO_URING : AIO_BACKEND_LIBAIO,
+                                 config_.aio_queue_depth);
+        set_io_scheduler_config(config_);
+      }
+
       // server initialize, including start transport,
       // listen port, accept socket data from client
       if (OB_SUCCESS == ret)
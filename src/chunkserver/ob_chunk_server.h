@@ -89,6 +89,7 @@ namespace oceanbase
                                          const int64_t network_timeout);
         int init_file_service(const int32_t queue_size,
             const int32_t thread_cout, const int32_t band_limit);
+        void set_io_scheduler_config(const ObChunkServerConfig& config);
       private:
         // request service handler
         ObChunkService service_;
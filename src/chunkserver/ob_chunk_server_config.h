@@ -64,20 +64,31 @@ namespace oceanbase
 
         DEF_BOOL(lazy_load_sstable, "True", "lazy load sstable to speed up cs start");
         DEF_BOOL(unmerge_if_unchanged, "True", "merge sstable depend on it\\'s changed or not");
+        DEF_BOOL(merge_reuse_unchanged_block, "True", "copy the sstable blocks without incremental data into the new sstable in daily merge");
         DEF_INT(bypass_sstable_loader_thread_num, "0", "[0,10]", "bypass sstable loead thread number");
         DEF_CAP(compactsstable_cache_size, "0", "compacet sstable cache size");
         DEF_INT(compactsstable_cache_thread_num, "0", "[0,]", "compacet sstable cache thread number");
 
         DEF_CAP(migrate_band_limit_per_second, "50MB", "network band limit for migration");
 
+        DEF_BOOL(io_scheduler_enable, "True", "throttle the disk io of merge, migration and bypass loading to keep the query latency");
+        DEF_TIME(io_foreground_latency_target, "20ms", "[0,]", "slow down the background io of a disk if the query read latency of the disk beyonds this value, 0 means never slow down");
+        DEF_CAP(merge_io_band_limit, "100MB", "max disk band of daily merge for each disk, 0 means no limit");
+        DEF_CAP(migrate_io_band_limit, "0", "max disk band of tablet migration for each disk, 0 means no limit, the network band is limited by migrate_band_limit_per_second");
+        DEF_CAP(load_io_band_limit, "50MB", "max disk band of bypass sstable loading for each disk, 0 means no limit");
+        DEF_CAP(io_background_min_band_limit, "4MB", "min disk band of each background io class when it is slowed down");
+
         DEF_CAP(merge_mem_limit, "64MB", "memory usage to merge for each thread");
         DEF_INT(merge_thread_per_disk, "2", "[1,]", "merge thread per disk, increase the number will reduce daily merge time but increase response time");
         DEF_INT(max_merge_thread_num, "10", "[1,32]", "max merge thread number");
+        DEF_INT(merge_compress_thread_num, "0", "[0,16]", "block compress thread number of each merge thread, 0 means compress in merge thread");
         DEF_INT(merge_threshold_load_high, "16", "[1,]", "suspend some merge threads if system load beyond this value");
         DEF_INT(merge_threshold_request_high, "3000", "[1,]", "suspend some merge threads if get/scan number beyond this value");
         DEF_TIME(merge_delay_interval, "600s", "(0,]", "sleep time before start merge");
         DEF_TIME(merge_delay_for_lsync, "5s", "(0,)", "sleep time wait for ups synchronise frozen version if merge should read slave ups");
         DEF_BOOL(merge_scan_use_preread, "True", "prepread sstable when doing daily merge");
+        DEF_BOOL(aio_use_io_uring, "False", "read sstable by io_uring if the kernel supports it, otherwise use libaio");
+        DEF_INT(aio_queue_depth, "4", "[1,16]", "max number of requests in flight for each aio read buffer");
         DEF_TIME(merge_timeout, "10s", "(0,)", "fetch ups data timeout in merge");
 
         DEF_INT(merge_pause_row_count, "2000", "merge check after how many rows");
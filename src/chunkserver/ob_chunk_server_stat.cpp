@@ -15,12 +15,123 @@
  */
 
 
+#include <algorithm>
 #include "ob_chunk_server_stat.h"
 
 namespace oceanbase
 {
   namespace chunkserver
   {
-    /* empty */
+    using namespace common;
+
+    namespace
+    {
+      inline int64_t get_rate(const int64_t count, const int64_t last_count, const int64_t elapsed_us)
+      {
+        // the counters may be reset
+        return (count > last_count) ? (count - last_count) * 1000000 / elapsed_us : 0;
+      }
+
+      bool hotter_table(const ObTableLoad &lhs, const ObTableLoad &rhs)
+      {
+        return lhs.get_qps() > rhs.get_qps()
+          || (lhs.get_qps() == rhs.get_qps() && lhs.scan_bytes_ > rhs.scan_bytes_);
+      }
+
+      bool hotter_tablet(const ObTabletLoad &lhs, const ObTabletLoad &rhs)
+      {
+        return lhs.get_qps() > rhs.get_qps()
+          || (lhs.get_qps() == rhs.get_qps() && lhs.scan_bytes_ > rhs.scan_bytes_);
+      }
+    }
+
+    ObTableLoadCollector::ObTableLoadCollector()
+      : last_collect_time_(0), elapsed_us_(0), tablet_count_(0)
+    {
+      memset(last_counters_, 0, sizeof(last_counters_));
+    }
+
+    void ObTableLoadCollector::add_tablet_access(const ObNewRange &range, const uint64_t get_count,
+        const uint64_t scan_count, const uint64_t scan_bytes)
+    {
+      // the counters of the first collection are since the server started, discard them
+      if (elapsed_us_ > 0 && (get_count > 0 || scan_count > 0 || scan_bytes > 0))
+      {
+        ObTabletLoad load;
+        load.table_id_ = range.table_id_;
+        load.range_hash_ = ObTabletLoad::get_range_hash(range);
+        load.get_qps_ = static_cast<int64_t>(get_count) * 1000000 / elapsed_us_;
+        load.scan_qps_ = static_cast<int64_t>(scan_count) * 1000000 / elapsed_us_;
+        load.scan_bytes_ = static_cast<int64_t>(scan_bytes) * 1000000 / elapsed_us_;
+        if (tablet_count_ < ObServerLoad::MAX_TABLET_LOAD_COUNT)
+        {
+          tablet_loads_[tablet_count_++] = load;
+          std::push_heap(tablet_loads_, tablet_loads_ + tablet_count_, hotter_tablet);
+        }
+        else if (hotter_tablet(load, tablet_loads_[0]))
+        {
+          std::pop_heap(tablet_loads_, tablet_loads_ + tablet_count_, hotter_tablet);
+          tablet_loads_[tablet_count_ - 1] = load;
+          std::push_heap(tablet_loads_, tablet_loads_ + tablet_count_, hotter_tablet);
+        }
+      }
+    }
+
+    void ObTableLoadCollector::refresh(const ObStatManager &stat_mgr, const int64_t now)
+    {
+      const int64_t elapsed_us = now - last_collect_time_;
+      int64_t table_count = 0;
+      int64_t index = 0;
+      ObStatManager::const_iterator it = stat_mgr.begin(OB_STAT_CHUNKSERVER);
+
+      // the position of a table in stat manager never changes
+      for (; it != stat_mgr.end(OB_STAT_CHUNKSERVER) && index < OB_MAX_TABLE_NUMBER; ++it, ++index)
+      {
+        TableCounter &last = last_counters_[index];
+        const uint64_t table_id = it->get_table_id();
+        const int64_t get_count = it->get_value(INDEX_GET_COUNT);
+        const int64_t scan_count = it->get_value(INDEX_SCAN_COUNT);
+        const int64_t scan_bytes = it->get_value(INDEX_SCAN_BYTES);
+
+        // table 0 holds the server wide stats
+        if (0 != table_id && OB_INVALID_ID != table_id
+            && last.table_id_ == table_id && 0 != last_collect_time_ && elapsed_us > 0)
+        {
+          ObTableLoad &load = table_loads_[table_count];
+          load.table_id_ = table_id;
+          load.get_qps_ = get_rate(get_count, last.get_count_, elapsed_us);
+          load.scan_qps_ = get_rate(scan_count, last.scan_count_, elapsed_us);
+          load.scan_bytes_ = get_rate(scan_bytes, last.scan_bytes_, elapsed_us);
+          if (load.get_qps() > 0 || load.scan_bytes_ > 0)
+          {
+            ++table_count;
+          }
+        }
+        last.table_id_ = table_id;
+        last.get_count_ = get_count;
+        last.scan_count_ = scan_count;
+        last.scan_bytes_ = scan_bytes;
+      }
+
+      if (table_count > ObServerLoad::MAX_TABLE_LOAD_COUNT)
+      {
+        std::partial_sort(table_loads_, table_loads_ + ObServerLoad::MAX_TABLE_LOAD_COUNT,
+            table_loads_ + table_count, hotter_table);
+        table_count = ObServerLoad::MAX_TABLE_LOAD_COUNT;
+      }
+      load_.reset();
+      for (int64_t i = 0; i < table_count; ++i)
+      {
+        load_.add_table_load(table_loads_[i]);
+      }
+      std::sort_heap(tablet_loads_, tablet_loads_ + tablet_count_, hotter_tablet);
+      for (int64_t i = 0; i < tablet_count_; ++i)
+      {
+        load_.add_tablet_load(tablet_loads_[i]);
+      }
+      last_collect_time_ = now;
+      TBSYS_LOG(DEBUG, "refresh table load, table_count=%ld tablet_count=%ld elapsed_us=%ld",
+          table_count, tablet_count_, elapsed_us);
+    }
   }
 }
@@ -17,8 +17,10 @@
 #ifndef OCEANBASE_CHUNKSERVER_OB_CHUNK_SERVER_STAT_H_
 #define OCEANBASE_CHUNKSERVER_OB_CHUNK_SERVER_STAT_H_
 
+#include <tbsys.h>
 #include "common/ob_statistics.h"
 #include "common/ob_common_stat.h"
+#include "common/ob_server_load.h"
 namespace oceanbase
 {
   namespace chunkserver
@@ -34,6 +36,76 @@ namespace oceanbase
           set_id2name(common::OB_STAT_SSTABLE, common::ObStatSingleton::sstable_map, common::SSTABLE_STAT_MAX);
         }
     };
+
+    /**
+     * compute the query rates of each table from the counters of the stat
+     * manager and the rates of each tablet from the access counters of the
+     * tablets, the hottest tables and tablets are reported to rootserver by
+     * heartbeat for the load based balance.
+     */
+    class ObTableLoadCollector
+    {
+      public:
+        static const int64_t COLLECT_INTERVAL_US = 10 * 1000 * 1000;
+
+      public:
+        ObTableLoadCollector();
+        ~ObTableLoadCollector() {}
+
+        /**
+         * refresh the rates if COLLECT_INTERVAL_US passed since last
+         * collection, then get the load of the hottest tables and tablets
+         * @param image tablet image which calls add_tablet_access() with
+         * the access counters of each tablet since last call in
+         * fetch_tablet_access(ObTableLoadCollector&)
+         */
+        template <typename TabletImage>
+        void collect(const common::ObStatManager &stat_mgr, const TabletImage &image,
+            common::ObServerLoad &load)
+        {
+          collect(stat_mgr, image, tbsys::CTimeUtil::getTime(), load);
+        }
+        template <typename TabletImage>
+        void collect(const common::ObStatManager &stat_mgr, const TabletImage &image,
+            const int64_t now, common::ObServerLoad &load)
+        {
+          tbsys::CThreadGuard guard(&mutex_);
+          if (0 == last_collect_time_ || now - last_collect_time_ >= COLLECT_INTERVAL_US)
+          {
+            tablet_count_ = 0;
+            elapsed_us_ = (0 == last_collect_time_) ? 0 : now - last_collect_time_;
+            image.fetch_tablet_access(*this);
+            refresh(stat_mgr, now);
+          }
+          load = load_;
+        }
+
+        /// called by the tablet image during collect()
+        void add_tablet_access(const common::ObNewRange &range, const uint64_t get_count,
+            const uint64_t scan_count, const uint64_t scan_bytes);
+
+      private:
+        struct TableCounter
+        {
+          uint64_t table_id_;
+          int64_t get_count_;
+          int64_t scan_count_;
+          int64_t scan_bytes_;
+        };
+        void refresh(const common::ObStatManager &stat_mgr, const int64_t now);
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObTableLoadCollector);
+        tbsys::CThreadMutex mutex_;
+        int64_t last_collect_time_;
+        int64_t elapsed_us_;
+        TableCounter last_counters_[common::OB_MAX_TABLE_NUMBER];
+        common::ObTableLoad table_loads_[common::OB_MAX_TABLE_NUMBER];
+        // heap of the hottest tablets, the coldest one is on the top
+        int64_t tablet_count_;
+        common::ObTabletLoad tablet_loads_[common::ObServerLoad::MAX_TABLET_LOAD_COUNT];
+        common::ObServerLoad load_;
+    };
   } /* chunkserver */
 } /* oceanbase */
 #endif
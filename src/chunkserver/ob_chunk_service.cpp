@@ -921,6 +921,7 @@ namespace oceanbase
       int64_t start_time = tbsys::CTimeUtil::getTime();
       uint64_t  table_id = OB_INVALID_ID; //for stat
       bool is_scan = true; //for stat
+      int64_t scan_bytes = 0; //for stat
       ObNewScanner* new_scanner = GET_TSI_MULT(ObNewScanner, TSI_CS_NEW_SCANNER_1);
       int64_t session_id = 0;
       int32_t response_cid = channel_id;
@@ -1087,6 +1088,7 @@ namespace oceanbase
           if (is_scan)
           {
             OB_STAT_TABLE_INC(CHUNKSERVER, table_id, INDEX_SCAN_BYTES, out_buffer.get_position());
+            scan_bytes += out_buffer.get_position();
           }
           else
           {
@@ -1172,6 +1174,10 @@ namespace oceanbase
       {
         ObTabletManager& tablet_manager = chunk_server_->get_tablet_manager();
         ObTablet*& tablet = tablet_manager.get_cur_thread_scan_tablet();
+        if (is_scan && tablet != NULL)
+        {
+          tablet->inc_access(0, 1, scan_bytes);
+        }
         if (tablet != NULL && check_update_data(*tablet,ups_data_version,release_tablet) != OB_SUCCESS)
         {
           TBSYS_LOG(WARN,"check update data failed"); //just warn
@@ -1210,6 +1216,7 @@ namespace oceanbase
       common::ObResultCode rc;
       rc.result_code_ = OB_SUCCESS;
       uint64_t  table_id = OB_INVALID_ID; //for stat
+      int64_t scan_bytes = 0; //for stat
       ObQueryService* query_service = NULL;
       ObScanner* scanner = GET_TSI_MULT(ObScanner, TSI_CS_SCANNER_1);
       common::ObScanParam *scan_param_ptr = GET_TSI_MULT(ObScanParam, TSI_CS_SCAN_PARAM_1);
@@ -1322,6 +1329,7 @@ namespace oceanbase
         if (OB_SUCCESS == serialize_ret)
         {
           OB_STAT_TABLE_INC(CHUNKSERVER, table_id, INDEX_SCAN_BYTES, out_buffer.get_position());
+          scan_bytes += out_buffer.get_position();
           chunk_server_->send_response(
               is_last_packet ? OB_SESSION_END : OB_SCAN_RESPONSE, CS_SCAN_VERSION,
               out_buffer, req, response_cid, session_id);
@@ -1383,6 +1391,10 @@ namespace oceanbase
       {
         ObTabletManager& tablet_manager = chunk_server_->get_tablet_manager();
         ObTablet*& tablet = tablet_manager.get_cur_thread_scan_tablet();
+        if (tablet != NULL)
+        {
+          tablet->inc_access(0, 1, scan_bytes);
+        }
         if (tablet != NULL && check_update_data(*tablet,ups_data_version,release_tablet) != OB_SUCCESS)
         {
           TBSYS_LOG(WARN,"check update data failed"); //just warn
@@ -1507,7 +1519,11 @@ namespace oceanbase
       // send heartbeat request to root_server first
       if (OB_SUCCESS == rc.result_code_)
       {
-        rc.result_code_ = CS_RPC_CALL_RS(heartbeat_server, chunk_server_->get_self(), OB_CHUNKSERVER);
+        // report the query load of the hottest tables and tablets for balance
+        ObServerLoad load;
+        table_load_collector_.collect(chunk_server_->get_stat_manager(),
+            chunk_server_->get_tablet_manager().get_serving_tablet_image(), load);
+        rc.result_code_ = CS_RPC_CALL_RS(heartbeat_server, chunk_server_->get_self(), OB_CHUNKSERVER, load);
         if (OB_SUCCESS != rc.result_code_)
         {
           TBSYS_LOG(WARN, "failed to async_heartbeat, ret=%d", rc.result_code_);
@@ -18,6 +18,7 @@
 #include "common/thread_buffer.h"
 #include "common/ob_timer.h"
 #include "ob_schema_task.h"
+#include "ob_chunk_server_stat.h"
 #include "easy_io.h"
 #include "common/ob_cur_time.h"
 #include "common/ob_ms_list.h"
@@ -375,6 +376,7 @@ namespace oceanbase
         common::TimeUpdateDuty time_update_duty_;
         common::MsList ms_list_task_;
         common::ThreadSpecificBuffer query_service_buffer_;
+        ObTableLoadCollector table_load_collector_;
     };
 
 
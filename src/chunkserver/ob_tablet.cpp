@@ -252,6 +252,9 @@ namespace oceanbase
       compact_header_ = NULL;
       compact_tail_ = NULL;
       ref_count_ = 0;
+      get_count_ = 0;
+      scan_count_ = 0;
+      scan_bytes_ = 0;
       image_ = NULL;
       memset(&extend_info_, 0, sizeof(extend_info_));
       sstable_id_list_.clear();
@@ -161,6 +161,20 @@ namespace oceanbase
         inline void inc_merge_count() { ++merge_count_; }
         inline uint32_t inc_ref() { return common::atomic_inc(&ref_count_); }
         inline uint32_t dec_ref() { return common::atomic_dec(&ref_count_); }
+        // access counters of the tablet, reported to rootserver by heartbeat
+        inline void inc_access(const uint64_t get_count, const uint64_t scan_count, const uint64_t scan_bytes)
+        {
+          if (0 < get_count) common::atomic_add(&get_count_, get_count);
+          if (0 < scan_count) common::atomic_add(&scan_count_, scan_count);
+          if (0 < scan_bytes) common::atomic_add(&scan_bytes_, scan_bytes);
+        }
+        // get the counters since last fetch and clear them
+        inline void fetch_access(uint64_t &get_count, uint64_t &scan_count, uint64_t &scan_bytes)
+        {
+          get_count = common::atomic_exchange(&get_count_, 0);
+          scan_count = common::atomic_exchange(&scan_count_, 0);
+          scan_bytes = common::atomic_exchange(&scan_bytes_, 0);
+        }
         inline int32_t get_compactsstable_num() {return compactsstable_num_;}
         int add_compactsstable(compactsstable::ObCompactSSTableMemNode* cache);
         compactsstable::ObCompactSSTableMemNode* get_compactsstable_list();
@@ -197,6 +211,9 @@ namespace oceanbase
         int32_t compactsstable_num_;
         volatile uint32_t compactsstable_loading_;
         volatile uint32_t ref_count_;
+        volatile uint64_t get_count_;
+        volatile uint64_t scan_count_;
+        volatile uint64_t scan_bytes_;
         int64_t data_version_;
         ObTabletExtendInfo extend_info_;
         tbsys::CThreadMutex extend_info_mutex_;
@@ -24,6 +24,7 @@
 #include "ob_tablet.h"
 #include "ob_disk_manager.h"
 #include "ob_fileinfo_cache.h"
+#include "ob_chunk_server_stat.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::common::serialization;
@@ -3272,6 +3273,36 @@ namespace oceanbase
       }
     }
 
+    int ObMultiVersionTabletImage::fetch_tablet_access(ObTableLoadCollector &collector) const
+    {
+      int ret = OB_SUCCESS;
+      uint64_t get_count = 0;
+      uint64_t scan_count = 0;
+      uint64_t scan_bytes = 0;
+
+      tbsys::CRLockGuard guard(lock_);
+
+      int64_t index = service_index_;
+      if (index >= 0 && index < MAX_RESERVE_VERSION_COUNT && has_tablet(index))
+      {
+        const ObTabletImage &image = *image_tracker_[index];
+        for (int32_t i = 0; i < image.tablet_list_.size(); ++i)
+        {
+          ObTablet *tablet = image.tablet_list_.at(i);
+          tablet->fetch_access(get_count, scan_count, scan_bytes);
+          if (get_count > 0 || scan_count > 0 || scan_bytes > 0)
+          {
+            collector.add_tablet_access(tablet->get_range(), get_count, scan_count, scan_bytes);
+          }
+        }
+      }
+      else
+      {
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      return ret;
+    }
+
     int ObMultiVersionTabletImage::delete_table(const uint64_t table_id)
     {
       int ret = OB_SUCCESS;
@@ -96,6 +96,7 @@ namespace oceanbase
     };
 
     class ObDiskManager;
+    class ObTableLoadCollector;
 
     class ObMultiVersionTabletImage;
     class ObTabletImage
@@ -411,6 +412,13 @@ namespace oceanbase
         int64_t get_serving_version() const;
 
         void dump(const bool dump_sstable = true) const;
+
+        /**
+         * fetch and clear the access counters of the serving tablets,
+         * add the tablets accessed since last fetch to %collector
+         */
+        int fetch_tablet_access(ObTableLoadCollector &collector) const;
+
         inline void reset()
         {
           for (int64_t i = 0; i < MAX_RESERVE_VERSION_COUNT; ++i)
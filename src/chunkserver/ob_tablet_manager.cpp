@@ -25,6 +25,7 @@
 #include "common/ob_tablet_info.h"
 #include "common/ob_scanner.h"
 #include "common/ob_atomic.h"
+#include "common/ob_io_scheduler.h"
 #include "sstable/ob_sstable_getter.h"
 #include "sstable/ob_disk_path.h"
 #include "ob_tablet.h"
@@ -261,6 +262,7 @@ namespace oceanbase
       int rc = OB_SUCCESS;
       ObMultiVersionTabletImage & tablet_image = get_serving_tablet_image();
       ObTablet * tablet = NULL;
+      int32_t src_disk_no = -1;
       char dest_dir_buf[OB_MAX_FILE_NAME_LENGTH];
       char dest_filename_buf[OB_MAX_FILE_NAME_LENGTH];
 
@@ -319,6 +321,7 @@ namespace oceanbase
         tablet_version = tablet->get_data_version();
         tablet_seq_num = tablet->get_sequence_num();
         crc_sum = tablet->get_checksum();
+        src_disk_no = tablet->get_disk_no();
         TBSYS_LOG(INFO, "migrate_tablet sstable file num =%ld , version=%ld, checksum=%lu",
             num_file, tablet_version, crc_sum);
       }
@@ -384,6 +387,9 @@ namespace oceanbase
         int64_t timeout = THE_CHUNK_SERVER.get_config().network_timeout;
         int64_t band_limit = THE_CHUNK_SERVER.get_config().migrate_band_limit_per_second;
         common::ObFileClient& file_client = THE_CHUNK_SERVER.get_file_client();
+        // the network band is limited by send_file, the disk reads of the
+        // sstables are background io limited by migrate_io_band_limit
+        ObIOClassGuard io_guard(IO_CLASS_MIGRATE, src_disk_no);
 
         for(int64_t idx = 0; idx < num_file && OB_SUCCESS == rc; idx++)
         {
@@ -898,6 +904,9 @@ namespace oceanbase
         {
           thread_get_context = get_context;
         }
+        // the whole get is charged to the tablet of the first row, which is
+        // already held here, so no extra lookup in the tablet image is needed
+        get_context->tablets_[0]->inc_access(1, 0, 0);
 
 #ifdef OB_PROFILER
         PROFILER_BEGIN("init_sstable_getter");
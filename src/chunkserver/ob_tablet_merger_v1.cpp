@@ -20,6 +20,7 @@
 #include "sstable/ob_sstable_schema.h"
 #include "ob_chunk_server_main.h"
 #include "common/file_directory_utils.h"
+#include "common/ob_io_scheduler.h"
 #include "ob_chunk_merge.h"
 #include "ob_tablet_manager.h"
 
@@ -983,6 +984,11 @@ namespace oceanbase
               manager_.get_disk_manager().set_disk_status(disk_no,DISK_ERROR);
             TBSYS_LOG(ERROR,"Merge : create sstable failed : [%d]",ret);
           }
+          else
+          {
+            // the writes of the new sstable are throttled on its disk
+            ObIOScheduler::set_thread_io_disk(disk_no);
+          }
         }
       }
       return ret;
@@ -18,6 +18,7 @@
 #include "ob_tablet_merger_v2.h"
 #include "common/ob_schema.h"
 #include "common/file_directory_utils.h"
+#include "common/ob_io_scheduler.h"
 #include "compactsstablev2/ob_sstable_store_struct.h"
 #include "compactsstablev2/ob_sstable_schema.h"
 #include "sql/ob_sql_scan_param.h"
@@ -38,7 +39,7 @@ namespace oceanbase
      *-----------------------------------------------------------------------------*/
 
     ObTabletMergerV2::ObTabletMergerV2(ObChunkMerge& chunk_merge, ObTabletManager& manager) 
-      : ObTabletMerger(chunk_merge, manager)
+      : ObTabletMerger(chunk_merge, manager), is_tail_dirty_(false)
     {}
 
     int ObTabletMergerV2::init()
@@ -56,6 +57,16 @@ namespace oceanbase
         }
       }
 
+      if (OB_SUCCESS == ret)
+      {
+        int64_t compress_thread_num = chunk_server.get_config().merge_compress_thread_num;
+        if (OB_SUCCESS != (ret = writer_.set_compress_thread_num(compress_thread_num)))
+        {
+          TBSYS_LOG(ERROR, "set compress thread num error, compress_thread_num=%ld, ret=%d",
+              compress_thread_num, ret);
+        }
+      }
+
       return ret;
     }
 
@@ -75,18 +86,15 @@ namespace oceanbase
       op_ups_scan_.reset();
       op_ups_multi_get_.reset();
       writer_.reset();
+
+      raw_block_reader_.reset();
+      dirty_block_list_.clear();
+      is_tail_dirty_ = false;
       return OB_SUCCESS;
     }
 
-    int ObTabletMergerV2::init_sstable_writer(const common::ObTableSchema & table_schema, 
-        const ObTablet* tablet, const int64_t frozen_version)
+    int64_t ObTabletMergerV2::get_sstable_block_size(const common::ObTableSchema & table_schema)
     {
-      int ret = OB_SUCCESS;
-      compactsstablev2::ObFrozenMinorVersionRange version_range;
-      version_range.major_version_ = frozen_version;
-      ObCompactStoreType store_type = DENSE_DENSE; 
-      int64_t table_count = 1;  // chunkserver sstable always 1
-
       // if schema define sstable block size for table, use it
       // for the schema with version 2, the default block size is 64(KB),
       // we skip this case and use the config of chunkserver
@@ -96,6 +104,19 @@ namespace oceanbase
       {
         sstable_block_size = table_schema.get_block_size();
       }
+      return sstable_block_size;
+    }
+
+    int ObTabletMergerV2::init_sstable_writer(const common::ObTableSchema & table_schema, 
+        const ObTablet* tablet, const int64_t frozen_version)
+    {
+      int ret = OB_SUCCESS;
+      compactsstablev2::ObFrozenMinorVersionRange version_range;
+      version_range.major_version_ = frozen_version;
+      ObCompactStoreType store_type = DENSE_DENSE; 
+      int64_t table_count = 1;  // chunkserver sstable always 1
+
+      int64_t sstable_block_size = get_sstable_block_size(table_schema);
 
       int64_t max_sstable_size = OB_DEFAULT_MAX_TABLET_SIZE;
       int64_t min_split_sstable_size = 0;
@@ -278,11 +299,37 @@ namespace oceanbase
       return ret;
     }
 
+    int ObTabletMergerV2::open_range(const ObNewRange& range)
+    {
+      int ret = OB_SUCCESS;
+
+      if (OB_SUCCESS != tablet_scan_.close())
+      {
+        TBSYS_LOG(WARN, "tablet_scan_ close error.");
+      }
+      tablet_scan_.reset();
+
+      if (OB_SUCCESS != (ret = sql_scan_param_.set_range(range)))
+      {
+        TBSYS_LOG(WARN, "set range failed:[%d] range:%s", ret, to_cstring(range));
+      }
+      else if (OB_SUCCESS != (ret = tablet_scan_.create_plan(chunk_merge_.current_schema_)))
+      {
+        TBSYS_LOG(WARN, "fail to create plan:ret[%d], range:%s", ret, to_cstring(range));
+      }
+      else if (OB_SUCCESS != (ret = tablet_scan_.open()))
+      {
+        TBSYS_LOG(WARN, "open tablet scan fail:ret[%d], range:%s", ret, to_cstring(range));
+      }
+
+      return ret;
+    }
+
     int ObTabletMergerV2::do_merge()
     {
       int ret = OB_SUCCESS;
       bool is_tablet_unchanged = false;
-      bool is_sstable_split = false;
+      bool is_reuse_block = false;
       bool need_filter = tablet_merge_filter_.need_filter();
       /**
        * there are 2 cases that we cann't do "unmerge_if_unchanged"
@@ -315,9 +362,51 @@ namespace oceanbase
       {
         TBSYS_LOG(ERROR,"create sstable failed.");
       }
+      else if (OB_SUCCESS != (ret = prepare_reuse_block(is_reuse_block)))
+      {
+        TBSYS_LOG(WARN, "prepare_reuse_block error, ret=%d", ret);
+      }
+      else if (is_reuse_block)
+      {
+        ret = merge_reuse_block();
+      }
+      else
+      {
+        ret = merge_rows();
+      }
 
+      if (OB_SUCCESS == ret && !is_tablet_unchanged)
+      {
+        // the blocks compressed in background may split the sstable
+        if (OB_SUCCESS != (ret = flush_sstable()))
+        {
+          TBSYS_LOG(WARN, "flush_sstable error ret=%d", ret);
+        }
+        else
+        {
+          // finish the last sstable
+          ret = finish_sstable(false, is_tablet_unchanged);
+          TBSYS_LOG(INFO, "scan row END, finish current sstable reuse_block=%d, unchanged=%d,ret=%d", 
+              is_reuse_block, is_tablet_unchanged, ret);
+        }
+      }
+
+      if (OB_SUCCESS !=  tablet_scan_.close())
+      {
+        TBSYS_LOG(WARN, "tablet_scan_ close error.");
+      }
+      CLEAR_TRACE_LOG();
+
+      return ret;
+    }
+
+    int ObTabletMergerV2::merge_rows()
+    {
+      int ret = OB_SUCCESS;
+      bool is_sstable_split = false;
       const ObRow *cur_row = NULL;
-      while (OB_SUCCESS == ret && !is_tablet_unchanged)
+
+      while (OB_SUCCESS == ret)
       {
         if ( manager_.is_stoped() )
         {
@@ -331,10 +420,7 @@ namespace oceanbase
 
         if (OB_ITER_END == ret)
         {
-          // finish the last sstable
-          ret = finish_sstable(is_sstable_split, is_tablet_unchanged);
-          TBSYS_LOG(INFO, "scan row END, finish current sstable split=%d, unchanged=%d,ret=%d", 
-              is_sstable_split, is_tablet_unchanged, ret);
+          ret = OB_SUCCESS;
           break;
         }
         else if (OB_SUCCESS == ret && NULL != cur_row)
@@ -347,7 +433,7 @@ namespace oceanbase
           {
             TBSYS_LOG(INFO, "split tablet, range=%s, cur_row=%s", 
                 to_cstring(old_tablet_->get_range()), to_cstring(*cur_row));
-            if (OB_SUCCESS != (ret = finish_sstable(is_sstable_split, is_tablet_unchanged)))
+            if (OB_SUCCESS != (ret = finish_sstable(is_sstable_split, false)))
             {
               TBSYS_LOG(WARN, "finish_sstable error ret=%d", ret);
             }
@@ -367,11 +453,392 @@ namespace oceanbase
         }
       }
 
-      if (OB_SUCCESS !=  tablet_scan_.close())
+      return ret;
+    }
+
+    int ObTabletMergerV2::prepare_reuse_block(bool& reuse_block)
+    {
+      int ret = OB_SUCCESS;
+      reuse_block = false;
+
+      if (OB_SUCCESS != (ret = check_reuse_block(reuse_block)))
       {
-        TBSYS_LOG(WARN, "tablet_scan_ close error.");
+        TBSYS_LOG(WARN, "check_reuse_block error, ret=%d", ret);
+      }
+      else if (reuse_block && OB_SUCCESS != (ret = mark_dirty_blocks(reuse_block)))
+      {
+        TBSYS_LOG(WARN, "mark_dirty_blocks error, ret=%d", ret);
+      }
+
+      if (OB_CS_MERGE_CANCELED != ret && OB_SUCCESS != ret)
+      {
+        // merge all the rows of the tablet instead
+        TBSYS_LOG(WARN, "cannot reuse the blocks of tablet %s, merge rows, ret=%d",
+            to_cstring(old_tablet_->get_range()), ret);
+        ret = OB_SUCCESS;
+        reuse_block = false;
+      }
+
+      if (!reuse_block)
+      {
+        raw_block_reader_.reset();
+      }
+
+      return ret;
+    }
+
+    int ObTabletMergerV2::check_reuse_block(bool& reuse_block)
+    {
+      int ret = OB_SUCCESS;
+      const uint64_t table_id = old_tablet_->get_range().table_id_;
+      compactsstablev2::ObCompactSSTableReader* sstable_reader[1] = {NULL};
+      int32_t sstable_size = 1;
+      const ObTableSchema* table_schema = NULL;
+      const compactsstablev2::ObSSTableHeader* sstable_header = NULL;
+      const char* compressor_name = NULL;
+      const TableBloomFilter* bloomfilter = NULL;
+      reuse_block = false;
+
+      /**
+       * the blocks of the old sstable can be copied into the new sstable
+       * only if the rows in new sstable are exactly the same as the old
+       * one without incremental data
+       * 1. no data need expire
+       * 2. no column need join another table
+       * 3. the sstable is written in the same format with the same schema
+       */
+      if (!THE_CHUNK_SERVER.get_config().merge_reuse_unchanged_block
+          || tablet_merge_filter_.need_filter()
+          || tablet_scan_.has_join_data()
+          || 1 != old_tablet_->get_sstable_id_list().count())
+      {
+        // merge rows
+      }
+      else if (OB_SUCCESS != (ret = old_tablet_->find_sstable(
+              old_tablet_->get_range(), sstable_reader, sstable_size)))
+      {
+        TBSYS_LOG(WARN, "find_sstable error, ret=%d, range=%s",
+            ret, to_cstring(old_tablet_->get_range()));
+      }
+      else if (1 != sstable_size || NULL == sstable_reader[0])
+      {
+        // old sstable is not compact sstable
+      }
+      else if (NULL == (table_schema = chunk_merge_.current_schema_.get_table_schema(table_id)))
+      {
+        TBSYS_LOG(WARN, "table (%lu) has been deleted", table_id);
+        ret = OB_ERR_UNEXPECTED;
+      }
+      else if (NULL == (sstable_header = sstable_reader[0]->get_sstable_header())
+          || NULL == sstable_reader[0]->get_schema()
+          || NULL == (compressor_name = table_schema->get_compress_func_name())
+          || DENSE_DENSE != sstable_reader[0]->get_row_store_type()
+          || get_sstable_block_size(*table_schema) != sstable_header->block_size_
+          || 0 != strncmp(compressor_name, sstable_header->compressor_name_,
+            compactsstablev2::ObSSTableHeader::MAX_COMPRESSOR_NAME_SIZE)
+          || !sstable_reader[0]->get_schema()->is_same_table_schema(table_id, sstable_schema_))
+      {
+        TBSYS_LOG(INFO, "sstable format or schema changed, merge rows, range=%s",
+            to_cstring(old_tablet_->get_range()));
+      }
+      else if (OB_SUCCESS != (ret = raw_block_reader_.init(*sstable_reader[0], table_id,
+              manager_.get_compact_block_index_cache(), manager_.get_fileinfo_cache())))
+      {
+        TBSYS_LOG(WARN, "init raw block reader error, ret=%d, table_id=%lu", ret, table_id);
+      }
+      else if (NULL == (bloomfilter = raw_block_reader_.get_bloomfilter())
+          || compactsstablev2::SSTABLE_BLOOMFILTER_SIZE != bloomfilter->get_nbyte())
+      {
+        TBSYS_LOG(INFO, "sstable bloomfilter mismatch, merge rows, range=%s",
+            to_cstring(old_tablet_->get_range()));
+      }
+      else
+      {
+        reuse_block = true;
+      }
+
+      return ret;
+    }
+
+    int ObTabletMergerV2::mark_dirty_blocks(bool& reuse_block)
+    {
+      int ret = OB_SUCCESS;
+      ObChunkServer & chunkserver = THE_CHUNK_SERVER;
+      const ObNewRange& range = old_tablet_->get_range();
+      const uint64_t table_id = range.table_id_;
+      const compactsstablev2::ObSSTableSchemaColumnDef* def = NULL;
+      int64_t column_size = 0;
+      ObVersionRange version_range;
+      const ObRowkey* rowkey = NULL;
+      const ObRow* row = NULL;
+      const int64_t block_count = raw_block_reader_.get_block_count();
+      int64_t cursor = 0;
+      int64_t dirty_block_count = 0;
+      int64_t dirty_range_count = 0;
+
+      /**
+       * scan the incremental data of the tablet in update server, every
+       * block which covers a modified rowkey is dirty, the rowkeys after
+       * the last block make the tail of tablet dirty
+       */
+      version_range.start_version_ = ObVersion(old_tablet_->get_data_version() + 1);
+      version_range.border_flag_.unset_min_value();
+      version_range.border_flag_.set_inclusive_start();
+      version_range.end_version_ = ObVersion(frozen_version_);
+      version_range.border_flag_.unset_max_value();
+      version_range.border_flag_.set_inclusive_end();
+
+      op_ups_scan_.reset();
+      op_ups_scan_.set_version_range(version_range);
+      op_ups_scan_.set_is_read_consistency(false);
+      dirty_block_list_.clear();
+      is_tail_dirty_ = false;
+
+      for (int64_t i = 0; i < block_count && OB_SUCCESS == ret; ++i)
+      {
+        ret = dirty_block_list_.push_back(false);
+      }
+
+      if (OB_SUCCESS != ret)
+      {
+        TBSYS_LOG(WARN, "init dirty block list error, ret=%d, block_count=%ld", ret, block_count);
+      }
+      else if (OB_SUCCESS != (ret = op_ups_scan_.set_ups_rpc_proxy(chunkserver.get_rpc_proxy())))
+      {
+        TBSYS_LOG(WARN, "ups scan set ups rpc stub fail:ret[%d]", ret);
+      }
+      else if (OB_SUCCESS != (ret = op_ups_scan_.set_network_timeout(
+              chunkserver.get_config().network_timeout)))
+      {
+        TBSYS_LOG(WARN, "set ups scan timeout fail:ret[%d]", ret);
+      }
+      else if (OB_SUCCESS != (ret = op_ups_scan_.set_range(range)))
+      {
+        TBSYS_LOG(WARN, "ups scan set range fail:ret[%d], range=%s", ret, to_cstring(range));
+      }
+
+      // any modified column makes the row dirty
+      for (int32_t k = 0; k < 2 && OB_SUCCESS == ret; ++k)
+      {
+        if (NULL == (def = sstable_schema_.get_table_schema(table_id, 0 == k, column_size)))
+        {
+          TBSYS_LOG(WARN, "get table schema error, table_id=%lu, is_rowkey=%d", table_id, 0 == k);
+          ret = OB_ERR_UNEXPECTED;
+        }
+        for (int64_t i = 0; i < column_size && OB_SUCCESS == ret; ++i)
+        {
+          if (OB_SUCCESS != (ret = op_ups_scan_.add_column(def[i].column_id_)))
+          {
+            TBSYS_LOG(WARN, "op ups scan add column fail:ret[%d]", ret);
+          }
+        }
+      }
+
+      if (OB_SUCCESS != ret)
+      {
+      }
+      else if (OB_SUCCESS != (ret = op_ups_scan_.open()))
+      {
+        TBSYS_LOG(WARN, "open ups scan fail:ret[%d], range=%s", ret, to_cstring(range));
+      }
+      else
+      {
+        while (OB_SUCCESS == ret)
+        {
+          if ( manager_.is_stoped() )
+          {
+            TBSYS_LOG(WARN, "stop in merging");
+            ret = OB_CS_MERGE_CANCELED;
+          }
+          else if (OB_SUCCESS != (ret = op_ups_scan_.get_next_row(rowkey, row)))
+          {
+            if (OB_ITER_END == ret)
+            {
+              ret = OB_SUCCESS;
+              break;
+            }
+            TBSYS_LOG(WARN, "ups scan get_next_row error, ret=%d", ret);
+          }
+          else
+          {
+            while (cursor < block_count && raw_block_reader_.get_block_endkey(cursor) < *rowkey)
+            {
+              ++cursor;
+            }
+            if (cursor < block_count)
+            {
+              dirty_block_list_.at(cursor) = true;
+            }
+            else
+            {
+              is_tail_dirty_ = true;
+            }
+          }
+        }
+
+        if (OB_SUCCESS != op_ups_scan_.close())
+        {
+          TBSYS_LOG(WARN, "op_ups_scan_ close error.");
+        }
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        for (int64_t i = 0; i < block_count; ++i)
+        {
+          if (dirty_block_list_.at(i))
+          {
+            ++dirty_block_count;
+            if (0 == i || !dirty_block_list_.at(i - 1))
+            {
+              ++dirty_range_count;
+            }
+          }
+        }
+        if (is_tail_dirty_ && (0 == block_count || !dirty_block_list_.at(block_count - 1)))
+        {
+          ++dirty_range_count;
+        }
+
+        reuse_block = (dirty_block_count < block_count
+            && dirty_range_count <= MAX_REUSE_DIRTY_RANGE_COUNT);
+        TBSYS_LOG(INFO, "mark dirty blocks, range=%s, block_count=%ld, dirty_block_count=%ld, "
+            "dirty_range_count=%ld, tail_dirty=%d, reuse_block=%d",
+            to_cstring(range), block_count, dirty_block_count, dirty_range_count,
+            is_tail_dirty_, reuse_block);
+      }
+
+      return ret;
+    }
+
+    int ObTabletMergerV2::merge_reuse_block()
+    {
+      int ret = OB_SUCCESS;
+      const int64_t block_count = raw_block_reader_.get_block_count();
+      int64_t index = 0;
+      int64_t start = 0;
+      int64_t reuse_block_count = 0;
+
+      while (OB_SUCCESS == ret && index < block_count)
+      {
+        if ( manager_.is_stoped() )
+        {
+          TBSYS_LOG(WARN, "stop in merging");
+          ret = OB_CS_MERGE_CANCELED;
+        }
+        else if (!dirty_block_list_.at(index))
+        {
+          if (OB_SUCCESS != (ret = reuse_block(index)))
+          {
+            TBSYS_LOG(WARN, "reuse_block error, ret=%d, index=%ld", ret, index);
+          }
+          else
+          {
+            ++reuse_block_count;
+            ++index;
+          }
+        }
+        else
+        {
+          start = index;
+          while (index < block_count && dirty_block_list_.at(index))
+          {
+            ++index;
+          }
+          if (OB_SUCCESS != (ret = merge_dirty_blocks(start, index)))
+          {
+            TBSYS_LOG(WARN, "merge_dirty_blocks error, ret=%d, start=%ld, end=%ld",
+                ret, start, index);
+          }
+        }
+      }
+
+      // the tail after the last clean block
+      if (OB_SUCCESS == ret && is_tail_dirty_
+          && (0 == block_count || !dirty_block_list_.at(block_count - 1)))
+      {
+        if (OB_SUCCESS != (ret = merge_dirty_blocks(block_count, block_count)))
+        {
+          TBSYS_LOG(WARN, "merge tail error, ret=%d", ret);
+        }
+      }
+
+      TBSYS_LOG(INFO, "merge tablet %s with reused blocks, block_count=%ld, "
+          "reuse_block_count=%ld, ret=%d", to_cstring(old_tablet_->get_range()),
+          block_count, reuse_block_count, ret);
+
+      return ret;
+    }
+
+    int ObTabletMergerV2::reuse_block(const int64_t index)
+    {
+      int ret = OB_SUCCESS;
+      ObRecordHeaderV2 header;
+      const char* payload = NULL;
+      int64_t row_count = 0;
+      bool is_sstable_split = false;
+
+      // the rows appended before must be written out first
+      if (OB_SUCCESS != (ret = flush_sstable()))
+      {
+        TBSYS_LOG(WARN, "flush_sstable error ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = raw_block_reader_.read_block(index, header, payload, row_count)))
+      {
+        TBSYS_LOG(WARN, "read block error, ret=%d, index=%ld", ret, index);
+      }
+      else if (OB_SUCCESS != (ret = writer_.append_block(header, payload,
+              raw_block_reader_.get_block_endkey(index), row_count,
+              *raw_block_reader_.get_bloomfilter(), is_sstable_split)))
+      {
+        TBSYS_LOG(WARN, "append block error, ret=%d, index=%ld, endkey=%s", ret, index,
+            to_cstring(raw_block_reader_.get_block_endkey(index)));
+      }
+      else if (is_sstable_split)
+      {
+        TBSYS_LOG(INFO, "split tablet, range=%s, block endkey=%s", 
+            to_cstring(old_tablet_->get_range()),
+            to_cstring(raw_block_reader_.get_block_endkey(index)));
+        if (OB_SUCCESS != (ret = finish_sstable(is_sstable_split, false)))
+        {
+          TBSYS_LOG(WARN, "finish_sstable error ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = create_new_sstable()))
+        {
+          TBSYS_LOG(WARN, "create_new_sstable error,ret=%d", ret);
+        }
+      }
+
+      return ret;
+    }
+
+    int ObTabletMergerV2::merge_dirty_blocks(const int64_t start, const int64_t end)
+    {
+      int ret = OB_SUCCESS;
+      ObNewRange range = old_tablet_->get_range();
+
+      // (endkey of block start - 1, endkey of block end - 1]
+      if (start > 0)
+      {
+        range.start_key_ = raw_block_reader_.get_block_endkey(start - 1);
+        range.border_flag_.unset_min_value();
+        range.border_flag_.unset_inclusive_start();
+      }
+      if (end < raw_block_reader_.get_block_count())
+      {
+        range.end_key_ = raw_block_reader_.get_block_endkey(end - 1);
+        range.border_flag_.unset_max_value();
+        range.border_flag_.set_inclusive_end();
+      }
+
+      if (OB_SUCCESS != (ret = open_range(range)))
+      {
+        TBSYS_LOG(WARN, "open_range error, ret=%d, range=%s", ret, to_cstring(range));
+      }
+      else if (OB_SUCCESS != (ret = merge_rows()))
+      {
+        TBSYS_LOG(WARN, "merge_rows error, ret=%d, range=%s", ret, to_cstring(range));
       }
-      CLEAR_TRACE_LOG();
 
       return ret;
     }
@@ -470,6 +937,8 @@ namespace oceanbase
         }
         else
         {
+          // the writes of the new sstable are throttled on its disk
+          ObIOScheduler::set_thread_io_disk(disk_no);
           TBSYS_LOG(INFO,"create new sstable, sstable_path:%s ,version=%ld", path_, frozen_version_);
         }
       }
@@ -701,6 +1170,35 @@ namespace oceanbase
       return ret;
     }
 
+    int ObTabletMergerV2::flush_sstable()
+    {
+      int ret = OB_SUCCESS;
+      bool is_sstable_split = true;
+
+      while (OB_SUCCESS == ret && is_sstable_split)
+      {
+        if (OB_SUCCESS != (ret = writer_.flush(is_sstable_split)))
+        {
+          TBSYS_LOG(WARN, "flush writer error, ret=%d", ret);
+        }
+        else if (is_sstable_split)
+        {
+          TBSYS_LOG(INFO, "split tablet when flush, range=%s",
+              to_cstring(old_tablet_->get_range()));
+          if (OB_SUCCESS != (ret = finish_sstable(is_sstable_split, false)))
+          {
+            TBSYS_LOG(WARN, "finish_sstable error ret=%d", ret);
+          }
+          else if (OB_SUCCESS != (ret = create_new_sstable()))
+          {
+            TBSYS_LOG(WARN, "create_new_sstable error,ret=%d", ret);
+          }
+        }
+      }
+
+      return ret;
+    }
+
     int ObTabletMergerV2::finish_sstable(const bool is_sstable_split, const bool is_tablet_unchanged)
     {
       int ret = OB_SUCCESS;
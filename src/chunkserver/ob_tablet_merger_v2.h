@@ -20,6 +20,7 @@
 
 #include "common/ob_define.h"
 #include "compactsstablev2/ob_compact_sstable_writer.h"
+#include "compactsstablev2/ob_compact_sstable_raw_block_reader.h"
 #include "compactsstablev2/ob_sstable_schema.h"
 #include "ob_tablet_merger_v1.h"
 #include "ob_tablet_merge_filter.h"
@@ -45,6 +46,11 @@ namespace oceanbase
 
     class ObTabletMergerV2 : public ObTabletMerger
     {
+      public:
+        // every dirty block range is merged by a new tablet scan, too many
+        // ranges cost more than merging the whole tablet
+        static const int64_t MAX_REUSE_DIRTY_RANGE_COUNT = 256;
+
       public:
         ObTabletMergerV2(ObChunkMerge& chunk_merge, ObTabletManager& manager);
         ~ObTabletMergerV2() {}
@@ -58,10 +64,12 @@ namespace oceanbase
         int prepare_merge(ObTablet *tablet, int64_t frozen_version);
         int init_sstable_writer(const common::ObTableSchema & table_schema, 
             const ObTablet* tablet, const int64_t frozen_version);
+        static int64_t get_sstable_block_size(const common::ObTableSchema & table_schema);
         
         int create_new_sstable();
         int create_hard_link_sstable();
         int finish_sstable(const bool is_sstable_split, const bool is_tablet_unchanged);
+        int flush_sstable();
 
         int build_sstable_schema(const uint64_t table_id, compactsstablev2::ObSSTableSchema& sstable_schema);
         int build_project(const compactsstablev2::ObSSTableSchema& schema, sql::ObProject& project);
@@ -71,7 +79,16 @@ namespace oceanbase
         int wait_aio_buffer() const;
         int reset();
         int open();
+        int open_range(const common::ObNewRange& range);
         int do_merge();
+        int merge_rows();
+
+        int prepare_reuse_block(bool& reuse_block);
+        int check_reuse_block(bool& reuse_block);
+        int mark_dirty_blocks(bool& reuse_block);
+        int merge_reuse_block();
+        int reuse_block(const int64_t index);
+        int merge_dirty_blocks(const int64_t start, const int64_t end);
 
         int build_extend_info(const bool is_tablet_unchanged, ObTabletExtendInfo& extend_info);
         int build_new_tablet(const bool is_tablet_unchanged, ObTablet* &tablet);
@@ -91,6 +108,11 @@ namespace oceanbase
         sql::ObSSTableScan op_sstable_scan_;
         sql::ObUpsScan op_ups_scan_;
         sql::ObUpsMultiGet op_ups_multi_get_;
+
+        // for copy the blocks without incremental data
+        compactsstablev2::ObCompactSSTableRawBlockReader raw_block_reader_;
+        common::ObArray<bool> dirty_block_list_;
+        bool is_tail_dirty_;
     };
   } /* chunkserver */
 } /* oceanbase */
@@ -0,0 +1,136 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * lz4_compressor.cpp
+ *
+ */
+
+#include <new>
+#include <algorithm>
+#include <stdint.h>
+#include <lz4.h>
+#include <lz4hc.h>
+#include "lz4_compressor.h"
+
+const char *LZ4Compressor::NAME = "lz4_1.0";
+
+int LZ4Compressor::compress(const char *src_buffer,
+                            const int64_t src_data_size,
+                            char *dst_buffer,
+                            const int64_t dst_buffer_size,
+                            int64_t &dst_data_size)
+{
+  int ret = COM_E_NOERROR;
+  int compress_ret_size = 0;
+  if (NULL == src_buffer
+      || 0 >= src_data_size
+      || INT32_MAX < src_data_size
+      || NULL == dst_buffer
+      || 0 >= dst_buffer_size)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else if ((src_data_size + get_max_overflow_size(src_data_size)) > dst_buffer_size)
+  {
+    ret = COM_E_OVERFLOW;
+  }
+  else
+  {
+    if (0 == compress_level_)
+    {
+      compress_ret_size = LZ4_compress_default(src_buffer, dst_buffer,
+                                               static_cast<int>(src_data_size),
+                                               static_cast<int>(dst_buffer_size));
+    }
+    else
+    {
+      compress_ret_size = LZ4_compress_HC(src_buffer, dst_buffer,
+                                          static_cast<int>(src_data_size),
+                                          static_cast<int>(dst_buffer_size),
+                                          static_cast<int>(compress_level_));
+    }
+    if (0 >= compress_ret_size)
+    {
+      ret = COM_E_INTERNALERROR;
+    }
+    else
+    {
+      dst_data_size = compress_ret_size;
+    }
+  }
+  return ret;
+}
+
+int LZ4Compressor::decompress(const char *src_buffer,
+                              const int64_t src_data_size,
+                              char *dst_buffer,
+                              const int64_t dst_buffer_size,
+                              int64_t &dst_data_size)
+{
+  int ret = COM_E_NOERROR;
+  int decompress_ret_size = 0;
+  if (NULL == src_buffer
+      || 0 >= src_data_size
+      || INT32_MAX < src_data_size
+      || NULL == dst_buffer
+      || 0 >= dst_buffer_size)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  // 输入不完整或者dst_buffer放不下都返回负数，不会越界
+  else if (0 > (decompress_ret_size = LZ4_decompress_safe(src_buffer, dst_buffer,
+                                                          static_cast<int>(src_data_size),
+                                                          static_cast<int>(std::min(dst_buffer_size,
+                                                              static_cast<int64_t>(INT32_MAX))))))
+  {
+    ret = COM_E_DATAERROR;
+  }
+  else
+  {
+    dst_data_size = decompress_ret_size;
+  }
+  return ret;
+}
+
+int LZ4Compressor::set_compress_level(const int64_t compress_level)
+{
+  int ret = COM_E_NOERROR;
+  if (0 > compress_level || MAX_COMPRESS_LEVEL < compress_level)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else
+  {
+    compress_level_ = compress_level;
+  }
+  return ret;
+}
+
+const char *LZ4Compressor::get_compressor_name() const
+{
+  return NAME;
+}
+
+int64_t LZ4Compressor::get_max_overflow_size(const int64_t src_data_size) const
+{
+  // LZ4_compressBound: isize + isize / 255 + 16
+  return src_data_size / 255 + 16;
+}
+
+ObCompressor *create()
+{
+  return (new(std::nothrow) LZ4Compressor());
+}
+
+void destroy(ObCompressor *lz4)
+{
+  if (NULL != lz4)
+  {
+    delete lz4;
+    lz4 = NULL;
+  }
+}
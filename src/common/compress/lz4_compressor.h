@@ -0,0 +1,47 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * lz4_compressor.h
+ *
+ * 压缩和解压都很快，用于对延迟敏感的热表
+ * level为0使用快速压缩，level大于0使用同样格式的HC压缩，只影响压缩速度和压缩比
+ *
+ */
+#ifndef OCEANBASE_COMMON_COMPRESS_LZ4_COMPRESSOR_H_
+#define OCEANBASE_COMMON_COMPRESS_LZ4_COMPRESSOR_H_
+
+#include "ob_compressor.h"
+
+class LZ4Compressor : public ObCompressor
+{
+  public:
+    const static char *NAME;
+    const static int64_t MAX_COMPRESS_LEVEL = 12;
+  public:
+    LZ4Compressor() : compress_level_(0)
+    {
+    };
+    int compress(const char *src_buffer,
+                 const int64_t src_data_size,
+                 char *dst_buffer,
+                 const int64_t dst_buffer_size,
+                 int64_t &dst_data_size);
+    int decompress(const char *src_buffer,
+                   const int64_t src_data_size,
+                   char *dst_buffer,
+                   const int64_t dst_buffer_size,
+                   int64_t &dst_data_size);
+    int set_compress_level(const int64_t compress_level);
+    const char *get_compressor_name() const;
+    int64_t get_max_overflow_size(const int64_t src_data_size) const;
+  private:
+    int64_t compress_level_;
+};
+
+extern "C" ObCompressor *create();
+extern "C" void destroy(ObCompressor *lz4);
+#endif //OCEANBASE_COMMON_COMPRESS_LZ4_COMPRESSOR_H_
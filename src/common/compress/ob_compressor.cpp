@@ -14,38 +14,176 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <dlfcn.h>
+#include <pthread.h>
+#include <sys/stat.h>
 #include "ob_compressor.h"
 
 #define LIB_FNAME_FORMAT_LENGTH 6 // lib.so
 #define MAX_LIB_FNAME_BUFFER_SIZE (MAX_LIB_NAME_LENGTH + LIB_FNAME_FORMAT_LENGTH + 1)
+#define OPTION_DELIMITER '@'
+#define DICT_OPTION "dict="
+#define MAX_DICT_SIZE (16L * 1024 * 1024)
+#define MAX_SHARED_COMPRESSOR_NUM 64
 
-static void *get_lib_handle_(const char *compressor_lib_name)
+/*
+ * 带字典的实例按名字在进程内共享，每个sstable reader都建一份的话，
+ * 每个字典都要重复读文件，重复占用字典的内存
+ */
+struct SharedCompressor
+{
+  char name_[MAX_LIB_NAME_LENGTH];
+  ObCompressor *compressor_;
+  int64_t ref_cnt_;
+};
+static SharedCompressor shared_compressors[MAX_SHARED_COMPRESSOR_NUM];
+static pthread_mutex_t shared_compressors_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void *get_lib_handle_(const char *compressor_lib_name, const int64_t name_length)
 {
   void *sohandle = NULL;
   static __thread char soname[MAX_LIB_FNAME_BUFFER_SIZE];
   int64_t inner_ret = 0;
   if (NULL != compressor_lib_name
-      && -1 < (inner_ret = snprintf(soname, MAX_LIB_FNAME_BUFFER_SIZE, "lib%s.so", compressor_lib_name))
+      && MAX_LIB_NAME_LENGTH >= name_length
+      && -1 < (inner_ret = snprintf(soname, MAX_LIB_FNAME_BUFFER_SIZE, "lib%.*s.so",
+                                    static_cast<int>(name_length), compressor_lib_name))
       && MAX_LIB_FNAME_BUFFER_SIZE > inner_ret)
   {
-    sohandle = dlopen(soname, RTLD_LAZY);
+    // 压缩库可能注册了线程退出时的回调，不能在线程退出之前卸载
+    sohandle = dlopen(soname, RTLD_LAZY | RTLD_NODELETE);
   }
   return sohandle;
 }
 
-ObCompressor *create_compressor(const char *compressor_lib_name)
+static int load_dictionary_(ObCompressor *compressor, const char *path)
+{
+  int ret = ObCompressor::COM_E_NOERROR;
+  struct stat st;
+  FILE *fp = NULL;
+  char *dict_buffer = NULL;
+  if (0 != stat(path, &st)
+      || 0 >= st.st_size
+      || MAX_DICT_SIZE < st.st_size)
+  {
+    fprintf(stderr, "invalid compress dictionary file [%s]\n", path);
+    ret = ObCompressor::COM_E_INVALID_PARAM;
+  }
+  else if (NULL == (dict_buffer = (char*)malloc(st.st_size)))
+  {
+    ret = ObCompressor::COM_E_INTERNALERROR;
+  }
+  else if (NULL == (fp = fopen(path, "r"))
+           || st.st_size != static_cast<int64_t>(fread(dict_buffer, 1, st.st_size, fp)))
+  {
+    fprintf(stderr, "read compress dictionary file [%s] fail\n", path);
+    ret = ObCompressor::COM_E_INTERNALERROR;
+  }
+  else
+  {
+    ret = compressor->set_dictionary(dict_buffer, st.st_size);
+  }
+  if (NULL != fp)
+  {
+    fclose(fp);
+  }
+  if (NULL != dict_buffer)
+  {
+    free(dict_buffer);
+  }
+  return ret;
+}
+
+/*
+ * options: level=N,dict=PATH
+ * need_dict为false时，字典文件读不出来只告警，实例不带字典，
+ * 没有用字典压缩的数据块还可以解压
+ */
+static int apply_options_(ObCompressor *compressor, const char *options, const bool need_dict)
+{
+  int ret = ObCompressor::COM_E_NOERROR;
+  char buffer[MAX_LIB_NAME_LENGTH];
+  char *saveptr = NULL;
+  char *option = NULL;
+  int64_t inner_ret = snprintf(buffer, sizeof(buffer), "%s", options);
+  if (0 > inner_ret || static_cast<int64_t>(sizeof(buffer)) <= inner_ret)
+  {
+    ret = ObCompressor::COM_E_INVALID_PARAM;
+  }
+  for (option = strtok_r(buffer, ",", &saveptr);
+       ObCompressor::COM_E_NOERROR == ret && NULL != option;
+       option = strtok_r(NULL, ",", &saveptr))
+  {
+    char *end = NULL;
+    if (0 == strncmp(option, "level=", 6))
+    {
+      int64_t level = strtol(option + 6, &end, 10);
+      if (end == option + 6 || '\0' != *end)
+      {
+        ret = ObCompressor::COM_E_INVALID_PARAM;
+      }
+      else
+      {
+        ret = compressor->set_compress_level(level);
+      }
+    }
+    else if (0 == strncmp(option, DICT_OPTION, strlen(DICT_OPTION)))
+    {
+      ret = load_dictionary_(compressor, option + strlen(DICT_OPTION));
+      if (ObCompressor::COM_E_INVALID_PARAM == ret && !need_dict)
+      {
+        fprintf(stderr, "compress dictionary [%s] not loaded, only blocks compressed without it can be read\n",
+                option + strlen(DICT_OPTION));
+        ret = ObCompressor::COM_E_NOERROR;
+      }
+    }
+    else
+    {
+      ret = ObCompressor::COM_E_INVALID_PARAM;
+    }
+    if (ObCompressor::COM_E_NOERROR != ret)
+    {
+      fprintf(stderr, "apply compressor option [%s] fail, ret=%d\n", option, ret);
+    }
+  }
+  return ret;
+}
+
+/*
+ * 加载和卸载压缩库，create_compressor和destroy_compressor在此基础上处理共享的实例
+ */
+struct ObCompressorLoader
+{
+  static ObCompressor *load(const char *compressor_lib_name, const bool need_dict);
+  static void unload(ObCompressor *compressor);
+};
+
+ObCompressor *ObCompressorLoader::load(const char *compressor_lib_name, const bool need_dict)
 {
   ObCompressor *ret = NULL;
   void *sohandle = NULL;
   compressor_constructor_t compressor_constructor = NULL;
-  if (NULL != (sohandle = get_lib_handle_(compressor_lib_name)))
+  const char *options = NULL;
+  int64_t name_length = 0;
+  if (NULL != compressor_lib_name)
+  {
+    options = strchr(compressor_lib_name, OPTION_DELIMITER);
+    name_length = (NULL == options) ? strlen(compressor_lib_name) : options - compressor_lib_name;
+  }
+  if (NULL != (sohandle = get_lib_handle_(compressor_lib_name, name_length)))
   {
     if (NULL != (compressor_constructor = (compressor_constructor_t)dlsym(sohandle, "create")))
     {
       if (NULL != (ret = compressor_constructor()))
       {
         ret->set_sohandle(sohandle);
+        if (NULL != options
+            && ObCompressor::COM_E_NOERROR != apply_options_(ret, options + 1, need_dict))
+        {
+          ObCompressorLoader::unload(ret);
+          ret = NULL;
+        }
       }
     }
     else
@@ -60,20 +198,125 @@ ObCompressor *create_compressor(const char *compressor_lib_name)
   return ret;
 }
 
-void destroy_compressor(ObCompressor *compressor)
+static bool is_shared_(const char *compressor_lib_name)
+{
+  const char *options = strchr(compressor_lib_name, OPTION_DELIMITER);
+  return (NULL != options && NULL != strstr(options, DICT_OPTION)
+          && MAX_LIB_NAME_LENGTH > strlen(compressor_lib_name));
+}
+
+static ObCompressor *get_shared_compressor_(const char *compressor_lib_name, const bool need_dict)
+{
+  ObCompressor *ret = NULL;
+  SharedCompressor *free_slot = NULL;
+  pthread_mutex_lock(&shared_compressors_mutex);
+  for (int64_t i = 0; i < MAX_SHARED_COMPRESSOR_NUM && NULL == ret; i++)
+  {
+    SharedCompressor &shared = shared_compressors[i];
+    if (NULL == shared.compressor_)
+    {
+      if (NULL == free_slot)
+      {
+        free_slot = &shared;
+      }
+    }
+    else if (0 == strcmp(shared.name_, compressor_lib_name))
+    {
+      shared.ref_cnt_++;
+      ret = shared.compressor_;
+    }
+  }
+  if (NULL == ret)
+  {
+    // 先按需要字典创建，字典读不出来的实例不共享，下次创建时重新读字典文件
+    if (NULL != (ret = ObCompressorLoader::load(compressor_lib_name, true)))
+    {
+      if (NULL != free_slot)
+      {
+        strcpy(free_slot->name_, compressor_lib_name);
+        free_slot->compressor_ = ret;
+        free_slot->ref_cnt_ = 1;
+      }
+    }
+    else if (!need_dict)
+    {
+      ret = ObCompressorLoader::load(compressor_lib_name, false);
+    }
+  }
+  pthread_mutex_unlock(&shared_compressors_mutex);
+  return ret;
+}
+
+static ObCompressor *create_compressor_(const char *compressor_lib_name, const bool need_dict)
+{
+  ObCompressor *ret = NULL;
+  if (NULL != compressor_lib_name && is_shared_(compressor_lib_name))
+  {
+    ret = get_shared_compressor_(compressor_lib_name, need_dict);
+  }
+  else
+  {
+    ret = ObCompressorLoader::load(compressor_lib_name, need_dict);
+  }
+  return ret;
+}
+
+ObCompressor *create_compressor(const char *compressor_lib_name)
+{
+  return create_compressor_(compressor_lib_name, true);
+}
+
+ObCompressor *create_decompressor(const char *compressor_lib_name)
+{
+  return create_compressor_(compressor_lib_name, false);
+}
+
+void ObCompressorLoader::unload(ObCompressor *compressor)
 {
   void *sohandle = NULL;
   compressor_deconstructor_t compressor_deconstructor = NULL;
-  if (NULL != compressor)
+  if (NULL != (sohandle = compressor->get_sohandle()))
   {
-    if (NULL != (sohandle = compressor->get_sohandle()))
+    if (NULL != (compressor_deconstructor = (compressor_deconstructor_t)dlsym(sohandle, "destroy")))
     {
-      if (NULL != (compressor_deconstructor = (compressor_deconstructor_t)dlsym(sohandle, "destroy")))
+      compressor_deconstructor(compressor);
+    }
+    dlclose(sohandle);
+  }
+}
+
+/*
+ * 共享的实例只减引用计数，还有其他使用者时返回true
+ */
+static bool release_shared_(ObCompressor *compressor)
+{
+  bool in_use = false;
+  pthread_mutex_lock(&shared_compressors_mutex);
+  for (int64_t i = 0; i < MAX_SHARED_COMPRESSOR_NUM; i++)
+  {
+    SharedCompressor &shared = shared_compressors[i];
+    if (compressor == shared.compressor_)
+    {
+      if (0 < --shared.ref_cnt_)
       {
-        compressor_deconstructor(compressor);
+        in_use = true;
       }
-      dlclose(sohandle);
+      else
+      {
+        shared.compressor_ = NULL;
+        shared.name_[0] = '\0';
+      }
+      break;
     }
   }
+  pthread_mutex_unlock(&shared_compressors_mutex);
+  return in_use;
 }
 
+void destroy_compressor(ObCompressor *compressor)
+{
+  if (NULL != compressor && !release_shared_(compressor))
+  {
+    ObCompressorLoader::unload(compressor);
+  }
+}
@@ -106,6 +106,21 @@ class ObCompressor
       return COM_E_NOIMPL;
     };
   
+    /*
+     * 设置压缩和解压使用的字典，压缩和解压必须使用同一个字典
+     * 字典内容由实现自己保存，调用返回后dict_buffer可以释放
+     * 不是所有算法都必须提供
+     *
+     * @param [in] dict_buffer 字典内容
+     * @param [in] dict_size 字典长度
+     */
+    virtual int set_dictionary(const char *dict_buffer, const int64_t dict_size)
+    {
+      (void)(dict_buffer);
+      (void)(dict_size);
+      return COM_E_NOIMPL;
+    };
+
     /*
      * 根据传入的大小计算压缩后最大的可能的溢出大小
      * 不是所有算法都必须提供
@@ -131,8 +146,7 @@ class ObCompressor
     };
 
   private:
-    friend ObCompressor *create_compressor(const char *compressor_lib_name);
-    friend void destroy_compressor(ObCompressor *compressor);
+    friend struct ObCompressorLoader;
     void set_sohandle(void *sohandle)
     {
       sohandle_ = sohandle;
@@ -154,11 +168,25 @@ typedef void (*compressor_deconstructor_t)(ObCompressor *compressor);
 
 /*
  * 根据传入的名字加载动态库， 返回一个压缩方法实例
+ * 名字格式为 库名[@选项,选项...]，例如 zstd_1.0@level=19,dict=/path/to/dict
+ * 支持的选项:
+ *   level=N   调用set_compress_level(N)
+ *   dict=PATH 读入PATH文件的内容调用set_dictionary
+ * 名字会原样写入sstable的trailer，读的时候用同样的选项创建解压实例
+ * 带dict选项的实例按名字在进程内共享，同一个字典只读一次文件
  */
 extern ObCompressor *create_compressor(const char *compressor_lib_name);
 
+/*
+ * 创建读sstable用的解压实例，名字格式同create_compressor
+ * 带dict选项的实例按名字在进程内共享，不要再调用set_compress_level和set_dictionary
+ * 字典文件读不出来时不返回NULL，实例不带字典，没有用字典压缩的数据块照常解压，
+ * 用字典压缩的数据块解压返回COM_E_DATAERROR，下次创建时重新读字典文件
+ */
+extern ObCompressor *create_decompressor(const char *compressor_lib_name);
+
 /* 
- * 销毁一个压缩方法实例
+ * 销毁一个压缩方法实例，共享的实例在最后一个使用者销毁时释放
  */
 extern void destroy_compressor(ObCompressor *compressor);
 
@@ -0,0 +1,301 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * zstd_compressor.cpp
+ *
+ */
+
+#include <new>
+#include <string.h>
+#include <pthread.h>
+#include <zstd.h>
+#include "zstd_compressor.h"
+
+const char *ZstdCompressor::NAME = "zstd_1.0";
+
+// 每个线程一份，第一次使用时创建，线程退出时由pthread key的析构函数释放
+static __thread ZSTD_CCtx *t_cctx = NULL;
+static __thread ZSTD_DCtx *t_dctx = NULL;
+static pthread_key_t cctx_key;
+static pthread_key_t dctx_key;
+static pthread_once_t ctx_key_once = PTHREAD_ONCE_INIT;
+
+static void free_cctx_(void *cctx)
+{
+  ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(cctx));
+}
+
+static void free_dctx_(void *dctx)
+{
+  ZSTD_freeDCtx(static_cast<ZSTD_DCtx*>(dctx));
+}
+
+static void create_ctx_key_()
+{
+  pthread_key_create(&cctx_key, free_cctx_);
+  pthread_key_create(&dctx_key, free_dctx_);
+}
+
+static ZSTD_CCtx *get_cctx_()
+{
+  if (NULL == t_cctx)
+  {
+    pthread_once(&ctx_key_once, create_ctx_key_);
+    if (NULL != (t_cctx = ZSTD_createCCtx()))
+    {
+      pthread_setspecific(cctx_key, t_cctx);
+    }
+  }
+  return t_cctx;
+}
+
+static ZSTD_DCtx *get_dctx_()
+{
+  if (NULL == t_dctx)
+  {
+    pthread_once(&ctx_key_once, create_ctx_key_);
+    if (NULL != (t_dctx = ZSTD_createDCtx()))
+    {
+      pthread_setspecific(dctx_key, t_dctx);
+    }
+  }
+  return t_dctx;
+}
+
+ZstdCompressor::ZstdCompressor()
+  : compress_level_(DEFAULT_COMPRESS_LEVEL),
+    dict_buffer_(NULL),
+    dict_size_(0),
+    cdict_(NULL),
+    ddict_(NULL)
+{
+  pthread_mutex_init(&cdict_mutex_, NULL);
+}
+
+ZstdCompressor::~ZstdCompressor()
+{
+  free_dictionary_();
+  pthread_mutex_destroy(&cdict_mutex_);
+}
+
+int ZstdCompressor::compress(const char *src_buffer,
+                             const int64_t src_data_size,
+                             char *dst_buffer,
+                             const int64_t dst_buffer_size,
+                             int64_t &dst_data_size)
+{
+  int ret = COM_E_NOERROR;
+  size_t compress_ret_size = 0;
+  ZSTD_CCtx *cctx = NULL;
+  ZSTD_CDict *cdict = NULL;
+  if (NULL == src_buffer
+      || 0 >= src_data_size
+      || NULL == dst_buffer
+      || 0 >= dst_buffer_size)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else if ((src_data_size + get_max_overflow_size(src_data_size)) > dst_buffer_size)
+  {
+    ret = COM_E_OVERFLOW;
+  }
+  else if (NULL == (cctx = get_cctx_()))
+  {
+    ret = COM_E_INTERNALERROR;
+  }
+  else if (NULL != dict_buffer_ && NULL == (cdict = get_cdict_()))
+  {
+    ret = COM_E_INTERNALERROR;
+  }
+  else
+  {
+    if (NULL != cdict)
+    {
+      compress_ret_size = ZSTD_compress_usingCDict(cctx, dst_buffer, dst_buffer_size,
+                                                   src_buffer, src_data_size, cdict);
+    }
+    else
+    {
+      compress_ret_size = ZSTD_compressCCtx(cctx, dst_buffer, dst_buffer_size,
+                                            src_buffer, src_data_size,
+                                            static_cast<int>(compress_level_));
+    }
+    if (ZSTD_isError(compress_ret_size))
+    {
+      ret = COM_E_INTERNALERROR;
+    }
+    else
+    {
+      dst_data_size = static_cast<int64_t>(compress_ret_size);
+    }
+  }
+  return ret;
+}
+
+int ZstdCompressor::decompress(const char *src_buffer,
+                               const int64_t src_data_size,
+                               char *dst_buffer,
+                               const int64_t dst_buffer_size,
+                               int64_t &dst_data_size)
+{
+  int ret = COM_E_NOERROR;
+  unsigned long long content_size = 0;
+  size_t decompress_ret_size = 0;
+  ZSTD_DCtx *dctx = NULL;
+  if (NULL == src_buffer
+      || 0 >= src_data_size
+      || NULL == dst_buffer
+      || 0 >= dst_buffer_size)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else if (ZSTD_CONTENTSIZE_ERROR == (content_size = ZSTD_getFrameContentSize(src_buffer, src_data_size)))
+  {
+    ret = COM_E_DATAERROR;
+  }
+  else if (ZSTD_CONTENTSIZE_UNKNOWN != content_size
+           && content_size > static_cast<unsigned long long>(dst_buffer_size))
+  {
+    ret = COM_E_OVERFLOW;
+  }
+  else if (NULL == (dctx = get_dctx_()))
+  {
+    ret = COM_E_INTERNALERROR;
+  }
+  else
+  {
+    if (NULL != ddict_)
+    {
+      decompress_ret_size = ZSTD_decompress_usingDDict(dctx, dst_buffer, dst_buffer_size,
+                                                       src_buffer, src_data_size, ddict_);
+    }
+    else
+    {
+      decompress_ret_size = ZSTD_decompressDCtx(dctx, dst_buffer, dst_buffer_size,
+                                                src_buffer, src_data_size);
+    }
+    // 数据损坏，或者字典与压缩时使用的不一致
+    if (ZSTD_isError(decompress_ret_size))
+    {
+      ret = COM_E_DATAERROR;
+    }
+    else
+    {
+      dst_data_size = static_cast<int64_t>(decompress_ret_size);
+    }
+  }
+  return ret;
+}
+
+int ZstdCompressor::set_compress_level(const int64_t compress_level)
+{
+  int ret = COM_E_NOERROR;
+  if (1 > compress_level || ZSTD_maxCLevel() < compress_level)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else
+  {
+    compress_level_ = compress_level;
+    // 字典压缩上下文和level绑定，下次压缩时按新的level重建
+    if (NULL != cdict_)
+    {
+      ZSTD_freeCDict(cdict_);
+      cdict_ = NULL;
+    }
+  }
+  return ret;
+}
+
+int ZstdCompressor::set_dictionary(const char *dict_buffer, const int64_t dict_size)
+{
+  int ret = COM_E_NOERROR;
+  if (NULL == dict_buffer || 0 >= dict_size)
+  {
+    ret = COM_E_INVALID_PARAM;
+  }
+  else
+  {
+    free_dictionary_();
+    if (NULL == (dict_buffer_ = new(std::nothrow) char[dict_size]))
+    {
+      ret = COM_E_INTERNALERROR;
+    }
+    else
+    {
+      memcpy(dict_buffer_, dict_buffer, dict_size);
+      dict_size_ = dict_size;
+      // 只建解压用的DDict，CDict只有写sstable才用得到，第一次压缩时再建
+      if (NULL == (ddict_ = ZSTD_createDDict(dict_buffer_, dict_size_)))
+      {
+        ret = COM_E_INTERNALERROR;
+      }
+    }
+    if (COM_E_NOERROR != ret)
+    {
+      free_dictionary_();
+    }
+  }
+  return ret;
+}
+
+const char *ZstdCompressor::get_compressor_name() const
+{
+  return NAME;
+}
+
+int64_t ZstdCompressor::get_max_overflow_size(const int64_t src_data_size) const
+{
+  return static_cast<int64_t>(ZSTD_compressBound(src_data_size)) - src_data_size;
+}
+
+void ZstdCompressor::free_dictionary_()
+{
+  if (NULL != cdict_)
+  {
+    ZSTD_freeCDict(cdict_);
+    cdict_ = NULL;
+  }
+  if (NULL != ddict_)
+  {
+    ZSTD_freeDDict(ddict_);
+    ddict_ = NULL;
+  }
+  if (NULL != dict_buffer_)
+  {
+    delete[] dict_buffer_;
+    dict_buffer_ = NULL;
+  }
+  dict_size_ = 0;
+}
+
+ZSTD_CDict *ZstdCompressor::get_cdict_()
+{
+  ZSTD_CDict *cdict = NULL;
+  pthread_mutex_lock(&cdict_mutex_);
+  if (NULL == cdict_)
+  {
+    cdict_ = ZSTD_createCDict(dict_buffer_, dict_size_, static_cast<int>(compress_level_));
+  }
+  cdict = cdict_;
+  pthread_mutex_unlock(&cdict_mutex_);
+  return cdict;
+}
+
+ObCompressor *create()
+{
+  return (new(std::nothrow) ZstdCompressor());
+}
+
+void destroy(ObCompressor *zstd)
+{
+  if (NULL != zstd)
+  {
+    delete zstd;
+    zstd = NULL;
+  }
+}
@@ -0,0 +1,61 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * zstd_compressor.h
+ *
+ * 压缩比高，用于冷数据和归档表，可以设置压缩级别和预先训练的字典
+ * 压缩和解压的上下文按线程缓存，线程退出时释放，同一个实例可以被多个线程同时使用，
+ * set_compress_level和set_dictionary必须在使用之前调用
+ * 压缩用的字典上下文在第一次压缩时才创建，只做解压的实例不占这部分内存
+ *
+ */
+#ifndef OCEANBASE_COMMON_COMPRESS_ZSTD_COMPRESSOR_H_
+#define OCEANBASE_COMMON_COMPRESS_ZSTD_COMPRESSOR_H_
+
+#include <pthread.h>
+#include "ob_compressor.h"
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+class ZstdCompressor : public ObCompressor
+{
+  public:
+    const static char *NAME;
+    const static int64_t DEFAULT_COMPRESS_LEVEL = 3;
+  public:
+    ZstdCompressor();
+    ~ZstdCompressor();
+    int compress(const char *src_buffer,
+                 const int64_t src_data_size,
+                 char *dst_buffer,
+                 const int64_t dst_buffer_size,
+                 int64_t &dst_data_size);
+    int decompress(const char *src_buffer,
+                   const int64_t src_data_size,
+                   char *dst_buffer,
+                   const int64_t dst_buffer_size,
+                   int64_t &dst_data_size);
+    int set_compress_level(const int64_t compress_level);
+    int set_dictionary(const char *dict_buffer, const int64_t dict_size);
+    const char *get_compressor_name() const;
+    int64_t get_max_overflow_size(const int64_t src_data_size) const;
+  private:
+    void free_dictionary_();
+    ZSTD_CDict_s *get_cdict_();
+  private:
+    int64_t compress_level_;
+    char *dict_buffer_;
+    int64_t dict_size_;
+    ZSTD_CDict_s *cdict_;
+    ZSTD_DDict_s *ddict_;
+    pthread_mutex_t cdict_mutex_;
+};
+
+extern "C" ObCompressor *create();
+extern "C" void destroy(ObCompressor *zstd);
+#endif //OCEANBASE_COMMON_COMPRESS_ZSTD_COMPRESSOR_H_
@@ -0,0 +1,496 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_aio_backend.cpp for async read backend of sstable scan.
+ *
+ */
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <new>
+#include <tblog.h>
+#include <tbsys.h>
+#include "ob_aio_backend.h"
+#ifdef OB_HAVE_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+namespace oceanbase
+{
+  namespace common
+  {
+    namespace
+    {
+      ObAIOBackendType g_aio_backend_type = AIO_BACKEND_LIBAIO;
+      int64_t g_aio_queue_depth = 4;
+    }
+
+    void ObAIOBackend::set_config(const ObAIOBackendType type, const int64_t queue_depth)
+    {
+      g_aio_backend_type = type;
+      g_aio_queue_depth = (queue_depth < 1) ? 1
+        : ((queue_depth > MAX_QUEUE_DEPTH) ? MAX_QUEUE_DEPTH : queue_depth);
+      TBSYS_LOG(INFO, "set aio backend, type=%d queue_depth=%ld",
+                g_aio_backend_type, g_aio_queue_depth);
+    }
+
+    int64_t ObAIOBackend::get_queue_depth()
+    {
+      return g_aio_queue_depth;
+    }
+
+    ObAIOBackend *ObAIOBackend::create(const int64_t max_events,
+                                       const int64_t read_queue_depth)
+    {
+      ObAIOBackend *ret = NULL;
+#ifdef OB_HAVE_IO_URING
+      if (AIO_BACKEND_IO_URING == g_aio_backend_type)
+      {
+        ObIOUringBackend *io_uring = new (std::nothrow) ObIOUringBackend();
+        if (NULL == io_uring)
+        {
+          TBSYS_LOG(WARN, "failed to new io_uring backend");
+        }
+        else if (OB_SUCCESS != io_uring->init(max_events))
+        {
+          TBSYS_LOG(WARN, "failed to init io_uring backend, fall back to libaio");
+          delete io_uring;
+        }
+        else
+        {
+          ret = io_uring;
+        }
+      }
+#endif
+      if (NULL == ret)
+      {
+        ObLibAIOBackend *libaio = new (std::nothrow) ObLibAIOBackend();
+        if (NULL == libaio)
+        {
+          TBSYS_LOG(WARN, "failed to new libaio backend");
+        }
+        else if (OB_SUCCESS != libaio->init(max_events))
+        {
+          TBSYS_LOG(WARN, "failed to init libaio backend");
+          delete libaio;
+        }
+        else
+        {
+          ret = libaio;
+        }
+      }
+      if (NULL != ret)
+      {
+        ret->read_queue_depth_ = (read_queue_depth < 1) ? 1
+          : ((read_queue_depth > MAX_QUEUE_DEPTH) ? MAX_QUEUE_DEPTH : read_queue_depth);
+      }
+      return ret;
+    }
+
+    void ObAIOBackend::destroy(ObAIOBackend *backend)
+    {
+      if (NULL != backend)
+      {
+        delete backend;
+      }
+    }
+
+    ObLibAIOBackend::ObLibAIOBackend() : ctx_(NULL), queued_nr_(0)
+    {
+      memset(iocbs_, 0, sizeof(iocbs_));
+      memset(iocb_ptrs_, 0, sizeof(iocb_ptrs_));
+    }
+
+    ObLibAIOBackend::~ObLibAIOBackend()
+    {
+      if (NULL != ctx_)
+      {
+        io_destroy(ctx_);
+        ctx_ = NULL;
+      }
+    }
+
+    int ObLibAIOBackend::init(const int64_t max_events)
+    {
+      int ret = OB_SUCCESS;
+      int sys_ret = 0;
+      if (NULL != ctx_)
+      {
+        ret = OB_INIT_TWICE;
+      }
+      else if (max_events <= 0)
+      {
+        TBSYS_LOG(WARN, "invalid parameter, max_events=%ld", max_events);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (0 != (sys_ret = io_setup(static_cast<int>(max_events), &ctx_)))
+      {
+        TBSYS_LOG(WARN, "failed to setup io context, max_events=%ld, error:%s",
+                  max_events, strerror(-sys_ret));
+        ctx_ = NULL;
+        ret = OB_IO_ERROR;
+      }
+      return ret;
+    }
+
+    int ObLibAIOBackend::prep_pread(const int fd, char *buf, const int64_t size,
+                                    const int64_t offset, void *data)
+    {
+      int ret = OB_SUCCESS;
+      if (NULL == ctx_)
+      {
+        ret = OB_NOT_INIT;
+      }
+      else if (queued_nr_ >= MAX_QUEUE_DEPTH)
+      {
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else
+      {
+        io_prep_pread(&iocbs_[queued_nr_], fd, buf, size, offset);
+        iocbs_[queued_nr_].data = data;
+        iocb_ptrs_[queued_nr_] = &iocbs_[queued_nr_];
+        ++queued_nr_;
+      }
+      return ret;
+    }
+
+    int ObLibAIOBackend::submit()
+    {
+      int ret = OB_SUCCESS;
+      int sys_ret = 0;
+      if (NULL == ctx_)
+      {
+        ret = OB_NOT_INIT;
+      }
+      else if (0 < queued_nr_)
+      {
+        sys_ret = io_submit(ctx_, queued_nr_, iocb_ptrs_);
+        if (sys_ret != queued_nr_)
+        {
+          TBSYS_LOG(WARN, "io_submit failed, queued_nr=%ld ret=%d, error: %s",
+                    queued_nr_, sys_ret, sys_ret < 0 ? strerror(-sys_ret) : "partial submit");
+          ret = OB_IO_ERROR;
+        }
+        // the kernel has copied the iocbs, they could be reused
+        queued_nr_ = 0;
+      }
+      return ret;
+    }
+
+    int ObLibAIOBackend::get_events(const int64_t min_nr, const int64_t max_nr,
+                                    ObAIOEvent *events, const int64_t timeout_us,
+                                    int64_t &event_nr)
+    {
+      int ret = OB_SUCCESS;
+      event_nr = 0;
+      if (NULL == ctx_)
+      {
+        ret = OB_NOT_INIT;
+      }
+      else if (min_nr <= 0 || max_nr < min_nr || NULL == events)
+      {
+        TBSYS_LOG(WARN, "invalid parameter, min_nr=%ld max_nr=%ld events=%p",
+                  min_nr, max_nr, events);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        struct io_event io_events[max_nr];
+        struct timespec timeout;
+        timeout.tv_sec = timeout_us / 1000000;
+        timeout.tv_nsec = timeout_us % 1000000 * 1000;
+        int sys_ret = io_getevents(ctx_, min_nr, max_nr, io_events, &timeout);
+        if (sys_ret < 0)
+        {
+          TBSYS_LOG(WARN, "io_getevents failed, ret=%d, error: %s", sys_ret, strerror(-sys_ret));
+          ret = OB_IO_ERROR;
+        }
+        else
+        {
+          event_nr = sys_ret;
+          for (int64_t i = 0; i < event_nr; ++i)
+          {
+            events[i].data_ = io_events[i].data;
+            events[i].res_ = (0 != io_events[i].res2)
+              ? -static_cast<int64_t>(io_events[i].res2) : static_cast<int64_t>(io_events[i].res);
+          }
+        }
+      }
+      return ret;
+    }
+
+#ifdef OB_HAVE_IO_URING
+    ObIOUringBackend::ObIOUringBackend()
+      : ring_fd_(-1), queued_nr_(0),
+        sq_ptr_(MAP_FAILED), sq_ring_size_(0), sq_head_(NULL), sq_tail_(NULL),
+        sq_mask_(NULL), sq_array_(NULL), sqes_(NULL), sqes_size_(0), iovecs_(NULL),
+        cq_ptr_(MAP_FAILED), cq_ring_size_(0), cq_head_(NULL), cq_tail_(NULL),
+        cq_mask_(NULL), cqes_(NULL)
+    {
+    }
+
+    ObIOUringBackend::~ObIOUringBackend()
+    {
+      destroy();
+    }
+
+    void ObIOUringBackend::destroy()
+    {
+      if (NULL != sqes_)
+      {
+        munmap(sqes_, sqes_size_);
+        sqes_ = NULL;
+      }
+      if (MAP_FAILED != cq_ptr_)
+      {
+        munmap(cq_ptr_, cq_ring_size_);
+        cq_ptr_ = MAP_FAILED;
+      }
+      if (MAP_FAILED != sq_ptr_)
+      {
+        munmap(sq_ptr_, sq_ring_size_);
+        sq_ptr_ = MAP_FAILED;
+      }
+      if (NULL != iovecs_)
+      {
+        delete [] iovecs_;
+        iovecs_ = NULL;
+      }
+      if (ring_fd_ >= 0)
+      {
+        close(ring_fd_);
+        ring_fd_ = -1;
+      }
+      queued_nr_ = 0;
+    }
+
+    int ObIOUringBackend::init(const int64_t max_events)
+    {
+      int ret = OB_SUCCESS;
+      struct io_uring_params params;
+      memset(&params, 0, sizeof(params));
+
+      if (ring_fd_ >= 0)
+      {
+        ret = OB_INIT_TWICE;
+      }
+      else if (max_events <= 0)
+      {
+        TBSYS_LOG(WARN, "invalid parameter, max_events=%ld", max_events);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if ((ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup,
+                static_cast<uint32_t>(max_events), &params))) < 0)
+      {
+        TBSYS_LOG(WARN, "io_uring_setup failed, max_events=%ld, error: %s",
+                  max_events, strerror(errno));
+        ret = OB_IO_ERROR;
+      }
+      else
+      {
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+        void *sqes = MAP_FAILED;
+        if (MAP_FAILED == (sq_ptr_ = mmap(NULL, sq_ring_size_, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING))
+            || MAP_FAILED == (cq_ptr_ = mmap(NULL, cq_ring_size_, PROT_READ | PROT_WRITE,
+                                             MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING))
+            || MAP_FAILED == (sqes = mmap(NULL, sqes_size_, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES)))
+        {
+          TBSYS_LOG(WARN, "failed to mmap io_uring, error: %s", strerror(errno));
+          ret = OB_IO_ERROR;
+        }
+        else if (NULL == (iovecs_ = new (std::nothrow) struct iovec[params.sq_entries]))
+        {
+          TBSYS_LOG(WARN, "failed to allocate iovecs, sq_entries=%u", params.sq_entries);
+          sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+          ret = OB_ALLOCATE_MEMORY_FAILED;
+        }
+        else
+        {
+          char *sq_ptr = static_cast<char*>(sq_ptr_);
+          char *cq_ptr = static_cast<char*>(cq_ptr_);
+          sq_head_ = reinterpret_cast<uint32_t*>(sq_ptr + params.sq_off.head);
+          sq_tail_ = reinterpret_cast<uint32_t*>(sq_ptr + params.sq_off.tail);
+          sq_mask_ = reinterpret_cast<uint32_t*>(sq_ptr + params.sq_off.ring_mask);
+          sq_array_ = reinterpret_cast<uint32_t*>(sq_ptr + params.sq_off.array);
+          sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+          cq_head_ = reinterpret_cast<uint32_t*>(cq_ptr + params.cq_off.head);
+          cq_tail_ = reinterpret_cast<uint32_t*>(cq_ptr + params.cq_off.tail);
+          cq_mask_ = reinterpret_cast<uint32_t*>(cq_ptr + params.cq_off.ring_mask);
+          cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq_ptr + params.cq_off.cqes);
+          TBSYS_LOG(INFO, "init io_uring backend, sq_entries=%u cq_entries=%u",
+                    params.sq_entries, params.cq_entries);
+        }
+      }
+
+      if (OB_SUCCESS != ret)
+      {
+        destroy();
+      }
+      return ret;
+    }
+
+    int ObIOUringBackend::prep_pread(const int fd, char *buf, const int64_t size,
+                                     const int64_t offset, void *data)
+    {
+      int ret = OB_SUCCESS;
+      if (ring_fd_ < 0)
+      {
+        ret = OB_NOT_INIT;
+      }
+      else
+      {
+        const uint32_t tail = *sq_tail_;
+        const uint32_t head = *(volatile uint32_t*)sq_head_;
+        if (tail - head > *sq_mask_)
+        {
+          ret = OB_SIZE_OVERFLOW;
+        }
+        else
+        {
+          // the iovec is kept until the slot is reused, old kernels read it asynchronously
+          const uint32_t idx = tail & *sq_mask_;
+          struct io_uring_sqe *sqe = &sqes_[idx];
+          iovecs_[idx].iov_base = buf;
+          iovecs_[idx].iov_len = size;
+          memset(sqe, 0, sizeof(*sqe));
+          sqe->opcode = IORING_OP_READV;
+          sqe->fd = fd;
+          sqe->off = offset;
+          sqe->addr = reinterpret_cast<uint64_t>(&iovecs_[idx]);
+          sqe->len = 1;
+          sqe->user_data = reinterpret_cast<uint64_t>(data);
+          sq_array_[idx] = idx;
+          // publish the sqe before the tail
+          __sync_synchronize();
+          *(volatile uint32_t*)sq_tail_ = tail + 1;
+          ++queued_nr_;
+        }
+      }
+      return ret;
+    }
+
+    int ObIOUringBackend::submit()
+    {
+      int ret = OB_SUCCESS;
+      if (ring_fd_ < 0)
+      {
+        ret = OB_NOT_INIT;
+      }
+      else
+      {
+        int64_t retry_times = 0;
+        while (0 < queued_nr_ && OB_SUCCESS == ret)
+        {
+          int sys_ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_,
+                                                 static_cast<uint32_t>(queued_nr_), 0, 0, NULL, 0));
+          if (sys_ret > 0)
+          {
+            queued_nr_ -= sys_ret;
+            retry_times = 0;
+          }
+          else if (sys_ret < 0 && (EINTR == errno || EAGAIN == errno)
+                   && retry_times < MAX_SUBMIT_RETRY_TIMES)
+          {
+            // EAGAIN: the kernel is short of resources, give the inflight requests some time
+            usleep(static_cast<useconds_t>(SUBMIT_RETRY_INTERVAL_US << retry_times));
+            ++retry_times;
+          }
+          else
+          {
+            TBSYS_LOG(WARN, "io_uring_enter failed, queued_nr=%ld ret=%d retry_times=%ld, error: %s",
+                      queued_nr_, sys_ret, retry_times, sys_ret < 0 ? strerror(errno) : "nothing submitted");
+            ret = OB_IO_ERROR;
+          }
+        }
+        if (OB_SUCCESS != ret)
+        {
+          // drop the requests the kernel hasn't consumed as libaio does, the
+          // caller treats them as failed and their buffers may be reused
+          *(volatile uint32_t*)sq_tail_ = *(volatile uint32_t*)sq_head_;
+          queued_nr_ = 0;
+        }
+      }
+      return ret;
+    }
+
+    int64_t ObIOUringBackend::reap_events(const int64_t max_nr, ObAIOEvent *events)
+    {
+      int64_t ret = 0;
+      uint32_t head = *cq_head_;
+      const uint32_t tail = *(volatile uint32_t*)cq_tail_;
+      // read the cqes after the tail
+      __sync_synchronize();
+      while (head != tail && ret < max_nr)
+      {
+        const struct io_uring_cqe *cqe = &cqes_[head & *cq_mask_];
+        events[ret].data_ = reinterpret_cast<void*>(cqe->user_data);
+        events[ret].res_ = cqe->res;
+        ++ret;
+        ++head;
+      }
+      if (0 < ret)
+      {
+        __sync_synchronize();
+        *(volatile uint32_t*)cq_head_ = head;
+      }
+      return ret;
+    }
+
+    int ObIOUringBackend::get_events(const int64_t min_nr, const int64_t max_nr,
+                                     ObAIOEvent *events, const int64_t timeout_us,
+                                     int64_t &event_nr)
+    {
+      int ret = OB_SUCCESS;
+      const int64_t end_time = tbsys::CTimeUtil::getTime() + timeout_us;
+      int64_t left_us = timeout_us;
+      event_nr = 0;
+
+      if (ring_fd_ < 0)
+      {
+        ret = OB_NOT_INIT;
+      }
+      else if (min_nr <= 0 || max_nr < min_nr || NULL == events)
+      {
+        TBSYS_LOG(WARN, "invalid parameter, min_nr=%ld max_nr=%ld events=%p",
+                  min_nr, max_nr, events);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        while (OB_SUCCESS == ret)
+        {
+          event_nr += reap_events(max_nr - event_nr, events + event_nr);
+          if (event_nr >= min_nr
+              || (left_us = end_time - tbsys::CTimeUtil::getTime()) <= 0)
+          {
+            break;
+          }
+          // the ring fd is readable when there are completions
+          struct pollfd pfd;
+          pfd.fd = ring_fd_;
+          pfd.events = POLLIN;
+          pfd.revents = 0;
+          if (poll(&pfd, 1, static_cast<int>((left_us + 999) / 1000)) < 0 && EINTR != errno)
+          {
+            TBSYS_LOG(WARN, "failed to poll io_uring, error: %s", strerror(errno));
+            ret = OB_IO_ERROR;
+          }
+        }
+      }
+      return ret;
+    }
+#endif
+  } // end namespace common
+} // end namespace oceanbase
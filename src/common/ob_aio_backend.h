@@ -0,0 +1,192 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_aio_backend.h for async read backend of sstable scan.
+ *
+ */
+#ifndef OCEANBASE_COMMON_OB_AIO_BACKEND_H_
+#define OCEANBASE_COMMON_OB_AIO_BACKEND_H_
+
+#include <libaio.h>
+#include <sys/syscall.h>
+#include "ob_define.h"
+
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define OB_HAVE_IO_URING 1
+#include <sys/uio.h>
+// linux/io_uring.h is only included by ob_aio_backend.cpp, it pulls in the
+// BLOCK_SIZE macro of linux/fs.h which breaks ObFileService::BLOCK_SIZE
+struct io_uring_sqe;
+struct io_uring_cqe;
+#endif
+
+namespace oceanbase
+{
+  namespace common
+  {
+    enum ObAIOBackendType
+    {
+      AIO_BACKEND_LIBAIO = 0,
+      AIO_BACKEND_IO_URING,
+    };
+
+    struct ObAIOEvent
+    {
+      void *data_;        // user data of the request
+      int64_t res_;       // read size, or -errno if failed
+    };
+
+    /**
+     * 异步读的后端，每个线程一个实例，由该线程所有的aio buffer共用
+     * 1. prep_pread()只把请求放入队列，submit()用一次系统调用提交所有排队的请求
+     * 2. 可选libaio和io_uring两种实现，io_uring不可用(内核或编译环境不支持)时退化为libaio
+     */
+    class ObAIOBackend
+    {
+      public:
+        static const int64_t MAX_QUEUE_DEPTH = 16;
+
+      public:
+        ObAIOBackend() : read_queue_depth_(1) {}
+        virtual ~ObAIOBackend() {}
+
+        /**
+         * set the backend type and queue depth of each aio read for
+         * the backends created later
+         */
+        static void set_config(const ObAIOBackendType type, const int64_t queue_depth);
+        static int64_t get_queue_depth();
+
+        /**
+         * create a backend of the configured type which can hold
+         * max_events requests in flight
+         *
+         * @param read_queue_depth max chunks one read is split into,
+         *        max_events must be sized for it, it doesn't change
+         *        with the config during the lifetime of the backend
+         * @return NULL if failed to create any backend
+         */
+        static ObAIOBackend *create(const int64_t max_events,
+                                    const int64_t read_queue_depth = 1);
+        static void destroy(ObAIOBackend *backend);
+
+        int64_t get_read_queue_depth() const
+        {
+          return read_queue_depth_;
+        }
+        virtual ObAIOBackendType get_type() const = 0;
+
+        /**
+         * queue a read request, it isn't issued until submit()
+         *
+         * @return OB_SUCCESS, OB_SIZE_OVERFLOW if the submit queue is full
+         */
+        virtual int prep_pread(const int fd, char *buf, const int64_t size,
+                               const int64_t offset, void *data) = 0;
+
+        /// issue all the queued requests
+        virtual int submit() = 0;
+
+        /**
+         * wait at least min_nr requests to complete
+         *
+         * @param event_nr [out] number of events returned, 0 if timeout
+         */
+        virtual int get_events(const int64_t min_nr, const int64_t max_nr,
+                               ObAIOEvent *events, const int64_t timeout_us,
+                               int64_t &event_nr) = 0;
+
+      private:
+        int64_t read_queue_depth_;
+    };
+
+    class ObLibAIOBackend : public ObAIOBackend
+    {
+      public:
+        ObLibAIOBackend();
+        virtual ~ObLibAIOBackend();
+
+        int init(const int64_t max_events);
+        virtual ObAIOBackendType get_type() const
+        {
+          return AIO_BACKEND_LIBAIO;
+        }
+        virtual int prep_pread(const int fd, char *buf, const int64_t size,
+                               const int64_t offset, void *data);
+        virtual int submit();
+        virtual int get_events(const int64_t min_nr, const int64_t max_nr,
+                               ObAIOEvent *events, const int64_t timeout_us,
+                               int64_t &event_nr);
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObLibAIOBackend);
+        io_context_t ctx_;
+        int64_t queued_nr_;
+        struct iocb iocbs_[MAX_QUEUE_DEPTH];
+        struct iocb *iocb_ptrs_[MAX_QUEUE_DEPTH];
+    };
+
+#ifdef OB_HAVE_IO_URING
+    /**
+     * io_uring后端，直接使用系统调用，不依赖liburing
+     * 提交队列和完成队列都通过mmap与内核共享，请求用readv实现以兼容较早的内核
+     */
+    class ObIOUringBackend : public ObAIOBackend
+    {
+      public:
+        ObIOUringBackend();
+        virtual ~ObIOUringBackend();
+
+        int init(const int64_t max_events);
+        virtual ObAIOBackendType get_type() const
+        {
+          return AIO_BACKEND_IO_URING;
+        }
+        virtual int prep_pread(const int fd, char *buf, const int64_t size,
+                               const int64_t offset, void *data);
+        virtual int submit();
+        virtual int get_events(const int64_t min_nr, const int64_t max_nr,
+                               ObAIOEvent *events, const int64_t timeout_us,
+                               int64_t &event_nr);
+
+      private:
+        static const int64_t MAX_SUBMIT_RETRY_TIMES = 5;
+        static const int64_t SUBMIT_RETRY_INTERVAL_US = 100;
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObIOUringBackend);
+        int64_t reap_events(const int64_t max_nr, ObAIOEvent *events);
+        void destroy();
+
+      private:
+        int ring_fd_;
+        int64_t queued_nr_;
+        // submission queue
+        void *sq_ptr_;
+        int64_t sq_ring_size_;
+        uint32_t *sq_head_;
+        uint32_t *sq_tail_;
+        uint32_t *sq_mask_;
+        uint32_t *sq_array_;
+        struct io_uring_sqe *sqes_;
+        int64_t sqes_size_;
+        struct iovec *iovecs_;
+        // completion queue
+        void *cq_ptr_;
+        int64_t cq_ring_size_;
+        uint32_t *cq_head_;
+        uint32_t *cq_tail_;
+        uint32_t *cq_mask_;
+        struct io_uring_cqe *cqes_;
+    };
+#endif
+  } // end namespace common
+} // end namespace oceanbase
+
+#endif //OCEANBASE_COMMON_OB_AIO_BACKEND_H_
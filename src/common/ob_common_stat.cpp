@@ -70,6 +70,18 @@ const char *ObStatSingleton::ups_map[] = {
   "commit_log_size",
   "commit_log_id",
 
+  "replay_count",
+  "replay_time",
+};
+
+const char *ObStatSingleton::memtable_map[] = {
+  "row_cell_num_le_4",
+  "row_cell_num_le_16",
+  "row_cell_num_le_64",
+  "row_cell_num_le_256",
+  "row_cell_num_gt_256",
+  "hot_row_compact_count",
+  "hot_row_compact_time",
 };
 
 const char *ObStatSingleton::cs_map[] = {
@@ -148,6 +160,9 @@ const char *ObStatSingleton::sql_map[] = {
   "sql_drop_table_count",
 
   "sql_ps_allocator_count",
+
+  "sql_plan_cache_hit",
+  "sql_plan_cache_miss",
 };
 
 const char *ObStatSingleton::common_map[] = {
@@ -80,9 +80,25 @@ namespace oceanbase
       UPS_STAT_COMMIT_LOG_SIZE,
       UPS_STAT_COMMIT_LOG_ID,
 
+      UPS_STAT_REPLAY_COUNT,
+      UPS_STAT_REPLAY_TIMEU,
 
       UPDATESERVER_STAT_MAX,
     };
+    /* ups memtable */
+    enum
+    {
+      // 写入后行上已提交的cell个数分布
+      UPS_STAT_ROW_CELL_NUM_LE_4 = 0,
+      UPS_STAT_ROW_CELL_NUM_LE_16,
+      UPS_STAT_ROW_CELL_NUM_LE_64,
+      UPS_STAT_ROW_CELL_NUM_LE_256,
+      UPS_STAT_ROW_CELL_NUM_GT_256,
+      UPS_STAT_HOT_ROW_COMPACT_COUNT,
+      UPS_STAT_HOT_ROW_COMPACT_TIMEU,
+
+      MEMTABLE_STAT_MAX,
+    };
     /* chunkserver */
     enum
     {
@@ -194,6 +210,9 @@ namespace oceanbase
 
       SQL_PS_ALLOCATOR_COUNT,
 
+      SQL_PLAN_CACHE_HIT,
+      SQL_PLAN_CACHE_MISS,
+
       SQL_STAT_MAX,
     };
     /* obmysql */
@@ -256,6 +275,7 @@ namespace oceanbase
         static const char *sql_map[];
         static const char *obmysql_map[];
         static const char *sstable_map[];
+        static const char *memtable_map[];
       private:
         static ObStatManager *mgr_;
     };
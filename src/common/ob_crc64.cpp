@@ -21,6 +21,13 @@
 #include <stdlib.h>  
 #include "ob_crc64.h"  
 
+#if defined(__x86_64__) && defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define OB_CRC64_USE_PCLMUL
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#endif
+
 namespace oceanbase
 {
   namespace common
@@ -52,7 +59,31 @@ namespace oceanbase
     static const uint64_t CRC64_TABLE_SIZE = 256;
     static uint64_t s_crc64_table[CRC64_TABLE_SIZE] = {0};
     static uint16_t s_optimized_crc64_table[CRC64_TABLE_SIZE] = {0};
-    
+
+    /**
+      * Constants of the carry-less multiplication folding, see ob_crc64_pclmul.
+      * Folding a 128 bit block H * x^64 + L forward by D bits is
+      *    H * (x^(D+63) mod P) * x + L * (x^(D-1) mod P) * x
+      * the extra x comes free from multiplying two bit reflected 64 bit operands.
+      * Each pair is {x^(D+63) mod P, x^(D-1) mod P} for D = 512, 384, 256, 128.
+      */
+    static const int64_t CRC64_FOLD_CONST_NUM = 8;
+    static uint64_t s_crc64_fold_consts[CRC64_FOLD_CONST_NUM] = {0};
+
+    typedef uint64_t (*ObCrc64Func)(uint64_t uCRC64, const void *pv, int64_t cb);
+    static ObCrc64Func s_crc64_func = ob_crc64_optimized;
+
+    /// x^n mod P in the bit reflected form, x^0 is 1 << 63
+    static uint64_t crc64_xpow_mod(const uint64_t n, const uint64_t polynom)
+    {
+      uint64_t value = 1ULL << 63;
+      for (uint64_t i = 0; i < n; i++)
+      {
+        value = (value & 1) ? ((value >> 1) ^ polynom) : (value >> 1);
+      }
+      return value;
+    }
+
     void __attribute__((constructor)) ob_global_init_crc64_table()
     {
       ob_init_crc64_table(OB_DEFAULT_CRC64_POLYNOM);
@@ -77,6 +108,13 @@ namespace oceanbase
         s_crc64_table[i] = shift;
         s_optimized_crc64_table[i] = static_cast<int16_t >((shift >> 48) & 0xffff);
       }
+      for (int64_t i = 0; i < CRC64_FOLD_CONST_NUM / 2; i++)
+      {
+        const uint64_t distance = 512 - i * 128;
+        s_crc64_fold_consts[i * 2] = crc64_xpow_mod(distance + 63, polynom);
+        s_crc64_fold_consts[i * 2 + 1] = crc64_xpow_mod(distance - 1, polynom);
+      }
+      s_crc64_func = ob_crc64_pclmul_supported() ? ob_crc64_pclmul : ob_crc64_optimized;
     }
     
     /*
@@ -378,8 +416,80 @@ namespace oceanbase
         }
     
         return uCRC64; */
-        return ob_crc64_optimized(uCRC64, pv, cb);
+        return s_crc64_func(uCRC64, pv, cb);
     } 
+
+    bool ob_crc64_pclmul_supported()
+    {
+      bool bret = false;
+    #ifdef OB_CRC64_USE_PCLMUL
+      unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+      if (__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+      {
+        bret = (0 != (ecx & bit_PCLMUL)) && (0 != (edx & bit_SSE2));
+      }
+    #endif
+      return bret;
+    }
+
+    #ifdef OB_CRC64_USE_PCLMUL
+    __attribute__((target("sse2,pclmul")))
+    static inline __m128i crc64_fold(const __m128i value, const __m128i consts)
+    {
+      return _mm_xor_si128(_mm_clmulepi64_si128(value, consts, 0x00),
+                           _mm_clmulepi64_si128(value, consts, 0x11));
+    }
+
+    __attribute__((target("sse2,pclmul")))
+    uint64_t ob_crc64_pclmul(uint64_t uCRC64, const void *pv, int64_t cb)
+    {
+      const uint8_t *pu8 = (const uint8_t *)pv;
+      if (NULL != pv && cb >= 64)
+      {
+        const __m128i k512 = _mm_set_epi64x(s_crc64_fold_consts[1], s_crc64_fold_consts[0]);
+        const __m128i k384 = _mm_set_epi64x(s_crc64_fold_consts[3], s_crc64_fold_consts[2]);
+        const __m128i k256 = _mm_set_epi64x(s_crc64_fold_consts[5], s_crc64_fold_consts[4]);
+        const __m128i k128 = _mm_set_epi64x(s_crc64_fold_consts[7], s_crc64_fold_consts[6]);
+        // 前8个字节是最高次的系数，当前crc加在这里
+        __m128i x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)pu8), _mm_cvtsi64_si128(uCRC64));
+        __m128i x1 = _mm_loadu_si128((const __m128i*)(pu8 + 16));
+        __m128i x2 = _mm_loadu_si128((const __m128i*)(pu8 + 32));
+        __m128i x3 = _mm_loadu_si128((const __m128i*)(pu8 + 48));
+        pu8 += 64;
+        cb -= 64;
+        // 4路相互独立的折叠，隐藏pclmulqdq的延迟
+        while (cb >= 64)
+        {
+          x0 = _mm_xor_si128(crc64_fold(x0, k512), _mm_loadu_si128((const __m128i*)pu8));
+          x1 = _mm_xor_si128(crc64_fold(x1, k512), _mm_loadu_si128((const __m128i*)(pu8 + 16)));
+          x2 = _mm_xor_si128(crc64_fold(x2, k512), _mm_loadu_si128((const __m128i*)(pu8 + 32)));
+          x3 = _mm_xor_si128(crc64_fold(x3, k512), _mm_loadu_si128((const __m128i*)(pu8 + 48)));
+          pu8 += 64;
+          cb -= 64;
+        }
+        __m128i x = _mm_xor_si128(_mm_xor_si128(crc64_fold(x0, k384), crc64_fold(x1, k256)),
+                                  _mm_xor_si128(crc64_fold(x2, k128), x3));
+        while (cb >= 16)
+        {
+          x = _mm_xor_si128(crc64_fold(x, k128), _mm_loadu_si128((const __m128i*)pu8));
+          pu8 += 16;
+          cb -= 16;
+        }
+        // 剩下的128位就是之前所有数据的余式，再按普通数据查表归约到64位
+        uint64_t rest[2];
+        const uint8_t *prest = (const uint8_t *)rest;
+        _mm_storeu_si128((__m128i*)rest, x);
+        uCRC64 = 0;
+        DO_16_STEP(uCRC64, prest);
+      }
+      return ob_crc64_optimized(uCRC64, pu8, cb);
+    }
+    #else
+    uint64_t ob_crc64_pclmul(uint64_t uCRC64, const void *pv, int64_t cb)
+    {
+      return ob_crc64_optimized(uCRC64, pv, cb);
+    }
+    #endif
     
     /** 
       * Calculate CRC64 for a memory block. 
@@ -51,6 +51,16 @@ namespace oceanbase
       * @param   cb      Size of the memory block in bytes. 
       */ 
     uint64_t ob_crc64(const void *pv, int64_t cb);
+
+    /**
+      * The table driven and the carry-less multiplication(PCLMULQDQ) implementations
+      * of ob_crc64, with the same output. ob_crc64 picks ob_crc64_pclmul when the cpu
+      * supports it, these are exported for testing and benchmark purpose.
+      * ob_crc64_pclmul must not be called if ob_crc64_pclmul_supported returns false.
+      */
+    uint64_t ob_crc64_optimized(uint64_t uCRC64, const void *pv, int64_t cb);
+    uint64_t ob_crc64_pclmul(uint64_t uCRC64, const void *pv, int64_t cb);
+    bool ob_crc64_pclmul_supported();
     
     /**
       * Get the static CRC64 table. This function is only used for testing purpose.
@@ -528,6 +528,7 @@ namespace oceanbase
     static const int64_t OB_DEFAULT_SSTABLE_BLOCK_SIZE = 16*1024; // 16KB
     static const int64_t OB_DEFAULT_MAX_TABLET_SIZE = 256*1024*1024; // 256MB
     static const int64_t OB_MYSQL_PACKET_BUFF_SIZE = 6 * 1024; //6KB
+    static const int64_t OB_MYSQL_STREAM_BUFF_SIZE = 64 * 1024; //64KB
     static const int64_t OB_MAX_ERROR_CODE = 10000;
     static const int64_t OB_MAX_THREAD_NUM = 1024;
   } // end namespace common
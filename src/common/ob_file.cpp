@@ -24,6 +24,7 @@
 #include <new>
 #include <algorithm>
 #include "ob_file.h"
+#include "ob_io_scheduler.h"
 
 namespace oceanbase
 {
@@ -1307,6 +1308,7 @@ namespace oceanbase
       }
       else
       {
+        ObIOScheduler::get_instance().throttle(count);
         ret = file_->pread(buf, count, offset, read_size);
       }
       return ret;
@@ -1321,6 +1323,7 @@ namespace oceanbase
       }
       else
       {
+        ObIOScheduler::get_instance().throttle(count);
         ret = file_->pread(count, offset, file_buf, read_size);
       }
       return ret;
@@ -1379,6 +1382,7 @@ namespace oceanbase
           preader = &buffer_reader;
         }
         int64_t read_size = 0;
+        ObIOScheduler::get_instance().throttle(size);
         ret = preader->pread_by_fd(fd, size, offset, file_buf, read_size);
         if (size != read_size)
         {
@@ -1515,6 +1519,7 @@ namespace oceanbase
       }
       else
       {
+        ObIOScheduler::get_instance().throttle(count);
         ret = file_->append(buf, count, is_fsync);
       }
       return ret;
@@ -1529,6 +1534,7 @@ namespace oceanbase
       }
       else
       {
+        ObIOScheduler::get_instance().throttle(count);
         ret = file_->async_append(buf, count, callback);
       }
       return ret;
@@ -0,0 +1,283 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_file_block_prefetcher.cpp for sequential read of the sent file.
+ *
+ */
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "ob_file_block_prefetcher.h"
+#include "ob_malloc.h"
+#include "ob_file.h"
+#include "utility.h"
+#include "ob_aio_backend.h"
+#include "ob_io_scheduler.h"
+
+using namespace oceanbase;
+using namespace oceanbase::common;
+
+ObFileBlockPrefetcher::ObFileBlockPrefetcher():
+  fd_(-1), file_size_(0), block_size_(0), prefetch_count_(0),
+  next_offset_(0), cur_idx_(0), cur_returned_(false),
+  backend_(NULL), misalign_buf_(NULL)
+{
+  memset(blocks_, 0, sizeof(blocks_));
+}
+
+ObFileBlockPrefetcher::~ObFileBlockPrefetcher()
+{
+  close();
+}
+
+int ObFileBlockPrefetcher::open(const ObString& path, const int64_t block_size,
+    const int64_t prefetch_count)
+{
+  int ret = OB_SUCCESS;
+  char path_buf[OB_MAX_FILE_NAME_LENGTH];
+  struct stat file_stat;
+
+  if (-1 != fd_)
+  {
+    TBSYS_LOG(WARN, "prefetcher is opened already, fd=%d", fd_);
+    ret = OB_INIT_TWICE;
+  }
+  else if (block_size <= 0 || 0 != block_size % OB_DIRECT_IO_ALIGN
+      || prefetch_count <= 0 || prefetch_count > MAX_PREFETCH_COUNT)
+  {
+    TBSYS_LOG(WARN, "invalid param, block_size=%ld, prefetch_count=%ld",
+        block_size, prefetch_count);
+    ret = OB_INVALID_ARGUMENT;
+  }
+  else if (path.length() <= 0 || path.length() >= OB_MAX_FILE_NAME_LENGTH)
+  {
+    TBSYS_LOG(WARN, "invalid path length[%d]", path.length());
+    ret = OB_INVALID_ARGUMENT;
+  }
+  else
+  {
+    snprintf(path_buf, sizeof(path_buf), "%.*s", path.length(), path.ptr());
+    if (-1 == (fd_ = ::open(path_buf, O_RDONLY | O_DIRECT)))
+    {
+      TBSYS_LOG(WARN, "open file [%s] failed: %s", path_buf, strerror(errno));
+      ret = OB_IO_ERROR;
+    }
+    else if (0 != fstat(fd_, &file_stat))
+    {
+      TBSYS_LOG(WARN, "stat file [%s] failed: %s", path_buf, strerror(errno));
+      ret = OB_IO_ERROR;
+    }
+    else
+    {
+      file_size_ = file_stat.st_size;
+    }
+  }
+
+  if (OB_SUCCESS == ret)
+  {
+    misalign_buf_ = reinterpret_cast<char *>(ob_malloc(
+        block_size * prefetch_count + OB_DIRECT_IO_ALIGN, ObModIds::OB_FILE_CLIENT));
+    if (NULL == misalign_buf_)
+    {
+      TBSYS_LOG(WARN, "allocate prefetch buffer failed, block_size=%ld, prefetch_count=%ld",
+          block_size, prefetch_count);
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+    }
+  }
+
+  if (OB_SUCCESS == ret)
+  {
+    // fall back to synchronous read if aio isn't available
+    if (NULL == (backend_ = ObAIOBackend::create(prefetch_count)))
+    {
+      TBSYS_LOG(WARN, "create aio backend failed, read the file synchronously");
+    }
+
+    char* buf = reinterpret_cast<char *>(upper_align(
+        reinterpret_cast<int64_t>(misalign_buf_), OB_DIRECT_IO_ALIGN));
+    block_size_ = block_size;
+    prefetch_count_ = prefetch_count;
+    next_offset_ = 0;
+    cur_idx_ = 0;
+    cur_returned_ = false;
+    for (int64_t i = 0; i < prefetch_count_ && OB_SUCCESS == ret; ++i)
+    {
+      blocks_[i].buf_ = buf + i * block_size_;
+      ret = submit_read(blocks_[i]);
+    }
+  }
+
+  if (OB_SUCCESS != ret)
+  {
+    close();
+  }
+
+  return ret;
+}
+
+int ObFileBlockPrefetcher::submit_read(Block& block)
+{
+  int ret = OB_SUCCESS;
+
+  block.in_flight_ = false;
+  block.size_ = 0;
+  if (next_offset_ >= file_size_)
+  {
+    block.offset_ = -1;
+  }
+  else
+  {
+    block.offset_ = next_offset_;
+    next_offset_ += block_size_;
+    if (NULL != backend_)
+    {
+      // the migration read is throttled by io scheduler before it's issued
+      ObIOScheduler::get_instance().throttle(block_size_);
+      if (OB_SUCCESS != (ret = backend_->prep_pread(fd_, block.buf_, block_size_,
+              block.offset_, &block)))
+      {
+        TBSYS_LOG(WARN, "prep aio read failed, offset=%ld, ret=%d", block.offset_, ret);
+      }
+      else if (OB_SUCCESS != (ret = backend_->submit()))
+      {
+        TBSYS_LOG(WARN, "submit aio read failed, offset=%ld, ret=%d", block.offset_, ret);
+      }
+      else
+      {
+        block.in_flight_ = true;
+      }
+    }
+  }
+
+  return ret;
+}
+
+int ObFileBlockPrefetcher::wait_read(Block& block)
+{
+  int ret = OB_SUCCESS;
+  ObAIOEvent events[MAX_PREFETCH_COUNT];
+  int64_t event_nr = 0;
+
+  if (NULL == backend_)
+  {
+    ObIOScheduler::get_instance().throttle(block_size_);
+    block.size_ = unintr_pread(fd_, block.buf_, block_size_, block.offset_);
+  }
+
+  // the reads complete in any order
+  while (OB_SUCCESS == ret && block.in_flight_)
+  {
+    if (OB_SUCCESS != (ret = backend_->get_events(1, prefetch_count_, events,
+            READ_TIMEOUT_US, event_nr)))
+    {
+      TBSYS_LOG(WARN, "get aio events failed, ret=%d", ret);
+    }
+    else if (0 == event_nr)
+    {
+      TBSYS_LOG(WARN, "wait aio read timeout, offset=%ld", block.offset_);
+      ret = OB_IO_ERROR;
+    }
+    else
+    {
+      for (int64_t i = 0; i < event_nr; ++i)
+      {
+        Block* done = reinterpret_cast<Block*>(events[i].data_);
+        done->size_ = events[i].res_;
+        done->in_flight_ = false;
+      }
+    }
+  }
+
+  if (OB_SUCCESS == ret)
+  {
+    int64_t expect_size = file_size_ - block.offset_;
+    expect_size = (expect_size > block_size_) ? block_size_ : expect_size;
+    if (block.size_ != expect_size)
+    {
+      TBSYS_LOG(WARN, "read file block failed, offset=%ld, read_size=%ld, expect_size=%ld",
+          block.offset_, block.size_, expect_size);
+      ret = OB_IO_ERROR;
+    }
+  }
+
+  return ret;
+}
+
+int ObFileBlockPrefetcher::get_next_block(const char*& buf, int64_t& read_size)
+{
+  int ret = OB_SUCCESS;
+  buf = NULL;
+  read_size = 0;
+
+  if (-1 == fd_)
+  {
+    ret = OB_NOT_INIT;
+  }
+  else if (cur_returned_)
+  {
+    // the last returned block is sent, reuse its buffer for the next read
+    ret = submit_read(blocks_[cur_idx_]);
+    cur_idx_ = (cur_idx_ + 1) % prefetch_count_;
+    cur_returned_ = false;
+  }
+
+  if (OB_SUCCESS == ret && blocks_[cur_idx_].offset_ >= 0)
+  {
+    if (OB_SUCCESS == (ret = wait_read(blocks_[cur_idx_])))
+    {
+      buf = blocks_[cur_idx_].buf_;
+      read_size = blocks_[cur_idx_].size_;
+      cur_returned_ = true;
+    }
+  }
+
+  return ret;
+}
+
+void ObFileBlockPrefetcher::close()
+{
+  ObAIOEvent events[MAX_PREFETCH_COUNT];
+  int64_t event_nr = 0;
+
+  // the buffers can't be freed until all the reads are done
+  for (int64_t i = 0; i < prefetch_count_ && NULL != backend_; ++i)
+  {
+    while (blocks_[i].in_flight_)
+    {
+      if (OB_SUCCESS != backend_->get_events(1, prefetch_count_, events,
+            READ_TIMEOUT_US, event_nr) || 0 == event_nr)
+      {
+        TBSYS_LOG(ERROR, "wait aio read failed when close, offset=%ld", blocks_[i].offset_);
+        break;
+      }
+      for (int64_t j = 0; j < event_nr; ++j)
+      {
+        reinterpret_cast<Block*>(events[j].data_)->in_flight_ = false;
+      }
+    }
+  }
+
+  if (NULL != backend_)
+  {
+    ObAIOBackend::destroy(backend_);
+    backend_ = NULL;
+  }
+  if (-1 != fd_)
+  {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  if (NULL != misalign_buf_)
+  {
+    ob_free(misalign_buf_);
+    misalign_buf_ = NULL;
+  }
+  memset(blocks_, 0, sizeof(blocks_));
+  prefetch_count_ = 0;
+  file_size_ = 0;
+}
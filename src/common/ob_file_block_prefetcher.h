@@ -0,0 +1,87 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_file_block_prefetcher.h for sequential read of the sent file.
+ *
+ */
+#ifndef OCEANBASE_COMMON_OB_FILE_BLOCK_PREFETCHER_H_
+#define OCEANBASE_COMMON_OB_FILE_BLOCK_PREFETCHER_H_
+
+#include "ob_define.h"
+#include "ob_string.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    class ObAIOBackend;
+
+    // read a file block by block in order with O_DIRECT, the next blocks
+    // are read by aio while the current block is being sent
+    class ObFileBlockPrefetcher
+    {
+    public:
+      static const int64_t MAX_PREFETCH_COUNT = 8;
+      static const int64_t READ_TIMEOUT_US = 10 * 1000 * 1000;
+
+    public:
+      ObFileBlockPrefetcher();
+      virtual ~ObFileBlockPrefetcher();
+
+    public:
+      // open the file and start reading the first blocks
+      // param @path            the path of local file
+      //       @block_size      the size of each block, aligned to OB_DIRECT_IO_ALIGN
+      //       @prefetch_count  the number of blocks in read, including the
+      //                        one returned by get_next_block
+      //
+      int open(const ObString& path, const int64_t block_size,
+          const int64_t prefetch_count);
+
+      // get the next block, read_size is 0 at the end of file,
+      // the block is valid until the next call
+      int get_next_block(const char*& buf, int64_t& read_size);
+
+      void close();
+
+      int64_t get_file_size() const
+      {
+        return file_size_;
+      }
+
+    private:
+      struct Block
+      {
+        char* buf_;
+        int64_t offset_;    // -1 if there is nothing to read
+        int64_t size_;      // read size, -errno if failed
+        bool in_flight_;
+      };
+
+      int submit_read(Block& block);
+      int wait_read(Block& block);
+
+    private:
+      DISALLOW_COPY_AND_ASSIGN(ObFileBlockPrefetcher);
+
+      int fd_;
+      int64_t file_size_;
+      int64_t block_size_;
+      int64_t prefetch_count_;
+      int64_t next_offset_;
+      int64_t cur_idx_;
+      bool cur_returned_;
+      ObAIOBackend* backend_;   // NULL if aio isn't available, read synchronously
+      char* misalign_buf_;
+      Block blocks_[MAX_PREFETCH_COUNT];
+    };
+  }
+}
+
+#endif /* OCEANBASE_COMMON_OB_FILE_BLOCK_PREFETCHER_H_ */
@@ -148,18 +148,24 @@ int ObFileClient::send_file_pre(const int64_t timeout,
 }
 
 int ObFileClient::send_file_block(const int64_t timeout,
-    const ObServer& dest_server, ObFileReader& file_reader, char *buf,
-    const int64_t offset, int64_t& read_size,
+    const ObServer& dest_server, ObFileBlockPrefetcher& prefetcher,
+    const int64_t offset, int64_t& read_size, uint64_t& checksum,
     ObDataBuffer& in_buffer, ObDataBuffer& out_buffer,const int64_t session_id)
 {
   int err = OB_SUCCESS;
+  const char *buf = NULL;
 
   //FILL_TRACE_LOG("Start send block");
-  // read file data to buf
-  err = file_reader.pread(buf, block_size_, offset, read_size);
+  // get file data prefetched, the following blocks are read while this one is sent
+  err = prefetcher.get_next_block(buf, read_size);
   if (OB_SUCCESS != err)
   {
     TBSYS_LOG(WARN, "Read file block failed");
+    read_size = 0;
+  }
+  else
+  {
+    checksum = ob_crc64(checksum, buf, read_size);
   }
 
   //FILL_TRACE_LOG("End file_reader.pread");
@@ -239,8 +245,8 @@ int ObFileClient::send_file_block(const int64_t timeout,
 }
 
 int ObFileClient::send_file_end(const int64_t timeout,
-    const ObServer& dest_server, ObDataBuffer& in_buffer,
-    ObDataBuffer& out_buffer,const int64_t session_id)
+    const ObServer& dest_server, const uint64_t checksum,
+    ObDataBuffer& in_buffer, ObDataBuffer& out_buffer,const int64_t session_id)
 {
   int ret = OB_SUCCESS;
   ObResultCode rc;
@@ -255,6 +261,17 @@ int ObFileClient::send_file_end(const int64_t timeout,
     TBSYS_LOG(WARN, "Encode rc failed:rc.result_code_[%d], ret[%d]",
         rc.result_code_, ret);
   }
+  // the checksum of the whole file is verified by the receiver once at the end,
+  // the receiver of old version ignores it
+  if (OB_SUCCESS == ret)
+  {
+    ret = serialization::encode_i64(in_buffer.get_data(), in_buffer.get_capacity(),
+        in_buffer.get_position(), static_cast<int64_t>(checksum));
+    if (OB_SUCCESS != ret)
+    {
+      TBSYS_LOG(WARN, "Encode checksum failed:checksum[%lu], ret[%d]", checksum, ret);
+    }
+  }
 
   if (OB_SUCCESS == ret)
   {
@@ -290,11 +307,11 @@ int ObFileClient::send_file_loop(const int64_t timeout,
 {
   int64_t t1 = tbsys::CTimeUtil::getTime();
 
-  ObFileReader file_reader;
+  ObFileBlockPrefetcher prefetcher;
   ObDataBuffer in_buffer;
   ObDataBuffer out_buffer;
   int64_t file_size = -1;
-  char *block_buffer = NULL;
+  uint64_t checksum = 0;
   int64_t session_id = 0;
   int ret = OB_SUCCESS;
   int64_t band_limit = band_limit_in;
@@ -325,40 +342,19 @@ int ObFileClient::send_file_loop(const int64_t timeout,
     ret = get_rpc_buffer(out_buffer);
   }
 
+  // open local file and start reading the first blocks
   if (OB_SUCCESS == ret)
   {
-    block_buffer = reinterpret_cast<char *>(ob_malloc(block_size_, ObModIds::OB_FILE_CLIENT));
-    if (NULL == block_buffer)
-    {
-      ret = OB_ALLOCATE_MEMORY_FAILED;
-      TBSYS_LOG(WARN, "Allocate memory for block buffer failed:ret[%d]", ret);
-    }
-  }
-
-  // get file size
-  if (OB_SUCCESS == ret)
-  {
-    struct stat file_stat;
-    if (stat(local_path.ptr(), &file_stat) != 0)
-    {
-      TBSYS_LOG(WARN, "get file size of %.*s failed: %s",
-          local_path.length(), local_path.ptr(), strerror(errno));
-      ret = OB_IO_ERROR;
-    } else {
-      file_size = file_stat.st_size;
-    }
-  }
-
-  // open local file
-  if (OB_SUCCESS == ret)
-  {
-    bool is_dio = true;
-    ret = file_reader.open(local_path, is_dio);
+    ret = prefetcher.open(local_path, block_size_, PREFETCH_BLOCK_COUNT);
     if (OB_SUCCESS != ret)
     {
       TBSYS_LOG(WARN, "Open file for send_file failed. path=[%.*s] ret=[%d]",
           local_path.length(), local_path.ptr(), ret);
     }
+    else
+    {
+      file_size = prefetcher.get_file_size();
+    }
   }
 
   //FILL_TRACE_LOG("Start send_file_pre");
@@ -388,8 +384,8 @@ int ObFileClient::send_file_loop(const int64_t timeout,
   {
     //FILL_TRACE_LOG("Send_file_block=%ld", offset);
     start_time_us = tbsys::CTimeUtil::getTime();
-    ret = send_file_block(timeout, dest_server, file_reader, block_buffer,
-        offset, read_size, in_buffer, out_buffer, session_id);
+    ret = send_file_block(timeout, dest_server, prefetcher,
+        offset, read_size, checksum, in_buffer, out_buffer, session_id);
     if (OB_SUCCESS != ret)
     {
       TBSYS_LOG(ERROR, "failed to send file block to server[%s] offset[%ld] "
@@ -416,7 +412,7 @@ int ObFileClient::send_file_loop(const int64_t timeout,
       {
         // send the finish notify to dest server
         //FILL_TRACE_LOG("Start send_file_end");
-        ret = send_file_end(timeout, dest_server, in_buffer, out_buffer, session_id);
+        ret = send_file_end(timeout, dest_server, checksum, in_buffer, out_buffer, session_id);
         if (OB_SUCCESS != ret)
         {
           TBSYS_LOG(ERROR, "failed to send_file_end:ret=[%d]", ret);
@@ -433,15 +429,7 @@ int ObFileClient::send_file_loop(const int64_t timeout,
     }
   }
 
-  if (NULL != block_buffer)
-  {
-    ob_free(block_buffer);
-  }
-
-  if (file_reader.is_opened())
-  {
-    file_reader.close();
-  }
+  prefetcher.close();
 
   int64_t duration = tbsys::CTimeUtil::getTime() - t1;
   if (OB_SUCCESS == ret && duration == 0)
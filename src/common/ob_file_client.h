@@ -10,6 +10,7 @@
 #include "ob_string.h"
 #include "ob_result.h"
 #include "utility.h"
+#include "ob_file_block_prefetcher.h"
 
 namespace oceanbase
 {
@@ -47,13 +48,13 @@ namespace oceanbase
           ObDataBuffer& out_buffer,int64_t& session_id);
 
       int send_file_block(const int64_t timeout, const ObServer& dest_server,
-          ObFileReader& file_reader, char *buf, const int64_t offset, 
-          int64_t& read_size, ObDataBuffer& in_buffer, 
+          ObFileBlockPrefetcher& prefetcher, const int64_t offset, 
+          int64_t& read_size, uint64_t& checksum, ObDataBuffer& in_buffer, 
           ObDataBuffer& out_buffer,const int64_t session_id);
 
       int send_file_end(const int64_t timeout, const ObServer& dest_server,
-          ObDataBuffer& in_buffer, ObDataBuffer& out_buffer,
-          const int64_t session_id);
+          const uint64_t checksum, ObDataBuffer& in_buffer, 
+          ObDataBuffer& out_buffer, const int64_t session_id);
 
       int send_file_loop(const int64_t timeout, const int64_t band_limit, 
           const ObServer& dest_server, const ObString& local_path, 
@@ -69,6 +70,7 @@ namespace oceanbase
 
       static const int32_t MAX_CONCURRENCY_COUNT = 128;
       static const int64_t MIN_BAND_LIMIT = 1024;
+      static const int64_t PREFETCH_BLOCK_COUNT = 4;
       static const int32_t DEFAULT_VERSION = 1;
     };
   }
@@ -1,4 +1,5 @@
 #include "ob_file_service.h"
+#include "ob_crc64.h"
 
 using namespace oceanbase;
 using namespace oceanbase::common;
@@ -451,10 +452,12 @@ int ObFileService::receive_file_pre(ObFileAppender& file_appender,
 }
 
 int ObFileService::receive_file_block(ObFileAppender& file_appender,
-    char* block_buf, easy_request_t* request, ObDataBuffer& in_buffer,
+    char* block_buf, int64_t& received_size, uint64_t& checksum, int& append_err,
+    easy_request_t* request, ObDataBuffer& in_buffer,
     ObDataBuffer& out_buffer, int32_t & response_cid, const int64_t session_id)
 {
-  int err = OB_SUCCESS;
+  // the error of the last append is returned to sender now
+  int err = append_err;
   int64_t offset;
   int64_t read_size = -1;
   //FILL_TRACE_LOG("Start receive_file_block");
@@ -466,6 +469,12 @@ int ObFileService::receive_file_block(ObFileAppender& file_appender,
     {
       TBSYS_LOG(WARN, "Decode offset failed: err=[%d]", err);
     }
+    else if (offset != received_size)
+    {
+      TBSYS_LOG(WARN, "Unexpected block offset[%ld], received size[%ld]",
+          offset, received_size);
+      err = OB_INVALID_DATA;
+    }
   }
   if (OB_SUCCESS == err)
   {
@@ -478,18 +487,7 @@ int ObFileService::receive_file_block(ObFileAppender& file_appender,
     }
   }
   //FILL_TRACE_LOG("decode end");
-  // write file block
-  if (OB_SUCCESS == err)
-  {
-    const bool is_fsync = false;
-    err = file_appender.append(block_buf, read_size, is_fsync);
-    if (OB_SUCCESS != err)
-    {
-      TBSYS_LOG(WARN, "Appender file block failed:err=[%d]", err);
-    }
-  }
-  //FILL_TRACE_LOG("append end");
-  // send response
+  // send response before the block is written
   ObResultCode rc;
   int ret = OB_SUCCESS;
   rc.result_code_ = err;
@@ -523,6 +521,22 @@ int ObFileService::receive_file_block(ObFileAppender& file_appender,
   }
 
   //FILL_TRACE_LOG("send response end");
+  // write file block while the sender is sending the next block
+  if (OB_SUCCESS == ret && OB_SUCCESS == err && read_size > 0)
+  {
+    const bool is_fsync = false;
+    append_err = file_appender.append(block_buf, read_size, is_fsync);
+    if (OB_SUCCESS != append_err)
+    {
+      TBSYS_LOG(WARN, "Appender file block failed:err=[%d]", append_err);
+    }
+    else
+    {
+      received_size += read_size;
+      checksum = ob_crc64(checksum, block_buf, read_size);
+    }
+  }
+  //FILL_TRACE_LOG("append end");
   if (OB_SUCCESS == ret && OB_SUCCESS != err)
   {
     ret = err;
@@ -532,17 +546,24 @@ int ObFileService::receive_file_block(ObFileAppender& file_appender,
 
 
 int ObFileService::receive_file_end(ObString& file_path, ObString& tmp_file_path,
-    const int64_t file_size, easy_request_t* request, ObDataBuffer& out_buffer,
+    const int64_t file_size, const uint64_t checksum, const int append_err,
+    ObDataBuffer& in_buffer, easy_request_t* request, ObDataBuffer& out_buffer,
     int32_t& response_cid, const int64_t session_id)
 {
-  int ret = OB_SUCCESS;
+  int ret = append_err;
+  int64_t sender_checksum = 0;
 
   struct stat file_stat;
   char tmp_path_buf[OB_MAX_FILE_NAME_LENGTH];
   char path_buf[OB_MAX_FILE_NAME_LENGTH];
   int n = snprintf(tmp_path_buf, OB_MAX_FILE_NAME_LENGTH, "%.*s",
       tmp_file_path.length(), tmp_file_path.ptr());
-  if (n<0 || n>=OB_MAX_FILE_NAME_LENGTH)
+  if (OB_SUCCESS != ret)
+  {
+    TBSYS_LOG(ERROR, "failed to append the last block of tmp_file_path[%.*s]: ret[%d]",
+        tmp_file_path.length(), tmp_file_path.ptr(), ret);
+  }
+  else if (n<0 || n>=OB_MAX_FILE_NAME_LENGTH)
   {
     TBSYS_LOG(ERROR, "failed to get tmp_file_path length[%d] [%.*s]",
         n, tmp_file_path.length(), tmp_file_path.ptr());
@@ -570,6 +591,23 @@ int ObFileService::receive_file_end(ObString& file_path, ObString& tmp_file_path
         "remote file size[%ld]", file_stat.st_size, file_size);
     ret = OB_INVALID_DATA;
   }
+  // the sender of old version doesn't send the checksum
+  if (OB_SUCCESS == ret && in_buffer.get_position() < in_buffer.get_capacity())
+  {
+    ret = serialization::decode_i64(in_buffer.get_data(), in_buffer.get_capacity(),
+        in_buffer.get_position(), &sender_checksum);
+    if (OB_SUCCESS != ret)
+    {
+      TBSYS_LOG(ERROR, "Decode checksum failed:ret=[%d]", ret);
+    }
+    else if (static_cast<uint64_t>(sender_checksum) != checksum)
+    {
+      TBSYS_LOG(ERROR, "The checksum of received tmp file[%s] is [%lu], "
+          "remote file checksum[%lu]", tmp_path_buf, checksum,
+          static_cast<uint64_t>(sender_checksum));
+      ret = OB_CHECKSUM_ERROR;
+    }
+  }
   if (OB_SUCCESS == ret && 0 != rename(tmp_path_buf, path_buf))
   {
     TBSYS_LOG(ERROR, "Rename [%s] to path[%s] failed: errno[%d] %s",
@@ -612,6 +650,9 @@ int ObFileService::receive_file_loop(ObString& file_path, ObString& tmp_file_pat
   int ret = OB_SUCCESS;
   ObResultCode rc;
   ObPacket *next_request = NULL;
+  int64_t received_size = 0;
+  uint64_t checksum = 0;
+  int append_err = OB_SUCCESS;
 
   if (!file_appender.is_opened())
   {
@@ -678,8 +719,9 @@ int ObFileService::receive_file_loop(ObString& file_path, ObString& tmp_file_pat
     {
       if (OB_SUCCESS == rc.result_code_) // receive file block
       {
-        ret = receive_file_block(file_appender, block_buf, request,
-            *in_buffer, out_buffer, response_cid, session_id);
+        ret = receive_file_block(file_appender, block_buf, received_size,
+            checksum, append_err, request, *in_buffer, out_buffer,
+            response_cid, session_id);
         if (OB_SUCCESS != ret)
         {
           TBSYS_LOG(ERROR, "failed to receive_file_block");
@@ -694,7 +736,8 @@ int ObFileService::receive_file_loop(ObString& file_path, ObString& tmp_file_pat
         }
         //FILL_TRACE_LOG("receive_file_end");
         ret = receive_file_end(file_path, tmp_file_path, file_size,
-            request, out_buffer, response_cid, session_id);
+            checksum, append_err, *in_buffer, request, out_buffer,
+            response_cid, session_id);
         if (OB_SUCCESS != ret)
         {
           TBSYS_LOG(ERROR, "failed to send receive_file_end");
@@ -53,11 +53,16 @@ namespace oceanbase
           easy_request_t* request, ObDataBuffer& in_buffer, 
           ObDataBuffer& out_buffer, int32_t& response_cid, const int64_t session_id);
 
+      // the block is acked before it's appended, so the sender can send the
+      // next block while this one is being written. an append error is
+      // kept in append_err and returned in the response of the next packet.
       int receive_file_block(ObFileAppender& file_appender, char* buf,
+          int64_t& received_size, uint64_t& checksum, int& append_err,
           easy_request_t* request, ObDataBuffer& in_buffer,
           ObDataBuffer& out_buffer, int32_t& response_cid, const int64_t session_id);
 
       int receive_file_end(ObString& file_path, ObString& tmp_file_path, const int64_t file_size,
+          const uint64_t checksum, const int append_err, ObDataBuffer& in_buffer,
           easy_request_t* request, ObDataBuffer& out_buffer, 
           int32_t& response_cid, const int64_t session_id);
 
@@ -71,6 +71,14 @@ namespace oceanbase
           merge_server, static_cast<int32_t>(server_role));
     }
 
+    int ObGeneralRpcStub::heartbeat_server(const int64_t timeout, const ObServer & root_server,
+        const ObServer & server, const ObRole server_role, const ObServerLoad & load) const
+    {
+      return post_request_3(root_server, timeout, OB_HEARTBEAT, NEW_VERSION,
+          ObTbnetCallback::default_callback, NULL,
+          server, static_cast<int32_t>(server_role), load);
+    }
+
     int ObGeneralRpcStub::find_server(const int64_t timeout, const ObServer & root_server,
         ObServer & update_server) const
     {
@@ -16,6 +16,7 @@
 #define OCEANBASE_COMMON_CTRL_RPC_STUB_H_
 
 #include "ob_server.h"
+#include "ob_server_load.h"
 #include "ob_rpc_stub.h"
 #include "common/location/ob_tablet_location_list.h"
 #include "sql/ob_physical_plan.h"
@@ -84,6 +85,12 @@ namespace oceanbase
         int heartbeat_server(const int64_t timeout, const common::ObServer & root_server,
             const common::ObServer & merge_server, const common::ObRole server_role) const;
 
+        // heartbeat to root server with the query load of chunkserver
+        // param  @load  the hottest tables of the server
+        int heartbeat_server(const int64_t timeout, const common::ObServer & root_server,
+            const common::ObServer & server, const common::ObRole server_role,
+            const common::ObServerLoad & load) const;
+
         // get update server vip addr through root server rpc call
         // param  @timeout  action timeout
         //        @root_server root server addr
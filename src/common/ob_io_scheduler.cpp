@@ -0,0 +1,251 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_io_scheduler.cpp for disk io scheduling of chunkserver.
+ *
+ */
+#include <unistd.h>
+#include <tblog.h>
+#include <tbsys.h>
+#include "ob_io_scheduler.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    namespace
+    {
+      __thread int g_thread_io_class = IO_CLASS_FOREGROUND;
+      __thread int64_t g_thread_io_disk = -1;
+    }
+
+    ObIOScheduler &ObIOScheduler::get_instance()
+    {
+      static ObIOScheduler scheduler;
+      return scheduler;
+    }
+
+    ObIOScheduler::ObIOScheduler()
+      : enable_(false), latency_target_us_(0), min_band_limit_(0)
+    {
+      memset(max_band_limit_, 0, sizeof(max_band_limit_));
+      for (int64_t i = 0; i <= MAX_DISK_NO; ++i)
+      {
+        ObIODiskQueue &queue = queues_[i];
+        queue.fg_inflight_ = 0;
+        queue.fg_latency_us_ = 0;
+        queue.fg_count_ = 0;
+        queue.last_adjust_time_ = 0;
+        memset(queue.band_limit_, 0, sizeof(queue.band_limit_));
+        memset(queue.tokens_, 0, sizeof(queue.tokens_));
+        memset(queue.last_refill_time_, 0, sizeof(queue.last_refill_time_));
+      }
+    }
+
+    void ObIOScheduler::set_config(const bool enable, const int64_t latency_target_us,
+                                   const int64_t band_limit[IO_CLASS_NUM],
+                                   const int64_t min_band_limit)
+    {
+      latency_target_us_ = (latency_target_us < 0) ? 0 : latency_target_us;
+      min_band_limit_ = (min_band_limit < 0) ? 0 : min_band_limit;
+      max_band_limit_[IO_CLASS_FOREGROUND] = 0;
+      for (int64_t c = IO_CLASS_FOREGROUND + 1; c < IO_CLASS_NUM; ++c)
+      {
+        max_band_limit_[c] = (band_limit[c] < 0) ? 0 : band_limit[c];
+      }
+
+      // restart the adaptive limits from the new upper limits
+      for (int64_t i = 0; i <= MAX_DISK_NO; ++i)
+      {
+        ObIODiskQueue &queue = queues_[i];
+        tbsys::CThreadGuard guard(&queue.mutex_);
+        for (int64_t c = IO_CLASS_FOREGROUND + 1; c < IO_CLASS_NUM; ++c)
+        {
+          queue.band_limit_[c] = max_band_limit_[c];
+          queue.tokens_[c] = 0;
+          queue.last_refill_time_[c] = 0;
+        }
+      }
+      enable_ = enable;
+
+      TBSYS_LOG(INFO, "set io scheduler, enable=%d latency_target=%ldus merge=%ld "
+                "migrate=%ld load=%ld min_band_limit=%ld", enable_, latency_target_us_,
+                max_band_limit_[IO_CLASS_MERGE], max_band_limit_[IO_CLASS_MIGRATE],
+                max_band_limit_[IO_CLASS_LOAD], min_band_limit_);
+    }
+
+    void ObIOScheduler::set_thread_io_class(const ObIOClass io_class)
+    {
+      g_thread_io_class = io_class;
+    }
+
+    ObIOClass ObIOScheduler::get_thread_io_class()
+    {
+      return static_cast<ObIOClass>(g_thread_io_class);
+    }
+
+    void ObIOScheduler::set_thread_io_disk(const int64_t disk_no)
+    {
+      g_thread_io_disk = disk_no;
+    }
+
+    int64_t ObIOScheduler::get_thread_io_disk()
+    {
+      return g_thread_io_disk;
+    }
+
+    ObIOScheduler::ObIODiskQueue *ObIOScheduler::get_queue(const int64_t disk_no)
+    {
+      return (disk_no >= 0 && disk_no <= MAX_DISK_NO) ? &queues_[disk_no] : NULL;
+    }
+
+    const ObIOScheduler::ObIODiskQueue *ObIOScheduler::get_queue(const int64_t disk_no) const
+    {
+      return (disk_no >= 0 && disk_no <= MAX_DISK_NO) ? &queues_[disk_no] : NULL;
+    }
+
+    void ObIOScheduler::throttle(const int64_t disk_no, const int64_t size)
+    {
+      const ObIOClass io_class = get_thread_io_class();
+      ObIODiskQueue *queue = NULL;
+      int64_t wait_us = 0;
+
+      if (!enable_ || IO_CLASS_FOREGROUND == io_class || io_class >= IO_CLASS_NUM
+          || size <= 0 || NULL == (queue = get_queue(disk_no)))
+      {
+        // not throttled
+      }
+      else
+      {
+        tbsys::CThreadGuard guard(&queue->mutex_);
+        const int64_t now = tbsys::CTimeUtil::getTime();
+        adjust_band_limit(*queue, now);
+
+        const int64_t band_limit = queue->band_limit_[io_class];
+        if (band_limit > 0)
+        {
+          // refill, at most BURST_US of tokens are saved for the idle time,
+          // the debt left by the former ios is paid first
+          const int64_t burst = band_limit * BURST_US / 1000000;
+          const int64_t full_us = (burst - queue->tokens_[io_class]) * 1000000 / band_limit;
+          int64_t elapsed_us = now - queue->last_refill_time_[io_class];
+          elapsed_us = (elapsed_us < 0) ? 0 : elapsed_us;
+          if (elapsed_us >= full_us)
+          {
+            queue->tokens_[io_class] = burst;
+          }
+          else
+          {
+            queue->tokens_[io_class] += band_limit * elapsed_us / 1000000;
+          }
+          queue->last_refill_time_[io_class] = now;
+
+          // take the tokens even if not enough, the debt is paid by sleeping
+          queue->tokens_[io_class] -= size;
+          if (queue->tokens_[io_class] < 0)
+          {
+            wait_us = -queue->tokens_[io_class] * 1000000 / band_limit;
+          }
+        }
+
+        if (queue->fg_inflight_ > 0)
+        {
+          wait_us += MAX_YIELD_US;
+        }
+      }
+
+      // usleep doesn't accept a second or more, pay the whole debt in slices
+      while (wait_us > 0)
+      {
+        const int64_t sleep_us = (wait_us > MAX_WAIT_US) ? MAX_WAIT_US : wait_us;
+        usleep(static_cast<useconds_t>(sleep_us));
+        wait_us -= sleep_us;
+      }
+    }
+
+    void ObIOScheduler::adjust_band_limit(ObIODiskQueue &queue, const int64_t now)
+    {
+      if (now - queue.last_adjust_time_ >= ADJUST_INTERVAL_US)
+      {
+        const bool overload = queue.fg_count_ > 0 && latency_target_us_ > 0
+          && queue.fg_latency_us_ > latency_target_us_;
+
+        for (int64_t c = IO_CLASS_FOREGROUND + 1; c < IO_CLASS_NUM; ++c)
+        {
+          const int64_t max_band_limit = max_band_limit_[c];
+          const int64_t min_band_limit = (min_band_limit_ < max_band_limit)
+            ? min_band_limit_ : max_band_limit;
+          int64_t band_limit = queue.band_limit_[c];
+
+          if (max_band_limit <= 0)
+          {
+            band_limit = 0;
+          }
+          else if (overload)
+          {
+            // the lowest priority class gives up its bandwidth fastest
+            band_limit = (IO_CLASS_LOAD == c) ? band_limit / 4 : band_limit / 2;
+            band_limit = (band_limit < min_band_limit) ? min_band_limit : band_limit;
+          }
+          else
+          {
+            band_limit += max_band_limit / 8;
+            band_limit = (band_limit > max_band_limit) ? max_band_limit : band_limit;
+          }
+
+          if (band_limit != queue.band_limit_[c])
+          {
+            TBSYS_LOG(DEBUG, "adjust io band limit, class=%ld from %ld to %ld, "
+                      "fg_latency=%ldus fg_count=%ld", c, queue.band_limit_[c],
+                      band_limit, queue.fg_latency_us_, queue.fg_count_);
+            queue.band_limit_[c] = band_limit;
+          }
+        }
+
+        queue.fg_count_ = 0;
+        queue.last_adjust_time_ = now;
+      }
+    }
+
+    void ObIOScheduler::begin_foreground_io(const int64_t disk_no)
+    {
+      ObIODiskQueue *queue = get_queue(disk_no);
+      if (NULL != queue)
+      {
+        __sync_add_and_fetch(&queue->fg_inflight_, 1);
+      }
+    }
+
+    void ObIOScheduler::end_foreground_io(const int64_t disk_no, const int64_t elapsed_us)
+    {
+      ObIODiskQueue *queue = get_queue(disk_no);
+      if (NULL != queue)
+      {
+        __sync_sub_and_fetch(&queue->fg_inflight_, 1);
+        // the average is updated without lock, a lost sample doesn't matter
+        const int64_t latency = queue->fg_latency_us_;
+        queue->fg_latency_us_ = (0 == latency) ? elapsed_us : (latency * 7 + elapsed_us) / 8;
+        __sync_add_and_fetch(&queue->fg_count_, 1);
+      }
+    }
+
+    int64_t ObIOScheduler::get_band_limit(const int64_t disk_no, const ObIOClass io_class) const
+    {
+      const ObIODiskQueue *queue = get_queue(disk_no);
+      return (NULL == queue || io_class < 0 || io_class >= IO_CLASS_NUM)
+        ? 0 : queue->band_limit_[io_class];
+    }
+
+    int64_t ObIOScheduler::get_foreground_latency(const int64_t disk_no) const
+    {
+      const ObIODiskQueue *queue = get_queue(disk_no);
+      return (NULL == queue) ? 0 : queue->fg_latency_us_;
+    }
+  } // end namespace common
+} // end namespace oceanbase
@@ -0,0 +1,149 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_io_scheduler.h for disk io scheduling of chunkserver.
+ *
+ */
+#ifndef OCEANBASE_COMMON_OB_IO_SCHEDULER_H_
+#define OCEANBASE_COMMON_OB_IO_SCHEDULER_H_
+
+#include <tbsys.h>
+#include "ob_define.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    enum ObIOClass
+    {
+      IO_CLASS_FOREGROUND = 0,    // query read, never throttled
+      IO_CLASS_MERGE,             // daily merge read and write
+      IO_CLASS_MIGRATE,           // tablet migration read
+      IO_CLASS_LOAD,              // bypass sstable load
+      IO_CLASS_NUM,
+    };
+
+    /**
+     * chunkserver的磁盘IO调度，每块盘为每个后台IO类别维护一个令牌桶
+     * 1. 前台读(查询)不限速，只统计每块盘的在途请求数和平均延迟
+     * 2. 后台IO(合并、迁移、旁路导入)按线程所属类别和磁盘取令牌，不够时睡眠等待，
+     *    同一块盘上有前台读在途时再让出一小段时间
+     * 3. 每个调整周期根据前台读延迟调整后台限速：超过目标延迟时乘性下降
+     *    (旁路导入优先级最低，下降最快)，否则加性恢复到配置的上限
+     * 4. IO类别和磁盘号是线程属性，由发起后台IO的线程设置，底层读写接口据此限速
+     */
+    class ObIOScheduler
+    {
+      public:
+        static const int64_t MAX_DISK_NO = 64;
+        static const int64_t ADJUST_INTERVAL_US = 200 * 1000;
+        static const int64_t BURST_US = 100 * 1000;
+        static const int64_t MAX_YIELD_US = 2 * 1000;
+        static const int64_t MAX_WAIT_US = 1000 * 1000 - 1;  // longest single usleep
+
+      public:
+        static ObIOScheduler &get_instance();
+
+        /**
+         * @param enable false if no background io is throttled
+         * @param latency_target_us target of the foreground read latency,
+         *        0 means the background limits are never lowered
+         * @param band_limit max bytes per second of each class on each
+         *        disk, <= 0 means the class isn't throttled, the limit of
+         *        IO_CLASS_FOREGROUND is ignored
+         * @param min_band_limit the adaptive limit never drops below it
+         */
+        void set_config(const bool enable, const int64_t latency_target_us,
+                        const int64_t band_limit[IO_CLASS_NUM],
+                        const int64_t min_band_limit);
+
+        /// io class and disk of the io issued by current thread
+        static void set_thread_io_class(const ObIOClass io_class);
+        static ObIOClass get_thread_io_class();
+        static void set_thread_io_disk(const int64_t disk_no);
+        static int64_t get_thread_io_disk();
+
+        /**
+         * wait the tokens of the background io of current thread, return
+         * at once for the foreground io or an unknown disk
+         *
+         * @param disk_no disk of the io
+         * @param size bytes to read or write
+         */
+        void throttle(const int64_t disk_no, const int64_t size);
+        void throttle(const int64_t size)
+        {
+          throttle(get_thread_io_disk(), size);
+        }
+
+        /// account a foreground read on disk_no
+        void begin_foreground_io(const int64_t disk_no);
+        void end_foreground_io(const int64_t disk_no, const int64_t elapsed_us);
+
+        int64_t get_band_limit(const int64_t disk_no, const ObIOClass io_class) const;
+        int64_t get_foreground_latency(const int64_t disk_no) const;
+
+      private:
+        struct ObIODiskQueue
+        {
+          tbsys::CThreadMutex mutex_;
+          volatile int64_t fg_inflight_;
+          volatile int64_t fg_latency_us_;    // moving average of the foreground reads
+          volatile int64_t fg_count_;         // foreground reads in current adjust interval
+          int64_t last_adjust_time_;
+          int64_t band_limit_[IO_CLASS_NUM];
+          int64_t tokens_[IO_CLASS_NUM];
+          int64_t last_refill_time_[IO_CLASS_NUM];
+        };
+
+      private:
+        ObIOScheduler();
+        ~ObIOScheduler() {}
+        DISALLOW_COPY_AND_ASSIGN(ObIOScheduler);
+
+        ObIODiskQueue *get_queue(const int64_t disk_no);
+        const ObIODiskQueue *get_queue(const int64_t disk_no) const;
+        void adjust_band_limit(ObIODiskQueue &queue, const int64_t now);
+
+      private:
+        bool enable_;
+        int64_t latency_target_us_;
+        int64_t max_band_limit_[IO_CLASS_NUM];
+        int64_t min_band_limit_;
+        ObIODiskQueue queues_[MAX_DISK_NO + 1];
+    };
+
+    /**
+     * set the io class and disk of current thread in a scope
+     */
+    class ObIOClassGuard
+    {
+      public:
+        ObIOClassGuard(const ObIOClass io_class, const int64_t disk_no)
+          : io_class_(ObIOScheduler::get_thread_io_class()),
+            disk_no_(ObIOScheduler::get_thread_io_disk())
+        {
+          ObIOScheduler::set_thread_io_class(io_class);
+          ObIOScheduler::set_thread_io_disk(disk_no);
+        }
+        ~ObIOClassGuard()
+        {
+          ObIOScheduler::set_thread_io_class(io_class_);
+          ObIOScheduler::set_thread_io_disk(disk_no_);
+        }
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObIOClassGuard);
+        ObIOClass io_class_;
+        int64_t disk_no_;
+    };
+  } // end namespace common
+} // end namespace oceanbase
+
+#endif //OCEANBASE_COMMON_OB_IO_SCHEDULER_H_
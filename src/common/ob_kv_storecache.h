@@ -977,6 +977,8 @@ namespace oceanbase
       static const int64_t MEM_BLOCK_SIZE = MemBlock::MEM_BLOCK_SIZE;
       static const int64_t MAX_WASH_OUT_SIZE = 10 * MEM_BLOCK_SIZE;
       static const int64_t MAX_MEMBLOCK_INFO_COUNT = 128 * 1024; //128K
+      // 低优先级memblock提交时的访问时间，淘汰时排在所有正常memblock之前，被访问后提升为正常
+      static const int64_t LOW_PRIORITY_LAST_TIME = 1;
       typedef FreeList<MemBlock> MemBlockFreeList;
       struct MemBlockInfo
       {
@@ -1009,7 +1011,7 @@ namespace oceanbase
         KVStoreCache() : inited_(false), adapter_(NULL), free_list_(), avg_get_cnt_(0),
                          max_mb_num_(MAX_MEMBLOCK_INFO_COUNT),total_mb_num_(0), mb_infos_(NULL),
                          not_revert_cnt_(0), cache_miss_cnt_(0), cache_hit_cnt_(0),
-                         cur_memblock_(NULL)
+                         cur_memblock_(NULL), cur_low_memblock_(NULL)
         {
         };
         ~KVStoreCache()
@@ -1119,6 +1121,11 @@ namespace oceanbase
               free_list_.free(cur_memblock_);
               cur_memblock_ = NULL;
             }
+            if (NULL != cur_low_memblock_)
+            {
+              free_list_.free(cur_low_memblock_);
+              cur_low_memblock_ = NULL;
+            }
             inited_ = false;
             free_list_.clear();
             free_list_.set_max_alloc_size(INT64_MAX);
@@ -1153,6 +1160,11 @@ namespace oceanbase
                 free_list_.free(cur_memblock_);
                 cur_memblock_ = NULL;
               }
+              if (NULL != cur_low_memblock_)
+              {
+                free_list_.free(cur_low_memblock_);
+                cur_low_memblock_ = NULL;
+              }
             }
           }
           return ret;
@@ -1162,8 +1174,15 @@ namespace oceanbase
           adapter_ = adapter;
         };
       public:
+        /**
+         * @param low_priority store the kvpair into a separate memblock which
+         *        is washed out before all the normal memblocks unless it is
+         *        accessed after submitted, used for data read by scans so that
+         *        a large scan doesn't wash out the hot kvpairs
+         */
         int store(const Key &key, const Value &value, StoreHandle &handle,
-                  Key **ppkey = NULL, Value **ppvalue = NULL)
+                  Key **ppkey = NULL, Value **ppvalue = NULL,
+                  const bool low_priority = false)
         {
           int ret = OB_SUCCESS;
           MemBlock *memblock = NULL;
@@ -1178,7 +1197,7 @@ namespace oceanbase
           {
             ret = OB_INVALID_ARGUMENT;
           }
-          else if (NULL == (memblock = get_cur_memblock_(seq_num, align_kv_size)))
+          else if (NULL == (memblock = get_cur_memblock_(seq_num, align_kv_size, low_priority)))
           {
             ret = OB_BUF_NOT_ENOUGH;
           }
@@ -1218,14 +1237,14 @@ namespace oceanbase
                    * function get_cur_memblock_() can ensure big memblock is
                    * thread local.
                    */
-                  submit_memblock_(memblock);
+                  submit_memblock_(memblock, low_priority);
                 }
                 break;
               }
               else if (OB_BUF_NOT_ENOUGH == ret)
               {
-                submit_cur_memblock_(memblock);
-                if (NULL == (memblock = get_cur_memblock_(seq_num, align_kv_size)))
+                submit_cur_memblock_(memblock, low_priority);
+                if (NULL == (memblock = get_cur_memblock_(seq_num, align_kv_size, low_priority)))
                 {
                   break;
                 }
@@ -1308,6 +1327,16 @@ namespace oceanbase
                       tmp_mem_block = cur_memblock_;
                       TBSYS_LOG(DEBUG, "start scan cur_memblock");
                     }
+                    else if (handle.mb_infos_pos == total_mb_num_ + 1
+                            && NULL != cur_low_memblock_)
+                    {
+                      tmp_mem_block = cur_low_memblock_;
+                      TBSYS_LOG(DEBUG, "start scan cur_low_memblock");
+                    }
+                    else if (handle.mb_infos_pos <= total_mb_num_ + 1)
+                    {
+                      // current memblock is NULL, try the next one
+                    }
                     else
                     {
                       ret = OB_ITER_END;
@@ -1562,9 +1591,10 @@ namespace oceanbase
           TBSYS_LOG_US(DEBUG, "sort_timeu=%ld free_timeu=%ld", sort_timeu, free_timeu);
           return wash_out_size;
         };
-        MemBlock *get_cur_memblock_(int32_t &seq_num, const int64_t align_kv_size)
+        MemBlock *get_cur_memblock_(int32_t &seq_num, const int64_t align_kv_size, const bool low_priority)
         {
           MemBlock *ret = NULL;
+          MemBlock * volatile &cur_memblock = low_priority ? cur_low_memblock_ : cur_memblock_;
           if (align_kv_size > free_list_.get_max_alloc_size())
           {
             TBSYS_LOG_US(WARN, "cann't allocate memblock from free list, kv size is bigger "
@@ -1578,7 +1608,7 @@ namespace oceanbase
             {
               if (align_kv_size > MemBlock::MEM_BLOCK_SIZE
                   || (align_kv_size <= MemBlock::MEM_BLOCK_SIZE
-                      && (NULL == (ret = cur_memblock_) || !ret->check_and_inc_ref_cnt())))
+                      && (NULL == (ret = cur_memblock) || !ret->check_and_inc_ref_cnt())))
               {
                 MemBlock *new_memblock = free_list_.alloc(align_kv_size);
                 while (NULL == new_memblock)
@@ -1620,7 +1650,7 @@ namespace oceanbase
                 else
                 {
                   MemBlock *old_memblock = NULL;
-                  if (NULL == (old_memblock = (MemBlock*)atomic_compare_exchange((uint64_t*)&cur_memblock_, (uint64_t)new_memblock, (uint64_t)NULL)))
+                  if (NULL == (old_memblock = (MemBlock*)atomic_compare_exchange((uint64_t*)&cur_memblock, (uint64_t)new_memblock, (uint64_t)NULL)))
                   {
                     ret = new_memblock;
                     break;
@@ -1644,7 +1674,7 @@ namespace oceanbase
           }
           return ret;
         };
-        void submit_memblock_(MemBlock *submit_memblock)
+        void submit_memblock_(MemBlock *submit_memblock, const bool low_priority)
         {
           int64_t i = 0;
           for (; i < total_mb_num_; i++)
@@ -1658,7 +1688,9 @@ namespace oceanbase
           {
             // 有原子性问题 可能更新的访问计数已经不是这个memblock的了 这个误差可以接受
             mb_infos_[i].get_cnt = submit_memblock->get_cnt();
-            mb_infos_[i].last_time = tbsys::CTimeUtil::getTime();
+            // 低优先级的memblock在成为当前memblock期间没有被访问过，才按低优先级淘汰
+            mb_infos_[i].last_time = (low_priority && 0 == submit_memblock->get_cnt())
+              ? LOW_PRIORITY_LAST_TIME : tbsys::CTimeUtil::getTime();
             submit_memblock->set_info_pos(i);
           }
           else
@@ -1669,11 +1701,12 @@ namespace oceanbase
             deref_memblock_(submit_memblock);
           }
         };
-        void submit_cur_memblock_(MemBlock *submit_memblock)
+        void submit_cur_memblock_(MemBlock *submit_memblock, const bool low_priority)
         {
-          if (submit_memblock == (MemBlock*)atomic_compare_exchange((uint64_t*)&cur_memblock_, (uint64_t)NULL, (uint64_t)submit_memblock))
+          MemBlock * volatile &cur_memblock = low_priority ? cur_low_memblock_ : cur_memblock_;
+          if (submit_memblock == (MemBlock*)atomic_compare_exchange((uint64_t*)&cur_memblock, (uint64_t)NULL, (uint64_t)submit_memblock))
           {
-            submit_memblock_(submit_memblock);
+            submit_memblock_(submit_memblock, low_priority);
           }
         };
       private:
@@ -1692,6 +1725,7 @@ namespace oceanbase
         int64_t cache_hit_cnt_;
 
         MemBlock * volatile cur_memblock_;
+        MemBlock * volatile cur_low_memblock_;
     };
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1817,7 +1851,8 @@ namespace oceanbase
           return store_.get_miss_cnt();
         };
       private:
-        int internal_put(const Key &key, const Value &value, StoreHandle& store_handle, bool overwrite = true)
+        int internal_put(const Key &key, const Value &value, StoreHandle& store_handle, bool overwrite = true,
+                         const bool low_priority = false)
         {
           int ret = OB_SUCCESS;
           Key *pkey = NULL;
@@ -1829,7 +1864,7 @@ namespace oceanbase
           {
             ret = OB_ENTRY_EXIST;
           }
-          else if (OB_SUCCESS != (ret = store_.store(key, value, store_handle, &pkey))
+          else if (OB_SUCCESS != (ret = store_.store(key, value, store_handle, &pkey, NULL, low_priority))
                   || NULL == pkey)
           {
             TBSYS_LOG(WARN, "store key-value fail ret=%d", ret);
@@ -1884,14 +1919,19 @@ namespace oceanbase
          *  use like this, the result is ok, but it will waste memblock
          *  memory.
          *
+         * if the low_priority param is true, the key-value is washed out
+         * before the others unless it is got again, use it for the
+         * key-values which are unlikely to be reused, such as the blocks
+         * read by a sequential scan.
+         *
          * @return int
          */
-        int put(const Key &key, const Value &value, bool overwrite = true)
+        int put(const Key &key, const Value &value, bool overwrite = true, const bool low_priority = false)
         {
           int ret = OB_SUCCESS;
           StoreHandle store_handle;
 
-          ret = internal_put(key, value, store_handle, overwrite);
+          ret = internal_put(key, value, store_handle, overwrite, low_priority);
             if (OB_SUCCESS == ret)
             {
               store_.revert(store_handle);
@@ -54,7 +54,7 @@ namespace oceanbase
     } eof_flag_buf_constructor_;
 
     ObLogGenerator::ObLogGenerator(): is_frozen_(false), log_file_max_size_(1<<24), start_cursor_(), end_cursor_(),
-                                      log_buf_(NULL), log_buf_len_(0), pos_(0)
+                                      log_buf_(NULL), spare_buf_(NULL), log_buf_len_(0), pos_(0)
     {
       memset(empty_log_, 0, sizeof(empty_log_));
     }
@@ -66,6 +66,11 @@ namespace oceanbase
         free(log_buf_);
         log_buf_ = NULL;
       }
+      if(NULL != spare_buf_)
+      {
+        free(spare_buf_);
+        spare_buf_ = NULL;
+      }
     }
 
     bool ObLogGenerator::is_inited() const
@@ -640,5 +645,37 @@ namespace oceanbase
       }
       return err;
     }
+
+    int ObLogGenerator:: detach_log(ObLogCursor& start_cursor, ObLogCursor& end_cursor, char*& buf, int64_t& len)
+    {
+      int err = OB_SUCCESS;
+      int sys_err = 0;
+      char* frozen_buf = NULL;
+      if (OB_SUCCESS != (err = check_state()))
+      {
+        TBSYS_LOG(ERROR, "check_state()=>%d", err);
+      }
+      else if (NULL == spare_buf_
+               && 0 != (sys_err = posix_memalign((void**)&spare_buf_, LOG_FILE_ALIGN_SIZE, log_buf_len_)))
+      {
+        err = OB_ALLOCATE_MEMORY_FAILED;
+        TBSYS_LOG(ERROR, "posix_memalign(%ld):%s", log_buf_len_, strerror(sys_err));
+      }
+      else if (OB_SUCCESS != (err = get_log(start_cursor, end_cursor, frozen_buf, len)))
+      {
+        TBSYS_LOG(ERROR, "get_log()=>%d", err);
+      }
+      else
+      {
+        log_buf_ = spare_buf_;
+        spare_buf_ = frozen_buf;
+        buf = frozen_buf;
+        if (OB_SUCCESS != (err = commit(end_cursor)))
+        {
+          TBSYS_LOG(ERROR, "commit(end_cursor=%s)=>%d", to_cstring(end_cursor), err);
+        }
+      }
+      return err;
+    }
   } // end namespace common
 } // end namespace oceanbase
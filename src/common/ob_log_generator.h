@@ -46,6 +46,8 @@ namespace oceanbase
         int write_log(const LogCommand cmd, T& data);
         int get_log(ObLogCursor& start_cursor, ObLogCursor& end_cursor, char*& buf, int64_t& len);
         int commit(const ObLogCursor& end_cursor);
+        // 冻结当前缓冲区并与备用缓冲区交换后立即commit, 返回的buf在下一次detach_log之前保持有效
+        int detach_log(ObLogCursor& start_cursor, ObLogCursor& end_cursor, char*& buf, int64_t& len);
         int switch_log(int64_t& new_file_id);
         int check_point(int64_t& cur_log_file_id);
         int gen_keep_alive();
@@ -73,6 +75,7 @@ namespace oceanbase
         ObLogCursor start_cursor_;
         ObLogCursor end_cursor_;
         char* log_buf_;
+        char* spare_buf_; // detach_log时与log_buf_交换, 第一次使用时分配
         int64_t log_buf_len_;
         int64_t pos_;
         char empty_log_[LOG_FILE_ALIGN_SIZE * 2];
@@ -22,7 +22,8 @@ using namespace oceanbase::common;
 ObLogWriter::ObLogWriter(): is_initialized_(false),
                             net_warn_threshold_us_(5000),
                             disk_warn_threshold_us_(5000),
-                            last_net_elapse_(0), last_disk_elapse_(0), last_flush_log_time_(0)
+                            last_net_elapse_(0), last_disk_elapse_(0), last_flush_log_time_(0),
+                            has_detached_log_(false), detached_buf_(NULL), detached_len_(0)
 {
 }
 
@@ -163,11 +164,55 @@ int ObLogWriter::write_keep_alive_log()
   return err;
 }
 
-int ObLogWriter::flush_log(TraceLog::LogBuffer &tlog_buffer, const bool sync_to_slave, const bool is_master)
+int ObLogWriter::write_and_sync_log_(const ObLogCursor& start_cursor, const ObLogCursor& end_cursor,
+                                     char* buf, const int64_t len, const bool sync_to_slave)
 {
-  int ret = check_inner_stat();
+  int ret = OB_SUCCESS;
   int send_err = OB_SUCCESS;
   int64_t store_start_time_us = tbsys::CTimeUtil::getTime();
+  if (OB_SUCCESS != (ret = log_writer_.write(start_cursor, end_cursor,
+                                             buf, len + ObLogGenerator::LOG_FILE_ALIGN_SIZE)))
+  {
+    TBSYS_LOG(ERROR, "log_writer.write_log(buf=%p[%ld], cursor=[%s,%s])=>%d, maybe disk FULL or Broken",
+              buf, len, to_cstring(start_cursor), to_cstring(end_cursor), ret);
+  }
+  else
+  {
+    last_disk_elapse_ = tbsys::CTimeUtil::getTime() - store_start_time_us;
+    if (last_disk_elapse_ > disk_warn_threshold_us_)
+    {
+      TBSYS_LOG(WARN, "last_disk_elapse_[%ld] > disk_warn_threshold_us[%ld]", last_disk_elapse_, disk_warn_threshold_us_);
+    }
+  }
+  // 本地写盘成功后才同步给备机, 否则备机会比主机多出日志
+  if (OB_SUCCESS != ret || !sync_to_slave)
+  {}
+  else
+  {
+    int64_t net_start_time_us = tbsys::CTimeUtil::getTime();
+    if (OB_SUCCESS != (send_err = slave_mgr_->post_log_to_slave(buf, len)))
+    {
+      TBSYS_LOG(WARN, "slave_mgr.send_data(buf=%p[%ld], %s)=>%d", buf, len, to_cstring(*this), send_err);
+    }
+    if (OB_SUCCESS != (send_err = slave_mgr_->wait_post_log_to_slave(buf, len)))
+    {
+      TBSYS_LOG(ERROR, "slave_mgr.send_data(buf=%p[%ld], cur_write=[%s,%s], %s)=>%d", buf, len, to_cstring(start_cursor), to_cstring(end_cursor), to_cstring(*this), send_err);
+    }
+    else
+    {
+      last_net_elapse_ = tbsys::CTimeUtil::getTime() - net_start_time_us;
+      if (last_net_elapse_ > net_warn_threshold_us_)
+      {
+        TBSYS_LOG(WARN, "last_net_elapse_[%ld] > net_warn_threshold_us[%ld]", last_net_elapse_, net_warn_threshold_us_);
+      }
+    }
+  }
+  return ret;
+}
+
+int ObLogWriter::flush_log(TraceLog::LogBuffer &tlog_buffer, const bool sync_to_slave, const bool is_master)
+{
+  int ret = check_inner_stat();
   char* buf = NULL;
   int64_t len = 0;
   ObLogCursor start_cursor;
@@ -176,46 +221,23 @@ int ObLogWriter::flush_log(TraceLog::LogBuffer &tlog_buffer, const bool sync_to_
   {
     TBSYS_LOG(ERROR, "check_inner_stat()=>%d", ret);
   }
+  else
+  {
+    wait_detached_log();
+  }
+  if (OB_SUCCESS != ret)
+  {}
   else if (OB_SUCCESS != (ret = log_generator_.get_log(start_cursor, end_cursor, buf, len)))
   {
     TBSYS_LOG(ERROR, "log_generator.get_log()=>%d", ret);
   }
   else if (len <= 0)
   {}
-  else if (OB_SUCCESS != (ret = log_writer_.write(start_cursor, end_cursor,
-                                                  buf, len + ObLogGenerator::LOG_FILE_ALIGN_SIZE)))
+  else if (OB_SUCCESS != (ret = write_and_sync_log_(start_cursor, end_cursor, buf, len, sync_to_slave)))
   {
-    TBSYS_LOG(ERROR, "log_writer.write_log(buf=%p[%ld], cursor=[%s,%s])=>%d, maybe disk FULL or Broken",
+    TBSYS_LOG(ERROR, "write_and_sync_log(buf=%p[%ld], cursor=[%s,%s])=>%d",
               buf, len, to_cstring(start_cursor), to_cstring(end_cursor), ret);
   }
-  else
-  {
-    last_disk_elapse_ = tbsys::CTimeUtil::getTime() - store_start_time_us;
-    if (last_disk_elapse_ > disk_warn_threshold_us_)
-    {
-      TBSYS_LOG(WARN, "last_disk_elapse_[%ld] > disk_warn_threshold_us[%ld]", last_disk_elapse_, disk_warn_threshold_us_);
-    }
-    if (sync_to_slave)
-    {
-      int64_t net_start_time_us = tbsys::CTimeUtil::getTime();
-      if (OB_SUCCESS != (send_err = slave_mgr_->post_log_to_slave(buf, len)))
-      {
-        TBSYS_LOG(WARN, "slave_mgr.send_data(buf=%p[%ld], %s)=>%d", buf, len, to_cstring(*this), send_err);
-      }
-      if (OB_SUCCESS != (send_err = slave_mgr_->wait_post_log_to_slave(buf, len)))
-      {
-        TBSYS_LOG(ERROR, "slave_mgr.send_data(buf=%p[%ld], cur_write=[%s,%s], %s)=>%d", buf, len, to_cstring(start_cursor), to_cstring(end_cursor), to_cstring(*this), send_err);
-      }
-      else
-      {
-        last_net_elapse_ = tbsys::CTimeUtil::getTime() - net_start_time_us;
-        if (last_net_elapse_ > net_warn_threshold_us_)
-        {
-          TBSYS_LOG(WARN, "last_net_elapse_[%ld] > net_warn_threshold_us[%ld]", last_net_elapse_, net_warn_threshold_us_);
-        }
-      }
-    }
-  }
   FILL_TRACE_BUF(tlog_buffer, "write_log disk=%ld net=%ld, log=%ld:%ld",
                  last_disk_elapse_, last_net_elapse_,
                  start_cursor.log_id_, end_cursor.log_id_);
@@ -236,6 +258,98 @@ int ObLogWriter::flush_log(TraceLog::LogBuffer &tlog_buffer, const bool sync_to_
   return ret;
 }
 
+int ObLogWriter::detach_log()
+{
+  int ret = check_inner_stat();
+  char* buf = NULL;
+  int64_t len = 0;
+  ObLogCursor start_cursor;
+  ObLogCursor end_cursor;
+  if (OB_SUCCESS != ret)
+  {
+    TBSYS_LOG(ERROR, "check_inner_stat()=>%d", ret);
+  }
+  else
+  {
+    // 备用缓冲区就是上一批摘下的日志所在的缓冲区, 必须等它刷完才能交换
+    wait_detached_log();
+    if (OB_SUCCESS != (ret = log_generator_.detach_log(start_cursor, end_cursor, buf, len)))
+    {
+      TBSYS_LOG(ERROR, "log_generator.detach_log()=>%d", ret);
+    }
+    else
+    {
+      detached_cond_.lock();
+      detached_start_cursor_ = start_cursor;
+      detached_end_cursor_ = end_cursor;
+      detached_buf_ = buf;
+      detached_len_ = len;
+      has_detached_log_ = true;
+      detached_cond_.unlock();
+    }
+  }
+  return ret;
+}
+
+int ObLogWriter::flush_detached_log(TraceLog::LogBuffer &tlog_buffer, const bool is_master)
+{
+  int ret = check_inner_stat();
+  bool has_detached_log = false;
+  if (OB_SUCCESS != ret)
+  {
+    TBSYS_LOG(ERROR, "check_inner_stat()=>%d", ret);
+  }
+  else
+  {
+    detached_cond_.lock();
+    has_detached_log = has_detached_log_;
+    detached_cond_.unlock();
+  }
+  if (OB_SUCCESS != ret || !has_detached_log)
+  {}
+  else
+  {
+    if (detached_len_ <= 0)
+    {}
+    else if (OB_SUCCESS != (ret = write_and_sync_log_(detached_start_cursor_, detached_end_cursor_,
+                                                      detached_buf_, detached_len_, true)))
+    {
+      TBSYS_LOG(ERROR, "write_and_sync_log(buf=%p[%ld], cursor=[%s,%s])=>%d",
+                detached_buf_, detached_len_, to_cstring(detached_start_cursor_), to_cstring(detached_end_cursor_), ret);
+    }
+    FILL_TRACE_BUF(tlog_buffer, "write_log disk=%ld net=%ld, log=%ld:%ld",
+                   last_disk_elapse_, last_net_elapse_,
+                   detached_start_cursor_.log_id_, detached_end_cursor_.log_id_);
+    if (OB_SUCCESS != ret)
+    {}
+    else if (OB_SUCCESS != (ret = write_log_hook(is_master, detached_start_cursor_, detached_end_cursor_,
+                                                 detached_buf_, detached_len_)))
+    {
+      TBSYS_LOG(ERROR, "write_log_hook(log_id=[%ld,%ld))=>%d",
+                detached_start_cursor_.log_id_, detached_end_cursor_.log_id_, ret);
+    }
+    else if (detached_len_ > 0)
+    {
+      last_flush_log_time_ = tbsys::CTimeUtil::getTime();
+    }
+    detached_cond_.lock();
+    has_detached_log_ = false;
+    detached_cond_.broadcast();
+    detached_cond_.unlock();
+  }
+  return ret;
+}
+
+void ObLogWriter::wait_detached_log()
+{
+  detached_cond_.lock();
+  while (has_detached_log_)
+  {
+    detached_cond_.wait();
+  }
+  detached_cond_.unlock();
+}
+
 int ObLogWriter::write_and_flush_log(const LogCommand cmd, const char* log_data, const int64_t data_len)
 {
   int ret = check_inner_stat();
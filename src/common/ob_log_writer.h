@@ -16,6 +16,7 @@
 #define OCEANBASE_COMMON_OB_LOG_WRITER_H_
 
 #include "tblog.h"
+#include "tbsys.h"
 
 #include "ob_define.h"
 #include "data_buffer.h"
@@ -95,13 +96,31 @@ namespace oceanbase
 
       int write_keep_alive_log();
       /// @brief 将缓冲区中的日志写入磁盘
-      /// flush_log首相将缓冲区中的内容同步到Slave机器
-      /// 然后写入磁盘
+      /// flush_log首先将缓冲区中的内容写入磁盘
+      /// 本地写成功后再同步到Slave机器
+      /// 如果有detach_log摘下还未刷完的日志, 先等待它完成
       /// @retval OB_SUCCESS 成功
       /// @retval otherwise 失败
       int flush_log(TraceLog::LogBuffer &tlog_buffer = oceanbase::common::TraceLog::get_logbuffer(),
                     const bool sync_to_slave = true, const bool is_master = true);
 
+      /// @brief 流水线刷盘的第一阶段
+      /// 冻结缓冲区中的日志并换上备用缓冲区, 调用者可以立即继续序列化下一批日志
+      /// 上一批摘下的日志还没有刷完时先等待它完成, 因此最多只有一批日志在刷盘
+      /// @retval OB_SUCCESS 成功
+      /// @retval otherwise 失败
+      int detach_log();
+
+      /// @brief 流水线刷盘的第二阶段, 可以在另一个线程中调用
+      /// 将detach_log摘下的日志写入磁盘, 写成功后再同步到Slave机器
+      /// @retval OB_SUCCESS 成功或者没有摘下的日志
+      /// @retval otherwise 失败
+      int flush_detached_log(TraceLog::LogBuffer &tlog_buffer = oceanbase::common::TraceLog::get_logbuffer(),
+                             const bool is_master = true);
+
+      /// @brief 等待detach_log摘下的日志刷完
+      void wait_detached_log();
+
       /// @brief 写日志并且写盘
       /// 序列化日志并且写盘
       /// 内部缓冲区原先如有数据, 会被清空
@@ -140,6 +159,9 @@ namespace oceanbase
       inline int64_t get_last_flush_log_time() {return last_flush_log_time_;}
 
     protected:
+      int write_and_sync_log_(const ObLogCursor& start_cursor, const ObLogCursor& end_cursor,
+                              char* buf, const int64_t len, const bool sync_to_slave);
+
       inline int check_inner_stat() const
       {
         int ret = OB_SUCCESS;
@@ -162,6 +184,12 @@ namespace oceanbase
         int64_t last_net_elapse_;  //上一次写日志网络同步耗时
         int64_t last_disk_elapse_;  //上一次写日志磁盘耗时
         int64_t last_flush_log_time_; // 上次刷磁盘的时间
+        tbsys::CThreadCond detached_cond_;
+        bool has_detached_log_;  // detach_log摘下的日志还没有刷完
+        ObLogCursor detached_start_cursor_;
+        ObLogCursor detached_end_cursor_;
+        char* detached_buf_;
+        int64_t detached_len_;
     };
     template<typename T>
     int ObLogWriter::write_log(const LogCommand cmd, const T& data)
@@ -210,6 +210,7 @@ namespace oceanbase
         OB_SQL_RESULT_SET_DYN,
         OB_SQL_SESSION_HASHMAP,
         OB_SQL_SESSION_SBLOCK,
+        OB_SQL_PLAN_CACHE,
 
         OB_MOD_END
       };
@@ -356,6 +357,7 @@ namespace oceanbase
       ADD_MOD(OB_SQL_RESULT_SET_DYN);
       ADD_MOD(OB_SQL_SESSION_HASHMAP);
       ADD_MOD(OB_SQL_SESSION_SBLOCK);
+      ADD_MOD(OB_SQL_PLAN_CACHE);
 
       ADD_MOD(OB_MOD_END);
     }
@@ -0,0 +1,303 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_normalized_rowkey.cpp
+ *
+ */
+#include "ob_normalized_rowkey.h"
+#include "utility.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    int ObNormalizedRowkey::encode(const ObRowkey &rowkey, char *buf, const int64_t buf_len, int64_t &pos)
+    {
+      int ret = OB_SUCCESS;
+      const ObObj *objs = rowkey.get_obj_ptr();
+      const int64_t obj_cnt = rowkey.get_obj_cnt();
+      if (NULL == buf || 0 > pos)
+      {
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (0 < obj_cnt
+              && (objs[0].is_min_value() || objs[0].is_max_value()))
+      {
+        // <min,min,min> == <min>, <max,max,max> == <max>
+        ret = encode_obj_(objs[0], buf, buf_len, pos);
+      }
+      else
+      {
+        for (int64_t i = 0; OB_SUCCESS == ret && i < obj_cnt; i++)
+        {
+          ret = encode_obj_(objs[i], buf, buf_len, pos);
+        }
+      }
+      return ret;
+    }
+
+    int ObNormalizedRowkey::assign(const ObRowkey &rowkey, char *buf, const int64_t buf_len)
+    {
+      int64_t pos = 0;
+      int ret = encode(rowkey, buf, buf_len, pos);
+      if (OB_SUCCESS == ret)
+      {
+        ptr_ = buf;
+        length_ = pos;
+      }
+      else
+      {
+        reset();
+      }
+      return ret;
+    }
+
+    int64_t ObNormalizedRowkey::to_string(char *buffer, const int64_t length) const
+    {
+      int64_t pos = 0;
+      if (NULL == ptr_)
+      {
+        databuff_printf(buffer, length, pos, "invalid");
+      }
+      else if (NULL != buffer && 0 < length)
+      {
+        pos = hex_to_str(ptr_, static_cast<int32_t>(std::min(length_, (length - 1) / 2)),
+                         buffer, static_cast<int32_t>(length));
+        pos *= 2;
+      }
+      return pos;
+    }
+
+    int ObNormalizedRowkey::encode_obj_(const ObObj &obj, char *buf, const int64_t buf_len, int64_t &pos)
+    {
+      int ret = OB_SUCCESS;
+      uint8_t flag = NORMAL_FLAG;
+      if (obj.is_min_value())
+      {
+        flag = MIN_FLAG;
+      }
+      else if (obj.is_max_value())
+      {
+        flag = MAX_FLAG;
+      }
+      else if (ObNullType == obj.get_type())
+      {
+        flag = NULL_FLAG;
+      }
+      if (pos >= buf_len)
+      {
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else
+      {
+        buf[pos++] = static_cast<char>(flag);
+      }
+      if (OB_SUCCESS == ret
+          && NORMAL_FLAG == flag)
+      {
+        switch (obj.get_type())
+        {
+          case ObIntType:
+            {
+              int64_t value = 0;
+              obj.get_int(value);
+              ret = encode_int_(value, buf, buf_len, pos);
+              break;
+            }
+          case ObDateTimeType:
+          case ObPreciseDateTimeType:
+          case ObCreateTimeType:
+          case ObModifyTimeType:
+            {
+              // 不同的时间类型之间按微秒比较
+              int64_t value = 0;
+              obj.get_timestamp(value);
+              ret = encode_int_(value, buf, buf_len, pos);
+              break;
+            }
+          case ObBoolType:
+            {
+              bool value = false;
+              obj.get_bool(value);
+              if (pos >= buf_len)
+              {
+                ret = OB_SIZE_OVERFLOW;
+              }
+              else
+              {
+                buf[pos++] = value ? 1 : 0;
+              }
+              break;
+            }
+          case ObVarcharType:
+            {
+              ObString value;
+              obj.get_varchar(value);
+              ret = encode_varchar_(value, buf, buf_len, pos);
+              break;
+            }
+          case ObDecimalType:
+            {
+              ObNumber value;
+              obj.get_decimal(value);
+              ret = encode_decimal_(value, buf, buf_len, pos);
+              break;
+            }
+          default:
+            ret = OB_NOT_SUPPORTED;
+            break;
+        }
+      }
+      return ret;
+    }
+
+    int ObNormalizedRowkey::encode_int_(const int64_t value, char *buf, const int64_t buf_len, int64_t &pos)
+    {
+      int ret = OB_SUCCESS;
+      if (pos + static_cast<int64_t>(sizeof(value)) > buf_len)
+      {
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else
+      {
+        // 符号位取反后无符号数的大小顺序与有符号数一致
+        uint64_t v = static_cast<uint64_t>(value) ^ (1UL << 63);
+        for (int64_t i = sizeof(v) - 1; i >= 0; i--)
+        {
+          buf[pos++] = static_cast<char>((v >> (i * 8)) & 0xFF);
+        }
+      }
+      return ret;
+    }
+
+    int ObNormalizedRowkey::encode_varchar_(const ObString &value, char *buf, const int64_t buf_len, int64_t &pos)
+    {
+      int ret = OB_SUCCESS;
+      const char *ptr = value.ptr();
+      for (int64_t i = 0; OB_SUCCESS == ret && i < value.length(); i++)
+      {
+        if ('\0' != ptr[i])
+        {
+          if (pos >= buf_len)
+          {
+            ret = OB_SIZE_OVERFLOW;
+          }
+          else
+          {
+            buf[pos++] = ptr[i];
+          }
+        }
+        else if (pos + 2 > buf_len)
+        {
+          ret = OB_SIZE_OVERFLOW;
+        }
+        else
+        {
+          buf[pos++] = '\0';
+          buf[pos++] = static_cast<char>(0xFF);
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        if (pos + 2 > buf_len)
+        {
+          ret = OB_SIZE_OVERFLOW;
+        }
+        else
+        {
+          // 结束符小于任何转义后的字符，短的前缀排在前面
+          buf[pos++] = '\0';
+          buf[pos++] = '\0';
+        }
+      }
+      return ret;
+    }
+
+    int ObNormalizedRowkey::encode_decimal_(const ObNumber &value, char *buf, const int64_t buf_len, int64_t &pos)
+    {
+      static const uint8_t NEGATIVE_FLAG = 0x01;
+      static const uint8_t ZERO_FLAG = 0x02;
+      static const uint8_t POSITIVE_FLAG = 0x03;
+      int ret = OB_SUCCESS;
+      char str[ObNumber::MAX_PRINTABLE_SIZE + 8];
+      int64_t str_len = value.to_string(str, sizeof(str));
+      const char *iter = str;
+      const char *end = str + std::min(str_len, static_cast<int64_t>(sizeof(str)) - 1);
+      bool is_neg = false;
+      if ('-' == *iter)
+      {
+        is_neg = true;
+        iter++;
+      }
+      // 0.d1d2...dn * 10^exp，有效数字去掉首尾的0
+      char digits[ObNumber::MAX_PRINTABLE_SIZE + 8];
+      int64_t digit_num = 0;
+      int64_t exp = 0;
+      bool after_point = false;
+      for (; iter < end; iter++)
+      {
+        if ('.' == *iter)
+        {
+          after_point = true;
+        }
+        else if (0 == digit_num && '0' == *iter)
+        {
+          if (after_point)
+          {
+            exp--;
+          }
+        }
+        else
+        {
+          digits[digit_num++] = *iter;
+          if (!after_point)
+          {
+            exp++;
+          }
+        }
+      }
+      while (0 < digit_num && '0' == digits[digit_num - 1])
+      {
+        digit_num--;
+      }
+      if (0 == digit_num)
+      {
+        if (pos >= buf_len)
+        {
+          ret = OB_SIZE_OVERFLOW;
+        }
+        else
+        {
+          buf[pos++] = static_cast<char>(ZERO_FLAG);
+        }
+      }
+      else if (INT8_MAX < exp || INT8_MIN > exp)
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else if (pos + 2 + digit_num + 1 > buf_len)
+      {
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else
+      {
+        // 负数按位取反，绝对值大的排在前面
+        const uint8_t mask = is_neg ? 0xFF : 0x00;
+        buf[pos++] = static_cast<char>(is_neg ? NEGATIVE_FLAG : POSITIVE_FLAG);
+        buf[pos++] = static_cast<char>((exp + 128) ^ mask);
+        for (int64_t i = 0; i < digit_num; i++)
+        {
+          buf[pos++] = static_cast<char>(digits[i] ^ mask);
+        }
+        buf[pos++] = static_cast<char>(0x00 ^ mask);
+      }
+      return ret;
+    }
+  }
+}
@@ -0,0 +1,89 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_normalized_rowkey.h
+ *
+ */
+#ifndef OCEANBASE_COMMON_OB_NORMALIZED_ROWKEY_H_
+#define OCEANBASE_COMMON_OB_NORMALIZED_ROWKEY_H_
+#include <string.h>
+#include "ob_define.h"
+#include "ob_object.h"
+#include "ob_rowkey.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    // 保序的rowkey二进制编码，两个rowkey编码结果的memcmp与ObRowkey::compare(rhs)的结果一致，
+    // 编码一次之后排序和查找只需要memcmp
+    // 每个obj编码为一个字节的标记加上值:
+    //   min: 0x00, null: 0x01, 普通值: 0x02, max: 0xFF
+    //   int/datetime/precise_datetime/create_time/modify_time: 时间统一换算为微秒，
+    //     符号位取反后按大端写8字节
+    //   bool: 1字节
+    //   varchar: 二进制比较，0x00转义为0x00 0xFF，以0x00 0x00结尾
+    //   decimal: 符号 + 十进制指数 + 去掉首尾0的有效数字，负数按位取反
+    // 第一个obj为min或max时整个rowkey只编码一个标记字节，与ObRowkey::compare中
+    // <min,min,min> == <min>的约定一致
+    // float/double按epsilon比较不是全序，其它extend值没有序，编码返回OB_NOT_SUPPORTED，
+    // 调用者退回到ObRowkey::compare
+    class ObNormalizedRowkey
+    {
+      public:
+        static const uint8_t MIN_FLAG = 0x00;
+        static const uint8_t NULL_FLAG = 0x01;
+        static const uint8_t NORMAL_FLAG = 0x02;
+        static const uint8_t MAX_FLAG = 0xFF;
+      public:
+        ObNormalizedRowkey() : ptr_(NULL), length_(0) {}
+        ObNormalizedRowkey(const char *ptr, const int64_t length) : ptr_(ptr), length_(length) {}
+        ~ObNormalizedRowkey() {}
+      public:
+        /**
+         * append the normalized encoding of rowkey to buf
+         *
+         * @return OB_SUCCESS, OB_SIZE_OVERFLOW if buf is not enough,
+         * OB_NOT_SUPPORTED if the rowkey has float, double or other extend values
+         */
+        static int encode(const ObRowkey &rowkey, char *buf, const int64_t buf_len, int64_t &pos);
+        /// encode rowkey to buf and point to it, invalid if failed
+        int assign(const ObRowkey &rowkey, char *buf, const int64_t buf_len);
+
+        inline bool is_valid() const { return NULL != ptr_; }
+        inline const char *ptr() const { return ptr_; }
+        inline int64_t length() const { return length_; }
+        inline void reset()
+        {
+          ptr_ = NULL;
+          length_ = 0;
+        }
+        inline int compare(const ObNormalizedRowkey &rhs) const
+        {
+          int cmp = memcmp(ptr_, rhs.ptr_, std::min(length_, rhs.length_));
+          if (0 == cmp)
+          {
+            cmp = (length_ < rhs.length_) ? -1 : ((length_ > rhs.length_) ? 1 : 0);
+          }
+          return cmp;
+        }
+        int64_t to_string(char *buffer, const int64_t length) const;
+      private:
+        static int encode_obj_(const ObObj &obj, char *buf, const int64_t buf_len, int64_t &pos);
+        static int encode_int_(const int64_t value, char *buf, const int64_t buf_len, int64_t &pos);
+        static int encode_varchar_(const ObString &value, char *buf, const int64_t buf_len, int64_t &pos);
+        static int encode_decimal_(const ObNumber &value, char *buf, const int64_t buf_len, int64_t &pos);
+      private:
+        const char *ptr_;
+        int64_t length_;
+    };
+  }
+}
+
+#endif //OCEANBASE_COMMON_OB_NORMALIZED_ROWKEY_H_
@@ -336,6 +336,7 @@ namespace oceanbase
       OB_UPS_SHOW_SESSIONS_RESPONSE = 1308,
       OB_UPS_KILL_SESSION = 1309,
       OB_UPS_KILL_SESSION_RESPONSE = 1310,
+      OB_UPS_ASYNC_COMPACT_HOT_ROWS = 1311,
 
       OB_GET_CLOG_STAT = 1340,
       OB_GET_CLOG_STAT_RESPONSE = 1341,
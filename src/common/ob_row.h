@@ -79,6 +79,8 @@ namespace oceanbase
          */
         int raw_get_cell(const int64_t cell_idx, const common::ObObj *&cell,
             uint64_t &table_id, uint64_t &column_id) const;
+        /// 不需要table_id和column_id时使用，不查row desc
+        inline int raw_get_cell(const int64_t cell_idx, const common::ObObj *&cell) const;
         inline int raw_get_cell_for_update(const int64_t cell_idx, common::ObObj *&cell);
 
         /// 设置第cell_idx个cell
@@ -148,6 +150,21 @@ namespace oceanbase
       row_desc_ = &row_desc;
     }
 
+    inline int ObRow::raw_get_cell(const int64_t cell_idx, const common::ObObj *&cell) const
+    {
+      int ret = OB_SUCCESS;
+      if (OB_UNLIKELY(cell_idx >= get_column_num()))
+      {
+        ret = OB_INVALID_ARGUMENT;
+        TBSYS_LOG(WARN, "invalid cell_idx=%ld cells_count=%ld", cell_idx, get_column_num());
+      }
+      else
+      {
+        ret = raw_row_.get_cell(cell_idx, cell);
+      }
+      return ret;
+    }
+
     inline int ObRow::raw_get_cell_for_update(const int64_t cell_idx, common::ObObj *&cell)
     {
       int ret = OB_SUCCESS;
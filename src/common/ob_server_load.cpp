@@ -0,0 +1,249 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_server_load.cpp for the query load of chunkserver reported
+ * to rootserver by heartbeat.
+ *
+ */
+#include <tblog.h>
+#include "ob_server_load.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    uint64_t ObTabletLoad::get_range_hash(const ObNewRange &range)
+    {
+      // ObNewRange::hash is 32 bits, add the hash of end key to make
+      // collisions among the tablets of one table unlikely
+      uint64_t hash = static_cast<uint32_t>(range.hash());
+      return (hash << 32) | range.end_key_.murmurhash2(static_cast<uint32_t>(range.table_id_));
+    }
+
+    ObServerLoad::ObServerLoad()
+      : table_count_(0), tablet_count_(0)
+    {
+    }
+
+    void ObServerLoad::reset()
+    {
+      table_count_ = 0;
+      tablet_count_ = 0;
+    }
+
+    int ObServerLoad::add_table_load(const ObTableLoad &load)
+    {
+      int ret = OB_SUCCESS;
+      if (table_count_ >= MAX_TABLE_LOAD_COUNT)
+      {
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else
+      {
+        tables_[table_count_++] = load;
+      }
+      return ret;
+    }
+
+    const ObTableLoad *ObServerLoad::get_table_load(const uint64_t table_id) const
+    {
+      const ObTableLoad *ret = NULL;
+      for (int64_t i = 0; i < table_count_; ++i)
+      {
+        if (tables_[i].table_id_ == table_id)
+        {
+          ret = &tables_[i];
+          break;
+        }
+      }
+      return ret;
+    }
+
+    int ObServerLoad::add_tablet_load(const ObTabletLoad &load)
+    {
+      int ret = OB_SUCCESS;
+      if (tablet_count_ >= MAX_TABLET_LOAD_COUNT)
+      {
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else
+      {
+        tablets_[tablet_count_++] = load;
+      }
+      return ret;
+    }
+
+    const ObTabletLoad *ObServerLoad::get_tablet_load(const uint64_t table_id, const uint64_t range_hash) const
+    {
+      const ObTabletLoad *ret = NULL;
+      for (int64_t i = 0; i < tablet_count_; ++i)
+      {
+        if (tablets_[i].table_id_ == table_id && tablets_[i].range_hash_ == range_hash)
+        {
+          ret = &tablets_[i];
+          break;
+        }
+      }
+      return ret;
+    }
+
+    DEFINE_SERIALIZE(ObServerLoad)
+    {
+      int ret = OB_SUCCESS;
+      int64_t tmp_pos = pos;
+      ret = serialization::encode_vi64(buf, buf_len, tmp_pos, table_count_);
+      for (int64_t i = 0; OB_SUCCESS == ret && i < table_count_; ++i)
+      {
+        if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, tmp_pos,
+                static_cast<int64_t>(tables_[i].table_id_)))
+            || OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, tmp_pos,
+                tables_[i].get_qps_))
+            || OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, tmp_pos,
+                tables_[i].scan_qps_))
+            || OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, tmp_pos,
+                tables_[i].scan_bytes_)))
+        {
+          TBSYS_LOG(WARN, "serialize table load error, ret=%d index=%ld", ret, i);
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        ret = serialization::encode_vi64(buf, buf_len, tmp_pos, tablet_count_);
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < tablet_count_; ++i)
+      {
+        if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, tmp_pos,
+                static_cast<int64_t>(tablets_[i].table_id_)))
+            || OB_SUCCESS != (ret = serialization::encode_i64(buf, buf_len, tmp_pos,
+                static_cast<int64_t>(tablets_[i].range_hash_)))
+            || OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, tmp_pos,
+                tablets_[i].get_qps_))
+            || OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, tmp_pos,
+                tablets_[i].scan_qps_))
+            || OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, tmp_pos,
+                tablets_[i].scan_bytes_)))
+        {
+          TBSYS_LOG(WARN, "serialize tablet load error, ret=%d index=%ld", ret, i);
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        pos = tmp_pos;
+      }
+      return ret;
+    }
+
+    DEFINE_DESERIALIZE(ObServerLoad)
+    {
+      int ret = OB_SUCCESS;
+      int64_t tmp_pos = pos;
+      int64_t count = 0;
+      int64_t table_id = 0;
+      reset();
+      if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos, &count)))
+      {
+        TBSYS_LOG(WARN, "deserialize table load count error, ret=%d", ret);
+      }
+      else if (count < 0 || count > MAX_TABLE_LOAD_COUNT)
+      {
+        TBSYS_LOG(WARN, "invalid table load count %ld", count);
+        ret = OB_SIZE_OVERFLOW;
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < count; ++i)
+      {
+        ObTableLoad &load = tables_[i];
+        if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos, &table_id))
+            || OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos,
+                &load.get_qps_))
+            || OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos,
+                &load.scan_qps_))
+            || OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos,
+                &load.scan_bytes_)))
+        {
+          TBSYS_LOG(WARN, "deserialize table load error, ret=%d index=%ld", ret, i);
+        }
+        else
+        {
+          load.table_id_ = static_cast<uint64_t>(table_id);
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        table_count_ = count;
+        count = 0;
+      }
+      // chunkservers of old version report no tablet
+      if (OB_SUCCESS == ret && tmp_pos < data_len)
+      {
+        if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos, &count)))
+        {
+          TBSYS_LOG(WARN, "deserialize tablet load count error, ret=%d", ret);
+        }
+        else if (count < 0 || count > MAX_TABLET_LOAD_COUNT)
+        {
+          TBSYS_LOG(WARN, "invalid tablet load count %ld", count);
+          ret = OB_SIZE_OVERFLOW;
+        }
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < count; ++i)
+      {
+        ObTabletLoad &load = tablets_[i];
+        int64_t range_hash = 0;
+        if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos, &table_id))
+            || OB_SUCCESS != (ret = serialization::decode_i64(buf, data_len, tmp_pos, &range_hash))
+            || OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos,
+                &load.get_qps_))
+            || OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos,
+                &load.scan_qps_))
+            || OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos,
+                &load.scan_bytes_)))
+        {
+          TBSYS_LOG(WARN, "deserialize tablet load error, ret=%d index=%ld", ret, i);
+        }
+        else
+        {
+          load.table_id_ = static_cast<uint64_t>(table_id);
+          load.range_hash_ = static_cast<uint64_t>(range_hash);
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        tablet_count_ = count;
+        pos = tmp_pos;
+      }
+      else
+      {
+        reset();
+      }
+      return ret;
+    }
+
+    DEFINE_GET_SERIALIZE_SIZE(ObServerLoad)
+    {
+      int64_t len = serialization::encoded_length_vi64(table_count_);
+      for (int64_t i = 0; i < table_count_; ++i)
+      {
+        len += serialization::encoded_length_vi64(static_cast<int64_t>(tables_[i].table_id_));
+        len += serialization::encoded_length_vi64(tables_[i].get_qps_);
+        len += serialization::encoded_length_vi64(tables_[i].scan_qps_);
+        len += serialization::encoded_length_vi64(tables_[i].scan_bytes_);
+      }
+      len += serialization::encoded_length_vi64(tablet_count_);
+      for (int64_t i = 0; i < tablet_count_; ++i)
+      {
+        len += serialization::encoded_length_vi64(static_cast<int64_t>(tablets_[i].table_id_));
+        len += serialization::encoded_length_i64(static_cast<int64_t>(tablets_[i].range_hash_));
+        len += serialization::encoded_length_vi64(tablets_[i].get_qps_);
+        len += serialization::encoded_length_vi64(tablets_[i].scan_qps_);
+        len += serialization::encoded_length_vi64(tablets_[i].scan_bytes_);
+      }
+      return len;
+    }
+  } // end namespace common
+} // end namespace oceanbase
@@ -0,0 +1,120 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_server_load.h for the query load of chunkserver reported
+ * to rootserver by heartbeat.
+ *
+ */
+#ifndef OCEANBASE_COMMON_OB_SERVER_LOAD_H_
+#define OCEANBASE_COMMON_OB_SERVER_LOAD_H_
+
+#include "ob_define.h"
+#include "serialization.h"
+#include "ob_range2.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    /// query load of one table on a chunkserver, all are rates per second
+    struct ObTableLoad
+    {
+      uint64_t table_id_;
+      int64_t get_qps_;
+      int64_t scan_qps_;
+      int64_t scan_bytes_;
+
+      ObTableLoad()
+        : table_id_(OB_INVALID_ID), get_qps_(0), scan_qps_(0), scan_bytes_(0)
+      {
+      }
+      int64_t get_qps() const
+      {
+        return get_qps_ + scan_qps_;
+      }
+    };
+
+    /**
+     * query load of one tablet on a chunkserver, all are rates per second,
+     * the tablet is identified by table id and the hash of its range
+     */
+    struct ObTabletLoad
+    {
+      uint64_t table_id_;
+      uint64_t range_hash_;
+      int64_t get_qps_;
+      int64_t scan_qps_;
+      int64_t scan_bytes_;
+
+      ObTabletLoad()
+        : table_id_(OB_INVALID_ID), range_hash_(0), get_qps_(0), scan_qps_(0), scan_bytes_(0)
+      {
+      }
+      int64_t get_qps() const
+      {
+        return get_qps_ + scan_qps_;
+      }
+      /// same on chunkserver and rootserver for the same range
+      static uint64_t get_range_hash(const ObNewRange &range);
+    };
+
+    /**
+     * query load of the hottest tables and tablets on a chunkserver,
+     * the tables not in the list are regarded as no load, the load of a
+     * table not taken by its listed tablets is shared by its other tablets
+     */
+    class ObServerLoad
+    {
+      public:
+        static const int64_t MAX_TABLE_LOAD_COUNT = 64;
+        static const int64_t MAX_TABLET_LOAD_COUNT = 64;
+
+      public:
+        ObServerLoad();
+        void reset();
+
+        /// @return OB_SIZE_OVERFLOW if there are MAX_TABLE_LOAD_COUNT tables already
+        int add_table_load(const ObTableLoad &load);
+        /// @return NULL if the table has no load
+        const ObTableLoad *get_table_load(const uint64_t table_id) const;
+        int64_t get_table_count() const
+        {
+          return table_count_;
+        }
+        const ObTableLoad &at(const int64_t index) const
+        {
+          return tables_[index];
+        }
+
+        /// @return OB_SIZE_OVERFLOW if there are MAX_TABLET_LOAD_COUNT tablets already
+        int add_tablet_load(const ObTabletLoad &load);
+        /// @return NULL if the tablet is not one of the hottest
+        const ObTabletLoad *get_tablet_load(const uint64_t table_id, const uint64_t range_hash) const;
+        int64_t get_tablet_count() const
+        {
+          return tablet_count_;
+        }
+        const ObTabletLoad &tablet_at(const int64_t index) const
+        {
+          return tablets_[index];
+        }
+
+        /// the tablets are appended after the tables, old rootservers ignore them
+        NEED_SERIALIZE_AND_DESERIALIZE;
+
+      private:
+        int64_t table_count_;
+        ObTableLoad tables_[MAX_TABLE_LOAD_COUNT];
+        int64_t tablet_count_;
+        ObTabletLoad tablets_[MAX_TABLET_LOAD_COUNT];
+    };
+  } // end namespace common
+} // end namespace oceanbase
+
+#endif //OCEANBASE_COMMON_OB_SERVER_LOAD_H_
@@ -131,25 +131,14 @@ namespace oceanbase
     class ObHandyAllocatorWrapper: public Allocator
     {
       public:
-        ObHandyAllocatorWrapper(): allocated_(0) {}
+        ObHandyAllocatorWrapper() {}
         ~ObHandyAllocatorWrapper() {}
-      private:
-        volatile int64_t allocated_;
       public:
-        int64_t get_alloc_size() const { return allocated_; }
+        // 由Allocator自己统计, 避免多线程分配时在同一个计数器上竞争
+        int64_t get_alloc_size() const { return Allocator::get_alloc_size(); }
         void* alloc(const int64_t size)
         {
-          int err = OB_SUCCESS;
-          void* p = NULL;
-          if (NULL == (p = Allocator::alloc(size)))
-          {
-            err = OB_MEM_OVERFLOW;
-          }
-          else
-          {
-            __sync_fetch_and_add(&allocated_, size);
-          }
-          return p;
+          return Allocator::alloc(size);
         }
         template<typename T>
         T* new_obj()
@@ -574,11 +574,16 @@ namespace oceanbase
       int err = OB_SUCCESS;
       SeqLockGuard guard(seq_);
       AllocatorNode* node = NULL;
-      if (NULL == (node = (AllocatorNode*)inst_allocator_.alloc(sizeof(*node))))
+      void* buf = NULL;
+      if (NULL == (buf = inst_allocator_.alloc(sizeof(*node) + CACHE_ALIGN_SIZE)))
       {
         err = OB_MEM_OVERFLOW;
         TBSYS_LOG(ERROR, "alloc inst node failed.");
       }
+      else if (NULL == (node = (AllocatorNode*)upper_align((int64_t)buf, CACHE_ALIGN_SIZE)))
+      {
+        err = OB_ERR_UNEXPECTED;
+      }
       else if (NULL == (allocator = new(&node->allocator_)StackAllocator()))
       {
         err = OB_ERR_UNEXPECTED;
@@ -599,5 +604,15 @@ namespace oceanbase
     {
       return container_.get();
     }
+
+    int64_t TSIStackAllocator::get_alloc_size() const
+    {
+      int64_t size = 0;
+      for (const AllocatorNode* node = head_; NULL != node; node = node->next_)
+      {
+        size += node->allocator_.get_alloc_size();
+      }
+      return size;
+    }
   }; // end namespace common
 }; // end namespace oceanbase
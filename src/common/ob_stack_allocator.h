@@ -63,6 +63,7 @@ namespace oceanbase
         void set_mod_id(int32_t mod_id) {allocator_->set_mod_id(mod_id);};
         int start_batch_alloc();
         int end_batch_alloc(const bool rollback);
+        int64_t get_alloc_size() const { return top_; }
       protected:
         int set_reserved_block(Block* block);
         int reserve_block(const int64_t size);
@@ -153,11 +154,12 @@ namespace oceanbase
     class TSIStackAllocator
     {
       public:
+        // 每个线程的StackAllocator在每次alloc时都会修改, 按cache line对齐避免线程间的false sharing
         struct AllocatorNode
         {
           AllocatorNode* next_;
           StackAllocator allocator_;
-        };
+        } CACHE_ALIGNED;
         struct BatchAllocGuard
         {
           BatchAllocGuard(TSIStackAllocator& allocator, int& err): allocator_(allocator), err_(err)
@@ -189,6 +191,8 @@ namespace oceanbase
         int end_batch_alloc(const bool rollback);
         int new_instance(StackAllocator*& allocator);
         StackAllocator* get();
+        // 所有线程已分配的内存之和, 不加锁, 只用于统计
+        int64_t get_alloc_size() const;
       private:
         volatile uint64_t seq_;
         int64_t block_size_;
@@ -309,7 +309,15 @@ namespace oceanbase
       }
       for (mod = 0; ret == OB_SUCCESS && mod < OB_MAX_MOD_NUMBER; mod++)
       {
-        ret = serialization::decode_vi32(buf, data_len, tmp_pos, &size);
+        if (tmp_pos == data_len)
+        {
+          // stats from an old server have no mods added later
+          size = 0;
+        }
+        else
+        {
+          ret = serialization::decode_vi32(buf, data_len, tmp_pos, &size);
+        }
         if (OB_SUCCESS == ret)
         {
           for (int64_t i = 0; i < size; i++)
@@ -29,6 +29,7 @@ namespace oceanbase
       OB_STAT_OBMYSQL = 5, // obmysql
       OB_STAT_COMMON = 6, // common
       OB_STAT_SSTABLE = 7, // sstable
+      OB_STAT_MEMTABLE = 8, // ups memtable
       OB_MAX_MOD_NUMBER, // max 
     };
 
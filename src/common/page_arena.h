@@ -604,6 +604,8 @@ namespace oceanbase
         virtual void *alloc(const int64_t sz) {return arena_.alloc(sz);};
         virtual void free(void *ptr) {arena_.free(reinterpret_cast<char*>(ptr));};
         void reuse() {arena_.reuse();};
+        int64_t used() const {return arena_.used();};
+        int64_t total() const {return arena_.total();};
         virtual void set_mod_id(int32_t mod_id) {UNUSED(mod_id);};
       private:
         ModuleArena arena_;
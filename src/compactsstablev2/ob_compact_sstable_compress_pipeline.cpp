@@ -0,0 +1,276 @@
+#include <errno.h>
+#include "ob_compact_sstable_compress_pipeline.h"
+
+using namespace oceanbase::common;
+
+namespace oceanbase
+{
+  namespace compactsstablev2
+  {
+    ObCompactSSTableCompressPipeline::ObCompactSSTableCompressPipeline()
+      : slot_num_(MAX_SLOT_NUM), head_(0), compress_pos_(0), tail_(0),
+        thread_num_(0), stop_(false)
+    {
+      pthread_mutex_init(&mutex_, NULL);
+      pthread_cond_init(&cond_, NULL);
+    }
+
+    ObCompactSSTableCompressPipeline::~ObCompactSSTableCompressPipeline()
+    {
+      destroy();
+      pthread_cond_destroy(&cond_);
+      pthread_mutex_destroy(&mutex_);
+    }
+
+    int ObCompactSSTableCompressPipeline::init(const int64_t thread_num)
+    {
+      int ret = OB_SUCCESS;
+
+      if (thread_num < 0 || thread_num > MAX_THREAD_NUM)
+      {
+        TBSYS_LOG(WARN, "invalid compress thread num:thread_num=%ld,"
+            "max=%ld", thread_num, MAX_THREAD_NUM);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (thread_num != thread_num_)
+      {
+        destroy();
+        stop_ = false;
+        slot_num_ = (0 == thread_num) ? MAX_SLOT_NUM : thread_num * 2;
+
+        for (int64_t i = 0; i < thread_num; i ++)
+        {
+          if (0 != pthread_create(&threads_[i], NULL, thread_func, this))
+          {
+            TBSYS_LOG(ERROR, "create compress thread error:i=%ld,"
+                "errno=%d", i, errno);
+            ret = OB_ERROR;
+            break;
+          }
+          thread_num_ ++;
+        }
+
+        if (OB_SUCCESS != ret)
+        {
+          destroy();
+        }
+        else
+        {
+          TBSYS_LOG(INFO, "start %ld sstable block compress threads",
+              thread_num_);
+        }
+      }
+
+      return ret;
+    }
+
+    void ObCompactSSTableCompressPipeline::destroy()
+    {
+      abort();
+
+      pthread_mutex_lock(&mutex_);
+      stop_ = true;
+      pthread_cond_broadcast(&cond_);
+      pthread_mutex_unlock(&mutex_);
+
+      for (int64_t i = 0; i < thread_num_; i ++)
+      {
+        pthread_join(threads_[i], NULL);
+      }
+      thread_num_ = 0;
+    }
+
+    void ObCompactSSTableCompressPipeline::abort()
+    {
+      pthread_mutex_lock(&mutex_);
+      //the slots in [head_, taken_pos) may be compressing, wait them;
+      //the others will not be taken by the threads any more
+      const int64_t taken_pos = compress_pos_;
+      compress_pos_ = tail_;
+      for (int64_t i = head_; i < taken_pos; i ++)
+      {
+        while (!slots_[i % slot_num_].done_)
+        {
+          pthread_cond_wait(&cond_, &mutex_);
+        }
+      }
+      pthread_mutex_unlock(&mutex_);
+
+      for (int64_t i = 0; i < slot_num_; i ++)
+      {
+        slots_[i].reuse();
+      }
+      head_ = 0;
+      compress_pos_ = 0;
+      tail_ = 0;
+    }
+
+    int ObCompactSSTableCompressPipeline::add_rowkey(const uint64_t table_id,
+        const ObRowkey& rowkey)
+    {
+      int ret = OB_SUCCESS;
+      ObCompactSSTableCompressSlot& slot = slots_[tail_ % slot_num_];
+      ObRowkey copy_rowkey;
+
+      if (is_full())
+      {
+        TBSYS_LOG(WARN, "compress pipeline is full:head_=%ld,tail_=%ld",
+            head_, tail_);
+        ret = OB_ERR_UNEXPECTED;
+      }
+      else if (OB_SUCCESS != (ret = rowkey.deep_copy(copy_rowkey,
+              slot.rowkey_allocator_)))
+      {
+        TBSYS_LOG(WARN, "rowkey deep copy error:ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = slot.rowkey_list_.push_back(copy_rowkey)))
+      {
+        TBSYS_LOG(WARN, "rowkey list push back error:ret=%d", ret);
+      }
+      else
+      {
+        slot.table_id_ = table_id;
+      }
+
+      return ret;
+    }
+
+    int ObCompactSSTableCompressPipeline::submit(const char* buf,
+        const int64_t len, const ObRowkey& endkey, ObCompressor* compressor)
+    {
+      int ret = OB_SUCCESS;
+      ObCompactSSTableCompressSlot& slot = slots_[tail_ % slot_num_];
+      ObMemBufAllocatorWrapper allocator(slot.endkey_buf_);
+      const int64_t comp_buf_size = (NULL == compressor) ? 0
+        : len + compressor->get_max_overflow_size(len);
+
+      if (!is_inited() || NULL == compressor || NULL == buf || len <= 0)
+      {
+        TBSYS_LOG(WARN, "invalid argument:thread_num_=%ld,compressor=%p,"
+            "buf=%p,len=%ld", thread_num_, compressor, buf, len);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (is_full())
+      {
+        TBSYS_LOG(WARN, "compress pipeline is full:head_=%ld,tail_=%ld",
+            head_, tail_);
+        ret = OB_ERR_UNEXPECTED;
+      }
+      else if (OB_SUCCESS != (ret = slot.uncomp_buf_.ensure_space(len,
+              ObModIds::OB_SSTABLE_WRITER)))
+      {
+        TBSYS_LOG(WARN, "ensure uncomp buf error:ret=%d,len=%ld", ret, len);
+      }
+      else if (OB_SUCCESS != (ret = slot.comp_buf_.ensure_space(
+              comp_buf_size, ObModIds::OB_SSTABLE_WRITER)))
+      {
+        TBSYS_LOG(WARN, "ensure comp buf error:ret=%d,comp_buf_size=%ld",
+            ret, comp_buf_size);
+      }
+      else if (OB_SUCCESS != (ret = endkey.deep_copy(slot.endkey_,
+              allocator)))
+      {
+        TBSYS_LOG(WARN, "endkey deep copy error:ret=%d", ret);
+      }
+      else
+      {
+        memcpy(slot.uncomp_buf_.get_buffer(), buf, len);
+        slot.uncomp_data_len_ = len;
+        slot.comp_buf_size_ = comp_buf_size;
+        slot.compressor_ = compressor;
+
+        pthread_mutex_lock(&mutex_);
+        tail_ ++;
+        pthread_cond_broadcast(&cond_);
+        pthread_mutex_unlock(&mutex_);
+      }
+
+      return ret;
+    }
+
+    int ObCompactSSTableCompressPipeline::get_head(
+        ObCompactSSTableCompressSlot*& slot, const bool wait)
+    {
+      int ret = OB_SUCCESS;
+      slot = NULL;
+
+      if (is_empty())
+      {
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else
+      {
+        ObCompactSSTableCompressSlot& head = slots_[head_ % slot_num_];
+
+        pthread_mutex_lock(&mutex_);
+        while (wait && !head.done_)
+        {
+          pthread_cond_wait(&cond_, &mutex_);
+        }
+        if (head.done_)
+        {
+          slot = &head;
+        }
+        else
+        {
+          ret = OB_EAGAIN;
+        }
+        pthread_mutex_unlock(&mutex_);
+      }
+
+      return ret;
+    }
+
+    void ObCompactSSTableCompressPipeline::pop_head()
+    {
+      if (!is_empty())
+      {
+        slots_[head_ % slot_num_].reuse();
+        head_ ++;
+      }
+    }
+
+    void* ObCompactSSTableCompressPipeline::thread_func(void* arg)
+    {
+      ObCompactSSTableCompressPipeline* pipeline
+        = reinterpret_cast<ObCompactSSTableCompressPipeline*>(arg);
+      if (NULL != pipeline)
+      {
+        pipeline->run();
+      }
+      return NULL;
+    }
+
+    void ObCompactSSTableCompressPipeline::run()
+    {
+      ObCompactSSTableCompressSlot* slot = NULL;
+
+      pthread_mutex_lock(&mutex_);
+      while (!stop_)
+      {
+        if (compress_pos_ < tail_)
+        {
+          slot = &slots_[compress_pos_ % slot_num_];
+          compress_pos_ ++;
+          pthread_mutex_unlock(&mutex_);
+
+          slot->compress();
+          if (OB_SUCCESS != slot->ret_)
+          {
+            TBSYS_LOG(WARN, "compress block error:ret=%d,uncomp_len=%ld",
+                slot->ret_, slot->uncomp_data_len_);
+          }
+
+          pthread_mutex_lock(&mutex_);
+          slot->done_ = true;
+          pthread_cond_broadcast(&cond_);
+        }
+        else
+        {
+          pthread_cond_wait(&cond_, &mutex_);
+        }
+      }
+      pthread_mutex_unlock(&mutex_);
+    }
+  }//end namespace compactsstablev2
+}//end namespace oceanbase
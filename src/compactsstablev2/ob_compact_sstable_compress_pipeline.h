@@ -0,0 +1,188 @@
+#ifndef OCEANBASE_COMPACTSSTABLEV2_OB_COMPACT_SSTABLE_COMPRESS_PIPELINE_H_
+#define OCEANBASE_COMPACTSSTABLEV2_OB_COMPACT_SSTABLE_COMPRESS_PIPELINE_H_
+
+#include <pthread.h>
+#include <tbsys.h>
+#include "common/ob_define.h"
+#include "common/ob_malloc.h"
+#include "common/ob_array.h"
+#include "common/page_arena.h"
+#include "common/ob_rowkey.h"
+#include "common/compress/ob_compressor.h"
+
+namespace oceanbase
+{
+  namespace compactsstablev2
+  {
+    /**
+     * one block in the compress pipeline
+     * --the uncompressed block data and its endkey
+     * --the rowkeys of the block, the row count and bloomfilter of the
+     *   sstable are updated with them when the block is written
+     */
+    struct ObCompactSSTableCompressSlot
+    {
+      common::ObMemBuf uncomp_buf_;
+      int64_t uncomp_data_len_;
+      common::ObMemBuf comp_buf_;
+      int64_t comp_buf_size_;
+      int64_t comp_data_len_;
+      ObCompressor* compressor_;
+      common::ObRowkey endkey_;
+      common::ObMemBuf endkey_buf_;
+      uint64_t table_id_;
+      common::ObArray<common::ObRowkey> rowkey_list_;
+      common::ObArenaAllocator rowkey_allocator_;
+      int ret_;
+      bool done_;
+
+      ObCompactSSTableCompressSlot()
+        : uncomp_data_len_(0), comp_buf_size_(0), comp_data_len_(0),
+          compressor_(NULL), table_id_(common::OB_INVALID_ID),
+          rowkey_allocator_(common::ObModIds::OB_SSTABLE_WRITER),
+          ret_(common::OB_SUCCESS), done_(false)
+      {
+      }
+
+      inline void reuse()
+      {
+        uncomp_data_len_ = 0;
+        comp_buf_size_ = 0;
+        comp_data_len_ = 0;
+        compressor_ = NULL;
+        endkey_.assign(NULL, 0);
+        table_id_ = common::OB_INVALID_ID;
+        rowkey_list_.clear();
+        rowkey_allocator_.reuse();
+        ret_ = common::OB_SUCCESS;
+        done_ = false;
+      }
+
+      inline void compress()
+      {
+        ret_ = compressor_->compress(uncomp_buf_.get_buffer(),
+            uncomp_data_len_, comp_buf_.get_buffer(), comp_buf_size_,
+            comp_data_len_);
+      }
+    };
+
+    /**
+     * compress the blocks of ObCompactSSTableWriter in background threads
+     * --the writer builds the block and submits it, then goes on building
+     *   the next block while the former blocks are compressed
+     * --the blocks are taken back strictly in submit order, so the writer
+     *   writes the file, the block index and the bloomfilter exactly as
+     *   the synchronous path does
+     * --slots_[tail_ % slot_num_] is the building slot which collects the
+     *   rowkeys of the current block
+     */
+    class ObCompactSSTableCompressPipeline
+    {
+    public:
+      static const int64_t MAX_THREAD_NUM = 16;
+      static const int64_t MAX_SLOT_NUM = MAX_THREAD_NUM * 2;
+
+    public:
+      ObCompactSSTableCompressPipeline();
+      ~ObCompactSSTableCompressPipeline();
+
+      /**
+       * start the compress threads
+       * @param thread_num: compress thread count, 0 means no pipeline
+       */
+      int init(const int64_t thread_num);
+
+      /**
+       * discard the blocks in pipeline and stop the threads
+       */
+      void destroy();
+
+      /**
+       * wait the blocks in compressing, then discard all the blocks
+       */
+      void abort();
+
+      inline bool is_inited() const
+      {
+        return thread_num_ > 0;
+      }
+
+      inline int64_t get_thread_num() const
+      {
+        return thread_num_;
+      }
+
+      /**
+       * no slot for the next block, the head must be taken back first
+       */
+      inline bool is_full() const
+      {
+        return tail_ - head_ >= slot_num_;
+      }
+
+      inline bool is_empty() const
+      {
+        return tail_ == head_;
+      }
+
+      /**
+       * record the rowkey of the row added into the current block
+       */
+      int add_rowkey(const uint64_t table_id, const common::ObRowkey& rowkey);
+
+      /**
+       * copy the current block into the building slot and hand it to
+       * the compress threads
+       * @param buf: uncompressed block data
+       * @param len: block data length
+       * @param endkey: the last rowkey of the block
+       * @param compressor: compressor, must be thread safe
+       */
+      int submit(const char* buf, const int64_t len,
+          const common::ObRowkey& endkey, ObCompressor* compressor);
+
+      /**
+       * get the oldest submitted block
+       * @param slot: the head slot
+       * @param wait: true(wait until the head is compressed)
+       * @return OB_SUCCESS(head is compressed), OB_EAGAIN(not compressed
+       *         and wait is false), OB_ENTRY_NOT_EXIST(pipeline empty)
+       */
+      int get_head(ObCompactSSTableCompressSlot*& slot, const bool wait);
+
+      /**
+       * release the head slot after it is written
+       */
+      void pop_head();
+
+      /**
+       * the endkey of the last submitted block
+       */
+      inline const common::ObRowkey& get_last_endkey() const
+      {
+        return slots_[(tail_ - 1) % slot_num_].endkey_;
+      }
+
+    private:
+      static void* thread_func(void* arg);
+      void run();
+
+    private:
+      DISALLOW_COPY_AND_ASSIGN(ObCompactSSTableCompressPipeline);
+
+      ObCompactSSTableCompressSlot slots_[MAX_SLOT_NUM];
+      int64_t slot_num_;
+      //head_ <= compress_pos_ <= tail_
+      int64_t head_;
+      int64_t compress_pos_;
+      int64_t tail_;
+
+      pthread_t threads_[MAX_THREAD_NUM];
+      int64_t thread_num_;
+      bool stop_;
+      pthread_mutex_t mutex_;
+      pthread_cond_t cond_;
+    };
+  }//end namespace compactsstablev2
+}//end namespace oceanbase
+#endif
@@ -0,0 +1,217 @@
+#include "ob_compact_sstable_raw_block_reader.h"
+#include "ob_sstable_store_struct.h"
+
+using namespace oceanbase::common;
+
+namespace oceanbase
+{
+  namespace compactsstablev2
+  {
+    ObCompactSSTableRawBlockReader::ObCompactSSTableRawBlockReader()
+      : sstable_reader_(NULL), fileinfo_cache_(NULL),
+        table_id_(OB_INVALID_ID), bloomfilter_(NULL), block_index_(NULL),
+        endkey_allocator_(ObModIds::OB_SSTABLE_READER)
+    {
+    }
+
+    ObCompactSSTableRawBlockReader::~ObCompactSSTableRawBlockReader()
+    {
+    }
+
+    int ObCompactSSTableRawBlockReader::init(
+        ObCompactSSTableReader& sstable_reader, const uint64_t table_id,
+        ObSSTableBlockIndexCache& block_index_cache,
+        IFileInfoMgr& fileinfo_cache)
+    {
+      int ret = OB_SUCCESS;
+      const ObSSTableTableIndex* table_index = NULL;
+      ObBlockIndexPositionInfo info;
+
+      reset();
+      if (NULL == (table_index = sstable_reader.get_table_index(table_id)))
+      {
+        TBSYS_LOG(WARN, "table index is NULL:table_id=%lu", table_id);
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else
+      {
+        info.sstable_file_id_ = sstable_reader.get_sstable_id();
+        info.index_offset_ = table_index->block_index_offset_;
+        info.index_size_ = table_index->block_index_size_;
+        info.endkey_offset_ = table_index->block_endkey_offset_;
+        info.endkey_size_ = table_index->block_endkey_size_;
+        info.block_count_ = table_index->block_count_;
+
+        if (OB_SUCCESS != (ret = block_index_cache.get_block_index(
+                info, table_id, block_index_buf_, block_index_)))
+        {
+          TBSYS_LOG(WARN, "get block index error:ret=%d,info=%s,"
+              "table_id=%lu", ret, to_cstring(info), table_id);
+        }
+        else
+        {
+          sstable_reader_ = &sstable_reader;
+          fileinfo_cache_ = &fileinfo_cache;
+          table_id_ = table_id;
+          bloomfilter_ = sstable_reader.get_table_bloomfilter(table_id);
+        }
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        if (OB_SUCCESS != (ret = load_block_endkeys()))
+        {
+          TBSYS_LOG(WARN, "load block endkeys error:ret=%d", ret);
+        }
+      }
+
+      if (OB_SUCCESS != ret)
+      {
+        reset();
+      }
+
+      return ret;
+    }
+
+    void ObCompactSSTableRawBlockReader::reset()
+    {
+      sstable_reader_ = NULL;
+      fileinfo_cache_ = NULL;
+      table_id_ = OB_INVALID_ID;
+      bloomfilter_ = NULL;
+      block_index_ = NULL;
+      endkey_list_.clear();
+      endkey_allocator_.reuse();
+    }
+
+    int ObCompactSSTableRawBlockReader::read_block(const int64_t index,
+        ObRecordHeaderV2& header, const char*& payload, int64_t& row_count)
+    {
+      int ret = OB_SUCCESS;
+      ObBlockPositionInfo pos_info;
+      const char* record_buf = NULL;
+      int64_t payload_size = 0;
+
+      if (!is_inited())
+      {
+        TBSYS_LOG(WARN, "raw block reader is not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (OB_SUCCESS != (ret = block_index_->get_block_position_info(
+              index, pos_info)))
+      {
+        TBSYS_LOG(WARN, "get block position info error:ret=%d,index=%ld",
+            ret, index);
+      }
+      else if (OB_SUCCESS != (ret = ObFileReader::read_record(
+              *fileinfo_cache_, sstable_reader_->get_sstable_id(),
+              pos_info.offset_, pos_info.size_, file_buf_)))
+      {
+        TBSYS_LOG(WARN, "read record error:ret=%d,offset=%ld,size=%ld",
+            ret, pos_info.offset_, pos_info.size_);
+      }
+      else
+      {
+        record_buf = file_buf_.get_buffer() + file_buf_.get_base_pos();
+        if (OB_SUCCESS != (ret = ObRecordHeaderV2::check_record(record_buf,
+                pos_info.size_, OB_SSTABLE_BLOCK_DATA_MAGIC, header,
+                payload, payload_size)))
+        {
+          TBSYS_LOG(WARN, "check record error:ret=%d,offset=%ld,size=%ld",
+              ret, pos_info.offset_, pos_info.size_);
+        }
+        else if (OB_SUCCESS != (ret = get_block_row_count(header, payload,
+                row_count)))
+        {
+          TBSYS_LOG(WARN, "get block row count error:ret=%d,index=%ld",
+              ret, index);
+        }
+      }
+
+      return ret;
+    }
+
+    int ObCompactSSTableRawBlockReader::load_block_endkeys()
+    {
+      int ret = OB_SUCCESS;
+      ObObj rowkey_buf_array[OB_MAX_ROWKEY_COLUMN_NUMBER];
+      ObRowkey endkey;
+      ObRowkey copy_endkey;
+      const int64_t block_count = block_index_->get_block_count();
+
+      for (int64_t i = 0; OB_SUCCESS == ret && i < block_count; i ++)
+      {
+        if (OB_SUCCESS != (ret = block_index_->get_block_endkey(i,
+                rowkey_buf_array, endkey)))
+        {
+          TBSYS_LOG(WARN, "get block endkey error:ret=%d,i=%ld", ret, i);
+        }
+        else if (OB_SUCCESS != (ret = endkey.deep_copy(copy_endkey,
+                endkey_allocator_)))
+        {
+          TBSYS_LOG(WARN, "endkey deep copy error:ret=%d,endkey=%s",
+              ret, to_cstring(endkey));
+        }
+        else if (OB_SUCCESS != (ret = endkey_list_.push_back(copy_endkey)))
+        {
+          TBSYS_LOG(WARN, "endkey list push back error:ret=%d", ret);
+        }
+      }
+
+      return ret;
+    }
+
+    int ObCompactSSTableRawBlockReader::get_block_row_count(
+        const ObRecordHeaderV2& header, const char* payload,
+        int64_t& row_count)
+    {
+      int ret = OB_SUCCESS;
+      const char* block_buf = payload;
+      int64_t block_len = header.data_zlength_;
+      ObCompressor* decompressor = NULL;
+
+      if (header.is_compress())
+      {
+        if (NULL == (decompressor = sstable_reader_->get_decompressor()))
+        {
+          TBSYS_LOG(WARN, "get decompressor error");
+          ret = OB_ERROR;
+        }
+        else if (OB_SUCCESS != (ret = uncomp_buf_.ensure_space(
+                header.data_length_, ObModIds::OB_SSTABLE_READER)))
+        {
+          TBSYS_LOG(WARN, "ensure space error:ret=%d,data_length_=%ld",
+              ret, header.data_length_);
+        }
+        else if (OB_SUCCESS != (ret = decompressor->decompress(payload,
+                header.data_zlength_, uncomp_buf_.get_buffer(),
+                header.data_length_, block_len)))
+        {
+          TBSYS_LOG(WARN, "decompress error:ret=%d,data_zlength_=%ld,"
+              "data_length_=%ld", ret, header.data_zlength_,
+              header.data_length_);
+        }
+        else
+        {
+          block_buf = uncomp_buf_.get_buffer();
+        }
+      }
+
+      if (OB_SUCCESS != ret)
+      {
+      }
+      else if (block_len < static_cast<int64_t>(sizeof(ObSSTableBlockHeader)))
+      {
+        TBSYS_LOG(WARN, "block is too small:block_len=%ld", block_len);
+        ret = OB_ERROR;
+      }
+      else
+      {
+        row_count = reinterpret_cast<const ObSSTableBlockHeader*>(
+            block_buf)->row_count_;
+      }
+
+      return ret;
+    }
+  }//end namespace compactsstablev2
+}//end namespace oceanbase
@@ -0,0 +1,110 @@
+#ifndef OCEANBASE_COMPACTSSTABLEV2_OB_COMPACT_SSTABLE_RAW_BLOCK_READER_H_
+#define OCEANBASE_COMPACTSSTABLEV2_OB_COMPACT_SSTABLE_RAW_BLOCK_READER_H_
+
+#include <tbsys.h>
+#include "common/ob_define.h"
+#include "common/ob_malloc.h"
+#include "common/ob_array.h"
+#include "common/page_arena.h"
+#include "common/ob_file.h"
+#include "common/ob_fileinfo_manager.h"
+#include "common/ob_rowkey.h"
+#include "common/ob_bloomfilter.h"
+#include "common/ob_record_header_v2.h"
+#include "ob_compact_sstable_reader.h"
+#include "ob_sstable_block_index_mgr.h"
+#include "ob_sstable_block_index_cache.h"
+
+namespace oceanbase
+{
+  namespace compactsstablev2
+  {
+    /**
+     * read the blocks of one table in the sstable as records
+     * --the daily merge copies the blocks without incremental data into
+     *   the new sstable with ObCompactSSTableWriter::append_block()
+     * --the blocks are read from the file directly, the block cache is
+     *   not polluted by the merge
+     * --the block is decompressed only for the row count in the block
+     *   header, the rows are not decoded
+     */
+    class ObCompactSSTableRawBlockReader
+    {
+    public:
+      ObCompactSSTableRawBlockReader();
+      ~ObCompactSSTableRawBlockReader();
+
+      /**
+       * load the block index and the block endkeys of the table
+       * @param sstable_reader: the sstable
+       * @param table_id: table id
+       * @param block_index_cache: block index cache
+       * @param fileinfo_cache: file info cache of the sstable file
+       */
+      int init(ObCompactSSTableReader& sstable_reader,
+          const uint64_t table_id,
+          ObSSTableBlockIndexCache& block_index_cache,
+          common::IFileInfoMgr& fileinfo_cache);
+
+      void reset();
+
+      inline bool is_inited() const
+      {
+        return NULL != block_index_;
+      }
+
+      inline int64_t get_block_count() const
+      {
+        return endkey_list_.count();
+      }
+
+      /**
+       * the endkey of the block
+       * @param index: block sequence, [0, get_block_count())
+       */
+      inline const common::ObRowkey& get_block_endkey(
+          const int64_t index) const
+      {
+        return endkey_list_.at(index);
+      }
+
+      /**
+       * the table bloomfilter of the sstable
+       */
+      inline const common::TableBloomFilter* get_bloomfilter() const
+      {
+        return bloomfilter_;
+      }
+
+      /**
+       * read the record of the block and check its checksum
+       * @param index: block sequence, [0, get_block_count())
+       * @param header: record header of the block
+       * @param payload: block data, valid until the next read
+       * @param row_count: row count of the block
+       */
+      int read_block(const int64_t index, common::ObRecordHeaderV2& header,
+          const char*& payload, int64_t& row_count);
+
+    private:
+      int load_block_endkeys();
+      int get_block_row_count(const common::ObRecordHeaderV2& header,
+          const char* payload, int64_t& row_count);
+
+    private:
+      DISALLOW_COPY_AND_ASSIGN(ObCompactSSTableRawBlockReader);
+
+      ObCompactSSTableReader* sstable_reader_;
+      common::IFileInfoMgr* fileinfo_cache_;
+      uint64_t table_id_;
+      const common::TableBloomFilter* bloomfilter_;
+      common::ObMemBuf block_index_buf_;
+      const ObSSTableBlockIndexMgr* block_index_;
+      common::ObArray<common::ObRowkey> endkey_list_;
+      common::ObArenaAllocator endkey_allocator_;
+      common::ObFileBuffer file_buf_;
+      common::ObMemBuf uncomp_buf_;
+    };
+  }//end namespace compactsstablev2
+}//end namespace oceanbase
+#endif
@@ -180,7 +180,7 @@ namespace oceanbase
 
       if (NULL == compressor_ && strlen(compressor_name) > 0)
       {
-        compressor_ = create_compressor(compressor_name);
+        compressor_ = create_decompressor(compressor_name);
         if (NULL == compressor_)
         {
           TBSYS_LOG(WARN, "create compressor error:NULL==compressor_");
@@ -518,6 +518,7 @@ namespace oceanbase
         if (NULL == tmp_buf)
         {
           TBSYS_LOG(WARN, "failed to alloce memory for arena");
+          ret = OB_ALLOCATE_MEMORY_FAILED;
         }
         else
         {
@@ -545,11 +546,17 @@ namespace oceanbase
 
       if (OB_SUCCESS == ret)
       {
-        ObSSTableTableIndex* table_index_ptr
-          = const_cast<ObSSTableTableIndex*>(table_index);
+        const ObSSTableTableIndex* table_index_ptr = table_index;
         TableBloomFilter* bloom_filter_ptr = result_bloomfilter;
-        for (int64_t i = 0; i < table_count; i ++)
+        for (int64_t i = 0; i < table_count;
+            i ++, table_index_ptr ++, bloom_filter_ptr ++)
         {
+          if (ObSSTableTableIndex::TABLE_INDEX_VERSION_NO_BLOOMFILTER
+              >= table_index_ptr->version_)
+          {//old sstable, leave the bloom filter uninited
+            continue;
+          }
+
           record_offset = table_index_ptr->bloom_filter_offset_;
           record_size = table_index_ptr->bloom_filter_size_;
           if (OB_SUCCESS != (ret = read_record(file_info,
@@ -558,41 +565,37 @@ namespace oceanbase
             TBSYS_LOG(WARN, "read record error:ret=%d", ret);
             break;
           }
+          else if (OB_SUCCESS != (ret = ObRecordHeaderV2::check_record(
+                  record_buf, record_size,
+                  OB_SSTABLE_TABLE_BLOOMFILTER_MAGIC, record_header,
+                  payload_ptr, payload_size)))
+          {
+            TBSYS_LOG(WARN, "check record error:ret=%d", ret);
+            break;
+          }
+          else if (record_header.is_compress())
+          {
+            TBSYS_LOG(WARN, "bloomfilter record should not be compressed");
+            ret = OB_ERROR;
+            break;
+          }
+          else if (OB_SUCCESS != (ret = bloom_filter_ptr->init(
+                  table_index_ptr->bloom_filter_hash_count_,
+                  payload_size)))
+          {
+            TBSYS_LOG(WARN, "bloomfilter init error:ret=%d", ret);
+            break;
+          }
+          else if (OB_SUCCESS != (ret = bloom_filter_ptr->reinit(
+                  reinterpret_cast<const uint8_t*>(payload_ptr),
+                  payload_size)))
+          {
+            TBSYS_LOG(WARN, "bloomfilter reinit error:ret=%d", ret);
+            break;
+          }
           else
           {
-            ret = ObRecordHeaderV2::check_record(record_buf, record_size,
-                OB_SSTABLE_TABLE_BLOOMFILTER_MAGIC, record_header,
-                payload_ptr, payload_size);
-            if (OB_SUCCESS == ret)
-            {
-              if (!record_header.is_compress())
-              {
-                if (OB_SUCCESS != (ret = bloom_filter_ptr->init(
-                    table_index_ptr->bloom_filter_hash_count_,
-                    payload_size)))
-                {
-                  TBSYS_LOG(WARN, "bloomfilter init error:ret=%d", ret);
-                  break;
-                }
-
-                if (OB_SUCCESS == ret)
-                {
-                  const uint8_t* tmp_ptr
-                    = reinterpret_cast<const uint8_t*>(payload_ptr);
-                  if (OB_SUCCESS != (ret = bloom_filter_ptr->reinit(tmp_ptr,
-                          payload_size)))
-                  {
-                    TBSYS_LOG(WARN, "bloomfilter reinit error:ret=%d", ret);
-                    break;
-                  }
-                }
-              }
-              else
-              {
-                TBSYS_LOG(WARN, "check record error:ret=%d", ret);
-                break;
-              }
-            }
+            enable_bloomfilter_ = true;
           }
         }
       }
@@ -601,6 +604,13 @@ namespace oceanbase
       {
         bloom_filter = result_bloomfilter;
       }
+      else if (NULL != result_bloomfilter)
+      {
+        for (int64_t i = 0; i < table_count; i ++)
+        {
+          result_bloomfilter[i].~TableBloomFilter();
+        }
+      }
 
       return ret;
     }
@@ -227,6 +227,24 @@ namespace oceanbase
         return bloom_filter;
       }
 
+      /**
+       * check by the table bloom filter if the table may contain the rowkey,
+       * always true if the sstable is written without bloom filter
+       */
+      inline bool may_contain(const uint64_t table_id,
+          const common::ObRowkey& rowkey) const
+      {
+        bool ret = true;
+        const common::TableBloomFilter* bloom_filter = NULL;
+        if (enable_bloomfilter_
+            && NULL != (bloom_filter = get_table_bloomfilter(table_id))
+            && 0 < bloom_filter->get_nbyte())
+        {
+          ret = bloom_filter->contain(table_id, rowkey);
+        }
+        return ret;
+      }
+
       ObCompressor* get_decompressor();
 
     private:
@@ -169,6 +169,12 @@ namespace oceanbase
         {
           TBSYS_LOG(WARN, "finish the current block error:ret=%d", ret);
         }
+        else if (use_compress_pipeline()
+            && OB_SUCCESS != (ret = write_compressed_blocks(true,
+                is_sstable_split)))
+        {
+          TBSYS_LOG(WARN, "write compressed blocks error:ret=%d", ret);
+        }
         else if (OB_SUCCESS != (ret = table_.add_table_bloomfilter(
                 sstable_writer_buffer_.get_list_bloomfilter())))
         {
@@ -357,13 +363,24 @@ namespace oceanbase
             not_table_first_row_ = true;
           }
 
-          //add list row count
-          sstable_writer_buffer_.inc_list_row_count();
-
-          //update bloom filter
-          if (OB_SUCCESS != (ret = sstable_writer_buffer_.update_list_bloomfilter(sstable_.get_table_id(), row_key)))
+          if (use_compress_pipeline())
+          {//row count and bloom filter are updated when the block is written
+            if (OB_SUCCESS != (ret = compress_pipeline_.add_rowkey(
+                    sstable_.get_table_id(), row_key)))
+            {
+              TBSYS_LOG(WARN, "compress pipeline add rowkey error:ret=%d", ret);
+            }
+          }
+          else
           {
-            TBSYS_LOG(WARN, "update list bloom filter error:ret=%d", ret);
+            //add list row count
+            sstable_writer_buffer_.inc_list_row_count();
+
+            //update bloom filter
+            if (OB_SUCCESS != (ret = sstable_writer_buffer_.update_list_bloomfilter(sstable_.get_table_id(), row_key)))
+            {
+              TBSYS_LOG(WARN, "update list bloom filter error:ret=%d", ret);
+            }
           }
         }
       }
@@ -468,16 +485,154 @@ namespace oceanbase
             not_table_first_row_ = true;
           }
 
-          //add list row count
-          sstable_writer_buffer_.inc_list_row_count();
+          if (use_compress_pipeline())
+          {//row count and bloom filter are updated when the block is written
+            const ObRowkey* rowkey = NULL;
+            if (OB_SUCCESS != (ret = row.get_rowkey(rowkey)))
+            {
+              TBSYS_LOG(WARN, "row get rowkey error:ret=%d,row=%s",
+                  ret, to_cstring(row));
+            }
+            else if (OB_SUCCESS != (ret = compress_pipeline_.add_rowkey(
+                    sstable_.get_table_id(), *rowkey)))
+            {
+              TBSYS_LOG(WARN, "compress pipeline add rowkey error:ret=%d", ret);
+            }
+          }
+          else
+          {
+            //add list row count
+            sstable_writer_buffer_.inc_list_row_count();
+
+            //update bloom filter
+            if (OB_SUCCESS != (ret = sstable_writer_buffer_.update_list_bloomfilter(sstable_.get_table_id(), row)))
+            {
+              TBSYS_LOG(WARN, "update list bloom filter error:ret=%d", ret);
+            }
+          }
+        }
+      }
+
+      return ret;
+    }
+
+    int ObCompactSSTableWriter::set_compress_thread_num(
+        const int64_t thread_num)
+    {
+      int ret = OB_SUCCESS;
+
+      if (!compress_pipeline_.is_empty())
+      {
+        TBSYS_LOG(WARN, "can not change compress thread num while writing:"
+            "thread_num=%ld", thread_num);
+        ret = OB_ERROR;
+      }
+      else if (OB_SUCCESS != (ret = compress_pipeline_.init(thread_num)))
+      {
+        TBSYS_LOG(WARN, "init compress pipeline error:ret=%d,"
+            "thread_num=%ld", ret, thread_num);
+      }
+
+      return ret;
+    }
+
+    int ObCompactSSTableWriter::flush(bool& is_sstable_split)
+    {
+      int ret = OB_SUCCESS;
+      is_sstable_split = false;
+
+      if (OB_SUCCESS != (ret = finish_current_block(is_sstable_split)))
+      {
+        TBSYS_LOG(WARN, "finish current block error:ret=%d", ret);
+      }
+      else if (!is_sstable_split && use_compress_pipeline())
+      {
+        if (OB_SUCCESS != (ret = write_compressed_blocks(true,
+                is_sstable_split)))
+        {
+          TBSYS_LOG(WARN, "write compressed blocks error:ret=%d", ret);
+        }
+      }
+
+      return ret;
+    }
+
+    int ObCompactSSTableWriter::append_block(const ObRecordHeaderV2& header,
+        const char* payload, const ObRowkey& endkey,
+        const int64_t row_count, const TableBloomFilter& bloomfilter,
+        bool& is_sstable_split)
+    {
+      int ret = OB_SUCCESS;
+      is_sstable_split = false;
+
+      if (!sstable_inited_ || !table_inited_ || !sstable_file_inited_)
+      {
+        TBSYS_LOG(WARN, "sstable has not been inited:sstable_inited_=%d,"
+            "table_inited_=%d,sstable_file_inited_=%d", sstable_inited_,
+            table_inited_, sstable_file_inited_);
+        ret = OB_NOT_INIT;
+      }
+      else if (NULL == payload || row_count <= 0 || header.data_zlength_ <= 0
+          || OB_SSTABLE_BLOCK_DATA_MAGIC != header.magic_)
+      {
+        TBSYS_LOG(WARN, "invalid argument:payload=%p,row_count=%ld,"
+            "data_zlength_=%ld,magic_=%d", payload, row_count,
+            header.data_zlength_, header.magic_);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (0 != block_.get_row_count() || !compress_pipeline_.is_empty())
+      {
+        TBSYS_LOG(WARN, "the writer must be flushed before append block:"
+            "row_count=%d", block_.get_row_count());
+        ret = OB_ERR_UNEXPECTED;
+      }
+      else if (!table_.check_rowkey_range(endkey, not_table_first_row_))
+      {
+        TBSYS_LOG(WARN, "check rowkey range error:endkey=%s,"
+            "not_table_first_row_=%d", to_cstring(endkey),
+            not_table_first_row_);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (not_table_first_row_
+          && OB_SUCCESS != (ret = sstable_writer_buffer_.check_rowkey(endkey)))
+      {
+        TBSYS_LOG(WARN, "sstable writer buffer check row error:"
+            "ret=%d,endkey=%s", ret, to_cstring(endkey));
+      }
+      else if (OB_SUCCESS != (ret = sstable_writer_buffer_.set_record_buf(
+              header, payload)))
+      {
+        TBSYS_LOG(WARN, "set record buf error:ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = sstable_writer_buffer_.set_cur_key(endkey)))
+      {
+        TBSYS_LOG(WARN, "set cur key error:ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = sstable_writer_buffer_.merge_list_bloomfilter(
+              bloomfilter)))
+      {
+        TBSYS_LOG(WARN, "merge list bloomfilter error:ret=%d", ret);
+      }
+      else
+      {
+        not_table_first_row_ = true;
+        sstable_writer_buffer_.add_list_row_count(row_count);
 
-#ifdef OB_COMPACT_SSTABLE_ALLOW_BLOOMFILTER_
-          //update bloom filter
-          if (OB_SUCCESS != (ret = sstable_writer_buffer_.update_list_bloomfilter(sstable_.get_table_id(), row)))
+        if (split_flag_)
+        {//allow split
+          if (OB_SUCCESS != (ret = finish_current_block_split(
+                  is_sstable_split)))
           {
-            TBSYS_LOG(WARN, "update list bloom filter error:ret=%d", ret);
+            TBSYS_LOG(WARN, "finish current block split error:ret=%d", ret);
+          }
+        }
+        else
+        {//don not allow split
+          if (OB_SUCCESS != (ret = finish_current_block_nosplit()))
+          {
+            TBSYS_LOG(WARN, "finish current block nosplit error:"
+                "ret=%d", ret);
           }
-#endif
         }
       }
 
@@ -493,6 +648,20 @@ namespace oceanbase
       {
         TBSYS_LOG(WARN, "finish current block error:ret=%d", ret);
       }
+
+      //the split of the last blocks is ignored as the synchronous path
+      while (OB_SUCCESS == ret && !compress_pipeline_.is_empty())
+      {
+        if (OB_SUCCESS != (ret = write_compressed_blocks(true,
+                is_sstable_split)))
+        {
+          TBSYS_LOG(WARN, "write compressed blocks error:ret=%d", ret);
+        }
+      }
+
+      if (OB_SUCCESS != ret)
+      {
+      }
       else if (!sstable_writer_buffer_.mem_block_list_empty())
       {//mem list is not empty
         if (OB_SUCCESS != (ret = flush_mem_block_list()))
@@ -563,6 +732,8 @@ namespace oceanbase
       sstable_first_table_ = false;
       not_table_first_row_ = false;
 
+      //the compress threads may be using compressor_
+      compress_pipeline_.abort();
       if (NULL != compressor_)
       {
         destroy_compressor(compressor_);
@@ -645,8 +816,15 @@ namespace oceanbase
 
       if (OB_SUCCESS == ret)
       {
-        table_.add_table_bloomfilter(sstable_writer_buffer_.get_list_bloomfilter());
-        sstable_writer_buffer_.reset_list_bloomfilter();
+        if (OB_SUCCESS != (ret = table_.add_table_bloomfilter(
+                sstable_writer_buffer_.get_list_bloomfilter())))
+        {
+          TBSYS_LOG(WARN, "add table bloomfilter error:ret=%d", ret);
+        }
+        else
+        {
+          sstable_writer_buffer_.reset_list_bloomfilter();
+        }
       }
 
       if (OB_SUCCESS == ret)
@@ -677,13 +855,24 @@ namespace oceanbase
         {
           TBSYS_LOG(WARN, "build block error:ret=%d", ret);
         }
+        else if (use_compress_pipeline())
+        {//compress in background, write the blocks compressed before
+          if (OB_SUCCESS != (ret = compress_pipeline_.submit(buf_ptr,
+                  data_len, sstable_writer_buffer_.get_cur_key(),
+                  compressor_)))
+          {
+            TBSYS_LOG(WARN, "compress pipeline submit error:ret=%d", ret);
+          }
+          else if (OB_SUCCESS != (ret = write_compressed_blocks(false,
+                  is_sstable_split)))
+          {
+            TBSYS_LOG(WARN, "write compressed blocks error:ret=%d", ret);
+          }
+        }
         else
         {
           sstable_writer_buffer_.set_uncomp_buf(buf_ptr, data_len);
-        }
 
-        if (OB_SUCCESS == ret)
-        {
           if (OB_SUCCESS != (ret = sstable_writer_buffer_.compress(
                   compressor_)))
           {//compress
@@ -693,24 +882,24 @@ namespace oceanbase
           {//select data
             sstable_writer_buffer_.select_buf();
           }
-        }
 
-        if (OB_SUCCESS == ret)
-        {
-          if (split_flag_)
-          {//allow split
-            if (OB_SUCCESS != (ret = finish_current_block_split(
-                    is_sstable_split)))
-            {
-              TBSYS_LOG(WARN, "finish current block split error:ret=%d", ret);
+          if (OB_SUCCESS == ret)
+          {
+            if (split_flag_)
+            {//allow split
+              if (OB_SUCCESS != (ret = finish_current_block_split(
+                      is_sstable_split)))
+              {
+                TBSYS_LOG(WARN, "finish current block split error:ret=%d", ret);
+              }
             }
-          }
-          else
-          {//don not allow split
-            if (OB_SUCCESS != (ret = finish_current_block_nosplit()))
-            {
-              TBSYS_LOG(WARN, "finish current block nosplit error:"
-                  "ret=%d", ret);
+            else
+            {//don not allow split
+              if (OB_SUCCESS != (ret = finish_current_block_nosplit()))
+              {
+                TBSYS_LOG(WARN, "finish current block nosplit error:"
+                    "ret=%d", ret);
+              }
             }
           }
         }
@@ -722,6 +911,108 @@ namespace oceanbase
       return ret;
     }
 
+    int ObCompactSSTableWriter::write_compressed_blocks(const bool wait_all,
+        bool& is_sstable_split)
+    {
+      int ret = OB_SUCCESS;
+      int tmp_ret = OB_SUCCESS;
+      is_sstable_split = false;
+      ObCompactSSTableCompressSlot* slot = NULL;
+
+      while (OB_SUCCESS == ret && !is_sstable_split)
+      {
+        //the rows of the next block need a free slot
+        const bool wait = wait_all || compress_pipeline_.is_full();
+        if (OB_SUCCESS != (tmp_ret = compress_pipeline_.get_head(slot, wait)))
+        {//empty or the head is in compressing
+          break;
+        }
+        else if (OB_SUCCESS != (ret = write_compressed_block(*slot,
+                is_sstable_split)))
+        {
+          TBSYS_LOG(WARN, "write compressed block error:ret=%d", ret);
+        }
+        else
+        {
+          compress_pipeline_.pop_head();
+        }
+      }
+
+      if (OB_SUCCESS == ret && !compress_pipeline_.is_empty())
+      {//the endkey of the written block is set as cur key, restore it
+        if (OB_SUCCESS != (ret = sstable_writer_buffer_.set_cur_key(
+                compress_pipeline_.get_last_endkey())))
+        {
+          TBSYS_LOG(WARN, "set cur key error:ret=%d", ret);
+        }
+      }
+
+      return ret;
+    }
+
+    int ObCompactSSTableWriter::write_compressed_block(
+        ObCompactSSTableCompressSlot& slot, bool& is_sstable_split)
+    {
+      int ret = OB_SUCCESS;
+      is_sstable_split = false;
+
+      for (int64_t i = 0; OB_SUCCESS == ret
+          && i < slot.rowkey_list_.count(); i ++)
+      {
+        sstable_writer_buffer_.inc_list_row_count();
+        if (OB_SUCCESS != (ret = sstable_writer_buffer_.update_list_bloomfilter(
+                slot.table_id_, slot.rowkey_list_.at(i))))
+        {
+          TBSYS_LOG(WARN, "update list bloom filter error:ret=%d", ret);
+        }
+      }
+
+      if (OB_SUCCESS != ret)
+      {
+      }
+      else if (OB_SUCCESS != (ret = slot.ret_))
+      {
+        TBSYS_LOG(WARN, "compress error:ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = sstable_writer_buffer_.set_comp_buf(
+              slot.comp_buf_.get_buffer(),
+              slot.comp_data_len_)))
+      {
+        TBSYS_LOG(WARN, "set comp buf error:ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = sstable_writer_buffer_.set_cur_key(
+              slot.endkey_)))
+      {
+        TBSYS_LOG(WARN, "set cur key error:ret=%d", ret);
+      }
+      else
+      {
+        sstable_writer_buffer_.set_uncomp_buf(
+            slot.uncomp_buf_.get_buffer(),
+            slot.uncomp_data_len_);
+        sstable_writer_buffer_.select_buf();
+
+        if (split_flag_)
+        {//allow split
+          if (OB_SUCCESS != (ret = finish_current_block_split(
+                  is_sstable_split)))
+          {
+            TBSYS_LOG(WARN, "finish current block split error:ret=%d", ret);
+          }
+        }
+        else
+        {//don not allow split
+          if (OB_SUCCESS != (ret = finish_current_block_nosplit()))
+          {
+            TBSYS_LOG(WARN, "finish current block nosplit error:"
+                "ret=%d", ret);
+          }
+        }
+      }
+
+      return ret;
+    }
+
 
 
     int ObCompactSSTableWriter::finish_current_block_split(
@@ -15,6 +15,7 @@
 #include "ob_sstable_table.h"
 #include "ob_sstable.h"
 #include "ob_compact_sstable_writer_buffer.h"
+#include "ob_compact_sstable_compress_pipeline.h"
 #include "ob_sstable_store_struct.h"
 
 class TestCompactSSTableWriter_construct_Test;
@@ -28,7 +29,6 @@ class TestCompactSSTableWriter_set_sstable_filepath1_Test;
 
 //#define OB_COMPACT_SSTABLE_ALLOW_SCHEMA_CHECK_ROWKEY_
 //#define OB_COMPACT_SSTABLE_ALLOW_TABLE_RANGE_CHECK_ROWKEY_
-//#define OB_COMPACT_SSTABLE_ALLOW_BLOOMFILTER_
 //#define OB_COMPACT_SSTABLE_ALLOW_LAST_CHECK_ROWKEY_
 
 namespace oceanbase
@@ -91,6 +91,8 @@ namespace oceanbase
 
       ~ObCompactSSTableWriter()
       {
+        //the compress threads may be using compressor_
+        compress_pipeline_.destroy();
         if (NULL != compressor_)
         {
           destroy_compressor(compressor_);
@@ -164,6 +166,45 @@ namespace oceanbase
        */
       int append_row(const common::ObRow& row, bool& is_sstable_split);
 
+      /**
+       * set the compress thread count
+       * --0: compress the block in the append thread(default)
+       * --n: compress the blocks in n background threads, the append
+       *      thread goes on building the next block
+       * @param thread_num: compress thread count
+       */
+      int set_compress_thread_num(const int64_t thread_num);
+
+      /**
+       * write out the current block and the blocks being compressed in
+       * background
+       * --the sstable may be split by these blocks, so the caller must
+       *   call flush() until is_sstable_split is false before finish()
+       *   or append_block() when def_sstable_size != 0
+       * @param is_sstable_split: sstable is or not split
+       */
+      int flush(bool& is_sstable_split);
+
+      /**
+       * append a block of another sstable without decoding its rows
+       * --the block must be written with the same schema, row store type
+       *   and compressor, and the writer must be flushed before
+       * --the record is written as it is, the row count and the
+       *   bloomfilter are taken from the arguments
+       * @param header: record header of the block
+       * @param payload: block data, compressed if header.is_compress()
+       * @param endkey: the last rowkey of the block
+       * @param row_count: row count of the block
+       * @param bloomfilter: table bloomfilter which contains the rowkeys
+       *        of the block
+       * @param is_sstable_split: sstable is or not split
+       */
+      int append_block(const common::ObRecordHeaderV2& header,
+          const char* payload, const common::ObRowkey& endkey,
+          const int64_t row_count,
+          const common::TableBloomFilter& bloomfilter,
+          bool& is_sstable_split);
+
       /**
        * finish current sstable
        */
@@ -250,6 +291,32 @@ namespace oceanbase
        */
       int finish_current_block_nosplit();
 
+      /**
+       * the block is compressed by the compress threads or not
+       */
+      inline bool use_compress_pipeline() const
+      {
+        return NULL != compressor_ && compress_pipeline_.is_inited();
+      }
+
+      /**
+       * write the compressed blocks of the pipeline in submit order
+       * @param wait_all: true(wait all the blocks),
+       *                  false(only wait when the pipeline is full)
+       * @param is_sstable_split: sstable is or not split, stop writing
+       *        the blocks when split
+       */
+      int write_compressed_blocks(const bool wait_all,
+          bool& is_sstable_split);
+
+      /**
+       * write one compressed block
+       * @param slot: the compressed block
+       * @param is_sstable_split: sstable is or not split
+       */
+      int write_compressed_block(ObCompactSSTableCompressSlot& slot,
+          bool& is_sstable_split);
+
       /**
        * need switch block(current block is full)
        */
@@ -365,6 +432,9 @@ namespace oceanbase
       ObSSTableTrailerOffset sstable_trailer_offset_;
 
       QueryStruct query_struct_;
+
+      //compress threads
+      ObCompactSSTableCompressPipeline compress_pipeline_;
     };
   }//end namespace compactsstablev2
 }//end namespace oceanbase
@@ -48,6 +48,7 @@ namespace oceanbase
 
       list_bloomfilter_.init(SSTABLE_BLOOMFILTER_HASH_COUNT, 
           SSTABLE_BLOOMFILTER_SIZE);
+      merged_bloomfilter_ = NULL;
       mem_block_list_total_len_  = 0;
       list_row_count_ = 0;
     }
@@ -235,6 +236,53 @@ namespace oceanbase
       return ret;
     }
 
+    int ObCompactSSTableWriterBuffer::set_comp_buf(const char* buf,
+        const int64_t len)
+    {
+      int ret = OB_SUCCESS;
+
+      if (OB_SUCCESS != (ret = ensure_comp_buf(len)))
+      {
+        TBSYS_LOG(WARN, "ensure comp buf error:ret=%d,len=%ld", ret, len);
+      }
+      else
+      {
+        memcpy(comp_buf_ptr_, buf, len);
+        comp_buf_data_len_ = len;
+      }
+
+      return ret;
+    }
+
+    int ObCompactSSTableWriterBuffer::set_record_buf(
+        const ObRecordHeaderV2& header, const char* payload)
+    {
+      int ret = OB_SUCCESS;
+
+      if (header.is_compress())
+      {//the output buf is selected by uncomp_buf_data_len_ > comp_buf_data_len_
+        if (OB_SUCCESS != (ret = set_comp_buf(payload, header.data_zlength_)))
+        {
+          TBSYS_LOG(WARN, "set comp buf error:ret=%d", ret);
+        }
+        else
+        {
+          uncomp_buf_ptr_ = NULL;
+          uncomp_buf_data_len_ = header.data_length_;
+          output_buf_flag_ = true;
+        }
+      }
+      else
+      {
+        uncomp_buf_ptr_ = const_cast<char*>(payload);
+        uncomp_buf_data_len_ = header.data_length_;
+        comp_buf_data_len_ = 0;
+        output_buf_flag_ = false;
+      }
+
+      return ret;
+    }
+
     int ObCompactSSTableWriterBuffer::cur_node_prepare()
     {
       int ret = OB_SUCCESS;
@@ -397,6 +445,29 @@ namespace oceanbase
       return ret;
     }
    
+    int ObCompactSSTableWriterBuffer::merge_list_bloomfilter(
+        const TableBloomFilter& bloomfilter)
+    {
+      int ret = OB_SUCCESS;
+
+      if (&bloomfilter == merged_bloomfilter_)
+      {
+        //merged already
+      }
+      else if (OB_SUCCESS != (ret = (list_bloomfilter_ | bloomfilter)))
+      {
+        TBSYS_LOG(WARN, "merge list bloomfilter error:ret=%d,nbyte=%ld,"
+            "other nbyte=%ld", ret, list_bloomfilter_.get_nbyte(),
+            bloomfilter.get_nbyte());
+      }
+      else
+      {
+        merged_bloomfilter_ = &bloomfilter;
+      }
+
+      return ret;
+    }
+
     void ObCompactSSTableWriterBuffer::update_record_header(
         const int16_t magic)
     {
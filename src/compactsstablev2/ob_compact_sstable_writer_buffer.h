@@ -171,6 +171,22 @@ namespace oceanbase
 
       int ensure_comp_buf(const int64_t buf_size);
 
+      /**
+       * copy the block compressed outside into comp buf
+       * @param buf: compressed data
+       * @param len: compressed data length
+       */
+      int set_comp_buf(const char* buf, const int64_t len);
+
+      /**
+       * load a block record of another sstable as the output buf,
+       * update_record_header() rebuilds the same record header
+       * @param header: record header of the block
+       * @param payload: block data, compressed if header.is_compress()
+       */
+      int set_record_buf(const common::ObRecordHeaderV2& header,
+          const char* payload);
+
       inline void select_buf()
       {
         if (0 == comp_buf_data_len_)
@@ -256,6 +272,11 @@ namespace oceanbase
         list_row_count_ ++;
       }
 
+      inline void add_list_row_count(const int64_t row_count)
+      {
+        list_row_count_ += row_count;
+      }
+
       inline const common::TableBloomFilter& get_list_bloomfilter() const
       {
         return list_bloomfilter_;
@@ -269,8 +290,15 @@ namespace oceanbase
       inline void reset_list_bloomfilter()
       {
         list_bloomfilter_.clear();
+        merged_bloomfilter_ = NULL;
       }
 
+      /**
+       * or the bloomfilter into list bloomfilter, the same bloomfilter
+       * is merged only once until the list bloomfilter is reset
+       */
+      int merge_list_bloomfilter(const common::TableBloomFilter& bloomfilter);
+
       int update_list_bloomfilter(uint64_t table_id,
           const common::ObRowkey& row_key);
 
@@ -330,6 +358,7 @@ namespace oceanbase
       int64_t mem_block_list_total_len_;
       int64_t list_row_count_;
       common::TableBloomFilter list_bloomfilter_;
+      const common::TableBloomFilter* merged_bloomfilter_;
     };
 
     inline int ObCompactSSTableWriterBuffer::check_rowkey(
@@ -11,6 +11,12 @@ namespace oceanbase
   {
     using namespace common;
 
+    static ObAIOBackend*& thread_aio_backend()
+    {
+      static __thread ObAIOBackend* backend = NULL;
+      return backend;
+    }
+
     ObAIOBuffer::ObAIOBuffer() 
       : inited_(false), state_(FREE), fd_(-1), 
         sstable_id_(OB_INVALID_ID), fileinfo_cache_(NULL), 
@@ -452,11 +458,12 @@ namespace oceanbase
 
     ObAIOBufferMgr::~ObAIOBufferMgr()
     {
-      io_context_t ctx = get_io_context();
+      ObAIOBackend*& backend = thread_aio_backend();
 
-      if (NULL != ctx)
+      if (NULL != backend)
       {
-        io_destroy(ctx);
+        ObAIOBackend::destroy(backend);
+        backend = NULL;
       }
 
       if (NULL != block_)
@@ -466,22 +473,24 @@ namespace oceanbase
       }
     }
 
-    io_context_t ObAIOBufferMgr::get_io_context()
+    ObAIOBackend* ObAIOBufferMgr::get_aio_backend()
     {
-      static __thread io_context_t ctx = NULL;
-      int64_t max_events = AIO_BUFFER_COUNT * OB_MAX_COLUMN_GROUP_NUMBER;
+      ObAIOBackend*& backend = thread_aio_backend();
+      // a read of an aio buffer has at most queue_depth chunks in flight,
+      // size the events by the configured depth instead of the max one
+      const int64_t queue_depth = ObAIOBackend::get_queue_depth();
+      int64_t max_events = AIO_BUFFER_COUNT * OB_MAX_COLUMN_GROUP_NUMBER * queue_depth;
 
-      if (NULL == ctx)
+      if (NULL == backend)
       {
-        if (0 != io_setup(static_cast<int>(max_events), &ctx))
+        if (NULL == (backend = ObAIOBackend::create(max_events, queue_depth)))
         {
-          TBSYS_LOG(WARN, "failed to setup io context, ctx=%p, error:%s", 
-              ctx, strerror(errno));
-          ctx = NULL;
+          TBSYS_LOG(WARN, "failed to create aio backend, max_events=%ld", 
+              max_events);
         }
       }
 
-      return ctx;
+      return backend;
     }
 
     int ObAIOBufferMgr::init()
@@ -496,7 +505,7 @@ namespace oceanbase
           ret = buffer_[i].init();
           if (OB_SUCCESS == ret)
           {
-            ret = event_mgr_[i].init(get_io_context());
+            ret = event_mgr_[i].init(get_aio_backend());
           }
         }
   
@@ -1986,7 +1995,7 @@ namespace oceanbase
       dataindex_key.offset_ = offset;
       dataindex_key.size_ = nbyte;
 
-      ret = block_cache_->get_kv_cache().put(dataindex_key, value, false);
+      ret = block_cache_->get_kv_cache().put(dataindex_key, value, false, true);
 
       return  ret;
     }
@@ -2113,7 +2122,7 @@ namespace oceanbase
             else
             {
               value.nbyte_ = dataindex_key.size_;
-              status = block_cache_->get_kv_cache().put(dataindex_key, value);
+              status = block_cache_->get_kv_cache().put(dataindex_key, value, true, true);
               if (OB_SUCCESS != status && OB_ENTRY_EXIST != status)
               {
                 TBSYS_LOG(WARN, "failed to copy block data to cache, status=%d", status);
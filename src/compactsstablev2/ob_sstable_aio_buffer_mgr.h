@@ -277,8 +277,8 @@ namespace oceanbase
      * column group has one ObAIOBufferMgr instance. each instance 
      * has two aio buffers, one aio buffer is used to read the 
      * current blocks data, the other aio buffer is used to preread 
-     * the next blocks data. because each thread has one io_context 
-     * instance, and each thread detect the state of io_context 
+     * the next blocks data. because each thread has one aio backend
+     * instance, and each thread detect the state of aio backend 
      * instance, the application get block serially, but we can do 
      * preread parallel. 
      */
@@ -393,7 +393,7 @@ namespace oceanbase
       }
 
       void reset();
-      io_context_t get_io_context();
+      common::ObAIOBackend* get_aio_backend();
       int ensure_block_buf_space(const int64_t size);
       const char* get_state_str(ObDoubleAIOBufferState state) const;
       void set_state(ObDoubleAIOBufferState state);
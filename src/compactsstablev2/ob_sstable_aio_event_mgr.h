@@ -1,7 +1,7 @@
 #ifndef OCEANBASE_COMPACTSSTABLEV2_OB_AIO_EVENT_MGR_H_
 #define OCEANBASE_COMPACTSSTABLEV2_OB_AIO_EVENT_MGR_H_
 
-#include <libaio.h>
+#include "common/ob_aio_backend.h"
 
 namespace oceanbase 
 {
@@ -15,17 +15,26 @@ namespace oceanbase
 
       ~ObAIOEventMgr();
 
-      int init(io_context_t ctx);
+      int init(common::ObAIOBackend* backend);
 
       int aio_submit(const int fd, const int64_t offset, 
           const int64_t size, ObAIOBufferInterface& aio_buf);
 
       int aio_wait(int64_t& timeout_us);
 
+    private:
+      static const int64_t MIN_CHUNK_SIZE = 128 * 1024;
+
+    private:
+      void chunk_finished(const int64_t res);
+
     private:
       bool inited_;
-      io_context_t ctx_;
-      struct iocb iocb_;
+      common::ObAIOBackend* backend_;
+      ObAIOBufferInterface* aio_buf_;
+      int64_t pending_nr_;
+      int64_t read_size_;
+      int ret_code_;
     };
   }//end namespace compactsstablev2
 }//end namespace oceanbase
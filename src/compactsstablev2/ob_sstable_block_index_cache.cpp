@@ -178,6 +178,48 @@ namespace oceanbase
       return ret;
     }
 
+    int ObSSTableBlockIndexCache::get_block_index(
+        const ObBlockIndexPositionInfo& block_index_info,
+        const uint64_t table_id, ObMemBuf& buf,
+        const ObSSTableBlockIndexMgr*& block_index)
+    {
+      int ret = OB_SUCCESS;
+      bool revert_handle = false;
+      ObSSTableBlockIndexMgr cache_block_index;
+      Handle handle;
+      block_index = NULL;
+
+      if (OB_SUCCESS != (ret = check_param(block_index_info, table_id)))
+      {
+        TBSYS_LOG(ERROR, "check param error");
+      }
+      else if (OB_SUCCESS != (ret = load_block_index(block_index_info,
+              cache_block_index, table_id, handle)))
+      {
+        TBSYS_LOG(ERROR, "load block index error");
+      }
+      else
+      {
+        revert_handle = true;
+        if (OB_SUCCESS != (ret = buf.ensure_space(cache_block_index.get_size(),
+                ObModIds::OB_SSTABLE_INDEX)))
+        {
+          TBSYS_LOG(WARN, "ensure space error:ret=%d,size=%ld",
+              ret, cache_block_index.get_size());
+        }
+        else
+        {
+          block_index = cache_block_index.copy(buf.get_buffer());
+        }
+      }
+
+      if (revert_handle && OB_SUCCESS != kv_cache_.revert(handle))
+      {
+        TBSYS_LOG(WARN, "kv cache revert error");
+      }
+
+      return ret;
+    }
 
     int ObSSTableBlockIndexCache::read_index_record(IFileInfoMgr& fileinfo_cache, 
         const uint64_t sstable_id, const int64_t offset, 
@@ -2,6 +2,7 @@
 #define OCEANBASE_COMPACTSSTABLEV2_OB_SSTABLE_BLOCK_INDEX_CACHE_H_
 
 #include "common/ob_define.h"
+#include "common/ob_malloc.h"
 #include "common/ob_kv_storecache.h"
 #include "common/ob_fileinfo_manager.h"
 #include "common/ob_range2.h"
@@ -129,6 +130,15 @@ namespace oceanbase
           const uint64_t table_id, const int64_t cur_offset,
           const SearchMode search_mode, ObBlockPositionInfos& pos_info);
 
+      /**
+       * copy the whole block index of the table out of the cache
+       * @param buf: the buffer which holds the copied block index
+       * @param block_index: the copied block index in buf
+       */
+      int get_block_index(const ObBlockIndexPositionInfo& block_index_info,
+          const uint64_t table_id, common::ObMemBuf& buf,
+          const ObSSTableBlockIndexMgr*& block_index);
+
     private:
       int read_index_record(common::IFileInfoMgr& fileinfo_cache, 
                       const uint64_t sstable_id, 
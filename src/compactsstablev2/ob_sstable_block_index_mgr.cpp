@@ -209,6 +209,62 @@ namespace oceanbase
       return ret;
     }
 
+    int ObSSTableBlockIndexMgr::get_block_position_info(const int64_t index,
+        ObBlockPositionInfo& pos_info) const
+    {
+      int ret = OB_SUCCESS;
+      Bound bound;
+
+      if (index < 0 || index >= block_count_)
+      {
+        TBSYS_LOG(WARN, "invalid block index:index=%ld,block_count_=%ld",
+            index, block_count_);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (ret = get_bound(bound)))
+      {
+        TBSYS_LOG(ERROR, "get bound error");
+      }
+      else
+      {
+        const_iterator it = bound.begin_ + index;
+        pos_info.offset_ = it->block_data_offset_;
+        pos_info.size_ = (it + 1)->block_data_offset_ - it->block_data_offset_;
+      }
+
+      return ret;
+    }
+
+    int ObSSTableBlockIndexMgr::get_block_endkey(const int64_t index,
+        ObObj* rowkey_buf_array, ObRowkey& endkey) const
+    {
+      int ret = OB_SUCCESS;
+      Bound bound;
+
+      if (index < 0 || index >= block_count_)
+      {
+        TBSYS_LOG(WARN, "invalid block index:index=%ld,block_count_=%ld",
+            index, block_count_);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (ret = get_bound(bound)))
+      {
+        TBSYS_LOG(ERROR, "get bound error");
+      }
+      else if (NULL == rowkey_buf_array)
+      {
+        TBSYS_LOG(WARN, "rowkey buf array is NULL");
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (ret = get_row_key(*(bound.begin_ + index),
+              rowkey_buf_array, endkey)))
+      {
+        TBSYS_LOG(WARN, "get row key error:ret=%d,index=%ld", ret, index);
+      }
+
+      return ret;
+    }
+
     ObSSTableBlockIndexMgr* ObSSTableBlockIndexMgr::copy(char* buffer) const
     {
       ObSSTableBlockIndexMgr* ret = reinterpret_cast<ObSSTableBlockIndexMgr*>(buffer);
@@ -406,9 +462,6 @@ namespace oceanbase
         common::ObRowkey& key) const
     {
       int ret = OB_SUCCESS;
-      ObCompactCellIterator row;
-      char* key_ptr = block_endkey_base_ + index.block_endkey_offset_;
-      int rowkey_obj_count = 0;
       ObObj* rowkey_buf_array = NULL;
       common::ModuleArena* arena = GET_TSI_MULT(ModuleArena,
           TSI_SSTABLE_MODULE_ARENA_1);
@@ -418,7 +471,23 @@ namespace oceanbase
       {
         TBSYS_LOG(WARN, "alloc error");
       }
-      else if (OB_SUCCESS != (ret = row.init(key_ptr, DENSE)))
+      else
+      {
+        ret = get_row_key(index, rowkey_buf_array, key);
+      }
+
+      return ret;
+    }
+
+    int ObSSTableBlockIndexMgr::get_row_key(const ObSSTableBlockIndex& index,
+        common::ObObj* rowkey_buf_array, common::ObRowkey& key) const
+    {
+      int ret = OB_SUCCESS;
+      ObCompactCellIterator row;
+      char* key_ptr = block_endkey_base_ + index.block_endkey_offset_;
+      int rowkey_obj_count = 0;
+
+      if (OB_SUCCESS != (ret = row.init(key_ptr, DENSE)))
       {
         TBSYS_LOG(WARN, "row init error");
       }
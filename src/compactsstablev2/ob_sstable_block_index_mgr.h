@@ -212,6 +212,22 @@ namespace oceanbase
       int search_batch_blocks_by_offset(const int64_t offset,
           const SearchMode mode, ObBlockPositionInfos& pos_info) const;
 
+      /**
+       * get the position of the block by its sequence in the table
+       * @param index: block sequence, [0, block_count_)
+       */
+      int get_block_position_info(const int64_t index,
+          ObBlockPositionInfo& pos_info) const;
+
+      /**
+       * get the endkey of the block by its sequence in the table
+       * @param index: block sequence, [0, block_count_)
+       * @param rowkey_buf_array: OB_MAX_ROWKEY_COLUMN_NUMBER objs which
+       *        hold the endkey, the varchar objs refer to the block index
+       */
+      int get_block_endkey(const int64_t index,
+          common::ObObj* rowkey_buf_array, common::ObRowkey& endkey) const;
+
       ObSSTableBlockIndexMgr* copy(char* buffer) const;
 
       inline int64_t get_size() const
@@ -249,6 +265,9 @@ namespace oceanbase
       int get_row_key(const ObSSTableBlockIndex& index, 
           common::ObRowkey& key) const;
 
+      int get_row_key(const ObSSTableBlockIndex& index,
+          common::ObObj* rowkey_buf_array, common::ObRowkey& key) const;
+
       inline int get_bound(Bound& bound) const
       {
         int ret = common::OB_SUCCESS;
@@ -123,6 +123,40 @@ namespace oceanbase
       return def;
     }
 
+    bool ObSSTableSchema::is_same_table_schema(const uint64_t table_id,
+        const ObSSTableSchema& schema) const
+    {
+      bool ret = true;
+      const ObSSTableSchemaColumnDef* def = NULL;
+      const ObSSTableSchemaColumnDef* other_def = NULL;
+      int64_t size = 0;
+      int64_t other_size = 0;
+
+      for (int64_t i = 0; ret && i < 2; i ++)
+      {//rowkey columns and rowvalue columns
+        const bool is_rowkey_column = (0 == i);
+        def = get_table_schema(table_id, is_rowkey_column, size);
+        other_def = schema.get_table_schema(table_id, is_rowkey_column,
+            other_size);
+        if (NULL == def && NULL == other_def)
+        {//no such columns
+        }
+        else if (NULL == def || NULL == other_def || size != other_size)
+        {
+          ret = false;
+        }
+        else
+        {
+          for (int64_t j = 0; ret && j < size; j ++)
+          {
+            ret = (def[j] == other_def[j]);
+          }
+        }
+      }
+
+      return ret;
+    }
+
     bool ObSSTableSchema::is_table_exist(const uint64_t table_id) const
     {
       bool ret = false;
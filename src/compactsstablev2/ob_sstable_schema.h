@@ -65,6 +65,10 @@ namespace oceanbase
         {
           ret = true;
         }
+        else
+        {
+          ret = false;
+        }
 
         return ret;
       }
@@ -214,6 +218,10 @@ namespace oceanbase
       //table exist?
       bool is_table_exist(const uint64_t table_id) const;
 
+      //the columns of the table are same with the other schema?
+      bool is_same_table_schema(const uint64_t table_id,
+          const ObSSTableSchema& schema) const;
+
       //column exist
       bool is_column_exist(const uint64_t table_id,
           const uint64_t column_id) const;
@@ -281,7 +281,9 @@ namespace oceanbase
       int32_t range_end_key_length_;  //range end key
       int64_t reserved_[8];       //reserverd
 
-      static const int32_t TABLE_INDEX_VERSION = 0x20000;
+      //table index of version 0x20000 has an empty bloom filter
+      static const int32_t TABLE_INDEX_VERSION_NO_BLOOMFILTER = 0x20000;
+      static const int32_t TABLE_INDEX_VERSION = 0x20001;
 
       ObSSTableTableIndex()
       {
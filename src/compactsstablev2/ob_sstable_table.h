@@ -100,14 +100,11 @@ namespace oceanbase
           const common::TableBloomFilter& table_bloomfilter)
       {
         int ret = common::OB_SUCCESS;
-        (void)table_bloomfilter;
-#ifdef OB_COMPACT_SSTABLE_ALLOW_BLOOMFILTER_
         if (common::OB_SUCCESS != (ret =
               table_bloomfilter_ | table_bloomfilter))
         {
           TBSYS_LOG(WARN, "failed to use or bloomfilter");
         }
-#endif
         return ret;
       }
 
@@ -6,6 +6,7 @@
 #include "ob_merge_callback.h"
 #include "common/ob_tbnet_callback.h"
 #include "common/utility.h"
+#include "sql/ob_sql_plan_cache.h"
 
 using namespace oceanbase::common;
 
@@ -70,6 +71,8 @@ namespace oceanbase
                                  * sysconf(_SC_PHYS_PAGES)
                                  * sysconf(_SC_PAGE_SIZE) / 100);
         log_interval_count_ = ms_config_.log_interval_count;
+        sql::ObSqlPlanCache::set_config(ms_config_.sql_plan_cache_count,
+                                        ms_config_.sql_plan_cache_mem_limit);
       }
 
       if (OB_SUCCESS == ret)
@@ -73,6 +73,10 @@ namespace oceanbase
         DEF_INT(obmysql_io_thread_count, "4", "[1,]", "obmysql io thread count for libeasy");
         DEF_INT(obmysql_work_thread_count, "50", "[1,]", "obmysql io thread count for doing sql task");
         DEF_CAP(obmysql_task_queue_size, "10000", "[1,]", "obmysql task queue size");
+        DEF_INT(sql_plan_cache_count, "256", "[0,]", "max cached plans of text sql for each session, 0 means disabled");
+        DEF_CAP(sql_plan_cache_mem_limit, "1GB", "[0,]", "max memory of the cached plans of all sessions");
+        DEF_CAP(sql_work_area_size, "256MB", "[0,]", "max memory of each hash group by or hash join operator, rows beyond it are dumped to run files under sql_tmp_dir, 0 means no limit");
+        DEF_STR(sql_tmp_dir, "/tmp", "directory of the run files dumped by sql operators");
     };
   } /* mergeserver */
 } /* oceanbase */
@@ -110,7 +110,6 @@ namespace oceanbase {
     {
       bool bool_val = false;
       int ret = OB_SUCCESS;
-      uint64_t length = 0;
       // MYSQL_TYPE_TINY format
       if (len - pos < 2)
       {
@@ -122,10 +121,8 @@ namespace oceanbase {
         OB_ASSERT(OB_SUCCESS == ret);
         if (TEXT == type_)
         {
-          /* skip 1 byte to store length */
-          length = snprintf(buf + pos + 1, len - pos - 1, "%d", bool_val ? 1 : 0);
-          ObMySQLUtil::store_length(buf, len, length, pos);
-          pos += length;
+          buf[pos++] = 1;
+          buf[pos++] = bool_val ? '1' : '0';
         }
         else if (BINARY == type_)
         {
@@ -153,7 +150,7 @@ namespace oceanbase {
         if (TEXT == type_)
         {
           /* skip 1 byte to store length */
-          length = snprintf(buf + pos + 1, len - pos - 1, "%ld", int_val);
+          length = ObMySQLUtil::int_to_str(int_val, buf + pos + 1);
           ObMySQLUtil::store_length(buf, len, length, pos);
           pos += length;
         }
@@ -196,13 +193,83 @@ namespace oceanbase {
       if (OB_SUCCESS == (ret = obj.get_decimal(num)))
       {
         /* skip 1 byte to store length */
-        length = num.to_string(buf + pos + 1, len - pos - 1);
+        if (len - pos > MAX_SMALL_DECIMAL_STR_LEN
+            && small_decimal_str(num, buf + pos + 1, length))
+        {
+          // do nothing
+        }
+        else
+        {
+          length = num.to_string(buf + pos + 1, len - pos - 1);
+        }
         ObMySQLUtil::store_length(buf, len, length, pos);
         pos += length;
       }
       return ret;
     }
 
+    bool ObMySQLRow::small_decimal_str(const ObNumber &num, char *buf, uint64_t &length) const
+    {
+      // 不超过两个word的decimal可以直接拼成int64，避免ObNumber::to_string逐位做多字除法，
+      // 输出格式与ObNumber::to_string保持一致
+      bool ret = false;
+      const int8_t nwords = num.get_nwords();
+      const int8_t vscale = num.get_vscale();
+      const uint32_t *words = num.get_words();
+      if (0 < nwords && nwords <= 2 && 0 <= vscale && vscale < ObMySQLUtil::MAX_INT_STR_LEN)
+      {
+        int64_t value = 0;
+        if (1 == nwords)
+        {
+          value = static_cast<int32_t>(words[0]);
+        }
+        else
+        {
+          value = static_cast<int64_t>((static_cast<uint64_t>(words[1]) << 32) | words[0]);
+        }
+        if (0 == value)
+        {
+          buf[0] = '0';
+          length = 1;
+        }
+        else
+        {
+          char digits[ObMySQLUtil::MAX_INT_STR_LEN];
+          int64_t pos = 0;
+          const uint64_t abs_value = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+          const int64_t digit_num = ObMySQLUtil::uint_to_str(abs_value, digits);
+          if (value < 0)
+          {
+            buf[pos++] = '-';
+          }
+          if (vscale >= digit_num)
+          {
+            // 0.0...0xxx
+            buf[pos++] = '0';
+            buf[pos++] = '.';
+            memset(buf + pos, '0', vscale - digit_num);
+            pos += vscale - digit_num;
+            memcpy(buf + pos, digits, digit_num);
+            pos += digit_num;
+          }
+          else
+          {
+            memcpy(buf + pos, digits, digit_num - vscale);
+            pos += digit_num - vscale;
+            if (vscale > 0)
+            {
+              buf[pos++] = '.';
+              memcpy(buf + pos, digits + digit_num - vscale, vscale);
+              pos += vscale;
+            }
+          }
+          length = pos;
+        }
+        ret = true;
+      }
+      return ret;
+    }
+
     int ObMySQLRow::datetime_cell_str(const ObObj &obj, char *buf, const int64_t len, int64_t &pos) const
     {
       int64_t datetime;
@@ -428,9 +495,17 @@ namespace oceanbase {
           if (OB_SUCCESS == ret && len - pos > dbl_len)
           {
             /* skip 1 byte to store length */
-            length = static_cast<size_t>(my_gcvt(value_d, MY_GCVT_ARG_DOUBLE,
-                                                 dbl_len - 1, buf + pos + 1,
-                                                 NULL));
+            if (is_small_integral(value_d))
+            {
+              // 整数值的double由my_gcvt输出时也是全部数字，直接走整数路径
+              length = ObMySQLUtil::int_to_str(static_cast<int64_t>(value_d), buf + pos + 1);
+            }
+            else
+            {
+              length = static_cast<size_t>(my_gcvt(value_d, MY_GCVT_ARG_DOUBLE,
+                                                   dbl_len - 1, buf + pos + 1,
+                                                   NULL));
+            }
           }
           else
           {
@@ -15,6 +15,7 @@
 #ifndef _OB_MYSQL_ROW_H_
 #define _OB_MYSQL_ROW_H_
 
+#include <math.h>
 #include "common/ob_row.h"
 #include "common/ob_object.h"
 #include "ob_mysql_util.h"
@@ -104,6 +105,12 @@ namespace oceanbase {
          * @return 成功返回OB_SUCCESS， 失败返回oceanbase error code
          */
         int decimal_cell_str(const ObObj &obj, char *buf, const int64_t len, int64_t &pos) const;
+        /**
+         * 不超过64位的decimal直接按整数转成文本，buf至少要有MAX_SMALL_DECIMAL_STR_LEN个字节
+         *
+         * @return 转换成功返回true，decimal太大时返回false，由ObNumber::to_string处理
+         */
+        bool small_decimal_str(const ObNumber &num, char *buf, uint64_t &length) const;
         /**
          * 序列化一个datetime型的cell到buf + pos的位置。
          * (ObDateTimeType, ObPreciseDateTimeType, ObCreateTimeType, ObModifyTimeType)
@@ -140,6 +147,17 @@ namespace oceanbase {
          * @return 成功返回OB_SUCCESS， 失败返回oceanbase error code
          */
         int float_cell_str(const ObObj &obj, char *buf, const int64_t len, int64_t &pos) const;
+        /// 绝对值小于1e15的整数值，my_gcvt不会用科学计数法输出，可以按整数转换
+        static inline bool is_small_integral(const double v)
+        {
+          return v > -1e15 && v < 1e15
+            && v == static_cast<double>(static_cast<int64_t>(v))
+            && !(0 == v && signbit(v));
+        }
+
+      private:
+        // 符号 + "0." + 最多19个前导0 + 最多20位数字
+        static const int64_t MAX_SMALL_DECIMAL_STR_LEN = 64;
 
       private:
         const common::ObRow *row_;
@@ -16,6 +16,7 @@
 #include "packet/ob_mysql_error_packet.h"
 #include "packet/ob_mysql_spr_packet.h"
 #include "sql/ob_sql_context.h"
+#include "sql/ob_sql_plan_cache.h"
 #include "common/ob_schema_manager.h"
 #include "common/hash/ob_hashutils.h"
 #include "common/ob_privilege.h"
@@ -32,6 +33,15 @@ namespace oceanbase
   namespace obmysql
   {
     __thread uint8_t number = 0;
+    //流式发送结果集: 正在由IO线程发送的buffer以及可以复用的空闲buffer，同一时刻最多一个buffer在发送
+    __thread easy_buf_t *sending_buff = NULL;
+    __thread easy_buf_t *spare_buff = NULL;
+    __thread easy_client_wait_t sending_wait;
+
+    static inline int64_t get_buff_capacity(easy_buf_t *buf)
+    {
+      return buf->end - reinterpret_cast<char *>(buf + 1);
+    }
     ObMySQLServer::ObMySQLServer(): io_thread_count_(1), work_thread_count_(10),
                                     task_queue_size_(100), port_(3100),
                                     stop_(false), eio_(NULL),
@@ -123,6 +133,11 @@ namespace oceanbase
         {
           TBSYS_LOG(ERROR, "set obmysql port=%s failed", config_->obmysql_port.str());
         }
+        else
+        {
+          ObSqlPlanCache::set_config(config_->sql_plan_cache_count,
+                                     config_->sql_plan_cache_mem_limit);
+        }
       }
 
       //init session mgr
@@ -2165,8 +2180,10 @@ namespace oceanbase
       {
         //基于结果集都是很小的假设每次都在message申请6k内存，尽可能的把所有的数据包都放到这个内存里面去
         //如果能够放下那么直接调用异步发送接口 工作线程不用等待IO线程发包
-        //如果发现6k不能放下所有结果，先发送序列化好的包，等待IO线程发送完毕以便复用这个6k的内存
+        //如果发现6k不能放下所有结果，改为流式发送: 序列化好的buffer交给IO线程异步发送，
+        //工作线程换一个64k的buffer继续序列化，见stream_raw_packet
         easy_addr_t addr = get_easy_addr(req);
+        spare_buff = NULL;
         easy_buf_t* buf = reinterpret_cast<easy_buf_t*>(easy_pool_alloc(req->ms->pool, OB_MYSQL_PACKET_BUFF_SIZE));
         if (NULL != buf)
         {
@@ -2193,6 +2210,12 @@ namespace oceanbase
           {
             TBSYS_LOG(WARN, "process row eof packet failed dest is %s ret is %d", inet_ntoa_r(addr), ret);
           }
+          //流式发送时等最后一个buffer发送完才能再唤醒req，出错时也要等，调用者随后会发error包
+          int wret = wait_sending_packet(req);
+          if (OB_SUCCESS == ret)
+          {
+            ret = wret;
+          }
           if (OB_SUCCESS == ret)
           {
             TBSYS_LOG(DEBUG, "send result set to client %s", inet_ntoa_r(addr));
@@ -2228,6 +2251,7 @@ namespace oceanbase
       {
         easy_request_t *req = packet->get_request();
         easy_addr_t addr = get_easy_addr(req);
+        spare_buff = NULL;
         easy_buf_t* buf = reinterpret_cast<easy_buf_t*>(easy_pool_alloc(req->ms->pool, OB_MYSQL_PACKET_BUFF_SIZE));
         if (NULL != buf && NULL != req)
         {
@@ -2267,10 +2291,15 @@ namespace oceanbase
                 }
               }
 
+              int wret = wait_sending_packet(req);
+              if (OB_SUCCESS == ret)
+              {
+                ret = wret;
+              }
               if (OB_SUCCESS == ret)
               {
                 TBSYS_LOG(DEBUG, "send result set to client %s", inet_ntoa_r(addr));
-                buf->last = data_buffer + buffer_pos;
+                buf->last = buf->pos + buffer_pos;
                 req->opacket = reinterpret_cast<void*>(buf);
                 ret = post_raw_packet(req);
                 if (OB_SUCCESS != ret)
@@ -2400,9 +2429,13 @@ namespace oceanbase
         else
         {
           TBSYS_LOG(WARN, "failed to get next field, err=%d", ret);
-          buff->last = buff->pos + buff_pos;
-          req->opacket = reinterpret_cast<void*>(buff);
-          int sret = send_raw_packet(req);
+          int sret = wait_sending_packet(req);
+          if (OB_SUCCESS == sret)
+          {
+            buff->last = buff->pos + buff_pos;
+            req->opacket = reinterpret_cast<void*>(buff);
+            sret = send_raw_packet(req);
+          }
           if (OB_SUCCESS != sret)
           {
             TBSYS_LOG(ERROR, "send raw packet(dest is %s) failed ret is %d", inet_ntoa_r(addr), sret);
@@ -2482,9 +2515,13 @@ namespace oceanbase
           }
           else
           {
-            buff->last = buff->pos + buff_pos;
-            req->opacket = reinterpret_cast<void*>(buff);
-            int sret = send_raw_packet(req);
+            int sret = wait_sending_packet(req);
+            if (OB_SUCCESS == sret)
+            {
+              buff->last = buff->pos + buff_pos;
+              req->opacket = reinterpret_cast<void*>(buff);
+              sret = send_raw_packet(req);
+            }
             if (OB_SUCCESS != sret)
             {
               TBSYS_LOG(ERROR, "send raw packet(dest is %s) failed ret is %d", inet_ntoa_r(addr), sret);
@@ -2525,12 +2562,10 @@ namespace oceanbase
         {
           if (0 != buff_pos) //有数据先发送
           {
-            buff->last = buff->pos + buff_pos;
-            req->opacket = reinterpret_cast<void*>(buff);
-            sret = send_raw_packet(req);
+            sret = stream_raw_packet(buff, buff_pos, req);
             if (OB_SUCCESS != sret)
             {
-              TBSYS_LOG(ERROR, "send raw packet(dest is %s) failed ret is %d", inet_ntoa_r(addr), sret);
+              TBSYS_LOG(ERROR, "stream raw packet(dest is %s) failed ret is %d", inet_ntoa_r(addr), sret);
               if (OB_CONNECT_ERROR == sret)
               {
                 ret = sret;
@@ -2538,9 +2573,7 @@ namespace oceanbase
             }
             else
             {
-              //now we can reuse message buffer
-              buff->pos = buff->pos - buff_pos;//libeasy 发包后会移动buf->pos 移回去
-              buff_pos = 0;
+              //buff已经换成空闲的buffer
               ret = packet->encode(buff->pos, buff->end - buff->pos, buff_pos);
             }
           }
@@ -2549,14 +2582,14 @@ namespace oceanbase
           {
             if (OB_ARRAY_OUT_OF_RANGE == ret || OB_SIZE_OVERFLOW == ret)
             {
-              //buffer size > 6k 表示buffer的大小已经是2M了
-              if (OB_MYSQL_PACKET_BUFF_SIZE < buff->end - buff->pos)
+              //空的buffer都放不下，如果已经是2M的buffer就放弃
+              if (OB_MAX_PACKET_LENGTH - static_cast<int64_t>(sizeof(easy_buf_t)) <= get_buff_capacity(buff))
               {
                 TBSYS_LOG(ERROR, "do not support packet larger than %ld ret is %d", OB_MAX_PACKET_LENGTH, ret);
               }
               else
               {
-                TBSYS_LOG(WARN, "packet size is larger than 6k, try alloc 2M buffer");
+                TBSYS_LOG(WARN, "packet size is larger than %ld, try alloc 2M buffer", get_buff_capacity(buff));
                 //alloc a 2m buffer
                 buff = reinterpret_cast<easy_buf_t*>(easy_pool_alloc(req->ms->pool, OB_MAX_PACKET_LENGTH));
                 if (NULL != buff)
@@ -2592,6 +2625,17 @@ namespace oceanbase
     }
 
     int ObMySQLServer::send_raw_packet(easy_request_t *req)
+    {
+      int ret = OB_SUCCESS;
+      easy_client_wait_t wait_obj;
+      if (OB_SUCCESS == (ret = start_raw_packet(req, wait_obj)))
+      {
+        ret = wait_raw_packet(req, wait_obj);
+      }
+      return ret;
+    }
+
+    int ObMySQLServer::start_raw_packet(easy_request_t *req, easy_client_wait_t &wait_obj)
     {
       int ret = OB_SUCCESS;
       if (NULL == req)
@@ -2601,29 +2645,88 @@ namespace oceanbase
       }
       else
       {
-
         easy_buf_t *buf = static_cast<easy_buf_t*>(req->opacket);
         if (NULL != buf)
         {
           OB_STAT_INC(OBMYSQL, SQL_QUERY_BYTES, buf->last - buf->pos);
         }
-        easy_client_wait_t wait_obj;
         wait_obj.done_count = 0;
         easy_client_wait_init(&wait_obj);
         req->client_wait = &wait_obj;
         req->retcode = EASY_AGAIN;
         //io线程被唤醒，r->opacket被挂过去,send_response->easy_connection_request_done
         easy_request_wakeup(req);
-        // IO线程回调 int ObMySQLCallback::process(easy_request_t* r)的时候唤醒工作线程
-        wait_client_obj(wait_obj);
-        //return OB_CONNECT_ERROR if status eq EASY_CONN_CLOSE
-        if (EASY_CONN_CLOSE == wait_obj.status)
+      }
+      return ret;
+    }
+
+    int ObMySQLServer::wait_raw_packet(easy_request_t *req, easy_client_wait_t &wait_obj)
+    {
+      int ret = OB_SUCCESS;
+      // IO线程回调 int ObMySQLCallback::process(easy_request_t* r)的时候唤醒工作线程
+      wait_client_obj(wait_obj);
+      //return OB_CONNECT_ERROR if status eq EASY_CONN_CLOSE
+      if (EASY_CONN_CLOSE == wait_obj.status)
+      {
+        TBSYS_LOG(WARN, "send error happen, quit current query");
+        ret = OB_CONNECT_ERROR;
+      }
+      easy_client_wait_cleanup(&wait_obj);
+      req->client_wait = NULL;
+      return ret;
+    }
+
+    int ObMySQLServer::wait_sending_packet(easy_request_t *req)
+    {
+      int ret = OB_SUCCESS;
+      if (NULL != sending_buff)
+      {
+        ret = wait_raw_packet(req, sending_wait);
+        spare_buff = sending_buff;
+        sending_buff = NULL;
+      }
+      return ret;
+    }
+
+    int ObMySQLServer::stream_raw_packet(easy_buf_t *&buff, int64_t &buff_pos, easy_request_t *req)
+    {
+      int ret = OB_SUCCESS;
+      easy_buf_t *next = NULL;
+      //上一个buffer发送完之前不能再唤醒req，这里等待IO线程也起到了反压的作用
+      if (OB_SUCCESS != (ret = wait_sending_packet(req)))
+      {
+        TBSYS_LOG(WARN, "wait sending packet failed ret is %d", ret);
+      }
+      else
+      {
+        //先准备好下一个buffer再发送，分配失败时buff仍然可用
+        if (NULL != spare_buff && OB_MYSQL_STREAM_BUFF_SIZE - static_cast<int64_t>(sizeof(easy_buf_t)) <= get_buff_capacity(spare_buff))
+        {
+          next = spare_buff;
+          spare_buff = NULL;
+          init_easy_buf(next, reinterpret_cast<char *>(next + 1), req, get_buff_capacity(next));
+        }
+        else if (NULL != (next = reinterpret_cast<easy_buf_t*>(easy_pool_alloc(req->ms->pool, OB_MYSQL_STREAM_BUFF_SIZE))))
+        {
+          init_easy_buf(next, reinterpret_cast<char *>(next + 1), req,
+                        OB_MYSQL_STREAM_BUFF_SIZE - sizeof(easy_buf_t));
+        }
+        else
+        {
+          TBSYS_LOG(ERROR, "alloc stream buffer from req->ms->pool failed");
+          ret = OB_ALLOCATE_MEMORY_FAILED;
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        buff->last = buff->pos + buff_pos;
+        req->opacket = reinterpret_cast<void*>(buff);
+        if (OB_SUCCESS == (ret = start_raw_packet(req, sending_wait)))
         {
-          TBSYS_LOG(WARN, "send error happen, quit current query");
-          ret = OB_CONNECT_ERROR;
+          sending_buff = buff;
+          buff = next;
+          buff_pos = 0;
         }
-        easy_client_wait_cleanup(&wait_obj);
-        req->client_wait = NULL;
       }
       return ret;
     }
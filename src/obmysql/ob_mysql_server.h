@@ -379,6 +379,34 @@ namespace oceanbase
          */
         int send_raw_packet(easy_request_t *req);
 
+        /**
+         * 唤醒IO线程发送req->opacket，不等待发送完成
+         * 发送完成之前不能再唤醒req，需要调用wait_raw_packet等待
+         * @param    req       request pointer
+         * @param    wait_obj  IO线程发送完毕后唤醒的对象
+         */
+        int start_raw_packet(easy_request_t *req, easy_client_wait_t &wait_obj);
+        int wait_raw_packet(easy_request_t *req, easy_client_wait_t &wait_obj);
+
+        /**
+         * 流式发送结果集时，把buff交给IO线程异步发送，buff换成另一个空闲的buffer继续序列化
+         * 同一时刻最多一个buffer在发送，发送下一个之前先等上一个发送完，
+         * 工作线程序列化和IO线程发包可以并行，大结果集的内存占用也有上限
+         * @param    buff      [in/out] 已经序列化好的buffer，成功后换成空闲的buffer
+         * @param    buff_pos  [in/out] buffer中数据的长度，成功后为0
+         * @param    req       request pointer
+         *
+         * @return   int       OB_SUCCESS if successful
+         *                     OB_CONNECT_ERROR if connection closed
+         */
+        int stream_raw_packet(easy_buf_t *&buff, int64_t &buff_pos, easy_request_t *req);
+
+        /**
+         * 等待stream_raw_packet发出的buffer发送完毕，没有正在发送的buffer时直接返回
+         * 设置req->opacket再次唤醒req之前必须先调用
+         */
+        int wait_sending_packet(easy_request_t *req);
+
         /**
          * 异步发送已经链接到req->output上的数据
          * 包全部序列化到libeasy message的buffer里
@@ -401,7 +429,7 @@ namespace oceanbase
         /**
          * Send field/params packets as response
          * This method will try to serialize all rows into one packet
-         * if there are no space to store one row any more, call send_raw_packet, then resue message buffer
+         * if there are no space to store one row any more, call stream_raw_packet, then continue with a spare buffer
          * @param buff
          * @param req         request pointer
          * @param result      sql result set
@@ -417,7 +445,7 @@ namespace oceanbase
         /**
          * 处理结果集中的单个数据包
          * 把包序列化到指定的buff中去 如果buff不够的
-         * 先把之前的包拷贝到线程buffer中等待发送完，再重用buffer把包序列化
+         * 先把之前的包交给IO线程发送(stream_raw_packet)，再换一个空闲的buffer把包序列化
          * @param buff               buff pointer
          * @param req                req pointer
          * @param packet             待发送的数据包
@@ -24,6 +24,60 @@ namespace oceanbase
                                    /* ObMaxType */
     };
 
+    static const char DIGITS_PAIRS[201] =
+      "00010203040506070809"
+      "10111213141516171819"
+      "20212223242526272829"
+      "30313233343536373839"
+      "40414243444546474849"
+      "50515253545556575859"
+      "60616263646566676869"
+      "70717273747576777879"
+      "80818283848586878889"
+      "90919293949596979899";
+
+    int64_t ObMySQLUtil::uint_to_str(uint64_t v, char *buf)
+    {
+      char tmp[MAX_INT_STR_LEN];
+      char *end = tmp + MAX_INT_STR_LEN;
+      char *p = end;
+      while (v >= 100)
+      {
+        const uint64_t idx = (v % 100) * 2;
+        v /= 100;
+        *--p = DIGITS_PAIRS[idx + 1];
+        *--p = DIGITS_PAIRS[idx];
+      }
+      if (v >= 10)
+      {
+        *--p = DIGITS_PAIRS[v * 2 + 1];
+        *--p = DIGITS_PAIRS[v * 2];
+      }
+      else
+      {
+        *--p = static_cast<char>('0' + v);
+      }
+      const int64_t length = end - p;
+      memcpy(buf, p, length);
+      return length;
+    }
+
+    int64_t ObMySQLUtil::int_to_str(int64_t v, char *buf)
+    {
+      int64_t length = 0;
+      if (v < 0)
+      {
+        buf[0] = '-';
+        // INT64_MIN取反会溢出，转成无符号数再取反
+        length = 1 + uint_to_str(0 - static_cast<uint64_t>(v), buf + 1);
+      }
+      else
+      {
+        length = uint_to_str(static_cast<uint64_t>(v), buf);
+      }
+      return length;
+    }
+
     //TODO avoid coredump if field_index is too large
     //http://dev.mysql.com/doc/internals/en/prepared-statements.html#null-bitmap
     //offset is 2
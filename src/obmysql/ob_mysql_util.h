@@ -183,6 +183,16 @@ namespace oceanbase
          * @return OB_SUCCESS or oceanbase error code.
          */
         static int store_obstr_nzt(char *buf, int64_t len, ObString str, int64_t &pos);
+        /**
+         * 把整数以十进制文本写到buf，不写结尾的'\0'，调用者保证buf至少有
+         * MAX_INT_STR_LEN个字节。按两位一组查表，比snprintf("%ld")快
+         *
+         * @return 写入的字节数
+         */
+        static int64_t int_to_str(int64_t v, char *buf);
+        static int64_t uint_to_str(uint64_t v, char *buf);
+        static const int64_t MAX_INT_STR_LEN = 20;
+
 //@{ 序列化整型数据，将v中的数据存到buf+pos的位置，并更新pos
         static inline int store_int1(char *buf, int64_t len, int8_t v, int64_t &pos);
         static inline int store_int2(char *buf, int64_t len, int16_t v, int64_t &pos);
@@ -0,0 +1,333 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_balance_simulator.cpp
+ * replay the root table, the chunkserver list and a snapshot of the
+ * query load offline, print the migrate plan of the load based balance
+ * and the load of each chunkserver before and after the plan.
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "common/ob_malloc.h"
+#include "common/ob_crc64.h"
+#include "ob_root_table2.h"
+#include "ob_chunk_server_manager.h"
+#include "ob_root_balancer.h"
+using namespace oceanbase::common;
+using namespace oceanbase::rootserver;
+
+namespace
+{
+  struct CsLoad
+  {
+    int64_t qps_;
+    int64_t scan_bytes_;
+  };
+
+  void usage(const char *prog)
+  {
+    printf("%s <root_table_file> <clist_file> <load_file> "
+           "[size_weight qps_weight scan_bytes_weight tolerance_percent]\n", prog);
+    printf("  each line of load_file: <cs_ip> <table_id> <get_qps> <scan_qps> <scan_bytes_per_second> [tablet_index]\n");
+    printf("  a line with tablet_index is the load of a hot tablet, the index-th tablet of the table in root table,\n"
+           "  which is a part of the load of its table\n");
+  }
+
+  const ObTabletInfo *find_tablet(ObRootTable2 &root_table, const uint64_t table_id, const int64_t index)
+  {
+    const ObTabletInfo *ret = NULL;
+    int64_t count = 0;
+    ObRootTable2::const_iterator it;
+    for (it = root_table.begin(); it != root_table.end() && NULL == ret; ++it)
+    {
+      const ObTabletInfo *tablet = root_table.get_tablet_info(it);
+      if (NULL != tablet && tablet->range_.table_id_ == table_id && index == count++)
+      {
+        ret = tablet;
+      }
+    }
+    return ret;
+  }
+
+  int load_snapshot(const char *filename, ObRootTable2 &root_table, ObChunkServerManager &csmgr)
+  {
+    int ret = OB_SUCCESS;
+    FILE *fp = fopen(filename, "r");
+    if (NULL == fp)
+    {
+      printf("failed to open load file %s\n", filename);
+      ret = OB_IO_ERROR;
+    }
+    else
+    {
+      char line[1024];
+      char ip[OB_IP_STR_BUFF];
+      char format[64];
+      int64_t line_no = 0;
+      // the width of ip must fit its buffer
+      snprintf(format, sizeof(format), "%%%lds %%lu %%ld %%ld %%ld %%ld", OB_IP_STR_BUFF - 1);
+      while (OB_SUCCESS == ret && NULL != fgets(line, sizeof(line), fp))
+      {
+        ObTableLoad load;
+        ObTabletLoad tablet_load;
+        const ObTabletInfo *tablet = NULL;
+        int64_t tablet_index = -1;
+        int token_num = 0;
+        ObServer server;
+        ++line_no;
+        if ('#' == line[0] || '\n' == line[0])
+        {
+          continue;
+        }
+        token_num = sscanf(line, format, ip, &load.table_id_,
+                           &load.get_qps_, &load.scan_qps_, &load.scan_bytes_, &tablet_index);
+        if (5 != token_num && 6 != token_num)
+        {
+          printf("invalid line %ld: %s", line_no, line);
+          ret = OB_INVALID_ARGUMENT;
+        }
+        else if (6 == token_num && NULL == (tablet = find_tablet(root_table, load.table_id_, tablet_index)))
+        {
+          printf("tablet %ld of table %lu not in root table at line %ld\n", tablet_index, load.table_id_, line_no);
+          ret = OB_INVALID_ARGUMENT;
+        }
+        else if (!server.set_ipv4_addr(ip, 0))
+        {
+          printf("invalid cs ip at line %ld: %s\n", line_no, ip);
+          ret = OB_INVALID_ARGUMENT;
+        }
+        else
+        {
+          ObChunkServerManager::iterator it = csmgr.find_by_ip(server);
+          if (it == csmgr.end())
+          {
+            printf("cs %s not in clist, ignored\n", ip);
+          }
+          else if (NULL != tablet)
+          {
+            tablet_load.table_id_ = load.table_id_;
+            tablet_load.range_hash_ = ObTabletLoad::get_range_hash(tablet->range_);
+            tablet_load.get_qps_ = load.get_qps_;
+            tablet_load.scan_qps_ = load.scan_qps_;
+            tablet_load.scan_bytes_ = load.scan_bytes_;
+            if (OB_SUCCESS != (ret = it->load_info_.add_tablet_load(tablet_load)))
+            {
+              printf("too many tablets of cs %s, max=%ld\n", ip, ObServerLoad::MAX_TABLET_LOAD_COUNT);
+            }
+          }
+          else if (OB_SUCCESS != (ret = it->load_info_.add_table_load(load)))
+          {
+            printf("too many tables of cs %s, max=%ld\n", ip, ObServerLoad::MAX_TABLE_LOAD_COUNT);
+          }
+        }
+      }
+      fclose(fp);
+    }
+    return ret;
+  }
+
+  int64_t count_tablets(ObRootTable2 &root_table, const int32_t cs_idx, const uint64_t table_id)
+  {
+    int64_t count = 0;
+    ObRootTable2::const_iterator it;
+    for (it = root_table.begin(); it != root_table.end(); ++it)
+    {
+      const ObTabletInfo *tablet = root_table.get_tablet_info(it);
+      if (NULL != tablet && tablet->range_.table_id_ == table_id && it->did_cs_have(cs_idx))
+      {
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  // the load a tablet takes away from cs, the same as ObRootBalancer::nb_get_tablet_cost:
+  // the load of a hot tablet is reported, the other tablets share the rest load of the table
+  void get_tablet_load(ObRootTable2 &root_table, const ObServerStatus &cs, const int32_t cs_idx,
+                       const ObNewRange &range, CsLoad &tablet_load)
+  {
+    const ObTableLoad *load = cs.load_info_.get_table_load(range.table_id_);
+    const ObTabletLoad *hot = cs.load_info_.get_tablet_load(range.table_id_, ObTabletLoad::get_range_hash(range));
+    tablet_load.qps_ = 0;
+    tablet_load.scan_bytes_ = 0;
+    if (NULL != hot)
+    {
+      tablet_load.qps_ = hot->get_qps();
+      tablet_load.scan_bytes_ = hot->scan_bytes_;
+    }
+    else if (NULL != load)
+    {
+      int64_t hot_count = 0;
+      int64_t rest_qps = load->get_qps();
+      int64_t rest_scan_bytes = load->scan_bytes_;
+      for (int64_t i = 0; i < cs.load_info_.get_tablet_count(); ++i)
+      {
+        if (cs.load_info_.tablet_at(i).table_id_ == range.table_id_)
+        {
+          ++hot_count;
+          rest_qps -= cs.load_info_.tablet_at(i).get_qps();
+          rest_scan_bytes -= cs.load_info_.tablet_at(i).scan_bytes_;
+        }
+      }
+      int64_t tablet_count = count_tablets(root_table, cs_idx, range.table_id_) - hot_count;
+      if (0 < tablet_count)
+      {
+        tablet_load.qps_ = (0 < rest_qps) ? rest_qps / tablet_count : 0;
+        tablet_load.scan_bytes_ = (0 < rest_scan_bytes) ? rest_scan_bytes / tablet_count : 0;
+      }
+    }
+  }
+
+  void print_skew(const char *title, const CsLoad *loads, ObChunkServerManager &csmgr)
+  {
+    int64_t cs_num = 0;
+    int64_t total_qps = 0;
+    int64_t max_qps = 0;
+    int64_t total_scan_bytes = 0;
+    int64_t max_scan_bytes = 0;
+    ObChunkServerManager::const_iterator it;
+    printf("%s\ncs qps scan_bytes\n", title);
+    for (it = csmgr.begin(); it != csmgr.end(); ++it)
+    {
+      if (ObServerStatus::STATUS_DEAD != it->status_)
+      {
+        const CsLoad &load = loads[it - csmgr.begin()];
+        printf("%s %ld %ld\n", it->server_.to_cstring(), load.qps_, load.scan_bytes_);
+        ++cs_num;
+        total_qps += load.qps_;
+        total_scan_bytes += load.scan_bytes_;
+        max_qps = (load.qps_ > max_qps) ? load.qps_ : max_qps;
+        max_scan_bytes = (load.scan_bytes_ > max_scan_bytes) ? load.scan_bytes_ : max_scan_bytes;
+      }
+    }
+    if (0 < cs_num)
+    {
+      printf("max/avg qps=%.2f max/avg scan_bytes=%.2f\n",
+             (0 < total_qps) ? static_cast<double>(max_qps * cs_num) / static_cast<double>(total_qps) : 1.0,
+             (0 < total_scan_bytes) ? static_cast<double>(max_scan_bytes * cs_num) / static_cast<double>(total_scan_bytes) : 1.0);
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  int ret = OB_SUCCESS;
+  if (4 != argc && 8 != argc)
+  {
+    usage(argv[0]);
+    return 0;
+  }
+  ob_init_memory_pool();
+  ob_init_crc64_table(OB_DEFAULT_CRC64_POLYNOM);
+  ObTabletInfoManager *tablet_manager = new ObTabletInfoManager();
+  ObRootTable2 *root_table = new ObRootTable2(tablet_manager);
+  ObChunkServerManager *csmgr = new ObChunkServerManager();
+  ObRootServerConfig *config = new ObRootServerConfig();
+  ObRootBalancer *balancer = new ObRootBalancer();
+  CsLoad *before = new CsLoad[ObChunkServerManager::MAX_SERVER_COUNT];
+  CsLoad *after = new CsLoad[ObChunkServerManager::MAX_SERVER_COUNT];
+  tbsys::CRWLock root_table_rwlock;
+  tbsys::CRWLock server_manager_rwlock;
+  int32_t cs_num = 0;
+  int32_t ms_num = 0;
+
+  if (OB_SUCCESS != (ret = root_table->read_from_file(argv[1])))
+  {
+    printf("failed to load root table from %s, err=%d\n", argv[1], ret);
+  }
+  else if (OB_SUCCESS != (ret = csmgr->read_from_file(argv[2], cs_num, ms_num)))
+  {
+    printf("failed to load server list from %s, err=%d\n", argv[2], ret);
+  }
+  else if (OB_SUCCESS != (ret = load_snapshot(argv[3], *root_table, *csmgr)))
+  {
+    printf("failed to load query load from %s, err=%d\n", argv[3], ret);
+  }
+  else
+  {
+    config->balance_by_load = true;
+    if (8 == argc)
+    {
+      config->balance_size_weight = atoll(argv[4]);
+      config->balance_qps_weight = atoll(argv[5]);
+      config->balance_scan_bytes_weight = atoll(argv[6]);
+      config->balance_tolerance_percent = atoll(argv[7]);
+    }
+    balancer->set_config(config);
+    balancer->set_root_table(root_table);
+    balancer->set_root_table_lock(&root_table_rwlock);
+    balancer->set_server_manager(csmgr);
+    balancer->set_server_manager_lock(&server_manager_rwlock);
+    csmgr->reset_balance_info(static_cast<int32_t>(config->balance_max_migrate_out_per_cs));
+    printf("load succ, tablet_num=%ld cs_num=%d\n", root_table->end() - root_table->begin(), cs_num);
+
+    memset(before, 0, sizeof(CsLoad) * ObChunkServerManager::MAX_SERVER_COUNT);
+    for (ObChunkServerManager::iterator it = csmgr->begin(); it != csmgr->end(); ++it)
+    {
+      for (int64_t i = 0; i < it->load_info_.get_table_count(); ++i)
+      {
+        before[it - csmgr->begin()].qps_ += it->load_info_.at(i).get_qps();
+        before[it - csmgr->begin()].scan_bytes_ += it->load_info_.at(i).scan_bytes_;
+      }
+    }
+    memcpy(after, before, sizeof(CsLoad) * ObChunkServerManager::MAX_SERVER_COUNT);
+
+    // plan every table in the order of root table
+    bool scan_next_table = true;
+    uint64_t last_table_id = OB_INVALID_ID;
+    ObRootTable2::const_iterator rt_it;
+    for (rt_it = root_table->begin(); rt_it != root_table->end() && scan_next_table; ++rt_it)
+    {
+      const ObTabletInfo *tablet = root_table->get_tablet_info(rt_it);
+      if (NULL != tablet && tablet->range_.table_id_ != last_table_id)
+      {
+        last_table_id = tablet->range_.table_id_;
+        balancer->nb_balance_by_table(last_table_id, scan_next_table);
+      }
+    }
+
+    // apply the plan, a tablet takes its own load if it is hot on src cs,
+    // otherwise its share of the rest load of its table
+    int64_t migrate_count = 0;
+    printf("migrate plan\n");
+    for (ObChunkServerManager::iterator it = csmgr->begin(); it != csmgr->end(); ++it)
+    {
+      const int32_t src_idx = static_cast<int32_t>(it - csmgr->begin());
+      for (const ObMigrateInfo *minfo = it->balance_info_.migrate_to_.head(); NULL != minfo; minfo = minfo->next_)
+      {
+        const ObServerStatus *dest = csmgr->get_server_status(minfo->cs_idx_);
+        CsLoad tablet_load;
+        if (NULL == dest)
+        {
+          continue;
+        }
+        printf("%s %s -> %s\n", to_cstring(minfo->range_), it->server_.to_cstring(), dest->server_.to_cstring());
+        ++migrate_count;
+        get_tablet_load(*root_table, *it, src_idx, minfo->range_, tablet_load);
+        after[src_idx].qps_ -= tablet_load.qps_;
+        after[src_idx].scan_bytes_ -= tablet_load.scan_bytes_;
+        after[minfo->cs_idx_].qps_ += tablet_load.qps_;
+        after[minfo->cs_idx_].scan_bytes_ += tablet_load.scan_bytes_;
+      }
+    }
+    printf("migrate_count=%ld\n", migrate_count);
+    print_skew("load before balance", before, *csmgr);
+    print_skew("load after balance", after, *csmgr);
+  }
+
+  delete [] after;
+  delete [] before;
+  delete balancer;
+  delete config;
+  delete csmgr;
+  delete root_table;
+  delete tablet_manager;
+  return ret;
+}
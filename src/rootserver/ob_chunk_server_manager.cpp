@@ -25,6 +25,8 @@ namespace oceanbase
     ObBalanceInfo::ObBalanceInfo()
       :table_sstable_total_size_(0),
        table_sstable_count_(0),
+       table_load_cost_(0),
+       table_tablet_load_cost_(0),
        curr_migrate_in_num_(0),
        curr_migrate_out_num_(0)
     {
@@ -47,6 +49,8 @@ namespace oceanbase
     {
       table_sstable_count_ = 0;
       table_sstable_total_size_ = 0;
+      table_load_cost_ = 0;
+      table_tablet_load_cost_ = 0;
     }
 
     ////////////////////////////////////////////////////////////////
@@ -408,6 +412,21 @@ namespace oceanbase
       }
       return ret;
     }
+    int ObChunkServerManager::update_load_info(const common::ObServer& server, const common::ObServerLoad& load_info)
+    {
+      int ret = OB_SUCCESS;
+      iterator it = find_by_ip(server);
+      if (it != end())
+      {
+        it->load_info_ = load_info;
+      }
+      else
+      {
+        TBSYS_LOG(WARN, "not find info about server %s", to_cstring(server));
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      return ret;
+    }
     int ObChunkServerManager::get_array_length() const
     {
       return static_cast<int32_t>(servers_.get_array_index());
@@ -579,6 +598,7 @@ namespace oceanbase
         }
         it->status_ = ObServerStatus::STATUS_DEAD;
         it->balance_info_.reset();
+        it->load_info_.reset();
       }
       return ;
     }
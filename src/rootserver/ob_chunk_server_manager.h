@@ -15,6 +15,7 @@
 #include "common/ob_server.h"
 #include "common/ob_array.h"
 #include "common/ob_range2.h"
+#include "common/ob_server_load.h"
 #include "ob_server_balance_info.h"
 #include "ob_migrate_info.h"
 
@@ -35,6 +36,12 @@ namespace oceanbase
       int64_t table_sstable_total_size_;
       /// total count of all sstables for one particular table in this CS
       int64_t table_sstable_count_;
+      /// weighted cost of size and query load for one particular table in this CS,
+      /// the average of all CS is ObRootBalancer::AVG_LOAD_COST
+      int64_t table_load_cost_;
+      /// the query load cost carried by each tablet of the table in this CS
+      /// which is not reported as one of the hottest tablets
+      int64_t table_tablet_load_cost_;
       /// the count of currently migrate-in tablets
       int32_t curr_migrate_in_num_;
       /// the count of currently migrate-out tablets
@@ -81,6 +88,7 @@ namespace oceanbase
       int32_t hb_retry_times_;        //no need serialize
 
       ObServerDiskInfo disk_info_; //chunk server disk info
+      common::ObServerLoad load_info_; //query load reported by heartbeat, no need serialize
       int64_t register_time_;       // no need serialize
       //used in the new rebalance algorithm, don't serialize
       ObBalanceInfo balance_info_;
@@ -116,6 +124,7 @@ namespace oceanbase
         int register_ms(const common::ObServer& server, int32_t port, int64_t time_stamp);
 
         int update_disk_info(const common::ObServer& server, const ObServerDiskInfo& disk_info);
+        int update_load_info(const common::ObServer& server, const common::ObServerLoad& load_info);
         int get_array_length() const;
         ObServerStatus* get_server_status(const int32_t index);
         const ObServerStatus* get_server_status(const int32_t index) const;
@@ -41,7 +41,11 @@ ObRootBalancer::ObRootBalancer()
    balance_batch_migrate_count_(0),
    balance_batch_migrate_done_num_(0),
    balance_select_dest_start_pos_(0),
-   balance_batch_copy_count_(0)
+   balance_batch_copy_count_(0),
+   balance_by_load_(false),
+   balance_size_cost_per_byte_(0),
+   balance_qps_cost_(0),
+   balance_scan_bytes_cost_(0)
 {
 }
 
@@ -243,6 +247,42 @@ int ObRootBalancer::nb_find_dest_cs(ObRootTable2::const_iterator meta, int64_t l
   return ret;
 }
 
+// 按负载均衡时选择代价最小的cs作为目的cs，迁入后代价不能超过high_bound
+int ObRootBalancer::nb_find_dest_cs_by_cost(ObRootTable2::const_iterator meta, int64_t high_bound, int64_t tablet_cost,
+                                           int32_t &dest_cs_idx, ObChunkServerManager::iterator &dest_it)
+{
+  int ret = OB_ENTRY_NOT_EXIST;
+  dest_cs_idx = OB_INVALID_INDEX;
+  int64_t min_cost = INT64_MAX;
+  int64_t mnow = tbsys::CTimeUtil::getMonotonicTime();
+  ObChunkServerManager::iterator it;
+  for (it = server_manager_->begin(); it != server_manager_->end(); ++it)
+  {
+    if (it->status_ != ObServerStatus::STATUS_DEAD
+        && it->status_ != ObServerStatus::STATUS_SHUTDOWN
+        && it->balance_info_.table_load_cost_ < min_cost
+        && it->balance_info_.table_load_cost_ <= high_bound - tablet_cost
+        && mnow > (it->register_time_ + config_->cs_probation_period))
+    {
+      int32_t cs_idx = static_cast<int32_t>(it - server_manager_->begin());
+      // this cs does't have this tablet
+      if (!meta->did_cs_have(cs_idx))
+      {
+        min_cost = it->balance_info_.table_load_cost_;
+        dest_it = it;
+        dest_cs_idx = cs_idx;
+        ret = OB_SUCCESS;
+      }
+    }
+  } // end for
+  if (OB_SUCCESS == ret)
+  {
+    TBSYS_LOG(DEBUG, "find dest cs by cost, cs_idx=%d cost=%ld tablet_cost=%ld high_bound=%ld",
+              dest_cs_idx, min_cost, tablet_cost, high_bound);
+  }
+  return ret;
+}
+
 int ObRootBalancer::nb_check_rereplication(ObRootTable2::const_iterator it, RereplicationAction &act)
 {
   int ret = OB_SUCCESS;
@@ -325,7 +365,22 @@ int ObRootBalancer::nb_add_copy(ObRootTable2::const_iterator it, const ObTabletI
   int ret = OB_ERROR;
   int32_t dest_cs_idx = OB_INVALID_INDEX;
   ObServerStatus *dest_it = NULL;
-  if (OB_SUCCESS != nb_find_dest_cs(it, low_bound, cs_num, dest_cs_idx, dest_it)
+  // the new replica shares the query load, only its size is counted
+  int64_t tablet_cost = static_cast<int64_t>(balance_size_cost_per_byte_ * static_cast<double>(tablet->occupy_size_));
+  if (balance_by_load_)
+  {
+    if (OB_SUCCESS != nb_find_dest_cs_by_cost(it, AVG_LOAD_COST + nb_get_load_cost_tolerance(),
+                                              tablet_cost, dest_cs_idx, dest_it)
+        || OB_INVALID_INDEX == dest_cs_idx)
+    {
+      if (OB_SUCCESS != nb_find_dest_cs_by_cost(it, INT64_MAX, tablet_cost, dest_cs_idx, dest_it)
+          || OB_INVALID_INDEX == dest_cs_idx)
+      {
+        TBSYS_LOG(DEBUG, "cannot find dest cs by cost");
+      }
+    }
+  }
+  else if (OB_SUCCESS != nb_find_dest_cs(it, low_bound, cs_num, dest_cs_idx, dest_it)
       || OB_INVALID_INDEX == dest_cs_idx)
   {
     if (OB_SUCCESS != nb_find_dest_cs(it, INT64_MAX, cs_num, dest_cs_idx, dest_it)
@@ -350,6 +405,7 @@ int ObRootBalancer::nb_add_copy(ObRootTable2::const_iterator it, const ObTabletI
       {
         // no locking
         dest_it->balance_info_.table_sstable_count_++;
+        dest_it->balance_info_.table_load_cost_ += tablet_cost;
         balance_batch_migrate_count_++;
         balance_batch_copy_count_++;
         ret = OB_SUCCESS;
@@ -372,15 +428,33 @@ int ObRootBalancer::nb_check_add_migrate(ObRootTable2::const_iterator it, const
       ObServerStatus *src_cs = server_manager_->get_server_status(cs_idx);
       if (NULL != src_cs && ObServerStatus::STATUS_DEAD != src_cs->status_)
       {
-        if ((src_cs->balance_info_.table_sstable_count_ > avg_count + delta_count
-             ||src_cs->status_ == ObServerStatus::STATUS_SHUTDOWN)
+        if (nb_is_migrate_out_cs(*src_cs, avg_count)
             && src_cs->balance_info_.migrate_to_.count() < migrate_out_per_cs)
         {
           // move out this sstable
           // find dest cs, no locking
           int32_t dest_cs_idx = OB_INVALID_INDEX;
           ObServerStatus *dest_it = NULL;
-          if (OB_SUCCESS != nb_find_dest_cs(it, avg_count - delta_count, cs_num, dest_cs_idx, dest_it)
+          int64_t tablet_cost = 0;
+          if (balance_by_load_)
+          {
+            // the tablet takes its share of the query load to dest cs
+            tablet_cost = nb_get_tablet_cost(*src_cs, *tablet);
+            if (OB_SUCCESS != nb_find_dest_cs_by_cost(it, AVG_LOAD_COST + nb_get_load_cost_tolerance(),
+                                                      tablet_cost, dest_cs_idx, dest_it)
+                || OB_INVALID_INDEX == dest_cs_idx)
+            {
+              if (src_cs->status_ == ObServerStatus::STATUS_SHUTDOWN)
+              {
+                if (OB_SUCCESS != nb_find_dest_cs_by_cost(it, INT64_MAX, tablet_cost, dest_cs_idx, dest_it)
+                    || OB_INVALID_INDEX == dest_cs_idx)
+                {
+                  TBSYS_LOG(WARN, "cannot find dest cs");
+                }
+              }
+            }
+          }
+          else if (OB_SUCCESS != nb_find_dest_cs(it, avg_count - delta_count, cs_num, dest_cs_idx, dest_it)
               || OB_INVALID_INDEX == dest_cs_idx)
           {
             if (src_cs->status_ == ObServerStatus::STATUS_SHUTDOWN)
@@ -400,6 +474,8 @@ int ObRootBalancer::nb_check_add_migrate(ObRootTable2::const_iterator it, const
               // no locking
               src_cs->balance_info_.table_sstable_count_--;
               dest_it->balance_info_.table_sstable_count_++;
+              src_cs->balance_info_.table_load_cost_ -= tablet_cost;
+              dest_it->balance_info_.table_load_cost_ += tablet_cost;
               balance_batch_migrate_count_++;
             }
           }
@@ -701,44 +777,51 @@ int ObRootBalancer::nb_balance_by_table(const uint64_t table_id, bool &scan_next
 
     ObRootTable2::const_iterator it;
     const ObTabletInfo* tablet = NULL;
-    bool table_found = false;
-    // scan the root table
     tbsys::CRLockGuard guard(*root_table_rwlock_);
-    for (it = root_table_->begin(); it != root_table_->end(); ++it)
+    // when balanced by load, the reported hot tablets are checked in the
+    // first pass, so the overloaded cs moves out its hotspots before the
+    // cold tablets in the root table order
+    for (int pass = balance_by_load_ ? 0 : 1; pass < 2 && scan_next_table; ++pass)
     {
-      tablet = root_table_->get_tablet_info(it);
-      if (NULL != tablet)
+      bool table_found = false;
+      // scan the root table
+      for (it = root_table_->begin(); it != root_table_->end(); ++it)
       {
-        if (tablet->range_.table_id_ == table_id)
+        tablet = root_table_->get_tablet_info(it);
+        if (NULL != tablet)
         {
-          if (!table_found)
-          {
-            table_found = true;
-          }
-          // do balnace if needed
-          if ((!is_curr_table_balanced || 0 < shutdown_num)
-              && config_->enable_balance
-              && it->can_be_migrated_now(config_->tablet_migrate_disabling_period))
-          {
-            nb_check_add_migrate(it, tablet, avg_count, cs_num, migrate_out_per_cs);
-          }
-          // terminate condition
-          if (server_manager_->is_migrate_infos_full())
+          if (tablet->range_.table_id_ == table_id)
           {
-            scan_next_table = false;
-            break;
+            if (!table_found)
+            {
+              table_found = true;
+            }
+            // do balnace if needed
+            if ((!is_curr_table_balanced || 0 < shutdown_num)
+                && config_->enable_balance
+                && it->can_be_migrated_now(config_->tablet_migrate_disabling_period)
+                && (!balance_by_load_ || (0 == pass) == nb_is_hot_tablet(it, *tablet)))
+            {
+              nb_check_add_migrate(it, tablet, avg_count, cs_num, migrate_out_per_cs);
+            }
+            // terminate condition
+            if (server_manager_->is_migrate_infos_full())
+            {
+              scan_next_table = false;
+              break;
+            }
           }
-        }
-        else
-        {
-          if (table_found)
+          else
           {
-            // another table
-            break;
+            if (table_found)
+            {
+              // another table
+              break;
+            }
           }
-        }
-      } // end if tablet not NULL
-    } // end for
+        } // end if tablet not NULL
+      } // end for
+    }
   }
   return ret;
 }
@@ -759,7 +842,19 @@ bool ObRootBalancer::nb_is_curr_table_balanced(int64_t avg_sstable_count, const
         // do not consider except_cs
         continue;
       }
-      if ((avg_sstable_count + delta_count) < it->balance_info_.table_sstable_count_)
+      if (balance_by_load_)
+      {
+        // any cs below the average can take load from the overloaded ones
+        if (AVG_LOAD_COST + nb_get_load_cost_tolerance() < it->balance_info_.table_load_cost_)
+        {
+          cs_out++;
+        }
+        else if (AVG_LOAD_COST > it->balance_info_.table_load_cost_)
+        {
+          cs_in++;
+        }
+      }
+      else if ((avg_sstable_count + delta_count) < it->balance_info_.table_sstable_count_)
       {
         cs_out++;
       }
@@ -856,14 +951,22 @@ int ObRootBalancer::nb_calculate_sstable_count(const uint64_t table_id, int64_t
     {
       sstable_avg_size = total_size/total_count;
     }
+    balance_by_load_ = false;
+    balance_size_cost_per_byte_ = 0;
+    balance_qps_cost_ = 0;
+    balance_scan_bytes_cost_ = 0;
+    if (config_->balance_by_load)
+    {
+      nb_calculate_load_cost(table_id, total_size,
+                             (0 < shutdown_count && shutdown_count < cs_count) ? cs_count - shutdown_count : cs_count);
+    }
     int32_t out_cs = 0;
     ObServerStatus *it = NULL;
     for (it = server_manager_->begin(); it != server_manager_->end(); ++it)
     {
       if (it->status_ != ObServerStatus::STATUS_DEAD)
       {
-        if (it->balance_info_.table_sstable_count_ > avg_count + config_->balance_tolerance_count
-            || ObServerStatus::STATUS_SHUTDOWN == it->status_)
+        if (nb_is_migrate_out_cs(*it, avg_count))
         {
           out_cs++;
         }
@@ -887,6 +990,147 @@ int ObRootBalancer::nb_calculate_sstable_count(const uint64_t table_id, int64_t
   return ret;
 }
 
+// 按加权代价均衡时计算每台cs上该表的代价：sstable大小、查询qps和scan字节数
+// 分别按占全部cs平均值的比例加权，所有cs的平均代价为AVG_LOAD_COST。
+// cs上报的热点tablet按各自的负载计算代价，该表其余的负载由其它tablet平分
+void ObRootBalancer::nb_calculate_load_cost(const uint64_t table_id, const int64_t total_size, const int32_t cs_num)
+{
+  int64_t total_qps = 0;
+  int64_t total_scan_bytes = 0;
+  ObServerStatus *it = NULL;
+  tbsys::CRLockGuard guard(*server_manager_rwlock_);
+  for (it = server_manager_->begin(); it != server_manager_->end(); ++it)
+  {
+    if (it->status_ != ObServerStatus::STATUS_DEAD)
+    {
+      const ObTableLoad *load = it->load_info_.get_table_load(table_id);
+      if (NULL != load)
+      {
+        total_qps += load->get_qps();
+        total_scan_bytes += load->scan_bytes_;
+      }
+    }
+  }
+  // the dimension without data is not counted
+  double size_weight = (0 < total_size) ? static_cast<double>(config_->balance_size_weight) : 0;
+  double qps_weight = (0 < total_qps) ? static_cast<double>(config_->balance_qps_weight) : 0;
+  double scan_bytes_weight = (0 < total_scan_bytes) ? static_cast<double>(config_->balance_scan_bytes_weight) : 0;
+  double weight_sum = size_weight + qps_weight + scan_bytes_weight;
+  // balanced by sstable count as before if no query load is reported
+  if (0 < cs_num && 0 < qps_weight + scan_bytes_weight)
+  {
+    double scale = static_cast<double>(AVG_LOAD_COST * cs_num) / weight_sum;
+    balance_by_load_ = true;
+    balance_size_cost_per_byte_ = (0 < size_weight) ? scale * size_weight / static_cast<double>(total_size) : 0;
+    balance_qps_cost_ = (0 < qps_weight) ? scale * qps_weight / static_cast<double>(total_qps) : 0;
+    balance_scan_bytes_cost_ = (0 < scan_bytes_weight) ? scale * scan_bytes_weight / static_cast<double>(total_scan_bytes) : 0;
+    for (it = server_manager_->begin(); it != server_manager_->end(); ++it)
+    {
+      if (it->status_ != ObServerStatus::STATUS_DEAD)
+      {
+        double load_cost = 0;
+        const ObTableLoad *load = it->load_info_.get_table_load(table_id);
+        if (NULL != load)
+        {
+          load_cost = balance_qps_cost_ * static_cast<double>(load->get_qps())
+            + balance_scan_bytes_cost_ * static_cast<double>(load->scan_bytes_);
+        }
+        // the hot tablets take their own load, the rest is shared by the other tablets
+        double hot_cost = 0;
+        int64_t hot_count = 0;
+        for (int64_t i = 0; i < it->load_info_.get_tablet_count(); ++i)
+        {
+          const ObTabletLoad &tablet_load = it->load_info_.tablet_at(i);
+          if (tablet_load.table_id_ == table_id)
+          {
+            hot_cost += static_cast<double>(nb_get_tablet_load_cost(tablet_load));
+            hot_count++;
+          }
+        }
+        ObBalanceInfo &info = it->balance_info_;
+        info.table_load_cost_ = static_cast<int64_t>(
+            balance_size_cost_per_byte_ * static_cast<double>(info.table_sstable_total_size_) + load_cost);
+        info.table_tablet_load_cost_ = (hot_cost < load_cost && hot_count < info.table_sstable_count_)
+          ? static_cast<int64_t>((load_cost - hot_cost) / static_cast<double>(info.table_sstable_count_ - hot_count)) : 0;
+      }
+    }
+  }
+  TBSYS_LOG(DEBUG, "load cost, table_id=%lu by_load=%d total_size=%ld total_qps=%ld total_scan_bytes=%ld",
+            table_id, balance_by_load_, total_size, total_qps, total_scan_bytes);
+}
+
+int64_t ObRootBalancer::nb_get_tablet_cost(const ObServerStatus &cs, const ObTabletInfo &tablet) const
+{
+  int64_t load_cost = cs.balance_info_.table_tablet_load_cost_;
+  if (0 < cs.load_info_.get_tablet_count())
+  {
+    const ObTabletLoad *load = cs.load_info_.get_tablet_load(tablet.range_.table_id_,
+                                                             ObTabletLoad::get_range_hash(tablet.range_));
+    if (NULL != load)
+    {
+      load_cost = nb_get_tablet_load_cost(*load);
+    }
+  }
+  return static_cast<int64_t>(balance_size_cost_per_byte_ * static_cast<double>(tablet.occupy_size_)) + load_cost;
+}
+
+int64_t ObRootBalancer::nb_get_tablet_load_cost(const ObTabletLoad &load) const
+{
+  return static_cast<int64_t>(balance_qps_cost_ * static_cast<double>(load.get_qps())
+                              + balance_scan_bytes_cost_ * static_cast<double>(load.scan_bytes_));
+}
+
+// 该tablet是否为某个副本所在cs上报的热点tablet，只依赖上报的负载，
+// 在一次均衡过程中不会改变
+bool ObRootBalancer::nb_is_hot_tablet(ObRootTable2::const_iterator it, const ObTabletInfo &tablet) const
+{
+  bool ret = false;
+  bool hashed = false;
+  uint64_t range_hash = 0;
+  for (int i = 0; i < OB_SAFE_COPY_COUNT && !ret; ++i)
+  {
+    int32_t cs_idx = it->server_info_indexes_[i];
+    if (OB_INVALID_INDEX != cs_idx)
+    {
+      const ObServerStatus *cs = server_manager_->get_server_status(cs_idx);
+      if (NULL != cs && ObServerStatus::STATUS_DEAD != cs->status_
+          && 0 < cs->load_info_.get_tablet_count())
+      {
+        if (!hashed)
+        {
+          range_hash = ObTabletLoad::get_range_hash(tablet.range_);
+          hashed = true;
+        }
+        ret = (NULL != cs->load_info_.get_tablet_load(tablet.range_.table_id_, range_hash));
+      }
+    }
+  }
+  return ret;
+}
+
+int64_t ObRootBalancer::nb_get_load_cost_tolerance() const
+{
+  return AVG_LOAD_COST * config_->balance_tolerance_percent / 100;
+}
+
+bool ObRootBalancer::nb_is_migrate_out_cs(const ObServerStatus &cs, int64_t avg_sstable_count) const
+{
+  bool ret = false;
+  if (ObServerStatus::STATUS_SHUTDOWN == cs.status_)
+  {
+    ret = true;
+  }
+  else if (balance_by_load_)
+  {
+    ret = cs.balance_info_.table_load_cost_ > AVG_LOAD_COST + nb_get_load_cost_tolerance();
+  }
+  else
+  {
+    ret = cs.balance_info_.table_sstable_count_ > avg_sstable_count + config_->balance_tolerance_count;
+  }
+  return ret;
+}
+
 void ObRootBalancer::nb_print_balance_info() const
 {
   char addr_buf[OB_IP_STR_BUFF];
@@ -896,9 +1140,10 @@ void ObRootBalancer::nb_print_balance_info() const
     if (NULL != it && ObServerStatus::STATUS_DEAD != it->status_)
     {
       it->server_.to_string(addr_buf, OB_IP_STR_BUFF);
-      TBSYS_LOG(DEBUG, "cs=%s sstables_count=%ld sstables_size=%ld migrate=%d",
+      TBSYS_LOG(DEBUG, "cs=%s sstables_count=%ld sstables_size=%ld load_cost=%ld migrate=%d",
                 addr_buf, it->balance_info_.table_sstable_count_,
                 it->balance_info_.table_sstable_total_size_,
+                it->balance_info_.table_load_cost_,
                 it->balance_info_.migrate_to_.count());
     }
   }
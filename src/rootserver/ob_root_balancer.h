@@ -44,6 +44,9 @@ namespace oceanbase
 
     class ObRootBalancer
     {
+      public:
+        // the average load cost of all cs for one table when balancing by load
+        static const int64_t AVG_LOAD_COST = 1000;
       public:
         ObRootBalancer();
         virtual ~ObRootBalancer();
@@ -80,15 +83,23 @@ namespace oceanbase
         int nb_calculate_sstable_count(const uint64_t table_id, int64_t &avg_size, int64_t &avg_count,
             int32_t &cs_num, int32_t &migrate_out_per_cs, int32_t &shutdown_count); // public only for testing
         bool nb_did_cs_have_no_tablets(const common::ObServer &cs) const;
+        int nb_balance_by_table(const uint64_t table_id, bool &scan_next_table); // public only for balance simulator
       private:
         //check wether shutdown_cs is migrate clean
         void check_shutdown_process();
         void check_components();
         void do_new_balance();
-        int nb_balance_by_table(const uint64_t table_id, bool &scan_next_table);
         int do_rereplication_by_table(const uint64_t table_id, bool &scan_next_table);
         int nb_find_dest_cs(ObRootTable2::const_iterator meta, int64_t low_bound, int32_t cs_num,
             int32_t &dest_cs_idx, ObChunkServerManager::iterator &dest_it);
+        int nb_find_dest_cs_by_cost(ObRootTable2::const_iterator meta, int64_t high_bound, int64_t tablet_cost,
+            int32_t &dest_cs_idx, ObChunkServerManager::iterator &dest_it);
+        void nb_calculate_load_cost(const uint64_t table_id, const int64_t total_size, const int32_t cs_num);
+        int64_t nb_get_tablet_cost(const ObServerStatus &cs, const common::ObTabletInfo &tablet) const;
+        int64_t nb_get_tablet_load_cost(const common::ObTabletLoad &load) const;
+        bool nb_is_hot_tablet(ObRootTable2::const_iterator it, const common::ObTabletInfo &tablet) const;
+        int64_t nb_get_load_cost_tolerance() const;
+        bool nb_is_migrate_out_cs(const ObServerStatus &cs, int64_t avg_sstable_count) const;
         uint64_t nb_get_next_table_id(int32_t table_count, int32_t seq = -1);
         int32_t nb_get_table_count();
         int send_msg_migrate(const common::ObServer &src, const common::ObServer &dest, const common::ObNewRange& range, bool keep_src);
@@ -149,6 +160,10 @@ namespace oceanbase
         int32_t balance_batch_migrate_done_num_;
         int32_t balance_select_dest_start_pos_;
         int32_t balance_batch_copy_count_; // for monitor purpose
+        bool balance_by_load_;              // current table is balanced by load cost
+        double balance_size_cost_per_byte_; // load cost of sstable size for current table
+        double balance_qps_cost_;           // load cost of one qps for current table
+        double balance_scan_bytes_cost_;    // load cost of one scan byte per second for current table
 
     };
 
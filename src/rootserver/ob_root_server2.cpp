@@ -2118,6 +2118,18 @@ int ObRootServer2::update_capacity_info(const common::ObServer& server, const in
   return ret;
 }
 
+/*
+ * chunk server通过心跳汇报各表的查询负载，用于按负载均衡
+ */
+int ObRootServer2::update_load_info(const common::ObServer& server, const common::ObServerLoad& load_info)
+{
+  tbsys::CWLockGuard guard(server_manager_rwlock_);
+  int ret = server_manager_.update_load_info(server, load_info);
+  TBSYS_LOG(DEBUG, "server %s update load info, table_count=%ld ret=%d",
+            to_cstring(server), load_info.get_table_count(), ret);
+  return ret;
+}
+
 /*
  * 迁移完成操作
  */
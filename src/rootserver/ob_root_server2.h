@@ -168,6 +168,10 @@ namespace oceanbase
          * chunk server更新自己的磁盘情况信息
          */
         int update_capacity_info(const common::ObServer& server, const int64_t capacity, const int64_t used);
+        /*
+         * chunk server通过心跳汇报各表的查询负载
+         */
+        int update_load_info(const common::ObServer& server, const common::ObServerLoad& load_info);
         /*
          * 迁移完成操作
          */
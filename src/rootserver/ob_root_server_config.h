@@ -75,6 +75,11 @@ namespace oceanbase
         DEF_TIME(balance_max_timeout, "5m", "max timeout for one group of balance task");
         DEF_INT(balance_max_concurrent_migrate_num, "2", "[1,10]", "max concurrent migrate num for balance");
         DEF_INT(balance_max_migrate_out_per_cs, "20", "[1,100]", "max migrate out per cs");
+        DEF_BOOL(balance_by_load, "False", "balance by weighted cost of sstable size and query load instead of sstable count");
+        DEF_INT(balance_size_weight, "1", "[0,100]", "weight of sstable size in load balance cost");
+        DEF_INT(balance_qps_weight, "1", "[0,100]", "weight of get and scan qps in load balance cost");
+        DEF_INT(balance_scan_bytes_weight, "1", "[0,100]", "weight of scan bytes in load balance cost");
+        DEF_INT(balance_tolerance_percent, "10", "[1,100]", "tolerance percent of cost for load balance");
         DEF_BOOL(enable_balance, "True", "balance switch");
         DEF_BOOL(enable_rereplication, "True", "rereplication switch");
         DEF_TIME(tablet_migrate_disabling_period, "60s", "cs can participate in balance after regist");
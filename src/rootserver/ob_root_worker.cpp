@@ -2159,6 +2159,21 @@ namespace oceanbase
       {
         result_msg.result_code_ = root_server_.receive_hb(server,role);
       }
+      // chunkserver reports its query load after the role
+      if (OB_SUCCESS == ret && OB_CHUNKSERVER == role
+          && in_buff.get_position() < in_buff.get_capacity())
+      {
+        ObServerLoad load_info;
+        if (OB_SUCCESS != (ret = load_info.deserialize(in_buff.get_data(),
+                in_buff.get_capacity(), in_buff.get_position())))
+        {
+          TBSYS_LOG(WARN, "deserialize load info error, server=%s ret=%d", to_cstring(server), ret);
+        }
+        else
+        {
+          root_server_.update_load_info(server, load_info);
+        }
+      }
       easy_request_wakeup(req);
       return ret;
     }
@@ -0,0 +1,886 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_compiled_expr.cpp
+ *
+ */
+#include "ob_compiled_expr.h"
+#include "common/ob_define.h"
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+namespace oceanbase
+{
+  namespace sql
+  {
+    class ObExprNode
+    {
+      public:
+        enum NodeType
+        {
+          OTHER_NODE = 0,
+          COLUMN_NODE,
+          CONST_NODE
+        };
+      public:
+        explicit ObExprNode(const NodeType node_type = OTHER_NODE)
+          :node_type_(node_type), stack_next_(NULL)
+        {
+        }
+        virtual ~ObExprNode() {}
+        // @note the return code of the operators of ObExprObj is ignored as the interpreter does
+        virtual int eval(const ObRow &row, ObExprObj &result) = 0;
+      public:
+        NodeType node_type_;
+        ObExprNode *stack_next_;        // used while compiling
+    };
+
+    class ObExprColumnNode: public ObExprNode
+    {
+      public:
+        ObExprColumnNode()
+          :ObExprNode(COLUMN_NODE), table_id_(OB_INVALID_ID), column_id_(OB_INVALID_ID),
+           cell_idx_(OB_INVALID_INDEX), next_column_(NULL)
+        {
+        }
+        virtual int eval(const ObRow &row, ObExprObj &result)
+        {
+          const ObObj *cell = NULL;
+          int ret = row.raw_get_cell(cell_idx_, cell);
+          if (OB_LIKELY(OB_SUCCESS == ret))
+          {
+            result.assign(*cell);
+          }
+          return ret;
+        }
+        inline int get_cell(const ObRow &row, const ObObj *&cell) const
+        {
+          return row.raw_get_cell(cell_idx_, cell);
+        }
+      public:
+        uint64_t table_id_;
+        uint64_t column_id_;
+        int64_t cell_idx_;
+        ObExprColumnNode *next_column_;
+    };
+
+    class ObExprConstNode: public ObExprNode
+    {
+      public:
+        ObExprConstNode()
+          :ObExprNode(CONST_NODE), obj_(NULL), is_ext_(false)
+        {
+        }
+        void set_obj(const ObObj &obj)
+        {
+          if (ObExtendType == obj.get_type())
+          {
+            // question mark or variable, the value may change between executions
+            int64_t obj_addr = 0;
+            obj.get_ext(obj_addr);
+            obj_ = reinterpret_cast<const ObObj*>(obj_addr);
+            is_ext_ = true;
+          }
+          else
+          {
+            obj_ = &obj;
+            value_.assign(obj);
+          }
+        }
+        virtual int eval(const ObRow &row, ObExprObj &result)
+        {
+          UNUSED(row);
+          if (is_ext_)
+          {
+            result.assign(*obj_);
+          }
+          else
+          {
+            result = value_;
+          }
+          return OB_SUCCESS;
+        }
+      public:
+        const ObObj *obj_;
+        bool is_ext_;
+        ObExprObj value_;
+    };
+
+    ////////////////////////////////////////////////////////////////
+    // operators
+    ////////////////////////////////////////////////////////////////
+    struct ObExprLtOp
+    {
+      static inline bool cmp(const int64_t v1, const int64_t v2) {return v1 < v2;}
+      static inline int calc(const ObExprObj &v1, const ObExprObj &v2, ObExprObj &res) {return v1.lt(v2, res);}
+    };
+    struct ObExprLeOp
+    {
+      static inline bool cmp(const int64_t v1, const int64_t v2) {return v1 <= v2;}
+      static inline int calc(const ObExprObj &v1, const ObExprObj &v2, ObExprObj &res) {return v1.le(v2, res);}
+    };
+    struct ObExprEqOp
+    {
+      static inline bool cmp(const int64_t v1, const int64_t v2) {return v1 == v2;}
+      static inline int calc(const ObExprObj &v1, const ObExprObj &v2, ObExprObj &res) {return v1.eq(v2, res);}
+    };
+    struct ObExprGeOp
+    {
+      static inline bool cmp(const int64_t v1, const int64_t v2) {return v1 >= v2;}
+      static inline int calc(const ObExprObj &v1, const ObExprObj &v2, ObExprObj &res) {return v1.ge(v2, res);}
+    };
+    struct ObExprGtOp
+    {
+      static inline bool cmp(const int64_t v1, const int64_t v2) {return v1 > v2;}
+      static inline int calc(const ObExprObj &v1, const ObExprObj &v2, ObExprObj &res) {return v1.gt(v2, res);}
+    };
+    struct ObExprNeOp
+    {
+      static inline bool cmp(const int64_t v1, const int64_t v2) {return v1 != v2;}
+      static inline int calc(const ObExprObj &v1, const ObExprObj &v2, ObExprObj &res) {return v1.ne(v2, res);}
+    };
+    // overflow is allowed, the same as ObExprObj
+    struct ObExprAddOp
+    {
+      template <typename T>
+      static inline T arith(const T v1, const T v2) {return v1 + v2;}
+      static inline int calc(ObExprObj &v1, ObExprObj &v2, ObExprObj &res) {return v1.add(v2, res);}
+    };
+    struct ObExprSubOp
+    {
+      template <typename T>
+      static inline T arith(const T v1, const T v2) {return v1 - v2;}
+      static inline int calc(ObExprObj &v1, ObExprObj &v2, ObExprObj &res) {return v1.sub(v2, res);}
+    };
+    struct ObExprMulOp
+    {
+      template <typename T>
+      static inline T arith(const T v1, const T v2) {return v1 * v2;}
+      static inline int calc(ObExprObj &v1, ObExprObj &v2, ObExprObj &res) {return v1.mul(v2, res);}
+    };
+
+    // left op right
+    template <typename Op>
+    class ObExprCompareNode: public ObExprNode
+    {
+      public:
+        ObExprCompareNode()
+          :left_(NULL), right_(NULL)
+        {
+        }
+        virtual int eval(const ObRow &row, ObExprObj &result)
+        {
+          int ret = OB_SUCCESS;
+          ObExprObj v1;
+          ObExprObj v2;
+          if (OB_SUCCESS == (ret = left_->eval(row, v1))
+              && OB_SUCCESS == (ret = right_->eval(row, v2)))
+          {
+            if (ObIntType == v1.get_type() && ObIntType == v2.get_type())
+            {
+              result.set_bool(Op::cmp(v1.get_int(), v2.get_int()));
+            }
+            else
+            {
+              Op::calc(v1, v2, result);
+            }
+          }
+          return ret;
+        }
+      public:
+        ObExprNode *left_;
+        ObExprNode *right_;
+    };
+
+    // column op const, the cell is compared without being converted to ObExprObj
+    template <typename Op>
+    class ObExprColumnCompareConstNode: public ObExprNode
+    {
+      public:
+        ObExprColumnCompareConstNode()
+          :column_(NULL), const_(NULL)
+        {
+        }
+        virtual int eval(const ObRow &row, ObExprObj &result)
+        {
+          int ret = OB_SUCCESS;
+          const ObObj *cell = NULL;
+          const ObObj *const_obj = const_->obj_;
+          int64_t v1 = 0;
+          int64_t v2 = 0;
+          if (OB_SUCCESS == (ret = column_->get_cell(row, cell)))
+          {
+            if (ObIntType == cell->get_type() && ObIntType == const_obj->get_type())
+            {
+              cell->get_int(v1);
+              const_obj->get_int(v2);
+              result.set_bool(Op::cmp(v1, v2));
+            }
+            else
+            {
+              ObExprObj expr_v1;
+              ObExprObj expr_v2;
+              expr_v1.assign(*cell);
+              const_->eval(row, expr_v2);
+              Op::calc(expr_v1, expr_v2, result);
+            }
+          }
+          return ret;
+        }
+      public:
+        ObExprColumnNode *column_;
+        ObExprConstNode *const_;
+    };
+
+    template <typename Op>
+    class ObExprArithNode: public ObExprNode
+    {
+      public:
+        ObExprArithNode()
+          :left_(NULL), right_(NULL)
+        {
+        }
+        virtual int eval(const ObRow &row, ObExprObj &result)
+        {
+          int ret = OB_SUCCESS;
+          ObExprObj v1;
+          ObExprObj v2;
+          if (OB_SUCCESS == (ret = left_->eval(row, v1))
+              && OB_SUCCESS == (ret = right_->eval(row, v2)))
+          {
+            const ObObjType type = v1.get_type();
+            if (type != v2.get_type())
+            {
+              Op::calc(v1, v2, result);
+            }
+            else if (ObIntType == type)
+            {
+              result.set_int(Op::arith(v1.get_int(), v2.get_int()));
+            }
+            else if (ObDoubleType == type)
+            {
+              result.set_double(Op::arith(v1.get_double(), v2.get_double()));
+            }
+            else if (ObFloatType == type)
+            {
+              result.set_float(Op::arith(v1.get_float(), v2.get_float()));
+            }
+            else
+            {
+              // decimal etc.
+              Op::calc(v1, v2, result);
+            }
+          }
+          return ret;
+        }
+      public:
+        ObExprNode *left_;
+        ObExprNode *right_;
+    };
+
+    class ObExprDivNode: public ObExprNode
+    {
+      public:
+        ObExprDivNode()
+          :left_(NULL), right_(NULL), int_div_as_double_(NULL)
+        {
+        }
+        virtual int eval(const ObRow &row, ObExprObj &result)
+        {
+          int ret = OB_SUCCESS;
+          ObExprObj v1;
+          ObExprObj v2;
+          if (OB_SUCCESS == (ret = left_->eval(row, v1))
+              && OB_SUCCESS == (ret = right_->eval(row, v2)))
+          {
+            v1.div(v2, result, *int_div_as_double_);
+          }
+          return ret;
+        }
+      public:
+        ObExprNode *left_;
+        ObExprNode *right_;
+        const bool *int_div_as_double_;
+    };
+
+    class ObExprModNode: public ObExprNode
+    {
+      public:
+        ObExprModNode()
+          :left_(NULL), right_(NULL)
+        {
+        }
+        virtual int eval(const ObRow &row, ObExprObj &result)
+        {
+          int ret = OB_SUCCESS;
+          ObExprObj v1;
+          ObExprObj v2;
+          if (OB_SUCCESS == (ret = left_->eval(row, v1))
+              && OB_SUCCESS == (ret = right_->eval(row, v2)))
+          {
+            v1.mod(v2, result);
+          }
+          return ret;
+        }
+      public:
+        ObExprNode *left_;
+        ObExprNode *right_;
+    };
+
+    // FALSE AND x is FALSE, TRUE OR x is TRUE, so the right operand could be skipped
+    class ObExprAndNode: public ObExprNode
+    {
+      public:
+        ObExprAndNode()
+          :left_(NULL), right_(NULL)
+        {
+        }
+        virtual int eval(const ObRow &row, ObExprObj &result)
+        {
+          int ret = OB_SUCCESS;
+          ObExprObj v1;
+          ObExprObj v2;
+          if (OB_SUCCESS != (ret = left_->eval(row, v1)))
+          {
+          }
+          else if (v1.is_false())
+          {
+            result.set_bool(false);
+          }
+          else if (OB_SUCCESS == (ret = right_->eval(row, v2)))
+          {
+            v1.land(v2, result);
+          }
+          return ret;
+        }
+      public:
+        ObExprNode *left_;
+        ObExprNode *right_;
+    };
+
+    class ObExprOrNode: public ObExprNode
+    {
+      public:
+        ObExprOrNode()
+          :left_(NULL), right_(NULL)
+        {
+        }
+        virtual int eval(const ObRow &row, ObExprObj &result)
+        {
+          int ret = OB_SUCCESS;
+          ObExprObj v1;
+          ObExprObj v2;
+          if (OB_SUCCESS != (ret = left_->eval(row, v1)))
+          {
+          }
+          else if (v1.is_true())
+          {
+            result.set_bool(true);
+          }
+          else if (OB_SUCCESS == (ret = right_->eval(row, v2)))
+          {
+            v1.lor(v2, result);
+          }
+          return ret;
+        }
+      public:
+        ObExprNode *left_;
+        ObExprNode *right_;
+    };
+
+    class ObExprNotNode: public ObExprNode
+    {
+      public:
+        ObExprNotNode()
+          :child_(NULL)
+        {
+        }
+        virtual int eval(const ObRow &row, ObExprObj &result)
+        {
+          int ret = OB_SUCCESS;
+          ObExprObj v;
+          if (OB_SUCCESS == (ret = child_->eval(row, v)))
+          {
+            v.lnot(result);
+          }
+          return ret;
+        }
+      public:
+        ObExprNode *child_;
+    };
+
+    // v BETWEEN lower AND upper
+    class ObExprBetweenNode: public ObExprNode
+    {
+      public:
+        ObExprBetweenNode()
+          :value_(NULL), lower_(NULL), upper_(NULL)
+        {
+        }
+        virtual int eval(const ObRow &row, ObExprObj &result)
+        {
+          int ret = OB_SUCCESS;
+          ObExprObj v;
+          ObExprObj lower;
+          ObExprObj upper;
+          if (OB_SUCCESS == (ret = value_->eval(row, v))
+              && OB_SUCCESS == (ret = lower_->eval(row, lower))
+              && OB_SUCCESS == (ret = upper_->eval(row, upper)))
+          {
+            if (ObIntType == v.get_type() && ObIntType == lower.get_type() && ObIntType == upper.get_type())
+            {
+              result.set_bool(lower.get_int() <= v.get_int() && v.get_int() <= upper.get_int());
+            }
+            else
+            {
+              v.btw(lower, upper, result);
+            }
+          }
+          return ret;
+        }
+      public:
+        ObExprNode *value_;
+        ObExprNode *lower_;
+        ObExprNode *upper_;
+    };
+  } // end namespace sql
+} // end namespace oceanbase
+
+ObCompiledExpr::ObCompiledExpr()
+  :state_(NOT_COMPILED),
+   arena_(ARENA_PAGE_SIZE, ModulePageAllocator(ObModIds::OB_SQL_EXPR)),
+   root_(NULL), stack_top_(NULL), stack_size_(0),
+   columns_(NULL), bound_row_desc_(NULL), bound_column_num_(0), bind_ret_(OB_NOT_INIT),
+   int_div_as_double_(false)
+{
+}
+
+ObCompiledExpr::~ObCompiledExpr()
+{
+  reset();
+}
+
+void ObCompiledExpr::reset()
+{
+  state_ = NOT_COMPILED;
+  root_ = NULL;
+  stack_top_ = NULL;
+  stack_size_ = 0;
+  columns_ = NULL;
+  bound_row_desc_ = NULL;
+  bound_column_num_ = 0;
+  bind_ret_ = OB_NOT_INIT;
+  // all the nodes are trivially destructible
+  arena_.free();
+}
+
+void ObCompiledExpr::set_not_supported()
+{
+  reset();
+  state_ = NOT_SUPPORTED;
+}
+
+template <typename T>
+T *ObCompiledExpr::new_node()
+{
+  T *node = NULL;
+  void *ptr = arena_.alloc(sizeof(T));
+  if (NULL == ptr)
+  {
+    TBSYS_LOG(WARN, "no memory");
+  }
+  else
+  {
+    node = new(ptr) T();
+  }
+  return node;
+}
+
+void ObCompiledExpr::push(ObExprNode *node)
+{
+  node->stack_next_ = stack_top_;
+  stack_top_ = node;
+  ++stack_size_;
+}
+
+ObExprNode *ObCompiledExpr::pop()
+{
+  ObExprNode *node = stack_top_;
+  stack_top_ = node->stack_next_;
+  node->stack_next_ = NULL;
+  --stack_size_;
+  return node;
+}
+
+int ObCompiledExpr::add_column(const uint64_t table_id, const uint64_t column_id)
+{
+  int ret = OB_SUCCESS;
+  ObExprColumnNode *node = NULL;
+  if (NOT_COMPILED != state_)
+  {
+    ret = OB_NOT_SUPPORTED;
+  }
+  else if (NULL == (node = new_node<ObExprColumnNode>()))
+  {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else
+  {
+    node->table_id_ = table_id;
+    node->column_id_ = column_id;
+    node->next_column_ = columns_;
+    columns_ = node;
+    push(node);
+  }
+  if (OB_SUCCESS != ret)
+  {
+    set_not_supported();
+    ret = OB_NOT_SUPPORTED;
+  }
+  return ret;
+}
+
+int ObCompiledExpr::add_const(const ObObj &obj)
+{
+  int ret = OB_SUCCESS;
+  ObExprConstNode *node = NULL;
+  if (NOT_COMPILED != state_)
+  {
+    ret = OB_NOT_SUPPORTED;
+  }
+  else if (NULL == (node = new_node<ObExprConstNode>()))
+  {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else
+  {
+    node->set_obj(obj);
+    push(node);
+  }
+  if (OB_SUCCESS != ret)
+  {
+    set_not_supported();
+    ret = OB_NOT_SUPPORTED;
+  }
+  return ret;
+}
+
+template <typename Op>
+int ObCompiledExpr::new_compare_node(ObExprNode *left, ObExprNode *right, ObExprNode *&node)
+{
+  int ret = OB_SUCCESS;
+  if (ObExprNode::COLUMN_NODE == left->node_type_
+      && ObExprNode::CONST_NODE == right->node_type_)
+  {
+    ObExprColumnCompareConstNode<Op> *cmp_node = new_node<ObExprColumnCompareConstNode<Op> >();
+    if (NULL == cmp_node)
+    {
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+    }
+    else
+    {
+      cmp_node->column_ = static_cast<ObExprColumnNode*>(left);
+      cmp_node->const_ = static_cast<ObExprConstNode*>(right);
+      node = cmp_node;
+    }
+  }
+  else
+  {
+    ObExprCompareNode<Op> *cmp_node = new_node<ObExprCompareNode<Op> >();
+    if (NULL == cmp_node)
+    {
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+    }
+    else
+    {
+      cmp_node->left_ = left;
+      cmp_node->right_ = right;
+      node = cmp_node;
+    }
+  }
+  return ret;
+}
+
+template <typename Op>
+int ObCompiledExpr::new_arith_node(ObExprNode *left, ObExprNode *right, ObExprNode *&node)
+{
+  int ret = OB_SUCCESS;
+  ObExprArithNode<Op> *arith_node = new_node<ObExprArithNode<Op> >();
+  if (NULL == arith_node)
+  {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else
+  {
+    arith_node->left_ = left;
+    arith_node->right_ = right;
+    node = arith_node;
+  }
+  return ret;
+}
+
+int ObCompiledExpr::add_op(const ObItemType op_type, const int64_t param_count)
+{
+  int ret = OB_SUCCESS;
+  int64_t expected_param_count = 2;
+  switch(op_type)
+  {
+    case T_OP_NOT:
+      expected_param_count = 1;
+      break;
+    case T_OP_BTW:
+      expected_param_count = 3;
+      break;
+    case T_OP_ADD:
+    case T_OP_MINUS:
+    case T_OP_MUL:
+    case T_OP_DIV:
+    case T_OP_REM:
+    case T_OP_MOD:
+    case T_OP_LE:
+    case T_OP_LT:
+    case T_OP_EQ:
+    case T_OP_GE:
+    case T_OP_GT:
+    case T_OP_NE:
+    case T_OP_AND:
+    case T_OP_OR:
+      break;
+    default:
+      ret = OB_NOT_SUPPORTED;
+      break;
+  }
+  if (OB_SUCCESS != ret)
+  {
+  }
+  else if (NOT_COMPILED != state_
+           || expected_param_count != param_count
+           || stack_size_ < param_count)
+  {
+    ret = OB_NOT_SUPPORTED;
+  }
+  else
+  {
+    ObExprNode *node = NULL;
+    ObExprNode *right = pop();
+    ObExprNode *left = NULL;
+    switch(op_type)
+    {
+      case T_OP_NOT:
+      {
+        ObExprNotNode *not_node = new_node<ObExprNotNode>();
+        if (NULL != not_node)
+        {
+          not_node->child_ = right;
+          node = not_node;
+        }
+        break;
+      }
+      case T_OP_BTW:
+      {
+        ObExprBetweenNode *btw_node = new_node<ObExprBetweenNode>();
+        if (NULL != btw_node)
+        {
+          btw_node->upper_ = right;
+          btw_node->lower_ = pop();
+          btw_node->value_ = pop();
+          node = btw_node;
+        }
+        break;
+      }
+      default:
+        left = pop();
+        break;
+    }
+    switch(op_type)
+    {
+      case T_OP_LT:
+        ret = new_compare_node<ObExprLtOp>(left, right, node);
+        break;
+      case T_OP_LE:
+        ret = new_compare_node<ObExprLeOp>(left, right, node);
+        break;
+      case T_OP_EQ:
+        ret = new_compare_node<ObExprEqOp>(left, right, node);
+        break;
+      case T_OP_GE:
+        ret = new_compare_node<ObExprGeOp>(left, right, node);
+        break;
+      case T_OP_GT:
+        ret = new_compare_node<ObExprGtOp>(left, right, node);
+        break;
+      case T_OP_NE:
+        ret = new_compare_node<ObExprNeOp>(left, right, node);
+        break;
+      case T_OP_ADD:
+        ret = new_arith_node<ObExprAddOp>(left, right, node);
+        break;
+      case T_OP_MINUS:
+        ret = new_arith_node<ObExprSubOp>(left, right, node);
+        break;
+      case T_OP_MUL:
+        ret = new_arith_node<ObExprMulOp>(left, right, node);
+        break;
+      case T_OP_DIV:
+      {
+        ObExprDivNode *div_node = new_node<ObExprDivNode>();
+        if (NULL != div_node)
+        {
+          div_node->left_ = left;
+          div_node->right_ = right;
+          div_node->int_div_as_double_ = &int_div_as_double_;
+          node = div_node;
+        }
+        break;
+      }
+      case T_OP_REM:
+      case T_OP_MOD:
+      {
+        ObExprModNode *mod_node = new_node<ObExprModNode>();
+        if (NULL != mod_node)
+        {
+          mod_node->left_ = left;
+          mod_node->right_ = right;
+          node = mod_node;
+        }
+        break;
+      }
+      case T_OP_AND:
+      {
+        ObExprAndNode *and_node = new_node<ObExprAndNode>();
+        if (NULL != and_node)
+        {
+          and_node->left_ = left;
+          and_node->right_ = right;
+          node = and_node;
+        }
+        break;
+      }
+      case T_OP_OR:
+      {
+        ObExprOrNode *or_node = new_node<ObExprOrNode>();
+        if (NULL != or_node)
+        {
+          or_node->left_ = left;
+          or_node->right_ = right;
+          node = or_node;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    if (OB_SUCCESS == ret && NULL == node)
+    {
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+    }
+    if (OB_SUCCESS == ret)
+    {
+      push(node);
+    }
+  }
+  if (OB_SUCCESS != ret)
+  {
+    set_not_supported();
+    ret = OB_NOT_SUPPORTED;
+  }
+  return ret;
+}
+
+int ObCompiledExpr::end()
+{
+  int ret = OB_SUCCESS;
+  if (NOT_COMPILED != state_ || 1 != stack_size_)
+  {
+    set_not_supported();
+    ret = OB_NOT_SUPPORTED;
+  }
+  else
+  {
+    root_ = pop();
+    state_ = COMPILED;
+  }
+  return ret;
+}
+
+int ObCompiledExpr::bind(const ObRowDesc *row_desc)
+{
+  int ret = OB_SUCCESS;
+  if (NULL == row_desc)
+  {
+    ret = OB_NOT_SUPPORTED;
+  }
+  else
+  {
+    for (ObExprColumnNode *column = columns_; NULL != column; column = column->next_column_)
+    {
+      if (OB_INVALID_INDEX == (column->cell_idx_ = row_desc->get_idx(column->table_id_, column->column_id_)))
+      {
+        ret = OB_NOT_SUPPORTED;
+        break;
+      }
+    }
+  }
+  // remember the result so that a failed binding is not retried for every row
+  bound_row_desc_ = row_desc;
+  bound_column_num_ = (NULL == row_desc) ? 0 : row_desc->get_column_num();
+  bind_ret_ = ret;
+  return ret;
+}
+
+bool ObCompiledExpr::is_bound(const ObRowDesc *row_desc) const
+{
+  bool bret = (NULL != row_desc
+               && OB_NOT_INIT != bind_ret_
+               && bound_column_num_ == row_desc->get_column_num());
+  if (!bret)
+  {
+  }
+  else if (OB_SUCCESS != bind_ret_)
+  {
+    // a failed binding has no cell index to check, the interpreter gives the
+    // right result anyway
+    bret = (row_desc == bound_row_desc_);
+  }
+  else
+  {
+    // the row desc may be another object or changed in place, the binding is
+    // kept as long as every column is still at its cell index
+    uint64_t table_id = OB_INVALID_ID;
+    uint64_t column_id = OB_INVALID_ID;
+    for (ObExprColumnNode *column = columns_; bret && NULL != column; column = column->next_column_)
+    {
+      bret = (OB_SUCCESS == row_desc->get_tid_cid(column->cell_idx_, table_id, column_id)
+              && column->table_id_ == table_id
+              && column->column_id_ == column_id);
+    }
+  }
+  return bret;
+}
+
+int ObCompiledExpr::calc(const ObRow &row, const bool int_div_as_double, ObExprObj &result)
+{
+  int ret = OB_SUCCESS;
+  const ObRowDesc *row_desc = row.get_row_desc();
+  if (OB_UNLIKELY(COMPILED != state_))
+  {
+    ret = OB_NOT_SUPPORTED;
+  }
+  else if (NULL != columns_
+           && OB_SUCCESS != (ret = (OB_LIKELY(is_bound(row_desc)) ? bind_ret_ : bind(row_desc))))
+  {
+    // some columns are not in the row, let the interpreter report the error
+  }
+  else
+  {
+    int_div_as_double_ = int_div_as_double;
+    ret = root_->eval(row, result);
+  }
+  return ret;
+}
@@ -0,0 +1,112 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_compiled_expr.h
+ *
+ */
+#ifndef _OB_COMPILED_EXPR_H
+#define _OB_COMPILED_EXPR_H 1
+#include "ob_item_type.h"
+#include "common/ob_row.h"
+#include "common/ob_row_desc.h"
+#include "common/ob_expr_obj.h"
+#include "common/page_arena.h"
+
+namespace oceanbase
+{
+  namespace sql
+  {
+    class ObExprNode;
+    class ObExprColumnNode;
+
+    // 后缀表达式的编译结果：把常见形式的表达式转换成一棵预先解析好的求值树，避免逐行解释执行
+    // 1. 列引用在第一次求值时(以及row desc的列布局变化时)解析成cell下标，之后按下标直接取cell
+    // 2. 比较和算术运算按运算符实例化成模板类；两个操作数都是int(或同为float/double)时直接计算，
+    //    其余情况调用ObExprObj的通用实现，保证结果与ObPostfixExpression解释执行的结果一致
+    // 3. 列与常量的比较单独实例化，不需要把cell先转换成ObExprObj
+    // 4. AND/OR短路求值
+    // 只支持列、常量、比较、AND/OR/NOT、BETWEEN和四则运算；含其他运算符的表达式返回OB_NOT_SUPPORTED，
+    // 由ObPostfixExpression解释执行
+    class ObCompiledExpr
+    {
+      public:
+        enum State
+        {
+          NOT_COMPILED = 0,
+          COMPILED,
+          NOT_SUPPORTED
+        };
+      public:
+        ObCompiledExpr();
+        ~ObCompiledExpr();
+        /// drop the compiled tree
+        void reset();
+        State get_state() const;
+        bool is_compiled() const;
+        /// drop the compiled tree and never compile again until reset()
+        void set_not_supported();
+
+        /**
+         * 按后缀表达式的顺序添加操作数和运算符，最后调用end()
+         * 任何一步返回OB_NOT_SUPPORTED后，状态变为NOT_SUPPORTED
+         * @note 常量obj的内存必须在编译结果被reset()之前一直有效
+         */
+        int add_column(const uint64_t table_id, const uint64_t column_id);
+        int add_const(const common::ObObj &obj);
+        int add_op(const ObItemType op_type, const int64_t param_count);
+        int end();
+
+        /**
+         * 对row求值
+         * @return OB_SUCCESS；其他返回值(如row中找不到某些列)表示应由调用者解释执行
+         */
+        int calc(const common::ObRow &row, const bool int_div_as_double, common::ObExprObj &result);
+      private:
+        // disallow copy
+        ObCompiledExpr(const ObCompiledExpr &other);
+        ObCompiledExpr& operator=(const ObCompiledExpr &other);
+        // function members
+        int bind(const common::ObRowDesc *row_desc);
+        bool is_bound(const common::ObRowDesc *row_desc) const;
+        void push(ObExprNode *node);
+        ObExprNode *pop();
+        template <typename Op>
+        int new_compare_node(ObExprNode *left, ObExprNode *right, ObExprNode *&node);
+        template <typename Op>
+        int new_arith_node(ObExprNode *left, ObExprNode *right, ObExprNode *&node);
+        template <typename T>
+        T *new_node();
+      private:
+        static const int64_t ARENA_PAGE_SIZE = 4 * 1024L;
+        // data members
+        State state_;
+        common::ModuleArena arena_;
+        ObExprNode *root_;
+        ObExprNode *stack_top_;                 // operands while compiling
+        int64_t stack_size_;
+        ObExprColumnNode *columns_;             // all the column references
+        const common::ObRowDesc *bound_row_desc_;
+        int64_t bound_column_num_;
+        int bind_ret_;
+        bool int_div_as_double_;
+    };
+
+    inline ObCompiledExpr::State ObCompiledExpr::get_state() const
+    {
+      return state_;
+    }
+
+    inline bool ObCompiledExpr::is_compiled() const
+    {
+      return COMPILED == state_;
+    }
+  } // end namespace sql
+} // end namespace oceanbase
+
+#endif /* _OB_COMPILED_EXPR_H */
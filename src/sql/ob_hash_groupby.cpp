@@ -14,51 +14,736 @@
  *
  */
 #include "ob_hash_groupby.h"
+#include "ob_physical_plan.h"
+#include "common/ob_row_util.h"
+#include "common/utility.h"
+#include <sys/stat.h>
 using namespace oceanbase::sql;
-/*
-int ObHashGroupBy::open()
+using namespace oceanbase::common;
+using namespace oceanbase::common::serialization;
+
+ObHashGroupBy::ObHashGroupBy()
+  :bucket_num_(DEFAULT_BUCKET_NUM), bucket_row_count_(0), has_dumped_(false),
+   next_run_bucket_idx_(0), curr_rows_(NULL), curr_bucket_idx_(-1), curr_group_idx_(0), child_row_desc_(NULL)
+{
+  memset(bucket_dumped_, 0, sizeof(bucket_dumped_));
+  run_filename_buf_[0] = '\0';
+}
+
+ObHashGroupBy::~ObHashGroupBy()
 {
-  构造row_desc_;
-  // 从子运算符读取所有数据，插入桶中
-  child_op_->open();
-  const common::ObRow *row = NULL;
-  for(child_op_->get_next_row(row))
+  child_row_desc_ = NULL;
+}
+
+void ObHashGroupBy::reset()
+{
+  ObGroupBy::reset();
+  aggr_func_.reset();
+  free_run_file();
+  row_store_.clear();
+  for (int64_t i = 0; i < MAX_BUCKET_NUM; ++i)
   {
-    根据groupby列计算row归属的hash桶ID;
-    add_to_backet(backet_idx, row);
+    bucket_rows_[i].clear();
   }
-  child_op_->close();
-  for(每个桶)
+  bucket_row_count_ = 0;
+  memset(bucket_dumped_, 0, sizeof(bucket_dumped_));
+  has_dumped_ = false;
+  pending_buckets_.clear();
+  next_run_bucket_idx_ = 0;
+  loaded_rows_.clear();
+  curr_rows_ = NULL;
+  bucket_num_ = DEFAULT_BUCKET_NUM;
+  run_filename_buf_[0] = '\0';
+  run_filename_.assign_ptr(NULL, 0);
+  group_chains_.clear();
+  next_in_group_.clear();
+  curr_bucket_idx_ = -1;
+  curr_group_idx_ = 0;
+  child_row_desc_ = NULL;
+}
+
+int ObHashGroupBy::set_bucket_num(const int64_t bucket_num)
+{
+  int ret = OB_SUCCESS;
+  if (0 >= bucket_num || MAX_BUCKET_NUM < bucket_num)
+  {
+    TBSYS_LOG(WARN, "invalid bucket num=%ld max=%ld", bucket_num, MAX_BUCKET_NUM);
+    ret = OB_INVALID_ARGUMENT;
+  }
+  else
   {
-    根据groupby列排序这个桶的内容，如果必要使用外排。
+    bucket_num_ = bucket_num;
   }
+  return ret;
 }
 
-int ObHashGroupBy::add_to_backet(const int64_t backet_idx, const common::ObRow* row)
+int ObHashGroupBy::set_run_filename(const common::ObString &filename)
 {
-  把row写入第backet_idx个桶中;  // 内存存储结构同ObSort，采用common::ObRow和ObCompactRow结合的方式
-  if (第backet_idx个桶大小超过backet_mem_size)
+  int ret = OB_SUCCESS;
+  if (filename.length() >= OB_MAX_FILE_NAME_LENGTH)
+  {
+    TBSYS_LOG(ERROR, "filename is too long, filename=%.*s", filename.length(), filename.ptr());
+    ret = OB_BUF_NOT_ENOUGH;
+  }
+  else
   {
-    dump这个桶到磁盘;
+    TBSYS_LOG(INFO, "hash groupby run file=%.*s", filename.length(), filename.ptr());
+    snprintf(run_filename_buf_, OB_MAX_FILE_NAME_LENGTH, "%.*s", filename.length(), filename.ptr());
+    run_filename_.assign_ptr(run_filename_buf_, filename.length());
   }
+  return ret;
+}
+
+int ObHashGroupBy::open()
+{
+  int ret = OB_SUCCESS;
+  child_row_desc_ = NULL;
+  if (OB_SUCCESS != (ret = ObGroupBy::open()))
+  {
+    TBSYS_LOG(WARN, "failed to open child op, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = child_op_->get_row_desc(child_row_desc_)))
+  {
+    TBSYS_LOG(WARN, "failed to get child row desc, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = aggr_func_.init(*child_row_desc_, aggr_columns_)))
+  {
+    TBSYS_LOG(WARN, "failed to construct row desc, err=%d", ret);
+  }
+  else if (!group_map_.created()
+           && OB_SUCCESS != (ret = group_map_.create(GROUP_HASH_MAP_SIZE)))
+  {
+    TBSYS_LOG(WARN, "failed to create group hash map, err=%d", ret);
+  }
+  else
+  {
+    // the group columns are kept as reserved cells of every stored row,
+    // so that they could be hashed and compared without decoding the row
+    for (int64_t i = 0; i < group_columns_.count(); ++i)
+    {
+      const ObGroupColumn &group_col = group_columns_.at(i);
+      if (OB_SUCCESS != (ret = row_store_.add_reserved_column(group_col.table_id_, group_col.column_id_)))
+      {
+        TBSYS_LOG(WARN, "failed to add reserved column, err=%d", ret);
+        break;
+      }
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    curr_bucket_idx_ = -1;
+    curr_group_idx_ = 0;
+    curr_rows_ = NULL;
+    group_chains_.clear();
+    next_in_group_.clear();
+    if (OB_SUCCESS != (ret = consume_input()))
+    {
+      TBSYS_LOG(WARN, "failed to consume input rows, err=%d", ret);
+    }
+  }
+  return ret;
 }
 
 int ObHashGroupBy::close()
 {
-  释放内存等资源;
+  int ret = OB_SUCCESS;
+  free_run_file();
+  row_store_.clear();
+  for (int64_t i = 0; i < bucket_num_; ++i)
+  {
+    bucket_rows_[i].clear();
+  }
+  bucket_row_count_ = 0;
+  memset(bucket_dumped_, 0, sizeof(bucket_dumped_));
+  has_dumped_ = false;
+  pending_buckets_.clear();
+  next_run_bucket_idx_ = 0;
+  loaded_rows_.clear();
+  curr_rows_ = NULL;
+  group_map_.clear();
+  group_chains_.clear();
+  next_in_group_.clear();
+  curr_bucket_idx_ = -1;
+  curr_group_idx_ = 0;
+  child_row_desc_ = NULL;
+  aggr_func_.destroy();
+  ret = ObGroupBy::close();
+  return ret;
+}
+
+void ObHashGroupBy::free_run_file()
+{
+  int ret = OB_SUCCESS;
+  if (run_file_.is_opened())
+  {
+    if (OB_SUCCESS != (ret = run_file_.close()))
+    {
+      TBSYS_LOG(WARN, "failed to close run file, err=%d", ret);
+    }
+    struct stat stat_buf;
+    if (0 == stat(run_filename_buf_, &stat_buf))
+    {
+      if (0 != unlink(run_filename_buf_))
+      {
+        TBSYS_LOG(WARN, "failed to remove tmp run file, err=%s", strerror(errno));
+      }
+    }
+  }
+}
+
+int ObHashGroupBy::get_row_desc(const common::ObRowDesc *&row_desc) const
+{
+  const ObRowDesc &r = aggr_func_.get_row_desc();
+  int ret = OB_SUCCESS;
+  if (OB_UNLIKELY(0 >= r.get_column_num()))
+  {
+    TBSYS_LOG(ERROR, "not init");
+    ret = OB_NOT_INIT;
+  }
+  else
+  {
+    row_desc = &r;
+  }
+  return ret;
+}
+
+int ObHashGroupBy::consume_input()
+{
+  int ret = OB_SUCCESS;
+  const ObRow *input_row = NULL;
+  // the buckets of the input rows take [0, bucket_num_) of the run file
+  next_run_bucket_idx_ = bucket_num_;
+  while (OB_SUCCESS == ret
+         && OB_SUCCESS == (ret = child_op_->get_next_row(input_row)))
+  {
+    if (OB_SUCCESS != (ret = add_input_row(*input_row, 0)))
+    {
+      TBSYS_LOG(WARN, "failed to add row into bucket, err=%d", ret);
+    }
+    else if (need_dump())
+    {
+      if (OB_SUCCESS != (ret = dump_buckets(0)))
+      {
+        TBSYS_LOG(WARN, "failed to dump buckets, err=%d", ret);
+      }
+    }
+  } // end while
+  if (OB_ITER_END == ret)
+  {
+    ret = OB_SUCCESS;
+  }
+  // once some rows were dumped, every bucket is read back from the run file
+  // one by one, and those still too large are repartitioned when loading
+  if (OB_SUCCESS == ret && has_dumped_)
+  {
+    if (!row_store_.is_empty()
+        && OB_SUCCESS != (ret = dump_buckets(0)))
+    {
+      TBSYS_LOG(WARN, "failed to dump the last rows, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = push_dumped_buckets(0, 0)))
+    {
+      TBSYS_LOG(WARN, "failed to push dumped buckets, err=%d", ret);
+    }
+  }
+  return ret;
+}
+
+// every level of repartitioning hashes the group columns with a different seed
+inline int64_t ObHashGroupBy::get_bucket_idx(const ObRowStore::StoredRow *stored_row, const int64_t level) const
+{
+  ObRowkey group_key(const_cast<ObObj*>(stored_row->reserved_cells_), stored_row->reserved_cells_count_);
+  uint32_t hash_val = group_key.murmurhash2(BUCKET_HASH_SEED + static_cast<uint32_t>(level));
+  return hash_val % bucket_num_;
+}
+
+int ObHashGroupBy::add_input_row(const common::ObRow &row, const int64_t level)
+{
+  int ret = OB_SUCCESS;
+  const ObRowStore::StoredRow *stored_row = NULL;
+  if (OB_SUCCESS != (ret = row_store_.add_row(row, stored_row)))
+  {
+    TBSYS_LOG(WARN, "failed to add row into row_store, err=%d", ret);
+  }
+  else
+  {
+    if (OB_SUCCESS != (ret = bucket_rows_[get_bucket_idx(stored_row, level)].push_back(stored_row)))
+    {
+      TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+    }
+    else
+    {
+      ++bucket_row_count_;
+    }
+  }
+  return ret;
+}
+
+inline bool ObHashGroupBy::need_dump() const
+{
+  bool ret = false;
+  if (0 < mem_size_limit_ && 0 < run_filename_.length())
+  {
+    int64_t used_mem_size = row_store_.get_used_mem_size()
+      + (loaded_rows_.count() + bucket_row_count_) * static_cast<int64_t>(sizeof(void*));
+    ret = (used_mem_size >= mem_size_limit_);
+  }
+  return ret;
+}
+
+int ObHashGroupBy::dump_buckets(const int64_t run_bucket_base)
+{
+  int ret = OB_SUCCESS;
+  if (!run_file_.is_opened())
+  {
+    if (OB_SUCCESS != (ret = run_file_.open(run_filename_)))
+    {
+      TBSYS_LOG(WARN, "failed to open run file, err=%d filename=%.*s",
+                ret, run_filename_.length(), run_filename_.ptr());
+    }
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < bucket_num_; ++i)
+  {
+    BucketRows &rows = bucket_rows_[i];
+    if (0 < rows.count())
+    {
+      if (OB_SUCCESS != (ret = run_file_.begin_append_run(run_bucket_base + i)))
+      {
+        TBSYS_LOG(WARN, "failed to begin dump run, err=%d bucket=%ld", ret, run_bucket_base + i);
+      }
+      else
+      {
+        for (int64_t j = 0; j < rows.count(); ++j)
+        {
+          if (OB_SUCCESS != (ret = run_file_.append_row(rows.at(j)->get_compact_row())))
+          {
+            TBSYS_LOG(WARN, "failed to append row, err=%d", ret);
+            break;
+          }
+        }
+        if (OB_SUCCESS == ret)
+        {
+          if (OB_SUCCESS != (ret = run_file_.end_append_run()))
+          {
+            TBSYS_LOG(WARN, "failed to end dump run, err=%d", ret);
+          }
+          else
+          {
+            TBSYS_LOG(INFO, "dump bucket run, bucket=%ld row_count=%ld", run_bucket_base + i, rows.count());
+            bucket_dumped_[i] = true;
+            bucket_row_count_ -= rows.count();
+            rows.clear();
+          }
+        }
+      }
+    }
+  } // end for
+  if (OB_SUCCESS == ret)
+  {
+    row_store_.clear_rows();
+    has_dumped_ = true;
+  }
+  return ret;
+}
+
+// the buckets are pushed in the reverse order so that they are popped in order
+int ObHashGroupBy::push_dumped_buckets(const int64_t run_bucket_base, const int64_t level)
+{
+  int ret = OB_SUCCESS;
+  for (int64_t i = bucket_num_ - 1; OB_SUCCESS == ret && 0 <= i; --i)
+  {
+    if (bucket_dumped_[i])
+    {
+      DumpedBucket bucket;
+      bucket.run_bucket_idx_ = run_bucket_base + i;
+      bucket.level_ = level;
+      if (OB_SUCCESS != (ret = pending_buckets_.push_back(bucket)))
+      {
+        TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+      }
+    }
+  } // end for
+  memset(bucket_dumped_, 0, sizeof(bucket_dumped_));
+  return ret;
+}
+
+// @return OB_ITER_END when all the buckets have been aggregated
+int ObHashGroupBy::next_bucket()
+{
+  int ret = OB_SUCCESS;
+  if (!has_dumped_)
+  {
+    // all the buckets are in memory
+    if (curr_bucket_idx_ + 1 >= bucket_num_)
+    {
+      curr_bucket_idx_ = bucket_num_;
+      ret = OB_ITER_END;
+    }
+    else
+    {
+      ++curr_bucket_idx_;
+      curr_rows_ = &bucket_rows_[curr_bucket_idx_];
+    }
+  }
+  else
+  {
+    bool loaded = false;
+    DumpedBucket bucket;
+    while (OB_SUCCESS == ret && !loaded)
+    {
+      if (0 >= pending_buckets_.count())
+      {
+        ret = OB_ITER_END;
+      }
+      else if (OB_SUCCESS != (ret = pending_buckets_.pop_back(bucket)))
+      {
+        TBSYS_LOG(WARN, "failed to pop dumped bucket, err=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = load_bucket(bucket, loaded)))
+      {
+        TBSYS_LOG(WARN, "failed to load bucket, err=%d bucket=%ld", ret, bucket.run_bucket_idx_);
+      }
+      else
+      {
+        curr_bucket_idx_ = bucket.run_bucket_idx_;
+        curr_rows_ = &loaded_rows_;
+      }
+    } // end while
+  }
+  return ret;
+}
+
+// read a dumped bucket back into memory; if it still exceeds the mem limit,
+// split its rows into the sub-buckets of the next level and dump them again,
+// in which case loaded is false and the sub-buckets are pushed as pending
+int ObHashGroupBy::load_bucket(const DumpedBucket &bucket, bool &loaded)
+{
+  int ret = OB_SUCCESS;
+  int64_t run_count = 0;
+  int64_t row_count = 0;
+  bool repartitioned = false;
+  int64_t run_bucket_base = 0;
+  const int64_t next_level = bucket.level_ + 1;
+  const ObRowStore::StoredRow *stored_row = NULL;
+  loaded = false;
+  // rows of the previous bucket are no longer needed
+  loaded_rows_.clear();
+  row_store_.clear_rows();
+  OB_ASSERT(child_row_desc_);
+  curr_input_row_.set_row_desc(*child_row_desc_);
+  if (OB_SUCCESS != (ret = run_file_.begin_read_bucket(bucket.run_bucket_idx_, run_count)))
+  {
+    TBSYS_LOG(WARN, "failed to begin to read bucket, err=%d bucket=%ld", ret, bucket.run_bucket_idx_);
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < run_count; ++i)
+  {
+    while (OB_SUCCESS == (ret = run_file_.get_next_row(i, curr_input_row_)))
+    {
+      ++row_count;
+      if (repartitioned)
+      {
+        if (OB_SUCCESS != (ret = add_input_row(curr_input_row_, next_level)))
+        {
+          TBSYS_LOG(WARN, "failed to add row into bucket, err=%d", ret);
+        }
+        else if (need_dump() && OB_SUCCESS != (ret = dump_buckets(run_bucket_base)))
+        {
+          TBSYS_LOG(WARN, "failed to dump buckets, err=%d", ret);
+        }
+      }
+      else if (OB_SUCCESS != (ret = row_store_.add_row(curr_input_row_, stored_row)))
+      {
+        TBSYS_LOG(WARN, "failed to add row into row_store, err=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = loaded_rows_.push_back(stored_row)))
+      {
+        TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+      }
+      else if (need_dump())
+      {
+        if (MAX_REPARTITION_LEVEL <= bucket.level_)
+        {
+          // most probably one huge group, which could not be split any more
+          TBSYS_LOG(DEBUG, "bucket exceeds the mem limit, bucket=%ld level=%ld",
+                    bucket.run_bucket_idx_, bucket.level_);
+        }
+        else
+        {
+          repartitioned = true;
+          run_bucket_base = next_run_bucket_idx_;
+          next_run_bucket_idx_ += bucket_num_;
+          for (int64_t j = 0; OB_SUCCESS == ret && j < loaded_rows_.count(); ++j)
+          {
+            stored_row = loaded_rows_.at(j);
+            if (OB_SUCCESS != (ret = bucket_rows_[get_bucket_idx(stored_row, next_level)].push_back(stored_row)))
+            {
+              TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+            }
+            else
+            {
+              ++bucket_row_count_;
+            }
+          }
+          loaded_rows_.clear();
+          if (OB_SUCCESS == ret && OB_SUCCESS != (ret = dump_buckets(run_bucket_base)))
+          {
+            TBSYS_LOG(WARN, "failed to dump buckets, err=%d", ret);
+          }
+        }
+      }
+      if (OB_SUCCESS != ret)
+      {
+        break;
+      }
+    } // end while
+    if (OB_ITER_END == ret)
+    {
+      ret = OB_SUCCESS;
+    }
+    else if (OB_SUCCESS != ret)
+    {
+      TBSYS_LOG(WARN, "failed to read run, err=%d bucket=%ld run_idx=%ld", ret, bucket.run_bucket_idx_, i);
+    }
+  } // end for
+  if (OB_SUCCESS == ret)
+  {
+    if (OB_SUCCESS != (ret = run_file_.end_read_bucket()))
+    {
+      TBSYS_LOG(WARN, "failed to end read bucket, err=%d", ret);
+    }
+    else if (!repartitioned)
+    {
+      loaded = true;
+      TBSYS_LOG(INFO, "load bucket, bucket=%ld run_count=%ld row_count=%ld",
+                bucket.run_bucket_idx_, run_count, row_count);
+    }
+    else if (!row_store_.is_empty() && OB_SUCCESS != (ret = dump_buckets(run_bucket_base)))
+    {
+      TBSYS_LOG(WARN, "failed to dump the last rows, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = push_dumped_buckets(run_bucket_base, next_level)))
+    {
+      TBSYS_LOG(WARN, "failed to push dumped buckets, err=%d", ret);
+    }
+    else
+    {
+      TBSYS_LOG(INFO, "repartition bucket, bucket=%ld level=%ld row_count=%ld",
+                bucket.run_bucket_idx_, next_level, row_count);
+    }
+  }
+  return ret;
+}
+
+// chain the rows of the same group together, keeping the order of their first appearance
+int ObHashGroupBy::build_group_chains()
+{
+  int ret = OB_SUCCESS;
+  const BucketRows &rows = *curr_rows_;
+  group_map_.clear();
+  group_chains_.clear();
+  next_in_group_.clear();
+  curr_group_idx_ = 0;
+  for (int64_t i = 0; OB_SUCCESS == ret && i < rows.count(); ++i)
+  {
+    const ObRowStore::StoredRow *stored_row = rows.at(i);
+    ObRowkey group_key(const_cast<ObObj*>(stored_row->reserved_cells_), stored_row->reserved_cells_count_);
+    int64_t group_idx = -1;
+    int hash_ret = group_map_.get(group_key, group_idx);
+    if (OB_SUCCESS != (ret = next_in_group_.push_back(-1)))
+    {
+      TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+    }
+    else if (hash::HASH_EXIST == hash_ret)
+    {
+      GroupChain &chain = group_chains_.at(group_idx);
+      next_in_group_.at(chain.tail_) = i;
+      chain.tail_ = i;
+    }
+    else if (hash::HASH_NOT_EXIST == hash_ret)
+    {
+      GroupChain chain;
+      chain.head_ = i;
+      chain.tail_ = i;
+      if (OB_SUCCESS != (ret = group_chains_.push_back(chain)))
+      {
+        TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+      }
+      else if (hash::HASH_INSERT_SUCC != (hash_ret = group_map_.set(group_key, group_chains_.count() - 1)))
+      {
+        TBSYS_LOG(WARN, "failed to insert group into hash map, hash_ret=%d", hash_ret);
+        ret = OB_ERROR;
+      }
+    }
+    else
+    {
+      TBSYS_LOG(WARN, "failed to get group from hash map, hash_ret=%d", hash_ret);
+      ret = OB_ERROR;
+    }
+  } // end for
+  if (OB_SUCCESS == ret && 0 < rows.count())
+  {
+    TBSYS_LOG(DEBUG, "build group chains, bucket=%ld row_count=%ld group_count=%ld",
+              curr_bucket_idx_, rows.count(), group_chains_.count());
+  }
+  return ret;
+}
+
+inline int ObHashGroupBy::convert_stored_row(const ObRowStore::StoredRow *stored_row)
+{
+  int ret = OB_SUCCESS;
+  curr_input_row_.set_row_desc(*child_row_desc_);
+  if (OB_SUCCESS != (ret = ObRowUtil::convert(stored_row->get_compact_row(), curr_input_row_)))
+  {
+    TBSYS_LOG(WARN, "failed to convert row, err=%d", ret);
+  }
+  return ret;
+}
+
+int ObHashGroupBy::aggregate_group(const GroupChain &chain, const common::ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  const BucketRows &rows = *curr_rows_;
+  int64_t row_idx = chain.head_;
+  if (OB_SUCCESS != (ret = convert_stored_row(rows.at(row_idx))))
+  {
+    TBSYS_LOG(WARN, "failed to convert the first row of the group, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = aggr_func_.prepare(curr_input_row_))) // the first row of this group
+  {
+    TBSYS_LOG(WARN, "failed to init aggr cells, err=%d", ret);
+  }
+  else
+  {
+    row_idx = next_in_group_.at(row_idx);
+    while (0 <= row_idx)
+    {
+      if (OB_SUCCESS != (ret = convert_stored_row(rows.at(row_idx))))
+      {
+        break;
+      }
+      else if (OB_SUCCESS != (ret = aggr_func_.process(curr_input_row_)))
+      {
+        TBSYS_LOG(WARN, "failed to calc aggr, err=%d", ret);
+        break;
+      }
+      row_idx = next_in_group_.at(row_idx);
+    } // end while
+  }
+  if (OB_SUCCESS == ret)
+  {
+    if (OB_SUCCESS != (ret = aggr_func_.get_result(row)))
+    {
+      TBSYS_LOG(WARN, "failed to calculate avg, err=%d", ret);
+    }
+  }
+  return ret;
 }
 
 int ObHashGroupBy::get_next_row(const common::ObRow *&row)
 {
-  for(当前桶curr_backet_idx_的具有相同groupby列的下k个行)
+  int ret = OB_SUCCESS;
+  if (OB_UNLIKELY(NULL != my_phy_plan_ && my_phy_plan_->is_timeout()))
   {
-    计算聚集列，修改curr_row_;
+    TBSYS_LOG(WARN, "execution timeout, ts=%ld", my_phy_plan_->get_timeout_timestamp());
+    ret = OB_PROCESS_TIMEOUT;
   }
-  if (当前桶处理完)
+  while (OB_SUCCESS == ret && curr_group_idx_ >= group_chains_.count())
+  {
+    // move to the next non-empty bucket
+    if (OB_SUCCESS != (ret = next_bucket()))
+    {
+      if (OB_ITER_END != ret)
+      {
+        TBSYS_LOG(WARN, "failed to move to the next bucket, err=%d", ret);
+      }
+      group_chains_.clear();
+      curr_group_idx_ = 0;
+    }
+    else if (OB_SUCCESS != (ret = build_group_chains()))
+    {
+      TBSYS_LOG(WARN, "failed to build group chains, err=%d bucket=%ld", ret, curr_bucket_idx_);
+    }
+  } // end while
+  if (OB_SUCCESS == ret)
   {
-    ++curr_backet_idx_;
+    if (OB_SUCCESS != (ret = aggregate_group(group_chains_.at(curr_group_idx_), row)))
+    {
+      TBSYS_LOG(WARN, "failed to aggregate group, err=%d bucket=%ld group=%ld",
+                ret, curr_bucket_idx_, curr_group_idx_);
+    }
+    else
+    {
+      ++curr_group_idx_;
+    }
   }
-  row = &curr_row_;
+  return ret;
+}
+
+ObPhyOperatorType ObHashGroupBy::get_type() const
+{
+  return PHY_HASH_GROUPBY;
 }
 
-*/
+void ObHashGroupBy::assign(const ObHashGroupBy& other)
+{
+  group_columns_ = other.group_columns_;
+  aggr_columns_ = other.aggr_columns_;
+  mem_size_limit_ = other.mem_size_limit_;
+  bucket_num_ = other.bucket_num_;
+  set_int_div_as_double(other.get_int_div_as_double());
+}
+
+DEFINE_SERIALIZE(ObHashGroupBy)
+{
+  int ret = OB_SUCCESS;
+  if ((ret = ObGroupBy::serialize(buf, buf_len, pos)) != OB_SUCCESS)
+  {
+    TBSYS_LOG(WARN, "fail to serialize ObGroupBy, ret= %d", ret);
+  }
+  else if ((ret = encode_bool(buf, buf_len, pos, get_int_div_as_double())) != OB_SUCCESS)
+  {
+    TBSYS_LOG(WARN, "serialize get_int_div_as_double fail. ret=%d", ret);
+  }
+  else if ((ret = encode_vi64(buf, buf_len, pos, bucket_num_)) != OB_SUCCESS)
+  {
+    TBSYS_LOG(WARN, "serialize bucket num fail. ret=%d", ret);
+  }
+  return ret;
+}
+
+DEFINE_DESERIALIZE(ObHashGroupBy)
+{
+  int ret = OB_SUCCESS;
+  bool did_int_div_as_double = false;
+  int64_t bucket_num = 0;
+  if ((ret = ObGroupBy::deserialize(buf, data_len, pos)) != OB_SUCCESS)
+  {
+    TBSYS_LOG(WARN, "fail to deserialize ObGroupBy. ret=%d", ret);
+  }
+  else if ((ret = decode_bool(buf, data_len, pos, &did_int_div_as_double)) != OB_SUCCESS)
+  {
+    TBSYS_LOG(WARN, "fail to deserialize get_int_div_as_double. ret=%d", ret);
+  }
+  else if ((ret = decode_vi64(buf, data_len, pos, &bucket_num)) != OB_SUCCESS)
+  {
+    TBSYS_LOG(WARN, "fail to deserialize bucket num. ret=%d", ret);
+  }
+  else if ((ret = set_bucket_num(bucket_num)) != OB_SUCCESS)
+  {
+    TBSYS_LOG(WARN, "invalid bucket num. ret=%d", ret);
+  }
+  else
+  {
+    set_int_div_as_double(did_int_div_as_double);
+  }
+  return ret;
+}
+
+DEFINE_GET_SERIALIZE_SIZE(ObHashGroupBy)
+{
+  int64_t size = 0;
+  size += ObGroupBy::get_serialize_size();
+  size += encoded_length_bool(get_int_div_as_double());
+  size += encoded_length_vi64(bucket_num_);
+  return size;
+}
@@ -15,44 +15,122 @@
  */
 #ifndef _OB_HASH_GROUPBY_H
 #define _OB_HASH_GROUPBY_H 1
-
-#include "sql/ob_groupby.h"
-#include "ob_sql_expression.h"
+#include "ob_groupby.h"
+#include "ob_aggregate_function.h"
+#include "ob_run_file.h"
+#include "common/ob_row_store.h"
+#include "common/ob_rowkey.h"
+#include "common/hash/ob_hashmap.h"
 
 namespace oceanbase
 {
   namespace sql
   {
+    // 输入数据无序，按groupby列的hash值分桶
+    // 1. open()时读入所有输入行，按hash值写入各个桶；内存超过mem_size_limit_时把所有桶dump到run file
+    // 2. get_next_row()逐个桶处理：用hash表把桶内同组的行串成链表，再对每条链调用ObAggregateFunction
+    // 3. 读回的桶仍然超过mem_size_limit_时，用另一个hash种子把它再分桶dump，最多MAX_REPARTITION_LEVEL层
+    // 整个过程不需要对输入排序，输出的各组之间无序
     class ObHashGroupBy: public ObGroupBy
     {
       public:
         ObHashGroupBy();
         virtual ~ObHashGroupBy();
+        void reset();
+
+        virtual void set_int_div_as_double(bool did);
+        virtual bool get_int_div_as_double() const;
+        /// set the number of hash buckets, should be in [1, MAX_BUCKET_NUM]
+        int set_bucket_num(const int64_t bucket_num);
+        int64_t get_bucket_num() const;
+        /// the run file used to dump buckets when exceeding the mem limit
+        int set_run_filename(const common::ObString &filename);
 
-        virtual int set_child(int32_t child_idx, ObPhyOperator &child_operator);
         virtual int open();
         virtual int close();
         virtual int get_next_row(const common::ObRow *&row);
+        virtual int get_row_desc(const common::ObRowDesc *&row_desc) const;
+        virtual ObPhyOperatorType get_type() const;
+        void assign(const ObHashGroupBy& other);
 
-        virtual int add_group_column(const ObSqlExpression &expr);
-        virtual int add_agg_column(const ObSqlExpression &expr);
-
-        void set_backets_param(const int64_t backets_num, const int64_t backet_mem_size);
+        NEED_SERIALIZE_AND_DESERIALIZE;
+      private:
+        // types and constants
+        static const int64_t DEFAULT_BUCKET_NUM = 16;
+        static const int64_t MAX_BUCKET_NUM = 256;
+        static const int64_t GROUP_HASH_MAP_SIZE = 64*1024;
+        static const uint32_t BUCKET_HASH_SEED = 0x5bd1e995;
+        static const int64_t MAX_REPARTITION_LEVEL = 3;
+        struct DumpedBucket
+        {
+          int64_t run_bucket_idx_;  // the bucket index in the run file
+          int64_t level_;           // how many times the rows have been repartitioned
+        };
+        struct GroupChain
+        {
+          int64_t head_;
+          int64_t tail_;
+        };
+        typedef common::hash::ObHashMap<common::ObRowkey, int64_t,
+                                        common::hash::NoPthreadDefendMode> GroupMap;
+        typedef common::ObArray<const common::ObRowStore::StoredRow*> BucketRows;
       private:
         // disallow copy
         ObHashGroupBy(const ObHashGroupBy &other);
         ObHashGroupBy& operator=(const ObHashGroupBy &other);
+        // function members
+        int consume_input();
+        int64_t get_bucket_idx(const common::ObRowStore::StoredRow *stored_row, const int64_t level) const;
+        int add_input_row(const common::ObRow &row, const int64_t level);
+        bool need_dump() const;
+        int dump_buckets(const int64_t run_bucket_base);
+        int push_dumped_buckets(const int64_t run_bucket_base, const int64_t level);
+        int next_bucket();
+        int load_bucket(const DumpedBucket &bucket, bool &loaded);
+        int build_group_chains();
+        int aggregate_group(const GroupChain &chain, const common::ObRow *&row);
+        int convert_stored_row(const common::ObRowStore::StoredRow *stored_row);
+        void free_run_file();
       private:
         // data members
-        ObPhyOpearator *child_op_;
-        ObArray<columnExpr> group_columns_;
-        ObArray<columnExpr> other_columns_;
-        ObArray<columnExpr> agg_columns_;
-        common::ObRow curr_row_;
-        common::ObRowDesc row_desc_;
+        ObAggregateFunction aggr_func_;
+        int64_t bucket_num_;
+        common::ObRowStore row_store_;
+        BucketRows bucket_rows_[MAX_BUCKET_NUM];
+        int64_t bucket_row_count_;  // rows in all the buckets, so need_dump() doesn't walk the buckets
+        bool bucket_dumped_[MAX_BUCKET_NUM];
+        bool has_dumped_;
+        common::ObArray<DumpedBucket> pending_buckets_; // dumped buckets to be aggregated, used as a stack
+        int64_t next_run_bucket_idx_;
+        BucketRows loaded_rows_;
+        const BucketRows *curr_rows_;
+        char run_filename_buf_[common::OB_MAX_FILE_NAME_LENGTH];
+        common::ObString run_filename_;
+        ObRunFile run_file_;
+        GroupMap group_map_;
+        common::ObArray<GroupChain> group_chains_;
+        common::ObArray<int64_t> next_in_group_;
+        int64_t curr_bucket_idx_;
+        int64_t curr_group_idx_;
+        const common::ObRowDesc *child_row_desc_;
+        common::ObRow curr_input_row_;
     };
+
+    inline void ObHashGroupBy::set_int_div_as_double(bool did)
+    {
+      aggr_func_.set_int_div_as_double(did);
+    }
+
+    inline bool ObHashGroupBy::get_int_div_as_double() const
+    {
+      return aggr_func_.get_int_div_as_double();
+    }
+
+    inline int64_t ObHashGroupBy::get_bucket_num() const
+    {
+      return bucket_num_;
+    }
   } // end namespace sql
 } // end namespace oceanbase
 
 #endif /* _OB_HASH_GROUPBY_H */
-
@@ -0,0 +1,1289 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_hash_join.cpp
+ *
+ */
+#include "ob_hash_join.h"
+#include "ob_physical_plan.h"
+#include "common/utility.h"
+#include "common/ob_row_util.h"
+#include <sys/stat.h>
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+ObHashJoin::ObHashJoin()
+  :build_left_(false), partition_num_(DEFAULT_PARTITION_NUM), mem_size_limit_(0),
+   build_row_desc_(NULL), probe_row_desc_(NULL), left_column_num_(0),
+   has_dumped_(false), next_bucket_idx_(0), stage_(PROBE_END),
+   probe_run_count_(0), curr_probe_run_idx_(0), curr_probe_row_(NULL),
+   curr_probe_matched_(false), curr_match_idx_(-1), curr_build_idx_(0)
+{
+  memset(partition_dumped_, 0, sizeof(partition_dumped_));
+  memset(probe_partition_dumped_, 0, sizeof(probe_partition_dumped_));
+  run_filename_buf_[0] = '\0';
+}
+
+ObHashJoin::~ObHashJoin()
+{
+  free_run_file();
+}
+
+int ObHashJoin::set_join_type(const ObJoin::JoinType join_type)
+{
+  int ret = OB_SUCCESS;
+  switch(join_type)
+  {
+    case INNER_JOIN:
+    case LEFT_OUTER_JOIN:
+    case RIGHT_OUTER_JOIN:
+    case FULL_OUTER_JOIN:
+    case LEFT_SEMI_JOIN:
+    case RIGHT_SEMI_JOIN:
+    case LEFT_ANTI_SEMI_JOIN:
+    case RIGHT_ANTI_SEMI_JOIN:
+      ret = ObJoin::set_join_type(join_type);
+      break;
+    default:
+      ret = OB_ERR_UNEXPECTED;
+      break;
+  }
+  return ret;
+}
+
+int ObHashJoin::set_partition_num(const int64_t partition_num)
+{
+  int ret = OB_SUCCESS;
+  if (0 >= partition_num || MAX_PARTITION_NUM < partition_num)
+  {
+    TBSYS_LOG(WARN, "invalid partition num=%ld max=%ld", partition_num, MAX_PARTITION_NUM);
+    ret = OB_INVALID_ARGUMENT;
+  }
+  else
+  {
+    partition_num_ = partition_num;
+  }
+  return ret;
+}
+
+int ObHashJoin::set_run_filename(const common::ObString &filename)
+{
+  int ret = OB_SUCCESS;
+  if (filename.length() >= OB_MAX_FILE_NAME_LENGTH)
+  {
+    TBSYS_LOG(ERROR, "filename is too long, filename=%.*s", filename.length(), filename.ptr());
+    ret = OB_BUF_NOT_ENOUGH;
+  }
+  else
+  {
+    TBSYS_LOG(INFO, "hash join run file=%.*s", filename.length(), filename.ptr());
+    snprintf(run_filename_buf_, OB_MAX_FILE_NAME_LENGTH, "%.*s", filename.length(), filename.ptr());
+    run_filename_.assign_ptr(run_filename_buf_, filename.length());
+  }
+  return ret;
+}
+
+ObPhyOperatorType ObHashJoin::get_type() const
+{
+  return PHY_HASH_JOIN;
+}
+
+inline bool ObHashJoin::probe_outer() const
+{
+  return FULL_OUTER_JOIN == join_type_
+    || (build_left_ ? RIGHT_OUTER_JOIN : LEFT_OUTER_JOIN) == join_type_;
+}
+
+inline bool ObHashJoin::build_outer() const
+{
+  return FULL_OUTER_JOIN == join_type_
+    || (build_left_ ? LEFT_OUTER_JOIN : RIGHT_OUTER_JOIN) == join_type_;
+}
+
+inline bool ObHashJoin::probe_semi() const
+{
+  return (build_left_ ? RIGHT_SEMI_JOIN : LEFT_SEMI_JOIN) == join_type_;
+}
+
+inline bool ObHashJoin::build_semi() const
+{
+  return (build_left_ ? LEFT_SEMI_JOIN : RIGHT_SEMI_JOIN) == join_type_;
+}
+
+inline bool ObHashJoin::probe_anti() const
+{
+  return (build_left_ ? RIGHT_ANTI_SEMI_JOIN : LEFT_ANTI_SEMI_JOIN) == join_type_;
+}
+
+inline bool ObHashJoin::build_anti() const
+{
+  return (build_left_ ? LEFT_ANTI_SEMI_JOIN : RIGHT_ANTI_SEMI_JOIN) == join_type_;
+}
+
+int ObHashJoin::open()
+{
+  int ret = OB_SUCCESS;
+  const ObRowDesc *left_row_desc = NULL;
+  const ObRowDesc *right_row_desc = NULL;
+  if (equal_join_conds_.count() <= 0)
+  {
+    TBSYS_LOG(WARN, "hash join can not work without equijoin conditions");
+    ret = OB_NOT_SUPPORTED;
+  }
+  else if (OB_SUCCESS != (ret = ObJoin::open()))
+  {
+    TBSYS_LOG(WARN, "failed to open child ops, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = left_op_->get_row_desc(left_row_desc)))
+  {
+    TBSYS_LOG(WARN, "failed to get child row desc, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = right_op_->get_row_desc(right_row_desc)))
+  {
+    TBSYS_LOG(WARN, "failed to get child row desc, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = cons_row_desc(*left_row_desc, *right_row_desc)))
+  {
+    TBSYS_LOG(WARN, "failed to cons row desc, err=%d", ret);
+  }
+  else
+  {
+    OB_ASSERT(left_row_desc);
+    OB_ASSERT(right_row_desc);
+    left_column_num_ = left_row_desc->get_column_num();
+    build_row_desc_ = build_left_ ? left_row_desc : right_row_desc;
+    probe_row_desc_ = build_left_ ? right_row_desc : left_row_desc;
+    curr_row_.set_row_desc(row_desc_);
+    build_row_.set_row_desc(*build_row_desc_);
+    probe_row_buf_.set_row_desc(*probe_row_desc_);
+    if (OB_SUCCESS != (ret = cons_key_columns()))
+    {
+      TBSYS_LOG(WARN, "failed to cons join key columns, err=%d", ret);
+    }
+    else if (!join_map_.created()
+             && OB_SUCCESS != (ret = join_map_.create(JOIN_HASH_MAP_SIZE)))
+    {
+      TBSYS_LOG(WARN, "failed to create join hash map, err=%d", ret);
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    spilled_partitions_.clear();
+    next_bucket_idx_ = 2 * MAX_PARTITION_NUM;
+    probe_run_count_ = 0;
+    curr_probe_run_idx_ = 0;
+    curr_probe_row_ = NULL;
+    curr_probe_matched_ = false;
+    curr_match_idx_ = -1;
+    curr_build_idx_ = 0;
+    if (OB_SUCCESS != (ret = consume_build_input()))
+    {
+      TBSYS_LOG(WARN, "failed to consume build input, err=%d", ret);
+    }
+    else if (has_dumped_)
+    {
+      if (OB_SUCCESS != (ret = dump_probe_input()))
+      {
+        TBSYS_LOG(WARN, "failed to dump probe input, err=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = add_spilled_partitions(0, MAX_PARTITION_NUM, 0)))
+      {
+        TBSYS_LOG(WARN, "failed to add spilled partitions, err=%d", ret);
+      }
+      else
+      {
+        stage_ = NEXT_PARTITION;
+      }
+    }
+    else if (OB_SUCCESS != (ret = build_hash_table()))
+    {
+      TBSYS_LOG(WARN, "failed to build hash table, err=%d", ret);
+    }
+    else if (build_rows_.count() <= 0 && !probe_outer() && !probe_anti())
+    {
+      // nothing to join with, the probe side need not to be read
+      stage_ = PROBE_END;
+    }
+    else
+    {
+      stage_ = PROBE_ROWS;
+    }
+  }
+  return ret;
+}
+
+int ObHashJoin::close()
+{
+  int ret = OB_SUCCESS;
+  free_run_file();
+  row_store_.clear();
+  probe_store_.clear();
+  for (int64_t i = 0; i < MAX_PARTITION_NUM; ++i)
+  {
+    partition_rows_[i].clear();
+  }
+  memset(partition_dumped_, 0, sizeof(partition_dumped_));
+  memset(probe_partition_dumped_, 0, sizeof(probe_partition_dumped_));
+  has_dumped_ = false;
+  spilled_partitions_.clear();
+  next_bucket_idx_ = 0;
+  join_map_.clear();
+  build_rows_.clear();
+  next_in_chain_.clear();
+  build_matched_.clear();
+  build_keys_.clear();
+  probe_keys_.clear();
+  stage_ = PROBE_END;
+  probe_run_count_ = 0;
+  curr_probe_run_idx_ = 0;
+  curr_probe_row_ = NULL;
+  curr_match_idx_ = -1;
+  curr_build_idx_ = 0;
+  build_row_desc_ = NULL;
+  probe_row_desc_ = NULL;
+  left_column_num_ = 0;
+  row_desc_.reset();
+  ret = ObJoin::close();
+  return ret;
+}
+
+void ObHashJoin::free_run_file()
+{
+  int ret = OB_SUCCESS;
+  if (run_file_.is_opened())
+  {
+    if (OB_SUCCESS != (ret = run_file_.close()))
+    {
+      TBSYS_LOG(WARN, "failed to close run file, err=%d", ret);
+    }
+    struct stat stat_buf;
+    if (0 == stat(run_filename_buf_, &stat_buf))
+    {
+      if (0 != unlink(run_filename_buf_))
+      {
+        TBSYS_LOG(WARN, "failed to remove tmp run file, err=%s", strerror(errno));
+      }
+    }
+  }
+}
+
+int ObHashJoin::get_row_desc(const common::ObRowDesc *&row_desc) const
+{
+  int ret = OB_SUCCESS;
+  if (OB_UNLIKELY(0 >= row_desc_.get_column_num()))
+  {
+    TBSYS_LOG(ERROR, "not init");
+    ret = OB_NOT_INIT;
+  }
+  else if (probe_semi() || probe_anti())
+  {
+    row_desc = probe_row_desc_;
+  }
+  else if (build_semi() || build_anti())
+  {
+    row_desc = build_row_desc_;
+  }
+  else
+  {
+    row_desc = &row_desc_;
+  }
+  return ret;
+}
+
+int ObHashJoin::cons_row_desc(const ObRowDesc &rd1, const ObRowDesc &rd2)
+{
+  int ret = OB_SUCCESS;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  for (int64_t i = 0; i < rd1.get_column_num(); ++i)
+  {
+    if (OB_SUCCESS != (ret = rd1.get_tid_cid(i, tid, cid)))
+    {
+      TBSYS_LOG(ERROR, "unexpected branch");
+      ret = OB_ERR_UNEXPECTED;
+      break;
+    }
+    else if (OB_SUCCESS != (ret = row_desc_.add_column_desc(tid, cid)))
+    {
+      TBSYS_LOG(WARN, "failed to add column desc, err=%d", ret);
+      break;
+    }
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < rd2.get_column_num(); ++i)
+  {
+    if (OB_SUCCESS != (ret = rd2.get_tid_cid(i, tid, cid)))
+    {
+      TBSYS_LOG(ERROR, "unexpected branch");
+    }
+    else if (OB_SUCCESS != (ret = row_desc_.add_column_desc(tid, cid)))
+    {
+      TBSYS_LOG(WARN, "failed to add column desc, err=%d", ret);
+    }
+  }
+  return ret;
+}
+
+// the join key columns of the build rows are kept as reserved cells of the stored rows,
+// so that they could be hashed and compared without decoding the row
+int ObHashJoin::cons_key_columns()
+{
+  int ret = OB_SUCCESS;
+  build_keys_.clear();
+  probe_keys_.clear();
+  if (OB_MAX_ROWKEY_COLUMN_NUMBER < equal_join_conds_.count())
+  {
+    TBSYS_LOG(WARN, "too many equijoin conditions, count=%ld", equal_join_conds_.count());
+    ret = OB_NOT_SUPPORTED;
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < equal_join_conds_.count(); ++i)
+  {
+    const ObSqlExpression &expr = equal_join_conds_.at(i);
+    ExprItem::SqlCellInfo c1;
+    ExprItem::SqlCellInfo c2;
+    if (!expr.is_equijoin_cond(c1, c2))
+    {
+      TBSYS_LOG(ERROR, "invalid equijoin condition");
+      ret = OB_ERR_UNEXPECTED;
+    }
+    else
+    {
+      // the operands may be in either order
+      const ObRowDesc &left_row_desc = build_left_ ? *build_row_desc_ : *probe_row_desc_;
+      if (OB_INVALID_INDEX == left_row_desc.get_idx(c1.tid, c1.cid))
+      {
+        ExprItem::SqlCellInfo tmp = c1;
+        c1 = c2;
+        c2 = tmp;
+      }
+      const ExprItem::SqlCellInfo &build_key = build_left_ ? c1 : c2;
+      const ExprItem::SqlCellInfo &probe_key = build_left_ ? c2 : c1;
+      if (OB_INVALID_INDEX == build_row_desc_->get_idx(build_key.tid, build_key.cid)
+          || OB_INVALID_INDEX == probe_row_desc_->get_idx(probe_key.tid, probe_key.cid))
+      {
+        TBSYS_LOG(WARN, "join key column not found, tid=%lu cid=%lu tid=%lu cid=%lu",
+                  c1.tid, c1.cid, c2.tid, c2.cid);
+        ret = OB_ERR_UNEXPECTED;
+      }
+      else if (OB_SUCCESS != (ret = build_keys_.push_back(build_key)))
+      {
+        TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = probe_keys_.push_back(probe_key)))
+      {
+        TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = row_store_.add_reserved_column(build_key.tid, build_key.cid)))
+      {
+        TBSYS_LOG(WARN, "failed to add reserved column, err=%d", ret);
+      }
+    }
+  } // end for
+  return ret;
+}
+
+static inline bool has_null_cell(const ObObj *cells, const int64_t count)
+{
+  bool ret = false;
+  for (int64_t i = 0; i < count; ++i)
+  {
+    if (cells[i].is_null())
+    {
+      ret = true;
+      break;
+    }
+  }
+  return ret;
+}
+
+int ObHashJoin::consume_build_input()
+{
+  int ret = OB_SUCCESS;
+  ObPhyOperator *build_op = build_left_ ? left_op_ : right_op_;
+  const ObRow *input_row = NULL;
+  while (OB_SUCCESS == ret
+         && OB_SUCCESS == (ret = build_op->get_next_row(input_row)))
+  {
+    if (OB_SUCCESS != (ret = add_build_row(*input_row, PARTITION_HASH_SEED)))
+    {
+      TBSYS_LOG(WARN, "failed to add build row, err=%d", ret);
+    }
+    else if (need_dump(row_store_))
+    {
+      if (OB_SUCCESS != (ret = dump_partitions(row_store_, 0, partition_dumped_)))
+      {
+        TBSYS_LOG(WARN, "failed to dump partitions, err=%d", ret);
+      }
+    }
+  } // end while
+  if (OB_ITER_END == ret)
+  {
+    ret = OB_SUCCESS;
+  }
+  if (OB_SUCCESS == ret)
+  {
+    if (has_dumped_)
+    {
+      if (!row_store_.is_empty()
+          && OB_SUCCESS != (ret = dump_partitions(row_store_, 0, partition_dumped_)))
+      {
+        TBSYS_LOG(WARN, "failed to dump the last rows, err=%d", ret);
+      }
+    }
+    else
+    {
+      // all the build rows fit in memory, build one hash table on all of them
+      build_rows_.clear();
+      for (int64_t i = 0; OB_SUCCESS == ret && i < partition_num_; ++i)
+      {
+        PartitionRows &rows = partition_rows_[i];
+        for (int64_t j = 0; j < rows.count(); ++j)
+        {
+          if (OB_SUCCESS != (ret = build_rows_.push_back(rows.at(j))))
+          {
+            TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+            break;
+          }
+        }
+        rows.clear();
+      }
+    }
+  }
+  return ret;
+}
+
+int ObHashJoin::add_build_row(const common::ObRow &row, const uint32_t hash_seed)
+{
+  int ret = OB_SUCCESS;
+  const ObRowStore::StoredRow *stored_row = NULL;
+  if (OB_SUCCESS != (ret = row_store_.add_row(row, stored_row)))
+  {
+    TBSYS_LOG(WARN, "failed to add row into row_store, err=%d", ret);
+  }
+  else if (has_null_cell(stored_row->reserved_cells_, stored_row->reserved_cells_count_)
+           && !build_outer() && !build_anti())
+  {
+    // never match and never output
+  }
+  else
+  {
+    ObRowkey join_key(const_cast<ObObj*>(stored_row->reserved_cells_), stored_row->reserved_cells_count_);
+    int64_t part_idx = join_key.murmurhash2(hash_seed) % partition_num_;
+    if (OB_SUCCESS != (ret = partition_rows_[part_idx].push_back(stored_row)))
+    {
+      TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+    }
+  }
+  return ret;
+}
+
+// partition the probe row in the same way as the build rows of the current pass,
+// rows of empty build partitions are dropped unless they will be output unmatched
+int ObHashJoin::add_probe_row(const common::ObRow &row, const uint32_t hash_seed, const int64_t bucket_offset)
+{
+  int ret = OB_SUCCESS;
+  const ObObj *cell = NULL;
+  const ObRowStore::StoredRow *stored_row = NULL;
+  const int64_t key_count = probe_keys_.count();
+  const bool keep_unmatched = probe_outer() || probe_anti();
+  for (int64_t i = 0; i < key_count; ++i)
+  {
+    const ExprItem::SqlCellInfo &key = probe_keys_.at(i);
+    if (OB_SUCCESS != (ret = row.get_cell(key.tid, key.cid, cell)))
+    {
+      TBSYS_LOG(WARN, "failed to get cell, err=%d tid=%lu cid=%lu", ret, key.tid, key.cid);
+      break;
+    }
+    else
+    {
+      probe_key_cells_[i] = *cell;
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    bool skip = false;
+    int64_t part_idx = 0;
+    if (has_null_cell(probe_key_cells_, key_count))
+    {
+      // rows with NULL key match nothing, any partition is OK
+      skip = !keep_unmatched;
+    }
+    else
+    {
+      ObRowkey join_key(probe_key_cells_, key_count);
+      part_idx = join_key.murmurhash2(hash_seed) % partition_num_;
+      // the build partition is empty
+      skip = !keep_unmatched && !partition_dumped_[part_idx];
+    }
+    if (skip)
+    {
+    }
+    else if (OB_SUCCESS != (ret = probe_store_.add_row(row, stored_row)))
+    {
+      TBSYS_LOG(WARN, "failed to add row into row_store, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = partition_rows_[part_idx].push_back(stored_row)))
+    {
+      TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+    }
+    else if (need_dump(probe_store_))
+    {
+      if (OB_SUCCESS != (ret = dump_partitions(probe_store_, bucket_offset, probe_partition_dumped_)))
+      {
+        TBSYS_LOG(WARN, "failed to dump probe partitions, err=%d", ret);
+      }
+    }
+  }
+  return ret;
+}
+
+inline bool ObHashJoin::need_dump(const ObRowStore &store) const
+{
+  bool ret = false;
+  if (0 < mem_size_limit_ && 0 < run_filename_.length())
+  {
+    int64_t used_mem_size = store.get_used_mem_size() + build_rows_.count() * sizeof(void*);
+    for (int64_t i = 0; i < partition_num_; ++i)
+    {
+      used_mem_size += partition_rows_[i].count() * sizeof(void*);
+    }
+    ret = (used_mem_size >= mem_size_limit_);
+  }
+  return ret;
+}
+
+// write every non-empty partition as a run of the bucket (bucket_offset + partition index)
+int ObHashJoin::dump_partitions(ObRowStore &store, const int64_t bucket_offset, bool *dumped_flags)
+{
+  int ret = OB_SUCCESS;
+  if (!run_file_.is_opened())
+  {
+    if (OB_SUCCESS != (ret = run_file_.open(run_filename_)))
+    {
+      TBSYS_LOG(WARN, "failed to open run file, err=%d filename=%.*s",
+                ret, run_filename_.length(), run_filename_.ptr());
+    }
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < partition_num_; ++i)
+  {
+    PartitionRows &rows = partition_rows_[i];
+    if (0 < rows.count())
+    {
+      if (OB_SUCCESS != (ret = run_file_.begin_append_run(bucket_offset + i)))
+      {
+        TBSYS_LOG(WARN, "failed to begin dump run, err=%d bucket=%ld", ret, bucket_offset + i);
+      }
+      else
+      {
+        for (int64_t j = 0; j < rows.count(); ++j)
+        {
+          if (OB_SUCCESS != (ret = run_file_.append_row(rows.at(j)->get_compact_row())))
+          {
+            TBSYS_LOG(WARN, "failed to append row, err=%d", ret);
+            break;
+          }
+        }
+        if (OB_SUCCESS == ret)
+        {
+          if (OB_SUCCESS != (ret = run_file_.end_append_run()))
+          {
+            TBSYS_LOG(WARN, "failed to end dump run, err=%d", ret);
+          }
+          else
+          {
+            TBSYS_LOG(INFO, "dump partition run, bucket=%ld row_count=%ld", bucket_offset + i, rows.count());
+            dumped_flags[i] = true;
+            rows.clear();
+          }
+        }
+      }
+    }
+  } // end for
+  if (OB_SUCCESS == ret)
+  {
+    store.clear_rows();
+    has_dumped_ = true;
+  }
+  return ret;
+}
+
+// once the build side was dumped, the probe rows are partitioned in the same way
+// and dumped too, the partitions are joined one by one later
+int ObHashJoin::dump_probe_input()
+{
+  int ret = OB_SUCCESS;
+  ObPhyOperator *probe_op = build_left_ ? right_op_ : left_op_;
+  const ObRow *input_row = NULL;
+  while (OB_SUCCESS == ret
+         && OB_SUCCESS == (ret = probe_op->get_next_row(input_row)))
+  {
+    if (OB_SUCCESS != (ret = add_probe_row(*input_row, PARTITION_HASH_SEED, MAX_PARTITION_NUM)))
+    {
+      TBSYS_LOG(WARN, "failed to add probe row, err=%d", ret);
+    }
+  } // end while
+  if (OB_ITER_END == ret)
+  {
+    ret = OB_SUCCESS;
+  }
+  if (OB_SUCCESS == ret && !probe_store_.is_empty())
+  {
+    if (OB_SUCCESS != (ret = dump_partitions(probe_store_, MAX_PARTITION_NUM, probe_partition_dumped_)))
+    {
+      TBSYS_LOG(WARN, "failed to dump the last probe rows, err=%d", ret);
+    }
+  }
+  probe_store_.clear();
+  return ret;
+}
+
+// remember the partitions dumped by the current pass, they are joined in the order of partition index
+int ObHashJoin::add_spilled_partitions(const int64_t build_offset, const int64_t probe_offset, const int64_t level)
+{
+  int ret = OB_SUCCESS;
+  for (int64_t i = partition_num_ - 1; OB_SUCCESS == ret && i >= 0; --i)
+  {
+    if (partition_dumped_[i] || probe_partition_dumped_[i])
+    {
+      SpilledPartition part;
+      part.build_bucket_ = partition_dumped_[i] ? build_offset + i : -1;
+      part.probe_bucket_ = probe_partition_dumped_[i] ? probe_offset + i : -1;
+      part.level_ = level;
+      if (OB_SUCCESS != (ret = spilled_partitions_.push_back(part)))
+      {
+        TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+      }
+    }
+  }
+  memset(partition_dumped_, 0, sizeof(partition_dumped_));
+  memset(probe_partition_dumped_, 0, sizeof(probe_partition_dumped_));
+  return ret;
+}
+
+// stop loading and report oversized if the build rows of the partition exceed the mem limit
+int ObHashJoin::load_partition(const SpilledPartition &part, bool &oversized)
+{
+  int ret = OB_SUCCESS;
+  oversized = false;
+  row_store_.clear_rows();
+  build_rows_.clear();
+  if (0 <= part.build_bucket_)
+  {
+    int64_t run_count = 0;
+    const ObRowStore::StoredRow *stored_row = NULL;
+    if (OB_SUCCESS != (ret = run_file_.begin_read_bucket(part.build_bucket_, run_count)))
+    {
+      TBSYS_LOG(WARN, "failed to begin to read bucket, err=%d bucket=%ld", ret, part.build_bucket_);
+    }
+    for (int64_t i = 0; OB_SUCCESS == ret && !oversized && i < run_count; ++i)
+    {
+      while (OB_SUCCESS == (ret = run_file_.get_next_row(i, build_row_)))
+      {
+        if (OB_SUCCESS != (ret = row_store_.add_row(build_row_, stored_row)))
+        {
+          TBSYS_LOG(WARN, "failed to add row into row_store, err=%d", ret);
+          break;
+        }
+        else if (OB_SUCCESS != (ret = build_rows_.push_back(stored_row)))
+        {
+          TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+          break;
+        }
+        else if (MAX_REPARTITION_LEVEL > part.level_ && need_dump(row_store_))
+        {
+          oversized = true;
+          break;
+        }
+      }
+      if (OB_ITER_END == ret)
+      {
+        ret = OB_SUCCESS;
+      }
+      else if (OB_SUCCESS != ret)
+      {
+        TBSYS_LOG(WARN, "failed to read run, err=%d bucket=%ld run_idx=%ld", ret, part.build_bucket_, i);
+      }
+    } // end for
+    if (OB_SUCCESS == ret)
+    {
+      if (OB_SUCCESS != (ret = run_file_.end_read_bucket()))
+      {
+        TBSYS_LOG(WARN, "failed to end read bucket, err=%d", ret);
+      }
+      else if (oversized)
+      {
+        TBSYS_LOG(INFO, "partition exceeds mem limit, bucket=%ld level=%ld mem_size_limit=%ld",
+                  part.build_bucket_, part.level_, mem_size_limit_);
+        row_store_.clear_rows();
+        build_rows_.clear();
+      }
+      else
+      {
+        TBSYS_LOG(INFO, "load partition, bucket=%ld run_count=%ld row_count=%ld",
+                  part.build_bucket_, run_count, build_rows_.count());
+      }
+    }
+  }
+  return ret;
+}
+
+// split both sides of the partition into partition_num_ smaller ones with another hash seed
+int ObHashJoin::repartition(const SpilledPartition &part)
+{
+  int ret = OB_SUCCESS;
+  const int64_t level = part.level_ + 1;
+  const uint32_t hash_seed = PARTITION_HASH_SEED + static_cast<uint32_t>(level);
+  const int64_t build_offset = next_bucket_idx_;
+  const int64_t probe_offset = next_bucket_idx_ + partition_num_;
+  int64_t run_count = 0;
+  next_bucket_idx_ += 2 * partition_num_;
+  row_store_.clear_rows();
+  if (OB_SUCCESS != (ret = run_file_.begin_read_bucket(part.build_bucket_, run_count)))
+  {
+    TBSYS_LOG(WARN, "failed to begin to read bucket, err=%d bucket=%ld", ret, part.build_bucket_);
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < run_count; ++i)
+  {
+    while (OB_SUCCESS == (ret = run_file_.get_next_row(i, build_row_)))
+    {
+      if (OB_SUCCESS != (ret = add_build_row(build_row_, hash_seed)))
+      {
+        TBSYS_LOG(WARN, "failed to add build row, err=%d", ret);
+        break;
+      }
+      else if (need_dump(row_store_)
+               && OB_SUCCESS != (ret = dump_partitions(row_store_, build_offset, partition_dumped_)))
+      {
+        TBSYS_LOG(WARN, "failed to dump partitions, err=%d", ret);
+        break;
+      }
+    }
+    if (OB_ITER_END == ret)
+    {
+      ret = OB_SUCCESS;
+    }
+  } // end for
+  if (OB_SUCCESS != ret)
+  {
+  }
+  else if (OB_SUCCESS != (ret = run_file_.end_read_bucket()))
+  {
+    TBSYS_LOG(WARN, "failed to end read bucket, err=%d", ret);
+  }
+  else if (!row_store_.is_empty()
+           && OB_SUCCESS != (ret = dump_partitions(row_store_, build_offset, partition_dumped_)))
+  {
+    TBSYS_LOG(WARN, "failed to dump the last rows, err=%d", ret);
+  }
+  if (OB_SUCCESS == ret && 0 <= part.probe_bucket_)
+  {
+    if (OB_SUCCESS != (ret = run_file_.begin_read_bucket(part.probe_bucket_, run_count)))
+    {
+      TBSYS_LOG(WARN, "failed to begin to read bucket, err=%d bucket=%ld", ret, part.probe_bucket_);
+    }
+    for (int64_t i = 0; OB_SUCCESS == ret && i < run_count; ++i)
+    {
+      while (OB_SUCCESS == (ret = run_file_.get_next_row(i, probe_row_buf_)))
+      {
+        if (OB_SUCCESS != (ret = add_probe_row(probe_row_buf_, hash_seed, probe_offset)))
+        {
+          TBSYS_LOG(WARN, "failed to add probe row, err=%d", ret);
+          break;
+        }
+      }
+      if (OB_ITER_END == ret)
+      {
+        ret = OB_SUCCESS;
+      }
+    } // end for
+    if (OB_SUCCESS != ret)
+    {
+    }
+    else if (OB_SUCCESS != (ret = run_file_.end_read_bucket()))
+    {
+      TBSYS_LOG(WARN, "failed to end read bucket, err=%d", ret);
+    }
+    else if (!probe_store_.is_empty()
+             && OB_SUCCESS != (ret = dump_partitions(probe_store_, probe_offset, probe_partition_dumped_)))
+    {
+      TBSYS_LOG(WARN, "failed to dump the last probe rows, err=%d", ret);
+    }
+    probe_store_.clear();
+  }
+  if (OB_SUCCESS != ret)
+  {
+  }
+  else if (OB_SUCCESS != (ret = add_spilled_partitions(build_offset, probe_offset, level)))
+  {
+    TBSYS_LOG(WARN, "failed to add spilled partitions, err=%d", ret);
+  }
+  else
+  {
+    TBSYS_LOG(INFO, "repartition, bucket=%ld level=%ld", part.build_bucket_, level);
+  }
+  return ret;
+}
+
+int ObHashJoin::begin_probe_partition(const SpilledPartition &part)
+{
+  int ret = OB_SUCCESS;
+  probe_run_count_ = 0;
+  curr_probe_run_idx_ = 0;
+  curr_probe_row_ = NULL;
+  curr_match_idx_ = -1;
+  curr_build_idx_ = 0;
+  if (0 <= part.probe_bucket_)
+  {
+    if (OB_SUCCESS != (ret = run_file_.begin_read_bucket(part.probe_bucket_, probe_run_count_)))
+    {
+      TBSYS_LOG(WARN, "failed to begin to read bucket, err=%d bucket=%ld",
+                ret, part.probe_bucket_);
+    }
+  }
+  return ret;
+}
+
+// chain the build rows of the same join key together, keeping their input order
+int ObHashJoin::build_hash_table()
+{
+  int ret = OB_SUCCESS;
+  const int64_t row_count = build_rows_.count();
+  join_map_.clear();
+  next_in_chain_.clear();
+  build_matched_.clear();
+  next_in_chain_.reserve(row_count);
+  build_matched_.reserve(row_count);
+  for (int64_t i = 0; OB_SUCCESS == ret && i < row_count; ++i)
+  {
+    if (OB_SUCCESS != (ret = next_in_chain_.push_back(-1)))
+    {
+      TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = build_matched_.push_back(false)))
+    {
+      TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+    }
+  }
+  for (int64_t i = row_count - 1; OB_SUCCESS == ret && i >= 0; --i)
+  {
+    const ObRowStore::StoredRow *stored_row = build_rows_.at(i);
+    if (!has_null_cell(stored_row->reserved_cells_, stored_row->reserved_cells_count_))
+    {
+      ObRowkey join_key(const_cast<ObObj*>(stored_row->reserved_cells_), stored_row->reserved_cells_count_);
+      int64_t head = -1;
+      if (hash::HASH_EXIST == join_map_.get(join_key, head))
+      {
+        next_in_chain_.at(i) = head;
+      }
+      int hash_ret = join_map_.set(join_key, i, 1);
+      if (hash::HASH_INSERT_SUCC != hash_ret && hash::HASH_OVERWRITE_SUCC != hash_ret)
+      {
+        TBSYS_LOG(WARN, "failed to set hash map, hash_ret=%d", hash_ret);
+        ret = OB_ERROR;
+      }
+    }
+  }
+  return ret;
+}
+
+int ObHashJoin::get_next_partition()
+{
+  int ret = OB_SUCCESS;
+  SpilledPartition part;
+  bool oversized = false;
+  while (OB_SUCCESS == ret)
+  {
+    if (OB_SUCCESS != spilled_partitions_.pop_back(part))
+    {
+      ret = OB_ITER_END;
+    }
+    else if (OB_SUCCESS != (ret = load_partition(part, oversized)))
+    {
+      TBSYS_LOG(WARN, "failed to load partition, err=%d bucket=%ld", ret, part.build_bucket_);
+    }
+    else if (oversized)
+    {
+      if (OB_SUCCESS != (ret = repartition(part)))
+      {
+        TBSYS_LOG(WARN, "failed to repartition, err=%d bucket=%ld", ret, part.build_bucket_);
+      }
+    }
+    else if (build_rows_.count() <= 0 && !probe_outer() && !probe_anti())
+    {
+      // skip the probe rows of this partition
+    }
+    else if (OB_SUCCESS != (ret = build_hash_table()))
+    {
+      TBSYS_LOG(WARN, "failed to build hash table, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = begin_probe_partition(part)))
+    {
+      TBSYS_LOG(WARN, "failed to begin probe partition, err=%d", ret);
+    }
+    else
+    {
+      break;
+    }
+  }
+  return ret;
+}
+
+int ObHashJoin::get_next_probe_row()
+{
+  int ret = OB_SUCCESS;
+  curr_probe_row_ = NULL;
+  if (has_dumped_)
+  {
+    ret = OB_ITER_END;
+    while (curr_probe_run_idx_ < probe_run_count_)
+    {
+      if (OB_SUCCESS == (ret = run_file_.get_next_row(curr_probe_run_idx_, probe_row_buf_)))
+      {
+        curr_probe_row_ = &probe_row_buf_;
+        break;
+      }
+      else if (OB_ITER_END == ret)
+      {
+        ++curr_probe_run_idx_;
+      }
+      else
+      {
+        TBSYS_LOG(WARN, "failed to read run, err=%d run_idx=%ld", ret, curr_probe_run_idx_);
+        break;
+      }
+    }
+    if (OB_ITER_END == ret && 0 < probe_run_count_)
+    {
+      probe_run_count_ = 0;
+      int err = OB_SUCCESS;
+      if (OB_SUCCESS != (err = run_file_.end_read_bucket()))
+      {
+        TBSYS_LOG(WARN, "failed to end read bucket, err=%d", err);
+        ret = err;
+      }
+    }
+  }
+  else
+  {
+    ObPhyOperator *probe_op = build_left_ ? right_op_ : left_op_;
+    ret = probe_op->get_next_row(curr_probe_row_);
+  }
+  if (OB_SUCCESS == ret)
+  {
+    curr_probe_matched_ = false;
+    ret = find_match_chain();
+  }
+  else if (OB_ITER_END != ret)
+  {
+    TBSYS_LOG(WARN, "failed to get next probe row, err=%d", ret);
+  }
+  return ret;
+}
+
+int ObHashJoin::find_match_chain()
+{
+  int ret = OB_SUCCESS;
+  const ObObj *cell = NULL;
+  const int64_t key_count = probe_keys_.count();
+  curr_match_idx_ = -1;
+  for (int64_t i = 0; i < key_count; ++i)
+  {
+    const ExprItem::SqlCellInfo &key = probe_keys_.at(i);
+    if (OB_SUCCESS != (ret = curr_probe_row_->get_cell(key.tid, key.cid, cell)))
+    {
+      TBSYS_LOG(WARN, "failed to get cell, err=%d tid=%lu cid=%lu", ret, key.tid, key.cid);
+      break;
+    }
+    else
+    {
+      probe_key_cells_[i] = *cell;
+    }
+  }
+  if (OB_SUCCESS == ret && !has_null_cell(probe_key_cells_, key_count))
+  {
+    ObRowkey join_key(probe_key_cells_, key_count);
+    int64_t head = -1;
+    if (hash::HASH_EXIST == join_map_.get(join_key, head))
+    {
+      curr_match_idx_ = head;
+    }
+  }
+  return ret;
+}
+
+int ObHashJoin::convert_build_row(const int64_t build_idx)
+{
+  int ret = OB_SUCCESS;
+  const ObRowStore::StoredRow *stored_row = build_rows_.at(build_idx);
+  if (OB_SUCCESS != (ret = ObRowUtil::convert(stored_row->get_compact_row(), build_row_)))
+  {
+    TBSYS_LOG(WARN, "failed to convert compact row, err=%d", ret);
+  }
+  return ret;
+}
+
+int ObHashJoin::curr_row_is_qualified(bool &is_qualified)
+{
+  int ret = OB_SUCCESS;
+  is_qualified = true;
+  const ObObj *res = NULL;
+  for (int64_t i = 0; i < other_join_conds_.count(); ++i)
+  {
+    ObSqlExpression &expr = other_join_conds_.at(i);
+    if (OB_SUCCESS != (ret = expr.calc(curr_row_, res)))
+    {
+      TBSYS_LOG(WARN, "failed to calc expr, err=%d", ret);
+      break;
+    }
+    else if (!res->is_true())
+    {
+      is_qualified = false;
+      break;
+    }
+  }
+  return ret;
+}
+
+// NULL row means the columns of that side are all NULL
+int ObHashJoin::join_rows(const ObRow *left_row, const ObRow *right_row)
+{
+  int ret = OB_SUCCESS;
+  const ObObj *cell = NULL;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  ObObj null_cell;
+  null_cell.set_null();
+  const int64_t column_num = row_desc_.get_column_num();
+  for (int64_t i = 0; i < left_column_num_; ++i)
+  {
+    if (NULL == left_row)
+    {
+      cell = &null_cell;
+    }
+    else if (OB_SUCCESS != (ret = left_row->raw_get_cell(i, cell, tid, cid)))
+    {
+      TBSYS_LOG(ERROR, "unexpected branch, err=%d", ret);
+      ret = OB_ERR_UNEXPECTED;
+      break;
+    }
+    if (OB_SUCCESS != (ret = curr_row_.raw_set_cell(i, *cell)))
+    {
+      TBSYS_LOG(WARN, "failed to set cell, err=%d i=%ld", ret, i);
+      break;
+    }
+  } // end for
+  for (int64_t j = 0; OB_SUCCESS == ret && j < column_num - left_column_num_; ++j)
+  {
+    if (NULL == right_row)
+    {
+      cell = &null_cell;
+    }
+    else if (OB_SUCCESS != (ret = right_row->raw_get_cell(j, cell, tid, cid)))
+    {
+      TBSYS_LOG(ERROR, "unexpected branch, err=%d", ret);
+      ret = OB_ERR_UNEXPECTED;
+      break;
+    }
+    if (OB_SUCCESS != (ret = curr_row_.raw_set_cell(left_column_num_ + j, *cell)))
+    {
+      TBSYS_LOG(WARN, "failed to set cell, err=%d j=%ld", ret, j);
+    }
+  } // end for
+  return ret;
+}
+
+int ObHashJoin::probe_get_next_row(const common::ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  bool got_row = false;
+  const bool track_build_match = build_outer() || build_semi() || build_anti();
+  while (OB_SUCCESS == ret && !got_row)
+  {
+    if (NULL == curr_probe_row_)
+    {
+      if (OB_SUCCESS != (ret = get_next_probe_row()))
+      {
+        break;
+      }
+    }
+    // walk through the chain of build rows with the same join key
+    while (OB_SUCCESS == ret && -1 != curr_match_idx_)
+    {
+      const int64_t build_idx = curr_match_idx_;
+      bool is_qualified = false;
+      curr_match_idx_ = next_in_chain_.at(build_idx);
+      if ((build_semi() || build_anti()) && build_matched_.at(build_idx))
+      {
+        // already known to be matched
+        continue;
+      }
+      else if (OB_SUCCESS != (ret = convert_build_row(build_idx)))
+      {
+        TBSYS_LOG(WARN, "failed to convert build row, err=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = (build_left_ ? join_rows(&build_row_, curr_probe_row_)
+                                     : join_rows(curr_probe_row_, &build_row_))))
+      {
+        TBSYS_LOG(WARN, "failed to join rows, err=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = curr_row_is_qualified(is_qualified)))
+      {
+        TBSYS_LOG(WARN, "failed to test qualification, err=%d", ret);
+      }
+      else if (is_qualified)
+      {
+        curr_probe_matched_ = true;
+        if (track_build_match)
+        {
+          build_matched_.at(build_idx) = true;
+        }
+        if (probe_semi() || probe_anti())
+        {
+          // the probe row is determined
+          curr_match_idx_ = -1;
+        }
+        else if (!build_semi() && !build_anti())
+        {
+          row = &curr_row_;
+          got_row = true;
+          break;
+        }
+      }
+    } // end while
+    if (OB_SUCCESS == ret && !got_row)
+    {
+      // no more build rows match the current probe row
+      if ((probe_semi() && curr_probe_matched_)
+          || (probe_anti() && !curr_probe_matched_))
+      {
+        row = curr_probe_row_;
+        got_row = true;
+      }
+      else if (probe_outer() && !curr_probe_matched_)
+      {
+        if (OB_SUCCESS != (ret = (build_left_ ? join_rows(NULL, curr_probe_row_)
+                                  : join_rows(curr_probe_row_, NULL))))
+        {
+          TBSYS_LOG(WARN, "failed to join rows, err=%d", ret);
+        }
+        else
+        {
+          row = &curr_row_;
+          got_row = true;
+        }
+      }
+      curr_probe_row_ = NULL;
+    }
+  } // end while
+  return ret;
+}
+
+int ObHashJoin::output_build_get_next_row(const common::ObRow *&row)
+{
+  int ret = OB_ITER_END;
+  while (curr_build_idx_ < build_rows_.count())
+  {
+    const int64_t build_idx = curr_build_idx_++;
+    const bool matched = build_matched_.at(build_idx);
+    if ((build_semi() && matched) || (build_anti() && !matched))
+    {
+      if (OB_SUCCESS == (ret = convert_build_row(build_idx)))
+      {
+        row = &build_row_;
+      }
+      break;
+    }
+    else if (build_outer() && !matched)
+    {
+      if (OB_SUCCESS == (ret = convert_build_row(build_idx)))
+      {
+        if (OB_SUCCESS != (ret = (build_left_ ? join_rows(&build_row_, NULL)
+                                  : join_rows(NULL, &build_row_))))
+        {
+          TBSYS_LOG(WARN, "failed to join rows, err=%d", ret);
+        }
+        else
+        {
+          row = &curr_row_;
+        }
+      }
+      break;
+    }
+  } // end while
+  return ret;
+}
+
+int ObHashJoin::get_next_row(const common::ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  bool got_row = false;
+  if (OB_UNLIKELY(NULL != my_phy_plan_ && my_phy_plan_->is_timeout()))
+  {
+    TBSYS_LOG(WARN, "execution timeout, ts=%ld", my_phy_plan_->get_timeout_timestamp());
+    ret = OB_PROCESS_TIMEOUT;
+  }
+  while (OB_SUCCESS == ret && !got_row)
+  {
+    switch(stage_)
+    {
+      case PROBE_ROWS:
+        if (OB_SUCCESS == (ret = probe_get_next_row(row)))
+        {
+          got_row = true;
+        }
+        else if (OB_ITER_END == ret)
+        {
+          ret = OB_SUCCESS;
+          curr_build_idx_ = 0;
+          if (build_outer() || build_semi() || build_anti())
+          {
+            stage_ = OUTPUT_BUILD_ROWS;
+          }
+          else
+          {
+            stage_ = has_dumped_ ? NEXT_PARTITION : PROBE_END;
+          }
+        }
+        break;
+      case OUTPUT_BUILD_ROWS:
+        if (OB_SUCCESS == (ret = output_build_get_next_row(row)))
+        {
+          got_row = true;
+        }
+        else if (OB_ITER_END == ret)
+        {
+          ret = OB_SUCCESS;
+          stage_ = has_dumped_ ? NEXT_PARTITION : PROBE_END;
+        }
+        break;
+      case NEXT_PARTITION:
+        if (OB_SUCCESS == (ret = get_next_partition()))
+        {
+          stage_ = PROBE_ROWS;
+        }
+        else if (OB_ITER_END == ret)
+        {
+          ret = OB_SUCCESS;
+          stage_ = PROBE_END;
+        }
+        break;
+      default:
+        ret = OB_ITER_END;
+        break;
+    }
+  } // end while
+  return ret;
+}
+
+int64_t ObHashJoin::to_string(char* buf, const int64_t buf_len) const
+{
+  int64_t pos = 0;
+  databuff_printf(buf, buf_len, pos, "Hash(build=%s) ", build_left_ ? "left" : "right");
+  pos += ObJoin::to_string(buf + pos, buf_len - pos);
+  return pos;
+}
@@ -0,0 +1,180 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_hash_join.h
+ *
+ */
+#ifndef _OB_HASH_JOIN_H
+#define _OB_HASH_JOIN_H 1
+#include "ob_join.h"
+#include "ob_run_file.h"
+#include "common/ob_row.h"
+#include "common/ob_array.h"
+#include "common/ob_row_store.h"
+#include "common/ob_rowkey.h"
+#include "common/hash/ob_hashmap.h"
+
+namespace oceanbase
+{
+  namespace sql
+  {
+    // 不要求输入有序，只支持带等值join条件的join，支持所有join类型
+    // 1. open()时读入build端(默认是右孩子，应当是较小的一端)的所有行，按等值join列的hash值分区；
+    //    内存超过mem_size_limit_时把所有分区dump到run file，之后probe端的行也按分区dump (Grace hash join)
+    //    加载时仍然超过内存限制的分区用另一个hash种子再分区，最多MAX_REPARTITION_LEVEL层
+    // 2. 在内存中的build行上建hash表，同一join key的行串成链表；逐行读probe端，在hash表中查找匹配的行
+    // 3. 对于需要输出build端未匹配行(或已匹配行)的join类型，probe结束后再扫一遍build行
+    // @note join key中含NULL的行不会与任何行匹配
+    // @note semi/anti semi join只输出被保留一端的列
+    class ObHashJoin: public ObJoin
+    {
+      public:
+        ObHashJoin();
+        virtual ~ObHashJoin();
+        virtual int open();
+        virtual int close();
+        virtual int set_join_type(const ObJoin::JoinType join_type);
+        virtual int get_next_row(const common::ObRow *&row);
+        virtual int get_row_desc(const common::ObRowDesc *&row_desc) const;
+        virtual int64_t to_string(char* buf, const int64_t buf_len) const;
+        virtual ObPhyOperatorType get_type() const;
+
+        /// build the hash table on the left child instead of the right one
+        void set_build_left(const bool build_left);
+        bool is_build_left() const;
+        /// set the number of partitions used when spilling, should be in [1, MAX_PARTITION_NUM]
+        int set_partition_num(const int64_t partition_num);
+        int64_t get_partition_num() const;
+        /// the memory limit of the build side, 0 means no limit
+        void set_mem_size_limit(const int64_t limit);
+        /// the run file used to dump partitions when exceeding the mem limit
+        int set_run_filename(const common::ObString &filename);
+      private:
+        // types and constants
+        static const int64_t DEFAULT_PARTITION_NUM = 16;
+        static const int64_t MAX_PARTITION_NUM = 256;
+        static const int64_t JOIN_HASH_MAP_SIZE = 64*1024;
+        static const uint32_t PARTITION_HASH_SEED = 0x5bd1e995;
+        // a partition with too many rows of the same join key can not be split by hashing,
+        // it is loaded as a whole after being repartitioned this many times
+        static const int64_t MAX_REPARTITION_LEVEL = 3;
+        enum ProbeStage
+        {
+          PROBE_ROWS,               // probe the hash table with the probe rows
+          OUTPUT_BUILD_ROWS,        // output the (un)matched build rows
+          NEXT_PARTITION,           // load the next dumped partition
+          PROBE_END
+        };
+        typedef common::hash::ObHashMap<common::ObRowkey, int64_t,
+                                        common::hash::NoPthreadDefendMode> JoinMap;
+        typedef common::ObArray<const common::ObRowStore::StoredRow*> PartitionRows;
+        // a partition in the run file, the build rows and the probe rows are in two buckets
+        struct SpilledPartition
+        {
+          int64_t build_bucket_;    // -1 if no build rows
+          int64_t probe_bucket_;    // -1 if no probe rows
+          int64_t level_;           // times of repartitioning
+        };
+      private:
+        // disallow copy
+        ObHashJoin(const ObHashJoin &other);
+        ObHashJoin& operator=(const ObHashJoin &other);
+        // function members
+        int cons_row_desc(const common::ObRowDesc &rd1, const common::ObRowDesc &rd2);
+        int cons_key_columns();
+        int consume_build_input();
+        int add_build_row(const common::ObRow &row, const uint32_t hash_seed);
+        int add_probe_row(const common::ObRow &row, const uint32_t hash_seed, const int64_t bucket_offset);
+        bool need_dump(const common::ObRowStore &store) const;
+        int dump_partitions(common::ObRowStore &store, const int64_t bucket_offset, bool *dumped_flags);
+        int dump_probe_input();
+        int add_spilled_partitions(const int64_t build_offset, const int64_t probe_offset, const int64_t level);
+        int load_partition(const SpilledPartition &part, bool &oversized);
+        int repartition(const SpilledPartition &part);
+        int begin_probe_partition(const SpilledPartition &part);
+        int build_hash_table();
+        int get_next_probe_row();
+        int find_match_chain();
+        int get_next_partition();
+        int probe_get_next_row(const common::ObRow *&row);
+        int output_build_get_next_row(const common::ObRow *&row);
+        int join_rows(const common::ObRow *left_row, const common::ObRow *right_row);
+        int curr_row_is_qualified(bool &is_qualified);
+        int convert_build_row(const int64_t build_idx);
+        void free_run_file();
+        bool probe_outer() const;
+        bool build_outer() const;
+        bool probe_semi() const;
+        bool build_semi() const;
+        bool probe_anti() const;
+        bool build_anti() const;
+      private:
+        // data members
+        bool build_left_;
+        int64_t partition_num_;
+        int64_t mem_size_limit_;
+        common::ObArray<ExprItem::SqlCellInfo> build_keys_;
+        common::ObArray<ExprItem::SqlCellInfo> probe_keys_;
+        common::ObRowDesc row_desc_;        // left columns + right columns
+        const common::ObRowDesc *build_row_desc_;
+        const common::ObRowDesc *probe_row_desc_;
+        int64_t left_column_num_;
+        common::ObRowStore row_store_;      // build rows
+        common::ObRowStore probe_store_;    // probe rows to be dumped
+        PartitionRows partition_rows_[MAX_PARTITION_NUM];
+        bool partition_dumped_[MAX_PARTITION_NUM];          // of the current partitioning pass
+        bool probe_partition_dumped_[MAX_PARTITION_NUM];
+        bool has_dumped_;
+        common::ObArray<SpilledPartition> spilled_partitions_;  // partitions to be joined
+        int64_t next_bucket_idx_;
+        char run_filename_buf_[common::OB_MAX_FILE_NAME_LENGTH];
+        common::ObString run_filename_;
+        ObRunFile run_file_;
+        // the hash table of build rows in memory
+        JoinMap join_map_;
+        PartitionRows build_rows_;
+        common::ObArray<int64_t> next_in_chain_;
+        common::ObArray<bool> build_matched_;
+        // iterating state
+        ProbeStage stage_;
+        int64_t probe_run_count_;
+        int64_t curr_probe_run_idx_;
+        const common::ObRow *curr_probe_row_;
+        bool curr_probe_matched_;
+        int64_t curr_match_idx_;
+        int64_t curr_build_idx_;
+        common::ObObj probe_key_cells_[common::OB_MAX_ROWKEY_COLUMN_NUMBER];
+        common::ObRow probe_row_buf_;       // probe row read from the run file
+        common::ObRow build_row_;
+        common::ObRow curr_row_;
+    };
+
+    inline void ObHashJoin::set_build_left(const bool build_left)
+    {
+      build_left_ = build_left;
+    }
+
+    inline bool ObHashJoin::is_build_left() const
+    {
+      return build_left_;
+    }
+
+    inline int64_t ObHashJoin::get_partition_num() const
+    {
+      return partition_num_;
+    }
+
+    inline void ObHashJoin::set_mem_size_limit(const int64_t limit)
+    {
+      mem_size_limit_ = limit;
+    }
+  } // end namespace sql
+} // end namespace oceanbase
+
+#endif /* _OB_HASH_JOIN_H */
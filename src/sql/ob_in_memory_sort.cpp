@@ -14,12 +14,15 @@
  *
  */
 #include "ob_in_memory_sort.h"
+#include "ob_sort_worker_pool.h"
 #include "common/ob_row_util.h"
+#include "tbsys.h"
+#include <algorithm>
 using namespace oceanbase::sql;
 using namespace oceanbase::common;
 
 ObInMemorySort::ObInMemorySort()
-  :sort_columns_(NULL), sort_array_get_pos_(0), row_desc_(NULL)
+  :sort_columns_(NULL), sort_thread_count_(1), sort_array_get_pos_(0), row_desc_(NULL)
 {
 }
 
@@ -51,6 +54,14 @@ void ObInMemorySort::reset()
   row_desc_ = NULL;
 }
 
+void ObInMemorySort::reuse()
+{
+  row_store_.clear_rows();
+  sort_array_.clear();
+  sort_array_get_pos_ = 0;
+  row_desc_ = NULL;
+}
+
 int ObInMemorySort::add_row(const common::ObRow &row)
 {
   int ret = OB_SUCCESS;
@@ -102,11 +113,45 @@ struct ObInMemorySort::Comparer
     const common::ObArray<ObSortColumn> &sort_columns_;
 };
 
+// sort one chunk of the rows in each task
+class ObInMemorySort::SortChunkTask: public ObSortTask
+{
+  public:
+    SortChunkTask()
+      :rows_(NULL), begin_(0), end_(0), comparer_(NULL)
+    {
+    }
+    virtual ~SortChunkTask()
+    {
+    }
+    void set_chunk(const common::ObRowStore::StoredRow **rows, const int64_t begin,
+                   const int64_t end, const Comparer &comparer)
+    {
+      rows_ = rows;
+      begin_ = begin;
+      end_ = end;
+      comparer_ = &comparer;
+    }
+    virtual void process()
+    {
+      std::sort(rows_ + begin_, rows_ + end_, *comparer_);
+    }
+  private:
+    const common::ObRowStore::StoredRow **rows_;
+    int64_t begin_;
+    int64_t end_;
+    const Comparer *comparer_;
+};
+
 int ObInMemorySort::sort_rows()
 {
   int ret = OB_SUCCESS;
   OB_ASSERT(sort_columns_);
-  if (0 < sort_array_.count())
+  if (1 < sort_thread_count_ && MIN_PARALLEL_SORT_ROW_COUNT <= sort_array_.count())
+  {
+    ret = parallel_sort_rows();
+  }
+  else if (0 < sort_array_.count())
   {
     TBSYS_LOG(DEBUG, "sort rows, count=%ld", sort_array_.count());
     const common::ObRowStore::StoredRow **first_row = &sort_array_.at(0);
@@ -115,6 +160,60 @@ int ObInMemorySort::sort_rows()
   return ret;
 }
 
+// the chunks are sorted by the shared ObSortWorkerPool and the first one in the calling thread
+int ObInMemorySort::parallel_sort_rows()
+{
+  int ret = OB_SUCCESS;
+  const int64_t row_count = sort_array_.count();
+  int64_t chunk_count = std::min(sort_thread_count_, row_count / (MIN_PARALLEL_SORT_ROW_COUNT / 2));
+  if (MAX_SORT_CHUNK_COUNT < chunk_count)
+  {
+    chunk_count = MAX_SORT_CHUNK_COUNT;
+  }
+  const common::ObRowStore::StoredRow **first_row = &sort_array_.at(0);
+  Comparer comparer(*sort_columns_);
+  SortChunkTask tasks[MAX_SORT_CHUNK_COUNT];
+  bool submitted[MAX_SORT_CHUNK_COUNT];
+  ObSortWorkerPool &pool = ObSortWorkerPool::get_instance();
+  int64_t submitted_count = 0;
+  for (int64_t i = 0; i < chunk_count; ++i)
+  {
+    tasks[i].set_chunk(first_row, get_chunk_begin(row_count, chunk_count, i),
+                       get_chunk_begin(row_count, chunk_count, i + 1), comparer);
+    submitted[i] = (0 < i && OB_SUCCESS == pool.submit(tasks[i]));
+    if (submitted[i])
+    {
+      ++submitted_count;
+    }
+  }
+  // the chunks failed to submit are sorted in this thread
+  for (int64_t i = 0; i < chunk_count; ++i)
+  {
+    if (submitted[i])
+    {
+      pool.wait(tasks[i]);
+    }
+    else
+    {
+      tasks[i].process();
+    }
+  }
+  TBSYS_LOG(DEBUG, "parallel sort rows, count=%ld chunk_count=%ld submitted_count=%ld",
+            row_count, chunk_count, submitted_count);
+  // merge the sorted chunks
+  for (int64_t width = 1; width < chunk_count; width *= 2)
+  {
+    for (int64_t i = 0; i + width < chunk_count; i += 2 * width)
+    {
+      std::inplace_merge(first_row + get_chunk_begin(row_count, chunk_count, i),
+                         first_row + get_chunk_begin(row_count, chunk_count, i + width),
+                         first_row + get_chunk_begin(row_count, chunk_count, std::min(i + 2 * width, chunk_count)),
+                         comparer);
+    }
+  }
+  return ret;
+}
+
 int ObInMemorySort::get_next_row(common::ObRow &row)
 {
   int ret = OB_SUCCESS;
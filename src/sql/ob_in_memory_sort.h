@@ -47,8 +47,12 @@ namespace oceanbase
         virtual ~ObInMemorySort();
 
         int set_sort_columns(const common::ObArray<ObSortColumn> &sort_columns);
+        /// sort_rows() uses up to `count' threads for large inputs
+        void set_sort_thread_count(const int64_t count);
 
         void reset();
+        /// remove all the rows but keep the sort columns
+        void reuse();
         int add_row(const common::ObRow &row);
         int sort_rows();
 
@@ -61,15 +65,22 @@ namespace oceanbase
         int64_t get_row_count() const;
         int64_t get_used_mem_size() const;
       private:
-        // types
+        // types and constants
         struct Comparer;
+        class SortChunkTask;
+        static const int64_t MIN_PARALLEL_SORT_ROW_COUNT = 64*1024L;
+        static const int64_t MAX_SORT_CHUNK_COUNT = 32;
       private:
         // disallow copy
         ObInMemorySort(const ObInMemorySort &other);
         ObInMemorySort& operator=(const ObInMemorySort &other);
+        // function members
+        int parallel_sort_rows();
+        static int64_t get_chunk_begin(const int64_t row_count, const int64_t chunk_count, const int64_t chunk_idx);
       private:
         // data members
         const common::ObArray<ObSortColumn> *sort_columns_;
+        int64_t sort_thread_count_;
         common::ObRowStore row_store_;
         common::ObArray<const common::ObRowStore::StoredRow*> sort_array_;
         int64_t sort_array_get_pos_;
@@ -77,6 +88,17 @@ namespace oceanbase
         const common::ObRowDesc *row_desc_;
     };
 
+    inline void ObInMemorySort::set_sort_thread_count(const int64_t count)
+    {
+      sort_thread_count_ = count;
+    }
+
+    inline int64_t ObInMemorySort::get_chunk_begin(const int64_t row_count, const int64_t chunk_count,
+                                                   const int64_t chunk_idx)
+    {
+      return chunk_idx >= chunk_count ? row_count : row_count * chunk_idx / chunk_count;
+    }
+
     inline const common::ObRowDesc* ObInMemorySort::get_row_desc() const
     {
       return row_desc_;
@@ -14,6 +14,7 @@
  *
  */
 #include "ob_limit.h"
+#include "ob_sort.h"
 #include "common/utility.h"
 #include "common/ob_obj_cast.h"
 using namespace oceanbase::sql;
@@ -110,17 +111,22 @@ int ObLimit::open()
   int ret = OB_SUCCESS;
   input_count_ = 0;
   output_count_ = 0;
-  if ((ret = ObSingleChildPhyOperator::open()) != OB_SUCCESS)
-  {
-    TBSYS_LOG(WARN, "Failed to open child_op, err=%d", ret);
-  }
-  else if ((ret = get_limit(limit_, offset_)) != OB_SUCCESS)
+  if ((ret = get_limit(limit_, offset_)) != OB_SUCCESS)
   {
     TBSYS_LOG(WARN, "Failed to instantiate limit/offset, err=%d", ret);
   }
   else
   {
     is_instantiated_ = true;
+    // ORDER BY ... LIMIT: the sort only needs to keep the first offset+limit rows
+    if (0 <= limit_ && NULL != child_op_ && PHY_SORT == child_op_->get_type())
+    {
+      static_cast<ObSort*>(child_op_)->set_topn(limit_ + offset_);
+    }
+    if ((ret = ObSingleChildPhyOperator::open()) != OB_SUCCESS)
+    {
+      TBSYS_LOG(WARN, "Failed to open child_op, err=%d", ret);
+    }
   }
   return ret;
 }
@@ -73,7 +73,7 @@ namespace oceanbase
         return ret;
       }
 
-        int fill_result_set(ObResultSet& result_set, ObSQLSessionInfo *session_info, common::StackAllocator &alloc);
+        int fill_result_set(ObResultSet& result_set, ObSQLSessionInfo *session_info, common::ObIAllocator &alloc);
 
       uint64_t generate_table_id()
       {
@@ -21,14 +21,21 @@ using namespace oceanbase::common;
 
 ObMergeSort::ObMergeSort()
   :final_run_(NULL), sort_columns_(NULL),
-   need_push_heap_(false),
-   dump_run_count_(0), row_desc_(NULL)
+   need_replay_(false),
+   dump_run_count_(0), merge_mem_size_(0), row_desc_(NULL),
+   dump_task_(*this), is_dumping_(false)
 {
   run_filename_buf_[0] = '\0';
 }
 
 ObMergeSort::~ObMergeSort()
 {
+  wait_dump();
+}
+
+void ObMergeSort::set_merge_mem_size(const int64_t mem_size)
+{
+  merge_mem_size_ = mem_size;
 }
 
 void ObMergeSort::set_sort_columns(const common::ObArray<ObSortColumn> &sort_columns)
@@ -55,6 +62,7 @@ int ObMergeSort::set_run_filename(const common::ObString &filename)
 void ObMergeSort::reset()
 {
   int ret = OB_SUCCESS;
+  wait_dump();
   if (run_file_.is_opened())
   {
     if (OB_SUCCESS != (ret = run_file_.close()))
@@ -72,6 +80,11 @@ void ObMergeSort::reset()
   }
   dump_run_count_ = 0;
   row_desc_ = NULL;
+  merge_runs_.clear();
+  merge_tree_.clear();
+  sort_column_idx_.clear();
+  final_run_ = NULL;
+  need_replay_ = false;
 }
 
 int ObMergeSort::dump_run(ObInMemorySort &rows)
@@ -119,6 +132,7 @@ int ObMergeSort::dump_run(ObInMemorySort &rows)
           {
             row_desc_ = rows.get_row_desc();
           }
+          ++dump_run_count_;
           TBSYS_LOG(INFO, "dump run, row_count=%ld", rows.get_row_count());
         }
       }
@@ -127,190 +141,275 @@ int ObMergeSort::dump_run(ObInMemorySort &rows)
   return ret;
 }
 
+void ObMergeSort::DumpTask::process()
+{
+  if (OB_SUCCESS != (ret_ = rows_->sort_rows()))
+  {
+    TBSYS_LOG(WARN, "failed to sort, err=%d", ret_);
+  }
+  else if (OB_SUCCESS != (ret_ = merge_sort_.dump_run(*rows_)))
+  {
+    TBSYS_LOG(WARN, "failed to dump, err=%d", ret_);
+  }
+}
+
+int ObMergeSort::async_dump_run(ObInMemorySort &rows)
+{
+  int ret = OB_SUCCESS;
+  if (OB_SUCCESS != (ret = wait_dump()))
+  {
+    TBSYS_LOG(WARN, "the previous dumping failed, err=%d", ret);
+  }
+  else
+  {
+    if (NULL == row_desc_)
+    {
+      // set here rather than in dump_run() on the worker thread, so that the
+      // caller never reads it while the dump task writes it
+      row_desc_ = rows.get_row_desc();
+    }
+    dump_task_.rows_ = &rows;
+    dump_task_.ret_ = OB_SUCCESS;
+    if (OB_SUCCESS != ObSortWorkerPool::get_instance().submit(dump_task_))
+    {
+      // dump in the current thread
+      TBSYS_LOG(WARN, "failed to submit dump task, dump synchronously");
+      dump_task_.process();
+      ret = dump_task_.ret_;
+    }
+    else
+    {
+      is_dumping_ = true;
+    }
+  }
+  return ret;
+}
+
+int ObMergeSort::wait_dump()
+{
+  int ret = OB_SUCCESS;
+  if (is_dumping_)
+  {
+    ObSortWorkerPool::get_instance().wait(dump_task_);
+    is_dumping_ = false;
+    ret = dump_task_.ret_;
+  }
+  return ret;
+}
+
 void ObMergeSort::set_final_run(ObInMemorySort &rows)
 {
   final_run_ = &rows;
 }
 
-struct ObMergeSort::HeapComparer
+bool ObMergeSort::is_before(const int64_t run_idx1, const int64_t run_idx2) const
 {
-  HeapComparer(const common::ObArray<ObSortColumn> &sort_columns)
-    :sort_columns_(sort_columns)
+  bool ret = false;
+  const int64_t run_count = merge_runs_.count();
+  if (run_count == run_idx1)
+  {
+    // the virtual minimum, only used while building the tree
+    ret = true;
+  }
+  else if (run_count == run_idx2)
+  {
+    ret = false;
+  }
+  else if (merge_runs_.at(run_idx1).is_end_)
+  {
+    ret = false;
+  }
+  else if (merge_runs_.at(run_idx2).is_end_)
   {
+    ret = true;
   }
-  bool operator()(const RowRun &r1, const RowRun &r2) const
+  else
   {
-    bool ret = false;
+    const ObRow &row1 = merge_runs_.at(run_idx1).row_;
+    const ObRow &row2 = merge_runs_.at(run_idx2).row_;
     const ObObj *cell1 = NULL;
     const ObObj *cell2 = NULL;
-    for (int32_t i = 0; i < sort_columns_.count(); ++i)
+    bool is_equal = true;
+    for (int64_t i = 0; i < sort_column_idx_.count(); ++i)
     {
-      if (OB_SUCCESS != (ret = r1.first.get_cell(sort_columns_.at(i).table_id_,
-                                                 sort_columns_.at(i).column_id_, cell1)))
+      if (OB_SUCCESS != row1.raw_get_cell(sort_column_idx_.at(i), cell1)
+          || OB_SUCCESS != row2.raw_get_cell(sort_column_idx_.at(i), cell2))
       {
-        TBSYS_LOG(ERROR, "failed to get cell, err=%d", ret);
+        TBSYS_LOG(ERROR, "failed to get cell, idx=%ld", sort_column_idx_.at(i));
         break;
       }
-      else if (OB_SUCCESS != (ret = r2.first.get_cell(sort_columns_.at(i).table_id_,
-                                                      sort_columns_.at(i).column_id_, cell2)))
+      else if (*cell1 < *cell2)
       {
-        TBSYS_LOG(ERROR, "failed to get cell, err=%d", ret);
+        ret = sort_columns_->at(i).is_ascending_;
+        is_equal = false;
+        break;
       }
-      else
+      else if (*cell1 > *cell2)
       {
-        if (*cell1 < *cell2)
-        {
-          ret = !sort_columns_.at(i).is_ascending_;
-          break;
-        }
-        else if (*cell1 > *cell2)
-        {
-          ret = sort_columns_.at(i).is_ascending_;
-          break;
-        }
+        ret = !sort_columns_->at(i).is_ascending_;
+        is_equal = false;
+        break;
       }
     } // end for
-    return ret;
+    if (is_equal)
+    {
+      ret = run_idx1 < run_idx2;
+    }
+  }
+  return ret;
+}
+
+void ObMergeSort::adjust_merge_tree(int64_t run_idx)
+{
+  const int64_t run_count = merge_runs_.count();
+  for (int64_t parent = (run_idx + run_count) / 2; 0 < parent; parent /= 2)
+  {
+    if (is_before(merge_tree_.at(parent), run_idx))
+    {
+      // the loser stays in the node, the winner goes up
+      std::swap(merge_tree_.at(parent), run_idx);
+    }
   }
-  private:
-    const common::ObArray<ObSortColumn> &sort_columns_;
-};
+  merge_tree_.at(0) = run_idx;
+}
 
-int ObMergeSort::build_merge_heap()
+int ObMergeSort::read_next_row(const int64_t run_idx)
 {
   int ret = OB_SUCCESS;
-  common::ObRow row;
-  OB_ASSERT(row_desc_);
-  row.set_row_desc(*row_desc_);
-  if (OB_SUCCESS != (ret = run_file_.begin_read_bucket(SORT_RUN_FILE_BUCKET_ID, dump_run_count_)))
+  MergeRun &merge_run = merge_runs_.at(run_idx);
+  if (run_idx < dump_run_count_)
   {
-    TBSYS_LOG(WARN, "failed to begin to read backet, err=%d", ret);
+    ret = run_file_.get_next_row(run_idx, merge_run.row_);
   }
   else
   {
-    heap_array_.clear();
-    heap_array_.reserve(static_cast<int32_t>(dump_run_count_+1));
-    for (int64_t i = 0; i < dump_run_count_; ++i)
-    {
-      if (OB_SUCCESS != (ret = run_file_.get_next_row(i, row)))
-      {
-        TBSYS_LOG(WARN, "failed to read next row, err=%d i=%ld", ret, i);
-        break;
-      }
-      else if (OB_SUCCESS != (ret = heap_array_.push_back(std::make_pair(row, i))))
-      {
-        TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
-        break;
-      }
-    } // end for
+    // the last in-memory run
+    ret = final_run_->get_next_row(merge_run.row_);
   }
-
-  if (OB_SUCCESS == ret)
+  if (OB_ITER_END == ret)
   {
-    if (NULL != final_run_ && 0 < final_run_->get_row_count())
-    {
-      if (OB_SUCCESS != (ret = final_run_->get_next_row(row)))
-      {
-        TBSYS_LOG(WARN, "failed th get the first row, err=%d", ret);
-      }
-      else if (OB_SUCCESS != (ret = heap_array_.push_back(std::make_pair(row, dump_run_count_))))
-      {
-        TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
-      }
-    }
+    TBSYS_LOG(INFO, "end of run, run_idx=%ld run_count=%ld", run_idx, merge_runs_.count());
+    merge_run.is_end_ = true;
+    ret = OB_SUCCESS;
   }
-  if (OB_SUCCESS == ret)
+  else if (OB_SUCCESS != ret)
   {
-    OB_ASSERT(2 <= heap_array_.count());
-    OB_ASSERT(sort_columns_);
-    TBSYS_LOG(INFO, "build merge heap, size=%ld sort_columns_count=%ld",
-              heap_array_.count(), sort_columns_->count());
-    need_push_heap_ = false;
-    RowRun *first_row = &heap_array_.at(0);
-    std::make_heap(first_row, first_row+heap_array_.count(), HeapComparer(*sort_columns_));
+    TBSYS_LOG(WARN, "failed to read next row, err=%d run_idx=%ld", ret, run_idx);
   }
   return ret;
 }
 
-
-int ObMergeSort::get_next_row(const common::ObRow *&row)
+int ObMergeSort::build_merge_tree()
 {
   int ret = OB_SUCCESS;
-  if (0 >= heap_array_.count())
+  int64_t run_count = 0;
+  OB_ASSERT(sort_columns_);
+  merge_runs_.clear();
+  merge_tree_.clear();
+  sort_column_idx_.clear();
+  if (OB_SUCCESS != (ret = wait_dump()))
   {
-    if (OB_SUCCESS != (ret = run_file_.end_read_bucket()))
+    TBSYS_LOG(WARN, "failed to dump run, err=%d", ret);
+  }
+  else
+  {
+    OB_ASSERT(row_desc_);
+    run_count = dump_run_count_ + ((NULL != final_run_ && 0 < final_run_->get_row_count()) ? 1 : 0);
+    if (0 < merge_mem_size_ && 0 < dump_run_count_)
     {
-      TBSYS_LOG(WARN, "failed to end read backet, err=%d", ret);
+      run_file_.set_read_block_size(merge_mem_size_ / dump_run_count_);
+    }
+    if (OB_SUCCESS != (ret = run_file_.begin_read_bucket(SORT_RUN_FILE_BUCKET_ID, dump_run_count_)))
+    {
+      TBSYS_LOG(WARN, "failed to begin to read backet, err=%d", ret);
     }
-    ret = OB_ITER_END;
-    TBSYS_LOG(INFO, "end of merge sort");
   }
-  else if (need_push_heap_)
+  for (int64_t i = 0; OB_SUCCESS == ret && i < sort_columns_->count(); ++i)
   {
-    RowRun *first_row = &heap_array_.at(0);
-    RowRun *last_pop_row = first_row+heap_array_.count()-1;
-    int64_t run_idx = last_pop_row->second;
-    // get the next row from the run_idx run
-    if (run_idx < dump_run_count_)
+    const int64_t idx = row_desc_->get_idx(sort_columns_->at(i).table_id_, sort_columns_->at(i).column_id_);
+    if (OB_INVALID_INDEX == idx)
     {
-      if (OB_SUCCESS != (ret = run_file_.get_next_row(run_idx, last_pop_row->first)))
-      {
-        if (OB_ITER_END == ret)
-        {
-          heap_array_.pop_back();
-          TBSYS_LOG(INFO, "end of dumped run, run_idx=%ld run_count=%ld", run_idx, heap_array_.count());
-        }
-        else
-        {
-          TBSYS_LOG(WARN, "failed to read next row, err=%d i=%ld", ret, run_idx);
-        }
-      }
+      TBSYS_LOG(ERROR, "sort column not in the row, tid=%lu cid=%lu",
+                sort_columns_->at(i).table_id_, sort_columns_->at(i).column_id_);
+      ret = OB_ERR_UNEXPECTED;
     }
-    else
+    else if (OB_SUCCESS != (ret = sort_column_idx_.push_back(idx)))
+    {
+      TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    MergeRun merge_run;
+    merge_run.row_.set_row_desc(*row_desc_);
+    merge_runs_.reserve(run_count);
+    merge_tree_.reserve(run_count);
+    for (int64_t i = 0; OB_SUCCESS == ret && i < run_count; ++i)
     {
-      // the last in-memory run
-      if (OB_SUCCESS != (ret = final_run_->get_next_row(last_pop_row->first)))
+      if (OB_SUCCESS != (ret = merge_runs_.push_back(merge_run)))
       {
-        if (OB_ITER_END == ret)
-        {
-          TBSYS_LOG(INFO, "end of the in-memory run, run_idx=%ld run_count=%ld", run_idx, heap_array_.count());
-          heap_array_.pop_back();
-        }
-        else
-        {
-          TBSYS_LOG(WARN, "failed to get next row, err=%d i=%ld", ret, run_idx);
-        }
+        TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+      }
+      // initialized with the virtual minimum
+      else if (OB_SUCCESS != (ret = merge_tree_.push_back(run_count)))
+      {
+        TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
       }
     }
-    // push heap
-    if (OB_SUCCESS == ret)
+    for (int64_t i = 0; OB_SUCCESS == ret && i < run_count; ++i)
     {
-      std::push_heap(first_row, first_row+heap_array_.count(), HeapComparer(*sort_columns_));
+      ret = read_next_row(i);
     }
-    else if (OB_ITER_END == ret)
+  }
+  if (OB_SUCCESS == ret)
+  {
+    for (int64_t i = run_count - 1; i >= 0; --i)
     {
-      ret = OB_SUCCESS;
+      adjust_merge_tree(i);
     }
+    need_replay_ = false;
+    TBSYS_LOG(INFO, "build merge tree, run_count=%ld sort_columns_count=%ld read_block_size=%ld",
+              run_count, sort_columns_->count(), run_file_.get_read_block_size());
   }
+  return ret;
+}
 
-  if (OB_SUCCESS == ret && 0 >= heap_array_.count())
+int ObMergeSort::get_next_row(const common::ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  int64_t winner = 0;
+  if (0 >= merge_tree_.count())
   {
-    if (OB_SUCCESS != (ret = run_file_.end_read_bucket()))
+    ret = OB_ITER_END;
+  }
+  else if (need_replay_)
+  {
+    // get the next row from the run of the last winner
+    winner = merge_tree_.at(0);
+    if (OB_SUCCESS == (ret = read_next_row(winner)))
     {
-      TBSYS_LOG(WARN, "failed to end read backet, err=%d", ret);
+      adjust_merge_tree(winner);
     }
-    ret = OB_ITER_END;
-    TBSYS_LOG(INFO, "end of merge sort");
   }
-
   if (OB_SUCCESS == ret)
   {
-    RowRun *first_row = &heap_array_.at(0);
-    OB_ASSERT(std::__is_heap(first_row, first_row+heap_array_.count(), HeapComparer(*sort_columns_)));
-    std::pop_heap(first_row, first_row+heap_array_.count(), HeapComparer(*sort_columns_));
-    RowRun *next_row = first_row+heap_array_.count()-1;
-    row = &next_row->first;
-    need_push_heap_ = true;
+    winner = merge_tree_.at(0);
+    if (merge_runs_.at(winner).is_end_)
+    {
+      // all the runs are ended
+      if (OB_SUCCESS != (ret = run_file_.end_read_bucket()))
+      {
+        TBSYS_LOG(WARN, "failed to end read backet, err=%d", ret);
+      }
+      merge_tree_.clear();
+      ret = OB_ITER_END;
+      TBSYS_LOG(INFO, "end of merge sort");
+    }
+    else
+    {
+      row = &merge_runs_.at(winner).row_;
+      need_replay_ = true;
+    }
   }
   return ret;
 }
@@ -22,12 +22,15 @@
 #include "ob_run_file.h"
 #include "ob_in_memory_sort.h"
 #include "ob_sort_helper.h"
+#include "ob_sort_worker_pool.h"
 
 namespace oceanbase
 {
   namespace sql
   {
     // on-disk merge sort, used by ObSort
+    // 1. runs could be dumped by ObSortWorkerPool while the caller fills the next run, see async_dump_run()
+    // 2. the runs are merged with a loser tree
     class ObMergeSort: public ObSortHelper
     {
       public:
@@ -36,34 +39,75 @@ namespace oceanbase
 
         int set_run_filename(const common::ObString &filename);
         void set_sort_columns(const common::ObArray<ObSortColumn> &sort_columns);
+        /// memory for reading the runs while merging, used to decide the read-ahead size of each run
+        void set_merge_mem_size(const int64_t mem_size);
 
         void reset();
         int dump_run(ObInMemorySort &rows);
+        /**
+         * sort `rows' and dump it in the shared sort worker threads
+         * wait for the previous dumping first if there is one
+         * @note `rows' should not be touched until wait_dump() returns
+         */
+        int async_dump_run(ObInMemorySort &rows);
+        /// wait for the background dumping, return its result
+        int wait_dump();
         void set_final_run(ObInMemorySort &rows);
-        int build_merge_heap();
+        int build_merge_tree();
 
-        /// @pre build_heap()
+        /// @pre build_merge_tree()
         virtual int get_next_row(const common::ObRow *&row);
       private:
         // types and constants
         static const int64_t SORT_RUN_FILE_BUCKET_ID = 0;
-        struct HeapComparer;
-        typedef std::pair<common::ObRow, int64_t> RowRun;
+        struct MergeRun
+        {
+          common::ObRow row_;
+          bool is_end_;
+          MergeRun()
+            :is_end_(false)
+          {
+          }
+        };
+        class DumpTask: public ObSortTask
+        {
+          public:
+            DumpTask(ObMergeSort &merge_sort)
+              :merge_sort_(merge_sort), rows_(NULL), ret_(common::OB_SUCCESS)
+            {
+            }
+            virtual void process();
+          public:
+            ObMergeSort &merge_sort_;
+            ObInMemorySort *rows_;
+            int ret_;
+        };
       private:
         // disallow copy
         ObMergeSort(const ObMergeSort &other);
         ObMergeSort& operator=(const ObMergeSort &other);
+        // function members
+        int read_next_row(const int64_t run_idx);
+        // whether run1 should be output before run2
+        bool is_before(const int64_t run_idx1, const int64_t run_idx2) const;
+        void adjust_merge_tree(int64_t run_idx);
       private:
         // data members
         char run_filename_buf_[common::OB_MAX_FILE_NAME_LENGTH];
         common::ObString run_filename_;
         ObRunFile run_file_;
-        common::ObArray<RowRun> heap_array_;
+        common::ObArray<MergeRun> merge_runs_;
+        // loser tree, merge_tree_[0] is the winner and the others are the losers of the internal nodes
+        common::ObArray<int64_t> merge_tree_;
+        common::ObArray<int64_t> sort_column_idx_;
         ObInMemorySort *final_run_;
         const common::ObArray<ObSortColumn> *sort_columns_;
-        bool need_push_heap_;
+        bool need_replay_;
         int64_t dump_run_count_;
+        int64_t merge_mem_size_;
         const common::ObRowDesc *row_desc_;
+        DumpTask dump_task_;
+        bool is_dumping_;
     };
   } // end namespace sql
 } // end namespace oceanbase
@@ -16,16 +16,88 @@
 
 #include "ob_multiple_scan_merge.h"
 #include "common/ob_row_fuse.h"
+#include "common/ob_malloc.h"
 
 using namespace oceanbase;
 using namespace sql;
 
 ObMultipleScanMerge::ObMultipleScanMerge()
   :child_context_num_(0),
-  is_cur_row_valid_(false)
+  is_cur_row_valid_(false),
+  nkey_buf_(NULL),
+  nkey_buf_child_num_(0)
 {
 }
 
+ObMultipleScanMerge::~ObMultipleScanMerge()
+{
+  if (NULL != nkey_buf_)
+  {
+    ob_free(nkey_buf_, ObModIds::OB_SQL_COMMON);
+    nkey_buf_ = NULL;
+  }
+}
+
+int ObMultipleScanMerge::alloc_nkey_buf()
+{
+  int ret = OB_SUCCESS;
+  if (NULL == nkey_buf_ || nkey_buf_child_num_ < child_num_)
+  {
+    if (NULL != nkey_buf_)
+    {
+      ob_free(nkey_buf_, ObModIds::OB_SQL_COMMON);
+      nkey_buf_child_num_ = 0;
+    }
+    if (NULL == (nkey_buf_ = (char*)ob_malloc((child_num_ + 1) * NORMALIZED_ROWKEY_BUF_SIZE,
+                                              ObModIds::OB_SQL_COMMON)))
+    {
+      TBSYS_LOG(WARN, "fail to alloc normalized rowkey buf, child_num=%d", child_num_);
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+    }
+    else
+    {
+      nkey_buf_child_num_ = child_num_;
+    }
+  }
+  return ret;
+}
+
+void ObMultipleScanMerge::normalize_rowkey(ChildContext &child_context)
+{
+  const ObRowkey *rowkey = NULL;
+  if (OB_SUCCESS != child_context.row_->get_rowkey(rowkey)
+      || OB_SUCCESS != child_context.nkey_.assign(*rowkey,
+                                                   nkey_buf_ + child_context.seq_ * NORMALIZED_ROWKEY_BUF_SIZE,
+                                                   NORMALIZED_ROWKEY_BUF_SIZE))
+  {
+    child_context.nkey_.reset();
+  }
+}
+
+bool ObMultipleScanMerge::is_same_rowkey(const ChildContext &child_context) const
+{
+  bool bret = false;
+  const ObRowkey *cur_rowkey = NULL;
+  const ObRowkey *rowkey = NULL;
+  if (cur_nkey_.is_valid() && child_context.nkey_.is_valid())
+  {
+    bret = (0 == cur_nkey_.compare(child_context.nkey_));
+  }
+  else if (OB_SUCCESS != cur_row_.get_rowkey(cur_rowkey))
+  {
+    TBSYS_LOG(WARN, "fail to get rowkey");
+  }
+  else if (OB_SUCCESS != child_context.row_->get_rowkey(rowkey))
+  {
+    TBSYS_LOG(WARN, "fail to get rowkey");
+  }
+  else
+  {
+    bret = (*cur_rowkey == *rowkey);
+  }
+  return bret;
+}
+
 int ObMultipleScanMerge::write_row(ObRow &row)
 {
   int ret = OB_SUCCESS;
@@ -65,8 +137,13 @@ bool ObMultipleScanMerge::CmpFunc::operator() (ObMultipleScanMerge::ChildContext
   bool bret = false;
   const ObRowkey *r1 = NULL;
   const ObRowkey *r2 = NULL;
+  int32_t r = 0;
 
-  if (OB_SUCCESS != a.row_->get_rowkey(r1))
+  if (a.nkey_.is_valid() && b.nkey_.is_valid())
+  {
+    r = a.nkey_.compare(b.nkey_);
+  }
+  else if (OB_SUCCESS != a.row_->get_rowkey(r1))
   {
     TBSYS_LOG(WARN, "fail to get rowkey");
   }
@@ -74,8 +151,10 @@ bool ObMultipleScanMerge::CmpFunc::operator() (ObMultipleScanMerge::ChildContext
   {
     TBSYS_LOG(WARN, "fail to get rowkey");
   }
-
-  int32_t r = r1->compare(*r2);
+  else
+  {
+    r = r1->compare(*r2);
+  }
   if (r > 0)
   {
     bret = true;
@@ -95,6 +174,11 @@ int ObMultipleScanMerge::open()
   const ObRowDesc *row_desc = NULL;
 
   child_context_num_ = 0;
+  cur_nkey_.reset();
+  if (OB_SUCCESS != (ret = alloc_nkey_buf()))
+  {
+    TBSYS_LOG(WARN, "fail to alloc normalized rowkey buf:ret[%d]", ret);
+  }
 
   for (int32_t i=0;OB_SUCCESS == ret && i<child_num_;i++)
   {
@@ -120,6 +204,7 @@ int ObMultipleScanMerge::open()
           child_context_array_[child_context_num_].child_ = child_array_[i];
           child_context_array_[child_context_num_].row_ = row;
           child_context_array_[child_context_num_].seq_ = i;
+          normalize_rowkey(child_context_array_[child_context_num_]);
           child_context_num_ ++;
         }
       }
@@ -149,8 +234,6 @@ int ObMultipleScanMerge::open()
 int ObMultipleScanMerge::get_next_row(const ObRow *&row)
 {
   int ret = OB_SUCCESS;
-  const ObRowkey *cur_rowkey = NULL;
-  const ObRowkey *rowkey = NULL;
   bool is_row_empty = false;
 
   CmpFunc cmp_func;
@@ -179,21 +262,9 @@ int ObMultipleScanMerge::get_next_row(const ObRow *&row)
       last_child_context_.child_ = NULL;
     }
 
-    if (is_cur_row_valid_)
-    {
-      if (OB_SUCCESS != (ret = cur_row_.get_rowkey(cur_rowkey)))
-      {
-        TBSYS_LOG(WARN, "fail to get rowkey:ret[%d]", ret);
-      }
-      else if (OB_SUCCESS != (ret = min_rowkey_child.row_->get_rowkey(rowkey)))
-      {
-        TBSYS_LOG(WARN, "fail to get rowkey:ret[%d]", ret);
-      }
-    }
-
     if (OB_SUCCESS == ret)
     {
-      if (!is_cur_row_valid_ || *cur_rowkey == *rowkey)
+      if (!is_cur_row_valid_ || is_same_rowkey(min_rowkey_child))
       {
         is_row_empty = !is_cur_row_valid_;
         if (OB_SUCCESS != (ret = common::ObRowFuse::fuse_row(*(min_rowkey_child.row_), cur_row_, is_row_empty, is_ups_row_)))
@@ -208,6 +279,17 @@ int ObMultipleScanMerge::get_next_row(const ObRow *&row)
             {
               TBSYS_LOG(WARN, "fail to copy rowkey:ret[%d]", ret);
             }
+            else if (min_rowkey_child.nkey_.is_valid())
+            {
+              // child的编码缓冲在它下一次get_next_row时会被覆盖
+              char *cur_nkey_buf = nkey_buf_ + child_num_ * NORMALIZED_ROWKEY_BUF_SIZE;
+              memcpy(cur_nkey_buf, min_rowkey_child.nkey_.ptr(), min_rowkey_child.nkey_.length());
+              cur_nkey_ = ObNormalizedRowkey(cur_nkey_buf, min_rowkey_child.nkey_.length());
+            }
+            else
+            {
+              cur_nkey_.reset();
+            }
           }
         }
 
@@ -253,6 +335,7 @@ int ObMultipleScanMerge::get_next_row(const ObRow *&row)
       }
       else if (OB_SUCCESS == ret)
       {
+        normalize_rowkey(min_rowkey_child);
         child_context_array_[child_context_num_] = min_rowkey_child;
         child_context_num_ ++;
         std::push_heap(&child_context_array_[0], &child_context_array_[child_context_num_], cmp_func);
@@ -18,20 +18,25 @@
 #define _OB_MULTIPLE_SCAN_MERGE_H 1
 
 #include "ob_multiple_merge.h"
+#include "common/ob_normalized_rowkey.h"
 
 namespace oceanbase
 {
   namespace sql
   {
+    // 堆中的每一行只做一次rowkey的保序编码，之后堆调整和合并同一行时只需要memcmp，
+    // 编码失败(类型不支持或者rowkey太长)的行退回ObRowkey::compare
     class ObMultipleScanMerge : public ObMultipleMerge
     {
+      static const int64_t NORMALIZED_ROWKEY_BUF_SIZE = 256;
       struct ChildContext
       {
         ObPhyOperator *child_;
         const ObRow *row_;
         int32_t seq_;
+        common::ObNormalizedRowkey nkey_;
 
-        ChildContext() : child_(NULL), row_(NULL), seq_(0)
+        ChildContext() : child_(NULL), row_(NULL), seq_(0), nkey_()
         {
         }
       };
@@ -44,7 +49,7 @@ namespace oceanbase
 
       public:
         ObMultipleScanMerge();
-        virtual ~ObMultipleScanMerge() {}
+        virtual ~ObMultipleScanMerge();
 
         int get_next_row(const ObRow *&row);
         int open();
@@ -54,6 +59,9 @@ namespace oceanbase
 
       private:
         int write_row(ObRow &row);
+        int alloc_nkey_buf();
+        void normalize_rowkey(ChildContext &child_context);
+        bool is_same_rowkey(const ChildContext &child_context) const;
 
       private:
         ChildContext child_context_array_[MAX_CHILD_OPERATOR_NUM];
@@ -61,6 +69,10 @@ namespace oceanbase
         ChildContext last_child_context_;
         int32_t child_context_num_;
         bool is_cur_row_valid_;
+        // 每个child一段编码缓冲，最后一段保存cur_row_的编码
+        char *nkey_buf_;
+        int64_t nkey_buf_child_num_;
+        common::ObNormalizedRowkey cur_nkey_;
     };
   }
 }
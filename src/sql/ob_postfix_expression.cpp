@@ -253,6 +253,7 @@ namespace oceanbase
       int ret = OB_SUCCESS;
       int i = 0;
       this->expr_.clear();
+      compiled_expr_.reset();
       if (OB_SUCCESS != (ret = str_buf_.reset()))
       {
         TBSYS_LOG(WARN, "fail to reset string buffer");
@@ -327,6 +328,7 @@ namespace oceanbase
     {
       int ret = OB_SUCCESS;
       ObObj obj2;
+      compiled_expr_.reset();
       if (obj.get_type() == ObVarcharType)
       {
         if (OB_SUCCESS != (ret = str_buf_.write_obj(obj, &obj2)))
@@ -351,6 +353,7 @@ namespace oceanbase
       ObObj item_type;
       ObObj obj, obj2;
       ObSqlSysFunc sys_func;
+      compiled_expr_.reset();
       switch(item.type_)
       {
         case T_STRING:
@@ -530,6 +533,7 @@ namespace oceanbase
     int ObPostfixExpression::merge_expr(const ObPostfixExpression &expr1, const ObPostfixExpression &expr2, const ExprItem &op)
     {
       int ret = OB_SUCCESS;
+      compiled_expr_.reset();
       for(int64_t i = 0; ret == OB_SUCCESS && i < expr1.expr_.count() - 1; i++)
       {
         ret = this->expr_.push_back(expr1.expr_[i]);
@@ -555,6 +559,64 @@ namespace oceanbase
       return ret;
     }
 
+    int ObPostfixExpression::compile()
+    {
+      int ret = OB_SUCCESS;
+      int64_t type = 0;
+      int64_t value = 0;
+      int64_t value2 = 0;
+      int64_t idx = 0;
+      compiled_expr_.reset();
+      while (OB_SUCCESS == ret && idx < expr_.count())
+      {
+        if (OB_SUCCESS != (ret = expr_[idx++].get_int(type)))
+        {
+          ret = OB_NOT_SUPPORTED;
+        }
+        else if (END == type)
+        {
+          ret = compiled_expr_.end();
+          break;
+        }
+        else if (COLUMN_IDX == type)
+        {
+          if (idx + 1 >= expr_.count()
+              || OB_SUCCESS != expr_[idx++].get_int(value)
+              || OB_SUCCESS != expr_[idx++].get_int(value2))
+          {
+            ret = OB_NOT_SUPPORTED;
+          }
+          else
+          {
+            ret = compiled_expr_.add_column(static_cast<uint64_t>(value), static_cast<uint64_t>(value2));
+          }
+        }
+        else if (CONST_OBJ == type && idx < expr_.count())
+        {
+          ret = compiled_expr_.add_const(expr_[idx++]);
+        }
+        else if (OP == type
+                 && idx + 1 < expr_.count()
+                 && OB_SUCCESS == expr_[idx++].get_int(value)
+                 && OB_SUCCESS == expr_[idx++].get_int(value2))
+        {
+          ret = compiled_expr_.add_op(static_cast<ObItemType>(value), value2);
+        }
+        else
+        {
+          ret = OB_NOT_SUPPORTED;
+        }
+      }
+      if (OB_SUCCESS != ret || !compiled_expr_.is_compiled())
+      {
+        // the expression will be interpreted
+        compiled_expr_.set_not_supported();
+        TBSYS_LOG(DEBUG, "expression not compiled, expr=%s", to_cstring(*this));
+        ret = OB_NOT_SUPPORTED;
+      }
+      return ret;
+    }
+
     int ObPostfixExpression::calc(const common::ObRow &row, const ObObj *&composite_val)
     {
       int ret = OB_SUCCESS;
@@ -565,10 +627,30 @@ namespace oceanbase
       int idx = 0;
       ObExprObj result;
       int idx_i = 0;
-      ObPostExprExtraParams *extra_params = GET_TSI_MULT(ObPostExprExtraParams, TSI_SQL_EXPR_EXTRA_PARAMS_1);
-      // get the stack for calculation
-      ObPostfixExpressionCalcStack *stack = GET_TSI_MULT(ObPostfixExpressionCalcStack, TSI_SQL_EXPR_STACK_1);
-      if (NULL == stack || NULL == extra_params)
+      bool calculated = false;
+      ObPostExprExtraParams *extra_params = NULL;
+      ObPostfixExpressionCalcStack *stack = NULL;
+      if (OB_UNLIKELY(ObCompiledExpr::NOT_COMPILED == compiled_expr_.get_state()))
+      {
+        compile();
+      }
+      if (compiled_expr_.is_compiled()
+          && OB_SUCCESS == compiled_expr_.calc(row, did_int_div_as_double_, result))
+      {
+        calculated = true;
+        if (OB_SUCCESS != (ret = result.to(result_)))
+        {
+          TBSYS_LOG(WARN, "failed to convert exprobj to obj, err=%d", ret);
+        }
+        else
+        {
+          composite_val = &result_;
+        }
+      }
+      // else not compiled or some columns are not in the row, interpret it
+      else if (NULL == (extra_params = GET_TSI_MULT(ObPostExprExtraParams, TSI_SQL_EXPR_EXTRA_PARAMS_1))
+               // get the stack for calculation
+               || NULL == (stack = GET_TSI_MULT(ObPostfixExpressionCalcStack, TSI_SQL_EXPR_STACK_1)))
       {
         TBSYS_LOG(ERROR, "no memory for postfix expression extra params and stack");
         ret = OB_ALLOCATE_MEMORY_FAILED;
@@ -579,7 +661,7 @@ namespace oceanbase
         extra_params->did_int_div_as_double_ = did_int_div_as_double_;
       }
 
-      while (OB_SUCCESS == ret)
+      while (OB_SUCCESS == ret && !calculated)
       {
         // 获得数据类型:列id、数字、操作符、结束标记
         if (OB_SUCCESS != (ret = expr_[idx++].get_int(type)))
@@ -29,6 +29,7 @@
 #include "common/ob_row.h"
 #include "common/ob_expr_obj.h"
 #include "common/ob_se_array.h"
+#include "ob_compiled_expr.h"
 using namespace oceanbase::common;
 
 namespace oceanbase
@@ -313,6 +314,8 @@ namespace oceanbase
 
         /* 将row中的值代入到expr计算结果 */
         int calc(const common::ObRow &row, const ObObj *&result);
+        /// 是否已编译成求值树，见ObCompiledExpr
+        bool is_compiled() const;
 
         /*
          * 判断表达式类型：是否是const, column_index, etc
@@ -422,6 +425,8 @@ namespace oceanbase
         // 辅助函数，检查表达式是否表示const或者column index
         int check_expr_type(const int64_t type_val, bool &is_type, const int64_t stack_len) const;
         int get_sys_func(const common::ObString &sys_func, ObSqlSysFunc &func_type) const;
+        // 第一次calc时把expr_编译成ObCompiledExpr，不支持的表达式仍然解释执行
+        int compile();
       private:
         static const int64_t DEF_STRING_BUF_SIZE = 64 * 1024L;
         static const int64_t BASIC_SYMBOL_COUNT = 64;
@@ -437,6 +442,7 @@ namespace oceanbase
         bool did_int_div_as_double_;
         ObObj result_;
         ObStringBuf str_buf_;
+        ObCompiledExpr compiled_expr_;
     }; // class ObPostfixExpression
 
     inline void ObPostfixExpression::set_int_div_as_double(bool did)
@@ -453,8 +459,14 @@ namespace oceanbase
             && END == type);
     }
 
+    inline bool ObPostfixExpression::is_compiled() const
+    {
+      return compiled_expr_.is_compiled();
+    }
+
     inline void ObPostfixExpression::reset(void)
     {
+      compiled_expr_.reset();
       str_buf_.reset();
       expr_.clear();
     }
@@ -96,7 +96,7 @@ namespace oceanbase
         int reset();
         int add_field_column(const Field & field);
         int add_param_column(const Field & field);
-        int pre_assign_params_room(const int64_t& size, common::StackAllocator &alloc);
+        int pre_assign_params_room(const int64_t& size, common::ObIAllocator &alloc);
         int fill_params(const common::ObArray<obmysql::EMySQLFieldType>& types,
                         const common::ObArray<common::ObObj>& values);
         int from_prepared(const ObResultSet& stored_result_set);
@@ -116,6 +116,7 @@ namespace oceanbase
         void set_session(ObSQLSessionInfo *s);
         ObSQLSessionInfo* get_session();
         void set_ps_transformer_allocator(common::ObArenaAllocator *allocator);
+        const common::ObArenaAllocator *get_ps_transformer_allocator() const;
       private:
         // types and constants
         static const int64_t MSG_SIZE = 512;
@@ -389,6 +390,11 @@ namespace oceanbase
       ps_trans_allocator_ = allocator;
     }
 
+    inline const common::ObArenaAllocator *ObResultSet::get_ps_transformer_allocator() const
+    {
+      return ps_trans_allocator_;
+    }
+
   } // end namespace sql
 } // end namespace oceanbase
 
@@ -753,6 +753,11 @@ int ObRpcScan::set_limit(const ObSqlExpression& limit, const ObSqlExpression& of
   return read_param_->set_limit(limit, offset);
 }
 
+int ObRpcScan::add_sort_column(const uint64_t tid, const uint64_t cid, const bool is_ascending)
+{
+  return read_param_->add_sort_column(tid, cid, is_ascending);
+}
+
 int ObRpcScan::cons_row_desc(const ObSqlGetParam &sql_get_param, ObRowDesc &row_desc)
 {
   int ret = OB_SUCCESS;
@@ -94,6 +94,8 @@ namespace oceanbase
          * @return OB_SUCCESS或错误码
          */
         int set_limit(const ObSqlExpression& limit, const ObSqlExpression& offset);
+        /// 与limit一起下压到chunkserver的排序列，每个tablet只返回排在最前面的offset+limit行
+        int add_sort_column(const uint64_t tid, const uint64_t cid, const bool is_ascending);
 
         //void set_data_version(int64_t data_version);
         int set_scan_range(const ObNewRange &range)
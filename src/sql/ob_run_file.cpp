@@ -19,7 +19,8 @@ using namespace oceanbase::sql;
 using namespace oceanbase::common;
 
 ObRunFile::ObRunFile()
-  :curr_run_trailer_(NULL), curr_run_row_count_(0)
+  :curr_run_trailer_(NULL), curr_run_row_count_(0),
+   read_block_size_(DEFAULT_READ_BLOCK_SIZE)
 {
 }
 
@@ -209,6 +210,28 @@ bool ObRunFile::RunBlock::is_end_of_run() const
   return (next_row_pos_ >= block_data_size_) && (block_offset_ + block_data_size_ >= run_end_offset_);
 }
 
+void ObRunFile::set_read_block_size(const int64_t block_size)
+{
+  const int64_t align_size = FileComponent::DirectFileReader::DEFAULT_ALIGN_SIZE;
+  if (block_size <= DEFAULT_READ_BLOCK_SIZE)
+  {
+    read_block_size_ = DEFAULT_READ_BLOCK_SIZE;
+  }
+  else if (block_size >= MAX_READ_BLOCK_SIZE)
+  {
+    read_block_size_ = MAX_READ_BLOCK_SIZE;
+  }
+  else
+  {
+    read_block_size_ = (block_size + align_size - 1) / align_size * align_size;
+  }
+}
+
+int64_t ObRunFile::get_read_block_size() const
+{
+  return read_block_size_;
+}
+
 int ObRunFile::begin_read_bucket(const int64_t bucket_idx, int64_t &run_count)
 {
   int ret = OB_SUCCESS;
@@ -233,7 +256,7 @@ int ObRunFile::begin_read_bucket(const int64_t bucket_idx, int64_t &run_count)
     while (OB_SUCCESS == ret
            && 0 < run_trailer_pos)
     {
-      if (OB_SUCCESS != (ret = run_block.assign(run_block.BLOCK_SIZE, FileComponent::DirectFileReader::DEFAULT_ALIGN_SIZE)))
+      if (OB_SUCCESS != (ret = run_block.assign(read_block_size_, FileComponent::DirectFileReader::DEFAULT_ALIGN_SIZE)))
       {
         TBSYS_LOG(ERROR, "failed to alloc block, err=%d", ret);
       }
@@ -268,8 +291,8 @@ int ObRunFile::begin_read_bucket(const int64_t bucket_idx, int64_t &run_count)
         {
           run_block.run_end_offset_ = run_trailer_pos;
           run_block.block_offset_ = run_trailer_pos - run_trailer->curr_run_size_;
-          run_block.block_data_size_ = run_trailer->curr_run_size_ < run_block.BLOCK_SIZE ?
-            run_trailer->curr_run_size_ : run_block.BLOCK_SIZE;
+          run_block.block_data_size_ = run_trailer->curr_run_size_ < read_block_size_ ?
+            run_trailer->curr_run_size_ : read_block_size_;
           run_block.next_row_pos_ = 0;
 
           run_trailer_pos = run_trailer->prev_run_trailer_pos_; // update the previous run trailer
@@ -413,8 +436,8 @@ int ObRunFile::read_next_run_block(RunBlock &run_block)
 {
   int ret = OB_SUCCESS;
   const int64_t read_offset = run_block.block_offset_ + run_block.next_row_pos_;
-  const int64_t count = (run_block.run_end_offset_ - read_offset < run_block.BLOCK_SIZE) ?
-    (run_block.run_end_offset_ - read_offset) : run_block.BLOCK_SIZE;
+  const int64_t count = (run_block.run_end_offset_ - read_offset < read_block_size_) ?
+    (run_block.run_end_offset_ - read_offset) : read_block_size_;
   run_block.block_data_size_ = count;
   run_block.block_offset_ = read_offset;
   run_block.next_row_pos_ = 0;
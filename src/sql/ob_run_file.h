@@ -39,10 +39,17 @@ namespace oceanbase
         int append_row(const common::ObString &compact_row);
         int end_append_run();
 
+        /// the size of each read of a run, i.e. the read-ahead buffer of every run
+        /// @note takes effect at the next begin_read_bucket()
+        void set_read_block_size(const int64_t block_size);
+        int64_t get_read_block_size() const;
         int begin_read_bucket(const int64_t bucket_idx, int64_t &run_count);
         /// @return OB_ITER_END when reaching the end of this run
         int get_next_row(const int64_t run_idx, common::ObRow &row);
         int end_read_bucket();
+      public:
+        static const int64_t DEFAULT_READ_BLOCK_SIZE = 2*1024*1024LL;
+        static const int64_t MAX_READ_BLOCK_SIZE = 32*1024*1024LL;
       private:
         // types and constants
         static const int64_t MAGIC_NUMBER = 0x656c69666e7572; // "runfile"
@@ -60,7 +67,6 @@ namespace oceanbase
         };
         struct RunBlock: public common::ObFileBuffer
         {
-          static const int64_t BLOCK_SIZE = 2*1024*1024LL;
           int64_t run_end_offset_;
           int64_t block_offset_;
           int64_t block_data_size_;
@@ -90,6 +96,7 @@ namespace oceanbase
         RunTrailer *curr_run_trailer_;
         common::ObArray<RunBlock> run_blocks_;
         int64_t curr_run_row_count_;
+        int64_t read_block_size_;
     };
   } // end namespace sql
 } // end namespace oceanbase
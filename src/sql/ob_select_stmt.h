@@ -136,7 +136,7 @@ namespace oceanbase
       uint64_t get_right_query_id() { return right_query_id_; }
       uint64_t get_limit_expr_id() const { return limit_count_id_; }
       uint64_t get_offset_expr_id() const { return limit_offset_id_; }
-      bool is_distinct() { return is_distinct_; }
+      bool is_distinct() const { return is_distinct_; }
       bool is_set_distinct() { return is_set_distinct_; }
       bool is_for_update() { return for_update_; }
       bool has_limit()
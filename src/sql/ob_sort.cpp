@@ -20,7 +20,7 @@ using namespace oceanbase::sql;
 using namespace oceanbase::common;
 
 ObSort::ObSort()
-  :mem_size_limit_(0), sort_reader_(&in_mem_sort_)
+  :mem_size_limit_(0), sort_thread_count_(DEFAULT_SORT_THREAD_COUNT), topn_(0), sort_reader_(&in_mem_sort_)
 {
 }
 
@@ -33,8 +33,12 @@ void ObSort::reset()
   ObSingleChildPhyOperator::clear();
   sort_columns_.clear();
   mem_size_limit_ = 0;
-  in_mem_sort_.reset();
+  sort_thread_count_ = DEFAULT_SORT_THREAD_COUNT;
+  topn_ = 0;
   merge_sort_.reset();
+  in_mem_sort_.reset();
+  dump_sort_.reset();
+  topn_sort_.reset();
   sort_reader_ = &in_mem_sort_;
 }
 
@@ -44,6 +48,16 @@ void ObSort::set_mem_size_limit(const int64_t limit)
   mem_size_limit_ = limit;
 }
 
+void ObSort::set_sort_thread_count(const int64_t count)
+{
+  sort_thread_count_ = count;
+}
+
+void ObSort::set_topn(const int64_t topn)
+{
+  topn_ = topn;
+}
+
 int ObSort::set_run_filename(const common::ObString &filename)
 {
   TBSYS_LOG(INFO, "sort run file=%.*s", filename.length(), filename.ptr());
@@ -71,6 +85,13 @@ int ObSort::open()
   {
     TBSYS_LOG(WARN, "failed to open child_op, err=%d", ret);
   }
+  else if (use_topn_sort())
+  {
+    if (OB_SUCCESS != (ret = do_topn_sort()))
+    {
+      TBSYS_LOG(WARN, "failed to sort input data, err=%d", ret);
+    }
+  }
   else if (OB_SUCCESS != (ret = do_sort()))
   {
     TBSYS_LOG(WARN, "failed to sort input data, err=%d", ret);
@@ -81,8 +102,11 @@ int ObSort::open()
 int ObSort::close()
 {
   int ret = OB_SUCCESS;
-  in_mem_sort_.reset();
+  // wait for the dumping task before freeing the rows
   merge_sort_.reset();
+  in_mem_sort_.reset();
+  dump_sort_.reset();
+  topn_sort_.reset();
   sort_reader_ = &in_mem_sort_;
   ret = ObSingleChildPhyOperator::close();
   return ret;
@@ -103,39 +127,86 @@ int ObSort::get_row_desc(const common::ObRowDesc *&row_desc) const
   return ret;
 }
 
+inline bool ObSort::use_topn_sort() const
+{
+  return 0 < topn_ && MAX_TOPN >= topn_;
+}
+
+int ObSort::do_topn_sort()
+{
+  int ret = OB_SUCCESS;
+  const common::ObRow *input_row = NULL;
+  if (OB_SUCCESS != (ret = topn_sort_.set_sort_columns(sort_columns_)))
+  {
+    TBSYS_LOG(WARN, "fail to set sort columns for topn_sort. ret=%d", ret);
+  }
+  else
+  {
+    topn_sort_.set_topn(topn_);
+    while(OB_SUCCESS == ret
+        && OB_SUCCESS == (ret = child_op_->get_next_row(input_row)))
+    {
+      if (OB_SUCCESS != (ret = topn_sort_.add_row(*input_row)))
+      {
+        TBSYS_LOG(WARN, "failed to add row, err=%d", ret);
+      }
+    } // end while
+    if (OB_ITER_END == ret)
+    {
+      ret = OB_SUCCESS;
+    }
+    if (OB_SUCCESS == ret)
+    {
+      if (OB_SUCCESS != (ret = topn_sort_.sort_rows()))
+      {
+        TBSYS_LOG(WARN, "failed to sort, err=%d", ret);
+      }
+      else
+      {
+        TBSYS_LOG(DEBUG, "topn sort, topn=%ld row_count=%ld", topn_, topn_sort_.get_row_count());
+        sort_reader_ = &topn_sort_;
+      }
+    }
+  }
+  return ret;
+}
+
 int ObSort::do_sort()
 {
   int ret = OB_SUCCESS;
   bool need_merge = false;
   const common::ObRow *input_row = NULL;
+  ObInMemorySort *in_mem_sort = &in_mem_sort_;
   if (OB_SUCCESS != (ret = in_mem_sort_.set_sort_columns(sort_columns_)))
   {
     TBSYS_LOG(WARN, "fail to set sort columns for in_mem_sort. ret=%d", ret);
   }
+  else if (OB_SUCCESS != (ret = dump_sort_.set_sort_columns(sort_columns_)))
+  {
+    TBSYS_LOG(WARN, "fail to set sort columns for dump_sort. ret=%d", ret);
+  }
   else
   {
+    in_mem_sort_.set_sort_thread_count(sort_thread_count_);
+    dump_sort_.set_sort_thread_count(sort_thread_count_);
     merge_sort_.set_sort_columns(sort_columns_); // pointer assign, return void
+    merge_sort_.set_merge_mem_size(mem_size_limit_);
     while(OB_SUCCESS == ret
         && OB_SUCCESS == (ret = child_op_->get_next_row(input_row)))
     {
-      if (OB_SUCCESS != (ret = in_mem_sort_.add_row(*input_row)))
+      if (OB_SUCCESS != (ret = in_mem_sort->add_row(*input_row)))
       {
         TBSYS_LOG(WARN, "failed to add row, err=%d", ret);
       }
-      else if (need_dump())
+      else if (need_dump(*in_mem_sort))
       {
-        if (OB_SUCCESS != (ret = in_mem_sort_.sort_rows()))
-        {
-          TBSYS_LOG(WARN, "failed to sort, err=%d", ret);
-        }
-        else if (OB_SUCCESS != (ret = merge_sort_.dump_run(in_mem_sort_)))
+        if (OB_SUCCESS != (ret = dump_run(in_mem_sort)))
         {
           TBSYS_LOG(WARN, "failed to dump, err=%d", ret);
         }
         else
         {
           TBSYS_LOG(INFO, "need merge sort");
-          in_mem_sort_.reset();
           need_merge = true;
           sort_reader_ = &merge_sort_;
         }
@@ -148,16 +219,16 @@ int ObSort::do_sort()
     if (OB_SUCCESS == ret)
     {
       // sort the last run
-      if (OB_SUCCESS != (ret = in_mem_sort_.sort_rows()))
+      if (OB_SUCCESS != (ret = in_mem_sort->sort_rows()))
       {
         TBSYS_LOG(WARN, "failed to sort, err=%d", ret);
       }
-      else if (need_merge && 0 < in_mem_sort_.get_row_count())
+      else if (need_merge)
       {
-        merge_sort_.set_final_run(in_mem_sort_);
-        if (OB_SUCCESS != (ret = merge_sort_.build_merge_heap()))
+        merge_sort_.set_final_run(*in_mem_sort);
+        if (OB_SUCCESS != (ret = merge_sort_.build_merge_tree()))
         {
-          TBSYS_LOG(WARN, "failed to build heap, err=%d", ret);
+          TBSYS_LOG(WARN, "failed to build merge tree, err=%d", ret);
         }
       }
     }
@@ -165,9 +236,55 @@ int ObSort::do_sort()
   return ret;
 }
 
-inline bool ObSort::need_dump() const
+int ObSort::dump_run(ObInMemorySort *&in_mem_sort)
+{
+  int ret = OB_SUCCESS;
+  if (1 >= sort_thread_count_)
+  {
+    if (OB_SUCCESS != (ret = in_mem_sort->sort_rows()))
+    {
+      TBSYS_LOG(WARN, "failed to sort, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = merge_sort_.dump_run(*in_mem_sort)))
+    {
+      TBSYS_LOG(WARN, "failed to dump, err=%d", ret);
+    }
+    else
+    {
+      in_mem_sort->reuse();
+    }
+  }
+  else
+  {
+    // the other buffer is free after the previous dumping finished
+    ObInMemorySort *next_sort = (&in_mem_sort_ == in_mem_sort) ? &dump_sort_ : &in_mem_sort_;
+    if (OB_SUCCESS != (ret = merge_sort_.wait_dump()))
+    {
+      TBSYS_LOG(WARN, "failed to dump, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = merge_sort_.async_dump_run(*in_mem_sort)))
+    {
+      TBSYS_LOG(WARN, "failed to dump, err=%d", ret);
+    }
+    else
+    {
+      next_sort->reuse();
+      in_mem_sort = next_sort;
+    }
+  }
+  return ret;
+}
+
+inline bool ObSort::need_dump(const ObInMemorySort &in_mem_sort) const
 {
-  return mem_size_limit_ <= 0 ? false : (in_mem_sort_.get_used_mem_size() >= mem_size_limit_);
+  bool ret = false;
+  if (0 < mem_size_limit_)
+  {
+    // two buffers are used in turn when dumping in the background
+    const int64_t limit = (1 < sort_thread_count_) ? mem_size_limit_ / 2 : mem_size_limit_;
+    ret = in_mem_sort.get_used_mem_size() >= limit;
+  }
+  return ret;
 }
 
 int ObSort::get_next_row(const common::ObRow *&row)
@@ -208,7 +325,12 @@ int64_t ObSort::to_string(char* buf, const int64_t buf_len) const
       databuff_printf(buf, buf_len, pos, ",");
     }
   }
-  databuff_printf(buf, buf_len, pos, "])\n");
+  databuff_printf(buf, buf_len, pos, "]");
+  if (0 < topn_)
+  {
+    databuff_printf(buf, buf_len, pos, ", topn=%ld", topn_);
+  }
+  databuff_printf(buf, buf_len, pos, ")\n");
   if (NULL != child_op_)
   {
     int64_t pos2 = child_op_->to_string(buf+pos, buf_len-pos);
@@ -296,6 +418,8 @@ void ObSort::assign(const ObSort &other)
 {
   sort_columns_ = other.get_sort_columns();
   mem_size_limit_ = other.get_mem_size_limit();
+  sort_thread_count_ = other.get_sort_thread_count();
+  topn_ = other.get_topn();
 }
 
 ObPhyOperatorType ObSort::get_type() const
@@ -19,11 +19,17 @@
 #include "common/ob_string.h"
 #include "ob_in_memory_sort.h"
 #include "ob_merge_sort.h"
+#include "ob_topn_sort.h"
 
 namespace oceanbase
 {
   namespace sql
   {
+    // 排序
+    // 1. 输入行先放入内存中的ObInMemorySort；超过mem_size_limit_时排序并写一个run到文件，最后用ObMergeSort归并
+    // 2. sort_thread_count_ > 1时：大的run在进程共享的ObSortWorkerPool中分块排序；两块内存轮流使用，
+    //    一块在后台排序并写run的同时，另一块继续接收输入行，此时每块内存最多使用mem_size_limit_的一半
+    // 3. 设置了topn(例如由上层的ObLimit设置)时只需要输出前topn行，用ObTopNSort在内存中保留前topn行，不写run
     class ObSort: public ObSingleChildPhyOperator
     {
       public:
@@ -35,6 +41,10 @@ namespace oceanbase
         int64_t get_sort_column_size() const;
         void set_mem_size_limit(const int64_t limit);
         int set_run_filename(const common::ObString &filename);
+        /// 1 means sorting in the calling thread only
+        void set_sort_thread_count(const int64_t count);
+        /// only the first `topn' rows are needed, 0 means all the rows
+        void set_topn(const int64_t topn);
 
         virtual int open();
         virtual int close();
@@ -45,22 +55,35 @@ namespace oceanbase
 
         void assign(const ObSort &other);
         int64_t get_mem_size_limit() const;
+        int64_t get_sort_thread_count() const;
+        int64_t get_topn() const;
         const common::ObArray<ObSortColumn>& get_sort_columns() const;
 
         NEED_SERIALIZE_AND_DESERIALIZE;
+      private:
+        static const int64_t DEFAULT_SORT_THREAD_COUNT = 4;
+        // larger topn is handled by the normal sort which could dump runs to the disk
+        static const int64_t MAX_TOPN = 64*1024L;
       private:
         // disallow copy
         ObSort(const ObSort &other);
         ObSort& operator=(const ObSort &other);
         // function members
-        bool need_dump() const;
+        bool need_dump(const ObInMemorySort &in_mem_sort) const;
+        bool use_topn_sort() const;
         int do_sort();
+        int do_topn_sort();
+        int dump_run(ObInMemorySort *&in_mem_sort);
       private:
         // data members
         common::ObArray<ObSortColumn> sort_columns_;
         int64_t mem_size_limit_;
+        int64_t sort_thread_count_;
+        int64_t topn_;
         ObInMemorySort in_mem_sort_;
+        ObInMemorySort dump_sort_;      // being dumped in the background while in_mem_sort_ is being filled
         ObMergeSort merge_sort_;
+        ObTopNSort topn_sort_;
         ObSortHelper *sort_reader_;
     };
 
@@ -68,6 +91,14 @@ namespace oceanbase
     {
       return mem_size_limit_;
     }
+    inline int64_t ObSort::get_sort_thread_count() const
+    {
+      return sort_thread_count_;
+    }
+    inline int64_t ObSort::get_topn() const
+    {
+      return topn_;
+    }
     inline int64_t ObSort::get_sort_column_size() const
     {
       return sort_columns_.count();
@@ -0,0 +1,180 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sort_worker_pool.cpp
+ *
+ */
+#include "ob_sort_worker_pool.h"
+#include "tbsys.h"
+#include <unistd.h>
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+ObSortWorkerPool &ObSortWorkerPool::get_instance()
+{
+  static ObSortWorkerPool instance;
+  return instance;
+}
+
+ObSortWorkerPool::ObSortWorkerPool()
+  :head_(NULL), tail_(NULL), thread_num_(0), stop_(false)
+{
+  pthread_mutex_init(&mutex_, NULL);
+  pthread_cond_init(&task_cond_, NULL);
+  pthread_cond_init(&done_cond_, NULL);
+}
+
+ObSortWorkerPool::~ObSortWorkerPool()
+{
+  pthread_mutex_lock(&mutex_);
+  stop_ = true;
+  pthread_cond_broadcast(&task_cond_);
+  pthread_mutex_unlock(&mutex_);
+  for (int64_t i = 0; i < thread_num_; ++i)
+  {
+    pthread_join(threads_[i], NULL);
+  }
+  thread_num_ = 0;
+  pthread_cond_destroy(&done_cond_);
+  pthread_cond_destroy(&task_cond_);
+  pthread_mutex_destroy(&mutex_);
+}
+
+// @pre mutex_ is locked
+int ObSortWorkerPool::start_threads()
+{
+  int ret = OB_SUCCESS;
+  int64_t thread_num = sysconf(_SC_NPROCESSORS_ONLN);
+  if (MAX_THREAD_NUM < thread_num)
+  {
+    thread_num = MAX_THREAD_NUM;
+  }
+  for (int64_t i = thread_num_; i < thread_num; ++i)
+  {
+    if (0 != pthread_create(&threads_[i], NULL, thread_func, this))
+    {
+      TBSYS_LOG(WARN, "failed to create sort worker thread, err=%s", strerror(errno));
+      break;
+    }
+    ++thread_num_;
+  }
+  if (0 >= thread_num_)
+  {
+    ret = OB_ERR_SYS;
+  }
+  else
+  {
+    TBSYS_LOG(INFO, "sort worker threads started, thread_num=%ld", thread_num_);
+  }
+  return ret;
+}
+
+int ObSortWorkerPool::submit(ObSortTask &task)
+{
+  int ret = OB_SUCCESS;
+  pthread_mutex_lock(&mutex_);
+  if (0 >= thread_num_ && OB_SUCCESS != (ret = start_threads()))
+  {
+    TBSYS_LOG(WARN, "no sort worker thread, err=%d", ret);
+  }
+  else
+  {
+    task.state_ = ObSortTask::TASK_QUEUED;
+    task.next_ = NULL;
+    if (NULL == tail_)
+    {
+      head_ = &task;
+    }
+    else
+    {
+      tail_->next_ = &task;
+    }
+    tail_ = &task;
+    pthread_cond_signal(&task_cond_);
+  }
+  pthread_mutex_unlock(&mutex_);
+  return ret;
+}
+
+void ObSortWorkerPool::wait(ObSortTask &task)
+{
+  pthread_mutex_lock(&mutex_);
+  if (ObSortTask::TASK_QUEUED == task.state_)
+  {
+    // not started yet, take it back from the queue
+    ObSortTask *prev = NULL;
+    ObSortTask *curr = head_;
+    while (curr != &task)
+    {
+      prev = curr;
+      curr = curr->next_;
+    }
+    if (NULL == prev)
+    {
+      head_ = task.next_;
+    }
+    else
+    {
+      prev->next_ = task.next_;
+    }
+    if (tail_ == &task)
+    {
+      tail_ = prev;
+    }
+    task.state_ = ObSortTask::TASK_RUNNING;
+    pthread_mutex_unlock(&mutex_);
+    task.process();
+    pthread_mutex_lock(&mutex_);
+  }
+  else
+  {
+    while (ObSortTask::TASK_RUNNING == task.state_)
+    {
+      pthread_cond_wait(&done_cond_, &mutex_);
+    }
+  }
+  task.state_ = ObSortTask::TASK_IDLE;
+  task.next_ = NULL;
+  pthread_mutex_unlock(&mutex_);
+}
+
+void *ObSortWorkerPool::thread_func(void *arg)
+{
+  reinterpret_cast<ObSortWorkerPool*>(arg)->run();
+  return NULL;
+}
+
+void ObSortWorkerPool::run()
+{
+  ObSortTask *task = NULL;
+  pthread_mutex_lock(&mutex_);
+  while (!stop_)
+  {
+    if (NULL == head_)
+    {
+      pthread_cond_wait(&task_cond_, &mutex_);
+    }
+    else
+    {
+      task = head_;
+      head_ = task->next_;
+      if (NULL == head_)
+      {
+        tail_ = NULL;
+      }
+      task->state_ = ObSortTask::TASK_RUNNING;
+      pthread_mutex_unlock(&mutex_);
+      task->process();
+      pthread_mutex_lock(&mutex_);
+      task->state_ = ObSortTask::TASK_DONE;
+      pthread_cond_broadcast(&done_cond_);
+    }
+  }
+  pthread_mutex_unlock(&mutex_);
+}
@@ -0,0 +1,89 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sort_worker_pool.h
+ *
+ */
+#ifndef _OB_SORT_WORKER_POOL_H
+#define _OB_SORT_WORKER_POOL_H 1
+#include "common/ob_define.h"
+#include <pthread.h>
+
+namespace oceanbase
+{
+  namespace sql
+  {
+    // a task run by ObSortWorkerPool, e.g. sorting one chunk of rows or dumping one run
+    class ObSortTask
+    {
+      public:
+        ObSortTask()
+          :state_(TASK_IDLE), next_(NULL)
+        {
+        }
+        virtual ~ObSortTask()
+        {
+        }
+        virtual void process() = 0;
+      private:
+        friend class ObSortWorkerPool;
+        enum TaskState
+        {
+          TASK_IDLE,
+          TASK_QUEUED,
+          TASK_RUNNING,
+          TASK_DONE
+        };
+        TaskState state_;
+        ObSortTask *next_;
+    };
+
+    // the worker threads shared by all the sort operators of the process,
+    // the number of threads is bounded by the cpu count and MAX_THREAD_NUM
+    // 1. the threads are started by the first submit()
+    // 2. wait() takes back the task not started yet and processes it in the calling thread,
+    //    so a task waiting for its own subtasks never blocks the pool
+    class ObSortWorkerPool
+    {
+      public:
+        static const int64_t MAX_THREAD_NUM = 16;
+      public:
+        static ObSortWorkerPool &get_instance();
+
+        /// @return OB_SUCCESS, or an error if no thread could be started and the task is not queued
+        int submit(ObSortTask &task);
+        /// wait for a submitted task, the task could be submitted again after that
+        void wait(ObSortTask &task);
+        int64_t get_thread_num() const;
+      private:
+        ObSortWorkerPool();
+        ~ObSortWorkerPool();
+        DISALLOW_COPY_AND_ASSIGN(ObSortWorkerPool);
+        int start_threads();
+        static void *thread_func(void *arg);
+        void run();
+      private:
+        ObSortTask *head_;
+        ObSortTask *tail_;
+        pthread_t threads_[MAX_THREAD_NUM];
+        int64_t thread_num_;
+        bool stop_;
+        pthread_mutex_t mutex_;
+        pthread_cond_t task_cond_;  // signaled when a task is queued
+        pthread_cond_t done_cond_;  // broadcast when a task is done
+    };
+
+    inline int64_t ObSortWorkerPool::get_thread_num() const
+    {
+      return thread_num_;
+    }
+  } // end namespace sql
+} // end namespace oceanbase
+
+#endif /* _OB_SORT_WORKER_POOL_H */
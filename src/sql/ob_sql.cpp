@@ -41,6 +41,7 @@
 #include "sql/ob_set_password_stmt.h"
 #include "sql/ob_rename_user_stmt.h"
 #include "sql/ob_show_stmt.h"
+#include "sql/ob_sql_plan_cache.h"
 using namespace oceanbase::common;
 using namespace oceanbase::sql;
 
@@ -99,6 +100,14 @@ int ObSql::direct_execute(const common::ObString &stmt, ObResultSet &result, ObS
       TBSYS_LOG(TRACE, "execute special sql statement success [%.*s]", stmt.length(), stmt.ptr());
     }
   }
+  else if (true == execute_cached_plan(stmt, result, context))
+  {
+    if (OB_UNLIKELY(TBSYS_LOGGER._level >= TBSYS_LOG_LEVEL_TRACE))
+    {
+      TBSYS_LOG(TRACE, "execute cached plan, stmt_id=%lu sql=[%.*s]",
+                result.get_statement_id(), stmt.length(), stmt.ptr());
+    }
+  }
   else
   {
     ResultPlan result_plan;
@@ -130,7 +139,13 @@ int ObSql::direct_execute(const common::ObString &stmt, ObResultSet &result, ObS
         ObBasicStmt::StmtType stmt_type = logic_plan->get_main_stmt()->get_stmt_type();
         result.set_stmt_type(stmt_type);
         result.set_inner_stmt_type(stmt_type);
-        if (OB_SUCCESS != (ret = logic_plan->fill_result_set(result, context.session_info_, context.session_info_->get_transformer_mem_pool())))
+        // the fields and params of a prepared statement live as long as its plan
+        common::ObIAllocator *result_allocator = &context.session_info_->get_transformer_mem_pool();
+        if (context.is_prepare_protocol_ && NULL != context.transformer_allocator_)
+        {
+          result_allocator = context.transformer_allocator_;
+        }
+        if (OB_SUCCESS != (ret = logic_plan->fill_result_set(result, context.session_info_, *result_allocator)))
         {
           TBSYS_LOG(WARN, "fill result set failed,ret=%d", ret);
         }
@@ -399,6 +414,161 @@ int ObSql::stmt_close(const uint64_t stmt_id, ObSqlContext &context)
   return ret;
 }
 
+bool ObSql::execute_cached_plan(const common::ObString &stmt, ObResultSet &result, ObSqlContext &context)
+{
+  bool ret = false;
+  int err = OB_SUCCESS;
+  ObSQLSessionInfo *session = context.session_info_;
+  if (!ObSqlPlanCache::is_enabled()
+      || context.is_prepare_protocol_
+      || context.disable_privilege_check_
+      || NULL == session
+      || NULL == context.schema_manager_
+      || NULL == context.pp_privilege_
+      || NULL == *context.pp_privilege_)
+  {
+    // not cacheable
+  }
+  else
+  {
+    ObArray<ObObj> params;
+    ObArray<obmysql::EMySQLFieldType> params_type;
+    ObString normalized_stmt;
+    uint64_t stmt_id = OB_INVALID_ID;
+    ObResultSet *stored_result = NULL;
+    const int64_t schema_version = context.schema_manager_->get_version();
+    const int64_t privilege_version = (*context.pp_privilege_)->get_version();
+    char *buf = static_cast<char*>(session->get_parser_mem_pool().alloc(stmt.length()));
+    if (NULL == buf)
+    {
+      err = OB_ALLOCATE_MEMORY_FAILED;
+    }
+    else if (OB_SUCCESS != (err = ObSqlParameterizer::parameterize(stmt, buf, stmt.length(),
+                                                                   normalized_stmt, params)))
+    {
+      TBSYS_LOG(DEBUG, "statement is not parameterized, err=%d", err);
+    }
+    else if (OB_SUCCESS == (err = ObSqlPlanCache::get_instance().get(*session, normalized_stmt, schema_version,
+                                                                      privilege_version, stmt_id)))
+    {
+      if (OB_INVALID_ID == stmt_id)
+      {
+        err = OB_NOT_SUPPORTED;
+      }
+      else if (NULL == (stored_result = session->get_plan(stmt_id)))
+      {
+        // closed by the client by mistake
+        TBSYS_LOG(WARN, "cached plan not found, stmt_id=%lu", stmt_id);
+        err = OB_ENTRY_NOT_EXIST;
+      }
+      else
+      {
+        OB_STAT_INC(SQL, SQL_PLAN_CACHE_HIT);
+      }
+    }
+    if (OB_ENTRY_NOT_EXIST == err)
+    {
+      OB_STAT_INC(SQL, SQL_PLAN_CACHE_MISS);
+      if (OB_SUCCESS != (err = prepare_cached_plan(normalized_stmt, context, schema_version,
+                                                   privilege_version, stmt_id)))
+      {
+        TBSYS_LOG(DEBUG, "failed to prepare cached plan, err=%d sql=%.*s",
+                  err, normalized_stmt.length(), normalized_stmt.ptr());
+      }
+      else if (NULL == (stored_result = session->get_plan(stmt_id)))
+      {
+        err = OB_ERR_UNEXPECTED;
+      }
+    }
+    if (OB_SUCCESS != err)
+    {
+    }
+    else if (OB_SUCCESS != (err = stored_result->fill_params(params_type, params)))
+    {
+      TBSYS_LOG(WARN, "failed to bind params of cached plan, err=%d stmt_id=%lu", err, stmt_id);
+    }
+    else if (OB_SUCCESS != (err = result.from_prepared(*stored_result)))
+    {
+      TBSYS_LOG(WARN, "failed to fill result set from cached plan, err=%d", err);
+    }
+    else
+    {
+      result.set_stmt_type(stored_result->get_stmt_type());
+      ret = true;
+    }
+  }
+  return ret;
+}
+
+int ObSql::prepare_cached_plan(const common::ObString &normalized_stmt, ObSqlContext &context,
+                               const int64_t schema_version, const int64_t privilege_version,
+                               uint64_t &stmt_id)
+{
+  int ret = OB_SUCCESS;
+  int err = OB_SUCCESS;
+  ObSQLSessionInfo *session = context.session_info_;
+  ObSqlPlanCache &plan_cache = ObSqlPlanCache::get_instance();
+  ObResultSet prepare_result;
+  ObSqlContext prepare_context = context;
+  prepare_context.transformer_allocator_ = NULL;
+  ObResultSet *stored_result = NULL;
+  if (OB_SUCCESS != (ret = stmt_prepare(normalized_stmt, prepare_result, prepare_context)))
+  {
+    // the statement will be executed again as usual, report its own error
+    ob_reset_err_msg();
+  }
+  else if (NULL == (stored_result = session->get_plan(prepare_result.get_statement_id())))
+  {
+    ret = OB_ERR_UNEXPECTED;
+  }
+  else
+  {
+    switch (stored_result->get_stmt_type())
+    {
+      case ObBasicStmt::T_SELECT:
+      case ObBasicStmt::T_INSERT:
+      case ObBasicStmt::T_REPLACE:
+      case ObBasicStmt::T_UPDATE:
+      case ObBasicStmt::T_DELETE:
+        break;
+      default:
+        ret = OB_NOT_SUPPORTED;
+        break;
+    }
+    if (OB_SUCCESS != ret)
+    {
+      if (OB_SUCCESS != (err = session->remove_plan(prepare_result.get_statement_id())))
+      {
+        TBSYS_LOG(WARN, "failed to remove plan, err=%d", err);
+      }
+    }
+    else if (OB_SUCCESS != (ret = plan_cache.put(*session, normalized_stmt, schema_version,
+                                                 privilege_version, prepare_result.get_statement_id())))
+    {
+      TBSYS_LOG(DEBUG, "failed to cache plan, err=%d", ret);
+      if (OB_SUCCESS != (err = session->remove_plan(prepare_result.get_statement_id())))
+      {
+        TBSYS_LOG(WARN, "failed to remove plan, err=%d", err);
+      }
+    }
+    else
+    {
+      stmt_id = prepare_result.get_statement_id();
+    }
+  }
+  if (OB_NOT_SUPPORTED == ret
+      || (OB_SUCCESS != ret && NULL == stored_result && OB_ALLOCATE_MEMORY_FAILED != ret))
+  {
+    // remember it, no need to prepare the statement again until the schema changes
+    if (OB_SUCCESS != (err = plan_cache.put(*session, normalized_stmt, schema_version,
+                                            privilege_version, OB_INVALID_ID)))
+    {
+      TBSYS_LOG(DEBUG, "failed to cache plan, err=%d", err);
+    }
+  }
+  return ret;
+}
+
 bool ObSql::process_special_stmt_hook(const common::ObString &stmt, ObResultSet &result, ObSqlContext &context)
 {
   int ret = OB_SUCCESS;
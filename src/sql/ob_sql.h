@@ -91,6 +91,14 @@ namespace oceanbase
         //  true: hook success
         //  false: not hooked
         static bool process_special_stmt_hook(const common::ObString &stmt, ObResultSet &result, ObSqlContext &context);
+        // bind the literals of the statement to the cached plan of the same normalized sql
+        // @return
+        //  true: the cached plan is ready to execute
+        //  false: not cached, the statement should be executed as usual
+        static bool execute_cached_plan(const common::ObString &stmt, ObResultSet &result, ObSqlContext &context);
+        static int prepare_cached_plan(const common::ObString &normalized_stmt, ObSqlContext &context,
+                                       const int64_t schema_version, const int64_t privilege_version,
+                                       uint64_t &stmt_id);
         static int do_privilege_check(const common::ObString & username, const ObPrivilege **pp_privilege, ObLogicalPlan *plan);
         static bool no_enough_memory();
       private:
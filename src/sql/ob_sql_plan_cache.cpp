@@ -0,0 +1,575 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sql_plan_cache.cpp
+ *
+ */
+#include "ob_sql_plan_cache.h"
+#include "ob_sql_session_info.h"
+#include "common/ob_malloc.h"
+#include "common/ob_atomic.h"
+#include <ctype.h>
+#include <strings.h>
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+namespace
+{
+  const int64_t MAX_INT_LITERAL_LENGTH = 18;
+
+  inline bool is_ident_char(const char c)
+  {
+    return isalnum(static_cast<unsigned char>(c)) || '_' == c || '$' == c
+      || 0 != (static_cast<unsigned char>(c) & 0x80);
+  }
+
+  inline bool is_word(const char *word, const int64_t len, const char *keyword)
+  {
+    return static_cast<int64_t>(strlen(keyword)) == len && 0 == strncasecmp(word, keyword, len);
+  }
+
+  inline int64_t find_char(const char *str, const int64_t len, const int64_t pos, const char c)
+  {
+    const char *p = static_cast<const char*>(memchr(str + pos, c, len - pos));
+    return NULL == p ? -1 : p - str;
+  }
+}
+
+int ObSqlParameterizer::parameterize(const ObString &stmt, char *buf, const int64_t buf_len,
+                                     ObString &normalized, ObArray<ObObj> &params)
+{
+  int ret = OB_SUCCESS;
+  const char *str = stmt.ptr();
+  const int64_t len = stmt.length();
+  int64_t pos = 0;
+  int64_t out = 0;
+  bool type_checked = false;
+  bool in_param_zone = false;
+  bool stopped = false;
+  const char *last_word = NULL;    // the previous token if it's a word
+  int64_t last_word_len = 0;
+  char last_char = '\0';           // the last non-space char before the current token
+  ObObj param;
+  params.clear();
+  if (NULL == str || 0 >= len || NULL == buf || buf_len < len)
+  {
+    ret = OB_INVALID_ARGUMENT;
+  }
+  while (OB_SUCCESS == ret && pos < len)
+  {
+    const char c = str[pos];
+    int64_t end = pos + 1;
+    bool replaced = false;
+    bool is_word_token = false;
+    if (isspace(static_cast<unsigned char>(c)))
+    {
+      buf[out++] = c;
+      pos = end;
+      continue;
+    }
+    else if ('/' == c && end < len && '*' == str[end])
+    {
+      // comment or hint, copy as it is
+      int64_t close = end + 1;
+      while (close + 1 < len && !('*' == str[close] && '/' == str[close + 1]))
+      {
+        ++close;
+      }
+      if (close + 1 >= len)
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else
+      {
+        end = close + 2;
+      }
+    }
+    else if ('-' == c && end < len && '-' == str[end])
+    {
+      end = find_char(str, len, end, '\n');
+      end = 0 > end ? len : end;
+    }
+    else if ('`' == c || '"' == c)
+    {
+      if (0 > (end = find_char(str, len, end, c)))
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else
+      {
+        ++end;
+      }
+    }
+    else if ('?' == c || '@' == c || '#' == c)
+    {
+      ret = OB_NOT_SUPPORTED;
+    }
+    else if ('\'' == c)
+    {
+      bool plain = true;
+      bool closed = false;
+      while (end < len && !closed)
+      {
+        if ('\\' == str[end])
+        {
+          plain = false;
+          end += 2;
+        }
+        else if ('\'' == str[end])
+        {
+          if (end + 1 < len && '\'' == str[end + 1])
+          {
+            plain = false;
+            end += 2;
+          }
+          else
+          {
+            closed = true;
+            ++end;
+          }
+        }
+        else
+        {
+          ++end;
+        }
+      }
+      if (!closed)
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else if (plain && in_param_zone && !stopped
+               && (0 == pos || !is_ident_char(str[pos - 1]))    // X'...'
+               && !(NULL != last_word
+                    && (is_word(last_word, last_word_len, "DATE")
+                        || is_word(last_word, last_word_len, "TIME")
+                        || is_word(last_word, last_word_len, "TIMESTAMP"))))
+      {
+        ObString value(0, static_cast<int32_t>(end - pos - 2), str + pos + 1);
+        param.set_varchar(value);
+        replaced = true;
+      }
+    }
+    else if (isdigit(static_cast<unsigned char>(c)))
+    {
+      while (end < len && isdigit(static_cast<unsigned char>(str[end])))
+      {
+        ++end;
+      }
+      if (in_param_zone && !stopped
+          && end - pos <= MAX_INT_LITERAL_LENGTH
+          && (end >= len || (!is_ident_char(str[end]) && '.' != str[end]))
+          && '-' != last_char && '+' != last_char && '.' != last_char)
+      {
+        int64_t value = 0;
+        for (int64_t i = pos; i < end; ++i)
+        {
+          value = value * 10 + (str[i] - '0');
+        }
+        param.set_int(value);
+        replaced = true;
+      }
+    }
+    else if (is_ident_char(c))
+    {
+      while (end < len && is_ident_char(str[end]))
+      {
+        ++end;
+      }
+      const char *word = str + pos;
+      const int64_t word_len = end - pos;
+      is_word_token = true;
+      if (!type_checked)
+      {
+        type_checked = true;
+        if (!is_word(word, word_len, "SELECT") && !is_word(word, word_len, "INSERT")
+            && !is_word(word, word_len, "REPLACE") && !is_word(word, word_len, "UPDATE")
+            && !is_word(word, word_len, "DELETE"))
+        {
+          ret = OB_NOT_SUPPORTED;
+        }
+      }
+      else if (is_word(word, word_len, "WHERE") || is_word(word, word_len, "VALUES")
+               || is_word(word, word_len, "SET"))
+      {
+        in_param_zone = true;
+      }
+      else if (is_word(word, word_len, "SELECT"))
+      {
+        // the select list of subquery or union
+        in_param_zone = false;
+      }
+      else if (is_word(word, word_len, "ORDER") || is_word(word, word_len, "GROUP")
+               || is_word(word, word_len, "LIMIT") || is_word(word, word_len, "HAVING"))
+      {
+        stopped = true;
+      }
+      last_word = word;
+      last_word_len = word_len;
+    }
+
+    if (OB_SUCCESS != ret)
+    {
+    }
+    else if (replaced)
+    {
+      if (params.count() >= MAX_PARAM_COUNT)
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else if (OB_SUCCESS != (ret = params.push_back(param)))
+      {
+        TBSYS_LOG(WARN, "failed to push back param, err=%d", ret);
+      }
+      else
+      {
+        buf[out++] = '?';
+        last_char = '?';
+        last_word = NULL;
+      }
+    }
+    else
+    {
+      memcpy(buf + out, str + pos, end - pos);
+      out += end - pos;
+      last_char = str[end - 1];
+      if (!is_word_token)
+      {
+        last_word = NULL;
+      }
+    }
+    pos = end;
+  }
+  if (OB_SUCCESS == ret && !type_checked)
+  {
+    ret = OB_NOT_SUPPORTED;
+  }
+  if (OB_SUCCESS == ret)
+  {
+    normalized.assign_ptr(buf, static_cast<int32_t>(out));
+  }
+  return ret;
+}
+
+int64_t ObSqlPlanCache::max_plan_count_ = ObSqlPlanCache::DEFAULT_MAX_PLAN_COUNT;
+int64_t ObSqlPlanCache::mem_limit_ = ObSqlPlanCache::DEFAULT_MEM_LIMIT;
+volatile uint64_t ObSqlPlanCache::total_mem_size_ = 0;
+
+ObSqlPlanCache &ObSqlPlanCache::get_instance()
+{
+  static ObSqlPlanCache instance;
+  return instance;
+}
+
+ObSqlPlanCache::ObSqlPlanCache()
+  :inited_(false), lru_head_(NULL), lru_tail_(NULL)
+{
+}
+
+ObSqlPlanCache::~ObSqlPlanCache()
+{
+  // every session removes its entries when it's destroyed
+  entries_.destroy();
+}
+
+void ObSqlPlanCache::set_config(const int64_t max_plan_count, const int64_t mem_limit)
+{
+  max_plan_count_ = max_plan_count;
+  mem_limit_ = mem_limit;
+  TBSYS_LOG(INFO, "set sql plan cache, max_plan_count=%ld mem_limit=%ld",
+            max_plan_count_, mem_limit_);
+}
+
+bool ObSqlPlanCache::is_enabled()
+{
+  return 0 < max_plan_count_ && 0 < mem_limit_;
+}
+
+int64_t ObSqlPlanCache::get_total_mem_size()
+{
+  return static_cast<int64_t>(total_mem_size_);
+}
+
+int64_t ObSqlPlanCache::count() const
+{
+  tbsys::CThreadGuard guard(&lock_);
+  return inited_ ? entries_.size() : 0;
+}
+
+int ObSqlPlanCache::init()
+{
+  int ret = OB_SUCCESS;
+  if (inited_)
+  {
+  }
+  else if (OB_SUCCESS != (ret = entries_.create(hash::cal_next_prime(BUCKET_NUM))))
+  {
+    TBSYS_LOG(WARN, "failed to create plan cache map, err=%d", ret);
+  }
+  else
+  {
+    inited_ = true;
+  }
+  return ret;
+}
+
+int ObSqlPlanCache::get(ObSQLSessionInfo &session, const ObString &key,
+                        const int64_t schema_version, const int64_t privilege_version, uint64_t &stmt_id)
+{
+  int ret = OB_SUCCESS;
+  Entry *entry = NULL;
+  Entry *freed = NULL;
+  SessionPlans &plans = session.get_cached_plans();
+  {
+    tbsys::CThreadGuard guard(&lock_);
+    freed = plans.evicted_;
+    plans.evicted_ = NULL;
+    if (!inited_ || hash::HASH_EXIST != entries_.get(Key(&session, key), entry))
+    {
+      ret = OB_ENTRY_NOT_EXIST;
+    }
+    else if (entry->schema_version_ != schema_version
+             || entry->privilege_version_ != privilege_version)
+    {
+      TBSYS_LOG(DEBUG, "cached plan is stale, stmt_id=%lu schema_version=%ld:%ld privilege_version=%ld:%ld",
+                entry->stmt_id_, entry->schema_version_, schema_version,
+                entry->privilege_version_, privilege_version);
+      evict(entry, plans, freed);
+      ret = OB_ENTRY_NOT_EXIST;
+    }
+    else
+    {
+      unlink(entry);
+      link(entry);
+      stmt_id = entry->stmt_id_;
+    }
+  }
+  reclaim(session, freed);
+  return ret;
+}
+
+int ObSqlPlanCache::put(ObSQLSessionInfo &session, const ObString &key,
+                        const int64_t schema_version, const int64_t privilege_version, const uint64_t stmt_id)
+{
+  int ret = OB_SUCCESS;
+  Entry *entry = NULL;
+  Entry *freed = NULL;
+  void *buf = NULL;
+  SessionPlans &plans = session.get_cached_plans();
+  int64_t mem_size = sizeof(Entry) + key.length();
+  if (OB_INVALID_ID != stmt_id)
+  {
+    mem_size += get_plan_mem_size(session, stmt_id);
+  }
+  {
+    tbsys::CThreadGuard guard(&lock_);
+    freed = plans.evicted_;
+    plans.evicted_ = NULL;
+    if (OB_SUCCESS != (ret = init()))
+    {
+    }
+    else
+    {
+      if (hash::HASH_EXIST == entries_.get(Key(&session, key), entry))
+      {
+        evict(entry, plans, freed);
+        entry = NULL;
+      }
+      while (NULL != plans.tail_ && plans.count_ >= max_plan_count_)
+      {
+        evict(plans.tail_, plans, freed);
+      }
+      while (NULL != lru_tail_ && get_total_mem_size() + mem_size > mem_limit_)
+      {
+        TBSYS_LOG(DEBUG, "evict cached plan, stmt_id=%lu sql=%.*s", lru_tail_->stmt_id_,
+                  lru_tail_->key_.sql_.length(), lru_tail_->key_.sql_.ptr());
+        evict(lru_tail_, plans, freed);
+      }
+      if (get_total_mem_size() + mem_size > mem_limit_)
+      {
+        TBSYS_LOG(DEBUG, "sql plan cache is full, total_mem_size=%ld mem_size=%ld",
+                  get_total_mem_size(), mem_size);
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else if (NULL == (buf = ob_malloc(sizeof(Entry) + key.length(), ObModIds::OB_SQL_PLAN_CACHE)))
+      {
+        TBSYS_LOG(WARN, "no memory");
+        ret = OB_ALLOCATE_MEMORY_FAILED;
+      }
+      else
+      {
+        entry = new(buf) Entry();
+        char *key_buf = static_cast<char*>(buf) + sizeof(Entry);
+        memcpy(key_buf, key.ptr(), key.length());
+        entry->key_.session_ = &session;
+        entry->key_.sql_.assign_ptr(key_buf, key.length());
+        entry->plans_ = &plans;
+        entry->stmt_id_ = stmt_id;
+        entry->schema_version_ = schema_version;
+        entry->privilege_version_ = privilege_version;
+        entry->mem_size_ = mem_size;
+        if (hash::HASH_INSERT_SUCC != entries_.set(entry->key_, entry))
+        {
+          TBSYS_LOG(WARN, "failed to insert into plan cache map");
+          ret = OB_ERROR;
+          entry->~Entry();
+          ob_free(buf);
+        }
+        else
+        {
+          link(entry);
+          atomic_add(&total_mem_size_, static_cast<uint64_t>(mem_size));
+        }
+      }
+    }
+  }
+  reclaim(session, freed);
+  return ret;
+}
+
+void ObSqlPlanCache::remove_session(ObSQLSessionInfo &session)
+{
+  SessionPlans &plans = session.get_cached_plans();
+  Entry *freed = NULL;
+  {
+    tbsys::CThreadGuard guard(&lock_);
+    freed = plans.evicted_;
+    plans.evicted_ = NULL;
+    while (NULL != plans.head_)
+    {
+      evict(plans.head_, plans, freed);
+    }
+  }
+  // the prepared statements are freed along with the session
+  while (NULL != freed)
+  {
+    Entry *next = freed->session_next_;
+    free_entry(freed);
+    freed = next;
+  }
+}
+
+int64_t ObSqlPlanCache::get_plan_mem_size(ObSQLSessionInfo &session, const uint64_t stmt_id) const
+{
+  int64_t mem_size = 0;
+  const ObResultSet *result_set = session.get_plan(stmt_id);
+  if (NULL != result_set && NULL != result_set->get_ps_transformer_allocator())
+  {
+    mem_size = result_set->get_ps_transformer_allocator()->total();
+  }
+  return mem_size;
+}
+
+void ObSqlPlanCache::link(Entry *entry)
+{
+  SessionPlans &plans = *entry->plans_;
+  entry->lru_prev_ = NULL;
+  entry->lru_next_ = lru_head_;
+  if (NULL != lru_head_)
+  {
+    lru_head_->lru_prev_ = entry;
+  }
+  else
+  {
+    lru_tail_ = entry;
+  }
+  lru_head_ = entry;
+  entry->session_prev_ = NULL;
+  entry->session_next_ = plans.head_;
+  if (NULL != plans.head_)
+  {
+    plans.head_->session_prev_ = entry;
+  }
+  else
+  {
+    plans.tail_ = entry;
+  }
+  plans.head_ = entry;
+  ++plans.count_;
+}
+
+void ObSqlPlanCache::unlink(Entry *entry)
+{
+  SessionPlans &plans = *entry->plans_;
+  if (NULL != entry->lru_prev_)
+  {
+    entry->lru_prev_->lru_next_ = entry->lru_next_;
+  }
+  else
+  {
+    lru_head_ = entry->lru_next_;
+  }
+  if (NULL != entry->lru_next_)
+  {
+    entry->lru_next_->lru_prev_ = entry->lru_prev_;
+  }
+  else
+  {
+    lru_tail_ = entry->lru_prev_;
+  }
+  if (NULL != entry->session_prev_)
+  {
+    entry->session_prev_->session_next_ = entry->session_next_;
+  }
+  else
+  {
+    plans.head_ = entry->session_next_;
+  }
+  if (NULL != entry->session_next_)
+  {
+    entry->session_next_->session_prev_ = entry->session_prev_;
+  }
+  else
+  {
+    plans.tail_ = entry->session_prev_;
+  }
+  entry->lru_prev_ = entry->lru_next_ = NULL;
+  entry->session_prev_ = entry->session_next_ = NULL;
+  --plans.count_;
+}
+
+void ObSqlPlanCache::evict(Entry *entry, SessionPlans &plans, Entry *&freed)
+{
+  SessionPlans &owner = *entry->plans_;
+  entries_.erase(entry->key_);
+  unlink(entry);
+  // the memory is accounted as freed, even if the plan of other session is freed later
+  atomic_add(&total_mem_size_, static_cast<uint64_t>(-entry->mem_size_));
+  if (&owner == &plans)
+  {
+    entry->session_next_ = freed;
+    freed = entry;
+  }
+  else
+  {
+    entry->session_next_ = owner.evicted_;
+    owner.evicted_ = entry;
+  }
+}
+
+void ObSqlPlanCache::reclaim(ObSQLSessionInfo &session, Entry *freed)
+{
+  int err = OB_SUCCESS;
+  while (NULL != freed)
+  {
+    Entry *next = freed->session_next_;
+    if (OB_INVALID_ID != freed->stmt_id_
+        && OB_SUCCESS != (err = session.remove_plan(freed->stmt_id_)))
+    {
+      TBSYS_LOG(WARN, "failed to remove cached plan, stmt_id=%lu err=%d", freed->stmt_id_, err);
+    }
+    free_entry(freed);
+    freed = next;
+  }
+}
+
+void ObSqlPlanCache::free_entry(Entry *entry)
+{
+  entry->~Entry();
+  ob_free(entry);
+}
@@ -0,0 +1,161 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sql_plan_cache.h
+ *
+ */
+#ifndef _OB_SQL_PLAN_CACHE_H
+#define _OB_SQL_PLAN_CACHE_H 1
+#include "common/ob_string.h"
+#include "common/ob_object.h"
+#include "common/ob_array.h"
+#include "common/hash/ob_hashmap.h"
+#include "common/murmur_hash.h"
+#include "tbsys.h"
+
+namespace oceanbase
+{
+  namespace sql
+  {
+    class ObSQLSessionInfo;
+
+    // 把文本SQL中的常量替换成'?'并提取为参数，替换后的文本作为计划缓存的key
+    // 1. 只处理SELECT/INSERT/REPLACE/UPDATE/DELETE，只替换WHERE/VALUES/SET之后的整数和字符串常量，
+    //    遇到ORDER/GROUP/LIMIT/HAVING之后不再替换，select列表中的常量决定结果集的列名，保持不变
+    // 2. 带符号、与标识符相连或超过18位的数字，带转义的字符串，DATE/TIME/TIMESTAMP '...'和X'...'不替换
+    // 3. 已经包含'?'或者用户变量'@'的语句不处理
+    class ObSqlParameterizer
+    {
+      public:
+        static const int64_t MAX_PARAM_COUNT = 256;
+        /**
+         * @param buf [in] buffer of the normalized sql, at least stmt.length() bytes
+         * @param normalized [out] points to buf
+         * @param params [out] extracted literals, varchar params point into stmt
+         *
+         * @return OB_SUCCESS, OB_NOT_SUPPORTED if the statement should not be cached
+         */
+        static int parameterize(const common::ObString &stmt, char *buf, const int64_t buf_len,
+                                common::ObString &normalized, common::ObArray<common::ObObj> &params);
+      private:
+        ObSqlParameterizer();
+    };
+
+    // 文本SQL的计划缓存，(session, 归一化后的SQL文本) -> session中prepare好的语句
+    // 1. 整个server共用一个缓存，由lock_保护，内存按整个server限制，条目数按session限制
+    // 2. 物理计划带有执行状态并且从session的PS allocator中分配，不能在session之间共享，
+    //    所以计划仍然属于prepare它的session，key中带上session
+    // 3. 所有条目挂在一个侵入式的LRU链表上，同一个session的条目另外挂在session自己的链表上，
+    //    超出内存限制时淘汰全局LRU链表的尾部，超出条目数限制时淘汰session链表的尾部
+    // 4. 淘汰其它session的计划时不能操作那个session的prepare语句，条目先挂到它的evicted链表上，
+    //    由它在下一次get/put时或者关闭时释放计划
+    // 5. schema或者权限的版本变化后，旧的计划在下一次命中时失效
+    // 6. 不能缓存的语句也记录下来，避免每次都重新尝试prepare
+    // @note get/put/remove_session必须在持有session的mutex时调用
+    class ObSqlPlanCache
+    {
+      public:
+        static const int64_t DEFAULT_MAX_PLAN_COUNT = 256;
+        static const int64_t DEFAULT_MEM_LIMIT = 1L << 30;  // 1GB
+        struct Entry;
+        // the entries of a session, only accessed with the lock of the cache held
+        struct SessionPlans
+        {
+          SessionPlans() : head_(NULL), tail_(NULL), count_(0), evicted_(NULL) {}
+          Entry *head_;     // most recently used
+          Entry *tail_;
+          int64_t count_;
+          Entry *evicted_;  // evicted by other sessions, the plans are not freed yet
+        };
+      public:
+        static ObSqlPlanCache &get_instance();
+
+        /// @param max_plan_count max count of cached statements per session, 0 to disable the cache
+        static void set_config(const int64_t max_plan_count, const int64_t mem_limit);
+        static bool is_enabled();
+        /// memory used by the cached plans of all sessions
+        static int64_t get_total_mem_size();
+
+        /**
+         * @param stmt_id [out] OB_INVALID_ID if the statement is known as not cacheable
+         *
+         * @return OB_SUCCESS, OB_ENTRY_NOT_EXIST if not cached or the cached one is stale
+         */
+        int get(ObSQLSessionInfo &session, const common::ObString &key,
+                const int64_t schema_version, const int64_t privilege_version, uint64_t &stmt_id);
+        /**
+         * cache the prepared statement stmt_id, OB_INVALID_ID to remember
+         * the statement is not cacheable
+         *
+         * @return OB_SUCCESS, OB_SIZE_OVERFLOW if the memory limit is reached,
+         * the statement isn't owned by the cache if failed
+         */
+        int put(ObSQLSessionInfo &session, const common::ObString &key,
+                const int64_t schema_version, const int64_t privilege_version, const uint64_t stmt_id);
+        /// free all the entries of the session, the prepared statements are freed along with the session
+        void remove_session(ObSQLSessionInfo &session);
+        int64_t count() const;
+      public:
+        struct Key
+        {
+          Key() : session_(NULL) {}
+          Key(const ObSQLSessionInfo *session, const common::ObString &sql) : session_(session), sql_(sql) {}
+          int64_t hash() const
+          {
+            return common::murmurhash2(sql_.ptr(), sql_.length(),
+                                       static_cast<uint32_t>(reinterpret_cast<uint64_t>(session_) >> 4));
+          }
+          bool operator==(const Key &other) const
+          {
+            return session_ == other.session_ && sql_ == other.sql_;
+          }
+          const ObSQLSessionInfo *session_;
+          common::ObString sql_;    // the memory follows the entry
+        };
+        struct Entry
+        {
+          Key key_;
+          SessionPlans *plans_;   // of the owner session
+          uint64_t stmt_id_;
+          int64_t schema_version_;
+          int64_t privilege_version_;
+          int64_t mem_size_;
+          Entry *lru_prev_;       // the global LRU list
+          Entry *lru_next_;
+          Entry *session_prev_;   // the list of the session, or the evicted list
+          Entry *session_next_;
+        };
+      private:
+        typedef common::hash::ObHashMap<Key, Entry*, common::hash::NoPthreadDefendMode> EntryMap;
+        static const int64_t BUCKET_NUM = 10243;
+      private:
+        ObSqlPlanCache();
+        ~ObSqlPlanCache();
+        DISALLOW_COPY_AND_ASSIGN(ObSqlPlanCache);
+        int init();
+        int64_t get_plan_mem_size(ObSQLSessionInfo &session, const uint64_t stmt_id) const;
+        void link(Entry *entry);
+        void unlink(Entry *entry);
+        void evict(Entry *entry, SessionPlans &plans, Entry *&freed);
+        void reclaim(ObSQLSessionInfo &session, Entry *freed);
+        void free_entry(Entry *entry);
+      private:
+        static int64_t max_plan_count_;
+        static int64_t mem_limit_;
+        static volatile uint64_t total_mem_size_;
+        mutable tbsys::CThreadMutex lock_;
+        bool inited_;
+        Entry *lru_head_;   // most recently used
+        Entry *lru_tail_;
+        EntryMap entries_;
+    };
+  } // end namespace sql
+} // end namespace oceanbase
+
+#endif /* _OB_SQL_PLAN_CACHE_H */
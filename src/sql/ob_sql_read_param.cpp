@@ -13,9 +13,9 @@ namespace oceanbase
     ObSqlReadParam::ObSqlReadParam() :
       is_read_master_(0), is_result_cached_(0), data_version_(OB_NEWEST_DATA_VERSION),
       table_id_(OB_INVALID_ID), renamed_table_id_(OB_INVALID_ID), only_static_data_(false),
-      project_(), scalar_agg_(), group_(), group_columns_sort_(), limit_(), filter_(),
+      project_(), scalar_agg_(), group_(), group_columns_sort_(), limit_(), sort_(), filter_(),
       has_project_(false), has_scalar_agg_(false), has_group_(false), has_group_columns_sort_(false),
-      has_limit_(false), has_filter_(false)
+      has_limit_(false), has_sort_(false), has_filter_(false)
     {
       reset();
     }
@@ -39,12 +39,14 @@ namespace oceanbase
 
       group_columns_sort_.reset();
       limit_.reset();
+      sort_.reset();
       filter_.reset();
       has_project_ = false;
       has_scalar_agg_ = false;
       has_group_ = false;
       has_group_columns_sort_ = false;
       has_limit_ = false;
+      has_sort_ = false;
       has_filter_ = false;
     }
 
@@ -228,6 +230,25 @@ namespace oceanbase
       return limit_;
     }
 
+    int ObSqlReadParam::add_sort_column(const uint64_t tid, const uint64_t cid, const bool is_ascending)
+    {
+      int ret = OB_SUCCESS;
+      if (has_scalar_agg_ || has_group_)
+      {
+        ret = OB_ERR_GEN_PLAN;
+        TBSYS_LOG(WARN, "Can not push down order by with aggregate function(s) or group by. ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = sort_.add_sort_column(tid, cid, is_ascending)))
+      {
+        TBSYS_LOG(WARN, "Add sort column of ObSqlReadParam sort operator failed. ret=%d", ret);
+      }
+      else
+      {
+        has_sort_ = true;
+      }
+      return ret;
+    }
+
 
 
     ////////////////////// SERIALIZATION ///////////////////////
@@ -537,6 +558,20 @@ namespace oceanbase
         }
       }
 
+      // SORT_PARAM_FIELD
+      if (OB_SUCCESS == ret && has_sort_)
+      {
+        obj.set_ext(ObActionFlag::SQL_SORT_PARAM_FIELD);
+        if (OB_SUCCESS != (ret = obj.serialize(buf, buf_len, pos)))
+        {
+          TBSYS_LOG(WARN, "fail to serialize obj. buf=%p, buf_len=%ld, pos=%ld, ret=%d", buf, buf_len, pos, ret);
+        }
+        else if (OB_SUCCESS != (ret = sort_.serialize(buf, buf_len, pos)))
+        {
+          TBSYS_LOG(WARN, "fail to serialize sort param. buf=%p, buf_len=%ld, pos=%ld, ret=%d", buf, buf_len, pos, ret);
+        }
+      }
+
       // FILTER_PARAM_FIELD
       if (OB_SUCCESS == ret && has_filter_)
       {
@@ -671,6 +706,19 @@ namespace oceanbase
                 }
                 break;
               }
+            case ObActionFlag::SQL_SORT_PARAM_FIELD:
+              {
+                if (OB_SUCCESS != (ret = sort_.deserialize(buf, data_len, pos)))
+                {
+                  TBSYS_LOG(WARN, "fail to deserialize sort. buf=%p, data_len=%ld, pos=%ld, ret=%d",
+                      buf, data_len, pos, ret);
+                }
+                else
+                {
+                  has_sort_ = true;
+                }
+                break;
+              }
             case ObActionFlag::SQL_FILTER_PARAM_FIELD:
               {
                 if (OB_SUCCESS != (ret = filter_.deserialize(buf, data_len, pos)))
@@ -768,6 +816,12 @@ namespace oceanbase
         total_size += obj.get_serialize_size();
         total_size += limit_.get_serialize_size();
       }
+      if (has_sort_)
+      {
+        obj.set_ext(ObActionFlag::SQL_SORT_PARAM_FIELD);
+        total_size += obj.get_serialize_size();
+        total_size += sort_.get_serialize_size();
+      }
       if (has_filter_)
       {
         obj.set_ext(ObActionFlag::SQL_FILTER_PARAM_FIELD);
@@ -841,6 +895,11 @@ namespace oceanbase
       {
         limit_.assign(other.limit_);
       }
+      has_sort_ = other.has_sort_;
+      if (other.has_sort_)
+      {
+        sort_.assign(other.sort_);
+      }
       return *this;
     }
 
@@ -856,6 +915,8 @@ namespace oceanbase
         databuff_print_obj(buf, buf_len, pos, *group_);
       if (has_group_columns_sort_)
         databuff_print_obj(buf, buf_len, pos, group_columns_sort_);
+      if (has_sort_)
+        databuff_print_obj(buf, buf_len, pos, sort_);
       if (has_filter_)
         databuff_print_obj(buf, buf_len, pos, filter_);
       if (has_project_)
@@ -46,18 +46,22 @@ namespace oceanbase
       virtual int add_aggr_column(const ObSqlExpression& expr);
       virtual int set_limit(const ObLimit &limit);
       virtual int set_limit(const ObSqlExpression& limit, const ObSqlExpression& offset);
+      /// ORDER BY pushed down with LIMIT, the sort keeps the first offset+limit rows only
+      virtual int add_sort_column(const uint64_t tid, const uint64_t cid, const bool is_ascending);
       virtual const ObProject &get_project() const;
       virtual const ObScalarAggregate &get_scalar_agg() const;
       virtual const ObMergeGroupBy &get_group() const;
       virtual const ObSort &get_group_columns_sort() const;
       virtual const ObFilter &get_filter() const;
       virtual const ObLimit &get_limit() const;
+      virtual const ObSort &get_sort() const;
       virtual inline bool has_project() const;
       virtual inline bool has_scalar_agg() const;
       virtual inline bool has_group() const;
       virtual inline bool has_group_columns_sort() const;
       virtual inline bool has_filter() const;
       virtual inline bool has_limit() const;
+      virtual inline bool has_sort() const;
       virtual inline int64_t get_output_column_size() const;
       // caution: NOT deep copy
       virtual ObSqlReadParam& operator=(const ObSqlReadParam &other);
@@ -88,12 +92,14 @@ namespace oceanbase
       ObMergeGroupBy *group_;
       ObSort group_columns_sort_;
       ObLimit limit_;
+      ObSort sort_;
       ObFilter filter_;
       bool has_project_;
       bool has_scalar_agg_;
       bool has_group_;
       bool has_group_columns_sort_;
       bool has_limit_;
+      bool has_sort_;
       bool has_filter_;
     };
 
@@ -185,6 +191,11 @@ namespace oceanbase
       return has_limit_;
     }
 
+    inline bool ObSqlReadParam::has_sort() const
+    {
+      return has_sort_;
+    }
+
     inline int64_t ObSqlReadParam::get_output_column_size() const
     {
       return project_.get_output_column_size();
@@ -205,6 +216,11 @@ namespace oceanbase
       return group_columns_sort_;
     }
 
+    inline const ObSort & ObSqlReadParam::get_sort() const
+    {
+      return sort_;
+    }
+
   } /* sql */
 } /* oceanbase */
 
@@ -79,6 +79,8 @@ int ObSQLSessionInfo::init(common::DefaultBlockAllocator &block_allocator)
 
 void ObSQLSessionInfo::destroy()
 {
+  // the cached plans are freed with the other prepared statements
+  ObSqlPlanCache::get_instance().remove_session(*this);
   IdPlanMap::iterator iter;
   for (iter = id_plan_map_.begin(); iter != id_plan_map_.end(); iter++)
   {
@@ -28,6 +28,7 @@
 #include "common/page_arena.h"
 #include "common/ob_pool.h"
 #include "common/ob_pooled_allocator.h"
+#include "ob_sql_plan_cache.h"
 namespace oceanbase
 {
   namespace sql
@@ -96,6 +97,7 @@ namespace oceanbase
         common::StackAllocator& get_transformer_mem_pool(){return transformer_mem_pool_;}
         common::ObArenaAllocator* get_transformer_mem_pool_for_ps();
         void free_transformer_mem_pool_for_ps(common::ObArenaAllocator* arena);
+        ObSqlPlanCache::SessionPlans& get_cached_plans(){return cached_plans_;}
 
         int store_plan(const common::ObString& stmt_name, ObResultSet& result_set);
         int remove_plan(const uint64_t& stmt_id);
@@ -168,6 +170,7 @@ namespace oceanbase
         common::ObPool<common::ObWrapperAllocator> arena_pointers_;
         common::ObList<common::ObArenaAllocator *> free_arena_for_transformer_;
         common::ObPooledAllocator<ObResultSet, common::ObWrapperAllocator> result_set_pool_;
+        ObSqlPlanCache::SessionPlans cached_plans_; // entries of this session in the plan cache
     };
   }
 }
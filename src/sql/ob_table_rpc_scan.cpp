@@ -42,8 +42,8 @@ namespace oceanbase
     ObTableRpcScan::ObTableRpcScan() :
       rpc_scan_(), scalar_agg_(NULL), group_(NULL), group_columns_sort_(), limit_(),
       has_rpc_(false), has_scalar_agg_(false), has_group_(false),
-      has_group_columns_sort_(false), has_limit_(false), is_skip_empty_row_(true),
-      read_method_(ObSqlReadStrategy::USE_SCAN)
+      has_group_columns_sort_(false), has_limit_(false), has_sort_(false), is_skip_empty_row_(true),
+      read_method_(ObSqlReadStrategy::USE_SCAN), estimated_row_count_(-1)
     {
     }
 
@@ -119,8 +119,8 @@ namespace oceanbase
             }
           }
         }
-        // limit
-        if (OB_SUCCESS == ret && has_limit_)
+        // limit, the rows of different tablets are not in order if order by is pushed down
+        if (OB_SUCCESS == ret && has_limit_ && !has_sort_)
         {
           if (OB_SUCCESS != (ret = limit_.set_child(0, *child_op_)))
           {
@@ -188,6 +188,13 @@ namespace oceanbase
       return ret;
     }
 
+    void ObTableRpcScan::reset()
+    {
+      read_method_ = ObSqlReadStrategy::USE_SCAN;
+      is_skip_empty_row_ = true;
+      estimated_row_count_ = -1;
+    }
+
     int ObTableRpcScan::init(ObSqlContext *context, const common::ObRpcScanHint &hint)
     {
       int ret = OB_SUCCESS;
@@ -409,6 +416,25 @@ namespace oceanbase
       return ret;
     }
 
+    int ObTableRpcScan::add_sort_column(const uint64_t tid, const uint64_t cid, const bool is_ascending)
+    {
+      int ret = OB_SUCCESS;
+      if (has_group_ || has_scalar_agg_)
+      {
+        ret = OB_ERR_GEN_PLAN;
+        TBSYS_LOG(WARN, "Can not push down order by with aggregate function(s) or group by. ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = rpc_scan_.add_sort_column(tid, cid, is_ascending)))
+      {
+        TBSYS_LOG(WARN, "fail to add sort column to rpc scan operator. ret=%d", ret);
+      }
+      else
+      {
+        has_sort_ = true;
+      }
+      return ret;
+    }
+
     int64_t ObTableRpcScan::to_string(char* buf, const int64_t buf_len) const
     {
       int64_t pos = 0;
@@ -477,6 +503,11 @@ namespace oceanbase
       ENCODE_OP(has_limit_, limit_);
 
 #undef ENCODE_OP
+      if (OB_SUCCESS == ret
+          && OB_SUCCESS != (ret = common::serialization::encode_vi64(buf, buf_len, pos, estimated_row_count_)))
+      {
+        TBSYS_LOG(WARN, "fail to encode estimated_row_count_:ret[%d]", ret);
+      }
       return ret;
 #endif
     }
@@ -514,6 +545,11 @@ namespace oceanbase
       limit_.reset();
       DECODE_OP(has_limit_, limit_);
 #undef DECODE_OP
+      if (OB_SUCCESS == ret
+          && OB_SUCCESS != (ret = common::serialization::decode_vi64(buf, data_len, pos, &estimated_row_count_)))
+      {
+        TBSYS_LOG(WARN, "fail to decode estimated_row_count_:ret[%d]", ret);
+      }
       return ret;
 #endif
     }
@@ -535,6 +571,7 @@ namespace oceanbase
       GET_OP_SERIALIZE_SIZE(size, has_group_, group_);
       GET_OP_SERIALIZE_SIZE(size, has_limit_, limit_);
 #undef GET_OP_SERIALIZE_SIZE
+      size += common::serialization::encoded_length_vi64(estimated_row_count_);
       return size;
 #endif
     }
@@ -46,6 +46,8 @@ namespace oceanbase
         virtual ObPhyOperatorType get_type() const;
 
         int init(ObSqlContext *context, const common::ObRpcScanHint &hint);
+        /// 清除init()和优化器设置的读方式、估计行数等状态
+        void reset();
 
         /**
          * 添加一个需输出的column
@@ -86,6 +88,11 @@ namespace oceanbase
          * @return OB_SUCCESS或错误码
          */
         int set_limit(const ObSqlExpression& limit, const ObSqlExpression& offset);
+        /**
+         * 把ORDER BY与limit一起下压到chunkserver，每个tablet只返回排在最前面的offset+limit行
+         * @note 多个tablet的结果之间无序，本地不做limit，由上层的ObSort和ObLimit得到最终结果
+         */
+        int add_sort_column(const uint64_t tid, const uint64_t cid, const bool is_ascending);
         int64_t to_string(char* buf, const int64_t buf_len) const;
 
         void set_rowkey_cell_count(const int64_t rowkey_cell_count)
@@ -93,6 +100,16 @@ namespace oceanbase
           rpc_scan_.set_rowkey_cell_count(rowkey_cell_count);
         }
 
+        /// 优化器估计的输出行数，-1表示未知
+        void set_estimated_row_count(const int64_t row_count)
+        {
+          estimated_row_count_ = row_count;
+        }
+        int64_t get_estimated_row_count() const
+        {
+          return estimated_row_count_;
+        }
+
         NEED_SERIALIZE_AND_DESERIALIZE;
 
       private:
@@ -113,8 +130,10 @@ namespace oceanbase
         bool has_group_;
         bool has_group_columns_sort_;
         bool has_limit_;
+        bool has_sort_;
         bool is_skip_empty_row_;
         int32_t read_method_;
+        int64_t estimated_row_count_;
     };
   } // end namespace sql
 } // end namespace oceanbase
@@ -38,6 +38,7 @@ void ObTabletScan::reset(void)
   op_scalar_agg_.reset();
   op_group_columns_sort_.reset();
   op_group_.reset();
+  op_sort_.reset();
   op_limit_.clear();
 }
 
@@ -63,6 +64,11 @@ bool ObTabletScan::has_incremental_data() const
   return ret;
 }
 
+bool ObTabletScan::has_join_data() const
+{
+  return JOIN_DATA == plan_level_;
+}
+
 int ObTabletScan::need_incremental_data(
     ObArray<uint64_t> &basic_columns,
     ObTabletJoin::TableJoinInfo &table_join_info,
@@ -449,6 +455,27 @@ int ObTabletScan::create_plan(const ObSchemaManagerV2 &schema_mgr)
       }
     }
   }
+  // pushed-down ORDER BY ... LIMIT, the limit above makes it a top-n sort
+  if (OB_SUCCESS == ret && sql_scan_param_->has_sort())
+  {
+    if (!sql_scan_param_->has_limit())
+    {
+      ret = OB_ERR_GEN_PLAN;
+      TBSYS_LOG(WARN, "Physical plan error, sort need a limit operator. ret=%d", ret);
+    }
+    else
+    {
+      op_sort_.assign(sql_scan_param_->get_sort());
+      if (OB_SUCCESS != (ret = op_sort_.set_child(0, *op_root_)))
+      {
+        TBSYS_LOG(WARN, "Fail to set child of sort operator. ret=%d", ret);
+      }
+      else
+      {
+        op_root_ = &op_sort_;
+      }
+    }
+  }
   if (OB_SUCCESS == ret && sql_scan_param_->has_limit())
   {
     op_limit = &op_limit_;
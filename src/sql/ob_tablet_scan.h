@@ -78,6 +78,7 @@ namespace oceanbase
         virtual int create_plan(const ObSchemaManagerV2 &schema_mgr);
         
         bool has_incremental_data() const;
+        bool has_join_data() const;
         int64_t to_string(char* buf, const int64_t buf_len) const;
         inline void set_sql_scan_param(const ObSqlScanParam &sql_scan_param);
         void set_scan_context(const ScanContext &scan_context)
@@ -115,6 +116,7 @@ namespace oceanbase
         ObScalarAggregate op_scalar_agg_;
         ObMergeGroupBy op_group_;
         ObSort op_group_columns_sort_;
+        ObSort op_sort_;
         ObLimit op_limit_;
     };
 
@@ -0,0 +1,302 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_topn_sort.cpp
+ *
+ */
+#include "ob_topn_sort.h"
+#include "common/ob_row_util.h"
+#include <algorithm>
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+// the same order as ObInMemorySort
+struct ObTopNSort::Comparer
+{
+  Comparer(const common::ObArray<ObSortColumn> &sort_columns)
+    :sort_columns_(sort_columns)
+  {
+  }
+  bool operator()(const common::ObRowStore::StoredRow *r1, const common::ObRowStore::StoredRow *r2) const
+  {
+    bool ret = false;
+    OB_ASSERT(r1);
+    OB_ASSERT(r2);
+    for (int32_t i = 0; i < sort_columns_.count(); ++i)
+    {
+      if (r1->reserved_cells_[i] < r2->reserved_cells_[i])
+      {
+        ret = sort_columns_.at(i).is_ascending_;
+        break;
+      }
+      else if (r1->reserved_cells_[i] > r2->reserved_cells_[i])
+      {
+        ret = !sort_columns_.at(i).is_ascending_;
+        break;
+      }
+    } // end for
+    return ret;
+  }
+  private:
+    const common::ObArray<ObSortColumn> &sort_columns_;
+};
+
+ObTopNSort::ObTopNSort()
+  :sort_columns_(NULL), topn_(0), cur_store_idx_(0), dropped_row_count_(0),
+   get_pos_(0), row_desc_(NULL)
+{
+}
+
+ObTopNSort::~ObTopNSort()
+{
+}
+
+int ObTopNSort::set_sort_columns(const common::ObArray<ObSortColumn> &sort_columns)
+{
+  int ret = OB_SUCCESS;
+  sort_columns_ = &sort_columns;
+  for (int64_t s = 0; OB_SUCCESS == ret && s < 2; ++s)
+  {
+    for (int32_t i = 0; i < sort_columns.count(); ++i)
+    {
+      const ObSortColumn &sort_column = sort_columns.at(i);
+      if (OB_SUCCESS != (ret = row_stores_[s].add_reserved_column(sort_column.table_id_, sort_column.column_id_)))
+      {
+        TBSYS_LOG(WARN, "failed to add reserved column, err=%d", ret);
+        break;
+      }
+    }
+  }
+  return ret;
+}
+
+void ObTopNSort::reset()
+{
+  row_stores_[0].clear();
+  row_stores_[1].clear();
+  cur_store_idx_ = 0;
+  dropped_row_count_ = 0;
+  heap_.clear();
+  sort_column_idx_.clear();
+  get_pos_ = 0;
+  row_desc_ = NULL;
+}
+
+void ObTopNSort::reuse()
+{
+  row_stores_[0].clear_rows();
+  row_stores_[1].clear_rows();
+  cur_store_idx_ = 0;
+  dropped_row_count_ = 0;
+  heap_.clear();
+  sort_column_idx_.clear();
+  get_pos_ = 0;
+  row_desc_ = NULL;
+}
+
+int ObTopNSort::init_sort_column_idx(const common::ObRow &row)
+{
+  int ret = OB_SUCCESS;
+  row_desc_ = row.get_row_desc();
+  OB_ASSERT(row_desc_);
+  sort_column_idx_.clear();
+  for (int32_t i = 0; OB_SUCCESS == ret && i < sort_columns_->count(); ++i)
+  {
+    const int64_t idx = row_desc_->get_idx(sort_columns_->at(i).table_id_, sort_columns_->at(i).column_id_);
+    if (OB_INVALID_INDEX == idx)
+    {
+      TBSYS_LOG(ERROR, "sort column not in the row, tid=%lu cid=%lu",
+                sort_columns_->at(i).table_id_, sort_columns_->at(i).column_id_);
+      ret = OB_ERR_UNEXPECTED;
+    }
+    else if (OB_SUCCESS != (ret = sort_column_idx_.push_back(idx)))
+    {
+      TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+    }
+  }
+  return ret;
+}
+
+int ObTopNSort::add_row(const common::ObRow &row)
+{
+  int ret = OB_SUCCESS;
+  OB_ASSERT(sort_columns_);
+  if (OB_UNLIKELY(0 >= topn_))
+  {
+    TBSYS_LOG(ERROR, "invalid topn=%ld", topn_);
+    ret = OB_NOT_INIT;
+  }
+  else if (NULL == row_desc_
+           && OB_SUCCESS != (ret = init_sort_column_idx(row)))
+  {
+    TBSYS_LOG(WARN, "failed to init sort columns, err=%d", ret);
+  }
+  else if (heap_.count() < topn_)
+  {
+    ret = push_row(row);
+  }
+  else if (is_before(row, heap_.at(0)))
+  {
+    ret = replace_top(row);
+  }
+  else
+  {
+    // not in the top n rows, drop it without copying
+  }
+  return ret;
+}
+
+bool ObTopNSort::is_before(const common::ObRow &row, const common::ObRowStore::StoredRow *stored_row) const
+{
+  bool ret = false;
+  const ObObj *cell = NULL;
+  for (int64_t i = 0; i < sort_column_idx_.count(); ++i)
+  {
+    if (OB_SUCCESS != row.raw_get_cell(sort_column_idx_.at(i), cell))
+    {
+      TBSYS_LOG(ERROR, "failed to get cell, idx=%ld", sort_column_idx_.at(i));
+      break;
+    }
+    else if (*cell < stored_row->reserved_cells_[i])
+    {
+      ret = sort_columns_->at(i).is_ascending_;
+      break;
+    }
+    else if (*cell > stored_row->reserved_cells_[i])
+    {
+      ret = !sort_columns_->at(i).is_ascending_;
+      break;
+    }
+  } // end for
+  return ret;
+}
+
+int ObTopNSort::push_row(const common::ObRow &row)
+{
+  int ret = OB_SUCCESS;
+  const common::ObRowStore::StoredRow* stored_row = NULL;
+  if (OB_SUCCESS != (ret = row_stores_[cur_store_idx_].add_row(row, stored_row)))
+  {
+    TBSYS_LOG(WARN, "failed to add row into row_store, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = heap_.push_back(stored_row)))
+  {
+    TBSYS_LOG(WARN, "failed to push back to array, err=%d", ret);
+  }
+  else
+  {
+    const common::ObRowStore::StoredRow **first_row = &heap_.at(0);
+    std::push_heap(first_row, first_row + heap_.count(), Comparer(*sort_columns_));
+  }
+  return ret;
+}
+
+int ObTopNSort::replace_top(const common::ObRow &row)
+{
+  int ret = OB_SUCCESS;
+  const common::ObRowStore::StoredRow* stored_row = NULL;
+  if (OB_SUCCESS != (ret = row_stores_[cur_store_idx_].add_row(row, stored_row)))
+  {
+    TBSYS_LOG(WARN, "failed to add row into row_store, err=%d", ret);
+  }
+  else
+  {
+    Comparer comparer(*sort_columns_);
+    const common::ObRowStore::StoredRow **first_row = &heap_.at(0);
+    const int64_t row_count = heap_.count();
+    std::pop_heap(first_row, first_row + row_count, comparer);
+    first_row[row_count - 1] = stored_row;
+    std::push_heap(first_row, first_row + row_count, comparer);
+    ++dropped_row_count_;
+    if (topn_ <= dropped_row_count_ && MIN_COMPACT_ROW_COUNT <= dropped_row_count_)
+    {
+      ret = compact_rows();
+    }
+  }
+  return ret;
+}
+
+int ObTopNSort::compact_rows()
+{
+  int ret = OB_SUCCESS;
+  const int64_t next_store_idx = 1 - cur_store_idx_;
+  ObRowStore &next_store = row_stores_[next_store_idx];
+  const common::ObRowStore::StoredRow* stored_row = NULL;
+  curr_row_.set_row_desc(*row_desc_);
+  // the order of the heap is kept since the sort keys are not changed
+  for (int64_t i = 0; i < heap_.count(); ++i)
+  {
+    if (OB_SUCCESS != (ret = ObRowUtil::convert(heap_.at(i)->get_compact_row(), curr_row_)))
+    {
+      TBSYS_LOG(WARN, "failed to convert row, err=%d", ret);
+      break;
+    }
+    else if (OB_SUCCESS != (ret = next_store.add_row(curr_row_, stored_row)))
+    {
+      TBSYS_LOG(WARN, "failed to add row into row_store, err=%d", ret);
+      break;
+    }
+    else
+    {
+      heap_.at(i) = stored_row;
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    TBSYS_LOG(DEBUG, "compact topn rows, row_count=%ld dropped_row_count=%ld",
+              heap_.count(), dropped_row_count_);
+    row_stores_[cur_store_idx_].clear_rows();
+    cur_store_idx_ = next_store_idx;
+    dropped_row_count_ = 0;
+  }
+  return ret;
+}
+
+int ObTopNSort::sort_rows()
+{
+  int ret = OB_SUCCESS;
+  OB_ASSERT(sort_columns_);
+  if (0 < heap_.count())
+  {
+    const common::ObRowStore::StoredRow **first_row = &heap_.at(0);
+    std::sort_heap(first_row, first_row + heap_.count(), Comparer(*sort_columns_));
+  }
+  get_pos_ = 0;
+  return ret;
+}
+
+int ObTopNSort::get_next_row(const common::ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  if (get_pos_ >= heap_.count())
+  {
+    ret = OB_ITER_END;
+  }
+  else
+  {
+    OB_ASSERT(row_desc_);
+    curr_row_.set_row_desc(*row_desc_);
+    if (OB_SUCCESS != (ret = ObRowUtil::convert(heap_.at(get_pos_)->get_compact_row(), curr_row_)))
+    {
+      TBSYS_LOG(WARN, "failed to convert row, err=%d", ret);
+    }
+    else
+    {
+      ++get_pos_;
+      row = &curr_row_;
+    }
+  }
+  return ret;
+}
+
+int64_t ObTopNSort::get_used_mem_size() const
+{
+  return row_stores_[0].get_used_mem_size() + row_stores_[1].get_used_mem_size()
+    + heap_.count() * sizeof(void*);
+}
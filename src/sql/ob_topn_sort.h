@@ -0,0 +1,99 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_topn_sort.h
+ *
+ */
+#ifndef _OB_TOPN_SORT_H
+#define _OB_TOPN_SORT_H 1
+#include "common/ob_array.h"
+#include "common/ob_row.h"
+#include "common/ob_row_store.h"
+#include "ob_sort_helper.h"
+#include "ob_in_memory_sort.h"
+
+namespace oceanbase
+{
+  namespace sql
+  {
+    // 只保留排在最前面的topn行的排序，用于ORDER BY ... LIMIT
+    // 1. 用一个大小为topn的堆保存当前最前面的topn行，堆顶是其中排在最后的一行；
+    //    新的行不排在堆顶之前时直接丢弃，不拷贝
+    // 2. 被挤出堆的行仍然占用row store的内存，丢弃的行数达到topn时，
+    //    把堆中的行拷贝到另一个row store中，两个row store轮流使用，内存不超过约2*topn行
+    class ObTopNSort: public ObSortHelper
+    {
+      public:
+        ObTopNSort();
+        virtual ~ObTopNSort();
+
+        int set_sort_columns(const common::ObArray<ObSortColumn> &sort_columns);
+        /// @param topn must be positive
+        void set_topn(const int64_t topn);
+        int64_t get_topn() const;
+
+        void reset();
+        /// remove all the rows but keep the sort columns
+        void reuse();
+        int add_row(const common::ObRow &row);
+        /// sort the kept rows, no more rows could be added
+        int sort_rows();
+
+        // @pre sort_rows()
+        virtual int get_next_row(const common::ObRow *&row);
+
+        int64_t get_row_count() const;
+        int64_t get_used_mem_size() const;
+      private:
+        // types and constants
+        struct Comparer;
+        static const int64_t MIN_COMPACT_ROW_COUNT = 1024L;
+      private:
+        // disallow copy
+        ObTopNSort(const ObTopNSort &other);
+        ObTopNSort& operator=(const ObTopNSort &other);
+        // function members
+        int init_sort_column_idx(const common::ObRow &row);
+        /// whether `row' is sorted before the stored row
+        bool is_before(const common::ObRow &row, const common::ObRowStore::StoredRow *stored_row) const;
+        int push_row(const common::ObRow &row);
+        int replace_top(const common::ObRow &row);
+        int compact_rows();
+      private:
+        // data members
+        const common::ObArray<ObSortColumn> *sort_columns_;
+        int64_t topn_;
+        common::ObRowStore row_stores_[2];
+        int64_t cur_store_idx_;
+        int64_t dropped_row_count_;     // rows in the current store but not in the heap
+        common::ObArray<const common::ObRowStore::StoredRow*> heap_;
+        common::ObArray<int64_t> sort_column_idx_;
+        int64_t get_pos_;
+        common::ObRow curr_row_;
+        const common::ObRowDesc *row_desc_;
+    };
+
+    inline void ObTopNSort::set_topn(const int64_t topn)
+    {
+      topn_ = topn;
+    }
+
+    inline int64_t ObTopNSort::get_topn() const
+    {
+      return topn_;
+    }
+
+    inline int64_t ObTopNSort::get_row_count() const
+    {
+      return heap_.count();
+    }
+  } // end namespace sql
+} // end namespace oceanbase
+
+#endif /* _OB_TOPN_SORT_H */
@@ -27,6 +27,8 @@
 #include "ob_sort.h"
 #include "ob_merge_distinct.h"
 #include "ob_merge_groupby.h"
+#include "ob_hash_groupby.h"
+#include "ob_hash_join.h"
 #include "ob_merge_join.h"
 #include "ob_scalar_aggregate.h"
 #include "ob_limit.h"
@@ -1068,16 +1070,46 @@ int ObTransformer::gen_phy_group_by(
     ObPhyOperator *&out_op)
 {
   int& ret = err_stat.err_code_ = OB_SUCCESS;
-  ObMergeGroupBy *group_op = NULL;
+  ObGroupBy *group_op = NULL;
+  ObMergeGroupBy *merge_group_op = NULL;
+  ObHashGroupBy *hash_group_op = NULL;
   ObSort *sort_op = NULL;
   ObProject *project_op = NULL;
-  if (ret == OB_SUCCESS)
-    CREATE_PHY_OPERRATOR(sort_op, ObSort, physical_plan, err_stat);
-  if (ret == OB_SUCCESS)
-    CREATE_PHY_OPERRATOR(group_op, ObMergeGroupBy, physical_plan, err_stat);
-  if (ret == OB_SUCCESS && (ret = group_op->set_child(0, *sort_op)) != OB_SUCCESS)
+  if (is_group_by_rowkey_prefix(logical_plan, select_stmt)
+    || select_stmt->get_order_item_size() <= 0)
   {
-    TRANS_LOG("Add child of group by plan faild");
+    // input rows are nearly in the group order already, or the groups are expected
+    // in the group order since there is no ORDER BY, sort + merge group by
+    if (ret == OB_SUCCESS)
+      CREATE_PHY_OPERRATOR(sort_op, ObSort, physical_plan, err_stat);
+    if (ret == OB_SUCCESS)
+      CREATE_PHY_OPERRATOR(merge_group_op, ObMergeGroupBy, physical_plan, err_stat);
+    if (ret == OB_SUCCESS && (ret = merge_group_op->set_child(0, *sort_op)) != OB_SUCCESS)
+    {
+      TRANS_LOG("Add child of group by plan faild");
+    }
+    group_op = merge_group_op;
+  }
+  else
+  {
+    // unsorted input and the groups will be ordered by ORDER BY later,
+    // aggregate by hashing the group columns without sorting
+    if (ret == OB_SUCCESS)
+      CREATE_PHY_OPERRATOR(hash_group_op, ObHashGroupBy, physical_plan, err_stat);
+    char run_filename_buf[OB_MAX_FILE_NAME_LENGTH];
+    ObString run_filename;
+    int64_t mem_size_limit = 0;
+    if (ret == OB_SUCCESS
+      && get_work_area("hash_groupby", hash_group_op, mem_size_limit,
+                       run_filename_buf, OB_MAX_FILE_NAME_LENGTH, run_filename))
+    {
+      hash_group_op->set_mem_size_limit(mem_size_limit);
+      if ((ret = hash_group_op->set_run_filename(run_filename)) != OB_SUCCESS)
+      {
+        TRANS_LOG("Set run file of hash group by faild");
+      }
+    }
+    group_op = hash_group_op;
   }
 
   ObSqlRawExpr *group_expr;
@@ -1090,12 +1122,15 @@ int ObTransformer::gen_phy_group_by(
     {
       ObBinaryRefRawExpr *col_expr = dynamic_cast<ObBinaryRefRawExpr*>(group_expr->get_expr());
       OB_ASSERT(NULL != col_expr);
-      ret = sort_op->add_sort_column(col_expr->get_first_ref_id(), col_expr->get_second_ref_id(), true);
-      if (ret != OB_SUCCESS)
+      if (NULL != sort_op)
       {
-        TRANS_LOG("Add sort column faild, table_id=%lu, column_id=%lu",
-            col_expr->get_first_ref_id(), col_expr->get_second_ref_id());
-        break;
+        ret = sort_op->add_sort_column(col_expr->get_first_ref_id(), col_expr->get_second_ref_id(), true);
+        if (ret != OB_SUCCESS)
+        {
+          TRANS_LOG("Add sort column faild, table_id=%lu, column_id=%lu",
+              col_expr->get_first_ref_id(), col_expr->get_second_ref_id());
+          break;
+        }
       }
       ret = group_op->add_group_column(col_expr->get_first_ref_id(), col_expr->get_second_ref_id());
       if (ret != OB_SUCCESS)
@@ -1133,7 +1168,8 @@ int ObTransformer::gen_phy_group_by(
         TRANS_LOG("Add output column to project plan faild");
         break;
       }
-      if ((ret = sort_op->add_sort_column(
+      if (NULL != sort_op
+        && (ret = sort_op->add_sort_column(
                               group_expr->get_table_id(),
                               group_expr->get_column_id(),
                               true)) != OB_SUCCESS)
@@ -1152,13 +1188,16 @@ int ObTransformer::gen_phy_group_by(
   }
   if (ret == OB_SUCCESS)
   {
+    ObPhyOperator *group_child_op = group_op;
+    if (NULL != sort_op)
+      group_child_op = sort_op;
     if (project_op)
-      ret = sort_op->set_child(0, *project_op);
+      ret = group_child_op->set_child(0, *project_op);
     else
-      ret = sort_op->set_child(0, *in_op);
+      ret = group_child_op->set_child(0, *in_op);
     if (ret != OB_SUCCESS)
     {
-      TRANS_LOG("Add child to sort plan faild");
+      TRANS_LOG("Add child to group by plan faild");
     }
   }
 
@@ -1195,6 +1234,165 @@ int ObTransformer::gen_phy_group_by(
   return ret;
 }
 
+// the rowkey order of a single table is kept by the scan, so when the group columns
+// are exactly a prefix of the rowkey the merge group by is preferred
+bool ObTransformer::is_group_by_rowkey_prefix(
+    ObLogicalPlan *logical_plan,
+    ObSelectStmt *select_stmt)
+{
+  bool ret = false;
+  int32_t num = select_stmt->get_group_expr_size();
+  if (1 == select_stmt->get_table_size()
+    && 0 < num && num <= OB_MAX_ROWKEY_COLUMN_NUMBER)
+  {
+    TableItem &table_item = select_stmt->get_table_item(0);
+    const ObTableSchema *table_schema = NULL;
+    if (TableItem::GENERATED_TABLE != table_item.type_
+      && NULL != (table_schema = sql_context_->schema_manager_->get_table_schema(table_item.ref_id_)))
+    {
+      const ObRowkeyInfo &rowkey_info = table_schema->get_rowkey_info();
+      bool covered[OB_MAX_ROWKEY_COLUMN_NUMBER];
+      memset(covered, 0, sizeof(covered));
+      ret = true;
+      for (int32_t i = 0; ret && i < num; i++)
+      {
+        ObSqlRawExpr *group_expr = logical_plan->get_expr(select_stmt->get_group_expr_id(i));
+        ObBinaryRefRawExpr *col_expr = NULL;
+        ObRowkeyColumn rowkey_column;
+        int64_t index = -1;
+        if (NULL == group_expr
+          || group_expr->get_expr()->get_expr_type() != T_REF_COLUMN
+          || NULL == (col_expr = dynamic_cast<ObBinaryRefRawExpr*>(group_expr->get_expr()))
+          || col_expr->get_first_ref_id() != table_item.table_id_
+          || OB_SUCCESS != rowkey_info.get_index(col_expr->get_second_ref_id(), index, rowkey_column)
+          || index >= num)
+        {
+          ret = false;
+        }
+        else
+        {
+          covered[index] = true;
+        }
+      }
+      for (int32_t i = 0; ret && i < num; i++)
+      {
+        ret = covered[i];
+      }
+    }
+  }
+  return ret;
+}
+
+// hash join compares the join keys by their hash values, so both columns
+// should be of the same type, which is only known for base tables
+bool ObTransformer::is_hash_join_cond(
+    ObSelectStmt *select_stmt,
+    ObBinaryRefRawExpr *expr1,
+    ObBinaryRefRawExpr *expr2)
+{
+  bool ret = false;
+  TableItem *table_item1 = NULL;
+  TableItem *table_item2 = NULL;
+  const ObColumnSchemaV2 *column1 = NULL;
+  const ObColumnSchemaV2 *column2 = NULL;
+  if (NULL != expr1 && NULL != expr2
+    && NULL != (table_item1 = select_stmt->get_table_item_by_id(expr1->get_first_ref_id()))
+    && NULL != (table_item2 = select_stmt->get_table_item_by_id(expr2->get_first_ref_id()))
+    && TableItem::GENERATED_TABLE != table_item1->type_
+    && TableItem::GENERATED_TABLE != table_item2->type_
+    && NULL != (column1 = sql_context_->schema_manager_->get_column_schema(
+                  table_item1->ref_id_, expr1->get_second_ref_id()))
+    && NULL != (column2 = sql_context_->schema_manager_->get_column_schema(
+                  table_item2->ref_id_, expr2->get_second_ref_id())))
+  {
+    ret = (column1->get_type() == column2->get_type());
+  }
+  return ret;
+}
+
+// build the hash table on the child which is known to be small, the limit is raised
+// when the build rows could be dumped to the run file of the work area,
+// otherwise sort both children and use merge join as before
+bool ObTransformer::choose_hash_join(
+    ObPhyOperator *left_op,
+    ObPhyOperator *right_op,
+    bool &build_left)
+{
+  bool ret = false;
+  int64_t left_rows = estimate_row_count(left_op);
+  int64_t right_rows = estimate_row_count(right_op);
+  int64_t max_build_rows = (0 < get_work_area_size()) ?
+    HASH_JOIN_MAX_DUMP_BUILD_ROWS : HASH_JOIN_MAX_BUILD_ROWS;
+  if (0 <= right_rows && right_rows <= max_build_rows
+    && (0 > left_rows || right_rows <= left_rows))
+  {
+    build_left = false;
+    ret = true;
+  }
+  else if (0 <= left_rows && left_rows <= max_build_rows)
+  {
+    build_left = true;
+    ret = true;
+  }
+  TBSYS_LOG(DEBUG, "estimated join rows, left=%ld right=%ld use_hash_join=%c build_left=%c",
+      left_rows, right_rows, ret ? 'Y' : 'N', build_left ? 'Y' : 'N');
+  return ret;
+}
+
+// @return -1 if unknown
+int64_t ObTransformer::estimate_row_count(ObPhyOperator *op)
+{
+  int64_t ret = -1;
+  ObTableRpcScan *table_rpc_scan_op = NULL;
+  if (NULL != (table_rpc_scan_op = dynamic_cast<ObTableRpcScan*>(op)))
+  {
+    ret = table_rpc_scan_op->get_estimated_row_count();
+  }
+  return ret;
+}
+
+// @return 0 if no limit is configured
+int64_t ObTransformer::get_work_area_size() const
+{
+  int64_t ret = 0;
+  if (NULL != sql_context_ && NULL != sql_context_->merge_service_)
+  {
+    ret = sql_context_->merge_service_->get_config().sql_work_area_size;
+  }
+  return ret;
+}
+
+// the memory limit and run file of hash group by/hash join, rows beyond the limit are
+// dumped to a run file under sql_tmp_dir, which is named by the pid and the operator
+// @return false if no limit is configured
+bool ObTransformer::get_work_area(
+    const char *op_name,
+    const ObPhyOperator *op,
+    int64_t &mem_size_limit,
+    char *filename_buf,
+    const int64_t buf_len,
+    ObString &run_filename)
+{
+  bool ret = false;
+  if (0 < (mem_size_limit = get_work_area_size()))
+  {
+    const mergeserver::ObMergeServerConfig &config = sql_context_->merge_service_->get_config();
+    int64_t len = snprintf(filename_buf, buf_len, "%s/%s_%d_%p.run",
+        config.sql_tmp_dir.str(), op_name, getpid(), op);
+    if (0 < len && len < buf_len)
+    {
+      run_filename.assign_ptr(filename_buf, static_cast<int32_t>(len));
+      ret = true;
+    }
+    else
+    {
+      TBSYS_LOG(WARN, "run file name is too long, dir=%s", config.sql_tmp_dir.str());
+      mem_size_limit = 0;
+    }
+  }
+  return ret;
+}
+
 int ObTransformer::gen_phy_scalar_aggregate(
     ObLogicalPlan *logical_plan,
     ObPhysicalPlan *physical_plan,
@@ -1258,11 +1456,9 @@ int ObTransformer::gen_phy_joins(
   while (ret == OB_SUCCESS && phy_table_list.size() > 1)
   {
     ObAddProject *project_op = NULL;
-    ObMergeJoin *join_op = NULL;
-    CREATE_PHY_OPERRATOR(join_op, ObMergeJoin, physical_plan, err_stat);
-    if (ret != OB_SUCCESS)
-      break;
-    join_op->set_join_type(ObJoin::INNER_JOIN);
+    // merge join by default, hash join is chosen when the first join condition is found
+    ObJoin *join_op = NULL;
+    ObHashJoin *hash_join_op = NULL;
 
     ObBitSet<> join_table_bitset;
     ObBitSet<> left_table_bitset;
@@ -1280,26 +1476,6 @@ int ObTransformer::gen_phy_joins(
         ObBinaryRefRawExpr *rexpr = dynamic_cast<ObBinaryRefRawExpr*>(join_cnd->get_second_op_expr());
         int32_t left_bit_idx = select_stmt->get_table_bit_index(lexpr->get_first_ref_id());
         int32_t right_bit_idx = select_stmt->get_table_bit_index(rexpr->get_first_ref_id());
-        CREATE_PHY_OPERRATOR(left_sort, ObSort, physical_plan, err_stat);
-        if (ret != OB_SUCCESS)
-          break;
-        ret = left_sort->add_sort_column(lexpr->get_first_ref_id(), lexpr->get_second_ref_id(), true);
-        if (ret != OB_SUCCESS)
-        {
-          TRANS_LOG("Add sort column faild table_id=%lu, column_id =%lu",
-              lexpr->get_first_ref_id(), lexpr->get_second_ref_id());
-          break;
-        }
-        CREATE_PHY_OPERRATOR(right_sort, ObSort, physical_plan, err_stat);
-        if (ret != OB_SUCCESS)
-          break;
-        ret = right_sort->add_sort_column(rexpr->get_first_ref_id(), rexpr->get_second_ref_id(), true);
-        if (ret != OB_SUCCESS)
-        {
-          TRANS_LOG("Add sort column faild table_id=%lu, column_id =%lu",
-              lexpr->get_first_ref_id(), lexpr->get_second_ref_id());
-          break;
-        }
 
         oceanbase::common::ObList<ObPhyOperator*>::iterator table_it = phy_table_list.begin();
         oceanbase::common::ObList<ObPhyOperator*>::iterator del_table_it;
@@ -1355,16 +1531,73 @@ int ObTransformer::gen_phy_joins(
 
         // Two columns must from different table, that expression from one table has been erased in gen_phy_table()
         OB_ASSERT(left_table_op && right_table_op);
-        if ((ret = left_sort->set_child(0, *left_table_op)) != OB_SUCCESS )
+        bool build_left = false;
+        if (is_hash_join_cond(select_stmt, lexpr, rexpr)
+          && choose_hash_join(left_table_op, right_table_op, build_left))
         {
-          TRANS_LOG("Add child of join plan faild");
-          break;
+          // the children need not to be sorted
+          CREATE_PHY_OPERRATOR(hash_join_op, ObHashJoin, physical_plan, err_stat);
+          if (ret != OB_SUCCESS)
+            break;
+          hash_join_op->set_build_left(build_left);
+          char run_filename_buf[OB_MAX_FILE_NAME_LENGTH];
+          ObString run_filename;
+          int64_t mem_size_limit = 0;
+          if (get_work_area("hash_join", hash_join_op, mem_size_limit,
+                            run_filename_buf, OB_MAX_FILE_NAME_LENGTH, run_filename))
+          {
+            hash_join_op->set_mem_size_limit(mem_size_limit);
+            if ((ret = hash_join_op->set_run_filename(run_filename)) != OB_SUCCESS)
+            {
+              TRANS_LOG("Set run file of hash join faild");
+              break;
+            }
+          }
+          join_op = hash_join_op;
+          if ((ret = join_op->set_child(0, *left_table_op)) != OB_SUCCESS
+            || (ret = join_op->set_child(1, *right_table_op)) != OB_SUCCESS)
+          {
+            TRANS_LOG("Add child of join plan faild");
+            break;
+          }
         }
-        if ((ret = right_sort->set_child(0, *right_table_op)) != OB_SUCCESS )
+        else
         {
-          TRANS_LOG("Add child of join plan faild");
-          break;
+          CREATE_PHY_OPERRATOR(join_op, ObMergeJoin, physical_plan, err_stat);
+          if (ret != OB_SUCCESS)
+            break;
+          CREATE_PHY_OPERRATOR(left_sort, ObSort, physical_plan, err_stat);
+          if (ret != OB_SUCCESS)
+            break;
+          ret = left_sort->add_sort_column(lexpr->get_first_ref_id(), lexpr->get_second_ref_id(), true);
+          if (ret != OB_SUCCESS)
+          {
+            TRANS_LOG("Add sort column faild table_id=%lu, column_id =%lu",
+                lexpr->get_first_ref_id(), lexpr->get_second_ref_id());
+            break;
+          }
+          CREATE_PHY_OPERRATOR(right_sort, ObSort, physical_plan, err_stat);
+          if (ret != OB_SUCCESS)
+            break;
+          ret = right_sort->add_sort_column(rexpr->get_first_ref_id(), rexpr->get_second_ref_id(), true);
+          if (ret != OB_SUCCESS)
+          {
+            TRANS_LOG("Add sort column faild table_id=%lu, column_id =%lu",
+                lexpr->get_first_ref_id(), lexpr->get_second_ref_id());
+            break;
+          }
+          if ((ret = left_sort->set_child(0, *left_table_op)) != OB_SUCCESS )
+          {
+            TRANS_LOG("Add child of join plan faild");
+            break;
+          }
+          if ((ret = right_sort->set_child(0, *right_table_op)) != OB_SUCCESS )
+          {
+            TRANS_LOG("Add child of join plan faild");
+            break;
+          }
         }
+        join_op->set_join_type(ObJoin::INNER_JOIN);
         ObSqlExpression join_op_cnd;
         if ((ret = (*cnd_it)->fill_sql_expression(
                                   join_op_cnd,
@@ -1396,7 +1629,11 @@ int ObTransformer::gen_phy_joins(
         ObBinaryRefRawExpr *expr2 = dynamic_cast<ObBinaryRefRawExpr*>(join_cnd->get_second_op_expr());
         int32_t bit_idx1 = select_stmt->get_table_bit_index(expr1->get_first_ref_id());
         int32_t bit_idx2 = select_stmt->get_table_bit_index(expr2->get_first_ref_id());
-        if (left_table_bitset.has_member(bit_idx1))
+        if (hash_join_op != NULL)
+        {
+          // no sort needed for hash join
+        }
+        else if (left_table_bitset.has_member(bit_idx1))
           ret = left_sort->add_sort_column(expr1->get_first_ref_id(), expr1->get_second_ref_id(), true);
         else
           ret = right_sort->add_sort_column(expr1->get_first_ref_id(), expr1->get_second_ref_id(), true);
@@ -1406,7 +1643,11 @@ int ObTransformer::gen_phy_joins(
               expr1->get_first_ref_id(), expr1->get_second_ref_id());
           break;
         }
-        if (right_table_bitset.has_member(bit_idx2))
+        if (hash_join_op != NULL)
+        {
+          // no sort needed for hash join
+        }
+        else if (right_table_bitset.has_member(bit_idx2))
           ret = right_sort->add_sort_column(expr2->get_first_ref_id(), expr2->get_second_ref_id(), true);
         else
           ret = left_sort->add_sort_column(expr2->get_first_ref_id(), expr2->get_second_ref_id(), true);
@@ -1421,8 +1662,17 @@ int ObTransformer::gen_phy_joins(
                                   join_op_cnd,
                                   this,
                                   logical_plan,
-                                  physical_plan))) != OB_SUCCESS
-          || (ret = join_op->add_equijoin_condition(join_op_cnd)) != OB_SUCCESS)
+                                  physical_plan))) != OB_SUCCESS)
+        {
+          TRANS_LOG("Add condition of join plan faild");
+          break;
+        }
+        // keys of different types could not be hashed, check them as other condition instead
+        else if (hash_join_op != NULL && !is_hash_join_cond(select_stmt, expr1, expr2))
+          ret = join_op->add_other_join_condition(join_op_cnd);
+        else
+          ret = join_op->add_equijoin_condition(join_op_cnd);
+        if (ret != OB_SUCCESS)
         {
           TRANS_LOG("Add condition of join plan faild");
           break;
@@ -1440,6 +1690,13 @@ int ObTransformer::gen_phy_joins(
         && (*cnd_it)->get_tables_set().overlap(left_table_bitset)
         && (*cnd_it)->get_tables_set().overlap(right_table_bitset)))
       {
+        if (join_op == NULL)
+        {
+          CREATE_PHY_OPERRATOR(join_op, ObMergeJoin, physical_plan, err_stat);
+          if (ret != OB_SUCCESS)
+            break;
+          join_op->set_join_type(ObJoin::INNER_JOIN);
+        }
         ObSqlExpression join_other_cnd;
         if ((ret = ((*cnd_it)->fill_sql_expression(
                                   join_other_cnd,
@@ -1469,24 +1726,36 @@ int ObTransformer::gen_phy_joins(
     {
       if (join_table_bitset.is_empty() == false)
       {
-        // find a join condition, a merge join will be used here
-        OB_ASSERT(left_sort != NULL);
-        OB_ASSERT(right_sort != NULL);
-        if ((ret = join_op->set_child(0, *left_sort)) != OB_SUCCESS)
+        // find a join condition, a merge join or a hash join will be used here
+        // the children of hash join have been set already
+        OB_ASSERT(join_op != NULL);
+        if (hash_join_op == NULL)
         {
-          TRANS_LOG("Add child of join plan faild");
-          break;
-        }
-        if ((ret = join_op->set_child(1, *right_sort)) != OB_SUCCESS)
-        {
-          TRANS_LOG("Add child of join plan faild");
-          break;
+          OB_ASSERT(left_sort != NULL);
+          OB_ASSERT(right_sort != NULL);
+          if ((ret = join_op->set_child(0, *left_sort)) != OB_SUCCESS)
+          {
+            TRANS_LOG("Add child of join plan faild");
+            break;
+          }
+          if ((ret = join_op->set_child(1, *right_sort)) != OB_SUCCESS)
+          {
+            TRANS_LOG("Add child of join plan faild");
+            break;
+          }
         }
       }
       else
       {
         // Can not find a join condition, a product join will be used here
         // FIX me, should be ObJoin, it will be fixed when Join is supported
+        if (join_op == NULL)
+        {
+          CREATE_PHY_OPERRATOR(join_op, ObMergeJoin, physical_plan, err_stat);
+          if (ret != OB_SUCCESS)
+            break;
+          join_op->set_join_type(ObJoin::INNER_JOIN);
+        }
         ObPhyOperator *op = NULL;
         if ((ret = phy_table_list.pop_front(op)) != OB_SUCCESS)
         {
@@ -1955,6 +2224,11 @@ int ObTransformer::gen_phy_table(
           else
           {
             TBSYS_LOG(DEBUG, "use [%s] method", read_method == ObSqlReadStrategy::USE_SCAN ? "SCAN" : "GET");
+            if (ObSqlReadStrategy::USE_GET == read_method)
+            {
+              // at most one row for each rowkey
+              table_rpc_scan_op->set_estimated_row_count(rowkey_array.count());
+            }
           }
           hint.read_method_ = read_method;
         }
@@ -2357,7 +2631,9 @@ int ObTransformer::try_push_down_limit(
   // 2. only one table, whose type is BASE_TABLE or ALIAS_TABLE
   // 3. can not be joined table.
   // 4. does not have group clause or aggregate function(s)
-  // 5. does not have order by caluse
+  // 5. does not have order by caluse, or all the order items are columns of the table,
+  //    then every tablet returns its top offset+limit rows, and the limit is still
+  //    needed over the sort of the merge server
   // 6. limit is initialed
   else if (select_stmt->get_from_item_size() == 1
     && select_stmt->get_from_item(0).is_joined_ == false
@@ -2366,9 +2642,36 @@ int ObTransformer::try_push_down_limit(
     || select_stmt->get_table_item(0).type_ == TableItem::ALIAS_TABLE)
     && select_stmt->get_group_expr_size() == 0
     && select_stmt->get_agg_fun_size() == 0
-    && select_stmt->get_order_item_size() == 0)
-  {
-    limit_pushed_down = true;
+    && (select_stmt->get_order_item_size() == 0
+    || (select_stmt->get_limit_expr_id() != OB_INVALID_ID
+    && !select_stmt->is_distinct()
+    && select_stmt->get_having_expr_size() == 0
+    && is_order_by_columns_of(logical_plan, select_stmt, select_stmt->get_table_item(0).table_id_))))
+  {
+    limit_pushed_down = (select_stmt->get_order_item_size() == 0);
+    int32_t num = select_stmt->get_order_item_size();
+    for (int32_t i = 0; ret == OB_SUCCESS && i < num; i++)
+    {
+      const OrderItem& order_item = select_stmt->get_order_item(i);
+      ObSqlRawExpr *order_expr = logical_plan->get_expr(order_item.expr_id_);
+      if (order_expr->get_expr()->is_const())
+      {
+        // do nothing, const column is of no usage for sorting
+      }
+      else
+      {
+        ObBinaryRefRawExpr *col_expr = dynamic_cast<ObBinaryRefRawExpr*>(order_expr->get_expr());
+        if ((ret = table_rpc_scan_op->add_sort_column(
+                                col_expr->get_first_ref_id(),
+                                col_expr->get_second_ref_id(),
+                                order_item.order_type_ == OrderItem::ASC ? true : false
+                                )) != OB_SUCCESS)
+        {
+          TRANS_LOG("Add sort column to table scan failed");
+          break;
+        }
+      }
+    }
     ObSqlExpression limit_count;
     ObSqlExpression limit_offset;
     ObSqlExpression *ptr = &limit_count;
@@ -2406,6 +2709,34 @@ int ObTransformer::try_push_down_limit(
   return ret;
 }
 
+bool ObTransformer::is_order_by_columns_of(
+    ObLogicalPlan *logical_plan,
+    const ObSelectStmt *select_stmt,
+    const uint64_t table_id)
+{
+  bool ret = true;
+  int32_t num = select_stmt->get_order_item_size();
+  for (int32_t i = 0; ret && i < num; i++)
+  {
+    const OrderItem& order_item = select_stmt->get_order_item(i);
+    ObSqlRawExpr *order_expr = logical_plan->get_expr(order_item.expr_id_);
+    if (order_expr == NULL)
+    {
+      ret = false;
+    }
+    else if (order_expr->get_expr()->is_const())
+    {
+      // skip
+    }
+    else if (order_expr->get_expr()->get_expr_type() != T_REF_COLUMN
+      || dynamic_cast<ObBinaryRefRawExpr*>(order_expr->get_expr())->get_first_ref_id() != table_id)
+    {
+      ret = false;
+    }
+  }
+  return ret;
+}
+
 int ObTransformer::gen_phy_values(
     ObLogicalPlan *logical_plan,
     ObPhysicalPlan *physical_plan,
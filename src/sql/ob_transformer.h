@@ -54,6 +54,11 @@ namespace oceanbase
         ObSqlContext* get_sql_context();
 
       private:
+        // max estimated rows of the build side to choose hash join if it could not be dumped
+        static const int64_t HASH_JOIN_MAX_BUILD_ROWS = 100000;
+        // max estimated rows of the build side to choose hash join if it could be dumped,
+        // a bigger build side is written to and read from the run file too many times
+        static const int64_t HASH_JOIN_MAX_DUMP_BUILD_ROWS = 10000000;
         DISALLOW_COPY_AND_ASSIGN(ObTransformer);
         void *trans_malloc(const size_t nbyte);
         void trans_free(void* p);
@@ -154,6 +159,26 @@ namespace oceanbase
             ObSelectStmt *select_stmt,
             ObPhyOperator *in_op,
             ObPhyOperator *&out_op);
+        bool is_group_by_rowkey_prefix(
+            ObLogicalPlan *logical_plan,
+            ObSelectStmt *select_stmt);
+        bool is_hash_join_cond(
+            ObSelectStmt *select_stmt,
+            ObBinaryRefRawExpr *expr1,
+            ObBinaryRefRawExpr *expr2);
+        bool choose_hash_join(
+            ObPhyOperator *left_op,
+            ObPhyOperator *right_op,
+            bool &build_left);
+        int64_t estimate_row_count(ObPhyOperator *op);
+        int64_t get_work_area_size() const;
+        bool get_work_area(
+            const char *op_name,
+            const ObPhyOperator *op,
+            int64_t &mem_size_limit,
+            char *filename_buf,
+            const int64_t buf_len,
+            ObString &run_filename);
         int gen_phy_scalar_aggregate(
             ObLogicalPlan *logical_plan,
             ObPhysicalPlan *physical_plan,
@@ -344,6 +369,10 @@ namespace oceanbase
             const ObSelectStmt *select_stmt,
             bool& limit_pushed_down,
             ObPhyOperator *scan_op);
+        bool is_order_by_columns_of(
+            ObLogicalPlan *logical_plan,
+            const ObSelectStmt *select_stmt,
+            const uint64_t table_id);
         int gen_phy_show_parameters(
             ObLogicalPlan *logical_plan,
             ObPhysicalPlan *physical_plan,
@@ -18,6 +18,8 @@
 #include "ob_sstable_block_index_v2.h"
 #include "ob_blockcache.h"
 #include "ob_sstable_writer.h"
+#include "ob_disk_path.h"
+#include "common/ob_io_scheduler.h"
 
 namespace oceanbase 
 {
@@ -25,11 +27,18 @@ namespace oceanbase
   {
     using namespace common;
 
+    //aio backend shared by all the aio buffer managers of the thread
+    static ObAIOBackend*& thread_aio_backend()
+    {
+      static __thread ObAIOBackend* backend = NULL;
+      return backend;
+    }
+
     ObAIOBuffer::ObAIOBuffer() : inited_(false), state_(FREE), fd_(-1), 
       sstable_id_(OB_INVALID_ID), fileinfo_cache_(NULL), file_info_(NULL), 
       file_offset_(-1), misalign_buf_(NULL), buffer_(NULL), buf_size_(0), 
       buf_read_(0), buf_to_read_(0), buf_pos_(0), block_(NULL), block_count_(0), 
-      cur_block_idx_(0)
+      cur_block_idx_(0), io_disk_no_(-1), io_begin_time_(0)
     {
 
     }
@@ -103,8 +112,27 @@ namespace oceanbase
       return ret;
     }
 
+    void ObAIOBuffer::begin_foreground_io(const int64_t disk_no)
+    {
+      io_disk_no_ = disk_no;
+      io_begin_time_ = tbsys::CTimeUtil::getTime();
+      ObIOScheduler::get_instance().begin_foreground_io(disk_no);
+    }
+
+    void ObAIOBuffer::end_foreground_io()
+    {
+      if (io_disk_no_ >= 0)
+      {
+        ObIOScheduler::get_instance().end_foreground_io(io_disk_no_, 
+          tbsys::CTimeUtil::getTime() - io_begin_time_);
+        io_disk_no_ = -1;
+      }
+    }
+
     void ObAIOBuffer::aio_finished(const int64_t ret_size, const int ret_code)
     {
+      end_foreground_io();
+
       if (NULL != file_info_ && WAIT == state_)
       {
         fileinfo_cache_->revert_fileinfo(file_info_);
@@ -459,11 +487,12 @@ namespace oceanbase
 
     ObAIOBufferMgr::~ObAIOBufferMgr()
     {
-      io_context_t ctx = get_io_context();
+      ObAIOBackend*& backend = thread_aio_backend();
 
-      if (NULL != ctx)
+      if (NULL != backend)
       {
-        io_destroy(ctx);
+        ObAIOBackend::destroy(backend);
+        backend = NULL;
       }
 
       if (NULL != block_)
@@ -473,22 +502,23 @@ namespace oceanbase
       }
     }
 
-    io_context_t ObAIOBufferMgr::get_io_context()
+    ObAIOBackend* ObAIOBufferMgr::get_aio_backend()
     {
-      static __thread io_context_t ctx = NULL;
-      int64_t max_events = AIO_BUFFER_COUNT * OB_MAX_COLUMN_GROUP_NUMBER;
+      ObAIOBackend*& backend = thread_aio_backend();
+      // a read of an aio buffer has at most queue_depth chunks in flight,
+      // size the events by the configured depth instead of the max one
+      const int64_t queue_depth = ObAIOBackend::get_queue_depth();
+      int64_t max_events = AIO_BUFFER_COUNT * OB_MAX_COLUMN_GROUP_NUMBER * queue_depth;
 
-      if (NULL == ctx)
+      if (NULL == backend)
       {
-        if (0 != io_setup(static_cast<int>(max_events), &ctx))
+        if (NULL == (backend = ObAIOBackend::create(max_events, queue_depth)))
         {
-          TBSYS_LOG(WARN, "failed to setup io context, ctx=%p, error:%s", 
-                    ctx, strerror(errno));
-          ctx = NULL;
+          TBSYS_LOG(WARN, "failed to create aio backend, max_events=%ld", max_events);
         }
       }
 
-      return ctx;
+      return backend;
     }
 
     int ObAIOBufferMgr::init()
@@ -503,7 +533,7 @@ namespace oceanbase
           ret = buffer_[i].init();
           if (OB_SUCCESS == ret)
           {
-            ret = event_mgr_[i].init(get_io_context());
+            ret = event_mgr_[i].init(get_aio_backend());
           }
         }
   
@@ -1416,6 +1446,20 @@ namespace oceanbase
       return ret;
     }
 
+    void ObAIOBufferMgr::schedule_aio_read(ObAIOBuffer& aio_buf)
+    {
+      //the query reads are only accounted, the merge and migration reads are throttled
+      const int64_t disk_no = static_cast<int64_t>(get_sstable_disk_no(sstable_id_));
+      if (IO_CLASS_FOREGROUND == ObIOScheduler::get_thread_io_class())
+      {
+        aio_buf.begin_foreground_io(disk_no);
+      }
+      else
+      {
+        ObIOScheduler::get_instance().throttle(disk_no, aio_buf.get_toread_size());
+      }
+    }
+
     int ObAIOBufferMgr::aio_read_blocks(ObAIOBuffer& aio_buf, ObAIOEventMgr& event_mgr, 
                                         const int64_t aio_buf_idx, int64_t& timeout_us)
     {
@@ -1435,9 +1479,14 @@ namespace oceanbase
                                     reverse_scan_);
         if (OB_SUCCESS == ret)
         {
+          schedule_aio_read(aio_buf);
           ret = event_mgr.aio_submit(aio_buf.get_fd(), aio_buf.get_file_offset(),
                                      aio_buf.get_toread_size(), aio_buf);
-          if (OB_SUCCESS == ret)
+          if (OB_SUCCESS != ret)
+          {
+            aio_buf.end_foreground_io();
+          }
+          else
           {
             aio_buf.set_state(WAIT);
             cur_buf_idx_ = aio_buf_idx;
@@ -1474,11 +1523,16 @@ namespace oceanbase
 
         if (OB_SUCCESS == ret)
         {
+          schedule_aio_read(*preread_aio_buf);
           ret = preread_event_mgr->aio_submit(preread_aio_buf->get_fd(), 
                                               preread_aio_buf->get_file_offset(),
                                               preread_aio_buf->get_toread_size(), 
                                               *preread_aio_buf);
-          if (OB_SUCCESS == ret)
+          if (OB_SUCCESS != ret)
+          {
+            preread_aio_buf->end_foreground_io();
+          }
+          else
           {
             aio_stat_.total_read_size_ += preread_aio_buf->get_toread_size();
             aio_stat_.total_read_times_ += 1;
@@ -1986,7 +2040,7 @@ namespace oceanbase
       dataindex_key.offset = offset;
       dataindex_key.size = nbyte;
 
-      ret = block_cache_->get_kv_cache().put(dataindex_key, value, false);
+      ret = block_cache_->get_kv_cache(dataindex_key).put(dataindex_key, value, false, true);
 
       return  ret;
     }
@@ -2113,7 +2167,7 @@ namespace oceanbase
             else
             {
               value.nbyte = dataindex_key.size;
-              status = block_cache_->get_kv_cache().put(dataindex_key, value);
+              status = block_cache_->get_kv_cache(dataindex_key).put(dataindex_key, value, true, true);
               if (OB_SUCCESS != status && OB_ENTRY_EXIST != status)
               {
                 TBSYS_LOG(WARN, "failed to copy block data to cache, status=%d", status);
@@ -211,6 +211,16 @@ namespace oceanbase
                                const int64_t block_count,
                                const bool reverse_scan = false);
 
+      /**
+       * account the aio read of this buffer as a foreground read of 
+       * the disk, the latency is reported to io scheduler when the 
+       * aio finishes or end_foreground_io() is called. 
+       * 
+       * @param disk_no disk no of the sstable file
+       */
+      void begin_foreground_io(const int64_t disk_no);
+      void end_foreground_io();
+
       static int64_t lower_align(int64_t input, int64_t align);
       static int64_t upper_align(int64_t input, int64_t align);
       
@@ -237,6 +247,9 @@ namespace oceanbase
       ObBlockInfo* block_;          //block array which this buffer belong to
       int64_t block_count_;         //block count of block array
       int64_t cur_block_idx_;       //which block is reading in crrent block array
+
+      int64_t io_disk_no_;          //disk of the foreground read, -1 if not accounted
+      int64_t io_begin_time_;       //submit time of the foreground read
     };
 
     struct ObIOStat
@@ -291,8 +304,8 @@ namespace oceanbase
      * column group has one ObAIOBufferMgr instance. each instance 
      * has two aio buffers, one aio buffer is used to read the 
      * current blocks data, the other aio buffer is used to preread 
-     * the next blocks data. because each thread has one io_context 
-     * instance, and each thread detect the state of io_context 
+     * the next blocks data. because each thread has one aio backend
+     * instance, and each thread detect the state of aio backend 
      * instance, the application get block serially, but we can do 
      * preread parallel. 
      */
@@ -412,7 +425,7 @@ namespace oceanbase
       }
 
       void reset();
-      io_context_t get_io_context();
+      common::ObAIOBackend* get_aio_backend();
       int ensure_block_buf_space(const int64_t size);
       const char* get_state_str(ObDoubleAIOBufferState state) const;
       void set_state(ObDoubleAIOBufferState state);
@@ -444,6 +457,7 @@ namespace oceanbase
       int init_read_range();
       int update_read_range(const bool check_cache, const bool reverse_scan);
 
+      void schedule_aio_read(ObAIOBuffer& aio_buf);
       int preread_blocks();
       int aio_read_blocks(ObAIOBuffer& aio_buf, ObAIOEventMgr& event_mgr, 
                           const int64_t aio_buf_idx, int64_t& timeout_us);
@@ -23,9 +23,10 @@ namespace oceanbase
   {
     using namespace common;
 
-    ObAIOEventMgr::ObAIOEventMgr() : inited_(false), ctx_(NULL)
+    ObAIOEventMgr::ObAIOEventMgr() 
+    : inited_(false), backend_(NULL), aio_buf_(NULL), pending_nr_(0), 
+      read_size_(0), ret_code_(0)
     {
-      memset(&iocb_, 0, sizeof(struct iocb));
     }
 
     ObAIOEventMgr::~ObAIOEventMgr()
@@ -33,18 +34,18 @@ namespace oceanbase
 
     }
 
-    int ObAIOEventMgr::init(io_context_t ctx)
+    int ObAIOEventMgr::init(ObAIOBackend* backend)
     {
       int ret = OB_SUCCESS;
 
-      if (NULL == ctx)
+      if (NULL == backend)
       {
-        TBSYS_LOG(WARN, "invalid parameter, ctx=%p", ctx);
+        TBSYS_LOG(WARN, "invalid parameter, backend=%p", backend);
         ret = OB_ERROR; 
       }
       else
       {
-        ctx_ = ctx;
+        backend_ = backend;
         inited_ = true;
       }
 
@@ -55,7 +56,9 @@ namespace oceanbase
                                   const int64_t size, ObAIOBufferInterface& aio_buf)
     {
       int ret               = OB_SUCCESS;
-      struct iocb* iocb_tmp = NULL;
+      int64_t chunk_size    = 0;
+      int64_t chunk_offset  = 0;
+      int64_t chunk_nr      = 0;
 
       if (!inited_)
       {
@@ -70,56 +73,123 @@ namespace oceanbase
       }
       else
       {
-        io_prep_pread(&iocb_, fd, aio_buf.get_buffer(), size, offset);
-        iocb_.data = &aio_buf;
-        iocb_tmp = &iocb_;
-        ret = io_submit(ctx_, 1, &iocb_tmp);
-        if (1 != ret)
+        /**
+         * split the request into chunks aligned to OB_DIRECT_IO_ALIGN, 
+         * the last chunk ends at the same position as the whole request 
+         */
+        chunk_size = (size + backend_->get_read_queue_depth() - 1) 
+                     / backend_->get_read_queue_depth();
+        chunk_size = (chunk_size < MIN_CHUNK_SIZE) ? MIN_CHUNK_SIZE : chunk_size;
+        chunk_size = (chunk_size + OB_DIRECT_IO_ALIGN - 1) 
+                     / OB_DIRECT_IO_ALIGN * OB_DIRECT_IO_ALIGN;
+
+        aio_buf_ = &aio_buf;
+        read_size_ = 0;
+        ret_code_ = 0;
+        pending_nr_ = 0;
+        for (chunk_offset = 0; chunk_offset < size && OB_SUCCESS == ret; 
+             chunk_offset += chunk_size, ++chunk_nr)
         {
-          TBSYS_LOG(WARN, "io_submit failed, ret=%d, error: %s", 
-                    ret, strerror(-ret));
-          ret = OB_ERROR;
+          ret = backend_->prep_pread(fd, aio_buf.get_buffer() + chunk_offset,
+                                     (size - chunk_offset < chunk_size) 
+                                     ? size - chunk_offset : chunk_size,
+                                     offset + chunk_offset, this);
         }
-        else
+
+        if (OB_SUCCESS != ret && chunk_nr > 1)
         {
+          /**
+           * the queued chunks can't be cancelled, submit them and report 
+           * the failure by aio_finished() like a failed read 
+           */
+          TBSYS_LOG(WARN, "failed to queue aio read chunk, fd=%d, offset=%ld, size=%ld, "
+                          "chunk_nr=%ld, ret=%d", fd, offset, size, chunk_nr, ret);
+          ret_code_ = EAGAIN;
           ret = OB_SUCCESS;
+          --chunk_nr;
+        }
+
+        if (OB_SUCCESS == ret)
+        {
+          pending_nr_ = chunk_nr;
+          ret = backend_->submit();
+        }
+
+        if (OB_SUCCESS != ret)
+        {
+          TBSYS_LOG(WARN, "aio submit failed, fd=%d, offset=%ld, size=%ld, ret=%d",
+                    fd, offset, size, ret);
+          pending_nr_ = 0;
+          ret = OB_ERROR;
         }
       }
 
       return ret;
     }
 
+    void ObAIOEventMgr::chunk_finished(const int64_t res)
+    {
+      if (pending_nr_ <= 0 || NULL == aio_buf_)
+      {
+        TBSYS_LOG(WARN, "unexpected aio event, pending_nr=%ld, aio_buf=%p, res=%ld", 
+                  pending_nr_, aio_buf_, res);
+      }
+      else
+      {
+        if (res < 0)
+        {
+          ret_code_ = static_cast<int>(-res);
+        }
+        else
+        {
+          read_size_ += res;
+        }
+
+        if (0 == --pending_nr_)
+        {
+          aio_buf_->aio_finished(read_size_, ret_code_);
+        }
+      }
+    }
+
     int ObAIOEventMgr::aio_wait(int64_t& timeout_us)
     {
       int ret               = OB_ERROR;
       int64_t event_nr      = 0;
-      int inner_ret         = OB_CS_EAGAIN;
       int64_t start_time    = tbsys::CTimeUtil::getTime();
       int64_t cur_timeo_us  = timeout_us;
       int64_t max_events_nr = ObAIOBufferMgr::AIO_BUFFER_COUNT 
                               * OB_MAX_COLUMN_GROUP_NUMBER;
-      struct io_event events[max_events_nr];
-      struct timespec timeout;
+      ObAIOEvent events[max_events_nr];
 
       /**
        * NOTE: there are 2 aio buffer for each thread, maybe both of 
        * the aio buffer are reading data by aio, so aio_wait will 
        * detect both of the aio buffer, and check whether some aio 
-       * buffer are ready. 
+       * buffer are ready. the events of this aio buffer may be 
+       * handled by the aio_wait of the other aio buffer already. 
        */
       if (!inited_)
       {
         TBSYS_LOG(WARN, "aio event manager doesn't init");
         ret = OB_ERROR;
       }
+      else if (0 == pending_nr_)
+      {
+        ret = OB_SUCCESS;
+      }
       else
       {
-        while (OB_CS_EAGAIN == inner_ret)
+        while (true)
         {
-          timeout.tv_sec = cur_timeo_us / 1000000;
-          timeout.tv_nsec = cur_timeo_us % 1000000 * 1000;
-          event_nr = io_getevents(ctx_, 1, max_events_nr, events, &timeout);
-          if (0 == event_nr)
+          if (OB_SUCCESS != backend_->get_events(1, max_events_nr, events, 
+                                                 cur_timeo_us, event_nr))
+          {
+            TBSYS_LOG(WARN, "failed to get aio events");
+            ret = OB_ERROR;
+            break;
+          }
+          else if (0 == event_nr)
           {
             TBSYS_LOG(WARN, "AIO read timeout, event_nr=%ld, timeout_us=%ld", 
                       event_nr, timeout_us);
@@ -131,22 +201,18 @@ namespace oceanbase
           {
             for (int64_t i = 0; i < event_nr; ++i)
             {
-              static_cast<ObAIOBufferInterface*>(events[i].data)->aio_finished(
-                events[i].res, static_cast<int>(events[i].res2));
-              if (events[i].data == iocb_.data)
-              {
-                /**
-                 * this event is what we wait, it means that the waiting aio 
-                 * buffer finished aio read, so return OB_SUCCESS. 
-                 */
-                ret = OB_SUCCESS;
-              }
+              static_cast<ObAIOEventMgr*>(events[i].data_)->chunk_finished(events[i].res_);
             }
 
             cur_timeo_us = start_time + timeout_us - tbsys::CTimeUtil::getTime();
-            if (OB_SUCCESS == ret)
+            if (0 == pending_nr_)
             {
+              /**
+               * all the chunks we wait are finished, it means that the 
+               * waiting aio buffer finished aio read, so return OB_SUCCESS. 
+               */
               timeout_us = cur_timeo_us;
+              ret = OB_SUCCESS;
               break;
             }
   
@@ -156,10 +222,6 @@ namespace oceanbase
               ret = OB_AIO_TIMEOUT;
               break;
             }
-            else
-            {
-              inner_ret = OB_CS_EAGAIN;
-            }
           }
         } //while
       }
@@ -14,7 +14,7 @@
 #ifndef OCEANBASE_SSTABLE_OB_AIO_EVENT_MGR_H_
 #define OCEANBASE_SSTABLE_OB_AIO_EVENT_MGR_H_
 
-#include <libaio.h>
+#include "common/ob_aio_backend.h"
 
 namespace oceanbase 
 {
@@ -28,19 +28,22 @@ namespace oceanbase
       ~ObAIOEventMgr();
 
       /**
-       * initialize aio event manager with io_context_t
+       * initialize aio event manager with aio backend
        * 
-       * @param ctx the io_context_t to assign to the aio event 
-       *            manager
+       * @param backend the thread local aio backend to assign to the
+       *                aio event manager
        * 
        * @return int if success, returns OB_SUCCESS, else returns 
        *         OB_ERROR
        */
-      int init(io_context_t ctx);
+      int init(common::ObAIOBackend* backend);
 
       /**
-       * submit an aio read request, it just encapsulate io_submit 
-       * simply 
+       * submit an aio read request, the request is split into at 
+       * most ObAIOBackend::get_read_queue_depth() chunks which are 
+       * submitted together, so the device has more requests in 
+       * flight for one aio buffer. the aio buffer is finished after 
+       * all the chunks are finished. 
        * 
        * @param fd file to read
        * @param offset offset in file 
@@ -55,8 +58,8 @@ namespace oceanbase
                      const int64_t size, ObAIOBufferInterface& aio_buf);
 
       /**
-       * wait aio read to complete, it just  encapsulate io_wait 
-       * simply 
+       * wait aio read to complete, the finished requests of other 
+       * aio event managers using the same backend are handled too 
        * 
        * @param timeout_us [in/out] timeout in us
        * 
@@ -65,11 +68,20 @@ namespace oceanbase
        */
       int aio_wait(int64_t& timeout_us);
 
+    private:
+      static const int64_t MIN_CHUNK_SIZE = 128 * 1024; //128K
+
+    private:
+      void chunk_finished(const int64_t res);
+
     private:
       DISALLOW_COPY_AND_ASSIGN(ObAIOEventMgr);
       bool inited_;
-      io_context_t ctx_;  //io_context, thread local instance 
-      struct iocb iocb_;  //io callback instance
+      common::ObAIOBackend* backend_;   //aio backend, thread local instance 
+      ObAIOBufferInterface* aio_buf_;   //aio buffer of the request in flight
+      int64_t pending_nr_;              //chunks not finished
+      int64_t read_size_;               //size read by the finished chunks
+      int ret_code_;                    //error code of the failed chunk
     };
   } // namespace oceanbase::sstable
 } // namespace Oceanbase
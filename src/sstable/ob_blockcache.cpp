@@ -14,9 +14,11 @@
 #include "common/ob_file.h"
 #include "common/ob_record_header.h"
 #include "common/ob_common_stat.h"
+#include "common/ob_io_scheduler.h"
 #include "ob_blockcache.h"
 #include "ob_sstable_block_index_v2.h"
 #include "ob_sstable_writer.h"
+#include "ob_disk_path.h"
 
 namespace oceanbase
 {
@@ -25,13 +27,13 @@ namespace oceanbase
     using namespace common;
 
     ObBlockCache::ObBlockCache()
-    : inited_(false), fileinfo_cache_(NULL)
+    : inited_(false), fileinfo_cache_(NULL), shard_num_(1)
     {
 
     }
 
     ObBlockCache::ObBlockCache(IFileInfoMgr& fileinfo_cache) 
-    : inited_(false), fileinfo_cache_(&fileinfo_cache)
+    : inited_(false), fileinfo_cache_(&fileinfo_cache), shard_num_(1)
     {
     }
 
@@ -47,15 +49,30 @@ namespace oceanbase
       {
         TBSYS_LOG(INFO, "have inited");
       }
-      else if (OB_SUCCESS != kv_cache_.init(cache_mem_size))
-      {
-        TBSYS_LOG(WARN, "init kv cache fail");
-        ret = OB_ERROR;
-      }
       else
       {
-        inited_ = true;
-        TBSYS_LOG_US(DEBUG, "init blockcache succ cache_mem_size=%ld, ", cache_mem_size);
+        // each shard holds at least MIN_SHARD_MEM_SIZE memory, small cache isn't sharded
+        shard_num_ = cache_mem_size / MIN_SHARD_MEM_SIZE;
+        shard_num_ = (shard_num_ < 1) ? 1 : ((shard_num_ > MAX_SHARD_NUM) ? MAX_SHARD_NUM : shard_num_);
+        for (int64_t i = 0; i < shard_num_; ++i)
+        {
+          if (OB_SUCCESS != kv_caches_[i].init(cache_mem_size / shard_num_))
+          {
+            TBSYS_LOG(WARN, "init kv cache fail, shard=%ld", i);
+            for (int64_t j = 0; j < i; ++j)
+            {
+              kv_caches_[j].destroy();
+            }
+            ret = OB_ERROR;
+            break;
+          }
+        }
+        if (OB_SUCCESS == ret)
+        {
+          inited_ = true;
+          TBSYS_LOG(INFO, "init blockcache succ cache_mem_size=%ld, shard_num=%ld",
+                    cache_mem_size, shard_num_);
+        }
       }
 
       return ret;
@@ -70,13 +87,20 @@ namespace oceanbase
         TBSYS_LOG(INFO, "not inited");
         ret = OB_NOT_INIT;
       }
-      else if (OB_SUCCESS != (ret = kv_cache_.enlarge_total_size(cache_mem_size)))
-      {
-        TBSYS_LOG(WARN, "enlarge total block cache size of kv cache fail");
-      }
       else
       {
-        TBSYS_LOG(INFO, "success enlarge block cache size to %ld", cache_mem_size);
+        for (int64_t i = 0; i < shard_num_; ++i)
+        {
+          if (OB_SUCCESS != (ret = kv_caches_[i].enlarge_total_size(cache_mem_size / shard_num_)))
+          {
+            TBSYS_LOG(WARN, "enlarge total block cache size of kv cache fail, shard=%ld", i);
+            break;
+          }
+        }
+        if (OB_SUCCESS == ret)
+        {
+          TBSYS_LOG(INFO, "success enlarge block cache size to %ld", cache_mem_size);
+        }
       }
 
       return ret;
@@ -88,12 +112,15 @@ namespace oceanbase
 
       if (inited_)
       {
-        if (OB_SUCCESS != kv_cache_.destroy())
+        for (int64_t i = 0; i < shard_num_; ++i)
         {
-          TBSYS_LOG(WARN, "destroy cache fail");
-          ret = OB_ERROR;
+          if (OB_SUCCESS != kv_caches_[i].destroy())
+          {
+            TBSYS_LOG(WARN, "destroy cache fail, shard=%ld", i);
+            ret = OB_ERROR;
+          }
         }
-        else
+        if (OB_SUCCESS == ret)
         {
           inited_ = false;
           fileinfo_cache_ = NULL;
@@ -112,14 +139,16 @@ namespace oceanbase
         TBSYS_LOG(WARN, "have not inited");
         ret = OB_ERROR;
       }
-      else if (OB_SUCCESS != kv_cache_.clear())
-      {
-        TBSYS_LOG(WARN, "clear cache fail");
-        ret = OB_ERROR;
-      }
       else
       {
-        // do nothing
+        for (int64_t i = 0; i < shard_num_; ++i)
+        {
+          if (OB_SUCCESS != kv_caches_[i].clear())
+          {
+            TBSYS_LOG(WARN, "clear cache fail, shard=%ld", i);
+            ret = OB_ERROR;
+          }
+        }
       }
 
       return ret;
@@ -142,8 +171,23 @@ namespace oceanbase
       }
       else
       {
+        //the background read is throttled on the disk of the sstable by 
+        //ObFileReader, the foreground read is only accounted
+        const int64_t disk_no = static_cast<int64_t>(get_sstable_disk_no(sstable_id));
+        const ObIOClass io_class = ObIOScheduler::get_thread_io_class();
+        const int64_t begin_time = tbsys::CTimeUtil::getTime();
+        ObIOClassGuard io_guard(io_class, disk_no);
+        if (IO_CLASS_FOREGROUND == io_class)
+        {
+          ObIOScheduler::get_instance().begin_foreground_io(disk_no);
+        }
         ret = ObFileReader::read_record(fileinfo_cache, sstable_id, offset, 
                                         size, *file_buf);
+        if (IO_CLASS_FOREGROUND == io_class)
+        {
+          ObIOScheduler::get_instance().end_foreground_io(disk_no, 
+            tbsys::CTimeUtil::getTime() - begin_time);
+        }
         if (OB_SUCCESS == ret)
         {
           out_buffer = file_buf->get_buffer() + file_buf->get_base_pos();
@@ -183,10 +227,11 @@ namespace oceanbase
         data_index.sstable_id = sstable_id;
         data_index.offset = offset;
         data_index.size = nbyte;
+        KVCache &kv_cache = get_kv_cache(data_index);
 
-        if (OB_SUCCESS == kv_cache_.get(data_index, output_value, buffer_handle.handle_, false))
+        if (OB_SUCCESS == kv_cache.get(data_index, output_value, buffer_handle.handle_, false))
         {
-          buffer_handle.block_cache_ = this;
+          buffer_handle.kv_cache_ = &kv_cache;
           buffer_handle.buffer_ = output_value.buffer;
           ret = static_cast<int>(nbyte);
 #ifndef _SSTABLE_NO_STAT_
@@ -223,11 +268,11 @@ namespace oceanbase
             if (OB_SUCCESS == status)
             {
               //put and fetch block from block cache
-              status = kv_cache_.put_and_fetch(data_index, input_value, output_value, 
-                                               buffer_handle.handle_, false, false);
+              status = kv_cache.put_and_fetch(data_index, input_value, output_value, 
+                                              buffer_handle.handle_, false, false);
               if (OB_SUCCESS == status)
               {
-                buffer_handle.block_cache_ = this;
+                buffer_handle.kv_cache_ = &kv_cache;
                 buffer_handle.buffer_ = output_value.buffer;
                 ret = static_cast<int>(nbyte);
               }
@@ -280,10 +325,11 @@ namespace oceanbase
         data_index.offset = current_block.offset_;
         data_index.size = current_block.size_;
 
-        if (OB_SUCCESS == kv_cache_.get(data_index, output_value, buffer_handle.handle_, true))
+        KVCache &kv_cache = get_kv_cache(data_index);
+        if (OB_SUCCESS == kv_cache.get(data_index, output_value, buffer_handle.handle_, true))
         {
           // found in cache, continue search next block;
-          buffer_handle.block_cache_ = this;
+          buffer_handle.kv_cache_ = &kv_cache;
           buffer_handle.buffer_ = output_value.buffer;
           ret = static_cast<int>(data_index.size);
 #ifndef _SSTABLE_NO_STAT_
@@ -387,11 +433,11 @@ namespace oceanbase
 
               if (cursor == i)
               {
-                status = kv_cache_.put_and_fetch(data_index, input_value, 
+                status = kv_cache.put_and_fetch(data_index, input_value, 
                     output_value, buffer_handle.handle_, false, false);
                 if (OB_SUCCESS == status)
                 {
-                  buffer_handle.block_cache_ = this;
+                  buffer_handle.kv_cache_ = &kv_cache;
                   buffer_handle.buffer_ = output_value.buffer;
                   ret = static_cast<int>(data_index.size);
                 }
@@ -405,7 +451,8 @@ namespace oceanbase
               }
               else
               {
-                kv_cache_.put(data_index, input_value, false);
+                // the blocks read ahead may never be used, put them with low priority
+                get_kv_cache(data_index).put(data_index, input_value, false, true);
               }
               inner_offset += block_infos.position_info_[i].size_; 
             }
@@ -440,9 +487,10 @@ namespace oceanbase
         data_index.offset = offset;
         data_index.size = nbyte;
 
-        if (OB_SUCCESS == kv_cache_.get(data_index, value, buffer_handle.handle_, true))
+        KVCache &kv_cache = get_kv_cache(data_index);
+        if (OB_SUCCESS == kv_cache.get(data_index, value, buffer_handle.handle_, true))
         {
-          buffer_handle.block_cache_ = this;
+          buffer_handle.kv_cache_ = &kv_cache;
           buffer_handle.buffer_ = value.buffer;
           ret = static_cast<int32_t>(nbyte);
         }
@@ -454,7 +502,12 @@ namespace oceanbase
 
     const int64_t ObBlockCache::size() const
     {
-      return kv_cache_.size();
+      int64_t ret = 0;
+      for (int64_t i = 0; i < shard_num_; ++i)
+      {
+        ret += kv_caches_[i].size();
+      }
+      return ret;
     }
 
     ObAIOBufferMgr* ObBlockCache::get_aio_buf_mgr(const uint64_t sstable_id, 
@@ -592,14 +645,23 @@ namespace oceanbase
       }
       else
       {
+        // buffer handle remembers the shard in traversal
+        int64_t shard_idx = (NULL == buffer_handle.kv_cache_) ? 0 : buffer_handle.kv_cache_ - kv_caches_;
         while (OB_EAGAIN == ret)
         {
-          ret = kv_cache_.get_next(data_index, value, buffer_handle.handle_);
+          ret = kv_caches_[shard_idx].get_next(data_index, value, buffer_handle.handle_);
           if (OB_SUCCESS == ret)
           {
-            buffer_handle.block_cache_ = this;
+            buffer_handle.kv_cache_ = &kv_caches_[shard_idx];
             buffer_handle.buffer_ = value.buffer;
           }
+          else if (OB_ITER_END == ret && shard_idx + 1 < shard_num_)
+          {
+            // traverse the next shard with a new handle
+            buffer_handle.reset();
+            buffer_handle.kv_cache_ = &kv_caches_[++shard_idx];
+            ret = OB_EAGAIN;
+          }
           else if (OB_ITER_END == ret)
           {
             //complete traversal, do nothing
@@ -91,12 +91,22 @@ namespace oceanbase
   {
     class ObBufferHandle;
 
+    /**
+     * block cache is divided into several shards by the hash of block key,
+     * each shard is an independent kv cache with its own hash map, memblocks
+     * and wash out, so the worker threads don't contend on the same
+     * structures. the blocks read by sequential scans through aio buffer
+     * manager are put into the cache with low priority, they are washed
+     * out first unless they are got again.
+     */
     class ObBlockCache
     {
       friend class ObBufferHandle;
       static const int64_t KVCACHE_ITEM_SIZE = 16 * 1024;      //16K
       static const int64_t KVCACHE_BLOCK_SIZE = 1024 * 1024L;  //1M
       static const int64_t MAX_READ_AHEAD_SIZE = 1024 * 1024L; //1M
+      static const int64_t MAX_SHARD_NUM = 8;
+      static const int64_t MIN_SHARD_MEM_SIZE = 256 * 1024 * 1024L; //256M
 
     public:
       typedef common::KeyValueCache<ObDataIndexKey, BlockCacheValue, 
@@ -272,9 +282,17 @@ namespace oceanbase
         return *fileinfo_cache_;
       }
 
-      inline KVCache &get_kv_cache()
+      /**
+       * get the kv cache shard which the block belongs to
+       */
+      inline KVCache &get_kv_cache(const ObDataIndexKey &data_index)
+      {
+        return kv_caches_[static_cast<uint64_t>(data_index.hash()) % shard_num_];
+      }
+
+      inline int64_t get_shard_num() const
       {
-        return kv_cache_;
+        return shard_num_;
       }
 
     private:
@@ -292,7 +310,8 @@ namespace oceanbase
     private:
       bool inited_;
       common::IFileInfoMgr* fileinfo_cache_;
-      KVCache kv_cache_;
+      int64_t shard_num_;
+      KVCache kv_caches_[MAX_SHARD_NUM];
     };
 
     class ObBufferHandle
@@ -300,25 +319,26 @@ namespace oceanbase
       friend class ObBlockCache;
 
     public:
-      ObBufferHandle() : block_cache_(NULL), buffer_(NULL)
+      ObBufferHandle() : kv_cache_(NULL), buffer_(NULL)
       {
       };
 
-      explicit ObBufferHandle(const char* buffer) : block_cache_(NULL), buffer_(buffer)
+      explicit ObBufferHandle(const char* buffer) : kv_cache_(NULL), buffer_(buffer)
       {
       };
 
       ~ObBufferHandle()
       {
-        if (NULL != block_cache_)
+        if (NULL != kv_cache_)
         {
-          block_cache_->kv_cache_.revert(handle_);
+          kv_cache_->revert(handle_);
         }
-        block_cache_ = NULL;
+        kv_cache_ = NULL;
         buffer_ = NULL;
       };
 
       explicit ObBufferHandle(const ObBufferHandle &other)
+        : kv_cache_(NULL), buffer_(NULL)
       {
         *this = other;
       };
@@ -337,42 +357,42 @@ namespace oceanbase
 
       ObBufferHandle &operator = (const ObBufferHandle &other)
       {
-        ObBlockCache *blockcache_tmp = block_cache_;
+        ObBlockCache::KVCache *kvcache_tmp = kv_cache_;
         ObBlockCache::Handle handle_tmp = handle_;
 
-        if (NULL != other.block_cache_)
+        if (NULL != other.kv_cache_)
         {
-          if (common::OB_SUCCESS == other.block_cache_->kv_cache_.dup_handle(other.handle_, handle_))
+          if (common::OB_SUCCESS == other.kv_cache_->dup_handle(other.handle_, handle_))
           {
-            block_cache_ = other.block_cache_;
+            kv_cache_ = other.kv_cache_;
             buffer_ = other.buffer_;
           }
           else
           {
-            TBSYS_LOG(ERROR, "copy handle fail this_block_cache=%p this_buffer=%p "
-                             "other_block_cache=%p other_buffer=%p",
-                      block_cache_, buffer_, other.block_cache_, other.buffer_);
-            block_cache_ = NULL;
+            TBSYS_LOG(ERROR, "copy handle fail this_kv_cache=%p this_buffer=%p "
+                             "other_kv_cache=%p other_buffer=%p",
+                      kv_cache_, buffer_, other.kv_cache_, other.buffer_);
+            kv_cache_ = NULL;
             buffer_ = NULL;
           }
         }
         else
         {
-          block_cache_ = other.block_cache_;
+          kv_cache_ = other.kv_cache_;
           handle_ = other.handle_;
           buffer_ = other.buffer_;
         }
 
-        if (NULL != blockcache_tmp)
+        if (NULL != kvcache_tmp)
         {
-          blockcache_tmp->kv_cache_.revert(handle_tmp);
+          kvcache_tmp->revert(handle_tmp);
         }
         
         return *this;
       };
 
     private:
-      ObBlockCache *block_cache_;
+      ObBlockCache::KVCache *kv_cache_;  // the kv cache shard which handle_ belongs to
       ObBlockCache::Handle handle_;
       const char *buffer_;
     };
@@ -817,7 +817,7 @@ namespace oceanbase
       //create compressor
       if (NULL == compressor_ && strlen(compressor_name) > 0)
       {
-        compressor_ = create_compressor(compressor_name);
+        compressor_ = create_decompressor(compressor_name);
         if (NULL == compressor_)
         {
           TBSYS_LOG(ERROR, "Problem create compressor");
@@ -13,6 +13,7 @@
  */
 #include "ob_log_replay_worker.h"
 #include "ob_ups_log_utils.h"
+#include "ob_ups_stat.h"
 
 namespace oceanbase
 {
@@ -307,6 +308,7 @@ namespace oceanbase
       }
       else
       {
+        int64_t start_time_us = tbsys::CTimeUtil::getTime();
         while(!_stop && OB_SUCCESS == err_ && OB_EAGAIN == (err = replay(*task)))
           ;
         if (OB_SUCCESS != err && OB_EAGAIN != err)
@@ -314,6 +316,11 @@ namespace oceanbase
           err_ = err;
           TBSYS_LOG(ERROR, "replay()=>%d", err);
         }
+        else if (OB_SUCCESS == err)
+        {
+          OB_STAT_INC(UPDATESERVER, UPS_STAT_REPLAY_COUNT, 1);
+          OB_STAT_INC(UPDATESERVER, UPS_STAT_REPLAY_TIMEU, tbsys::CTimeUtil::getTime() - start_time_us);
+        }
         while(!_stop && OB_SUCCESS == err_ && OB_EAGAIN == (err = commit_queue_.add(task->log_id_, (void*)task)))
           ;
         if (OB_SUCCESS != err && OB_EAGAIN != err)
@@ -388,10 +395,72 @@ namespace oceanbase
       return err;
     }
 
-    static int is_barrier_log(bool& is_barrier, const LogCommand cmd, const char* buf, const int64_t len)
+    // 取mutator中第一行的(table_id, rowkey)的hash作为分发apply线程的依据，
+    // 只解析到第一个rowkey为止；遇到不认识的格式(如按表名/二进制rowkey序列化)返回0，由调用者轮流分发
+    static int get_first_row_sign(uint64_t& sign, const char* buf, const int64_t len, int64_t pos)
+    {
+      int err = OB_SUCCESS;
+      ObObj obj;
+      int64_t ext_val = 0;
+      int64_t table_id = OB_INVALID_ID;
+      bool end_flag = false;
+      sign = 0;
+      while (OB_SUCCESS == err && !end_flag && pos < len)
+      {
+        if (OB_SUCCESS != (err = obj.deserialize(buf, len, pos)))
+        {
+          TBSYS_LOG(ERROR, "obj.deserialize(buf=%p[%ld], pos=%ld)=>%d", buf, len, pos, err);
+        }
+        else if (ObExtendType != obj.get_type())
+        {
+          end_flag = true;
+        }
+        else if (OB_SUCCESS != (err = obj.get_ext(ext_val)))
+        {
+          TBSYS_LOG(ERROR, "obj.get_ext()=>%d", err);
+        }
+        else if (ObActionFlag::MUTATOR_PARAM_FIELD == ext_val)
+        {}
+        else if (ObActionFlag::MUTATOR_TYPE_FIELD == ext_val
+                 || ObActionFlag::OBDB_SEMANTIC_FIELD == ext_val)
+        {
+          err = obj.deserialize(buf, len, pos);
+        }
+        else if (ObActionFlag::TABLE_NAME_FIELD == ext_val)
+        {
+          if (OB_SUCCESS == (err = obj.deserialize(buf, len, pos))
+              && OB_SUCCESS != obj.get_int(table_id))
+          {
+            end_flag = true;
+          }
+        }
+        else if (ObActionFlag::FORMED_ROW_KEY_FIELD == ext_val && OB_INVALID_ID != (uint64_t)table_id)
+        {
+          ObObj rowkey_objs[OB_MAX_ROWKEY_COLUMN_NUMBER];
+          ObRowkey rowkey(rowkey_objs, OB_MAX_ROWKEY_COLUMN_NUMBER);
+          if (OB_SUCCESS != (err = rowkey.deserialize(buf, len, pos)))
+          {
+            TBSYS_LOG(ERROR, "rowkey.deserialize(buf=%p[%ld], pos=%ld)=>%d", buf, len, pos, err);
+          }
+          else
+          {
+            sign = rowkey.murmurhash2(static_cast<uint32_t>(table_id));
+          }
+          end_flag = true;
+        }
+        else
+        {
+          end_flag = true;
+        }
+      }
+      return err;
+    }
+
+    static int parse_log_for_dispatch(bool& is_barrier, uint64_t& sign, const LogCommand cmd, const char* buf, const int64_t len)
     {
       int err = OB_SUCCESS;
       is_barrier = true;
+      sign = 0;
       if (NULL == buf || 0 >= len)
       {
         err = OB_INVALID_ARGUMENT;
@@ -411,6 +480,10 @@ namespace oceanbase
         else if (mutator.is_normal_mutator())
         {
           is_barrier = false;
+          if (OB_SUCCESS != get_first_row_sign(sign, buf, len, pos))
+          {
+            sign = 0;
+          }
         }
       }
       return err;
@@ -427,6 +500,7 @@ namespace oceanbase
       int64_t new_pos = pos;
       bool check_integrity = true;
       bool is_barrier = true;
+      uint64_t sign = 0;
       //TBSYS_LOG(INFO, "submit(task.log_id[%ld], next_submit_log_id[%ld], next_commit_log_id[%ld])", task.log_id_, next_submit_log_id_, next_commit_log_id_);
       if (_stop)
       {
@@ -465,10 +539,10 @@ namespace oceanbase
                   next_commit_log_id_, flying_trans_no_limit_, task.log_entry_.seq_);
 
       }
-      else if (OB_SUCCESS != (err = is_barrier_log(is_barrier, (LogCommand)task.log_entry_.cmd_,
-                                                   buf + new_pos, task.log_entry_.get_log_data_len())))
+      else if (OB_SUCCESS != (err = parse_log_for_dispatch(is_barrier, sign, (LogCommand)task.log_entry_.cmd_,
+                                                           buf + new_pos, task.log_entry_.get_log_data_len())))
       {
-        TBSYS_LOG(ERROR, "is_barrier_log()=>%d", err);
+        TBSYS_LOG(ERROR, "parse_log_for_dispatch()=>%d", err);
       }
       else
       {
@@ -491,7 +565,8 @@ namespace oceanbase
         task.profile_.enable_ = (TraceLog::get_log_level() <= TBSYS_LOG_LEVEL_INFO);
 
         log_applier_->on_submit(task);
-        if (OB_SUCCESS != (err = apply_worker_.push(&task))
+        // 修改同一行的日志总是由同一个apply线程按日志顺序回放，避免不同线程之间的行锁冲突
+        if (OB_SUCCESS != (err = apply_worker_.push(&task, sign))
             && OB_EAGAIN != err)
         {
           TBSYS_LOG(ERROR, "queue_.push(log_id=%ld)=>%d", log_id, err);
@@ -30,6 +30,8 @@ namespace oceanbase
     using namespace hash;
 
     MemTable::MemTable() : inited_(false), mem_tank_(), table_engine_(mem_tank_), table_bf_(),
+                           frozen_bf_(), frozen_bf_stat_(FROZEN_BF_NONE), hot_row_queue_(),
+                           hot_row_cell_num_(0),
                            version_(0), ref_cnt_(0),
                            checksum_before_mutate_(0), checksum_after_mutate_(0),
                            checksum_(0),
@@ -75,6 +77,13 @@ namespace oceanbase
         table_bf_.destroy();
         TBSYS_LOG(WARN, "init trans mgr fail ret=%d", ret);
       }
+      else if (OB_SUCCESS != (ret = hot_row_queue_.init(HOT_ROW_QUEUE_SIZE)))
+      {
+        table_engine_.destroy();
+        table_bf_.destroy();
+        trans_mgr_.destroy();
+        TBSYS_LOG(WARN, "init hot row queue fail ret=%d", ret);
+      }
       else
       {
         inited_ = true;
@@ -98,6 +107,9 @@ namespace oceanbase
         checksum_ = 0;
         uncommited_checksum_ = 0;
         table_bf_.destroy();
+        frozen_bf_stat_ = FROZEN_BF_NONE;
+        frozen_bf_.destroy();
+        hot_row_queue_.destroy();
         table_engine_.destroy();
         mem_tank_.clear();
         inited_ = false;
@@ -115,6 +127,13 @@ namespace oceanbase
       else
       {
         row_counter_ = 0;
+        frozen_bf_stat_ = FROZEN_BF_NONE;
+        frozen_bf_.destroy();
+        HotRow *hot_row = NULL;
+        while (OB_SUCCESS == hot_row_queue_.pop(hot_row))
+        {
+          // 队列中的行随table engine一起清掉
+        }
         ret = table_engine_.clear();
       }
       return ret;
@@ -530,6 +549,7 @@ namespace oceanbase
               ccw.row_finish();
               ret = copy_cells_(*cur_uci, ccw);
               ccw.reset();
+              add_hot_row_(cur_key, *cur_value);
             }
             if (OB_SUCCESS == ret
                 && !session.get_is_replaying()
@@ -658,16 +678,173 @@ namespace oceanbase
     {
       int ret = OB_SUCCESS;
       int64_t timeu = tbsys::CTimeUtil::getTime();
-
       TEValue new_value;
+      BaseSessionCtx merge_session(session.get_type(), session.get_host());
+      merge_session.set_trans_id(session.get_min_flying_trans_id());
+      if (OB_SUCCESS == (ret = compact_value_(merge_session, te_key, te_value, new_value))
+          && NULL != new_value.list_head)
+      {
+        // change te_value to new_value
+        te_value = new_value;
+        timeu = tbsys::CTimeUtil::getTime() - timeu;
+        OB_STAT_INC(UPDATESERVER, UPS_STAT_MERGE_COUNT, 1);
+        OB_STAT_INC(UPDATESERVER, UPS_STAT_MERGE_TIMEU, timeu);
+      }
+      return ret;
+    }
+
+    void MemTable::add_hot_row_(const TEKey &te_key, TEValue &te_value)
+    {
+      // cell_info_cnt只包含已提交的cell
+      int64_t cell_num = te_value.cell_info_cnt;
+      if (4 >= cell_num)
+      {
+        OB_STAT_INC(MEMTABLE, UPS_STAT_ROW_CELL_NUM_LE_4, 1);
+      }
+      else if (16 >= cell_num)
+      {
+        OB_STAT_INC(MEMTABLE, UPS_STAT_ROW_CELL_NUM_LE_16, 1);
+      }
+      else if (64 >= cell_num)
+      {
+        OB_STAT_INC(MEMTABLE, UPS_STAT_ROW_CELL_NUM_LE_64, 1);
+      }
+      else if (256 >= cell_num)
+      {
+        OB_STAT_INC(MEMTABLE, UPS_STAT_ROW_CELL_NUM_LE_256, 1);
+      }
+      else
+      {
+        OB_STAT_INC(MEMTABLE, UPS_STAT_ROW_CELL_NUM_GT_256, 1);
+      }
+
+      int64_t hot_row_cell_num = hot_row_cell_num_;
+      if (0 < hot_row_cell_num
+          && hot_row_cell_num < cell_num
+          && HST_NONE == te_value.hot_stat
+          && __sync_bool_compare_and_swap(&te_value.hot_stat, HST_NONE, HST_QUEUED))
+      {
+        HotRow *hot_row = (HotRow*)mem_tank_.node_alloc(sizeof(HotRow));
+        if (NULL == hot_row)
+        {
+          te_value.hot_stat = HST_NONE;
+        }
+        else
+        {
+          hot_row->table_id = te_key.table_id;
+          hot_row->value = &te_value;
+          if (OB_SUCCESS != hot_row_queue_.push(hot_row))
+          {
+            // 队列满了就不合并这一行, 下次写入时再尝试
+            te_value.hot_stat = HST_NONE;
+          }
+        }
+      }
+    }
+
+    int MemTable::compact_hot_rows(SessionMgr &session_mgr, int64_t &compacted_row_num)
+    {
+      int ret = OB_SUCCESS;
+      compacted_row_num = 0;
+      int64_t row_num = 0;
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (0 < (row_num = hot_row_queue_.get_total()))
+      {
+        row_num = (row_num > MAX_COMPACT_HOT_ROW_NUM_PER_TASK) ? MAX_COMPACT_HOT_ROW_NUM_PER_TASK : row_num;
+        // 小于等于min flying trans id的版本已经对所有事务可见, 可以合并成一个节点
+        session_mgr.flush_min_flying_trans_id();
+        BaseSessionCtx merge_session(ST_READ_ONLY, session_mgr);
+        merge_session.set_trans_id(session_mgr.get_min_flying_trans_id());
+        int64_t timeu = tbsys::CTimeUtil::getTime();
+        HotRow *hot_row = NULL;
+        // 只处理开始时已经在队列中的行且不超过上限, 加锁失败放回队列的行留到下一次
+        for (int64_t i = 0; i < row_num && OB_SUCCESS == hot_row_queue_.pop(hot_row); i++)
+        {
+          bool compacted = false;
+          int tmp_ret = compact_hot_row_(merge_session, *hot_row, compacted);
+          if (OB_EAGAIN == tmp_ret)
+          {
+            if (OB_SUCCESS != hot_row_queue_.push(hot_row))
+            {
+              hot_row->value->hot_stat = HST_NONE;
+            }
+          }
+          else if (compacted)
+          {
+            compacted_row_num++;
+          }
+        }
+        timeu = tbsys::CTimeUtil::getTime() - timeu;
+        OB_STAT_INC(MEMTABLE, UPS_STAT_HOT_ROW_COMPACT_COUNT, compacted_row_num);
+        OB_STAT_INC(MEMTABLE, UPS_STAT_HOT_ROW_COMPACT_TIMEU, timeu);
+        TBSYS_LOG(DEBUG, "compact hot rows row_num=%ld compacted_row_num=%ld min_flying_trans_id=%ld timeu=%ld",
+                  row_num, compacted_row_num, merge_session.get_trans_id(), timeu);
+      }
+      return ret;
+    }
+
+    int MemTable::compact_hot_row_(const BaseSessionCtx &merge_session, const HotRow &hot_row, bool &compacted)
+    {
+      int ret = OB_SUCCESS;
+      TEValue &te_value = *hot_row.value;
+      compacted = false;
+      // 和写事务互斥, 行上有未提交或者正在提交的数据时不合并
+      if (OB_SUCCESS != (ret = te_value.row_lock.try_exclusive_lock(HOT_ROW_COMPACT_LOCK_UID)))
+      {
+        ret = OB_EAGAIN;
+      }
+      else
+      {
+        if (NULL == te_value.cur_uc_info
+            && hot_row_cell_num_ < te_value.cell_info_cnt)
+        {
+          TEKey te_key;
+          te_key.table_id = hot_row.table_id;
+          TEValue new_value;
+          int tmp_ret = compact_value_(merge_session, te_key, te_value, new_value);
+          if (OB_SUCCESS == tmp_ret
+              && NULL != new_value.list_head)
+          {
+            // 读请求只从list_head开始遍历, 不能整体覆盖te_value(会覆盖row_lock)
+            // 先准备好list_tail, 最后切换list_head
+            te_value.list_tail = new_value.list_tail;
+            te_value.cell_info_cnt = new_value.cell_info_cnt;
+            te_value.cell_info_size = new_value.cell_info_size;
+            __sync_synchronize();
+            te_value.list_head = new_value.list_head;
+            compacted = true;
+          }
+          else if (OB_SUCCESS != tmp_ret
+                  && OB_EAGAIN != tmp_ret)
+          {
+            TBSYS_LOG(WARN, "compact hot row fail ret=%d table_id=%lu %s",
+                      tmp_ret, hot_row.table_id, te_value.log_str());
+          }
+        }
+        te_value.hot_stat = HST_NONE;
+        te_value.row_lock.try_exclusive_unlock(HOT_ROW_COMPACT_LOCK_UID);
+      }
+      return ret;
+    }
+
+    int MemTable::compact_value_(const BaseSessionCtx &merge_session,
+                                const TEKey &te_key,
+                                const TEValue &te_value,
+                                TEValue &new_value)
+    {
+      int ret = OB_SUCCESS;
+      int64_t timeu = tbsys::CTimeUtil::getTime();
+
       new_value.reset();
       new_value.index_stat = te_value.index_stat;
       new_value.cur_uc_info = te_value.cur_uc_info;
       new_value.row_lock = te_value.row_lock;
 
       MemTableGetIter get_iter;
-      BaseSessionCtx merge_session(session.get_type(), session.get_host());
-      merge_session.set_trans_id(session.get_min_flying_trans_id());
       get_iter.set_(te_key, &te_value, NULL, false, &merge_session);
       ObRowCompaction *rc_iter = GET_TSI_MULT(ObRowCompaction, TSI_UPS_ROW_COMPACTION_1);
       FixedSizeBuffer<OB_MAX_PACKET_LENGTH> *tbuf = GET_TSI_MULT(FixedSizeBuffer<OB_MAX_PACKET_LENGTH>, TSI_UPS_FIXED_SIZE_BUFFER_2);
@@ -786,14 +963,7 @@ namespace oceanbase
         TBSYS_LOG(DEBUG, "merge te_value succ, key-value: [%s] [%s] ==> [%s] value=%p timeu=%ld",
                   te_key.log_str(), te_value.log_str(), new_value.log_str(), &te_value, timeu);
         TBSYS_LOG(DEBUG, "merge te_value succ, list: [%s] ==> [%s] value=%p timeu=%ld",
-                  te_value.log_list(), new_value.log_list(), &te_value, timeu);
-        if (NULL != new_value.list_head)
-        {
-          // change te_value to new_value
-          te_value = new_value;
-          OB_STAT_INC(UPDATESERVER, UPS_STAT_MERGE_COUNT, 1);
-          OB_STAT_INC(UPDATESERVER, UPS_STAT_MERGE_TIMEU, timeu);
-        }
+                  const_cast<TEValue&>(te_value).log_list(), new_value.log_list(), &te_value, timeu);
       }
       return ret;
     }
@@ -1444,8 +1614,9 @@ namespace oceanbase
       }
       if (OB_SUCCESS == ret && NULL == value)
       {
-        if (using_memtable_bloomfilter()
-            && !table_bf_.contain(table_id, row_key))
+        if (frozen_bf_not_contain_(table_id, row_key)
+            || (using_memtable_bloomfilter()
+                && !table_bf_.contain(table_id, row_key)))
         {} // 保持value=NULL, iterator迭代时可以处理
         else
         {
@@ -1485,8 +1656,9 @@ namespace oceanbase
         TBSYS_LOG(WARN, "get trans node fail td=%lu", td);
         ret = OB_ERROR;
       }
-      else if (using_memtable_bloomfilter()
-              && !table_bf_.contain(table_id, row_key))
+      else if (frozen_bf_not_contain_(table_id, row_key)
+              || (using_memtable_bloomfilter()
+                  && !table_bf_.contain(table_id, row_key)))
       {
         iterator.get_get_iter_().set_(key, NULL, column_filter, tn);
       }
@@ -1708,6 +1880,69 @@ namespace oceanbase
       return table_bf.deep_copy(table_bf_);
     }
 
+    int MemTable::build_frozen_bloomfilter()
+    {
+      int ret = OB_SUCCESS;
+      int64_t nbyte = size() * FROZEN_BLOOM_FILTER_BITS_PER_ROW / CHAR_BIT + 1;
+      TableEngineIterator iter;
+      int64_t row_count = 0;
+      int64_t start_time = tbsys::CTimeUtil::getTime();
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (!__sync_bool_compare_and_swap(&frozen_bf_stat_, FROZEN_BF_NONE, FROZEN_BF_BUILDING))
+      {
+        TBSYS_LOG(INFO, "frozen bloomfilter is building or built, stat=%ld", frozen_bf_stat_);
+      }
+      else
+      {
+        if (FROZEN_BLOOM_FILTER_MAX_NBYTE < nbyte)
+        {
+          nbyte = FROZEN_BLOOM_FILTER_MAX_NBYTE;
+        }
+        if (OB_SUCCESS != (ret = frozen_bf_.init(FROZEN_BLOOM_FILTER_NHASH, nbyte)))
+        {
+          TBSYS_LOG(WARN, "init frozen bloomfilter fail ret=%d nbyte=%ld", ret, nbyte);
+        }
+        else if (OB_SUCCESS != (ret = scan_all(iter)))
+        {
+          TBSYS_LOG(WARN, "scan all fail ret=%d", ret);
+        }
+        else
+        {
+          while (OB_SUCCESS == ret
+                && OB_SUCCESS == (ret = iter.next()))
+          {
+            const TEKey &key = iter.get_key();
+            if (OB_SUCCESS != (ret = frozen_bf_.insert(key.table_id, key.row_key)))
+            {
+              TBSYS_LOG(WARN, "insert frozen bloomfilter fail ret=%d %s", ret, key.log_str());
+            }
+            else
+            {
+              row_count++;
+            }
+          }
+          ret = (OB_ITER_END == ret) ? OB_SUCCESS : ret;
+        }
+        if (OB_SUCCESS == ret)
+        {
+          __sync_synchronize();
+          frozen_bf_stat_ = FROZEN_BF_READY;
+          TBSYS_LOG(INFO, "build frozen bloomfilter succ row_count=%ld nbyte=%ld timeu=%ld",
+                    row_count, nbyte, tbsys::CTimeUtil::getTime() - start_time);
+        }
+        else
+        {
+          frozen_bf_.destroy();
+          frozen_bf_stat_ = FROZEN_BF_NONE;
+        }
+      }
+      return ret;
+    }
+
     int MemTable::scan_all(TableEngineIterator &iter)
     {
       int ret = OB_SUCCESS;
@@ -39,6 +39,7 @@
 #include "common/ob_cell_meta.h"
 #include "common/ob_column_filter.h"
 #include "common/ob_cellinfo_processor.h"
+#include "common/ob_fixed_queue.h"
 #include "sql/ob_husk_phy_operator.h"
 #include "ob_table_engine.h"
 #include "ob_ups_mutator.h"
@@ -206,10 +207,12 @@ namespace oceanbase
       //int64_t drop_page_num_once;
       //int64_t drop_sleep_interval_us;
       IExternMemTotal *extern_mem_total;
+      int64_t hot_row_cell_num;
       MemTableAttr() : total_memlimit(0),
                        //drop_page_num_once(0),
                        //drop_sleep_interval_us(0),
-                       extern_mem_total(NULL)
+                       extern_mem_total(NULL),
+                       hot_row_cell_num(0)
       {
       };
     };
@@ -233,7 +236,24 @@ namespace oceanbase
       static const int64_t MAX_ROW_SIZE = common::OB_MAX_ROW_LENGTH / CELL_INFO_SIZE_UNIT;
       static const int64_t BLOOM_FILTER_NHASH = 1;
       static const int64_t BLOOM_FILTER_NBYTE = common::OB_MAX_PACKET_LENGTH - 1 * 1024;
+      static const int64_t FROZEN_BLOOM_FILTER_NHASH = 3;
+      static const int64_t FROZEN_BLOOM_FILTER_BITS_PER_ROW = 10;
+      static const int64_t FROZEN_BLOOM_FILTER_MAX_NBYTE = 256L * 1024L * 1024L;
       static const int64_t MAX_TRANS_NUM = 64;
+      static const int64_t HOT_ROW_QUEUE_SIZE = 64L * 1024L;
+      static const int64_t MAX_COMPACT_HOT_ROW_NUM_PER_TASK = 1024; // 每次合并任务最多处理的行数, 避免长时间占用写线程
+      static const uint32_t HOT_ROW_COMPACT_LOCK_UID = static_cast<uint32_t>(common::QLock::UID_MASK); // session descriptor不会用到的uid
+      struct HotRow
+      {
+        uint64_t table_id;
+        TEValue *value;
+      };
+      enum FrozenBloomFilterStat
+      {
+        FROZEN_BF_NONE = 0,
+        FROZEN_BF_BUILDING = 1,
+        FROZEN_BF_READY = 2,
+      };
       public:
         MemTable();
         ~MemTable();
@@ -332,12 +352,14 @@ namespace oceanbase
         {
           mem_tank_.set_total_limit(attr.total_memlimit);
           mem_tank_.set_extern_mem_total(attr.extern_mem_total);
+          hot_row_cell_num_ = attr.hot_row_cell_num;
         };
 
         inline void get_attr(MemTableAttr &attr)
         {
           attr.total_memlimit = mem_tank_.get_total_limit();
           attr.extern_mem_total = mem_tank_.get_extern_mem_total();
+          attr.hot_row_cell_num = hot_row_cell_num_;
         };
 
         inline void log_memory_info() const
@@ -454,8 +476,24 @@ namespace oceanbase
 
         int get_bloomfilter(common::TableBloomFilter &table_bf) const;
 
+        // 冻结后内存表不再修改, 扫描全表按行数建立rowkey的bloomfilter, 建好之后get不存在的行时直接返回
+        // 活跃表上的table_bf_只有固定大小并且并发插入时可能丢失bit, 不能用来判断冻结表
+        // @note 只能在内存表冻结之后调用
+        int build_frozen_bloomfilter();
+        inline bool need_build_frozen_bloomfilter() const
+        {
+          return FROZEN_BF_NONE == frozen_bf_stat_;
+        };
+
         int scan_all(TableEngineIterator &iter);
 
+        // 写入时cell个数超过hot_row_cell_num的行会加入热点行队列, 由后台把链表上
+        // 所有事务都已经能看到的版本合并成一个节点, 减少热点行读取时遍历的节点数
+        // 写路径上超过max_row_cell_num的合并仍然保留, 作为后台来不及合并时的兜底
+        // 每次最多处理MAX_COMPACT_HOT_ROW_NUM_PER_TASK行, 剩下的留给下一次任务
+        // @param [out] compacted_row_num 本次合并的行数
+        int compact_hot_rows(SessionMgr &session_mgr, int64_t &compacted_row_num);
+
       private:
         inline int copy_cells_(TransNode &tn,
                               TEValue &value,
@@ -524,6 +562,12 @@ namespace oceanbase
         inline int merge_(RWSessionCtx &session,
                           const TEKey &te_key,
                           TEValue &te_value);
+        int compact_value_(const BaseSessionCtx &merge_session,
+                          const TEKey &te_key,
+                          const TEValue &te_value,
+                          TEValue &new_value);
+        inline void add_hot_row_(const TEKey &te_key, TEValue &te_value);
+        int compact_hot_row_(const BaseSessionCtx &merge_session, const HotRow &hot_row, bool &compacted);
 
         inline static bool is_row_too_long_(const RWSessionCtx &session, const TEKey &te_key, const TEValue &te_value);
         inline static int16_t get_varchar_length_kb_(const common::ObObj &value)
@@ -591,11 +635,21 @@ namespace oceanbase
         };
 
         void handle_checksum_error(ObUpsMutator &mutator);
+        inline bool frozen_bf_not_contain_(const uint64_t table_id, const common::ObRowkey &row_key) const
+        {
+          return FROZEN_BF_READY == frozen_bf_stat_
+                && !frozen_bf_.contain(table_id, row_key);
+        };
       private:
         bool inited_;
         MemTank mem_tank_;
         TableEngine table_engine_;
         common::TableBloomFilter table_bf_;
+        common::TableBloomFilter frozen_bf_;
+        volatile int64_t frozen_bf_stat_;
+        common::ObFixedQueue<HotRow> hot_row_queue_;
+        // 配置项hot_row_cell_num的缓存, 配置变化时由set_attr更新, 避免每次写行都去读配置
+        int64_t hot_row_cell_num_;
 
         int64_t version_;
         int64_t ref_cnt_;
@@ -35,18 +35,26 @@ namespace oceanbase
     MemTableRowIterator::MemTableRowIterator() : memtable_(NULL),
                                                  memtable_iter_(),
                                                  get_iter_(),
-                                                 rc_iter_()
+                                                 rc_iter_(),
+                                                 thread_num_(0),
+                                                 ranges_(NULL),
+                                                 range_num_(0)
     {
+      pthread_mutex_init(&mutex_, NULL);
+      pthread_cond_init(&cond_, NULL);
       reset_();
     }
 
     MemTableRowIterator::~MemTableRowIterator()
     {
       destroy();
+      pthread_cond_destroy(&cond_);
+      pthread_mutex_destroy(&mutex_);
     }
 
     int MemTableRowIterator::init(MemTable *memtable, const char *compressor_name,
-                                  const int64_t block_size, const int store_type)
+                                  const int64_t block_size, const int store_type,
+                                  const int64_t encode_thread_num)
     {
       int ret = OB_SUCCESS;
       if (NULL != memtable_)
@@ -75,6 +83,8 @@ namespace oceanbase
       {
         block_size_ = block_size;
         store_type_ = store_type;
+        encode_thread_num_ = (1 > encode_thread_num) ? 1 : encode_thread_num;
+        encode_thread_num_ = (MAX_ENCODE_THREAD_NUM < encode_thread_num_) ? MAX_ENCODE_THREAD_NUM : encode_thread_num_;
         memtable_ = memtable;
       }
       return ret;
@@ -82,6 +92,17 @@ namespace oceanbase
 
     void MemTableRowIterator::destroy()
     {
+      stop_encoders_();
+      if (NULL != ranges_)
+      {
+        for (int64_t i = 0; i < range_num_; i++)
+        {
+          ranges_[i].~EncodeRange();
+        }
+        ob_free(ranges_, ObModIds::OB_UPS_SSTABLE_MGR);
+        ranges_ = NULL;
+        range_num_ = 0;
+      }
       if (NULL != memtable_)
       {
         memtable_iter_.reset();
@@ -97,6 +118,12 @@ namespace oceanbase
       block_size_ = 0;
       store_type_ = 0;
       memset(compressor_name_, 0, sizeof(compressor_name_));
+      encode_thread_num_ = 1;
+      stop_ = false;
+      cut_end_ = false;
+      cut_seq_ = 0;
+      consume_seq_ = 0;
+      consume_row_ = -1;
     }
 
     void MemTableRowIterator::revert_schema_handle_()
@@ -132,6 +159,7 @@ namespace oceanbase
       else
       {
         TBSYS_LOG(INFO, "reset row_iter this=%p", this);
+        stop_encoders_();
         memtable_iter_.reset();
         ret = memtable_->scan_all(memtable_iter_);
       }
@@ -146,6 +174,11 @@ namespace oceanbase
         TBSYS_LOG(WARN, "have not inited this=%p", this);
         ret = OB_NOT_INIT;
       }
+      else if (1 < encode_thread_num_
+               && (0 < thread_num_ || OB_SUCCESS == start_encoders_()))
+      {
+        ret = next_encoded_row_();
+      }
       else
       {
         ret = memtable_iter_.next();
@@ -156,20 +189,24 @@ namespace oceanbase
     int MemTableRowIterator::get_row(sstable::ObSSTableRow &sstable_row)
     {
       int ret = OB_SUCCESS;
-      const TEKey key = memtable_iter_.get_key();
-      const TEValue *pvalue = memtable_iter_.get_value();
       if (NULL == memtable_)
       {
         TBSYS_LOG(WARN, "have not inited this=%p", this);
         ret = OB_NOT_INIT;
       }
-      else if (NULL == pvalue)
+      else if (0 < thread_num_)
+      {
+        ret = get_encoded_row_(sstable_row);
+      }
+      else if (NULL == memtable_iter_.get_value())
       {
         TBSYS_LOG(WARN, "value null pointer");
         ret = OB_ERROR;
       }
       else
       {
+        const TEKey key = memtable_iter_.get_key();
+        const TEValue *pvalue = memtable_iter_.get_value();
         sstable_row.clear();
         if (OB_SUCCESS != (ret = sstable_row.set_internal_rowkey(key.table_id, key.row_key)))
         {
@@ -206,6 +243,264 @@ namespace oceanbase
       return ret;
     }
 
+    int MemTableRowIterator::start_encoders_()
+    {
+      int ret = OB_SUCCESS;
+      const int64_t range_num = 2 * encode_thread_num_;
+      if (NULL == ranges_)
+      {
+        void *buf = ob_malloc(range_num * sizeof(EncodeRange), ObModIds::OB_UPS_SSTABLE_MGR);
+        if (NULL == buf)
+        {
+          TBSYS_LOG(WARN, "alloc encode ranges fail num=%ld", range_num);
+          ret = OB_MEM_OVERFLOW;
+        }
+        else
+        {
+          ranges_ = new(buf) EncodeRange[range_num];
+          range_num_ = range_num;
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        for (int64_t i = 0; i < range_num_; i++)
+        {
+          ranges_[i].stat = RANGE_FREE;
+          ranges_[i].err = OB_SUCCESS;
+          ranges_[i].row_num = 0;
+        }
+        stop_ = false;
+        cut_end_ = false;
+        cut_seq_ = 0;
+        consume_seq_ = 0;
+        consume_row_ = -1;
+        for (int64_t i = 0; i < encode_thread_num_; i++)
+        {
+          int tmp_ret = pthread_create(&threads_[thread_num_], NULL, encode_thread_func_, this);
+          if (0 != tmp_ret)
+          {
+            TBSYS_LOG(WARN, "pthread_create fail, ret=%d", tmp_ret);
+            break;
+          }
+          thread_num_++;
+        }
+        if (0 == thread_num_)
+        {
+          // 一个线程都没有起来时由dump线程自己读
+          TBSYS_LOG(WARN, "no encode thread started, read memtable rows in the dump thread");
+          encode_thread_num_ = 1;
+          ret = OB_ERROR;
+        }
+        else
+        {
+          TBSYS_LOG(INFO, "start %ld memtable row encode threads", thread_num_);
+        }
+      }
+      return ret;
+    }
+
+    void MemTableRowIterator::stop_encoders_()
+    {
+      if (0 < thread_num_)
+      {
+        pthread_mutex_lock(&mutex_);
+        stop_ = true;
+        pthread_cond_broadcast(&cond_);
+        pthread_mutex_unlock(&mutex_);
+        for (int64_t i = 0; i < thread_num_; i++)
+        {
+          pthread_join(threads_[i], NULL);
+        }
+        thread_num_ = 0;
+      }
+    }
+
+    int MemTableRowIterator::next_encoded_row_()
+    {
+      int ret = OB_SUCCESS;
+      pthread_mutex_lock(&mutex_);
+      while (OB_SUCCESS == ret)
+      {
+        EncodeRange &range = ranges_[consume_seq_ % range_num_];
+        if (RANGE_READY != range.stat)
+        {
+          if (cut_end_ && consume_seq_ == cut_seq_)
+          {
+            ret = OB_ITER_END;
+          }
+          else
+          {
+            pthread_cond_wait(&cond_, &mutex_);
+          }
+        }
+        else if (OB_SUCCESS != range.err)
+        {
+          ret = range.err;
+        }
+        else if (++consume_row_ < range.row_num)
+        {
+          break;
+        }
+        else
+        {
+          // 当前range消费完了，交还给encode线程
+          range.stat = RANGE_FREE;
+          consume_seq_++;
+          consume_row_ = -1;
+          pthread_cond_broadcast(&cond_);
+        }
+      }
+      pthread_mutex_unlock(&mutex_);
+      return ret;
+    }
+
+    int MemTableRowIterator::get_encoded_row_(sstable::ObSSTableRow &sstable_row)
+    {
+      int ret = OB_SUCCESS;
+      const EncodeRange &range = ranges_[consume_seq_ % range_num_];
+      if (RANGE_READY != range.stat
+          || 0 > consume_row_
+          || range.row_num <= consume_row_)
+      {
+        TBSYS_LOG(WARN, "no encoded row to get, consume_seq=%ld consume_row=%ld", consume_seq_, consume_row_);
+        ret = OB_ERROR;
+      }
+      else
+      {
+        const TEKey &key = range.keys[consume_row_];
+        sstable_row.clear();
+        if (OB_SUCCESS != (ret = sstable_row.set_internal_rowkey(key.table_id, key.row_key)))
+        {
+          TBSYS_LOG(WARN, "set internal rowkey to sstable_row fail key=[%s]", key.log_str());
+        }
+        for (int64_t i = (0 == consume_row_) ? 0 : range.row_end[consume_row_ - 1];
+             OB_SUCCESS == ret && i < range.row_end[consume_row_];
+             i++)
+        {
+          if (OB_SUCCESS != (ret = sstable_row.shallow_add_obj(range.objs.at(i), range.column_ids.at(i))))
+          {
+            TBSYS_LOG(WARN, "add obj to sstable_row fail ret=%d key=[%s]", ret, key.log_str());
+          }
+        }
+      }
+      return ret;
+    }
+
+    int MemTableRowIterator::cut_range_(EncodeRange &range)
+    {
+      int ret = OB_SUCCESS;
+      range.row_num = 0;
+      range.err = OB_SUCCESS;
+      while (RANGE_ROW_NUM > range.row_num
+             && OB_SUCCESS == (ret = memtable_iter_.next()))
+      {
+        range.keys[range.row_num] = memtable_iter_.get_key();
+        range.values[range.row_num] = memtable_iter_.get_value();
+        range.row_num++;
+      }
+      if (OB_SUCCESS != ret)
+      {
+        cut_end_ = true;
+        if (OB_ITER_END != ret)
+        {
+          TBSYS_LOG(WARN, "iterate memtable fail ret=%d", ret);
+          range.err = ret;
+        }
+        ret = (OB_ITER_END == ret) ? OB_SUCCESS : ret;
+      }
+      return ret;
+    }
+
+    int MemTableRowIterator::encode_range_(EncodeRange &range, MemTableGetIter &get_iter, ObRowCompaction &rc_iter)
+    {
+      int ret = OB_SUCCESS;
+      range.column_ids.clear();
+      range.objs.clear();
+      for (int64_t i = 0; OB_SUCCESS == ret && i < range.row_num; i++)
+      {
+        if (NULL == range.values[i])
+        {
+          TBSYS_LOG(WARN, "value null pointer");
+          ret = OB_ERROR;
+          break;
+        }
+        get_iter.set_(range.keys[i], range.values[i], NULL, true, NULL);
+        rc_iter.set_iterator(&get_iter);
+        while (OB_SUCCESS == (ret = rc_iter.next_cell()))
+        {
+          ObCellInfo *ci = NULL;
+          if (OB_SUCCESS != (ret = rc_iter.get_cell(&ci))
+              || NULL == ci)
+          {
+            TBSYS_LOG(WARN, "get cell from get_iter/rc_iter fail ret=%d", ret);
+            ret = (OB_SUCCESS == ret) ? OB_ERROR : ret;
+            break;
+          }
+          uint64_t column_id = ci->column_id_;
+          if (OB_INVALID_ID == column_id)
+          {
+            column_id = OB_FULL_ROW_COLUMN_ID;
+          }
+          if (OB_SUCCESS != (ret = range.column_ids.push_back(column_id))
+              || OB_SUCCESS != (ret = range.objs.push_back(ci->value_)))
+          {
+            TBSYS_LOG(WARN, "save encoded cell fail ret=%d [%s]", ret, print_cellinfo(ci));
+            break;
+          }
+        }
+        ret = (OB_ITER_END == ret) ? OB_SUCCESS : ret;
+        range.row_end[i] = range.objs.count();
+      }
+      return ret;
+    }
+
+    void MemTableRowIterator::run_encoder_()
+    {
+      MemTableGetIter get_iter;
+      ObRowCompaction rc_iter;
+      pthread_mutex_lock(&mutex_);
+      while (!stop_ && !cut_end_)
+      {
+        EncodeRange &range = ranges_[cut_seq_ % range_num_];
+        if (RANGE_FREE != range.stat)
+        {
+          pthread_cond_wait(&cond_, &mutex_);
+        }
+        else
+        {
+          cut_range_(range);
+          if (0 == range.row_num && OB_SUCCESS == range.err)
+          {
+            // memtable已经迭代完
+          }
+          else
+          {
+            range.stat = RANGE_ENCODING;
+            cut_seq_++;
+            pthread_mutex_unlock(&mutex_);
+            if (OB_SUCCESS == range.err)
+            {
+              range.err = encode_range_(range, get_iter, rc_iter);
+            }
+            pthread_mutex_lock(&mutex_);
+            range.stat = RANGE_READY;
+          }
+          pthread_cond_broadcast(&cond_);
+        }
+      }
+      pthread_mutex_unlock(&mutex_);
+    }
+
+    void *MemTableRowIterator::encode_thread_func_(void *data)
+    {
+      MemTableRowIterator *const host = static_cast<MemTableRowIterator*>(data);
+      if (NULL != host)
+      {
+        host->run_encoder_();
+      }
+      return NULL;
+    }
+
     bool MemTableRowIterator::get_compressor_name(ObString &compressor_str)
     {
       bool bret = false;
@@ -91,8 +91,34 @@ namespace oceanbase
         Allocator allocator_;
     };
 
+    // encode_thread_num大于1时按key切分range并行读取memtable的行
+    // 1. 共享的memtable_iter_每次按顺序切出RANGE_ROW_NUM行作为一个range，由切出它的encode线程
+    //    独立地遍历cell链表并做行压实，结果写到range自己的缓冲中
+    // 2. range放在一个环形数组里，dump线程按range的顺序消费，环满时encode线程等待，内存有界
+    // 3. 缓冲中的cell值是浅拷贝，指向frozen memtable的内存，memtable在转储期间不会释放
     class MemTableRowIterator : public IRowIterator, public RowkeyInfoCache
     {
+      public:
+        static const int64_t RANGE_ROW_NUM = 1024;
+        static const int64_t MAX_ENCODE_THREAD_NUM = 16;
+      private:
+        enum RangeStat
+        {
+          RANGE_FREE = 0,
+          RANGE_ENCODING = 1,
+          RANGE_READY = 2,
+        };
+        struct EncodeRange
+        {
+          volatile int stat;
+          int err;
+          int64_t row_num;
+          TEKey keys[RANGE_ROW_NUM];
+          TEValue *values[RANGE_ROW_NUM];
+          int64_t row_end[RANGE_ROW_NUM];   // 每一行在column_ids/objs中的结束位置
+          common::ObArray<uint64_t> column_ids;
+          common::ObArray<common::ObObj> objs;
+        };
       public:
         MemTableRowIterator();
         virtual ~MemTableRowIterator();
@@ -100,7 +126,8 @@ namespace oceanbase
         int init(MemTable *memtable,
                 const char *compressor_name = DEFAULT_COMPRESSOR_NAME,
                 const int64_t block_size = sstable::ObSSTableBlockBuilder::SSTABLE_BLOCK_SIZE,
-                const int store_type = sstable::OB_SSTABLE_STORE_SPARSE);
+                const int store_type = sstable::OB_SSTABLE_STORE_SPARSE,
+                const int64_t encode_thread_num = 1);
         void destroy();
       public:
         virtual int next_row();
@@ -115,6 +142,14 @@ namespace oceanbase
         void reset_();
         void revert_schema_handle_();
         bool get_schema_handle_();
+        int start_encoders_();
+        void stop_encoders_();
+        int next_encoded_row_();
+        int get_encoded_row_(sstable::ObSSTableRow &sstable_row);
+        int cut_range_(EncodeRange &range);
+        int encode_range_(EncodeRange &range, MemTableGetIter &get_iter, common::ObRowCompaction &rc_iter);
+        void run_encoder_();
+        static void *encode_thread_func_(void *data);
       private:
         MemTable *memtable_;
         TableEngineIterator memtable_iter_;
@@ -124,6 +159,19 @@ namespace oceanbase
         int64_t block_size_;
         int store_type_;
         char compressor_name_[common::OB_MAX_COMPRESSOR_NAME_LENGTH];
+        int64_t encode_thread_num_;
+        // 以下成员只在并行读取时使用，memtable_iter_也由mutex_保护
+        int64_t thread_num_;
+        pthread_t threads_[MAX_ENCODE_THREAD_NUM];
+        pthread_mutex_t mutex_;
+        pthread_cond_t cond_;
+        EncodeRange *ranges_;
+        int64_t range_num_;
+        bool stop_;
+        bool cut_end_;          // memtable_iter_已经迭代结束或者出错
+        int64_t cut_seq_;       // 下一个切出的range
+        int64_t consume_seq_;   // dump线程正在消费的range
+        int64_t consume_row_;
     };
   }
 }
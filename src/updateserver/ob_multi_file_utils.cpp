@@ -24,13 +24,22 @@ namespace oceanbase
   using namespace common;
   namespace updateserver
   {
-    MultiFileUtils::MultiFileUtils()
+    MultiFileUtils::MultiFileUtils() : file_pos_(-1),
+                                       writer_num_(0),
+                                       run_flag_(false),
+                                       push_seq_(0)
     {
+      pthread_mutex_init(&mutex_, NULL);
+      pthread_cond_init(&cond_, NULL);
+      memset(writers_, 0, sizeof(writers_));
+      memset(buffers_, 0, sizeof(buffers_));
     }
 
     MultiFileUtils::~MultiFileUtils()
     {
       close();
+      pthread_cond_destroy(&cond_);
+      pthread_mutex_destroy(&mutex_);
     }
 
     int MultiFileUtils::open(const ObString &fname, const bool dio, const bool is_create, const bool is_trunc, const int64_t align_size)
@@ -78,6 +87,10 @@ namespace oceanbase
             break;
           }
         }
+        if (OB_SUCCESS == ret)
+        {
+          ret = start_writers_();
+        }
         if (OB_SUCCESS != ret)
         {
           close();
@@ -131,6 +144,10 @@ namespace oceanbase
             break;
           }
         }
+        if (OB_SUCCESS == ret)
+        {
+          ret = start_writers_();
+        }
         if (OB_SUCCESS != ret)
         {
           close();
@@ -141,6 +158,7 @@ namespace oceanbase
 
     void MultiFileUtils::close()
     {
+      stop_writers_();
       ObList<ObIFileAppender*>::iterator iter;
       for (iter = flist_.begin(); iter != flist_.end(); iter++)
       {
@@ -153,33 +171,291 @@ namespace oceanbase
         }
       }
       flist_.clear();
+      file_pos_ = -1;
     }
 
     int64_t MultiFileUtils::get_file_pos() const
     {
       int64_t ret = -1;
-      ObList<ObIFileAppender*>::const_iterator iter;
-      ObIFileAppender *file = NULL;
       if (0 == flist_.size())
       {
         TBSYS_LOG(WARN, "no file open");
       }
-      else if (flist_.end() == (iter = flist_.begin()))
+      else
+      {
+        ret = file_pos_;
+      }
+      return ret;
+    }
+
+    int MultiFileUtils::append(const void *buf, const int64_t count, bool is_fsync)
+    {
+      int ret = OB_SUCCESS;
+      if (0 == flist_.size())
+      {
+        TBSYS_LOG(WARN, "no file open");
+        ret = OB_ERROR;
+      }
+      else if (NULL == buf || 0 > count)
+      {
+        TBSYS_LOG(WARN, "invalid param buf=%p count=%ld", buf, count);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (0 < writer_num_)
+      {
+        if (OB_SUCCESS == (ret = append_parallel_(buf, count))
+            && is_fsync)
+        {
+          ret = fsync();
+        }
+      }
+      else
+      {
+        ret = append_serial_(buf, count, is_fsync);
+      }
+      if (OB_SUCCESS == ret)
+      {
+        file_pos_ += count;
+      }
+      return ret;
+    }
+
+    int MultiFileUtils::fsync()
+    {
+      int ret = OB_SUCCESS;
+      if (0 == flist_.size())
+      {
+        TBSYS_LOG(WARN, "no file open");
+        ret = OB_ERROR;
+      }
+      else if (0 < writer_num_)
       {
-        TBSYS_LOG(WARN, "flist begin equal end");
+        if (OB_SUCCESS == (ret = push_buffer_(true)))
+        {
+          ret = wait_writers_(push_seq_);
+        }
       }
-      else if (NULL == (file = *iter))
+      else
+      {
+        ret = fsync_serial_();
+      }
+      return ret;
+    }
+
+    int MultiFileUtils::start_writers_()
+    {
+      int ret = OB_SUCCESS;
+      ObList<ObIFileAppender*>::iterator iter = flist_.begin();
+      if (flist_.end() == iter || NULL == *iter)
       {
         TBSYS_LOG(WARN, "invalid file pos=[0]");
+        ret = OB_ERROR;
       }
       else
       {
-        ret = file->get_file_pos();
+        file_pos_ = (*iter)->get_file_pos();
+      }
+      if (OB_SUCCESS != ret || 1 >= flist_.size())
+      {
+        // 只有一个文件时直接在调用线程中写
+      }
+      else if (MAX_FILE_NUM < flist_.size())
+      {
+        TBSYS_LOG(WARN, "too many files num=%ld max=%ld", flist_.size(), MAX_FILE_NUM);
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else
+      {
+        for (int64_t i = 0; OB_SUCCESS == ret && i < WRITE_BUFFER_NUM; i++)
+        {
+          if (NULL == (buffers_[i].buf = (char*)ob_malloc(WRITE_BUFFER_SIZE, ObModIds::OB_UPS_SSTABLE_MGR)))
+          {
+            TBSYS_LOG(WARN, "alloc write buffer fail size=%ld", WRITE_BUFFER_SIZE);
+            ret = OB_MEM_OVERFLOW;
+          }
+          buffers_[i].length = 0;
+          buffers_[i].is_fsync = false;
+        }
+        push_seq_ = 0;
+        run_flag_ = true;
+        for (int64_t i = 0; OB_SUCCESS == ret && iter != flist_.end(); iter++, i++)
+        {
+          ThreadConf &tc = writers_[i];
+          tc.index = i;
+          tc.file = *iter;
+          tc.done_seq = 0;
+          tc.err = OB_SUCCESS;
+          tc.host = this;
+          int tmp_ret = 0;
+          if (NULL == tc.file)
+          {
+            TBSYS_LOG(WARN, "invalid file pos=[%ld]", i);
+            ret = OB_ERROR;
+          }
+          else if (0 != (tmp_ret = pthread_create(&(tc.pd), NULL, thread_func_, &tc)))
+          {
+            TBSYS_LOG(WARN, "pthread_create fail, ret=%d", tmp_ret);
+            ret = OB_ERROR;
+          }
+          else
+          {
+            writer_num_++;
+          }
+        }
+        if (OB_SUCCESS != ret)
+        {
+          stop_writers_();
+        }
+        else
+        {
+          TBSYS_LOG(INFO, "start %ld parallel file writers", writer_num_);
+        }
+      }
+      return ret;
+    }
+
+    void MultiFileUtils::stop_writers_()
+    {
+      if (0 < writer_num_)
+      {
+        // 剩余的数据交给写线程写完
+        if (0 < buffers_[push_seq_ % WRITE_BUFFER_NUM].length)
+        {
+          push_buffer_(false);
+        }
+        wait_writers_(push_seq_);
+        pthread_mutex_lock(&mutex_);
+        run_flag_ = false;
+        pthread_cond_broadcast(&cond_);
+        pthread_mutex_unlock(&mutex_);
+        for (int64_t i = 0; i < writer_num_; i++)
+        {
+          pthread_join(writers_[i].pd, NULL);
+        }
+        writer_num_ = 0;
+      }
+      for (int64_t i = 0; i < WRITE_BUFFER_NUM; i++)
+      {
+        if (NULL != buffers_[i].buf)
+        {
+          ob_free(buffers_[i].buf, ObModIds::OB_UPS_SSTABLE_MGR);
+          buffers_[i].buf = NULL;
+        }
+        buffers_[i].length = 0;
+      }
+      push_seq_ = 0;
+    }
+
+    int MultiFileUtils::wait_writers_(const int64_t seq)
+    {
+      int ret = OB_SUCCESS;
+      pthread_mutex_lock(&mutex_);
+      for (int64_t i = 0; i < writer_num_; i++)
+      {
+        while (writers_[i].done_seq < seq)
+        {
+          pthread_cond_wait(&cond_, &mutex_);
+        }
+        if (OB_SUCCESS == ret)
+        {
+          ret = writers_[i].err;
+        }
+      }
+      pthread_mutex_unlock(&mutex_);
+      return ret;
+    }
+
+    int MultiFileUtils::push_buffer_(const bool is_fsync)
+    {
+      int ret = OB_SUCCESS;
+      pthread_mutex_lock(&mutex_);
+      buffers_[push_seq_ % WRITE_BUFFER_NUM].is_fsync = is_fsync;
+      push_seq_++;
+      pthread_cond_broadcast(&cond_);
+      pthread_mutex_unlock(&mutex_);
+      // 下一个缓冲被所有写线程写完之后才能重新填充
+      ret = wait_writers_(push_seq_ - WRITE_BUFFER_NUM + 1);
+      buffers_[push_seq_ % WRITE_BUFFER_NUM].length = 0;
+      buffers_[push_seq_ % WRITE_BUFFER_NUM].is_fsync = false;
+      return ret;
+    }
+
+    int MultiFileUtils::append_parallel_(const void *buf, const int64_t count)
+    {
+      int ret = OB_SUCCESS;
+      const char *ptr = static_cast<const char*>(buf);
+      int64_t remain = count;
+      while (OB_SUCCESS == ret && 0 < remain)
+      {
+        WriteBuffer &wb = buffers_[push_seq_ % WRITE_BUFFER_NUM];
+        int64_t copy_size = std::min(remain, WRITE_BUFFER_SIZE - wb.length);
+        memcpy(wb.buf + wb.length, ptr, copy_size);
+        wb.length += copy_size;
+        ptr += copy_size;
+        remain -= copy_size;
+        if (WRITE_BUFFER_SIZE == wb.length
+            && OB_SUCCESS != (ret = push_buffer_(false)))
+        {
+          TBSYS_LOG(WARN, "write buffer fail ret=%d buf=%p count=%ld", ret, buf, count);
+        }
       }
       return ret;
     }
 
-    int MultiFileUtils::append(const void *buf, const int64_t count, bool is_fsync)
+    void MultiFileUtils::run_writer_(ThreadConf &tc)
+    {
+      int tmp_ret = OB_SUCCESS;
+      pthread_mutex_lock(&mutex_);
+      while (true)
+      {
+        if (tc.done_seq < push_seq_)
+        {
+          const WriteBuffer &wb = buffers_[tc.done_seq % WRITE_BUFFER_NUM];
+          pthread_mutex_unlock(&mutex_);
+          // 出错之后继续消费缓冲，避免append的线程一直等待
+          if (OB_SUCCESS == tc.err)
+          {
+            if (0 < wb.length
+                && OB_SUCCESS != (tmp_ret = tc.file->append(wb.buf, wb.length, false)))
+            {
+              TBSYS_LOG(WARN, "append file fail pos=[%ld] ret=%d buf=%p count=%ld", tc.index, tmp_ret, wb.buf, wb.length);
+              tc.err = tmp_ret;
+            }
+            else if (wb.is_fsync
+                    && OB_SUCCESS != (tmp_ret = tc.file->fsync()))
+            {
+              TBSYS_LOG(WARN, "fsync fail pos=[%ld] ret=%d", tc.index, tmp_ret);
+              tc.err = tmp_ret;
+            }
+          }
+          pthread_mutex_lock(&mutex_);
+          tc.done_seq++;
+          pthread_cond_broadcast(&cond_);
+        }
+        else if (!run_flag_)
+        {
+          break;
+        }
+        else
+        {
+          pthread_cond_wait(&cond_, &mutex_);
+        }
+      }
+      pthread_mutex_unlock(&mutex_);
+    }
+
+    void *MultiFileUtils::thread_func_(void *data)
+    {
+      ThreadConf *const tc = static_cast<ThreadConf*>(data);
+      if (NULL != tc
+          && NULL != tc->host)
+      {
+        tc->host->run_writer_(*tc);
+      }
+      return NULL;
+    }
+
+    int MultiFileUtils::append_serial_(const void *buf, const int64_t count, const bool is_fsync)
     {
       int ret = OB_SUCCESS;
       if (0 == flist_.size())
@@ -212,7 +488,7 @@ namespace oceanbase
 
     }
 
-    int MultiFileUtils::fsync()
+    int MultiFileUtils::fsync_serial_()
     {
       int ret = OB_SUCCESS;
       if (0 == flist_.size())
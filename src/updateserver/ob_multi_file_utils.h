@@ -22,11 +22,13 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <pthread.h>
 #include <new>
 #include <algorithm>
 #include "common/ob_define.h"
 #include "common/ob_file.h"
+#include "common/ob_malloc.h"
 #include "common/ob_list.h"
 #include "common/hash/ob_hashutils.h"
 
@@ -34,6 +36,9 @@ namespace oceanbase
 {
   namespace updateserver
   {
+    // 多个文件时每个文件由一个写线程负责，append的数据先拷贝到共享的写缓冲中，
+    // 缓冲写满后交给所有写线程并行写盘，fsync也在各个盘上并行执行，
+    // 转储的耗时不再随着store的个数线性增长
     class MultiFileUtils : public common::ObIFileAppender
     {
       typedef common::ObFileAppender FileAppenderImpl;
@@ -41,6 +46,25 @@ namespace oceanbase
       static const bool IS_DIRECT = true;
       static const bool IS_CREATE = true;
       static const bool IS_TRUNC = false;
+      static const int64_t MAX_FILE_NUM = 32;
+      static const int64_t WRITE_BUFFER_NUM = 4;
+      static const int64_t WRITE_BUFFER_SIZE = 2L * 1024L * 1024L;
+      static const int64_t WAIT_TIME_US = 100 * 1000;
+      struct WriteBuffer
+      {
+        char *buf;
+        int64_t length;
+        bool is_fsync;
+      };
+      struct ThreadConf
+      {
+        pthread_t pd;
+        int64_t index;
+        common::ObIFileAppender *file;
+        volatile int64_t done_seq;
+        volatile int err;
+        MultiFileUtils *host;
+      };
       public:
         MultiFileUtils();
         ~MultiFileUtils();
@@ -52,9 +76,28 @@ namespace oceanbase
         int64_t get_file_pos() const;
         int append(const void *buf, const int64_t count, bool is_fsync);
         int fsync();
+      private:
+        int start_writers_();
+        void stop_writers_();
+        int wait_writers_(const int64_t seq);
+        int push_buffer_(const bool is_fsync);
+        int append_parallel_(const void *buf, const int64_t count);
+        int append_serial_(const void *buf, const int64_t count, const bool is_fsync);
+        int fsync_serial_();
+        void run_writer_(ThreadConf &tc);
+        static void *thread_func_(void *data);
       private:
         common::ObList<common::ObIFileAppender*> flist_;
         FileAlloc file_alloc_;
+        int64_t file_pos_;
+        int64_t writer_num_;
+        volatile bool run_flag_;
+        pthread_mutex_t mutex_;
+        pthread_cond_t cond_;
+        ThreadConf writers_[MAX_FILE_NUM];
+        WriteBuffer buffers_[WRITE_BUFFER_NUM];
+        // buffers_[push_seq_ % WRITE_BUFFER_NUM]是正在填充的缓冲
+        volatile int64_t push_seq_;
     };
   }
 }
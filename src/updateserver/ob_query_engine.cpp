@@ -29,6 +29,8 @@ namespace oceanbase
 
     int64_t QueryEngine::HASH_SIZE = 50000000;
     QueryEngine::QueryEngine(MemTank &allocer) : inited_(false),
+                                                 hash_index_enabled_(true),
+                                                 no_hash_index_table_num_(0),
                                                  btree_alloc_(allocer),
                                                  hash_alloc_(allocer),
                                                  keybtree_(btree_alloc_),
@@ -54,16 +56,25 @@ namespace oceanbase
       }
       else
       {
-        if (OB_SUCCESS != (ret = keyhash_.create(hash::cal_next_prime(hash_size?: HASH_SIZE))))
+        hash_index_enabled_ = g_conf.using_hash_index;
+        no_hash_index_table_num_ = std::min(static_cast<int64_t>(g_conf.no_hash_index_table_num), MAX_NO_HASH_INDEX_TABLE_NUM);
+        memcpy(no_hash_index_tables_, g_conf.no_hash_index_tables,
+              no_hash_index_table_num_ * sizeof(no_hash_index_tables_[0]));
+        // 不建hash索引时不分配桶数组
+        if (hash_index_enabled_
+            && OB_SUCCESS != (ret = keyhash_.create(hash::cal_next_prime(hash_size?: HASH_SIZE))))
         {
           TBSYS_LOG(WARN, "keyhash create fail");
         }
         else if (ERROR_CODE_OK != (ret = keybtree_.init()))
         {
           TBSYS_LOG(WARN, "keybtree init fail");
+          keyhash_.destroy();
         }
         else
         {
+          TBSYS_LOG(INFO, "query engine init hash_index_enabled=%s no_hash_index_table_num=%ld",
+                    STR_BOOL(hash_index_enabled_), no_hash_index_table_num_);
           inited_ = true;
         }
       }
@@ -96,7 +107,10 @@ namespace oceanbase
       else
       {
         keybtree_.clear();
-        keyhash_.clear();
+        if (hash_index_enabled_)
+        {
+          keyhash_.clear();
+        }
       }
       return ret;
     }
@@ -120,6 +134,27 @@ namespace oceanbase
         TBSYS_LOG(INFO, "value null pointer");
         ret = OB_ERROR;
       }
+      else if (!need_hash_index_(key.table_id))
+      {
+        // 只建btree索引，并发插入同一行时由btree返回key重复
+        if (ERROR_CODE_OK != (btree_ret = keybtree_.put(TEBtreeKey(key), value, false)))
+        {
+          if (ERROR_CODE_KEY_REPEAT == btree_ret)
+          {
+            ret = OB_ENTRY_EXIST;
+          }
+          else
+          {
+            TBSYS_LOG(WARN, "put to keybtree fail btree_ret=%d [%s] [%s]",
+                      btree_ret, key.log_str(), value->log_str());
+            ret = (ERROR_CODE_ALLOC_FAIL == btree_ret) ? OB_MEM_OVERFLOW : OB_ERROR;
+          }
+        }
+        else
+        {
+          value->index_stat |= IST_BTREE_INDEX;
+        }
+      }
       else if (OB_SUCCESS != (hash_ret = keyhash_.insert(hash_key, value)))
       {
         if (OB_ENTRY_EXIST != hash_ret)
@@ -132,7 +167,7 @@ namespace oceanbase
       else
       {
         value->index_stat |= IST_HASH_INDEX;
-        if (ERROR_CODE_OK != (btree_ret = keybtree_.put(key, value, true)))
+        if (ERROR_CODE_OK != (btree_ret = keybtree_.put(TEBtreeKey(key), value, true)))
         {
           TBSYS_LOG(WARN, "put to keybtree fail btree_ret=%d [%s] [%s]",
                     btree_ret, key.log_str(), value->log_str());
@@ -156,7 +191,8 @@ namespace oceanbase
       {
         TBSYS_LOG(WARN, "have not inited");
       }
-      else if (g_conf.using_hash_index)
+      else if (g_conf.using_hash_index
+              && need_hash_index_(key.table_id))
       {
         TEHashKey hash_key;
         hash_key.table_id = static_cast<uint32_t>(key.table_id);
@@ -190,7 +226,7 @@ namespace oceanbase
       else
       {
         int btree_ret = ERROR_CODE_OK;
-        if (ERROR_CODE_OK != (btree_ret = keybtree_.get(key, ret))
+        if (ERROR_CODE_OK != (btree_ret = keybtree_.get(TEBtreeKey(key), ret))
             || NULL == ret)
         {
           if (ERROR_CODE_NOT_FOUND != btree_ret)
@@ -226,12 +262,14 @@ namespace oceanbase
       else
       {
         btree_ret = ERROR_CODE_OK;
-        const TEKey *scan_start_key_ptr = NULL;
-        const TEKey *scan_end_key_ptr = NULL;
+        const TEBtreeKey btree_start_key(start_key);
+        const TEBtreeKey btree_end_key(end_key);
+        const TEBtreeKey *scan_start_key_ptr = NULL;
+        const TEBtreeKey *scan_end_key_ptr = NULL;
         int start_exclude_ = start_exclude;
         int end_exclude_ = end_exclude;
-        TEKey btree_min_key;
-        TEKey btree_max_key;
+        TEBtreeKey btree_min_key;
+        TEBtreeKey btree_max_key;
         if (0 != min_key)
         {
           btree_ret = keybtree_.get_min_key(btree_min_key);
@@ -248,7 +286,7 @@ namespace oceanbase
         }
         else
         {
-          scan_start_key_ptr = &start_key;
+          scan_start_key_ptr = &btree_start_key;
         }
         if (0 != max_key)
         {
@@ -266,7 +304,7 @@ namespace oceanbase
         }
         else
         {
-          scan_end_key_ptr = &end_key;
+          scan_end_key_ptr = &btree_end_key;
         }
         if (reverse)
         {
@@ -279,7 +317,7 @@ namespace oceanbase
                                               *scan_start_key_ptr, start_exclude_,
                                               *scan_end_key_ptr, end_exclude_);
           TBSYS_LOG(DEBUG, "[BTREE_SCAN_PARAM] [%s] %d [%s] %d",
-                    scan_start_key_ptr->log_str(), start_exclude_, scan_end_key_ptr->log_str(), end_exclude_);
+                    scan_start_key_ptr->to_cstring(), start_exclude_, scan_end_key_ptr->to_cstring(), end_exclude_);
           if (ERROR_CODE_OK != btree_ret)
           {
             TBSYS_LOG(WARN, "set key range to btree scan handle fail btree_ret=%d", btree_ret);
@@ -303,20 +341,22 @@ namespace oceanbase
       if (NULL != fd)
       {
         keybtree_t::TScanHandle handle;
-        TEKey btree_min_key;
-        TEKey btree_max_key;
+        TEBtreeKey btree_min_key;
+        TEBtreeKey btree_max_key;
         if (ERROR_CODE_OK == keybtree_.get_scan_handle(handle)
             && ERROR_CODE_OK == keybtree_.get_min_key(btree_min_key)
             && ERROR_CODE_OK == keybtree_.get_max_key(btree_max_key))
         {
           keybtree_.set_key_range(handle, btree_min_key, 0, btree_max_key, 0);
+          TEBtreeKey btree_key;
           TEKey key;
           TEValue *value = NULL;
           MemTableGetIter get_iter;
           int64_t num = 0;
-          while (ERROR_CODE_OK == keybtree_.get_next(handle, key, value)
+          while (ERROR_CODE_OK == keybtree_.get_next(handle, btree_key, value)
                 && NULL != value)
           {
+            btree_key.to_tekey(key);
             fprintf(fd, "[ROW_INFO][%ld] btree_key=[%s] btree_value=[%s] ptr=%p\n",
                     num, key.log_str(), value->log_str(), value);
             int64_t pos = 0;
@@ -355,6 +395,24 @@ namespace oceanbase
       keybtree_.dump_mem_info();
     }
 
+    bool QueryEngine::is_hash_index_enabled() const
+    {
+      return hash_index_enabled_;
+    }
+
+    bool QueryEngine::need_hash_index_(const uint64_t table_id) const
+    {
+      bool bret = hash_index_enabled_;
+      for (int64_t i = 0; bret && i < no_hash_index_table_num_; i++)
+      {
+        if (table_id == no_hash_index_tables_[i])
+        {
+          bret = false;
+        }
+      }
+      return bret;
+    }
+
     int64_t QueryEngine::hash_size() const
     {
       return keyhash_.size();
@@ -372,7 +430,7 @@ namespace oceanbase
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    QueryEngineIterator::QueryEngineIterator() : keybtree_(NULL), read_handle_(), key_(), pvalue_(NULL)
+    QueryEngineIterator::QueryEngineIterator() : keybtree_(NULL), read_handle_(), btree_key_(), key_(), pvalue_(NULL)
     {
     }
 
@@ -392,7 +450,7 @@ namespace oceanbase
       {
         while (true)
         {
-          if (ERROR_CODE_OK != (btree_ret = keybtree_->get_next(read_handle_, key_, pvalue_))
+          if (ERROR_CODE_OK != (btree_ret = keybtree_->get_next(read_handle_, btree_key_, pvalue_))
               || NULL == pvalue_)
           {
             if (ERROR_CODE_NOT_FOUND != btree_ret)
@@ -409,6 +467,7 @@ namespace oceanbase
           }
           else
           {
+            btree_key_.to_tekey(key_);
             break;
           }
         }
@@ -77,10 +77,13 @@ namespace oceanbase
     };
 
     class QueryEngineIterator;
+    // btree索引保存16字节的TEBtreeKey，hash索引可以整体关闭或者对指定的表关闭，
+    // 不建hash索引的表的get走btree，是否建hash索引在init时根据g_conf确定，
+    // 在memtable的整个生命周期中保持不变
     class QueryEngine
     {
       friend class QueryEngineIterator;
-      typedef common::cmbtree::BtreeBase<TEKey, TEValue*, BtreeEngineAllocator> keybtree_t;
+      typedef common::cmbtree::BtreeBase<TEBtreeKey, TEValue*, BtreeEngineAllocator> keybtree_t;
       typedef lightyhash::LightyHashMap<TEHashKey, TEValue*, HashEngineAllocator, HashEngineAllocator> keyhash_t;
       public:
         static int64_t HASH_SIZE;
@@ -129,8 +132,14 @@ namespace oceanbase
         int64_t hash_size() const;
         int64_t hash_bucket_using() const;
         int64_t hash_uninit_unit_num() const;
+        bool is_hash_index_enabled() const;
+      private:
+        bool need_hash_index_(const uint64_t table_id) const;
       private:
         bool inited_;
+        bool hash_index_enabled_;
+        int64_t no_hash_index_table_num_;
+        uint64_t no_hash_index_tables_[MAX_NO_HASH_INDEX_TABLE_NUM];
         BtreeEngineAllocator btree_alloc_;
         HashEngineAllocator hash_alloc_;
         keybtree_t keybtree_;
@@ -158,6 +167,7 @@ namespace oceanbase
       private:
         QueryEngine::keybtree_t *keybtree_;
         QueryEngine::keybtree_t::TScanHandle read_handle_;
+        TEBtreeKey btree_key_;
         TEKey key_;
         TEValue *pvalue_;
     };
@@ -215,14 +215,68 @@ namespace oceanbase
       };
     };
 
+    // btree索引中保存的key，与TEHashKey相同只有16字节，比TEKey少8字节，
+    // btree的叶子节点可以放下更多的key，比较时rowkey也只比较一次
+    struct TEBtreeKey
+    {
+      uint32_t table_id;
+      int32_t rk_length;
+      const ObObj *row_key;
+
+      TEBtreeKey() : table_id(UINT32_MAX),
+                     rk_length(0),
+                     row_key(NULL)
+      {
+      };
+      explicit TEBtreeKey(const TEKey &key) : table_id(static_cast<uint32_t>(key.table_id)),
+                                              rk_length(static_cast<int32_t>(key.row_key.length())),
+                                              row_key(key.row_key.ptr())
+      {
+      };
+      inline void to_tekey(TEKey &key) const
+      {
+        key.table_id = (UINT32_MAX == table_id) ? common::OB_INVALID_ID : table_id;
+        key.row_key.assign(const_cast<ObObj*>(row_key), rk_length);
+      };
+      inline int operator - (const TEBtreeKey &other) const
+      {
+        int ret = 0;
+        if (table_id > other.table_id)
+        {
+          ret = 1;
+        }
+        else if (table_id < other.table_id)
+        {
+          ret = -1;
+        }
+        else
+        {
+          common::ObRowkey rk1(const_cast<ObObj*>(row_key), rk_length);
+          common::ObRowkey rk2(const_cast<ObObj*>(other.row_key), other.rk_length);
+          ret = rk1.compare(rk2);
+        }
+        return ret;
+      };
+      inline const char *to_cstring() const
+      {
+        TEKey key;
+        to_tekey(key);
+        return key.log_str();
+      };
+    };
+
     static const uint8_t IST_NO_INDEX = 0x0;
     static const uint8_t IST_HASH_INDEX = 0x1;
     static const uint8_t IST_BTREE_INDEX = 0x2;
 
+    static const uint8_t HST_NONE = 0x0;
+    static const uint8_t HST_QUEUED = 0x1; // 已加入memtable的热点行队列，等待后台合并
+
     struct TEValueUCInfo;
     struct TEValue
     {
       uint8_t index_stat;
+      volatile uint8_t hot_stat;
       int16_t cell_info_cnt;
       int16_t cell_info_size; // 单位为1K
       ObCellInfoNode *list_head;
@@ -237,6 +291,7 @@ namespace oceanbase
       inline void reset()
       {
         index_stat = IST_NO_INDEX;
+        hot_stat = HST_NONE;
         cell_info_cnt = 0;
         cell_info_size = 0;
         list_head = NULL;
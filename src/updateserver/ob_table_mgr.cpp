@@ -1163,19 +1163,21 @@ namespace oceanbase
         {
           const char *compressor_name = ups_main->get_update_server().get_param().sstable_compressor_name;
           int64_t block_size = ups_main->get_update_server().get_param().sstable_block_size;
+          int64_t dump_thread_num = ups_main->get_update_server().get_param().sstable_dump_thread_num;
           if (NULL == compressor_name
               || 0 == strlen(compressor_name))
           {
             compressor_name = DEFAULT_COMPRESSOR_NAME;
           }
-          if (OB_SUCCESS != (ret = row_iter_.init(&(memtable_entity_.get_memtable()), compressor_name, block_size)))
+          if (OB_SUCCESS != (ret = row_iter_.init(&(memtable_entity_.get_memtable()), compressor_name, block_size,
+                                                  sstable::OB_SSTABLE_STORE_SPARSE, dump_thread_num)))
           {
             TBSYS_LOG(WARN, "row_iter set schema handle fail ret=%d", ret);
           }
           else
           {
-            TBSYS_LOG(INFO, "memtable rowiter init succ compressor_name=[%s] block_size=%ld",
-                      compressor_name, block_size);
+            TBSYS_LOG(INFO, "memtable rowiter init succ compressor_name=[%s] block_size=%ld dump_thread_num=%ld",
+                      compressor_name, block_size, dump_thread_num);
           }
         }
         UpsSchemaMgrGuard sm_guard;
@@ -2623,6 +2625,65 @@ namespace oceanbase
       return bret;
     }
 
+    bool TableMgr::try_build_frozen_bloomfilter()
+    {
+      bool bret = false;
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited this=%p", this);
+      }
+      else
+      {
+        TableItem *table_item2build = NULL;
+        ITableEntity *memtable_entity = NULL;
+        int btree_ret = ERROR_CODE_OK;
+        map_lock_.rdlock();
+        if (true)
+        {
+          BtreeReadHandle handle;
+          if (ERROR_CODE_OK != (btree_ret = table_map_.get_read_handle(handle)))
+          {
+            TBSYS_LOG(WARN, "get read handle fail ret=%d", btree_ret);
+          }
+          else
+          {
+            table_map_.set_key_range(handle, table_map_.get_min_key(), 0, table_map_.get_max_key(), 0);
+            TableItem *table_item = NULL;
+            while (ERROR_CODE_OK == table_map_.get_next(handle, table_item))
+            {
+              int64_t sstable_percent = 0;
+              if (NULL != table_item
+                  && TableItem::FROZEN <= table_item->get_stat()
+                  && table_item->get_memtable().need_build_frozen_bloomfilter()
+                  && NULL != (memtable_entity = table_item->get_table_entity(sstable_percent)))
+              {
+                // 和读请求一样引用内存表, 建立过程中内存表被释放也不会出错
+                memtable_entity->ref();
+                table_item->inc_ref_cnt();
+                table_item2build = table_item;
+                break;
+              }
+            }
+          }
+        }
+        map_lock_.unlock();
+        if (NULL != table_item2build)
+        {
+          SSTableID sst_id = table_item2build->get_sstable_id();
+          int ret = table_item2build->get_memtable().build_frozen_bloomfilter();
+          TBSYS_LOG(INFO, "build frozen bloomfilter ret=%d %s", ret, sst_id.log_str());
+          bret = (OB_SUCCESS == ret);
+          memtable_entity->deref();
+          if (0 == table_item2build->dec_ref_cnt())
+          {
+            table_allocator_.free(table_item2build);
+            TBSYS_LOG(INFO, "erase sstable, delete table_item=%p %s", table_item2build, sst_id.log_str());
+          }
+        }
+      }
+      return bret;
+    }
+
     bool TableMgr::try_drop_memtable(const int64_t mem_limit)
     {
       bool bret = false;
@@ -3412,5 +3473,22 @@ namespace oceanbase
         ups.submit_handle_frozen();
       }
     }
+
+    void CompactHotRowsDuty::runTimerTask()
+    {
+      ObUpdateServerMain *ups_main = ObUpdateServerMain::get_instance();
+      if (NULL == ups_main)
+      {
+        TBSYS_LOG(WARN, "get ups_main fail");
+      }
+      else
+      {
+        ObUpdateServer &ups = ups_main->get_update_server();
+        if (0 < ups.get_param().hot_row_cell_num)
+        {
+          ups.submit_compact_hot_rows();
+        }
+      }
+    }
   }
 }
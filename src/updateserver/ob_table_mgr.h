@@ -492,6 +492,9 @@ namespace oceanbase
         // 工作线程调用 将冻结表转储为sstable
         // 返回false表示没有冻结表需要转储了
         bool try_dump_memtable();
+        // 工作线程调用 为冻结表建立rowkey的bloomfilter
+        // 返回false表示没有冻结表需要建立了
+        bool try_build_frozen_bloomfilter();
         // 主线程定期调用 内存占用超过mem_limit情况下释放冻结表 由定时线程触发异步任务
         bool try_drop_memtable(const int64_t mem_limit);
         bool try_drop_memtable(const bool force);
@@ -601,6 +604,16 @@ namespace oceanbase
         virtual ~HandleFrozenDuty() {};
         virtual void runTimerTask();
     };
+
+    class CompactHotRowsDuty : public common::ObTimerTask
+    {
+      public:
+        static const int64_t SCHEDULE_PERIOD = 200L * 1000L;
+      public:
+        CompactHotRowsDuty() {};
+        virtual ~CompactHotRowsDuty() {};
+        virtual void runTimerTask();
+    };
   }
 }
 
@@ -40,12 +40,17 @@ namespace oceanbase
   {
     TransExecutor::TransExecutor(ObUtilInterface &ui) : TransHandlePool(),
                                                         TransCommitThread(),
+                                                        TransFlushThread(),
                                                         ui_(ui),
                                                         allocator_(),
                                                         session_ctx_factory_(),
                                                         session_mgr_(),
                                                         lock_mgr_(),
-                                                        uncommited_session_list_(),
+                                                        cur_flush_task_(0),
+                                                        batch_limit_(DEFAULT_BATCH_NUM),
+                                                        flush_elapse_us_(0),
+                                                        arrival_rate_(0),
+                                                        last_flush_start_time_(0),
                                                         ups_result_buffer_(ups_result_memory_, OB_MAX_PACKET_LENGTH)
     {
       allocator_.set_mod_id(ObModIds::OB_UPS_TRANS_EXECUTOR_TASK);
@@ -79,6 +84,7 @@ namespace oceanbase
       trans_handler_[OB_PHY_PLAN_EXECUTE] = thandle_write_trans;
       trans_handler_[OB_START_TRANSACTION] = thandle_start_session;
       trans_handler_[OB_UPS_ASYNC_KILL_ZOMBIE] = thandle_kill_zombie;
+      trans_handler_[OB_UPS_ASYNC_COMPACT_HOT_ROWS] = thandle_compact_hot_rows;
       trans_handler_[OB_UPS_SHOW_SESSIONS] = thandle_show_sessions;
       trans_handler_[OB_UPS_KILL_SESSION] = thandle_kill_session;
       trans_handler_[OB_END_TRANSACTION] = thandle_end_session;
@@ -111,6 +117,10 @@ namespace oceanbase
       {
         TBSYS_LOG(WARN, "init session mgr fail ret=%d", ret);
       }
+      else if (OB_SUCCESS != (ret = TransFlushThread::init(FLUSH_TASK_NUM, FINISH_THREAD_IDLE)))
+      {
+        TBSYS_LOG(WARN, "init TransFlushThread fail ret=%d", ret);
+      }
       else if (OB_SUCCESS != (ret = TransCommitThread::init(TASK_QUEUE_LIMIT, FINISH_THREAD_IDLE)))
       {
         TBSYS_LOG(WARN, "init TransCommitThread fail ret=%d", ret);
@@ -130,6 +140,7 @@ namespace oceanbase
     {
       TransHandlePool::destroy();
       TransCommitThread::destroy();
+      TransFlushThread::destroy();
       session_mgr_.destroy();
       allocator_.destroy();
     }
@@ -244,6 +255,7 @@ namespace oceanbase
         case OB_PHY_PLAN_EXECUTE:
         case OB_START_TRANSACTION:
         case OB_UPS_ASYNC_KILL_ZOMBIE:
+        case OB_UPS_ASYNC_COMPACT_HOT_ROWS:
         case OB_UPS_SHOW_SESSIONS:
         case OB_UPS_KILL_SESSION:
         case OB_END_TRANSACTION:
@@ -1001,6 +1013,11 @@ namespace oceanbase
       session_mgr_.kill_zombie_session(force);
     }
 
+    void TransExecutor::handle_compact_hot_rows_()
+    {
+      UPS.get_table_mgr().compact_hot_rows(session_mgr_);
+    }
+
     void TransExecutor::handle_show_sessions_(ObPacket &pkt,
                                               ObNewScanner &scanner,
                                               ObDataBuffer &buffer)
@@ -1196,16 +1213,16 @@ namespace oceanbase
             {
               TBSYS_LOG(WARN, "fill log fail ret=%d %s", ret, to_cstring(task.sid));
             }
-            else if (OB_SUCCESS != (ret = commit_log_()))
+            else if (OB_SUCCESS != (ret = submit_log_()))
             {
-              TBSYS_LOG(WARN, "commit log fail ret=%d %s", ret, to_cstring(task.sid));
+              TBSYS_LOG(WARN, "submit log fail ret=%d %s", ret, to_cstring(task.sid));
             }
             else if (OB_SUCCESS != (ret = fill_log_(task, *session_ctx)))
             {
               TBSYS_LOG(ERROR, "second fill log fail ret=%d %s serialize_size=%ld uncommited_number=%ld",
                         ret, to_cstring(task.sid),
                         session_ctx->get_ups_mutator().get_serialize_size(),
-                        uncommited_session_list_.size());
+                        flush_task_[cur_flush_task_].task_list.size());
             }
             else
             {
@@ -1216,9 +1233,9 @@ namespace oceanbase
       }
       if (OB_SUCCESS == ret
           && (0 == TransCommitThread::get_queued_num()
-              || MAX_BATCH_NUM <= uncommited_session_list_.size()))
+              || batch_limit_ <= flush_task_[cur_flush_task_].task_list.size()))
       {
-        ret = commit_log_();
+        ret = submit_log_();
       }
       if (OB_SUCCESS != ret)
       {
@@ -1267,10 +1284,11 @@ namespace oceanbase
       }
       if (OB_SUCCESS == ret)
       {
-        if (0 != uncommited_session_list_.push_back(&task))
+        ObList<Task*> &task_list = flush_task_[cur_flush_task_].task_list;
+        if (0 != task_list.push_back(&task))
         {
           ret = (OB_SUCCESS == ret) ? OB_MEM_OVERFLOW : ret;
-          TBSYS_LOG(ERROR, "unexpected push task to uncommited_session_list fail list_size=%ld, will kill self", uncommited_session_list_.size());
+          TBSYS_LOG(ERROR, "unexpected push task to uncommited_session_list fail list_size=%ld, will kill self", task_list.size());
           kill(getpid(), SIGTERM);
         }
         else
@@ -1285,27 +1303,93 @@ namespace oceanbase
       return ret;
     }
 
+    // commit线程摘下当前批次的日志交给flush线程，不等待刷盘完成
+    // log_mgr的detach_log会等待上一批日志写完盘，所以最多一批在写盘、一批在序列化
+    int TransExecutor::submit_log_()
+    {
+      int ret = OB_SUCCESS;
+      FlushTask &flush_task = flush_task_[cur_flush_task_];
+      if (0 < flush_task.task_list.size())
+      {
+        if (OB_SUCCESS != (ret = UPS.get_log_mgr().detach_log()))
+        {
+          TBSYS_LOG(ERROR, "detach commit log fail ret=%d uncommited_number=%ld, will kill self", ret, flush_task.task_list.size());
+          kill(getpid(), SIGTERM);
+        }
+        else
+        {
+          flush_task.batch_start_time = batch_start_time();
+          batch_start_time() = 0;
+          flush_task.is_flying = true;
+          if (OB_SUCCESS != (ret = TransFlushThread::push(&flush_task)))
+          {
+            TBSYS_LOG(ERROR, "push flush task fail ret=%d uncommited_number=%ld, will kill self", ret, flush_task.task_list.size());
+            kill(getpid(), SIGTERM);
+          }
+          else
+          {
+            cur_flush_task_ = (cur_flush_task_ + 1) % FLUSH_TASK_NUM;
+            // 下一个批次可能还在结束session，等它处理完才能继续往里填
+            wait_flush_task_(flush_task_[cur_flush_task_]);
+          }
+        }
+      }
+      try_submit_auto_freeze_();
+      return ret;
+    }
+
+    // 同步提交：除了写事务之外的请求都要等之前的日志全部刷盘并结束session
     int TransExecutor::commit_log_()
+    {
+      int ret = submit_log_();
+      for (int64_t i = 0; i < FLUSH_TASK_NUM; i++)
+      {
+        wait_flush_task_(flush_task_[i]);
+      }
+      return ret;
+    }
+
+    void TransExecutor::wait_flush_task_(FlushTask &flush_task)
+    {
+      flush_cond_.lock();
+      while (flush_task.is_flying)
+      {
+        flush_cond_.wait();
+      }
+      flush_cond_.unlock();
+    }
+
+    void TransExecutor::handle_flush(void *ptask, void *pdata)
     {
       int ret = OB_SUCCESS;
-      if (0 < uncommited_session_list_.size())
+      UNUSED(pdata);
+      FlushTask *flush_task = (FlushTask*)ptask;
+      if (NULL == flush_task)
+      {
+        TBSYS_LOG(WARN, "null pointer flush task=%p", flush_task);
+      }
+      else
       {
+        ObList<Task*> &task_list = flush_task->task_list;
         CLEAR_TRACE_BUF(TraceLog::get_logbuffer());
-        ret = UPS.get_table_mgr().flush_commit_log(TraceLog::get_logbuffer());
+        int64_t flush_start_time = tbsys::CTimeUtil::getTime();
+        ret = UPS.get_log_mgr().flush_detached_log(TraceLog::get_logbuffer());
+        update_batch_limit_(task_list.size(), flush_start_time,
+                            tbsys::CTimeUtil::getTime() - flush_start_time);
         if (OB_SUCCESS != ret)
         {
-          TBSYS_LOG(ERROR, "flush commit log fail ret=%d uncommited_number=%ld, will kill self", ret, uncommited_session_list_.size());
+          TBSYS_LOG(ERROR, "flush commit log fail ret=%d uncommited_number=%ld, will kill self", ret, task_list.size());
           kill(getpid(), SIGTERM);
         }
         bool rollback = (OB_SUCCESS != ret);
         int64_t i = 0;
         ObList<Task*>::iterator iter;
-        for (iter = uncommited_session_list_.begin(); iter != uncommited_session_list_.end(); iter++, i++)
+        for (iter = task_list.begin(); iter != task_list.end(); iter++, i++)
         {
           Task *task = *iter;
           if (NULL == task)
           {
-            TBSYS_LOG(ERROR, "unexpected task null pointer batch=%ld, will kill self", uncommited_session_list_.size());
+            TBSYS_LOG(ERROR, "unexpected task null pointer batch=%ld, will kill self", task_list.size());
             kill(getpid(), SIGTERM);
           }
           else
@@ -1321,7 +1405,7 @@ namespace oceanbase
               }
               else
               {
-                FILL_TRACE_BUF(session_ctx->get_tlog_buffer(), "%sbatch=%ld:%ld", TraceLog::get_logbuffer().buffer, i, uncommited_session_list_.size());
+                FILL_TRACE_BUF(session_ctx->get_tlog_buffer(), "%sbatch=%ld:%ld", TraceLog::get_logbuffer().buffer, i, task_list.size());
                 ups_result_buffer_.set_data(ups_result_memory_, OB_MAX_PACKET_LENGTH);
                 session_ctx->get_ups_result().serialize(ups_result_buffer_.get_data(),
                                                         ups_result_buffer_.get_capacity(),
@@ -1347,13 +1431,31 @@ namespace oceanbase
             task = NULL;
           }
         }
-        uncommited_session_list_.clear();
+        task_list.clear();
         OB_STAT_INC(UPDATESERVER, UPS_STAT_BATCH_COUNT, 1);
-        OB_STAT_INC(UPDATESERVER, UPS_STAT_BATCH_TIMEU, tbsys::CTimeUtil::getTime() - batch_start_time());
-        batch_start_time() = 0;
+        OB_STAT_INC(UPDATESERVER, UPS_STAT_BATCH_TIMEU, tbsys::CTimeUtil::getTime() - flush_task->batch_start_time);
+        flush_task->batch_start_time = 0;
+        flush_cond_.lock();
+        flush_task->is_flying = false;
+        flush_cond_.broadcast();
+        flush_cond_.unlock();
       }
-      try_submit_auto_freeze_();
-      return ret;
+    }
+
+    // 批量提交的大小按照Little定律估计：一次刷盘期间到达的事务数 = 到达速率 * 刷盘耗时
+    // 刷盘慢或者压力大时攒更大的批，减少fsync次数；压力小时批量上限降低，减少等待
+    // 两个量都取滑动平均(1/8的权重)，结果限制在[MIN_BATCH_NUM, MAX_BATCH_NUM]内，留两倍余量
+    void TransExecutor::update_batch_limit_(const int64_t batch_num, const int64_t flush_start_time, const int64_t flush_elapse)
+    {
+      flush_elapse_us_ = (0 == flush_elapse_us_) ? flush_elapse : (flush_elapse_us_ * 7 + flush_elapse) / 8;
+      if (0 < last_flush_start_time_ && last_flush_start_time_ < flush_start_time)
+      {
+        int64_t rate = batch_num * 1000000 / (flush_start_time - last_flush_start_time_);
+        arrival_rate_ = (0 == arrival_rate_) ? rate : (arrival_rate_ * 7 + rate) / 8;
+        int64_t limit = 2 * arrival_rate_ * flush_elapse_us_ / 1000000;
+        batch_limit_ = (MIN_BATCH_NUM > limit) ? MIN_BATCH_NUM : ((MAX_BATCH_NUM < limit) ? MAX_BATCH_NUM : limit);
+      }
+      last_flush_start_time_ = flush_start_time;
     }
 
     void TransExecutor::try_submit_auto_freeze_()
@@ -1408,6 +1510,8 @@ namespace oceanbase
       TBSYS_LOG(INFO, "queued_num trans_thread=%ld commit_thread=%ld",
                 TransHandlePool::get_queued_num(),
                 TransCommitThread::get_queued_num());
+      TBSYS_LOG(INFO, "group commit batch_limit=%ld flush_elapse=%ld arrival_rate=%ld",
+                batch_limit_, flush_elapse_us_, arrival_rate_);
       TBSYS_LOG(INFO, "==========log trans executor end==========");
     }
 
@@ -1511,6 +1615,14 @@ namespace oceanbase
       return true;
     }
 
+    bool TransExecutor::thandle_compact_hot_rows(TransExecutor &host, Task &task, TransParamData &pdata)
+    {
+      UNUSED(task);
+      UNUSED(pdata);
+      host.handle_compact_hot_rows_();
+      return true;
+    }
+
     bool TransExecutor::thandle_show_sessions(TransExecutor &host, Task &task, TransParamData &pdata)
     {
       pdata.buffer.get_position() = 0;
@@ -97,7 +97,21 @@ namespace oceanbase
         virtual int64_t get_seq(void* task) = 0;
     };
 
-    class TransExecutor : public TransHandlePool, public TransCommitThread
+    class TransFlushThread : public M2SQueueThread
+    {
+      public:
+        TransFlushThread() {};
+        virtual ~TransFlushThread() {};
+      public:
+        void handle(void *ptask, void *pdata)
+        {
+          handle_flush(ptask, pdata);
+        };
+      public:
+        virtual void handle_flush(void *ptask, void *pdata) = 0;
+    };
+
+    class TransExecutor : public TransHandlePool, public TransCommitThread, public TransFlushThread
     {
       struct TransParamData
       {
@@ -132,7 +146,17 @@ namespace oceanbase
           sid.reset();
         };
       };
+      // commit线程摘下一批日志后交给flush线程写盘、同步备机、结束session
+      // 两个批次轮流使用: 一批在刷盘时commit线程可以继续序列化下一批
+      struct FlushTask
+      {
+        FlushTask() : task_list(), batch_start_time(0), is_flying(false) {};
+        common::ObList<Task*> task_list;
+        int64_t batch_start_time;
+        volatile bool is_flying;
+      };
       static const int64_t TASK_QUEUE_LIMIT = 100000;
+      static const int64_t FLUSH_TASK_NUM = 2;
       static const int64_t FINISH_THREAD_IDLE = 5000;
       static const int64_t ALLOCATOR_TOTAL_LIMIT = 1L * 1024L * 1024L * 1024L;
       static const int64_t ALLOCATOR_HOLD_LIMIT = ALLOCATOR_TOTAL_LIMIT / 2;
@@ -142,7 +166,9 @@ namespace oceanbase
       static const int64_t MAX_RW_NUM = 20000;
       static const int64_t QUERY_TIMEOUT_RESERVE = 50000;
       static const int64_t TRY_FREEZE_INTERVAL = 1000000;
-      static const int64_t MAX_BATCH_NUM = 500;
+      static const int64_t MIN_BATCH_NUM = 32;
+      static const int64_t DEFAULT_BATCH_NUM = 500;
+      static const int64_t MAX_BATCH_NUM = 4096;
       typedef void (*packet_handler_pt)(common::ObPacket &pkt, common::ObDataBuffer &buffer);
       typedef bool (*trans_handler_pt)(TransExecutor &host, Task &task, TransParamData &pdata);
       typedef bool (*commit_handler_pt)(TransExecutor &host, Task &task, CommitParamData &pdata);
@@ -166,6 +192,8 @@ namespace oceanbase
         void on_commit_idle();
         int64_t get_seq(void* ptr);
 
+        void handle_flush(void *ptask, void *pdata);
+
         SessionMgr &get_session_mgr() {return session_mgr_;};
         LockMgr &get_lock_mgr() {return lock_mgr_;};
         void log_trans_info() const;
@@ -196,6 +224,7 @@ namespace oceanbase
                                 common::ObCellNewScanner &new_scanner,
                                 common::ObDataBuffer &buffer);
         void handle_kill_zombie_();
+        void handle_compact_hot_rows_();
         void handle_show_sessions_(common::ObPacket &pkt,
                                   common::ObNewScanner &scanner,
                                   common::ObDataBuffer &buffer);
@@ -206,7 +235,10 @@ namespace oceanbase
 
         int handle_write_commit_(Task &task);
         int fill_log_(Task &task, RWSessionCtx &session_ctx);
+        int submit_log_();
         int commit_log_();
+        void wait_flush_task_(FlushTask &flush_task);
+        void update_batch_limit_(const int64_t batch_num, const int64_t flush_start_time, const int64_t flush_elapse);
         void try_submit_auto_freeze_();
       private:
         static void phandle_non_impl(common::ObPacket &pkt, ObDataBuffer &buffer);
@@ -220,6 +252,7 @@ namespace oceanbase
         static bool thandle_write_trans(TransExecutor &host, Task &task, TransParamData &pdata);
         static bool thandle_start_session(TransExecutor &host, Task &task, TransParamData &pdata);
         static bool thandle_kill_zombie(TransExecutor &host, Task &task, TransParamData &pdata);
+        static bool thandle_compact_hot_rows(TransExecutor &host, Task &task, TransParamData &pdata);
         static bool thandle_show_sessions(TransExecutor &host, Task &task, TransParamData &pdata);
         static bool thandle_kill_session(TransExecutor &host, Task &task, TransParamData &pdata);
         static bool thandle_end_session(TransExecutor &host, Task &task, TransParamData &pdata);
@@ -245,7 +278,14 @@ namespace oceanbase
         LockMgr lock_mgr_;
         ObSpinLock write_clog_mutex_;
 
-        common::ObList<Task*> uncommited_session_list_;
+        FlushTask flush_task_[FLUSH_TASK_NUM];
+        int64_t cur_flush_task_;          // commit线程正在填充的批次，只在commit线程中修改
+        tbsys::CThreadCond flush_cond_;
+        // 根据刷盘耗时自适应调整的批量提交上限，只在flush线程中修改
+        volatile int64_t batch_limit_;
+        int64_t flush_elapse_us_;         // 刷盘耗时的滑动平均
+        int64_t arrival_rate_;            // 每秒进入commit线程的事务数的滑动平均
+        int64_t last_flush_start_time_;
         char ups_result_memory_[OB_MAX_PACKET_LENGTH];
         common::ObDataBuffer ups_result_buffer_;
     };
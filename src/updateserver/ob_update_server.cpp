@@ -222,6 +222,7 @@ namespace oceanbase
           if (OB_SUCCESS == table_mgr_.get_memtable_attr(memtable_attr))
           {
             memtable_attr.total_memlimit = config_.table_memory_limit;
+            memtable_attr.hot_row_cell_num = config_.hot_row_cell_num;
             table_mgr_.set_memtable_attr(memtable_attr);
           }
           else
@@ -539,6 +540,13 @@ namespace oceanbase
         }
       }
       if (OB_SUCCESS == err)
+      {
+        if (OB_SUCCESS != (err = set_timer_compact_hot_rows()))
+        {
+          TBSYS_LOG(WARN, "fail to set timer to compact hot rows. err=%d", err);
+        }
+      }
+      if (OB_SUCCESS == err)
       {
         if (OB_SUCCESS != (err = set_timer_time_update()))
         {
@@ -1082,6 +1090,20 @@ namespace oceanbase
       return err;
     }
 
+    int ObUpdateServer::set_timer_compact_hot_rows()
+    {
+      int err = OB_SUCCESS;
+
+      bool repeat = true;
+      err = timer_.schedule(compact_hot_rows_duty_, CompactHotRowsDuty::SCHEDULE_PERIOD, repeat);
+      if (OB_SUCCESS != err)
+      {
+        TBSYS_LOG(WARN, "schedule compact_hot_rows_duty fail err=%d", err);
+      }
+
+      return err;
+    }
+
     int ObUpdateServer::set_timer_handle_fronzen()
     {
       int err = OB_SUCCESS;
@@ -3693,6 +3715,10 @@ namespace oceanbase
       table_mgr_.update_merged_version(ups_rpc_stub_, root_server_, config_.resp_root_timeout);
       bool force = false;
       table_mgr_.erase_sstable(force);
+      if (config_.using_frozen_memtable_bloomfilter)
+      {
+        table_mgr_.build_frozen_bloomfilter();
+      }
       bool store_all = false;
       table_mgr_.store_memtable(store_all);
       table_mgr_.log_table_info();
@@ -4138,6 +4164,11 @@ namespace oceanbase
       return submit_async_task_(OB_UPS_ASYNC_KILL_ZOMBIE, write_thread_queue_, write_task_queue_size_);
     }
 
+    int ObUpdateServer::submit_compact_hot_rows()
+    {
+      return submit_async_task_(OB_UPS_ASYNC_COMPACT_HOT_ROWS, write_thread_queue_, write_task_queue_size_);
+    }
+
     void ObUpdateServer::schedule_warm_up_duty()
     {
       int ret = OB_SUCCESS;
@@ -4993,13 +5024,19 @@ namespace oceanbase
       g_conf.using_hash_index = (0 != config_.using_hash_index);
       TBSYS_LOG(INFO, "set using_hash_index=%s", STR_BOOL(g_conf.using_hash_index));
 
+      if (OB_SUCCESS == set_no_hash_index_tables(config_.no_hash_index_tables))
+      {
+        TBSYS_LOG(INFO, "set no_hash_index_tables=[%s]", config_.no_hash_index_tables.str());
+      }
+
       MemTableAttr memtable_attr;
       if (OB_SUCCESS == table_mgr_.get_memtable_attr(memtable_attr))
       {
         memtable_attr.total_memlimit = config_.table_memory_limit;
+        memtable_attr.hot_row_cell_num = config_.hot_row_cell_num;
         table_mgr_.set_memtable_attr(memtable_attr);
-        TBSYS_LOG(INFO, "set_memtable_attr table_memory_limit=%s",
-                  config_.table_memory_limit.str());
+        TBSYS_LOG(INFO, "set_memtable_attr table_memory_limit=%s hot_row_cell_num=%s",
+                  config_.table_memory_limit.str(), config_.hot_row_cell_num.str());
       }
 
       if (static_cast<int64_t>(config_.low_priv_cur_percent) >= 0)
@@ -301,6 +301,7 @@ namespace oceanbase
         int submit_fake_write_for_keep_alive();
         int submit_update_schema();
         int submit_kill_zombie();
+        int submit_compact_hot_rows();
 
         void schedule_warm_up_duty();
         int submit_load_bypass(const common::ObPacket *packet);
@@ -322,6 +323,7 @@ namespace oceanbase
         //int set_schema();
         int set_timer_major_freeze();
         int set_timer_kill_zombie();
+        int set_timer_compact_hot_rows();
         int set_timer_handle_fronzen();
         int set_timer_refresh_lsync_addr();
         int set_timer_switch_skey();
@@ -638,6 +640,7 @@ namespace oceanbase
         ObUpsCheckKeepAliveTask check_keep_alive_duty_;
         ObUpsGrantKeepAliveTask grant_keep_alive_duty_;
         KillZombieDuty kill_zombie_duty_;
+        CompactHotRowsDuty compact_hot_rows_duty_;
         ObUpsLeaseTask ups_lease_task_;
         common::ObTimer timer_;
         common::ObTimer config_timer_;
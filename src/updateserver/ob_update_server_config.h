@@ -127,6 +127,7 @@ namespace oceanbase
         DEF_TIME(sstable_time_limit, "7d", "remove from memory and dump to trash directory if sstable stay in memory such time");
         DEF_STR(sstable_compressor_name, "none", "sstable compressor name");
         DEF_CAP(sstable_block_size, "4K", "sstable block size");
+        DEF_INT(sstable_dump_thread_num, "4", "[1,16]", "number of threads to read and compact the rows of a frozen memtable by key range when dumping it to sstable");
         DEF_MOMENT(major_freeze_duty_time, "Disable", OB_CONFIG_DYNAMIC, "major freeze duty time");
         DEF_TIME(min_major_freeze_interval, "1s", "minimal time to generate major freeze version");
         DEF_BOOL(replay_checksum_flag, "True", "memtable checksum when replay");
@@ -135,11 +136,13 @@ namespace oceanbase
         DEF_TIME(lsync_fetch_timeout, "5s", "fetch commit log timeout from lsync or master ups");
         DEF_TIME(refresh_lsync_addr_interval, "60s", "interval of slave to refresh lsyncserver-address");
         DEF_INT(max_row_cell_num, "256", "compact cell when cell of row beyond this valud");
+        DEF_INT(hot_row_cell_num, "32", "[0,]", "compact cell of row in background when cell of row beyond this value, 0 to disable");
         DEF_CAP(table_available_warn_size, "0", "try drop frozen table if available table memory less than this value"); /* calc later */
         DEF_CAP(table_available_error_size, "0", "force drop frozen table and give an alarm if available table memory less than this value"); /* calc later */
 
         DEF_TIME(warm_up_time, "10m", "[10s,30m]", "sstable warm up time");
         DEF_BOOL(using_memtable_bloomfilter, "False", "using memtable bloomfilter");
+        DEF_BOOL(using_frozen_memtable_bloomfilter, "True", "build rowkey bloomfilter for frozen memtable to skip gets of non-existent rows");
         DEF_BOOL(write_sstable_use_dio, "True", "write sstable use dio");
 
         DEF_TIME(keep_alive_timeout, "5s", "keep alive timeout");
@@ -149,6 +152,7 @@ namespace oceanbase
 
         DEF_BOOL(using_static_cm_column_id, "False", "should treat 2 and 3 as create_time and modify_time column id");
         DEF_BOOL(using_hash_index, "True", "using hash index");
+        DEF_STR(no_hash_index_tables, "", "comma separated ids of tables only indexed by btree in memtable, saves memory of narrow rows");
 
         DEF_INT(log_cache_n_block, "4", "number of blocks of log cache");
         DEF_CAP(log_cache_block_size, "32MB", "size of per-block of log cache");
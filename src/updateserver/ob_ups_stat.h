@@ -43,6 +43,7 @@ namespace oceanbase
         set_id2name(common::OB_STAT_COMMON, common::ObStatSingleton::common_map, common::COMMON_STAT_MAX);
         set_id2name(common::OB_STAT_SQL, common::ObStatSingleton::sql_map, common::SQL_STAT_MAX);
         set_id2name(common::OB_STAT_SSTABLE, common::ObStatSingleton::sstable_map, common::SSTABLE_STAT_MAX);
+        set_id2name(common::OB_STAT_MEMTABLE, common::ObStatSingleton::memtable_map, common::MEMTABLE_STAT_MAX);
       }
     };
   }
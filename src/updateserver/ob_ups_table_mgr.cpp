@@ -205,6 +205,32 @@ namespace oceanbase
       while (all && need2dump);
     }
 
+    void ObUpsTableMgr :: build_frozen_bloomfilter()
+    {
+      while (table_mgr_.try_build_frozen_bloomfilter())
+      {
+      }
+    }
+
+    void ObUpsTableMgr :: compact_hot_rows(SessionMgr &session_mgr)
+    {
+      int ret = OB_SUCCESS;
+      TableItem *table_item = NULL;
+      int64_t compacted_row_num = 0;
+      if (NULL == (table_item = table_mgr_.get_active_memtable()))
+      {
+        TBSYS_LOG(WARN, "failed to acquire active memtable");
+      }
+      else
+      {
+        if (OB_SUCCESS != (ret = table_item->get_memtable().compact_hot_rows(session_mgr, compacted_row_num)))
+        {
+          TBSYS_LOG(WARN, "compact hot rows fail ret=%d", ret);
+        }
+        table_mgr_.revert_active_memtable(table_item);
+      }
+    }
+
     bool ObUpsTableMgr :: need_auto_freeze() const
     {
       return table_mgr_.need_auto_freeze();
@@ -272,6 +272,8 @@ namespace oceanbase
         int freeze_memtable(const TableMgr::FreezeType freeze_type, uint64_t &frozen_version, bool &report_version_changed,
                             const common::ObPacket *resp_packet = NULL);
         void store_memtable(const bool all);
+        void build_frozen_bloomfilter();
+        void compact_hot_rows(SessionMgr &session_mgr);
         void drop_memtable(const bool force);
         void erase_sstable(const bool force);
         void get_memtable_memory_info(TableMemInfo &mem_info);
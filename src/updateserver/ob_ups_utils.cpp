@@ -40,7 +40,48 @@ namespace oceanbase
   {
     using namespace oceanbase::common;
     Dummy __dummy__;
-    GConf g_conf = {true, 0, true};
+    GConf g_conf = {true, 0, true, 0, {0}};
+
+    int set_no_hash_index_tables(const char *str)
+    {
+      int ret = OB_SUCCESS;
+      uint64_t tables[MAX_NO_HASH_INDEX_TABLE_NUM];
+      int64_t table_num = 0;
+      const char *iter = str;
+      while (OB_SUCCESS == ret
+            && NULL != iter
+            && '\0' != *iter)
+      {
+        char *end = NULL;
+        uint64_t table_id = strtoul(iter, &end, 10);
+        if (end == iter
+            || (',' != *end && '\0' != *end)
+            || OB_INVALID_ID == table_id)
+        {
+          TBSYS_LOG(WARN, "invalid table id list [%s]", str);
+          ret = OB_INVALID_ARGUMENT;
+        }
+        else if (MAX_NO_HASH_INDEX_TABLE_NUM <= table_num)
+        {
+          TBSYS_LOG(WARN, "too many tables [%s] max=%ld", str, MAX_NO_HASH_INDEX_TABLE_NUM);
+          ret = OB_SIZE_OVERFLOW;
+        }
+        else
+        {
+          tables[table_num++] = table_id;
+          iter = (',' == *end) ? end + 1 : end;
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        g_conf.no_hash_index_table_num = 0;
+        __sync_synchronize();
+        memcpy(g_conf.no_hash_index_tables, tables, table_num * sizeof(tables[0]));
+        __sync_synchronize();
+        g_conf.no_hash_index_table_num = table_num;
+      }
+      return ret;
+    }
 
     template <>
     int ups_serialize<uint64_t>(const uint64_t &data, char *buf, const int64_t data_len, int64_t& pos)
@@ -81,13 +81,19 @@ namespace oceanbase
     extern void set_client_mgr_err(const int err);
     extern int64_t get_memtable_hash_buckets_size();
 
+    static const int64_t MAX_NO_HASH_INDEX_TABLE_NUM = 64;
     struct GConf
     {
       bool using_static_cm_column_id;
       volatile int64_t global_schema_version;
       bool using_hash_index;
+      // 只建btree索引不建hash索引的表，在新的活跃memtable上生效
+      volatile int64_t no_hash_index_table_num;
+      uint64_t no_hash_index_tables[MAX_NO_HASH_INDEX_TABLE_NUM];
     };
     extern GConf g_conf;
+    // @param str 逗号分隔的table id列表
+    extern int set_no_hash_index_tables(const char *str);
 
 #define OB_UPS_CREATE_TIME_COLUMN_ID(table_id) \
     ({ \
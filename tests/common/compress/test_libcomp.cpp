@@ -126,6 +126,171 @@ TEST(TestLibcomp, compress_snappy)
   }
 }
 
+static char *load_data(int64_t &size)
+{
+  const char *fname = "./data/comp.data";
+  struct stat st;
+  char *buffer = NULL;
+  FILE *fd = fopen(fname, "r");
+  if (NULL != fd && 0 == stat(fname, &st))
+  {
+    buffer = new char[st.st_size];
+    size = fread(buffer, sizeof(char), st.st_size, fd);
+  }
+  if (NULL != fd)
+  {
+    fclose(fd);
+  }
+  return buffer;
+}
+
+static void check_compress(ObCompressor *comp, const char *src_buffer, const int64_t src_size)
+{
+  int64_t buffer_size = src_size + comp->get_max_overflow_size(src_size);
+  char *comp_buffer = new char[buffer_size];
+  char *decomp_buffer = new char[src_size];
+  int64_t comp_size = 0;
+  int64_t decomp_size = 0;
+
+  EXPECT_EQ(ObCompressor::COM_E_OVERFLOW, comp->compress(src_buffer, src_size, comp_buffer, src_size, comp_size));
+  ASSERT_EQ(ObCompressor::COM_E_NOERROR, comp->compress(src_buffer, src_size, comp_buffer, buffer_size, comp_size));
+  ASSERT_EQ(ObCompressor::COM_E_NOERROR, comp->decompress(comp_buffer, comp_size, decomp_buffer, src_size, decomp_size));
+  EXPECT_EQ(src_size, decomp_size);
+  EXPECT_EQ(0, memcmp(decomp_buffer, src_buffer, src_size));
+
+  EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->compress(NULL, 1, NULL, 1, comp_size));
+  EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->compress(src_buffer, 0, comp_buffer, 0, comp_size));
+  EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->decompress(NULL, 1, NULL, 1, decomp_size));
+  EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->decompress(comp_buffer, -1, decomp_buffer, -1, decomp_size));
+  // 截断的数据和放不下的结果都不能越界
+  EXPECT_NE(ObCompressor::COM_E_NOERROR, comp->decompress(comp_buffer, comp_size / 2, decomp_buffer, src_size, decomp_size));
+  EXPECT_NE(ObCompressor::COM_E_NOERROR, comp->decompress(comp_buffer, comp_size, decomp_buffer, src_size - 1, decomp_size));
+
+  EXPECT_EQ(((int64_t)1)<<48, comp->get_interface_ver());
+  delete[] decomp_buffer;
+  delete[] comp_buffer;
+}
+
+TEST(TestLibcomp, compress_lz4)
+{
+  int64_t size = 0;
+  char *src_buffer = load_data(size);
+  ASSERT_TRUE(NULL != src_buffer);
+
+  ObCompressor *comp = create_compressor("lz4_1.0");
+  ASSERT_TRUE(NULL != comp);
+  EXPECT_EQ(0, strcmp("lz4_1.0", comp->get_compressor_name()));
+  check_compress(comp, src_buffer, size);
+  EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->set_compress_level(100));
+  EXPECT_EQ(ObCompressor::COM_E_NOERROR, comp->set_compress_level(9));
+  check_compress(comp, src_buffer, size);
+  destroy_compressor(comp);
+
+  // HC压缩的数据可以用默认实例解压
+  ASSERT_TRUE(NULL != (comp = create_compressor("lz4_1.0@level=9")));
+  check_compress(comp, src_buffer, size);
+  destroy_compressor(comp);
+  delete[] src_buffer;
+}
+
+TEST(TestLibcomp, compress_zstd)
+{
+  int64_t size = 0;
+  char *src_buffer = load_data(size);
+  ASSERT_TRUE(NULL != src_buffer);
+
+  ObCompressor *comp = create_compressor("zstd_1.0");
+  ASSERT_TRUE(NULL != comp);
+  EXPECT_EQ(0, strcmp("zstd_1.0", comp->get_compressor_name()));
+  check_compress(comp, src_buffer, size);
+  EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->set_compress_level(0));
+  EXPECT_EQ(ObCompressor::COM_E_INVALID_PARAM, comp->set_compress_level(100));
+  EXPECT_EQ(ObCompressor::COM_E_NOERROR, comp->set_compress_level(19));
+  check_compress(comp, src_buffer, size);
+  destroy_compressor(comp);
+  delete[] src_buffer;
+}
+
+static int64_t gen_rows(char *buffer, const int64_t size, const int64_t start)
+{
+  int64_t pos = 0;
+  for (int64_t i = start; pos + 128 < size; i++)
+  {
+    pos += snprintf(buffer + pos, size - pos, "%ld|user_%ld|2012-08-%02ld 10:00:00|shanghai|alipay.com|%ld\n",
+                    i, i * 7 % 100000, i % 28 + 1, i * 31);
+  }
+  return pos;
+}
+
+TEST(TestLibcomp, compress_zstd_dictionary)
+{
+  // 字典和数据都是相似的行，数据块很小的时候字典效果明显
+  const int64_t block_size = 4096;
+  char dict[16384];
+  char block[block_size];
+  int64_t dict_size = gen_rows(dict, sizeof(dict), 0);
+  int64_t data_size = gen_rows(block, block_size, 100000);
+  const char *dict_file = "./zstd_test.dict";
+  FILE *fd = fopen(dict_file, "w");
+  ASSERT_TRUE(NULL != fd);
+  ASSERT_EQ(dict_size, (int64_t)fwrite(dict, 1, dict_size, fd));
+  fclose(fd);
+
+  char name[MAX_LIB_NAME_LENGTH];
+  snprintf(name, sizeof(name), "zstd_1.0@level=5,dict=%s", dict_file);
+  ObCompressor *dict_comp = create_compressor(name);
+  ObCompressor *comp = create_compressor("zstd_1.0@level=5");
+  ASSERT_TRUE(NULL != dict_comp);
+  ASSERT_TRUE(NULL != comp);
+  check_compress(dict_comp, block, data_size);
+  // 设置字典之后再改level
+  EXPECT_EQ(ObCompressor::COM_E_NOERROR, dict_comp->set_compress_level(19));
+  check_compress(dict_comp, block, data_size);
+
+  char comp_buffer[block_size * 2];
+  int64_t dict_comp_size = 0;
+  int64_t comp_size = 0;
+  ASSERT_EQ(ObCompressor::COM_E_NOERROR, dict_comp->compress(block, data_size, comp_buffer, sizeof(comp_buffer), dict_comp_size));
+  ASSERT_EQ(ObCompressor::COM_E_NOERROR, comp->compress(block, data_size, comp_buffer, sizeof(comp_buffer), comp_size));
+  fprintf(stderr, "zstd size=%ld compressed=%ld with_dict=%ld\n", data_size, comp_size, dict_comp_size);
+  EXPECT_GT(comp_size, dict_comp_size);
+
+  // 同一个字典的实例是共享的，最后一个使用者销毁
+  ObCompressor *shared_comp = create_compressor(name);
+  ObCompressor *dict_decomp = create_decompressor(name);
+  EXPECT_TRUE(dict_comp == shared_comp);
+  EXPECT_TRUE(dict_comp == dict_decomp);
+  destroy_compressor(shared_comp);
+  destroy_compressor(dict_decomp);
+  check_compress(dict_comp, block, data_size);
+  destroy_compressor(dict_comp);
+
+  // 字典文件不存在时，解压实例还能解压没有用字典压缩的数据
+  char missing_name[MAX_LIB_NAME_LENGTH];
+  snprintf(missing_name, sizeof(missing_name), "zstd_1.0@level=5,dict=./not_exist.dict");
+  ObCompressor *missing_decomp = create_decompressor(missing_name);
+  ASSERT_TRUE(NULL != missing_decomp);
+  char decomp_buffer[block_size];
+  int64_t decomp_size = 0;
+  ASSERT_EQ(ObCompressor::COM_E_NOERROR, comp->compress(block, data_size, comp_buffer, sizeof(comp_buffer), comp_size));
+  ASSERT_EQ(ObCompressor::COM_E_NOERROR, missing_decomp->decompress(comp_buffer, comp_size, decomp_buffer, sizeof(decomp_buffer), decomp_size));
+  EXPECT_EQ(data_size, decomp_size);
+  EXPECT_EQ(0, memcmp(block, decomp_buffer, data_size));
+  ASSERT_TRUE(NULL != (dict_comp = create_compressor(name)));
+  ASSERT_EQ(ObCompressor::COM_E_NOERROR, dict_comp->compress(block, data_size, comp_buffer, sizeof(comp_buffer), dict_comp_size));
+  EXPECT_EQ(ObCompressor::COM_E_DATAERROR, missing_decomp->decompress(comp_buffer, dict_comp_size, decomp_buffer, sizeof(decomp_buffer), decomp_size));
+  destroy_compressor(missing_decomp);
+  destroy_compressor(dict_comp);
+  destroy_compressor(comp);
+
+  EXPECT_TRUE(NULL == create_compressor("zstd_1.0@dict=./not_exist.dict"));
+  EXPECT_TRUE(NULL == create_compressor("zstd_1.0@level=abc"));
+  EXPECT_TRUE(NULL == create_compressor("zstd_1.0@unknown=1"));
+  EXPECT_TRUE(NULL == create_compressor("lz4_1.0@dict=./zstd_test.dict"));
+  EXPECT_TRUE(NULL == create_compressor("none@level=1"));
+  unlink(dict_file);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc,argv);
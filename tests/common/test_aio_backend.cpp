@@ -0,0 +1,151 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "ob_malloc.h"
+#include "ob_aio_backend.h"
+
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace common;
+
+static const char *fname = "./test_aio_backend.data";
+static const int64_t block_size = 4096;
+static const int64_t block_num = 8;
+
+class TestAIOBackend : public ::testing::Test
+{
+  public:
+    virtual void SetUp()
+    {
+      char buf[block_size];
+      int fd = ::open(fname, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+      ASSERT_TRUE(fd >= 0);
+      for (int64_t i = 0; i < block_num; ++i)
+      {
+        memset(buf, static_cast<int>('a' + i), block_size);
+        ASSERT_EQ(block_size, ::write(fd, buf, block_size));
+      }
+      // half block at the end of the file
+      ASSERT_EQ(block_size / 2, ::write(fd, buf, block_size / 2));
+      ::close(fd);
+      fd_ = ::open(fname, O_RDONLY);
+      ASSERT_TRUE(fd_ >= 0);
+    }
+    virtual void TearDown()
+    {
+      ::close(fd_);
+      ::unlink(fname);
+    }
+    void read_blocks(ObAIOBackend &backend)
+    {
+      char bufs[block_num][block_size];
+      ObAIOEvent events[block_num + 1];
+      int64_t event_nr = 0;
+      int64_t total_nr = 0;
+      for (int64_t i = 0; i < block_num; ++i)
+      {
+        ASSERT_EQ(OB_SUCCESS, backend.prep_pread(fd_, bufs[i], block_size,
+                                                 i * block_size, bufs[i]));
+      }
+      ASSERT_EQ(OB_SUCCESS, backend.submit());
+      while (total_nr < block_num)
+      {
+        ASSERT_EQ(OB_SUCCESS, backend.get_events(1, block_num + 1, events + total_nr,
+                                                 1000000, event_nr));
+        ASSERT_LT(0, event_nr);
+        total_nr += event_nr;
+      }
+      ASSERT_EQ(block_num, total_nr);
+      for (int64_t i = 0; i < total_nr; ++i)
+      {
+        char *buf = static_cast<char*>(events[i].data_);
+        int64_t idx = (buf - bufs[0]) / block_size;
+        ASSERT_EQ(block_size, events[i].res_);
+        ASSERT_EQ('a' + idx, buf[0]);
+        ASSERT_EQ('a' + idx, buf[block_size - 1]);
+      }
+
+      // short read at the end of file
+      ASSERT_EQ(OB_SUCCESS, backend.prep_pread(fd_, bufs[0], block_size,
+                                               block_num * block_size, bufs[0]));
+      ASSERT_EQ(OB_SUCCESS, backend.submit());
+      ASSERT_EQ(OB_SUCCESS, backend.get_events(1, 1, events, 1000000, event_nr));
+      ASSERT_EQ(1, event_nr);
+      ASSERT_EQ(block_size / 2, events[0].res_);
+
+      // timeout without any request
+      ASSERT_EQ(OB_SUCCESS, backend.get_events(1, 1, events, 10000, event_nr));
+      ASSERT_EQ(0, event_nr);
+    }
+  protected:
+    int fd_;
+};
+
+TEST_F(TestAIOBackend, libaio)
+{
+  ObLibAIOBackend backend;
+  ASSERT_EQ(OB_SUCCESS, backend.init(64));
+  read_blocks(backend);
+}
+
+#ifdef OB_HAVE_IO_URING
+TEST_F(TestAIOBackend, io_uring)
+{
+  ObIOUringBackend backend;
+  if (OB_SUCCESS != backend.init(64))
+  {
+    fprintf(stderr, "io_uring isn't supported by the kernel, skip\n");
+  }
+  else
+  {
+    read_blocks(backend);
+  }
+}
+#endif
+
+TEST_F(TestAIOBackend, create)
+{
+  const int64_t max_queue_depth = ObAIOBackend::MAX_QUEUE_DEPTH;
+  // io_uring is opt-in
+  ObAIOBackend *backend = ObAIOBackend::create(64);
+  ASSERT_TRUE(NULL != backend);
+  EXPECT_EQ(AIO_BACKEND_LIBAIO, backend->get_type());
+  ObAIOBackend::destroy(backend);
+
+  ObAIOBackend::set_config(AIO_BACKEND_LIBAIO, 100);
+  EXPECT_EQ(max_queue_depth, ObAIOBackend::get_queue_depth());
+  backend = ObAIOBackend::create(64);
+  ASSERT_TRUE(NULL != backend);
+  EXPECT_EQ(AIO_BACKEND_LIBAIO, backend->get_type());
+  EXPECT_EQ(1, backend->get_read_queue_depth());
+  read_blocks(*backend);
+  ObAIOBackend::destroy(backend);
+
+  // the read queue depth is fixed when the backend is created
+  backend = ObAIOBackend::create(64, 4);
+  ASSERT_TRUE(NULL != backend);
+  ObAIOBackend::set_config(AIO_BACKEND_LIBAIO, 8);
+  EXPECT_EQ(4, backend->get_read_queue_depth());
+  ObAIOBackend::destroy(backend);
+  backend = ObAIOBackend::create(64, 100);
+  ASSERT_TRUE(NULL != backend);
+  EXPECT_EQ(max_queue_depth, backend->get_read_queue_depth());
+  ObAIOBackend::destroy(backend);
+
+  // falls back to libaio if io_uring isn't available
+  ObAIOBackend::set_config(AIO_BACKEND_IO_URING, 0);
+  EXPECT_EQ(1, ObAIOBackend::get_queue_depth());
+  backend = ObAIOBackend::create(64);
+  ASSERT_TRUE(NULL != backend);
+  read_blocks(*backend);
+  ObAIOBackend::destroy(backend);
+}
+
+int main(int argc, char** argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,143 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_crc64.cpp
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "common/ob_crc64.h"
+#include "common/ob_malloc.h"
+#include "common/utility.h"
+#include "tbsys.h"
+#include <gtest/gtest.h>
+
+using namespace oceanbase;
+using namespace common;
+
+static const int64_t BUF_SIZE = 2L * 1024 * 1024;
+
+// 逐字节查表，作为其它实现的参照
+static uint64_t crc64_bytewise(uint64_t crc, const void *pv, int64_t cb)
+{
+  const uint64_t *table = ob_get_crc64_table();
+  const uint8_t *pu8 = (const uint8_t *)pv;
+  for (int64_t i = 0; i < cb; i++)
+  {
+    crc = table[(crc ^ pu8[i]) & 0xff] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+class TestCrc64 : public ::testing::Test
+{
+  public:
+    virtual void SetUp()
+    {
+      buf_ = (char*)ob_malloc(BUF_SIZE + 64, ObModIds::TEST);
+      ASSERT_TRUE(NULL != buf_);
+      srandom(static_cast<unsigned int>(time(NULL)));
+      for (int64_t i = 0; i < BUF_SIZE + 64; i++)
+      {
+        buf_[i] = static_cast<char>(random());
+      }
+    }
+    virtual void TearDown()
+    {
+      ob_free(buf_);
+    }
+  protected:
+    char *buf_;
+};
+
+TEST_F(TestCrc64, known_value)
+{
+  // CRC-64-ISO without pre and post inversion
+  EXPECT_EQ(0UL, ob_crc64("", 0));
+  EXPECT_EQ(crc64_bytewise(0, "123456789", 9), ob_crc64("123456789", 9));
+  EXPECT_EQ(crc64_bytewise(0, buf_, BUF_SIZE), ob_crc64(buf_, BUF_SIZE));
+}
+
+TEST_F(TestCrc64, compatible)
+{
+  const bool pclmul = ob_crc64_pclmul_supported();
+  fprintf(stderr, "pclmul_supported=%s\n", STR_BOOL(pclmul));
+  for (int64_t len = 0; len < 1100; len++)
+  {
+    for (int64_t offset = 0; offset < 16; offset += 5)
+    {
+      const uint64_t init = (0 == len % 2) ? 0 : static_cast<uint64_t>(random()) << 32 | random();
+      const uint64_t expected = crc64_bytewise(init, buf_ + offset, len);
+      ASSERT_EQ(expected, ob_crc64_optimized(init, buf_ + offset, len)) << "len=" << len;
+      ASSERT_EQ(expected, ob_crc64(init, buf_ + offset, len)) << "len=" << len;
+      if (pclmul)
+      {
+        ASSERT_EQ(expected, ob_crc64_pclmul(init, buf_ + offset, len)) << "len=" << len;
+      }
+    }
+  }
+  // 分段计算与一次计算的结果一致
+  uint64_t crc = 0;
+  int64_t pos = 0;
+  while (pos < BUF_SIZE)
+  {
+    int64_t len = std::min(BUF_SIZE - pos, static_cast<int64_t>(random() % 10000));
+    crc = ob_crc64(crc, buf_ + pos, len);
+    pos += len;
+  }
+  EXPECT_EQ(crc64_bytewise(0, buf_, BUF_SIZE), crc);
+}
+
+TEST_F(TestCrc64, batch_checksum)
+{
+  ObBatchChecksum *bc = new ObBatchChecksum();
+  for (int64_t pos = 0; pos < BUF_SIZE; pos += 1000)
+  {
+    bc->fill(buf_ + pos, std::min(1000L, BUF_SIZE - pos));
+  }
+  EXPECT_EQ(crc64_bytewise(0, buf_, BUF_SIZE), bc->calc());
+  delete bc;
+}
+
+static void run_perf(const char *name, uint64_t (*func)(uint64_t, const void*, int64_t),
+                     const char *buf, const int64_t len)
+{
+  const int64_t total = 1L << 27;
+  uint64_t crc = 0;
+  int64_t timeu = tbsys::CTimeUtil::getTime();
+  for (int64_t i = 0; i < total / len; i++)
+  {
+    crc = func(crc, buf, len);
+  }
+  timeu = tbsys::CTimeUtil::getTime() - timeu;
+  fprintf(stderr, "%-10s len=%-8ld %8.2f MB/s crc=%lx\n", name, len,
+          (double)total / (double)(timeu + 1), crc);
+}
+
+TEST_F(TestCrc64, perf)
+{
+  const int64_t lens[] = {64, 512, 4096, 65536, BUF_SIZE};
+  for (int64_t i = 0; i < (int64_t)(sizeof(lens) / sizeof(lens[0])); i++)
+  {
+    run_perf("bytewise", crc64_bytewise, buf_, lens[i]);
+    run_perf("optimized", ob_crc64_optimized, buf_, lens[i]);
+    if (ob_crc64_pclmul_supported())
+    {
+      run_perf("pclmul", ob_crc64_pclmul, buf_, lens[i]);
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
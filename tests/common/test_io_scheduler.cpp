@@ -0,0 +1,135 @@
+#include <unistd.h>
+#include <tbsys.h>
+#include "ob_malloc.h"
+#include "ob_io_scheduler.h"
+
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace common;
+
+static const int64_t MB = 1024 * 1024;
+
+class TestIOScheduler : public ::testing::Test
+{
+  public:
+    virtual void SetUp()
+    {
+      set_config(true);
+    }
+    void set_config(const bool enable)
+    {
+      int64_t band_limit[IO_CLASS_NUM];
+      band_limit[IO_CLASS_FOREGROUND] = 0;
+      band_limit[IO_CLASS_MERGE] = 10 * MB;
+      band_limit[IO_CLASS_MIGRATE] = 0;
+      band_limit[IO_CLASS_LOAD] = 8 * MB;
+      ObIOScheduler::get_instance().set_config(enable, 20 * 1000, band_limit, 1 * MB);
+    }
+    int64_t throttle_time(const int64_t disk_no, const int64_t size)
+    {
+      int64_t begin = tbsys::CTimeUtil::getTime();
+      ObIOScheduler::get_instance().throttle(disk_no, size);
+      return tbsys::CTimeUtil::getTime() - begin;
+    }
+};
+
+TEST_F(TestIOScheduler, thread_io_class)
+{
+  EXPECT_EQ(IO_CLASS_FOREGROUND, ObIOScheduler::get_thread_io_class());
+  EXPECT_EQ(-1, ObIOScheduler::get_thread_io_disk());
+  {
+    ObIOClassGuard guard(IO_CLASS_MERGE, 3);
+    EXPECT_EQ(IO_CLASS_MERGE, ObIOScheduler::get_thread_io_class());
+    EXPECT_EQ(3, ObIOScheduler::get_thread_io_disk());
+    {
+      ObIOClassGuard inner_guard(IO_CLASS_LOAD, 4);
+      EXPECT_EQ(IO_CLASS_LOAD, ObIOScheduler::get_thread_io_class());
+      EXPECT_EQ(4, ObIOScheduler::get_thread_io_disk());
+    }
+    EXPECT_EQ(IO_CLASS_MERGE, ObIOScheduler::get_thread_io_class());
+    EXPECT_EQ(3, ObIOScheduler::get_thread_io_disk());
+  }
+  EXPECT_EQ(IO_CLASS_FOREGROUND, ObIOScheduler::get_thread_io_class());
+  EXPECT_EQ(-1, ObIOScheduler::get_thread_io_disk());
+}
+
+TEST_F(TestIOScheduler, foreground_not_throttled)
+{
+  // foreground io, unknown disk and unlimited class never wait
+  EXPECT_GT(50 * 1000, throttle_time(1, 100 * MB));
+  ObIOClassGuard guard(IO_CLASS_MERGE, 1);
+  EXPECT_GT(50 * 1000, throttle_time(-1, 100 * MB));
+  EXPECT_GT(50 * 1000, throttle_time(ObIOScheduler::MAX_DISK_NO + 1, 100 * MB));
+  ObIOClassGuard migrate_guard(IO_CLASS_MIGRATE, 1);
+  EXPECT_GT(50 * 1000, throttle_time(1, 100 * MB));
+  EXPECT_EQ(0, ObIOScheduler::get_instance().get_band_limit(1, IO_CLASS_MIGRATE));
+}
+
+TEST_F(TestIOScheduler, token_bucket)
+{
+  ObIOClassGuard guard(IO_CLASS_MERGE, 2);
+  EXPECT_EQ(10 * MB, ObIOScheduler::get_instance().get_band_limit(2, IO_CLASS_MERGE));
+  // burst of 100ms is available at first
+  EXPECT_GT(50 * 1000, throttle_time(2, 1 * MB));
+  // 1MB more needs about 100ms at 10MB/s
+  int64_t elapsed_us = throttle_time(2, 1 * MB);
+  EXPECT_LT(80 * 1000, elapsed_us);
+  EXPECT_GT(500 * 1000, elapsed_us);
+  // a large io pays its whole debt, in slices of MAX_WAIT_US
+  elapsed_us = throttle_time(2, 15 * MB);
+  EXPECT_LT(1200 * 1000, elapsed_us);
+  EXPECT_GT(2500 * 1000, elapsed_us);
+  // and the paid debt isn't charged again
+  EXPECT_GT(50 * 1000, throttle_time(2, 1));
+
+  set_config(false);
+  EXPECT_GT(50 * 1000, throttle_time(2, 100 * MB));
+}
+
+TEST_F(TestIOScheduler, adjust_band_limit)
+{
+  ObIOScheduler &scheduler = ObIOScheduler::get_instance();
+  ObIOClassGuard guard(IO_CLASS_MERGE, 5);
+  throttle_time(5, 1);
+
+  // slow foreground reads, the background limits are lowered
+  for (int64_t i = 0; i < 10; ++i)
+  {
+    scheduler.begin_foreground_io(5);
+    scheduler.end_foreground_io(5, 100 * 1000);
+  }
+  EXPECT_EQ(100 * 1000, scheduler.get_foreground_latency(5));
+  usleep(ObIOScheduler::ADJUST_INTERVAL_US);
+  throttle_time(5, 1);
+  EXPECT_EQ(5 * MB, scheduler.get_band_limit(5, IO_CLASS_MERGE));
+  EXPECT_EQ(2 * MB, scheduler.get_band_limit(5, IO_CLASS_LOAD));
+
+  // still slow, never lower than the min band limit
+  scheduler.begin_foreground_io(5);
+  scheduler.end_foreground_io(5, 100 * 1000);
+  usleep(ObIOScheduler::ADJUST_INTERVAL_US);
+  throttle_time(5, 1);
+  EXPECT_EQ(5 * MB / 2, scheduler.get_band_limit(5, IO_CLASS_MERGE));
+  EXPECT_EQ(1 * MB, scheduler.get_band_limit(5, IO_CLASS_LOAD));
+
+  // no foreground read, the limits are raised step by step
+  usleep(ObIOScheduler::ADJUST_INTERVAL_US);
+  throttle_time(5, 1);
+  EXPECT_EQ(5 * MB / 2 + 10 * MB / 8, scheduler.get_band_limit(5, IO_CLASS_MERGE));
+  EXPECT_EQ(2 * MB, scheduler.get_band_limit(5, IO_CLASS_LOAD));
+  for (int64_t i = 0; i < 8; ++i)
+  {
+    usleep(ObIOScheduler::ADJUST_INTERVAL_US);
+    throttle_time(5, 1);
+  }
+  EXPECT_EQ(10 * MB, scheduler.get_band_limit(5, IO_CLASS_MERGE));
+  EXPECT_EQ(8 * MB, scheduler.get_band_limit(5, IO_CLASS_LOAD));
+}
+
+int main(int argc, char** argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,156 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_normalized_rowkey.cpp
+ *
+ */
+
+#include "common/ob_malloc.h"
+#include "common/ob_rowkey.h"
+#include "common/ob_normalized_rowkey.h"
+#include "common/utility.h"
+#include <gtest/gtest.h>
+
+using namespace oceanbase;
+using namespace common;
+
+static const int64_t BUF_SIZE = 1024;
+
+static int sign(const int64_t v)
+{
+  return (v > 0) ? 1 : ((v < 0) ? -1 : 0);
+}
+
+class ObNormalizedRowkeyTest: public ::testing::Test
+{
+  public:
+    void check_order(const ObRowkey &r1, const ObRowkey &r2)
+    {
+      char buf1[BUF_SIZE];
+      char buf2[BUF_SIZE];
+      ObNormalizedRowkey n1;
+      ObNormalizedRowkey n2;
+      ASSERT_EQ(OB_SUCCESS, n1.assign(r1, buf1, BUF_SIZE));
+      ASSERT_EQ(OB_SUCCESS, n2.assign(r2, buf2, BUF_SIZE));
+      EXPECT_EQ(sign(r1.compare(r2)), sign(n1.compare(n2))) << to_cstring(r1) << " vs " << to_cstring(r2);
+      EXPECT_EQ(sign(r2.compare(r1)), sign(n2.compare(n1))) << to_cstring(r2) << " vs " << to_cstring(r1);
+    }
+    // every pair of objs, as the only column and followed by another column
+    void check_objs(const ObObj *objs, const int64_t num)
+    {
+      ObObj tail;
+      tail.set_int(0);
+      for (int64_t i = 0; i < num; i++)
+      {
+        for (int64_t j = 0; j < num; j++)
+        {
+          ObObj k1[2] = {objs[i], tail};
+          ObObj k2[2] = {objs[j], tail};
+          check_order(ObRowkey(k1, 1), ObRowkey(k2, 1));
+          check_order(ObRowkey(k1, 2), ObRowkey(k2, 2));
+          check_order(ObRowkey(k1, 1), ObRowkey(k2, 2));
+        }
+      }
+    }
+};
+
+TEST_F(ObNormalizedRowkeyTest, int_and_time)
+{
+  int64_t values[] = {INT64_MIN, INT64_MIN + 1, -1000000, -256, -1, 0, 1, 255, 256, 1000000, INT64_MAX - 1, INT64_MAX};
+  const int64_t num = sizeof(values) / sizeof(values[0]);
+  ObObj objs[num * 2 + 3];
+  for (int64_t i = 0; i < num; i++)
+  {
+    objs[i].set_int(values[i]);
+  }
+  check_objs(objs, num);
+  objs[0].set_datetime(1);
+  objs[1].set_precise_datetime(999999);
+  objs[2].set_precise_datetime(1000000);
+  objs[3].set_createtime(1000001);
+  objs[4].set_modifytime(-1);
+  objs[5].set_datetime(-1);
+  check_objs(objs, 6);
+}
+
+TEST_F(ObNormalizedRowkeyTest, varchar)
+{
+  const char *strs[] = {"", "\0", "\0\0", "\0\1", "\1", "a", "a\0", "a\0b", "a\1", "ab", "abc", "b", "\xff", "\xff\xff"};
+  const int32_t lens[] = {0, 1, 2, 2, 1, 1, 2, 3, 2, 2, 3, 1, 1, 2};
+  const int64_t num = sizeof(strs) / sizeof(strs[0]);
+  ObObj objs[num];
+  for (int64_t i = 0; i < num; i++)
+  {
+    objs[i].set_varchar(ObString(lens[i], lens[i], strs[i]));
+  }
+  check_objs(objs, num);
+}
+
+TEST_F(ObNormalizedRowkeyTest, decimal)
+{
+  const char *strs[] = {"-12345.678", "-100", "-99.99", "-2", "-1.5", "-1.05", "-1", "-0.5", "-0.05",
+    "0", "0.000", "0.05", "0.5", "1", "1.0", "1.05", "1.5", "2", "99.99", "100", "100.00", "12345.678"};
+  const int64_t num = sizeof(strs) / sizeof(strs[0]);
+  ObObj objs[num];
+  for (int64_t i = 0; i < num; i++)
+  {
+    ObNumber n;
+    ASSERT_EQ(OB_SUCCESS, n.from(strs[i]));
+    objs[i].set_decimal(n, 38, n.get_vscale());
+  }
+  check_objs(objs, num);
+}
+
+TEST_F(ObNormalizedRowkeyTest, special_values)
+{
+  ObObj objs[6];
+  objs[0].set_min_value();
+  objs[1].set_null();
+  objs[2].set_int(-1);
+  objs[3].set_int(1);
+  objs[4].set_max_value();
+  objs[5].set_bool(true);
+  check_objs(objs, 5);
+
+  // <min,min,min> == <min>
+  ObObj mins[3];
+  mins[0].set_min_value();
+  mins[1].set_min_value();
+  mins[2].set_int(1);
+  check_order(ObRowkey(mins, 1), ObRowkey(mins, 3));
+  check_order(ObRowkey::MIN_ROWKEY, ObRowkey(mins, 3));
+  check_order(ObRowkey::MAX_ROWKEY, ObRowkey(mins, 3));
+  check_order(ObRowkey(), ObRowkey(mins, 3));
+
+  ObObj bools[2];
+  bools[0].set_bool(false);
+  bools[1].set_bool(true);
+  check_objs(bools, 2);
+}
+
+TEST_F(ObNormalizedRowkeyTest, not_supported)
+{
+  char buf[BUF_SIZE];
+  ObNormalizedRowkey n;
+  ObObj obj;
+  obj.set_double(1.0);
+  EXPECT_EQ(OB_NOT_SUPPORTED, n.assign(ObRowkey(&obj, 1), buf, BUF_SIZE));
+  EXPECT_FALSE(n.is_valid());
+  obj.set_varchar(ObString::make_string("abcdefgh"));
+  EXPECT_EQ(OB_SIZE_OVERFLOW, n.assign(ObRowkey(&obj, 1), buf, 8));
+  EXPECT_EQ(OB_SUCCESS, n.assign(ObRowkey(&obj, 1), buf, 11));
+  EXPECT_EQ(11, n.length());
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -87,6 +87,84 @@ TEST(test_ob_file_service, send_one_file)
   ASSERT_EQ(0, unlink(dest_path));
 }
 
+TEST(test_ob_file_service, send_unaligned_file)
+{
+  time_t t = time(NULL);
+  char src_path[OB_MAX_FILE_NAME_LENGTH];
+  char dest_file_name[OB_MAX_FILE_NAME_LENGTH];
+  char dest_dir[] = "/tmp";
+  int n = snprintf(src_path, OB_MAX_FILE_NAME_LENGTH, "/tmp/test_ob_file_sesrvice.unaligned.src.%ld", t);
+  ASSERT_LT(n,OB_MAX_FILE_NAME_LENGTH);
+  generate_file(src_path, 5);
+  // the last block is neither full nor aligned
+  ASSERT_EQ(0, truncate(src_path, 5 * 1024 * 1024 - 1000));
+  n = snprintf(dest_file_name, OB_MAX_FILE_NAME_LENGTH, "test_ob_file_sesrvice.unaligned.dest.%ld", t);
+  ASSERT_LT(n,OB_MAX_FILE_NAME_LENGTH);
+  int ret = client.send_file(1000*1000, 2048, file_server,
+      ObString(0, static_cast<int32_t>(strlen(src_path)), src_path),
+      ObString(0, static_cast<int32_t>(strlen(dest_dir)), dest_dir),
+      ObString(0, static_cast<int32_t>(strlen(dest_file_name)), dest_file_name));
+  ASSERT_EQ(0, ret);
+
+  char dest_path[OB_MAX_FILE_NAME_LENGTH];
+  n = snprintf(dest_path,OB_MAX_FILE_NAME_LENGTH, "%s/%s", dest_dir, dest_file_name);
+  ASSERT_LT(n,OB_MAX_FILE_NAME_LENGTH);
+  ASSERT_EQ(0, compare_file(src_path, dest_path));
+  ASSERT_EQ(0, unlink(src_path));
+  ASSERT_EQ(0, unlink(dest_path));
+}
+
+TEST(test_ob_file_service, block_prefetcher)
+{
+  const int64_t block_size = ObFileService::BLOCK_SIZE;
+  const int64_t file_size = 7 * block_size + 4097;
+  char src_path[OB_MAX_FILE_NAME_LENGTH];
+  int n = snprintf(src_path, OB_MAX_FILE_NAME_LENGTH, "/tmp/test_ob_file_sesrvice.prefetch.%ld", time(NULL));
+  ASSERT_LT(n,OB_MAX_FILE_NAME_LENGTH);
+  generate_file(src_path, 8);
+  ASSERT_EQ(0, truncate(src_path, file_size));
+
+  char *expect = reinterpret_cast<char *>(ob_malloc(file_size, ObModIds::TEST));
+  ASSERT_TRUE(NULL != expect);
+  FILE *fp = fopen(src_path, "r");
+  ASSERT_TRUE(NULL != fp);
+  ASSERT_EQ(file_size, static_cast<int64_t>(fread(expect, 1, file_size, fp)));
+  fclose(fp);
+
+  ObString path(0, static_cast<int32_t>(strlen(src_path)), src_path);
+  for (int64_t prefetch_count = 1; prefetch_count <= 4; ++prefetch_count)
+  {
+    ObFileBlockPrefetcher prefetcher;
+    const char *buf = NULL;
+    int64_t read_size = 0;
+    int64_t offset = 0;
+    ASSERT_EQ(OB_SUCCESS, prefetcher.open(path, block_size, prefetch_count));
+    ASSERT_EQ(file_size, prefetcher.get_file_size());
+    while (offset < file_size)
+    {
+      ASSERT_EQ(OB_SUCCESS, prefetcher.get_next_block(buf, read_size));
+      ASSERT_EQ(std::min(block_size, file_size - offset), read_size);
+      ASSERT_EQ(0, memcmp(expect + offset, buf, read_size));
+      offset += read_size;
+    }
+    ASSERT_EQ(OB_SUCCESS, prefetcher.get_next_block(buf, read_size));
+    ASSERT_EQ(0, read_size);
+  }
+
+  // close with reads in flight
+  ObFileBlockPrefetcher prefetcher;
+  const char *buf = NULL;
+  int64_t read_size = 0;
+  ASSERT_EQ(OB_INVALID_ARGUMENT, prefetcher.open(path, block_size + 1, 2));
+  ASSERT_EQ(OB_SUCCESS, prefetcher.open(path, block_size, 4));
+  ASSERT_EQ(OB_SUCCESS, prefetcher.get_next_block(buf, read_size));
+  prefetcher.close();
+  ASSERT_EQ(OB_NOT_INIT, prefetcher.get_next_block(buf, read_size));
+
+  ob_free(expect);
+  ASSERT_EQ(0, unlink(src_path));
+}
+
 class ObFileServer : public common::ObSingleServer
 {
   public:
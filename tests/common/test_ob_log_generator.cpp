@@ -171,6 +171,27 @@ namespace oceanbase
       BaseWorker worker;
       ASSERT_EQ(0, PARDO(get_thread_num(), this, duration));
     }
+    TEST_F(ObLogGeneratorTest, DetachLog){
+      ObLogCursor start_cursor;
+      ObLogCursor end_cursor;
+      char* first_buf = NULL;
+      int64_t first_len = 0;
+      char* second_buf = NULL;
+      int64_t second_len = 0;
+      static char buf_for_gen[1024];
+      ASSERT_EQ(OB_SUCCESS, log_generator.write_log(OB_LOG_NOP, buf_for_gen, sizeof(buf_for_gen)));
+      ASSERT_EQ(OB_SUCCESS, log_generator.detach_log(start_cursor, end_cursor, first_buf, first_len));
+      ASSERT_TRUE(log_generator.is_clear());
+      // 摘下的日志在下一批序列化期间必须保持不变
+      memset(buf_for_gen, 'x', sizeof(buf_for_gen));
+      ASSERT_EQ(OB_SUCCESS, log_generator.write_log(OB_LOG_NOP, buf_for_gen, sizeof(buf_for_gen)));
+      ASSERT_EQ(OB_SUCCESS, consume_log(first_buf, first_len));
+      ASSERT_TRUE(consumed_cursor.equal(end_cursor));
+      ASSERT_EQ(OB_SUCCESS, log_generator.detach_log(start_cursor, end_cursor, second_buf, second_len));
+      ASSERT_NE(first_buf, second_buf);
+      ASSERT_EQ(OB_SUCCESS, consume_log(second_buf, second_len));
+      ASSERT_TRUE(consumed_cursor.equal(end_cursor));
+    }
   }
 }
 using namespace oceanbase::test;
@@ -69,6 +69,36 @@ TEST(ObStatManager,Serialize)
   EXPECT_EQ(m2.end(OB_STAT_CHUNKSERVER), it);
 
 
+}
+TEST(ObStatManager,DeserializeWithoutNewMod)
+{
+  ObStatManager stat_manager(OB_UPDATESERVER);
+  stat_manager.set_value(OB_STAT_UPDATESERVER, 0, 1, 1);
+  char buff[1024];
+  int64_t pos = 0;
+  ASSERT_TRUE(OB_SUCCESS == stat_manager.serialize(buff, 1024, pos));
+  // an old server doesn't have the size of the last mod which is empty here
+  const int64_t old_len = pos - serialization::encoded_length_vi32(0);
+  pos = 0;
+  ObStatManager m2(OB_MERGESERVER);
+  ASSERT_TRUE(OB_SUCCESS == m2.deserialize(buff, old_len, pos));
+  EXPECT_EQ(old_len, pos);
+  EXPECT_EQ(OB_UPDATESERVER, m2.get_server_type());
+  ObStatManager::const_iterator it = m2.begin(OB_STAT_UPDATESERVER);
+  EXPECT_EQ(1, it->get_value(1));
+  EXPECT_EQ(m2.end(OB_STAT_MEMTABLE), m2.begin(OB_STAT_MEMTABLE));
+
+  // the new mod is serialized after all the old ones
+  stat_manager.set_value(OB_STAT_MEMTABLE, 0, 2, 3);
+  pos = 0;
+  ASSERT_TRUE(OB_SUCCESS == stat_manager.serialize(buff, 1024, pos));
+  const int64_t new_len = pos;
+  pos = 0;
+  ASSERT_TRUE(OB_SUCCESS == m2.deserialize(buff, new_len, pos));
+  EXPECT_EQ(new_len, pos);
+  it = m2.begin(OB_STAT_MEMTABLE);
+  ASSERT_TRUE(m2.end(OB_STAT_MEMTABLE) != it);
+  EXPECT_EQ(3, it->get_value(2));
 }
 int main(int argc, char **argv)
 {
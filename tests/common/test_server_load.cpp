@@ -0,0 +1,160 @@
+#include "ob_malloc.h"
+#include "ob_server_load.h"
+
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace common;
+
+TEST(TestServerLoad, add_and_get)
+{
+  const int64_t max_count = ObServerLoad::MAX_TABLE_LOAD_COUNT;
+  ObServerLoad load;
+  ObTableLoad table_load;
+  EXPECT_EQ(0, load.get_table_count());
+  EXPECT_TRUE(NULL == load.get_table_load(1001));
+  for (int64_t i = 0; i < max_count; ++i)
+  {
+    table_load.table_id_ = 1001 + i;
+    table_load.get_qps_ = i;
+    table_load.scan_qps_ = 2 * i;
+    EXPECT_EQ(OB_SUCCESS, load.add_table_load(table_load));
+  }
+  EXPECT_EQ(OB_SIZE_OVERFLOW, load.add_table_load(table_load));
+  EXPECT_EQ(max_count, load.get_table_count());
+  ASSERT_TRUE(NULL != load.get_table_load(1003));
+  EXPECT_EQ(6, load.get_table_load(1003)->get_qps());
+  load.reset();
+  EXPECT_EQ(0, load.get_table_count());
+  EXPECT_TRUE(NULL == load.get_table_load(1003));
+}
+
+TEST(TestServerLoad, add_and_get_tablet)
+{
+  const int64_t max_count = ObServerLoad::MAX_TABLET_LOAD_COUNT;
+  ObServerLoad load;
+  ObTabletLoad tablet_load;
+  EXPECT_EQ(0, load.get_tablet_count());
+  EXPECT_TRUE(NULL == load.get_tablet_load(1001, 1));
+  for (int64_t i = 0; i < max_count; ++i)
+  {
+    tablet_load.table_id_ = 1001;
+    tablet_load.range_hash_ = i;
+    tablet_load.get_qps_ = i;
+    EXPECT_EQ(OB_SUCCESS, load.add_tablet_load(tablet_load));
+  }
+  EXPECT_EQ(OB_SIZE_OVERFLOW, load.add_tablet_load(tablet_load));
+  EXPECT_EQ(max_count, load.get_tablet_count());
+  ASSERT_TRUE(NULL != load.get_tablet_load(1001, 3));
+  EXPECT_EQ(3, load.get_tablet_load(1001, 3)->get_qps());
+  EXPECT_TRUE(NULL == load.get_tablet_load(1002, 3));
+  load.reset();
+  EXPECT_EQ(0, load.get_tablet_count());
+}
+
+TEST(TestServerLoad, range_hash)
+{
+  ObObj start_obj;
+  ObObj end_obj;
+  ObObj other_obj;
+  ObNewRange range;
+  ObNewRange same_range;
+  start_obj.set_int(100);
+  end_obj.set_int(200);
+  other_obj.set_int(300);
+  range.table_id_ = 1001;
+  range.start_key_.assign(&start_obj, 1);
+  range.end_key_.assign(&end_obj, 1);
+  range.border_flag_.set_inclusive_end();
+  same_range = range;
+  EXPECT_EQ(ObTabletLoad::get_range_hash(range), ObTabletLoad::get_range_hash(same_range));
+  same_range.end_key_.assign(&other_obj, 1);
+  EXPECT_NE(ObTabletLoad::get_range_hash(range), ObTabletLoad::get_range_hash(same_range));
+  same_range = range;
+  same_range.table_id_ = 1002;
+  EXPECT_NE(ObTabletLoad::get_range_hash(range), ObTabletLoad::get_range_hash(same_range));
+}
+
+TEST(TestServerLoad, serialize)
+{
+  char buf[4096];
+  int64_t pos = 0;
+  ObServerLoad load;
+  ObServerLoad load2;
+  ObTableLoad table_load;
+  for (int64_t i = 0; i < 10; ++i)
+  {
+    table_load.table_id_ = 3001 + i;
+    table_load.get_qps_ = 100 * i;
+    table_load.scan_qps_ = 10 * i;
+    table_load.scan_bytes_ = 1024 * 1024 * i;
+    ASSERT_EQ(OB_SUCCESS, load.add_table_load(table_load));
+  }
+  ObTabletLoad tablet_load;
+  for (int64_t i = 0; i < 5; ++i)
+  {
+    tablet_load.table_id_ = 3001;
+    tablet_load.range_hash_ = UINT64_MAX - i;
+    tablet_load.get_qps_ = 10 * i;
+    tablet_load.scan_qps_ = i;
+    tablet_load.scan_bytes_ = 1024 * i;
+    ASSERT_EQ(OB_SUCCESS, load.add_tablet_load(tablet_load));
+  }
+  ASSERT_EQ(OB_SUCCESS, load.serialize(buf, sizeof(buf), pos));
+  EXPECT_EQ(load.get_serialize_size(), pos);
+  int64_t data_len = pos;
+  pos = 0;
+  ASSERT_EQ(OB_SUCCESS, load2.deserialize(buf, data_len, pos));
+  EXPECT_EQ(data_len, pos);
+  ASSERT_EQ(10, load2.get_table_count());
+  for (int64_t i = 0; i < 10; ++i)
+  {
+    EXPECT_EQ(load.at(i).table_id_, load2.at(i).table_id_);
+    EXPECT_EQ(load.at(i).get_qps_, load2.at(i).get_qps_);
+    EXPECT_EQ(load.at(i).scan_qps_, load2.at(i).scan_qps_);
+    EXPECT_EQ(load.at(i).scan_bytes_, load2.at(i).scan_bytes_);
+  }
+  ASSERT_EQ(5, load2.get_tablet_count());
+  for (int64_t i = 0; i < 5; ++i)
+  {
+    EXPECT_EQ(load.tablet_at(i).table_id_, load2.tablet_at(i).table_id_);
+    EXPECT_EQ(load.tablet_at(i).range_hash_, load2.tablet_at(i).range_hash_);
+    EXPECT_EQ(load.tablet_at(i).get_qps_, load2.tablet_at(i).get_qps_);
+    EXPECT_EQ(load.tablet_at(i).scan_qps_, load2.tablet_at(i).scan_qps_);
+    EXPECT_EQ(load.tablet_at(i).scan_bytes_, load2.tablet_at(i).scan_bytes_);
+  }
+
+  // truncated buffer
+  pos = 0;
+  EXPECT_NE(OB_SUCCESS, load2.deserialize(buf, data_len - 1, pos));
+  EXPECT_EQ(0, pos);
+
+  // chunkserver of old version reports only the tables
+  ObServerLoad table_only;
+  for (int64_t i = 0; i < 10; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, table_only.add_table_load(load.at(i)));
+  }
+  pos = 0;
+  ASSERT_EQ(OB_SUCCESS, table_only.serialize(buf, sizeof(buf), pos));
+  data_len = pos - 1; // without the tablet count
+  pos = 0;
+  ASSERT_EQ(OB_SUCCESS, load2.deserialize(buf, data_len, pos));
+  EXPECT_EQ(data_len, pos);
+  EXPECT_EQ(10, load2.get_table_count());
+  EXPECT_EQ(0, load2.get_tablet_count());
+
+  // count larger than MAX_TABLE_LOAD_COUNT
+  pos = 0;
+  ASSERT_EQ(OB_SUCCESS, serialization::encode_vi64(buf, sizeof(buf), pos, ObServerLoad::MAX_TABLE_LOAD_COUNT + 1));
+  data_len = pos;
+  pos = 0;
+  EXPECT_EQ(OB_SIZE_OVERFLOW, load2.deserialize(buf, data_len, pos));
+}
+
+int main(int argc, char** argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
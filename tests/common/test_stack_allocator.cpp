@@ -147,8 +147,11 @@ namespace oceanbase
       setThreadCount((int32_t)n_thread);
       start();
       wait();
+      ASSERT_LT(0, allocator.get_alloc_size());
+      ASSERT_GE(block_allocator.get_allocated(), allocator.get_alloc_size());
       ASSERT_EQ(OB_SUCCESS, allocator.clear());
       ASSERT_EQ(0, block_allocator.get_allocated());
+      ASSERT_EQ(0, allocator.get_alloc_size());
     }
   } // end namespace updateserver
 } // end namespace oceanbase
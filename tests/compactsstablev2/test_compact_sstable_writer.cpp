@@ -652,6 +652,104 @@ public:
     }
   }
 
+  /**
+   * set the file of the next sstable after split
+   * @param writer: sstable writer
+   * @param file_num: file num of the current sstable
+   */
+  void switch_sstable_file(ObCompactSSTableWriter& writer, int64_t& file_num)
+  {
+    ObString file_path;
+    file_num ++;
+    ASSERT_EQ(OB_SUCCESS, make_file_path(file_path, file_num));
+    ASSERT_EQ(OB_SUCCESS, writer.set_sstable_filepath(file_path));
+  }
+
+  /**
+   * write rows into sstable files, switch to the next file when split
+   * @param thread_num: compress thread num of the writer
+   * @param store_type: DENSE_DENSE(one table, split),
+   *                    DENSE_SPARSE(three tables, not split)
+   * @param first_file_num: file num of the first sstable
+   * @param file_count: sstable file count
+   */
+  void write_sstable_files(const int64_t thread_num,
+      const ObCompactStoreType store_type, const int64_t first_file_num,
+      int64_t& file_count)
+  {
+    int ret = OB_SUCCESS;
+    ObCompactSSTableWriter writer;
+    ObFrozenMinorVersionRange version_range;
+    ObString comp_name;
+    ObSSTableSchema schema;
+    ObNewRange range;
+    ObString file_path;
+    ObRow row;
+    uint64_t table_id[3] = {1001, 1002, 1003};
+    const bool split = (DENSE_DENSE == store_type);
+    const int64_t table_count = split ? 1 : 3;
+    const int64_t block_size = 1024;
+    const int64_t def_sstable_size = split ? 6000 : 0;
+    const int64_t min_split_sstable_size = split ? 3000 : 0;
+    int64_t file_num = first_file_num;
+    bool is_split = false;
+
+    ret = make_version_range(store_type, version_range, 0);
+    ASSERT_EQ(OB_SUCCESS, ret);
+    ret = make_comp_name(comp_name, 2);
+    ASSERT_EQ(OB_SUCCESS, ret);
+    ret = writer.set_compress_thread_num(thread_num);
+    ASSERT_EQ(OB_SUCCESS, ret);
+    ret = writer.set_sstable_param(version_range, store_type,
+        table_count, block_size, comp_name, def_sstable_size,
+        min_split_sstable_size);
+    ASSERT_EQ(OB_SUCCESS, ret);
+
+    for (int64_t t = 0; t < table_count; t ++)
+    {
+      ret = make_range(range, table_id[t], 0, 0, 0, 0);
+      ASSERT_EQ(OB_SUCCESS, ret);
+      make_schema(schema, table_id[t], 0);
+      ret = writer.set_table_info(table_id[t], schema, range);
+      ASSERT_EQ(OB_SUCCESS, ret);
+
+      if (0 == t)
+      {
+        ret = make_file_path(file_path, file_num);
+        ASSERT_EQ(OB_SUCCESS, ret);
+        ret = writer.set_sstable_filepath(file_path);
+        ASSERT_EQ(OB_SUCCESS, ret);
+      }
+
+      for (int64_t i = 0; i < 3000; i ++)
+      {
+        make_row(row, table_id[t], i, 0);
+        ret = writer.append_row(row, is_split);
+        ASSERT_EQ(OB_SUCCESS, ret);
+
+        if (is_split)
+        {
+          switch_sstable_file(writer, file_num);
+        }
+      }
+    }
+
+    //the blocks in compressing may split the sstable
+    do
+    {
+      ret = writer.flush(is_split);
+      ASSERT_EQ(OB_SUCCESS, ret);
+      if (is_split)
+      {
+        switch_sstable_file(writer, file_num);
+      }
+    } while (is_split);
+
+    ret = writer.finish();
+    ASSERT_EQ(OB_SUCCESS, ret);
+    file_count = file_num - first_file_num + 1;
+  }
+
   /**
    * delete file
    * @param i: file id
@@ -663,6 +761,39 @@ public:
     remove(file_path.ptr());
   }
 
+  /**
+   * check the two sstable files are the same byte by byte
+   * @param file_num1: file id
+   * @param file_num2: file id
+   */
+  void check_same_file(const int64_t file_num1, const int64_t file_num2)
+  {
+    ObString file_path;
+    char path1[1024];
+    char path2[1024];
+    make_file_path(file_path, file_num1);
+    snprintf(path1, sizeof(path1), "%s", file_path.ptr());
+    make_file_path(file_path, file_num2);
+    snprintf(path2, sizeof(path2), "%s", file_path.ptr());
+
+    FILE* fp1 = fopen(path1, "r");
+    FILE* fp2 = fopen(path2, "r");
+    ASSERT_TRUE(NULL != fp1);
+    ASSERT_TRUE(NULL != fp2);
+    int64_t size = 0;
+    int c1 = 0;
+    int c2 = 0;
+    do
+    {
+      c1 = fgetc(fp1);
+      c2 = fgetc(fp2);
+      ASSERT_EQ(c1, c2) << "file=" << file_num2 << " offset=" << size;
+      size ++;
+    } while (EOF != c2);
+    fclose(fp1);
+    fclose(fp2);
+  }
+
   /**
    * check block
    * @param fd: file fd
@@ -2780,6 +2911,198 @@ TEST_F(TestCompactSSTableWriter, append_row7)
   delete_file(file_num);
 }
 
+/**
+ * test compress_pipeline
+ * --the sstable files written with compress threads are the same as
+ *   the files compressed in the append thread
+ */
+TEST_F(TestCompactSSTableWriter, compress_pipeline)
+{
+  const ObCompactStoreType store_types[2] = {DENSE_DENSE, DENSE_SPARSE};
+  const int64_t thread_nums[3] = {1, 2, 4};
+
+  for (int64_t s = 0; s < 2; s ++)
+  {
+    int64_t sync_file_count = 0;
+    write_sstable_files(0, store_types[s], 1, sync_file_count);
+    if (DENSE_DENSE == store_types[s])
+    {
+      ASSERT_LT(2, sync_file_count);
+    }
+
+    for (int64_t t = 0; t < 3; t ++)
+    {
+      int64_t file_count = 0;
+      write_sstable_files(thread_nums[t], store_types[s], 101, file_count);
+      ASSERT_EQ(sync_file_count, file_count);
+
+      for (int64_t i = 0; i < file_count; i ++)
+      {
+        check_same_file(1 + i, 101 + i);
+        delete_file(101 + i);
+      }
+    }
+
+    for (int64_t i = 0; i < sync_file_count; i ++)
+    {
+      delete_file(1 + i);
+    }
+  }
+}
+
+TEST_F(TestCompactSSTableWriter, append_block)
+{
+  int ret = OB_SUCCESS;
+  ObFrozenMinorVersionRange version_range;
+  ObString comp_name;
+  ObSSTableSchema schema;
+  ObNewRange range;
+  ObString file_path;
+  ObRow row;
+  const ObRowkey* rowkey = NULL;
+  ObRowkey endkey;
+  ObCompressor* compressor = NULL;
+  TableBloomFilter bloomfilter;
+  const uint64_t table_id = 1001;
+  const int64_t block_size = 1024;
+  const int64_t thread_nums[2] = {0, 2};
+  bool is_split = false;
+
+  ret = make_version_range(DENSE_DENSE, version_range, 0);
+  ASSERT_EQ(OB_SUCCESS, ret);
+  ret = make_comp_name(comp_name, 2);
+  ASSERT_EQ(OB_SUCCESS, ret);
+  ret = make_compressor(compressor, 2);
+  ASSERT_EQ(OB_SUCCESS, ret);
+  ret = make_range(range, table_id, 0, 0, 0, 0);
+  ASSERT_EQ(OB_SUCCESS, ret);
+  make_schema(schema, table_id, 0);
+  ret = bloomfilter.init(SSTABLE_BLOOMFILTER_HASH_COUNT,
+      SSTABLE_BLOOMFILTER_SIZE);
+  ASSERT_EQ(OB_SUCCESS, ret);
+
+  //write the rows into 1.sst
+  {
+    ObCompactSSTableWriter writer;
+    ret = writer.set_sstable_param(version_range, DENSE_DENSE, 1,
+        block_size, comp_name, 0, 0);
+    ASSERT_EQ(OB_SUCCESS, ret);
+    ret = writer.set_table_info(table_id, schema, range);
+    ASSERT_EQ(OB_SUCCESS, ret);
+    make_file_path(file_path, 1);
+    ret = writer.set_sstable_filepath(file_path);
+    ASSERT_EQ(OB_SUCCESS, ret);
+
+    for (int64_t i = 0; i < 3000; i ++)
+    {
+      make_row(row, table_id, i, 0);
+      ret = writer.append_row(row, is_split);
+      ASSERT_EQ(OB_SUCCESS, ret);
+      ret = row.get_rowkey(rowkey);
+      ASSERT_EQ(OB_SUCCESS, ret);
+      ret = bloomfilter.insert(table_id, *rowkey);
+      ASSERT_EQ(OB_SUCCESS, ret);
+    }
+    ret = writer.finish();
+    ASSERT_EQ(OB_SUCCESS, ret);
+  }
+
+  //copy the blocks of 1.sst into 2.sst, every third block is written
+  //with rows, the new sstable must be the same as 1.sst
+  for (int64_t t = 0; t < 2; t ++)
+  {
+    ObCompactSSTableWriter writer;
+    ret = writer.set_compress_thread_num(thread_nums[t]);
+    ASSERT_EQ(OB_SUCCESS, ret);
+    ret = writer.set_sstable_param(version_range, DENSE_DENSE, 1,
+        block_size, comp_name, 0, 0);
+    ASSERT_EQ(OB_SUCCESS, ret);
+    ret = writer.set_table_info(table_id, schema, range);
+    ASSERT_EQ(OB_SUCCESS, ret);
+    make_file_path(file_path, 2);
+    ret = writer.set_sstable_filepath(file_path);
+    ASSERT_EQ(OB_SUCCESS, ret);
+
+    make_file_path(file_path, 1);
+    int fd = open(file_path.ptr(), O_RDONLY);
+    ASSERT_TRUE(fd >= 0);
+
+    char record_buf[64 * 1024];
+    char uncomp_buf[64 * 1024];
+    ObRecordHeaderV2 header;
+    const char* payload = NULL;
+    int64_t payload_size = 0;
+    int64_t uncomp_len = 0;
+    int64_t row_num = 0;
+    int64_t block_num = 0;
+
+    while (true)
+    {
+      const ObRecordHeaderV2* header_ptr = (ObRecordHeaderV2*)(record_buf);
+      ASSERT_EQ(static_cast<ssize_t>(sizeof(ObRecordHeaderV2)),
+          read(fd, record_buf, sizeof(ObRecordHeaderV2)));
+      if (OB_SSTABLE_BLOCK_DATA_MAGIC != header_ptr->magic_)
+      {
+        break;
+      }
+      const int64_t record_size = sizeof(ObRecordHeaderV2)
+        + header_ptr->data_zlength_;
+      ASSERT_EQ(record_size - static_cast<int64_t>(sizeof(ObRecordHeaderV2)),
+          read(fd, record_buf + sizeof(ObRecordHeaderV2),
+            record_size - sizeof(ObRecordHeaderV2)));
+      ret = ObRecordHeaderV2::check_record(record_buf, record_size,
+          OB_SSTABLE_BLOCK_DATA_MAGIC, header, payload, payload_size);
+      ASSERT_EQ(OB_SUCCESS, ret);
+
+      const char* block_buf = payload;
+      if (header.is_compress())
+      {
+        ret = compressor->decompress(payload, payload_size, uncomp_buf,
+            sizeof(uncomp_buf), uncomp_len);
+        ASSERT_EQ(OB_SUCCESS, ret);
+        block_buf = uncomp_buf;
+      }
+      const int64_t block_row_count
+        = ((const ObSSTableBlockHeader*)(block_buf))->row_count_;
+      ASSERT_LT(0, block_row_count);
+
+      if (2 == block_num % 3)
+      {
+        for (int64_t i = row_num; i < row_num + block_row_count; i ++)
+        {
+          make_row(row, table_id, i, 0);
+          ret = writer.append_row(row, is_split);
+          ASSERT_EQ(OB_SUCCESS, ret);
+        }
+      }
+      else
+      {
+        //the rows appended before must be written first
+        ret = writer.flush(is_split);
+        ASSERT_EQ(OB_SUCCESS, ret);
+        make_rowkey(endkey, row_num + block_row_count - 1);
+        ret = writer.append_block(header, payload, endkey, block_row_count,
+            bloomfilter, is_split);
+        ASSERT_EQ(OB_SUCCESS, ret);
+      }
+      ASSERT_FALSE(is_split);
+
+      row_num += block_row_count;
+      block_num ++;
+    }
+    close(fd);
+    ASSERT_EQ(3000, row_num);
+    ASSERT_LT(3, block_num);
+
+    ret = writer.finish();
+    ASSERT_EQ(OB_SUCCESS, ret);
+    check_same_file(1, 2);
+    delete_file(2);
+  }
+
+  delete_file(1);
+}
+
 /*
 TEST_F(TestCompactSSTableWriter, get_table_range)
 {//success or fail()
@@ -0,0 +1,122 @@
+/*
+ * (C) 2007-2012 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * Version: $id
+ *
+ * test_ob_mysql_row.cpp
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "common/ob_define.h"
+#include "common/ob_malloc.h"
+#include "common/ob_row.h"
+#include "common/ob_row_desc.h"
+#include "obmysql/ob_mysql_row.h"
+#include "obmysql/ob_mysql_dtoa.h"
+#include "obmysql/ob_mysql_global.h"
+
+using namespace oceanbase;
+using namespace oceanbase::common;
+using namespace oceanbase::obmysql;
+
+static const uint64_t TABLE_ID = 1001;
+static const int64_t BUF_SIZE = 1024;
+
+class TestObMySQLRow : public ::testing::Test
+{
+  public:
+    // 一列的行按文本协议序列化，返回lenenc字符串的内容
+    std::string text_of(const ObObj &obj)
+    {
+      ObRowDesc desc;
+      ObRow row;
+      EXPECT_EQ(OB_SUCCESS, desc.add_column_desc(TABLE_ID, OB_APP_MIN_COLUMN_ID));
+      row.set_row_desc(desc);
+      EXPECT_EQ(OB_SUCCESS, row.set_cell(TABLE_ID, OB_APP_MIN_COLUMN_ID, obj));
+      ObMySQLRow mrow;
+      mrow.get_inner_row() = &row;
+      mrow.set_protocol_type(TEXT);
+      char buf[BUF_SIZE];
+      int64_t pos = 0;
+      EXPECT_EQ(OB_SUCCESS, mrow.serialize(buf, BUF_SIZE, pos));
+      EXPECT_GT(251, static_cast<uint8_t>(buf[0]));
+      EXPECT_EQ(pos, 1 + static_cast<uint8_t>(buf[0]));
+      return std::string(buf + 1, pos - 1);
+    }
+};
+
+TEST_F(TestObMySQLRow, int_to_str)
+{
+  int64_t values[] = {0, 1, -1, 9, 10, 99, 100, -100, 12345, 1000000007,
+                      INT32_MAX, INT32_MIN, INT64_MAX, INT64_MIN, INT64_MIN + 1};
+  char buf[ObMySQLUtil::MAX_INT_STR_LEN + 1];
+  char expect[64];
+  for (int64_t i = 0; i < static_cast<int64_t>(sizeof(values) / sizeof(values[0])); i++)
+  {
+    int64_t len = ObMySQLUtil::int_to_str(values[i], buf);
+    buf[len] = '\0';
+    snprintf(expect, sizeof(expect), "%ld", values[i]);
+    EXPECT_STREQ(expect, buf);
+
+    ObObj obj;
+    obj.set_int(values[i]);
+    EXPECT_EQ(std::string(expect), text_of(obj));
+  }
+  int64_t len = ObMySQLUtil::uint_to_str(UINT64_MAX, buf);
+  buf[len] = '\0';
+  EXPECT_STREQ("18446744073709551615", buf);
+}
+
+TEST_F(TestObMySQLRow, bool_cell)
+{
+  ObObj obj;
+  obj.set_bool(true);
+  EXPECT_EQ("1", text_of(obj));
+  obj.set_bool(false);
+  EXPECT_EQ("0", text_of(obj));
+}
+
+TEST_F(TestObMySQLRow, decimal_cell)
+{
+  const char *strs[] = {"0", "0.000", "1", "-1", "0.5", "-0.05", "0.0001", "123.456", "-123.456",
+    "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967296",
+    "9223372036854775807", "-9223372036854775808", "9223372036854775808",
+    "12345678901234567890123.4567", "-0.00000000000000000001", "100.00"};
+  for (int64_t i = 0; i < static_cast<int64_t>(sizeof(strs) / sizeof(strs[0])); i++)
+  {
+    ObNumber n;
+    ASSERT_EQ(OB_SUCCESS, n.from(strs[i]));
+    char expect[ObNumber::MAX_PRINTABLE_SIZE];
+    n.to_string(expect, sizeof(expect));
+    ObObj obj;
+    obj.set_decimal(n, 38, n.get_vscale());
+    EXPECT_EQ(std::string(expect), text_of(obj)) << strs[i];
+  }
+}
+
+TEST_F(TestObMySQLRow, double_cell)
+{
+  double values[] = {0.0, -0.0, 1.0, -1.0, 3.0, 100.0, 0.5, -2.25, 1e14, 999999999999999.0,
+                     1e15, -1e15, 1e16, 1e20, 123456789.0, 1.0 / 3, 6e-16};
+  const int dbl_len = DOUBLE_TO_STRING_CONVERSION_BUFFER_SIZE;
+  for (int64_t i = 0; i < static_cast<int64_t>(sizeof(values) / sizeof(values[0])); i++)
+  {
+    char expect[dbl_len];
+    size_t len = my_gcvt(values[i], MY_GCVT_ARG_DOUBLE, dbl_len - 1, expect, NULL);
+    ObObj obj;
+    obj.set_double(values[i]);
+    EXPECT_EQ(std::string(expect, len), text_of(obj)) << values[i];
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
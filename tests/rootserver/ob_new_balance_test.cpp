@@ -20,6 +20,7 @@
 #include "rootserver/ob_root_worker.h"
 #include "root_server_tester.h"
 #include "rootserver/ob_root_rpc_stub.h"
+#include "chunkserver/ob_chunk_server_stat.h"
 #include <gtest/gtest.h>
 #include <cassert>
 #include "../common/test_rowkey_helper.h"
@@ -353,6 +354,16 @@ class ObBalanceTest: public ::testing::Test
     void heartbeat_cs(int32_t cs_num);
     ObServer &get_addr(int32_t idx);
     uint64_t get_table_id(int32_t idx);
+    // for balance by load, called after the balance threads stopped
+    void stop_balance_threads();
+    void set_balance_by_load(int64_t tolerance_percent);
+    ObServerStatus *get_cs(int32_t cs_idx);
+    const ObTabletInfo *get_tablet(int32_t table_idx, int32_t cs_idx, int32_t seq);
+    void set_load(int32_t cs_idx, int32_t table_idx, int64_t qps);
+    void set_hot_tablet_load(int32_t cs_idx, const ObTabletInfo &tablet, int64_t qps);
+    void plan_balance(int32_t table_idx);
+    bool has_migrate_info(int32_t cs_idx, const ObNewRange &range);
+    void reset_balance_by_load(int32_t cs_num);
   public:
     BalanceTestRootWorker worker_;
     ObRootServer2* server_;
@@ -441,6 +452,94 @@ uint64_t ObBalanceTest::get_table_id(int32_t idx)
   return 1000+idx;
 }
 
+void ObBalanceTest::stop_balance_threads()
+{
+  worker_.get_test_stub().stop();
+  worker_.get_test_stub().wait();
+  server_->stop_threads();
+}
+
+void ObBalanceTest::set_balance_by_load(int64_t tolerance_percent)
+{
+  worker_.rs_config_.balance_by_load = true;
+  worker_.rs_config_.balance_size_weight = 0;
+  worker_.rs_config_.balance_qps_weight = 1;
+  worker_.rs_config_.balance_scan_bytes_weight = 0;
+  worker_.rs_config_.balance_tolerance_percent = tolerance_percent;
+  worker_.rs_config_.cs_probation_period = 0;
+}
+
+ObServerStatus *ObBalanceTest::get_cs(int32_t cs_idx)
+{
+  return server_->server_manager_.find_by_ip(get_addr(cs_idx));
+}
+
+// the seq-th tablet of the table on the cs in root table
+const ObTabletInfo *ObBalanceTest::get_tablet(int32_t table_idx, int32_t cs_idx, int32_t seq)
+{
+  const ObTabletInfo *ret = NULL;
+  int32_t server_idx = static_cast<int32_t>(get_cs(cs_idx) - server_->server_manager_.begin());
+  int32_t count = 0;
+  ObRootTable2::const_iterator it;
+  for (it = server_->root_table_->begin(); it != server_->root_table_->end() && NULL == ret; ++it)
+  {
+    const ObTabletInfo *tablet = server_->root_table_->get_tablet_info(it);
+    if (NULL != tablet && tablet->range_.table_id_ == get_table_id(table_idx)
+        && it->did_cs_have(server_idx) && seq == count++)
+    {
+      ret = tablet;
+    }
+  }
+  return ret;
+}
+
+void ObBalanceTest::set_load(int32_t cs_idx, int32_t table_idx, int64_t qps)
+{
+  ObTableLoad load;
+  load.table_id_ = get_table_id(table_idx);
+  load.get_qps_ = qps;
+  ASSERT_EQ(OB_SUCCESS, get_cs(cs_idx)->load_info_.add_table_load(load));
+}
+
+void ObBalanceTest::set_hot_tablet_load(int32_t cs_idx, const ObTabletInfo &tablet, int64_t qps)
+{
+  ObTabletLoad load;
+  load.table_id_ = tablet.range_.table_id_;
+  load.range_hash_ = ObTabletLoad::get_range_hash(tablet.range_);
+  load.get_qps_ = qps;
+  ASSERT_EQ(OB_SUCCESS, get_cs(cs_idx)->load_info_.add_tablet_load(load));
+}
+
+void ObBalanceTest::plan_balance(int32_t table_idx)
+{
+  bool scan_next_table = true;
+  server_->server_manager_.reset_balance_info(static_cast<int32_t>(worker_.rs_config_.balance_max_migrate_out_per_cs));
+  ASSERT_EQ(OB_SUCCESS, server_->balancer_->nb_balance_by_table(get_table_id(table_idx), scan_next_table));
+}
+
+bool ObBalanceTest::has_migrate_info(int32_t cs_idx, const ObNewRange &range)
+{
+  bool ret = false;
+  const ObMigrateInfo *minfo = get_cs(cs_idx)->balance_info_.migrate_to_.head();
+  for (; NULL != minfo && !ret; minfo = minfo->next_)
+  {
+    ret = (minfo->range_ == range);
+  }
+  return ret;
+}
+
+// the planned migrations are not started, the tables are still balanced by sstable count
+void ObBalanceTest::reset_balance_by_load(int32_t cs_num)
+{
+  worker_.rs_config_.balance_by_load = false;
+  for (int32_t i = 0; i < cs_num; ++i)
+  {
+    get_cs(i)->load_info_.reset();
+    get_cs(i)->status_ = ObServerStatus::STATUS_SERVING;
+  }
+  server_->server_manager_.reset_balance_info(static_cast<int32_t>(worker_.rs_config_.balance_max_migrate_out_per_cs));
+}
+
 void ObBalanceTest::conv_key(const int64_t in, int64_t &out)
 {
   char* b1 = (char*)&in;
@@ -931,6 +1030,218 @@ TEST_F(ObBalanceTest, test_shutdown_servers)
   ASSERT_TRUE(server_->balancer_->nb_did_cs_have_no_tablets(get_addr(9)));
 }
 
+TEST_F(ObBalanceTest, test_balance_by_load_hot_tablet)
+{
+  // 2 tables, 4 cs, 10 tablets of each table on each cs
+  BalanceTestParams params(2, 4, -1, -1);
+  for (int i = 0; i < 4; ++i)
+  {
+    params.sstables_dist[0][i] = 10;
+    params.sstables_dist[1][i] = 10;
+  }
+  params.sstables_per_table_[0] = 40;
+  params.sstables_per_table_[1] = 40;
+  this->test_env(params);
+  stop_balance_threads();
+  set_balance_by_load(10);
+
+  // the cost of 1 qps is 1, cs 0 is overloaded by one hot tablet
+  const ObTabletInfo *hot = get_tablet(0, 0, 4);
+  ASSERT_TRUE(NULL != hot);
+  set_load(0, 0, 3700);
+  set_hot_tablet_load(0, *hot, 1000);
+  for (int i = 1; i < 4; ++i)
+  {
+    set_load(i, 0, 100);
+  }
+  plan_balance(0);
+  // the hot tablet takes its own load, the other 9 share the rest 2700
+  ObServerStatus *cs0 = get_cs(0);
+  ASSERT_EQ(300, cs0->balance_info_.table_tablet_load_cost_);
+  // the hot tablet is moved first, to the coldest cs, then the cold ones
+  ASSERT_TRUE(has_migrate_info(0, hot->range_));
+  ASSERT_EQ(7, cs0->balance_info_.migrate_to_.count());
+  ASSERT_EQ(900, cs0->balance_info_.table_load_cost_);
+  for (int i = 1; i < 4; ++i)
+  {
+    ASSERT_GE(1100, get_cs(i)->balance_info_.table_load_cost_);
+    ASSERT_EQ(0, get_cs(i)->balance_info_.migrate_to_.count());
+  }
+  reset_balance_by_load(params.cs_num_);
+}
+
+TEST_F(ObBalanceTest, test_balance_by_load_tolerance)
+{
+  // 2 tables, 4 cs, 10 tablets of each table on each cs
+  BalanceTestParams params(2, 4, -1, -1);
+  for (int i = 0; i < 4; ++i)
+  {
+    params.sstables_dist[0][i] = 10;
+    params.sstables_dist[1][i] = 10;
+  }
+  params.sstables_per_table_[0] = 40;
+  params.sstables_per_table_[1] = 40;
+  this->test_env(params);
+  stop_balance_threads();
+
+  set_load(0, 0, 1300);
+  for (int i = 1; i < 4; ++i)
+  {
+    set_load(i, 0, 900);
+  }
+  // 1300 is within the tolerance of 40%
+  set_balance_by_load(40);
+  plan_balance(0);
+  for (int i = 0; i < 4; ++i)
+  {
+    ASSERT_EQ(0, get_cs(i)->balance_info_.migrate_to_.count());
+  }
+  // the tablets of 130 are moved until cs 0 is within the tolerance of 10%
+  set_balance_by_load(10);
+  plan_balance(0);
+  ObServerStatus *cs0 = get_cs(0);
+  ASSERT_EQ(2, cs0->balance_info_.migrate_to_.count());
+  ASSERT_EQ(1040, cs0->balance_info_.table_load_cost_);
+  reset_balance_by_load(params.cs_num_);
+}
+
+TEST_F(ObBalanceTest, test_balance_by_load_shutdown)
+{
+  // 2 tables, 4 cs, 10 tablets of each table on each cs
+  BalanceTestParams params(2, 4, -1, -1);
+  for (int i = 0; i < 4; ++i)
+  {
+    params.sstables_dist[0][i] = 10;
+    params.sstables_dist[1][i] = 10;
+  }
+  params.sstables_per_table_[0] = 40;
+  params.sstables_per_table_[1] = 40;
+  this->test_env(params);
+  stop_balance_threads();
+  set_balance_by_load(10);
+
+  // no cs can take the hot tablet within the tolerance
+  const ObTabletInfo *hot = get_tablet(0, 0, 0);
+  ASSERT_TRUE(NULL != hot);
+  set_load(0, 0, 3700);
+  set_hot_tablet_load(0, *hot, 2500);
+  for (int i = 1; i < 4; ++i)
+  {
+    set_load(i, 0, 100);
+  }
+  plan_balance(0);
+  ASSERT_FALSE(has_migrate_info(0, hot->range_));
+  ASSERT_LT(0, get_cs(0)->balance_info_.migrate_to_.count());
+
+  // all the tablets of the shutting-down cs are moved out anyway
+  get_cs(0)->status_ = ObServerStatus::STATUS_SHUTDOWN;
+  plan_balance(0);
+  ASSERT_TRUE(has_migrate_info(0, hot->range_));
+  ASSERT_EQ(10, get_cs(0)->balance_info_.migrate_to_.count());
+  reset_balance_by_load(params.cs_num_);
+}
+
+// calls add_tablet_access() like ObMultiVersionTabletImage
+struct TestTabletImage
+{
+  static const int64_t TABLET_NUM = 100;
+  ObNewRange ranges_[TABLET_NUM];
+  ObObj keys_[TABLET_NUM];
+  uint64_t get_count_[TABLET_NUM];
+  uint64_t scan_count_[TABLET_NUM];
+  uint64_t scan_bytes_[TABLET_NUM];
+  TestTabletImage()
+  {
+    for (int64_t i = 0; i < TABLET_NUM; ++i)
+    {
+      keys_[i].set_int(i);
+      ranges_[i].table_id_ = 1001;
+      ranges_[i].start_key_.assign(&keys_[i], 1);
+      ranges_[i].end_key_.assign(&keys_[i], 1);
+    }
+    reset();
+  }
+  void reset()
+  {
+    memset(get_count_, 0, sizeof(get_count_));
+    memset(scan_count_, 0, sizeof(scan_count_));
+    memset(scan_bytes_, 0, sizeof(scan_bytes_));
+  }
+  int fetch_tablet_access(chunkserver::ObTableLoadCollector &collector) const
+  {
+    for (int64_t i = 0; i < TABLET_NUM; ++i)
+    {
+      if (0 < get_count_[i] || 0 < scan_count_[i] || 0 < scan_bytes_[i])
+      {
+        collector.add_tablet_access(ranges_[i], get_count_[i], scan_count_[i], scan_bytes_[i]);
+      }
+    }
+    return OB_SUCCESS;
+  }
+};
+
+TEST(ObTableLoadCollectorTest, rate_and_top_tablets)
+{
+  const int64_t interval = chunkserver::ObTableLoadCollector::COLLECT_INTERVAL_US;
+  const int64_t start = 1000000;
+  chunkserver::ObChunkServerStatManager stat_mgr;
+  chunkserver::ObTableLoadCollector *collector = new chunkserver::ObTableLoadCollector();
+  TestTabletImage *image = new TestTabletImage();
+  ObServerLoad load;
+
+  // the counters before the first collection are discarded
+  ASSERT_EQ(OB_SUCCESS, stat_mgr.set_value(OB_STAT_CHUNKSERVER, 1001, INDEX_GET_COUNT, 5000));
+  image->get_count_[0] = 5000;
+  collector->collect(stat_mgr, *image, start, load);
+  ASSERT_EQ(0, load.get_table_count());
+  ASSERT_EQ(0, load.get_tablet_count());
+
+  // rates in the interval of 10s
+  ASSERT_EQ(OB_SUCCESS, stat_mgr.set_value(OB_STAT_CHUNKSERVER, 1001, INDEX_GET_COUNT, 15000));
+  ASSERT_EQ(OB_SUCCESS, stat_mgr.set_value(OB_STAT_CHUNKSERVER, 1001, INDEX_SCAN_COUNT, 2000));
+  ASSERT_EQ(OB_SUCCESS, stat_mgr.set_value(OB_STAT_CHUNKSERVER, 1001, INDEX_SCAN_BYTES, 100000));
+  for (int64_t i = 0; i < TestTabletImage::TABLET_NUM; ++i)
+  {
+    image->get_count_[i] = 10 * i;
+  }
+  image->scan_count_[0] = 20;
+  image->scan_bytes_[0] = 100000;
+  collector->collect(stat_mgr, *image, start + interval, load);
+  ASSERT_EQ(1, load.get_table_count());
+  ASSERT_EQ(1000, load.get_table_load(1001)->get_qps_);
+  ASSERT_EQ(200, load.get_table_load(1001)->scan_qps_);
+  ASSERT_EQ(10000, load.get_table_load(1001)->scan_bytes_);
+  // only the hottest tablets, hottest first
+  ASSERT_EQ(ObServerLoad::MAX_TABLET_LOAD_COUNT + 0, load.get_tablet_count());
+  for (int64_t i = 0; i < load.get_tablet_count(); ++i)
+  {
+    const int64_t idx = TestTabletImage::TABLET_NUM - 1 - i;
+    ASSERT_EQ(idx, load.tablet_at(i).get_qps_);
+    ASSERT_EQ(ObTabletLoad::get_range_hash(image->ranges_[idx]), load.tablet_at(i).range_hash_);
+  }
+  // tablet 0 is not hot enough by qps
+  ASSERT_TRUE(NULL == load.get_tablet_load(1001, ObTabletLoad::get_range_hash(image->ranges_[0])));
+
+  // cached within the interval
+  image->reset();
+  image->get_count_[0] = 1000000;
+  collector->collect(stat_mgr, *image, start + interval + 1, load);
+  ASSERT_EQ(ObServerLoad::MAX_TABLET_LOAD_COUNT + 0, load.get_tablet_count());
+  ASSERT_EQ(TestTabletImage::TABLET_NUM - 1, load.tablet_at(0).get_qps_);
+
+  // counters of the table reset, no load of the table
+  ASSERT_EQ(OB_SUCCESS, stat_mgr.set_value(OB_STAT_CHUNKSERVER, 1001, INDEX_GET_COUNT, 0));
+  ASSERT_EQ(OB_SUCCESS, stat_mgr.set_value(OB_STAT_CHUNKSERVER, 1001, INDEX_SCAN_COUNT, 0));
+  ASSERT_EQ(OB_SUCCESS, stat_mgr.set_value(OB_STAT_CHUNKSERVER, 1001, INDEX_SCAN_BYTES, 0));
+  collector->collect(stat_mgr, *image, start + 2 * interval, load);
+  ASSERT_EQ(0, load.get_table_count());
+  ASSERT_EQ(1, load.get_tablet_count());
+  ASSERT_EQ(100000, load.tablet_at(0).get_qps_);
+
+  delete image;
+  delete collector;
+}
+
 int main(int argc, char **argv)
 {
   ob_init_memory_pool();
@@ -0,0 +1,202 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_hash_groupby_test.cpp
+ *
+ */
+#include "sql/ob_hash_groupby.h"
+#include "ob_fake_table.h"
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+using namespace oceanbase::common;
+using namespace oceanbase::sql;
+
+class ObHashGroupByTest: public ::testing::Test
+{
+  public:
+    ObHashGroupByTest();
+    virtual ~ObHashGroupByTest();
+    virtual void SetUp();
+    virtual void TearDown();
+  protected:
+    void cons_groupby(ObHashGroupBy &groupby, test::ObFakeTable &input);
+    void verify_result(ObHashGroupBy &groupby, const int64_t row_count);
+  protected:
+    static const int64_t AGGR_CID = 9999;
+  private:
+    // disallow copy
+    ObHashGroupByTest(const ObHashGroupByTest &other);
+    ObHashGroupByTest& operator=(const ObHashGroupByTest &other);
+};
+
+ObHashGroupByTest::ObHashGroupByTest()
+{
+}
+
+ObHashGroupByTest::~ObHashGroupByTest()
+{
+}
+
+void ObHashGroupByTest::SetUp()
+{
+}
+
+void ObHashGroupByTest::TearDown()
+{
+}
+
+// sum(c1) group by c3, note that the input is NOT sorted by c3
+void ObHashGroupByTest::cons_groupby(ObHashGroupBy &groupby, test::ObFakeTable &input)
+{
+  ASSERT_EQ(OB_SUCCESS, groupby.add_group_column(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+3));
+  ObSqlExpression sexpr;
+  sexpr.set_aggr_func(T_FUN_SUM, false);
+  sexpr.set_tid_cid(OB_INVALID_ID, AGGR_CID);
+  ExprItem expr_item;
+  expr_item.type_ = T_REF_COLUMN;
+  expr_item.value_.cell_.tid = test::ObFakeTable::TABLE_ID;
+  expr_item.value_.cell_.cid = OB_APP_MIN_COLUMN_ID+1;
+  sexpr.add_expr_item(expr_item); // c1
+  sexpr.add_expr_item_end();
+  ASSERT_EQ(OB_SUCCESS, groupby.add_aggr_column(sexpr));
+  ASSERT_EQ(OB_SUCCESS, groupby.set_child(0, input));
+}
+
+void ObHashGroupByTest::verify_result(ObHashGroupBy &groupby, const int64_t row_count)
+{
+  const ObRow *row = NULL;
+  const ObObj *cell = NULL;
+  int64_t group = 0;
+  int64_t sum = 0;
+  int64_t expected_sums[3] = {0, 0, 0};
+  bool seen[3] = {false, false, false};
+  for (int64_t i = 0; i < row_count; ++i)
+  {
+    expected_sums[i%3] += i;
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, groupby.get_next_row(row));
+    ASSERT_EQ(OB_SUCCESS, row->get_cell(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+3, cell));
+    ASSERT_EQ(OB_SUCCESS, cell->get_int(group));
+    ASSERT_TRUE(0 <= group && group < 3);
+    ASSERT_FALSE(seen[group]);
+    seen[group] = true;
+    ASSERT_EQ(OB_SUCCESS, row->get_cell(OB_INVALID_ID, AGGR_CID, cell));
+    ASSERT_EQ(OB_SUCCESS, cell->get_int(sum));
+    ASSERT_EQ(expected_sums[group], sum);
+  }
+  ASSERT_EQ(OB_ITER_END, groupby.get_next_row(row));
+  ASSERT_EQ(OB_ITER_END, groupby.get_next_row(row));
+}
+
+TEST_F(ObHashGroupByTest, basic_test)
+{
+  static const int64_t ROW_COUNT = 100;
+  ObHashGroupBy groupby;
+  test::ObFakeTable input;
+  input.set_row_count(ROW_COUNT);
+  cons_groupby(groupby, input);
+  char strbuff[1024];
+  groupby.to_string(strbuff, 1024);
+  TBSYS_LOG(INFO, "groupby=%s", strbuff);
+  ASSERT_EQ(OB_SUCCESS, groupby.open());
+  verify_result(groupby, ROW_COUNT);
+  ASSERT_EQ(OB_SUCCESS, groupby.close());
+  // reopen
+  ASSERT_EQ(OB_SUCCESS, groupby.open());
+  verify_result(groupby, ROW_COUNT);
+  ASSERT_EQ(OB_SUCCESS, groupby.close());
+}
+
+TEST_F(ObHashGroupByTest, single_bucket)
+{
+  static const int64_t ROW_COUNT = 100;
+  ObHashGroupBy groupby;
+  test::ObFakeTable input;
+  input.set_row_count(ROW_COUNT);
+  cons_groupby(groupby, input);
+  ASSERT_EQ(OB_INVALID_ARGUMENT, groupby.set_bucket_num(0));
+  ASSERT_EQ(OB_SUCCESS, groupby.set_bucket_num(1));
+  ASSERT_EQ(OB_SUCCESS, groupby.open());
+  verify_result(groupby, ROW_COUNT);
+  ASSERT_EQ(OB_SUCCESS, groupby.close());
+}
+
+TEST_F(ObHashGroupByTest, dump_buckets)
+{
+  static const int64_t ROW_COUNT = 30;
+  ObHashGroupBy groupby;
+  test::ObFakeTable input;
+  input.set_row_count(ROW_COUNT);
+  cons_groupby(groupby, input);
+  const char* filename = "ob_hash_groupby_test.run";
+  ObString run_filename;
+  run_filename.assign_ptr(const_cast<char*>(filename), static_cast<int32_t>(strlen(filename)));
+  ASSERT_EQ(OB_SUCCESS, groupby.set_run_filename(run_filename));
+  // dump all buckets after every input row
+  groupby.set_mem_size_limit(1);
+  ASSERT_EQ(OB_SUCCESS, groupby.open());
+  verify_result(groupby, ROW_COUNT);
+  ASSERT_EQ(OB_SUCCESS, groupby.close());
+  struct stat stat_buf;
+  ASSERT_NE(0, stat(filename, &stat_buf));
+}
+
+// a bucket still exceeding the mem limit after being loaded is split again
+TEST_F(ObHashGroupByTest, repartition_buckets)
+{
+  static const int64_t ROW_COUNT = 300;
+  ObHashGroupBy groupby;
+  test::ObFakeTable input;
+  input.set_row_count(ROW_COUNT);
+  cons_groupby(groupby, input);
+  const char* filename = "ob_hash_groupby_test.run";
+  ObString run_filename;
+  run_filename.assign_ptr(const_cast<char*>(filename), static_cast<int32_t>(strlen(filename)));
+  ASSERT_EQ(OB_SUCCESS, groupby.set_run_filename(run_filename));
+  ASSERT_EQ(OB_SUCCESS, groupby.set_bucket_num(2));
+  groupby.set_mem_size_limit(4096);
+  ASSERT_EQ(OB_SUCCESS, groupby.open());
+  verify_result(groupby, ROW_COUNT);
+  ASSERT_EQ(OB_SUCCESS, groupby.close());
+  // reopen
+  ASSERT_EQ(OB_SUCCESS, groupby.open());
+  verify_result(groupby, ROW_COUNT);
+  ASSERT_EQ(OB_SUCCESS, groupby.close());
+  struct stat stat_buf;
+  ASSERT_NE(0, stat(filename, &stat_buf));
+}
+
+TEST_F(ObHashGroupByTest, serialize)
+{
+  ObHashGroupBy groupby;
+  test::ObFakeTable input;
+  cons_groupby(groupby, input);
+  ASSERT_EQ(OB_SUCCESS, groupby.set_bucket_num(32));
+  groupby.set_int_div_as_double(true);
+  char buf[1024];
+  int64_t pos = 0;
+  ASSERT_EQ(OB_SUCCESS, groupby.serialize(buf, sizeof(buf), pos));
+  ASSERT_EQ(groupby.get_serialize_size(), pos);
+  ObHashGroupBy groupby2;
+  int64_t data_len = pos;
+  pos = 0;
+  ASSERT_EQ(OB_SUCCESS, groupby2.deserialize(buf, data_len, pos));
+  ASSERT_EQ(data_len, pos);
+  ASSERT_EQ(32, groupby2.get_bucket_num());
+  ASSERT_TRUE(groupby2.get_int_div_as_double());
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,317 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_hash_join_test.cpp
+ *
+ */
+#include "sql/ob_hash_join.h"
+#include "ob_fake_table.h"
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+class ObHashJoinTest: public ::testing::Test
+{
+  public:
+    ObHashJoinTest();
+    virtual ~ObHashJoinTest();
+    virtual void SetUp();
+    virtual void TearDown();
+  protected:
+    static const uint64_t LEFT_TID = 1001;
+    static const uint64_t RIGHT_TID = 2001;
+    // equijoin: left.c5 = right.c1, i.e. left_idx/3 = right_idx
+    static const int64_t LEFT_CID = 5;
+    static const int64_t RIGHT_CID = 1;
+    int64_t expected_row_count(ObJoin::JoinType join_type, int64_t left_row_count, int64_t right_row_count,
+                               bool has_other_cond);
+    void test_join(ObJoin::JoinType join_type, int64_t left_row_count, int64_t right_row_count,
+                   bool has_other_cond, bool build_left, int64_t mem_size_limit);
+  private:
+    // disallow copy
+    ObHashJoinTest(const ObHashJoinTest &other);
+    ObHashJoinTest& operator=(const ObHashJoinTest &other);
+};
+
+ObHashJoinTest::ObHashJoinTest()
+{
+}
+
+ObHashJoinTest::~ObHashJoinTest()
+{
+}
+
+void ObHashJoinTest::SetUp()
+{
+}
+
+void ObHashJoinTest::TearDown()
+{
+}
+
+// nested loop join on the fake table data
+int64_t ObHashJoinTest::expected_row_count(ObJoin::JoinType join_type, int64_t left_row_count,
+                                           int64_t right_row_count, bool has_other_cond)
+{
+  int64_t inner = 0;
+  int64_t left_matched = 0;
+  int64_t right_matched = 0;
+  bool *right_flags = new bool[right_row_count];
+  memset(right_flags, 0, right_row_count);
+  for (int64_t l = 0; l < left_row_count; ++l)
+  {
+    bool matched = false;
+    for (int64_t r = 0; r < right_row_count; ++r)
+    {
+      if (l/3 == r && (!has_other_cond || 0 == l%2))
+      {
+        ++inner;
+        matched = true;
+        right_flags[r] = true;
+      }
+    }
+    if (matched)
+    {
+      ++left_matched;
+    }
+  }
+  for (int64_t r = 0; r < right_row_count; ++r)
+  {
+    if (right_flags[r])
+    {
+      ++right_matched;
+    }
+  }
+  delete [] right_flags;
+  int64_t ret = 0;
+  switch(join_type)
+  {
+    case ObJoin::INNER_JOIN:
+      ret = inner;
+      break;
+    case ObJoin::LEFT_OUTER_JOIN:
+      ret = inner + left_row_count - left_matched;
+      break;
+    case ObJoin::RIGHT_OUTER_JOIN:
+      ret = inner + right_row_count - right_matched;
+      break;
+    case ObJoin::FULL_OUTER_JOIN:
+      ret = inner + left_row_count - left_matched + right_row_count - right_matched;
+      break;
+    case ObJoin::LEFT_SEMI_JOIN:
+      ret = left_matched;
+      break;
+    case ObJoin::RIGHT_SEMI_JOIN:
+      ret = right_matched;
+      break;
+    case ObJoin::LEFT_ANTI_SEMI_JOIN:
+      ret = left_row_count - left_matched;
+      break;
+    case ObJoin::RIGHT_ANTI_SEMI_JOIN:
+      ret = right_row_count - right_matched;
+      break;
+    default:
+      break;
+  }
+  return ret;
+}
+
+void ObHashJoinTest::test_join(ObJoin::JoinType join_type, int64_t left_row_count, int64_t right_row_count,
+                               bool has_other_cond, bool build_left, int64_t mem_size_limit)
+{
+  test::ObFakeTable left_input;
+  left_input.set_row_count(left_row_count);
+  left_input.set_table_id(LEFT_TID);
+  test::ObFakeTable right_input;
+  right_input.set_row_count(right_row_count);
+  right_input.set_table_id(RIGHT_TID);
+  ObHashJoin hash_join;
+  ASSERT_EQ(OB_SUCCESS, hash_join.set_child(0, left_input));
+  ASSERT_EQ(OB_SUCCESS, hash_join.set_child(1, right_input));
+  ASSERT_EQ(OB_SUCCESS, hash_join.set_join_type(join_type));
+  hash_join.set_build_left(build_left);
+  const uint64_t LEFT_COL = OB_APP_MIN_COLUMN_ID + LEFT_CID;
+  const uint64_t RIGHT_COL = OB_APP_MIN_COLUMN_ID + RIGHT_CID;
+  {
+    ObSqlExpression expr;
+    ExprItem item;
+    item.type_ = T_REF_COLUMN;
+    item.value_.cell_.tid = LEFT_TID;
+    item.value_.cell_.cid = LEFT_COL;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    item.type_ = T_REF_COLUMN;
+    item.value_.cell_.tid = RIGHT_TID;
+    item.value_.cell_.cid = RIGHT_COL;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    item.type_ = T_OP_EQ;
+    item.value_.int_ = 2;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item_end());
+    ASSERT_EQ(OB_SUCCESS, hash_join.add_equijoin_condition(expr));
+  }
+  // other cond: left.c1 % 2 = 0
+  if (has_other_cond)
+  {
+    ObSqlExpression expr;
+    ExprItem item;
+    item.type_ = T_REF_COLUMN;
+    item.value_.cell_.tid = LEFT_TID;
+    item.value_.cell_.cid = OB_APP_MIN_COLUMN_ID + 1;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    item.type_ = T_INT;
+    item.value_.int_ = 2;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    item.type_ = T_OP_MOD;
+    item.value_.int_ = 2;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    item.type_ = T_INT;
+    item.value_.int_ = 0;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    item.type_ = T_OP_EQ;
+    item.value_.int_ = 2;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item_end());
+    ASSERT_EQ(OB_SUCCESS, hash_join.add_other_join_condition(expr));
+  }
+  const char* filename = "ob_hash_join_test.run";
+  if (0 < mem_size_limit)
+  {
+    ObString run_filename;
+    run_filename.assign_ptr(const_cast<char*>(filename), static_cast<int32_t>(strlen(filename)));
+    ASSERT_EQ(OB_SUCCESS, hash_join.set_run_filename(run_filename));
+    ASSERT_EQ(OB_SUCCESS, hash_join.set_partition_num(4));
+    hash_join.set_mem_size_limit(mem_size_limit);
+  }
+  char buff[1024];
+  hash_join.to_string(buff, 1024);
+  printf("%s\n", buff);
+
+  ASSERT_EQ(OB_SUCCESS, hash_join.open());
+  const ObRowDesc *row_desc = NULL;
+  ASSERT_EQ(OB_SUCCESS, hash_join.get_row_desc(row_desc));
+  const bool only_left = (ObJoin::LEFT_SEMI_JOIN == join_type || ObJoin::LEFT_ANTI_SEMI_JOIN == join_type);
+  const bool only_right = (ObJoin::RIGHT_SEMI_JOIN == join_type || ObJoin::RIGHT_ANTI_SEMI_JOIN == join_type);
+  const ObRow *row = NULL;
+  const ObObj *cell = NULL;
+  int64_t row_count = 0;
+  int64_t left_key = 0;
+  int64_t right_key = 0;
+  int ret = OB_SUCCESS;
+  while (OB_SUCCESS == (ret = hash_join.get_next_row(row)))
+  {
+    ++row_count;
+    if (only_left)
+    {
+      ASSERT_EQ(left_input.get_row_desc().get_column_num(), row->get_column_num());
+    }
+    else if (only_right)
+    {
+      ASSERT_EQ(right_input.get_row_desc().get_column_num(), row->get_column_num());
+    }
+    else
+    {
+      ASSERT_EQ(left_input.get_row_desc().get_column_num() + right_input.get_row_desc().get_column_num(),
+                row->get_column_num());
+      ASSERT_EQ(OB_SUCCESS, row->get_cell(LEFT_TID, LEFT_COL, cell));
+      const bool left_is_null = cell->is_null();
+      if (!left_is_null)
+      {
+        ASSERT_EQ(OB_SUCCESS, cell->get_int(left_key));
+      }
+      ASSERT_EQ(OB_SUCCESS, row->get_cell(RIGHT_TID, RIGHT_COL, cell));
+      const bool right_is_null = cell->is_null();
+      if (!right_is_null)
+      {
+        ASSERT_EQ(OB_SUCCESS, cell->get_int(right_key));
+      }
+      ASSERT_FALSE(left_is_null && right_is_null);
+      if (!left_is_null && !right_is_null)
+      {
+        ASSERT_EQ(left_key, right_key);
+      }
+    }
+  } // end while
+  ASSERT_EQ(OB_ITER_END, ret);
+  ASSERT_EQ(OB_ITER_END, hash_join.get_next_row(row));
+  ASSERT_EQ(expected_row_count(join_type, left_row_count, right_row_count, has_other_cond), row_count);
+  ASSERT_EQ(OB_SUCCESS, hash_join.close());
+  struct stat stat_buf;
+  ASSERT_NE(0, stat(filename, &stat_buf));
+}
+
+TEST_F(ObHashJoinTest, all_join_types)
+{
+  ObJoin::JoinType join_types[] = {
+    ObJoin::INNER_JOIN,
+    ObJoin::LEFT_OUTER_JOIN,
+    ObJoin::RIGHT_OUTER_JOIN,
+    ObJoin::FULL_OUTER_JOIN,
+    ObJoin::LEFT_SEMI_JOIN,
+    ObJoin::RIGHT_SEMI_JOIN,
+    ObJoin::LEFT_ANTI_SEMI_JOIN,
+    ObJoin::RIGHT_ANTI_SEMI_JOIN
+  };
+  int64_t row_counts[][2] = {{0, 0}, {0, 10}, {10, 0}, {30, 5}, {30, 10}, {30, 20}, {1, 1}};
+  for (int64_t i = 0; i < static_cast<int64_t>(ARRAYSIZEOF(join_types)); ++i)
+  {
+    for (int64_t j = 0; j < static_cast<int64_t>(ARRAYSIZEOF(row_counts)); ++j)
+    {
+      for (int k = 0; k < 8; ++k)
+      {
+        // a limit of 1 byte dumps all partitions after every input row,
+        // and every loaded partition is repartitioned up to the max level
+        test_join(join_types[i], row_counts[j][0], row_counts[j][1],
+                  0 != (k & 1), 0 != (k & 2), (0 != (k & 4)) ? 1 : 0);
+      }
+    }
+  }
+}
+
+TEST_F(ObHashJoinTest, repartition)
+{
+  ObJoin::JoinType join_types[] = {
+    ObJoin::INNER_JOIN,
+    ObJoin::FULL_OUTER_JOIN,
+    ObJoin::RIGHT_ANTI_SEMI_JOIN
+  };
+  // one 2MB block of the row store plus 100 row pointers, so the build side is dumped
+  // every 100 rows, and a partition of more than 100 rows is repartitioned when loaded
+  const int64_t mem_size_limit = 2*1024*1024 + 100*sizeof(void*);
+  for (int64_t i = 0; i < static_cast<int64_t>(ARRAYSIZEOF(join_types)); ++i)
+  {
+    for (int k = 0; k < 4; ++k)
+    {
+      test_join(join_types[i], 1500, 500, 0 != (k & 1), 0 != (k & 2), mem_size_limit);
+    }
+  }
+}
+
+TEST_F(ObHashJoinTest, invalid_argument)
+{
+  ObHashJoin hash_join;
+  ASSERT_EQ(OB_INVALID_ARGUMENT, hash_join.set_partition_num(0));
+  ASSERT_EQ(OB_INVALID_ARGUMENT, hash_join.set_partition_num(257));
+  ASSERT_EQ(OB_SUCCESS, hash_join.set_partition_num(1));
+  ASSERT_EQ(1, hash_join.get_partition_num());
+  // equijoin conditions are required
+  test::ObFakeTable left_input;
+  test::ObFakeTable right_input;
+  ASSERT_EQ(OB_SUCCESS, hash_join.set_child(0, left_input));
+  ASSERT_EQ(OB_SUCCESS, hash_join.set_child(1, right_input));
+  ASSERT_EQ(OB_SUCCESS, hash_join.set_join_type(ObJoin::INNER_JOIN));
+  ASSERT_EQ(OB_NOT_SUPPORTED, hash_join.open());
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
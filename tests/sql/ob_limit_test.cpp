@@ -20,6 +20,7 @@
 #include "sql/ob_sql_expression.h"
 #include "common/ob_row.h"
 #include "sql/ob_limit.h"
+#include "sql/ob_sort.h"
 #include "ob_fake_table.h"
 
 
@@ -194,6 +195,44 @@ TEST_F(ObLimitTest, serialize_test)
 }
 
 
+TEST_F(ObLimitTest, limit_over_sort_test)
+{
+  ObLimit limiter;
+  ObSort sort;
+  ObFakeTable phy_op;
+  const ObRow *row = NULL;
+  const ObObj *cell = NULL;
+  int64_t int_cell = 0;
+
+  phy_op.set_row_count(10000);
+  ASSERT_EQ(OB_SUCCESS, sort.add_sort_column(ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+1, false));
+  ASSERT_EQ(OB_SUCCESS, sort.set_child(0, phy_op));
+  ASSERT_EQ(OB_SUCCESS, limiter.set_child(0, sort));
+  ObSqlExpression limit;
+  ObSqlExpression offset;
+  ExprItem item;
+  item.type_ = T_INT;
+  item.data_type_ = ObIntType;
+  item.value_.int_ = 10;
+  ASSERT_EQ(OB_SUCCESS, limit.add_expr_item(item));
+  ASSERT_EQ(OB_SUCCESS, limit.add_expr_item_end());
+  item.value_.int_ = 5;
+  ASSERT_EQ(OB_SUCCESS, offset.add_expr_item(item));
+  ASSERT_EQ(OB_SUCCESS, offset.add_expr_item_end());
+  ASSERT_EQ(OB_SUCCESS, limiter.set_limit(limit, offset));
+  ASSERT_EQ(OB_SUCCESS, limiter.open());
+  // the sort keeps offset+limit rows only
+  ASSERT_EQ(15, sort.get_topn());
+  for (int64_t i = 0; i < 10; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, limiter.get_next_row(row));
+    ASSERT_EQ(OB_SUCCESS, row->get_cell(ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+1, cell));
+    ASSERT_EQ(OB_SUCCESS, cell->get_int(int_cell));
+    ASSERT_EQ(10000 - 6 - i, int_cell);
+  }
+  ASSERT_EQ(OB_ITER_END, limiter.get_next_row(row));
+  limiter.close();
+}
 
 int main(int argc, char **argv)
 {
@@ -36,6 +36,9 @@ class ObMergeSortTest: public ::testing::Test
     ObMergeSort merge_sort_;
     ObArray<ObSortColumn> sort_columns_;
     ObInMemorySort in_mem_sort_;
+    ObInMemorySort in_mem_sort2_;
+  protected:
+    void verify(const int64_t row_count);
 };
 
 ObMergeSortTest::ObMergeSortTest()
@@ -64,12 +67,53 @@ void ObMergeSortTest::SetUp()
   merge_sort_.set_run_filename(filename);
   merge_sort_.set_sort_columns(sort_columns_);
   in_mem_sort_.set_sort_columns(sort_columns_);
+  in_mem_sort2_.set_sort_columns(sort_columns_);
 }
 
 void ObMergeSortTest::TearDown()
 {
   merge_sort_.reset();
   in_mem_sort_.reset();
+  in_mem_sort2_.reset();
+}
+
+void ObMergeSortTest::verify(const int64_t row_count)
+{
+  const ObRow *curr_row = NULL;
+  char buff[1024];
+  ObString str_cell1;
+  ObObj last_cell1;
+  ObObj last_cell2;
+  int64_t int_cell2 = 0;
+  const ObObj *cell1 = NULL;
+  const ObObj *cell2 = NULL;
+  for (int64_t i = 0; i < row_count; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, merge_sort_.get_next_row(curr_row));
+    ASSERT_EQ(OB_SUCCESS, curr_row->get_cell(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID, cell1));
+    ASSERT_EQ(OB_SUCCESS, curr_row->get_cell(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+1, cell2));
+    if (0 < i)
+    {
+      // check order
+      if (last_cell1 == *cell1)
+      {
+        ASSERT_TRUE(last_cell2 <= *cell2);
+      }
+      else
+      {
+        ASSERT_TRUE(last_cell1 > *cell1);
+      }
+    }
+    ASSERT_EQ(OB_SUCCESS, cell1->get_varchar(str_cell1));
+    ASSERT_TRUE(1024 > str_cell1.length());
+    memcpy(buff, str_cell1.ptr(), str_cell1.length());
+    str_cell1.assign_ptr(buff, str_cell1.length());
+    last_cell1.set_varchar(str_cell1);
+    ASSERT_EQ(OB_SUCCESS, cell2->get_int(int_cell2));
+    last_cell2.set_int(int_cell2);
+  }
+  ASSERT_EQ(OB_ITER_END, merge_sort_.get_next_row(curr_row));
+  ASSERT_EQ(OB_ITER_END, merge_sort_.get_next_row(curr_row));
 }
 
 TEST_F(ObMergeSortTest, basic_test)
@@ -81,7 +125,7 @@ TEST_F(ObMergeSortTest, basic_test)
   for (int i = 0; i < dump_run_count + 1; ++i)
   {
     ASSERT_EQ(OB_SUCCESS, input_table_.open());
-    in_mem_sort_.reset();
+    in_mem_sort_.reuse();
     const ObRow *row = NULL;
     for (int j = 0; j < row_count_per_run; ++j)
     {
@@ -102,7 +146,7 @@ TEST_F(ObMergeSortTest, basic_test)
 
   // verify
   ASSERT_EQ(OB_SUCCESS, input_table_.open());
-  ASSERT_EQ(OB_SUCCESS, merge_sort_.build_merge_heap());
+  ASSERT_EQ(OB_SUCCESS, merge_sort_.build_merge_tree());
   const ObRow *curr_row = NULL;
   char buff[1024];
   ObString str_cell1;
@@ -141,6 +185,47 @@ TEST_F(ObMergeSortTest, basic_test)
   ASSERT_EQ(OB_SUCCESS, input_table_.close());
 }
 
+TEST_F(ObMergeSortTest, async_dump_test)
+{
+  static const int dump_run_count = 5;
+  static const int64_t row_count_per_run = 100*1024;
+  ObInMemorySort *rows = &in_mem_sort_;
+  ObInMemorySort *next_rows = &in_mem_sort2_;
+  in_mem_sort_.set_sort_thread_count(4);
+  in_mem_sort2_.set_sort_thread_count(4);
+  merge_sort_.set_merge_mem_size(64*1024*1024L);
+
+  input_table_.set_row_count(row_count_per_run);
+  for (int i = 0; i < dump_run_count + 1; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, input_table_.open());
+    const ObRow *row = NULL;
+    for (int j = 0; j < row_count_per_run; ++j)
+    {
+      ASSERT_EQ(OB_SUCCESS, input_table_.get_next_row(row));
+      ASSERT_EQ(OB_SUCCESS, rows->add_row(*row));
+    }
+    if (i < dump_run_count)
+    {
+      ASSERT_EQ(OB_SUCCESS, merge_sort_.wait_dump());
+      ASSERT_EQ(OB_SUCCESS, merge_sort_.async_dump_run(*rows));
+      std::swap(rows, next_rows);
+      rows->reuse();
+    }
+    else
+    {
+      ASSERT_EQ(OB_SUCCESS, rows->sort_rows());
+      merge_sort_.set_final_run(*rows);
+    }
+    ASSERT_EQ(OB_SUCCESS, input_table_.close());
+  } // end for
+
+  ASSERT_EQ(OB_SUCCESS, input_table_.open());
+  ASSERT_EQ(OB_SUCCESS, merge_sort_.build_merge_tree());
+  verify(row_count_per_run * (dump_run_count + 1));
+  ASSERT_EQ(OB_SUCCESS, input_table_.close());
+}
+
 int main(int argc, char **argv)
 {
   ob_init_memory_pool();
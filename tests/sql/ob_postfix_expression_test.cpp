@@ -1436,6 +1436,267 @@ TEST_F(ObPostfixExpressionTest, case_func_test)
 }
 
 
+static ExprItem make_column_item(const uint64_t tid, const uint64_t cid)
+{
+  ExprItem item;
+  item.type_ = T_REF_COLUMN;
+  item.value_.cell_.tid = tid;
+  item.value_.cell_.cid = cid;
+  return item;
+}
+
+static ExprItem make_int_item(const int64_t v)
+{
+  ExprItem item;
+  item.type_ = T_INT;
+  item.value_.int_ = v;
+  return item;
+}
+
+static ExprItem make_op_item(const ObItemType op, const int64_t param_count)
+{
+  ExprItem item;
+  item.type_ = op;
+  item.value_.int_ = param_count;
+  return item;
+}
+
+// testcase:
+// c1 > 10 AND c2 <= c3 * 2
+TEST_F(ObPostfixExpressionTest, compiled_expr_test)
+{
+  sql::ObPostfixExpression p;
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_column_item(1001, 16)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_int_item(10)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_op_item(T_OP_GT, 2)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_column_item(1001, 17)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_column_item(1001, 18)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_int_item(2)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_op_item(T_OP_MUL, 2)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_op_item(T_OP_LE, 2)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_op_item(T_OP_AND, 2)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item_end());
+  ASSERT_FALSE(p.is_compiled());
+
+  ObRowDesc row_desc;
+  ASSERT_EQ(OB_SUCCESS, row_desc.add_column_desc(1001, 16));
+  ASSERT_EQ(OB_SUCCESS, row_desc.add_column_desc(1001, 17));
+  ASSERT_EQ(OB_SUCCESS, row_desc.add_column_desc(1001, 18));
+  ObRow row;
+  row.set_row_desc(row_desc);
+  ObObj c1, c2, c3;
+  const ObObj *result = NULL;
+  bool re = false;
+  // int columns
+  c1.set_int(11);
+  c2.set_int(6);
+  c3.set_int(3);
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 16, c1));
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 17, c2));
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 18, c3));
+  ASSERT_EQ(OB_SUCCESS, p.calc(row, result));
+  ASSERT_TRUE(p.is_compiled());
+  ASSERT_EQ(OB_SUCCESS, result->get_bool(re));
+  ASSERT_TRUE(re);
+  c2.set_int(7);
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 17, c2));
+  ASSERT_EQ(OB_SUCCESS, p.calc(row, result));
+  ASSERT_EQ(OB_SUCCESS, result->get_bool(re));
+  ASSERT_FALSE(re);
+  // short circuit
+  c1.set_int(10);
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 16, c1));
+  c2.set_int(6);
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 17, c2));
+  ASSERT_EQ(OB_SUCCESS, p.calc(row, result));
+  ASSERT_EQ(OB_SUCCESS, result->get_bool(re));
+  ASSERT_FALSE(re);
+  // mixed types go through ObExprObj
+  c1.set_double(10.5);
+  c2.set_double(5.5);
+  c3.set_float(3.0f);
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 16, c1));
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 17, c2));
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 18, c3));
+  ASSERT_EQ(OB_SUCCESS, p.calc(row, result));
+  ASSERT_EQ(OB_SUCCESS, result->get_bool(re));
+  ASSERT_TRUE(re);
+  // NULL AND TRUE is NULL
+  c1.set_null();
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 16, c1));
+  ASSERT_EQ(OB_SUCCESS, p.calc(row, result));
+  ASSERT_TRUE(result->is_null());
+  // NULL AND FALSE is FALSE
+  c2.set_double(6.5);
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 17, c2));
+  ASSERT_EQ(OB_SUCCESS, p.calc(row, result));
+  ASSERT_EQ(OB_SUCCESS, result->get_bool(re));
+  ASSERT_FALSE(re);
+
+  // the copy is compiled again
+  sql::ObPostfixExpression p2;
+  p2 = p;
+  ASSERT_FALSE(p2.is_compiled());
+  c1.set_int(100);
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 16, c1));
+  ASSERT_EQ(OB_SUCCESS, p2.calc(row, result));
+  ASSERT_TRUE(p2.is_compiled());
+  ASSERT_EQ(OB_SUCCESS, result->get_bool(re));
+  ASSERT_FALSE(re);
+
+  // the same row desc object is rebuilt with another column order
+  row_desc.reset();
+  ASSERT_EQ(OB_SUCCESS, row_desc.add_column_desc(1001, 18));
+  ASSERT_EQ(OB_SUCCESS, row_desc.add_column_desc(1001, 17));
+  ASSERT_EQ(OB_SUCCESS, row_desc.add_column_desc(1001, 16));
+  row.set_row_desc(row_desc);
+  c1.set_int(11);
+  c2.set_int(6);
+  c3.set_int(3);
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 16, c1));
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 17, c2));
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 18, c3));
+  ASSERT_EQ(OB_SUCCESS, p2.calc(row, result));
+  ASSERT_EQ(OB_SUCCESS, result->get_bool(re));
+  ASSERT_TRUE(re);
+  // a row desc of the same layout shares the binding
+  ObRowDesc row_desc2;
+  ASSERT_EQ(OB_SUCCESS, row_desc2.add_column_desc(1001, 18));
+  ASSERT_EQ(OB_SUCCESS, row_desc2.add_column_desc(1001, 17));
+  ASSERT_EQ(OB_SUCCESS, row_desc2.add_column_desc(1001, 16));
+  ObRow row2;
+  row2.set_row_desc(row_desc2);
+  c2.set_int(7);
+  ASSERT_EQ(OB_SUCCESS, row2.set_cell(1001, 16, c1));
+  ASSERT_EQ(OB_SUCCESS, row2.set_cell(1001, 17, c2));
+  ASSERT_EQ(OB_SUCCESS, row2.set_cell(1001, 18, c3));
+  ASSERT_EQ(OB_SUCCESS, p2.calc(row2, result));
+  ASSERT_EQ(OB_SUCCESS, result->get_bool(re));
+  ASSERT_FALSE(re);
+}
+
+// testcase:
+// 3 < c1 OR c1 BETWEEN -5 AND 0, NOT (c1 / 2 = 1), c1 - 1 % 3
+TEST_F(ObPostfixExpressionTest, compiled_expr_ops_test)
+{
+  ObRowDesc row_desc;
+  ASSERT_EQ(OB_SUCCESS, row_desc.add_column_desc(1001, 16));
+  ObRow row;
+  row.set_row_desc(row_desc);
+  ObObj c1;
+  const ObObj *result = NULL;
+  bool re = false;
+  int64_t int_re = 0;
+  double double_re = 0.0;
+
+  sql::ObPostfixExpression p;
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_int_item(3)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_column_item(1001, 16)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_op_item(T_OP_LT, 2)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_column_item(1001, 16)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_int_item(-5)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_int_item(0)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_op_item(T_OP_BTW, 3)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_op_item(T_OP_OR, 2)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item_end());
+  int64_t values[] = {-6, -5, -1, 0, 1, 3, 4};
+  bool expected[] = {false, true, true, true, false, false, true};
+  for (int64_t i = 0; i < static_cast<int64_t>(sizeof(values)/sizeof(values[0])); ++i)
+  {
+    c1.set_int(values[i]);
+    ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 16, c1));
+    ASSERT_EQ(OB_SUCCESS, p.calc(row, result));
+    ASSERT_TRUE(p.is_compiled());
+    ASSERT_EQ(OB_SUCCESS, result->get_bool(re));
+    ASSERT_EQ(expected[i], re);
+  }
+
+  sql::ObPostfixExpression p2;
+  ASSERT_EQ(OB_SUCCESS, p2.add_expr_item(make_column_item(1001, 16)));
+  ASSERT_EQ(OB_SUCCESS, p2.add_expr_item(make_int_item(2)));
+  ASSERT_EQ(OB_SUCCESS, p2.add_expr_item(make_op_item(T_OP_DIV, 2)));
+  ASSERT_EQ(OB_SUCCESS, p2.add_expr_item_end());
+  c1.set_int(3);
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 16, c1));
+  p2.set_int_div_as_double(true);
+  ASSERT_EQ(OB_SUCCESS, p2.calc(row, result));
+  ASSERT_TRUE(p2.is_compiled());
+  ASSERT_EQ(OB_SUCCESS, result->get_double(double_re));
+  ASSERT_DOUBLE_EQ(1.5, double_re);
+
+  sql::ObPostfixExpression p3;
+  ASSERT_EQ(OB_SUCCESS, p3.add_expr_item(make_column_item(1001, 16)));
+  ASSERT_EQ(OB_SUCCESS, p3.add_expr_item(make_int_item(1)));
+  ASSERT_EQ(OB_SUCCESS, p3.add_expr_item(make_int_item(3)));
+  ASSERT_EQ(OB_SUCCESS, p3.add_expr_item(make_op_item(T_OP_MOD, 2)));
+  ASSERT_EQ(OB_SUCCESS, p3.add_expr_item(make_op_item(T_OP_MINUS, 2)));
+  ASSERT_EQ(OB_SUCCESS, p3.add_expr_item(make_int_item(2)));
+  ASSERT_EQ(OB_SUCCESS, p3.add_expr_item(make_op_item(T_OP_EQ, 2)));
+  ASSERT_EQ(OB_SUCCESS, p3.add_expr_item(make_op_item(T_OP_NOT, 1)));
+  ASSERT_EQ(OB_SUCCESS, p3.add_expr_item_end());
+  ASSERT_EQ(OB_SUCCESS, p3.calc(row, result));
+  ASSERT_TRUE(p3.is_compiled());
+  ASSERT_EQ(OB_SUCCESS, result->get_bool(re));
+  ASSERT_FALSE(re);
+  c1.set_int(4);
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 16, c1));
+  ASSERT_EQ(OB_SUCCESS, p3.calc(row, result));
+  ASSERT_EQ(OB_SUCCESS, result->get_bool(re));
+  ASSERT_TRUE(re);
+
+  // c1 + 1 with an unknown column falls back to the interpreter
+  sql::ObPostfixExpression p4;
+  ASSERT_EQ(OB_SUCCESS, p4.add_expr_item(make_column_item(1001, 99)));
+  ASSERT_EQ(OB_SUCCESS, p4.add_expr_item(make_int_item(1)));
+  ASSERT_EQ(OB_SUCCESS, p4.add_expr_item(make_op_item(T_OP_ADD, 2)));
+  ASSERT_EQ(OB_SUCCESS, p4.add_expr_item_end());
+  ASSERT_NE(OB_SUCCESS, p4.calc(row, result));
+  ASSERT_EQ(OB_SUCCESS, p4.add_expr_item(make_int_item(1)));
+  ASSERT_FALSE(p4.is_compiled());
+  p4.reset();
+  ASSERT_EQ(OB_SUCCESS, p4.add_expr_item(make_column_item(1001, 16)));
+  ASSERT_EQ(OB_SUCCESS, p4.add_expr_item(make_int_item(1)));
+  ASSERT_EQ(OB_SUCCESS, p4.add_expr_item(make_op_item(T_OP_ADD, 2)));
+  ASSERT_EQ(OB_SUCCESS, p4.add_expr_item_end());
+  ASSERT_EQ(OB_SUCCESS, p4.calc(row, result));
+  ASSERT_TRUE(p4.is_compiled());
+  ASSERT_EQ(OB_SUCCESS, result->get_int(int_re));
+  ASSERT_EQ(5, int_re);
+}
+
+// testcase:
+// c1 LIKE 'a%' is not compiled
+TEST_F(ObPostfixExpressionTest, compiled_expr_fallback_test)
+{
+  ObRowDesc row_desc;
+  ASSERT_EQ(OB_SUCCESS, row_desc.add_column_desc(1001, 16));
+  ObRow row;
+  row.set_row_desc(row_desc);
+  ObObj c1;
+  const ObObj *result = NULL;
+  bool re = false;
+
+  sql::ObPostfixExpression p;
+  ExprItem item_pattern;
+  item_pattern.type_ = T_STRING;
+  item_pattern.string_.assign_ptr(const_cast<char*>("a%"), 2);
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_column_item(1001, 16)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(item_pattern));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item(make_op_item(T_OP_LIKE, 2)));
+  ASSERT_EQ(OB_SUCCESS, p.add_expr_item_end());
+  c1.set_varchar(ObString::make_string("abc"));
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 16, c1));
+  ASSERT_EQ(OB_SUCCESS, p.calc(row, result));
+  ASSERT_FALSE(p.is_compiled());
+  ASSERT_EQ(OB_SUCCESS, result->get_bool(re));
+  ASSERT_TRUE(re);
+  c1.set_varchar(ObString::make_string("bc"));
+  ASSERT_EQ(OB_SUCCESS, row.set_cell(1001, 16, c1));
+  ASSERT_EQ(OB_SUCCESS, p.calc(row, result));
+  ASSERT_EQ(OB_SUCCESS, result->get_bool(re));
+  ASSERT_FALSE(re);
+}
+
 int main(int argc, char **argv)
 {
   ob_init_memory_pool();
@@ -119,6 +119,47 @@ TEST_F(ObSortTest, merge_sort_test)
   test(1024*1024*10, true);
 }
 
+TEST_F(ObSortTest, parallel_merge_sort_test)
+{
+  sort_.set_mem_size_limit(32*1024*1024LL);
+  sort_.set_sort_thread_count(4);
+  test(1024*1024, true);
+}
+
+TEST_F(ObSortTest, single_thread_merge_sort_test)
+{
+  sort_.set_mem_size_limit(32*1024*1024LL);
+  sort_.set_sort_thread_count(1);
+  test(1024*1024, true);
+}
+
+TEST_F(ObSortTest, single_dump_parallel_merge_sort_test)
+{
+  // let the first buffer (half of the limit) fill up at about 3/4 of the input,
+  // so that exactly one run is dumped in the background before the merge
+  const int64_t row_count = 256*1024;
+  ObArray<ObSortColumn> sort_columns;
+  ObSortColumn sort_column;
+  sort_column.table_id_ = test::ObFakeTable::TABLE_ID;
+  sort_column.column_id_ = OB_APP_MIN_COLUMN_ID;
+  ASSERT_EQ(OB_SUCCESS, sort_columns.push_back(sort_column));
+  ObInMemorySort all_rows;
+  ASSERT_EQ(OB_SUCCESS, all_rows.set_sort_columns(sort_columns));
+  input_table_.set_row_count(row_count);
+  ASSERT_EQ(OB_SUCCESS, input_table_.open());
+  const ObRow *row = NULL;
+  for (int64_t i = 0; i < row_count; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, input_table_.get_next_row(row));
+    ASSERT_EQ(OB_SUCCESS, all_rows.add_row(*row));
+  }
+  ASSERT_EQ(OB_SUCCESS, input_table_.close());
+
+  sort_.set_mem_size_limit(all_rows.get_used_mem_size() * 3 / 2);
+  sort_.set_sort_thread_count(4);
+  test(row_count, true);
+}
+
 TEST_F(ObSortTest, in_mem_perf_test)
 {
   test(1024*1024, false);
@@ -129,6 +170,48 @@ TEST_F(ObSortTest, merge_sort_perf_test)
   test(1024*1024*10, false);
 }
 
+TEST_F(ObSortTest, topn_test)
+{
+  sort_.set_topn(1000);
+  test(1000, true);
+}
+
+TEST_F(ObSortTest, topn_order_test)
+{
+  const int64_t row_count = 100*1024;
+  const int64_t topn = 3000;
+  ObSort sort;
+  ASSERT_EQ(OB_SUCCESS, sort.add_sort_column(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+1, false));
+  ASSERT_EQ(OB_SUCCESS, sort.set_child(0, input_table_));
+  input_table_.set_row_count(row_count);
+  sort.set_topn(topn);
+  ASSERT_EQ(OB_SUCCESS, sort.open());
+  const ObRow *row = NULL;
+  const ObObj *cell = NULL;
+  int64_t int_cell = 0;
+  for (int64_t i = 0; i < topn; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, sort.get_next_row(row));
+    ASSERT_EQ(OB_SUCCESS, row->get_cell(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+1, cell));
+    ASSERT_EQ(OB_SUCCESS, cell->get_int(int_cell));
+    ASSERT_EQ(row_count - 1 - i, int_cell);
+  }
+  ASSERT_EQ(OB_ITER_END, sort.get_next_row(row));
+  ASSERT_EQ(OB_SUCCESS, sort.close());
+  // topn larger than the input
+  input_table_.set_row_count(100);
+  ASSERT_EQ(OB_SUCCESS, sort.open());
+  for (int64_t i = 0; i < 100; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, sort.get_next_row(row));
+    ASSERT_EQ(OB_SUCCESS, row->get_cell(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID+1, cell));
+    ASSERT_EQ(OB_SUCCESS, cell->get_int(int_cell));
+    ASSERT_EQ(99 - i, int_cell);
+  }
+  ASSERT_EQ(OB_ITER_END, sort.get_next_row(row));
+  ASSERT_EQ(OB_SUCCESS, sort.close());
+}
+
 int main(int argc, char **argv)
 {
   ob_init_memory_pool();
@@ -0,0 +1,131 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sort_worker_pool_test.cpp
+ *
+ */
+#include "sql/ob_sort_worker_pool.h"
+#include "common/ob_malloc.h"
+#include <gtest/gtest.h>
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+class ObSortWorkerPoolTest: public ::testing::Test
+{
+  public:
+    ObSortWorkerPoolTest();
+    virtual ~ObSortWorkerPoolTest();
+    virtual void SetUp();
+    virtual void TearDown();
+  private:
+    // disallow copy
+    ObSortWorkerPoolTest(const ObSortWorkerPoolTest &other);
+    ObSortWorkerPoolTest& operator=(const ObSortWorkerPoolTest &other);
+};
+
+ObSortWorkerPoolTest::ObSortWorkerPoolTest()
+{
+}
+
+ObSortWorkerPoolTest::~ObSortWorkerPoolTest()
+{
+}
+
+void ObSortWorkerPoolTest::SetUp()
+{
+}
+
+void ObSortWorkerPoolTest::TearDown()
+{
+}
+
+class CountTask: public ObSortTask
+{
+  public:
+    CountTask()
+      :count_(0)
+    {
+    }
+    virtual void process()
+    {
+      ++count_;
+    }
+    int64_t count_;
+};
+
+// submits subtasks and waits for them, like a dump task sorting its run in parallel
+class NestedTask: public ObSortTask
+{
+  public:
+    static const int64_t SUBTASK_NUM = 4;
+    virtual void process()
+    {
+      ObSortWorkerPool &pool = ObSortWorkerPool::get_instance();
+      for (int64_t i = 0; i < SUBTASK_NUM; ++i)
+      {
+        if (OB_SUCCESS != pool.submit(subtasks_[i]))
+        {
+          subtasks_[i].process();
+        }
+      }
+      for (int64_t i = 0; i < SUBTASK_NUM; ++i)
+      {
+        pool.wait(subtasks_[i]);
+      }
+    }
+    CountTask subtasks_[SUBTASK_NUM];
+};
+
+TEST_F(ObSortWorkerPoolTest, submit_and_wait)
+{
+  static const int64_t TASK_NUM = 100;
+  ObSortWorkerPool &pool = ObSortWorkerPool::get_instance();
+  CountTask tasks[TASK_NUM];
+  for (int round = 0; round < 3; ++round)
+  {
+    for (int64_t i = 0; i < TASK_NUM; ++i)
+    {
+      ASSERT_EQ(OB_SUCCESS, pool.submit(tasks[i]));
+    }
+    for (int64_t i = 0; i < TASK_NUM; ++i)
+    {
+      pool.wait(tasks[i]);
+      ASSERT_EQ(round + 1, tasks[i].count_);
+    }
+  }
+  ASSERT_LT(0, pool.get_thread_num());
+  ASSERT_GE(ObSortWorkerPool::MAX_THREAD_NUM + 0, pool.get_thread_num());
+}
+
+TEST_F(ObSortWorkerPoolTest, nested_tasks)
+{
+  // more waiting tasks than the threads
+  static const int64_t TASK_NUM = 64;
+  ObSortWorkerPool &pool = ObSortWorkerPool::get_instance();
+  NestedTask tasks[TASK_NUM];
+  for (int64_t i = 0; i < TASK_NUM; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, pool.submit(tasks[i]));
+  }
+  for (int64_t i = 0; i < TASK_NUM; ++i)
+  {
+    pool.wait(tasks[i]);
+    for (int64_t j = 0; j < NestedTask::SUBTASK_NUM; ++j)
+    {
+      ASSERT_EQ(1, tasks[i].subtasks_[j].count_);
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,148 @@
+/**
+ * (C) 2010-2012 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sql_parameterizer_test.cpp
+ *
+ */
+#include "sql/ob_sql_plan_cache.h"
+#include "sql/ob_sql_session_info.h"
+#include "common/ob_malloc.h"
+#include <gtest/gtest.h>
+
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+class ObSqlParameterizerTest: public ::testing::Test
+{
+  public:
+    int parameterize(const char *sql)
+    {
+      ObString stmt = ObString::make_string(sql);
+      int ret = ObSqlParameterizer::parameterize(stmt, buf_, sizeof(buf_), normalized_, params_);
+      if (OB_SUCCESS == ret)
+      {
+        snprintf(normalized_str_, sizeof(normalized_str_), "%.*s", normalized_.length(), normalized_.ptr());
+      }
+      return ret;
+    }
+  protected:
+    char buf_[1024];
+    char normalized_str_[1024];
+    ObString normalized_;
+    ObArray<ObObj> params_;
+};
+
+TEST_F(ObSqlParameterizerTest, point_select)
+{
+  int64_t int_val = 0;
+  ObString str_val;
+  ASSERT_EQ(OB_SUCCESS, parameterize("select c1, 10 from t1 where id = 123 and name='abc'"));
+  EXPECT_STREQ("select c1, 10 from t1 where id = ? and name=?", normalized_str_);
+  ASSERT_EQ(2, params_.count());
+  ASSERT_EQ(OB_SUCCESS, params_.at(0).get_int(int_val));
+  EXPECT_EQ(123, int_val);
+  ASSERT_EQ(OB_SUCCESS, params_.at(1).get_varchar(str_val));
+  EXPECT_EQ(0, str_val.compare("abc"));
+
+  // the same shape with other literals
+  char normalized[1024];
+  snprintf(normalized, sizeof(normalized), "%s", normalized_str_);
+  ASSERT_EQ(OB_SUCCESS, parameterize("select c1, 10 from t1 where id = 4567 and name=''"));
+  EXPECT_STREQ(normalized, normalized_str_);
+  ASSERT_EQ(OB_SUCCESS, params_.at(1).get_varchar(str_val));
+  EXPECT_EQ(0, str_val.length());
+}
+
+TEST_F(ObSqlParameterizerTest, dml)
+{
+  ASSERT_EQ(OB_SUCCESS, parameterize("INSERT INTO t1 (a, b) VALUES (1, 'x'), (2, 'y')"));
+  EXPECT_STREQ("INSERT INTO t1 (a, b) VALUES (?, ?), (?, ?)", normalized_str_);
+  EXPECT_EQ(4, params_.count());
+  ASSERT_EQ(OB_SUCCESS, parameterize("replace into t1 values(1,'x')"));
+  EXPECT_STREQ("replace into t1 values(?,?)", normalized_str_);
+  ASSERT_EQ(OB_SUCCESS, parameterize("update t1 set a=1, b='x' where id=2"));
+  EXPECT_STREQ("update t1 set a=?, b=? where id=?", normalized_str_);
+  ASSERT_EQ(OB_SUCCESS, parameterize("delete from t1 where id in (1, 2, 3)"));
+  EXPECT_STREQ("delete from t1 where id in (?, ?, ?)", normalized_str_);
+}
+
+TEST_F(ObSqlParameterizerTest, kept_literals)
+{
+  // signed, float, too long, adjacent to identifiers
+  ASSERT_EQ(OB_SUCCESS, parameterize("select * from t1 where a=-1 and b=1.5 and c=1234567890123456789 and d=1e3 and e=t2.c1"));
+  EXPECT_STREQ("select * from t1 where a=-1 and b=1.5 and c=1234567890123456789 and d=1e3 and e=t2.c1", normalized_str_);
+  EXPECT_EQ(0, params_.count());
+  // escaped strings, date and binary literals, quoted identifiers
+  ASSERT_EQ(OB_SUCCESS, parameterize("select * from t1 where a='it''s' and b='\\n' and c=date '2012-01-01' and d=X'0A' and `e`=\"f\""));
+  EXPECT_STREQ("select * from t1 where a='it''s' and b='\\n' and c=date '2012-01-01' and d=X'0A' and `e`=\"f\"", normalized_str_);
+  EXPECT_EQ(0, params_.count());
+  // select list, order by, group by and limit
+  ASSERT_EQ(OB_SUCCESS, parameterize("select a, 'x' from t1 where b in (select 1 from t2 where c=2) group by a having count(*) > 3 order by 1 limit 10"));
+  EXPECT_STREQ("select a, 'x' from t1 where b in (select 1 from t2 where c=?) group by a having count(*) > 3 order by 1 limit 10", normalized_str_);
+  EXPECT_EQ(1, params_.count());
+  // comments and hints
+  ASSERT_EQ(OB_SUCCESS, parameterize("select /*+ index(t1 i1) 5 */ * from t1 where a=5 -- 6\n and b=7"));
+  EXPECT_STREQ("select /*+ index(t1 i1) 5 */ * from t1 where a=? -- 6\n and b=?", normalized_str_);
+  EXPECT_EQ(2, params_.count());
+}
+
+TEST_F(ObSqlParameterizerTest, not_supported)
+{
+  EXPECT_EQ(OB_NOT_SUPPORTED, parameterize("show tables"));
+  EXPECT_EQ(OB_NOT_SUPPORTED, parameterize("set autocommit=1"));
+  EXPECT_EQ(OB_NOT_SUPPORTED, parameterize("select * from t1 where a=?"));
+  EXPECT_EQ(OB_NOT_SUPPORTED, parameterize("select @@version"));
+  EXPECT_EQ(OB_NOT_SUPPORTED, parameterize("select * from t1 where a='abc"));
+  EXPECT_EQ(OB_NOT_SUPPORTED, parameterize("select * from t1 /* where a=1"));
+  EXPECT_EQ(OB_NOT_SUPPORTED, parameterize("  "));
+}
+
+TEST(ObSqlPlanCacheTest, lru)
+{
+  // statements known as not cacheable own no plan, so no prepare is needed
+  ObSqlPlanCache &cache = ObSqlPlanCache::get_instance();
+  ObSQLSessionInfo session1;
+  ObSQLSessionInfo session2;
+  uint64_t stmt_id = 0;
+  const int64_t entry_size = sizeof(ObSqlPlanCache::Entry) + 4;
+  ObSqlPlanCache::set_config(2, 3 * entry_size);
+  ASSERT_EQ(OB_SUCCESS, cache.put(session1, ObString::make_string("sql1"), 1, 1, OB_INVALID_ID));
+  ASSERT_EQ(OB_SUCCESS, cache.put(session1, ObString::make_string("sql2"), 1, 1, OB_INVALID_ID));
+  ASSERT_EQ(OB_SUCCESS, cache.get(session1, ObString::make_string("sql1"), 1, 1, stmt_id));
+  EXPECT_EQ(OB_INVALID_ID, stmt_id);
+  EXPECT_EQ(OB_ENTRY_NOT_EXIST, cache.get(session2, ObString::make_string("sql1"), 1, 1, stmt_id));
+  // sql2 is the least recently used entry of session1
+  ASSERT_EQ(OB_SUCCESS, cache.put(session1, ObString::make_string("sql3"), 1, 1, OB_INVALID_ID));
+  EXPECT_EQ(OB_ENTRY_NOT_EXIST, cache.get(session1, ObString::make_string("sql2"), 1, 1, stmt_id));
+  EXPECT_EQ(2, cache.count());
+  EXPECT_EQ(2 * entry_size, ObSqlPlanCache::get_total_mem_size());
+  // the memory limit is shared, sql1 of session1 is the least recently used of the server
+  ASSERT_EQ(OB_SUCCESS, cache.put(session2, ObString::make_string("sql1"), 1, 1, OB_INVALID_ID));
+  ASSERT_EQ(OB_SUCCESS, cache.put(session2, ObString::make_string("sql2"), 1, 1, OB_INVALID_ID));
+  EXPECT_EQ(3, cache.count());
+  EXPECT_EQ(3 * entry_size, ObSqlPlanCache::get_total_mem_size());
+  EXPECT_EQ(OB_ENTRY_NOT_EXIST, cache.get(session1, ObString::make_string("sql1"), 1, 1, stmt_id));
+  EXPECT_EQ(OB_SUCCESS, cache.get(session1, ObString::make_string("sql3"), 1, 1, stmt_id));
+  // stale entry
+  EXPECT_EQ(OB_ENTRY_NOT_EXIST, cache.get(session2, ObString::make_string("sql1"), 2, 1, stmt_id));
+  EXPECT_EQ(2, cache.count());
+  cache.remove_session(session2);
+  EXPECT_EQ(1, cache.count());
+  cache.remove_session(session1);
+  EXPECT_EQ(0, cache.count());
+  EXPECT_EQ(0, ObSqlPlanCache::get_total_mem_size());
+  ObSqlPlanCache::set_config(ObSqlPlanCache::DEFAULT_MAX_PLAN_COUNT, ObSqlPlanCache::DEFAULT_MEM_LIMIT);
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -684,6 +684,306 @@ TEST(TestMemTable, total_empty)
   mt.destroy();
 }
 
+TEST(TestMemTable, frozen_bloomfilter)
+{
+  MemTable mt;
+  PageArena<char> allocer;
+  ObUpsMutator ups_mutator;
+  ObMutator &mutator = ups_mutator.get_mutator();
+  ObMutator result;
+  MemTableTransDescriptor td;
+  MemTableIterator iter;
+  ObRowCompaction rc;
+  ObCellInfo *ci = NULL;
+  read_cell_infos("test_cases/test_mt_scan.ci.ini", "MT_SCAN_CI", allocer, mutator, result);
+
+  EXPECT_NE(OB_SUCCESS, mt.build_frozen_bloomfilter());
+  mt.init();
+  mt.start_transaction(WRITE_TRANSACTION, td);
+  mt.start_mutation(td);
+  EXPECT_EQ(OB_SUCCESS, mt.set(td, ups_mutator, false));
+  mt.end_mutation(td, false);
+  mt.end_transaction(td, false);
+
+  EXPECT_TRUE(mt.need_build_frozen_bloomfilter());
+  EXPECT_EQ(OB_SUCCESS, mt.build_frozen_bloomfilter());
+  EXPECT_FALSE(mt.need_build_frozen_bloomfilter());
+  // built only once
+  EXPECT_EQ(OB_SUCCESS, mt.build_frozen_bloomfilter());
+
+  // existent row is not filtered
+  mt.start_transaction(READ_TRANSACTION, td);
+  EXPECT_EQ(OB_SUCCESS, mt.get(td, 1000, make_rowkey("pre_1000|suf_1000", &allocator_), iter));
+  rc.set_iterator(&iter);
+  EXPECT_EQ(OB_SUCCESS, rc.next_cell());
+  EXPECT_EQ(OB_SUCCESS, rc.get_cell(&ci));
+  EXPECT_FALSE(ObActionFlag::OP_ROW_DOES_NOT_EXIST == ci->value_.get_ext());
+  mt.end_transaction(td);
+
+  iter.reset();
+  mt.start_transaction(READ_TRANSACTION, td);
+  EXPECT_EQ(OB_SUCCESS, mt.get(td, 1000, make_rowkey("pre_9999|suf_9999", &allocator_), iter));
+  rc.set_iterator(&iter);
+  EXPECT_EQ(OB_SUCCESS, rc.next_cell());
+  EXPECT_EQ(OB_SUCCESS, rc.get_cell(&ci));
+  EXPECT_EQ(true, ObActionFlag::OP_ROW_DOES_NOT_EXIST == ci->value_.get_ext());
+  EXPECT_EQ(OB_ITER_END, rc.next_cell());
+  mt.end_transaction(td);
+
+  mt.clear();
+  EXPECT_TRUE(mt.need_build_frozen_bloomfilter());
+  mt.destroy();
+}
+
+struct HotRowTestCtx
+{
+  static const int64_t ROW_NUM = 2;
+  static const int64_t WRITE_NUM = 2000;
+  static const int64_t HOT_ROW_CELL_NUM = 8;
+  MemTable mt;
+  SessionCtxFactory scf;
+  SessionMgr sm;
+  LockMgr lm;
+  ObRowkey rowkeys[ROW_NUM];
+  pthread_mutex_t commit_mutex;
+  int64_t last_trans_id;
+  volatile int64_t running_writer_num;
+  volatile int64_t err_num;
+};
+
+static int hot_row_write(HotRowTestCtx &ctx, const int64_t row_idx, const int64_t v)
+{
+  int ret = OB_SUCCESS;
+  uint32_t sd = 0;
+  RWSessionCtx *session = NULL;
+  ILockInfo *lock_info = NULL;
+  ObMutator mutator;
+  if (OB_SUCCESS != (ret = ctx.sm.begin_session(ST_READ_WRITE, tbsys::CTimeUtil::getTime(), INT64_MAX, INT64_MAX, sd)))
+  {
+    TBSYS_LOG(WARN, "begin session fail ret=%d", ret);
+  }
+  else if (NULL == (session = ctx.sm.fetch_ctx<RWSessionCtx>(sd)))
+  {
+    ret = OB_ERR_UNEXPECTED;
+  }
+  else if (NULL == (lock_info = ctx.lm.assign(READ_COMMITED, *session)))
+  {
+    ret = OB_ERR_UNEXPECTED;
+  }
+  else if (OB_SUCCESS != (ret = lock_info->on_trans_begin())
+          || OB_SUCCESS != (ret = session->add_publish_callback(&(ctx.mt.get_trans_cb()), &(session->get_uc_info()))))
+  {
+    TBSYS_LOG(WARN, "prepare session fail ret=%d", ret);
+  }
+  else
+  {
+    session->get_uc_info().host = &ctx.mt;
+    ObObj obj;
+    obj.set_int(v);
+    mutator.update(1001, ctx.rowkeys[row_idx], 101, obj);
+    obj.set_int(-v);
+    mutator.update(1001, ctx.rowkeys[row_idx], 102, obj);
+    ret = ctx.mt.set(*session, *lock_info, mutator);
+  }
+  if (NULL != session)
+  {
+    // 提交的事务版本号单调递增
+    pthread_mutex_lock(&ctx.commit_mutex);
+    int64_t trans_id = tbsys::CTimeUtil::getTime();
+    trans_id = (trans_id <= ctx.last_trans_id) ? (ctx.last_trans_id + 1) : trans_id;
+    ctx.last_trans_id = trans_id;
+    session->set_trans_id(trans_id);
+    ctx.sm.revert_ctx(sd);
+    int tmp_ret = ctx.sm.end_session(sd, OB_SUCCESS != ret);
+    ret = (OB_SUCCESS == ret) ? tmp_ret : ret;
+    pthread_mutex_unlock(&ctx.commit_mutex);
+  }
+  return ret;
+}
+
+static int hot_row_read(HotRowTestCtx &ctx, const int64_t row_idx, int64_t &v1, int64_t &v2)
+{
+  int ret = OB_SUCCESS;
+  uint32_t sd = 0;
+  BaseSessionCtx *session = NULL;
+  MemTableIterator iter;
+  ObRowCompaction rc;
+  ObCellInfo *ci = NULL;
+  v1 = 0;
+  v2 = 0;
+  if (OB_SUCCESS != (ret = ctx.sm.begin_session(ST_READ_ONLY, tbsys::CTimeUtil::getTime(), INT64_MAX, INT64_MAX, sd)))
+  {
+    TBSYS_LOG(WARN, "begin session fail ret=%d", ret);
+  }
+  else if (NULL == (session = ctx.sm.fetch_ctx<BaseSessionCtx>(sd)))
+  {
+    ret = OB_ERR_UNEXPECTED;
+  }
+  else if (OB_SUCCESS == (ret = ctx.mt.get(*session, 1001, ctx.rowkeys[row_idx], iter)))
+  {
+    rc.set_iterator(&iter);
+    while (OB_SUCCESS == (ret = rc.next_cell())
+          && OB_SUCCESS == (ret = rc.get_cell(&ci)))
+    {
+      if (101 == ci->column_id_)
+      {
+        ci->value_.get_int(v1);
+      }
+      else if (102 == ci->column_id_)
+      {
+        ci->value_.get_int(v2);
+      }
+    }
+    ret = (OB_ITER_END == ret) ? OB_SUCCESS : ret;
+  }
+  if (NULL != session)
+  {
+    ctx.sm.revert_ctx(sd);
+    ctx.sm.end_session(sd);
+  }
+  return ret;
+}
+
+static void *hot_row_writer(void *arg)
+{
+  HotRowTestCtx &ctx = *(HotRowTestCtx*)arg;
+  int64_t row_idx = __sync_fetch_and_add(&ctx.running_writer_num, 1);
+  for (int64_t i = 1; i <= HotRowTestCtx::WRITE_NUM; i++)
+  {
+    if (OB_SUCCESS != hot_row_write(ctx, row_idx, i))
+    {
+      __sync_add_and_fetch(&ctx.err_num, 1);
+    }
+  }
+  __sync_add_and_fetch(&ctx.running_writer_num, -1);
+  return NULL;
+}
+
+static void *hot_row_reader(void *arg)
+{
+  HotRowTestCtx &ctx = *(HotRowTestCtx*)arg;
+  int64_t last_v[HotRowTestCtx::ROW_NUM] = {0};
+  while (0 < ctx.running_writer_num)
+  {
+    for (int64_t row_idx = 0; row_idx < HotRowTestCtx::ROW_NUM; row_idx++)
+    {
+      int64_t v1 = 0;
+      int64_t v2 = 0;
+      // 合并前后读到的行必须是某个已提交事务写入的完整版本, 并且不会回退
+      if (OB_SUCCESS != hot_row_read(ctx, row_idx, v1, v2)
+          || v1 != -v2
+          || v1 < last_v[row_idx])
+      {
+        TBSYS_LOG(ERROR, "read hot row fail row_idx=%ld v1=%ld v2=%ld last_v=%ld", row_idx, v1, v2, last_v[row_idx]);
+        __sync_add_and_fetch(&ctx.err_num, 1);
+      }
+      last_v[row_idx] = v1;
+    }
+  }
+  return NULL;
+}
+
+static void *hot_row_compactor(void *arg)
+{
+  HotRowTestCtx &ctx = *(HotRowTestCtx*)arg;
+  while (0 < ctx.running_writer_num)
+  {
+    int64_t compacted_row_num = 0;
+    if (OB_SUCCESS != ctx.mt.compact_hot_rows(ctx.sm, compacted_row_num))
+    {
+      __sync_add_and_fetch(&ctx.err_num, 1);
+    }
+  }
+  return NULL;
+}
+
+TEST(TestMemTable, compact_hot_rows)
+{
+  static const int64_t READER_NUM = 4;
+  HotRowTestCtx *ctx = new HotRowTestCtx();
+  MemTableAttr attr;
+  ctx->last_trans_id = 0;
+  ctx->running_writer_num = 0;
+  ctx->err_num = 0;
+  pthread_mutex_init(&ctx->commit_mutex, NULL);
+  ctx->rowkeys[0] = make_rowkey("hot_row_0", &allocator_);
+  ctx->rowkeys[1] = make_rowkey("hot_row_1", &allocator_);
+  ASSERT_EQ(OB_SUCCESS, ctx->sm.init(1000, 1000, 1000, &ctx->scf));
+  ASSERT_EQ(OB_SUCCESS, ctx->mt.init());
+  int64_t compacted_row_num = 0;
+  EXPECT_EQ(OB_SUCCESS, ctx->mt.compact_hot_rows(ctx->sm, compacted_row_num));
+  EXPECT_EQ(0, compacted_row_num);
+
+  // hot_row_cell_num为0时不记录热点行
+  for (int64_t i = 0; i < HotRowTestCtx::HOT_ROW_CELL_NUM; i++)
+  {
+    ASSERT_EQ(OB_SUCCESS, hot_row_write(*ctx, 0, 0));
+  }
+  EXPECT_EQ(OB_SUCCESS, ctx->mt.compact_hot_rows(ctx->sm, compacted_row_num));
+  EXPECT_EQ(0, compacted_row_num);
+
+  ctx->mt.get_attr(attr);
+  attr.hot_row_cell_num = HotRowTestCtx::HOT_ROW_CELL_NUM;
+  ctx->mt.set_attr(attr);
+  pthread_t writers[HotRowTestCtx::ROW_NUM];
+  pthread_t readers[READER_NUM];
+  pthread_t compactor;
+  // 写线程启动时各自认领一行, 先把计数清零再启动
+  ctx->running_writer_num = 0;
+  for (int64_t i = 0; i < HotRowTestCtx::ROW_NUM; i++)
+  {
+    pthread_create(&writers[i], NULL, hot_row_writer, ctx);
+  }
+  while (HotRowTestCtx::ROW_NUM > ctx->running_writer_num
+         && 0 == ctx->err_num)
+  {
+    usleep(100);
+  }
+  for (int64_t i = 0; i < READER_NUM; i++)
+  {
+    pthread_create(&readers[i], NULL, hot_row_reader, ctx);
+  }
+  pthread_create(&compactor, NULL, hot_row_compactor, ctx);
+  for (int64_t i = 0; i < HotRowTestCtx::ROW_NUM; i++)
+  {
+    pthread_join(writers[i], NULL);
+  }
+  for (int64_t i = 0; i < READER_NUM; i++)
+  {
+    pthread_join(readers[i], NULL);
+  }
+  pthread_join(compactor, NULL);
+  EXPECT_EQ(0, ctx->err_num);
+
+  do
+  {
+    EXPECT_EQ(OB_SUCCESS, ctx->mt.compact_hot_rows(ctx->sm, compacted_row_num));
+  }
+  while (0 < compacted_row_num);
+
+  // 没有活跃事务时所有版本都可以合并, 链表上只剩一个节点并且值是最后一次写入的
+  for (int64_t row_idx = 0; row_idx < HotRowTestCtx::ROW_NUM; row_idx++)
+  {
+    int64_t v1 = 0;
+    int64_t v2 = 0;
+    TEValue *value = NULL;
+    TEKey key(1001, ctx->rowkeys[row_idx]);
+    ASSERT_EQ(OB_SUCCESS, ctx->mt.ensure_cur_row(key, value));
+    ASSERT_TRUE(NULL != value);
+    EXPECT_TRUE(NULL != value->list_head);
+    EXPECT_EQ(value->list_head, value->list_tail);
+    EXPECT_TRUE(HotRowTestCtx::HOT_ROW_CELL_NUM >= value->cell_info_cnt);
+    EXPECT_TRUE(HST_NONE == value->hot_stat);
+    EXPECT_EQ(OB_SUCCESS, hot_row_read(*ctx, row_idx, v1, v2));
+    EXPECT_TRUE(HotRowTestCtx::WRITE_NUM == v1);
+    EXPECT_TRUE(-HotRowTestCtx::WRITE_NUM == v2);
+  }
+
+  ctx->mt.destroy();
+  pthread_mutex_destroy(&ctx->commit_mutex);
+  delete ctx;
+}
+
 int main(int argc, char **argv)
 {
   TBSYS_LOGGER.setLogLevel("debug");
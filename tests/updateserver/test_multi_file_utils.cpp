@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "common/ob_malloc.h"
+#include "updateserver/ob_multi_file_utils.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::updateserver;
+
+static const char *TEST_DIR = "./multi_file_utils_test";
+static const int64_t BUFFER_SIZE = 2L * 1024L * 1024L;
+
+class TestMultiFileUtils : public ::testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+      mkdir(TEST_DIR, 0755);
+      snprintf(fname1_, sizeof(fname1_), "%s/1.sst", TEST_DIR);
+      snprintf(fname2_, sizeof(fname2_), "%s/2.sst", TEST_DIR);
+      unlink(fname1_);
+      unlink(fname2_);
+    }
+    virtual void TearDown()
+    {
+      unlink(fname1_);
+      unlink(fname2_);
+      rmdir(TEST_DIR);
+    }
+    // 多个文件名使用'\0'分隔 最后一个文件名后使用两个'\0'结尾
+    ObString make_fnames(const char *f1, const char *f2)
+    {
+      memset(fnames_, 0, sizeof(fnames_));
+      int64_t len1 = strlen(f1);
+      memcpy(fnames_, f1, len1);
+      memcpy(fnames_ + len1 + 1, f2, strlen(f2));
+      return ObString(0, static_cast<int32_t>(len1 + 1 + strlen(f2) + 2), fnames_);
+    }
+    static int64_t file_size(const char *fname)
+    {
+      struct stat st;
+      return (0 == stat(fname, &st)) ? st.st_size : -1;
+    }
+    static void fill(char *buf, const int64_t len, const int64_t offset)
+    {
+      for (int64_t i = 0; i < len; i++)
+      {
+        buf[i] = static_cast<char>((offset + i) * 7 % 251);
+      }
+    }
+    static bool check_file(const char *fname, const int64_t len)
+    {
+      bool bret = (file_size(fname) == len);
+      FILE *fp = fopen(fname, "r");
+      char *expect = new char[BUFFER_SIZE];
+      char *data = new char[BUFFER_SIZE];
+      for (int64_t pos = 0; bret && NULL != fp && pos < len; pos += BUFFER_SIZE)
+      {
+        int64_t size = std::min(BUFFER_SIZE, len - pos);
+        fill(expect, size, pos);
+        bret = (size == static_cast<int64_t>(fread(data, 1, size, fp))) && 0 == memcmp(expect, data, size);
+      }
+      if (NULL != fp)
+      {
+        fclose(fp);
+      }
+      delete[] expect;
+      delete[] data;
+      return bret && NULL != fp;
+    }
+  protected:
+    char fname1_[256];
+    char fname2_[256];
+    char fnames_[1024];
+};
+
+TEST_F(TestMultiFileUtils, ring_wraparound)
+{
+  // 奇数长度的append跨越缓冲边界，总长度绕过写缓冲环很多圈
+  const int64_t append_size = BUFFER_SIZE / 3 + 17;
+  const int64_t total_size = 40 * BUFFER_SIZE + 5;
+  char *buf = new char[append_size];
+  MultiFileUtils files;
+  ASSERT_EQ(OB_SUCCESS, files.create(make_fnames(fname1_, fname2_), false, 0));
+  ASSERT_EQ(0, files.get_file_pos());
+  for (int64_t pos = 0; pos < total_size; pos += append_size)
+  {
+    int64_t size = std::min(append_size, total_size - pos);
+    fill(buf, size, pos);
+    ASSERT_EQ(OB_SUCCESS, files.append(buf, size, false));
+    ASSERT_EQ(pos + size, files.get_file_pos());
+  }
+  files.close();
+  EXPECT_TRUE(check_file(fname1_, total_size));
+  EXPECT_TRUE(check_file(fname2_, total_size));
+  delete[] buf;
+}
+
+TEST_F(TestMultiFileUtils, fsync_order)
+{
+  // fsync返回时之前append的数据已经全部写到了每个文件
+  char *buf = new char[BUFFER_SIZE];
+  MultiFileUtils files;
+  int64_t pos = 0;
+  ASSERT_EQ(OB_SUCCESS, files.create(make_fnames(fname1_, fname2_), false, 0));
+  for (int64_t i = 1; i <= 5; i++)
+  {
+    int64_t size = i * BUFFER_SIZE / 2 + i;
+    for (int64_t written = 0; written < size; written += BUFFER_SIZE)
+    {
+      int64_t len = std::min(BUFFER_SIZE, size - written);
+      fill(buf, len, pos);
+      // 最后一段带着fsync标记append
+      ASSERT_EQ(OB_SUCCESS, files.append(buf, len, (0 == i % 2) && written + len == size));
+      pos += len;
+    }
+    if (0 != i % 2)
+    {
+      ASSERT_EQ(OB_SUCCESS, files.fsync());
+    }
+    EXPECT_TRUE(check_file(fname1_, pos));
+    EXPECT_TRUE(check_file(fname2_, pos));
+  }
+  files.close();
+  delete[] buf;
+}
+
+TEST_F(TestMultiFileUtils, error_propagation)
+{
+  // 一个store写失败之后append和fsync都要返回错误，其它store上的写不能被阻塞
+  char *buf = new char[BUFFER_SIZE];
+  MultiFileUtils files;
+  int err = OB_SUCCESS;
+  ASSERT_EQ(OB_SUCCESS, files.open(make_fnames(fname1_, "/dev/full"), false, true, false, 0));
+  fill(buf, BUFFER_SIZE, 0);
+  for (int64_t i = 0; OB_SUCCESS == err && i < 16; i++)
+  {
+    err = files.append(buf, BUFFER_SIZE, false);
+  }
+  if (OB_SUCCESS == err)
+  {
+    err = files.fsync();
+  }
+  EXPECT_NE(OB_SUCCESS, err);
+  EXPECT_NE(OB_SUCCESS, files.fsync());
+  EXPECT_NE(OB_SUCCESS, files.append(buf, BUFFER_SIZE, true));
+  files.close();
+  delete[] buf;
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
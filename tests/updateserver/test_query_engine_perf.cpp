@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "common/ob_malloc.h"
+#include "updateserver/ob_memtank.h"
+#include "updateserver/ob_query_engine.h"
+#include "updateserver/ob_table_engine.h"
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace common;
+using namespace updateserver;
+
+static const uint64_t TABLE_ID = 1001;
+static const int64_t HASH_SIZE = 1L << 20;
+
+// 比较hash+btree和只建btree索引两种方式下每行的索引内存以及get/scan的耗时
+void run_test(const int64_t row_num, const bool using_hash_index)
+{
+  g_conf.using_hash_index = using_hash_index;
+  MemTank mem_tank;
+  QueryEngine engine(mem_tank);
+  ASSERT_EQ(OB_SUCCESS, engine.init(HASH_SIZE));
+  ASSERT_EQ(using_hash_index, engine.is_hash_index_enabled());
+
+  TEValue *values = (TEValue*)ob_malloc(row_num * sizeof(TEValue), ObModIds::TEST);
+  ObObj *objs = (ObObj*)ob_malloc(row_num * sizeof(ObObj), ObModIds::TEST);
+  ASSERT_TRUE(NULL != values && NULL != objs);
+  int64_t mem_before = mem_tank.used();
+  int64_t timeu = tbsys::CTimeUtil::getTime();
+  for (int64_t i = 0; i < row_num; i++)
+  {
+    // 打散插入顺序
+    objs[i].set_int((i * 7919) % row_num);
+    values[i].reset();
+    values[i].list_head = (ObCellInfoNode*)&values[i];
+    TEKey key(TABLE_ID, ObRowkey(&objs[i], 1));
+    ASSERT_EQ(OB_SUCCESS, engine.set(key, &values[i]));
+  }
+  int64_t set_timeu = tbsys::CTimeUtil::getTime() - timeu;
+  int64_t mem_used = mem_tank.used() - mem_before;
+
+  timeu = tbsys::CTimeUtil::getTime();
+  for (int64_t i = 0; i < row_num; i++)
+  {
+    ObObj obj;
+    obj.set_int(i);
+    TEKey key(TABLE_ID, ObRowkey(&obj, 1));
+    ASSERT_TRUE(NULL != engine.get(key));
+  }
+  int64_t get_timeu = tbsys::CTimeUtil::getTime() - timeu;
+
+  timeu = tbsys::CTimeUtil::getTime();
+  QueryEngineIterator iter;
+  TEKey key(TABLE_ID, ObRowkey());
+  ASSERT_EQ(OB_SUCCESS, engine.scan(key, 1, 0, key, 1, 0, false, iter));
+  int64_t scan_num = 0;
+  int64_t last = -1;
+  while (OB_SUCCESS == iter.next())
+  {
+    int64_t v = 0;
+    ASSERT_EQ(TABLE_ID, iter.get_key().table_id);
+    ASSERT_EQ(OB_SUCCESS, iter.get_key().row_key.ptr()[0].get_int(v));
+    ASSERT_LT(last, v);
+    last = v;
+    ++scan_num;
+  }
+  int64_t scan_timeu = tbsys::CTimeUtil::getTime() - timeu;
+  ASSERT_EQ(row_num, scan_num);
+
+  fprintf(stderr, "using_hash_index=%s row_num=%ld index_mem_per_row=%0.2f "
+          "set_timeu=%0.3f get_timeu=%0.3f scan_timeu=%0.3f\n",
+          STR_BOOL(using_hash_index), row_num, (double)mem_used / (double)row_num,
+          (double)set_timeu / (double)row_num, (double)get_timeu / (double)row_num,
+          (double)scan_timeu / (double)row_num);
+
+  engine.destroy();
+  ob_free(objs);
+  ob_free(values);
+}
+
+TEST(TestQueryEnginePerf, key_size)
+{
+  fprintf(stderr, "sizeof(TEKey)=%ld sizeof(TEBtreeKey)=%ld\n", sizeof(TEKey), sizeof(TEBtreeKey));
+  EXPECT_GT(sizeof(TEKey), sizeof(TEBtreeKey));
+}
+
+TEST(TestQueryEnginePerf, run_test)
+{
+  run_test(10000, true);
+  run_test(10000, false);
+  run_test(1000000, true);
+  run_test(1000000, false);
+  g_conf.using_hash_index = true;
+}
+
+TEST(TestQueryEnginePerf, no_hash_index_tables)
+{
+  ASSERT_EQ(OB_SUCCESS, set_no_hash_index_tables("1001,1003"));
+  ASSERT_EQ(2, g_conf.no_hash_index_table_num);
+  EXPECT_NE(OB_SUCCESS, set_no_hash_index_tables("1001,abc"));
+  EXPECT_EQ(2, g_conf.no_hash_index_table_num);
+
+  MemTank mem_tank;
+  QueryEngine engine(mem_tank);
+  ASSERT_EQ(OB_SUCCESS, engine.init(HASH_SIZE));
+  TEValue values[4];
+  ObObj obj;
+  obj.set_int(1);
+  for (int64_t i = 0; i < 4; i++)
+  {
+    values[i].reset();
+    TEKey key(TABLE_ID + i, ObRowkey(&obj, 1));
+    ASSERT_EQ(OB_SUCCESS, engine.set(key, &values[i]));
+    EXPECT_EQ(OB_ENTRY_EXIST, engine.set(key, &values[i]));
+    EXPECT_EQ(&values[i], engine.get(key));
+  }
+  // 只有1002和1004进了hash
+  EXPECT_EQ(2, engine.hash_size());
+  EXPECT_EQ(4, engine.btree_size());
+  engine.destroy();
+  ASSERT_EQ(OB_SUCCESS, set_no_hash_index_tables(""));
+  ASSERT_EQ(0, g_conf.no_hash_index_table_num);
+}
+
+int main(int argc, char **argv)
+{
+  TBSYS_LOGGER.setLogLevel("info");
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -108,6 +108,42 @@ int test_main(int argc, char **argv)
       fprintf(stderr, "value=[%s]\n", common::print_obj(*sstable_row.get_obj(i++)));
     }
   }
+
+  // 按range并行读取的结果和串行读取的一致
+  MemTableRowIterator parallel_iter;
+  sstable::ObSSTableRow parallel_row;
+  ObRowkey parallel_rowkey(NULL, 1);
+  ret = parallel_iter.init(&memtable, DEFAULT_COMPRESSOR_NAME, sstable::ObSSTableBlockBuilder::SSTABLE_BLOCK_SIZE,
+                           sstable::OB_SSTABLE_STORE_SPARSE, 4);
+  assert(OB_SUCCESS == ret);
+  for (int64_t loop = 0; loop < 2; loop++)
+  {
+    row_iter.reset_iter();
+    parallel_iter.reset_iter();
+    int64_t row_count = 0;
+    while (OB_SUCCESS == row_iter.next_row())
+    {
+      ret = parallel_iter.next_row();
+      assert(OB_SUCCESS == ret);
+      ret = row_iter.get_row(sstable_row);
+      assert(OB_SUCCESS == ret);
+      ret = parallel_iter.get_row(parallel_row);
+      assert(OB_SUCCESS == ret);
+      assert(sstable_row.get_table_id() == parallel_row.get_table_id());
+      sstable_row.get_rowkey(rowkey);
+      parallel_row.get_rowkey(parallel_rowkey);
+      assert(rowkey == parallel_rowkey);
+      assert(sstable_row.get_obj_count() == parallel_row.get_obj_count());
+      for (int32_t i = 0; i < sstable_row.get_obj_count(); i++)
+      {
+        assert(*sstable_row.get_obj(i) == *parallel_row.get_obj(i));
+      }
+      row_count++;
+    }
+    assert(OB_ITER_END == parallel_iter.next_row());
+    assert(2 == row_count);
+  }
+  parallel_iter.destroy();
   return 0;
 }
 
@@ -1495,6 +1495,134 @@ void DumpSSTable::dump_another_sstable(const char * file_dir_,const char *compre
 }
 
 
+/*
+ * 把sstable所有block解压后的原始数据，用每个压缩方法重新压缩和解压，
+ * 输出压缩比和压缩/解压速度，compressor_names以分号分隔，例如
+ * "snappy_1.0;lz4_1.0;zstd_1.0@level=19"
+ * output_dir不为空时把原始block逐个写成文件，可以用zstd --train训练字典
+ */
+void DumpSSTable::bench_compressor(const char *compressor_names, const char *output_dir)
+{
+  static const int64_t DECOMPRESS_ROUND = 10;
+  int ret = OB_SUCCESS;
+  const int64_t block_count = reader_.get_trailer().get_block_count();
+  char **blocks = (char**)calloc(block_count, sizeof(char*));
+  int64_t *block_sizes = (int64_t*)calloc(block_count, sizeof(int64_t));
+  int64_t total_size = 0;
+  int64_t max_block_size = 0;
+  ObRecordHeader record_header;
+
+  if (NULL == blocks || NULL == block_sizes)
+  {
+    fprintf(stderr, "failed to malloc memory\n");
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < block_count; ++i)
+  {
+    const ObSSTableBlockIndexV2::IndexEntryType *entry = block_index_->begin() + i;
+    if (OB_SUCCESS != (ret = read_and_decompress_record(ObSSTableWriter::DATA_BLOCK_MAGIC,
+            entry->block_offset_, entry->block_record_size_, record_header, blocks[i], block_sizes[i])))
+    {
+      fprintf(stderr, "read block %ld failed, ret=%d\n", i, ret);
+    }
+    else
+    {
+      total_size += block_sizes[i];
+      max_block_size = std::max(max_block_size, block_sizes[i]);
+      if (NULL != output_dir)
+      {
+        char fname[OB_MAX_FILE_NAME_LENGTH];
+        snprintf(fname, sizeof(fname), "%s/block_%ld", output_dir, i);
+        FILE *fp = fopen(fname, "w");
+        if (NULL == fp || block_sizes[i] != static_cast<int64_t>(fwrite(blocks[i], 1, block_sizes[i], fp)))
+        {
+          fprintf(stderr, "write block file %s failed\n", fname);
+          ret = OB_IO_ERROR;
+        }
+        if (NULL != fp)
+        {
+          fclose(fp);
+        }
+      }
+    }
+  }
+
+  char names[OB_MAX_FILE_NAME_LENGTH];
+  char *saveptr = NULL;
+  snprintf(names, sizeof(names), "%s", NULL == compressor_names ? "" : compressor_names);
+  fprintf(stderr, "%-40s %12s %12s %8s %14s %14s\n", "compressor", "raw_size", "comp_size", "ratio",
+          "comp_MB/s", "decomp_MB/s");
+  for (char *name = strtok_r(names, ";", &saveptr);
+       OB_SUCCESS == ret && NULL != name;
+       name = strtok_r(NULL, ";", &saveptr))
+  {
+    ObCompressor *compressor = create_compressor(name);
+    char *comp_buffer = NULL;
+    char *decomp_buffer = NULL;
+    int64_t comp_buffer_size = 0;
+    int64_t comp_total_size = 0;
+    int64_t comp_timeu = 0;
+    int64_t decomp_timeu = 0;
+    if (NULL == compressor)
+    {
+      fprintf(stderr, "create compressor %s failed\n", name);
+      continue;
+    }
+    comp_buffer_size = max_block_size + compressor->get_max_overflow_size(max_block_size);
+    comp_buffer = (char*)malloc(comp_buffer_size);
+    decomp_buffer = (char*)malloc(max_block_size);
+    for (int64_t i = 0; OB_SUCCESS == ret && i < block_count; ++i)
+    {
+      int64_t comp_size = 0;
+      int64_t decomp_size = 0;
+      int64_t timeu = tbsys::CTimeUtil::getTime();
+      if (ObCompressor::COM_E_NOERROR != compressor->compress(blocks[i], block_sizes[i],
+            comp_buffer, comp_buffer_size, comp_size))
+      {
+        fprintf(stderr, "compress block %ld with %s failed\n", i, name);
+        ret = OB_ERROR;
+        break;
+      }
+      comp_timeu += tbsys::CTimeUtil::getTime() - timeu;
+      comp_total_size += comp_size;
+      timeu = tbsys::CTimeUtil::getTime();
+      for (int64_t round = 0; OB_SUCCESS == ret && round < DECOMPRESS_ROUND; ++round)
+      {
+        if (ObCompressor::COM_E_NOERROR != compressor->decompress(comp_buffer, comp_size,
+              decomp_buffer, max_block_size, decomp_size)
+            || decomp_size != block_sizes[i])
+        {
+          fprintf(stderr, "decompress block %ld with %s failed\n", i, name);
+          ret = OB_ERROR;
+        }
+      }
+      decomp_timeu += tbsys::CTimeUtil::getTime() - timeu;
+      if (OB_SUCCESS == ret && 0 != memcmp(decomp_buffer, blocks[i], block_sizes[i]))
+      {
+        fprintf(stderr, "block %ld changed after compress with %s\n", i, name);
+        ret = OB_ERROR;
+      }
+    }
+    if (OB_SUCCESS == ret)
+    {
+      fprintf(stderr, "%-40s %12ld %12ld %8.3f %14.2f %14.2f\n", name, total_size, comp_total_size,
+              (double)total_size / (double)(comp_total_size + 1),
+              (double)total_size / (double)(comp_timeu + 1),
+              (double)(total_size * DECOMPRESS_ROUND) / (double)(decomp_timeu + 1));
+    }
+    free(comp_buffer);
+    free(decomp_buffer);
+    destroy_compressor(compressor);
+  }
+
+  for (int64_t i = 0; NULL != blocks && i < block_count; ++i)
+  {
+    free(blocks[i]);
+  }
+  free(blocks);
+  free(block_sizes);
+}
+
 void DumpSSTable::load_block(int32_t block_id)
 {
   int ret = OB_SUCCESS;
@@ -1726,7 +1854,7 @@ void usage()
 {
   printf("\n");
   printf("Usage: sstable_tools [OPTION]\n");
-  printf("   -c| --cmd_type command type [dump_sstable|cmp_sstable|dump_meta|search_meta] \n");
+  printf("   -c| --cmd_type command type [dump_sstable|cmp_sstable|dump_meta|search_meta|bench_compressor] \n");
   printf("   -D| --sstable_directory sstable directory \n");
   printf("   -I| --idx_file_name must be set while cmd_type is dump_meta\n");
   printf("   -f| --file_id sstable file id\n");
@@ -1746,6 +1874,7 @@ void usage()
   printf("   -c dump_sstable -d dump_trailer -P sstable_file_path\n");
   printf("   -c dump_sstable -d dump_block -P sstable_file_path -b block_id\n");
   printf("   -c search_meta -t table_id -r search_range -a app_name -x hex_format -D sstable_directory \n");
+  printf("   -c bench_compressor -P sstable_file_path -s \"snappy_1.0;lz4_1.0;zstd_1.0@level=19\" [-o raw_block_directory]\n");
   printf("   -c change_meta -t table_id -r search_range -d action"
       "(remove_range/set_merged_flag/clear_merged_flag/find_tablet/change_range) "
       "-x hex_format -D sstable_directory [-i disk_no -v data_version -f dump_sstable -n new_range]\n");
@@ -2235,7 +2364,7 @@ void parse_cmd_line(int argc,char **argv,CmdLineParam &clp)
     }
   }
 
-  if(0 == strcmp("dump_sstable",clp.cmd_type))
+  if(0 == strcmp("dump_sstable",clp.cmd_type) || 0 == strcmp("bench_compressor",clp.cmd_type))
   {
     if (NULL != name) clp.file_id = strtoll(name, NULL, 10);
     if (NULL != directory) g_sstable_directory = directory;
@@ -2335,6 +2464,16 @@ int main(const int argc, char **argv)
     fprintf(stderr,"dump sstable with new compressor \n");
     dump.dump_another_sstable(clp.output_sst_dir,clp.compressor_name);
   }
+  if(0 == strcmp("bench_compressor",clp.cmd_type))
+  {
+    DumpSSTable dump;
+    if (OB_SUCCESS != (ret = dump.open(clp.file_id)))
+    {
+      fprintf(stderr, "failed to open sstable file='%ld'\n",clp.file_id);
+      exit(1);
+    }
+    dump.bench_compressor(clp.compressor_name, clp.output_sst_dir);
+  }
   //if dump_meta
   if(0 == strcmp("dump_meta",clp.cmd_type))
   {
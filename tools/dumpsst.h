@@ -44,6 +44,7 @@ namespace oceanbase
 		void load_blocks(int32_t block_id , int32_t block_n);
 		void dump_another_sstable(const char * file_dir_ ,const char *compressor_);
 		void dump_another_block(int32_t block_id);
+        void bench_compressor(const char *compressor_names, const char *output_dir);
 private:
         int load_block_index();
         int read_and_decompress_record(const int16_t magic,const int64_t offset,